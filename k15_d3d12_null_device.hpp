@@ -0,0 +1,3396 @@
+#pragma once
+
+//FK: Null device
+//    Stand-ins for the parts of win32, d3d12, dxgi, dxc and pix that k15_d3d12_renderer.hpp uses. This gets included
+//    instead of the real headers when USE_NULL_DEVICE is set, so the renderer builds and runs without GPU, window
+//    or windows (eg: on linux build machines) while keeping the whole frame loop intact.
+//    - Command lists count what got recorded.
+//    - Queues advance a simulated GPU timeline by the cost of the executed command lists (see null_device_cost_model_t).
+//    - Fences get reached once the simulated GPU time of their signal has passed, events block until then.
+//    - The swap chain presents to nothing.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <wchar.h>
+#include <ctype.h>
+
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+//FK: win32
+typedef int32_t         BOOL;
+typedef uint8_t         BYTE;
+typedef uint16_t        WORD;
+typedef uint32_t        UINT;
+typedef uint32_t        UINT32;
+typedef uint32_t        DWORD;
+typedef int32_t         LONG;
+typedef uint32_t        ULONG;
+typedef int64_t         LONG64;
+typedef int64_t         LONGLONG;
+typedef uint64_t        UINT64;
+typedef int32_t         HRESULT;
+typedef float           FLOAT;
+typedef size_t          SIZE_T;
+typedef void*           PVOID;
+typedef void*           HANDLE;
+typedef void*           HWND;
+typedef void*           HINSTANCE;
+typedef char*           LPSTR;
+typedef const char*     LPCSTR;
+typedef wchar_t         WCHAR;
+typedef const wchar_t*  LPCWSTR;
+typedef intptr_t        LRESULT;
+typedef uintptr_t       WPARAM;
+typedef intptr_t        LPARAM;
+
+union LARGE_INTEGER
+{
+    LONGLONG QuadPart;
+};
+
+struct RECT
+{
+    LONG left;
+    LONG top;
+    LONG right;
+    LONG bottom;
+};
+
+struct POINT
+{
+    LONG x;
+    LONG y;
+};
+
+struct GUID
+{
+    uint32_t    Data1;
+    uint16_t    Data2;
+    uint16_t    Data3;
+    uint8_t     Data4[8];
+};
+
+typedef GUID        IID;
+typedef GUID        CLSID;
+typedef const IID&  REFIID;
+typedef const GUID& REFCLSID;
+
+#define CALLBACK
+#define WINAPI
+#define TRUE    1
+#define FALSE   0
+
+#define S_OK                                    ((HRESULT)0L)
+#define S_FALSE                                 ((HRESULT)1L)
+#define E_NOTIMPL                               ((HRESULT)0x80004001L)
+#define E_NOINTERFACE                           ((HRESULT)0x80004002L)
+#define E_FAIL                                  ((HRESULT)0x80004005L)
+#define E_OUTOFMEMORY                           ((HRESULT)0x8007000EL)
+#define E_INVALIDARG                            ((HRESULT)0x80070057L)
+#define D3D12_ERROR_ADAPTER_NOT_FOUND           ((HRESULT)0x887E0001L)
+#define D3D12_ERROR_DRIVER_VERSION_MISMATCH     ((HRESULT)0x887E0002L)
+#define DXGI_ERROR_INVALID_CALL                 ((HRESULT)0x887A0001L)
+#define DXGI_ERROR_NOT_FOUND                    ((HRESULT)0x887A0002L)
+#define DXGI_ERROR_WAS_STILL_DRAWING            ((HRESULT)0x887A000AL)
+#define SUCCEEDED(hr)                           (((HRESULT)(hr)) >= 0)
+#define FAILED(hr)                              (((HRESULT)(hr)) < 0)
+
+#define INFINITE                0xFFFFFFFF
+#define WAIT_OBJECT_0           0x00000000L
+#define WAIT_TIMEOUT            0x00000102L
+#define INVALID_HANDLE_VALUE    ((HANDLE)(intptr_t)-1)
+
+#define MB_CANCELTRYCONTINUE    0x00000006L
+#define MB_ICONERROR            0x00000010L
+#define MB_DEFBUTTON1           0x00000000L
+#define IDCANCEL                2
+#define IDTRYAGAIN              10
+#define IDCONTINUE              11
+
+#if !defined(_MSC_VER)
+#define __assume(x) do { if(!(x)) { __builtin_unreachable(); } } while(0)
+#endif
+
+#define sprintf_s   snprintf
+#define vswprintf_s vswprintf
+
+int64_t getNullDeviceTimeInNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void sleepUntilNullDeviceTime(const int64_t timeInNanoseconds)
+{
+    const int64_t nowInNanoseconds = getNullDeviceTimeInNanoseconds();
+    if(timeInNanoseconds > nowInNanoseconds)
+    {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(timeInNanoseconds - nowInNanoseconds));
+    }
+}
+
+void DebugBreak()
+{
+#if defined(_MSC_VER)
+    __debugbreak();
+#else
+    __builtin_trap();
+#endif
+}
+
+//FK: There's nobody to click the buttons, so asserts print and exit
+int MessageBoxA(HWND pWindowHandle, LPCSTR pText, LPCSTR pCaption, UINT type)
+{
+    (void)pWindowHandle;
+    (void)type;
+    fprintf(stderr, "%s\n%s\n", pCaption, pText);
+    return IDCANCEL;
+}
+
+#define MOVEFILE_REPLACE_EXISTING 0x1
+
+//FK: rename() replaces existing files atomically on posix systems
+BOOL MoveFileExA(LPCSTR pExistingFileName, LPCSTR pNewFileName, DWORD flags)
+{
+    (void)flags;
+    return rename(pExistingFileName, pNewFileName) == 0 ? TRUE : FALSE;
+}
+
+BOOL CreateDirectoryA(LPCSTR pPathName, void* pSecurityAttributes)
+{
+    (void)pSecurityAttributes;
+#if defined(_MSC_VER)
+    return _mkdir(pPathName) == 0 ? TRUE : FALSE;
+#else
+    return mkdir(pPathName, 0755) == 0 ? TRUE : FALSE;
+#endif
+}
+
+void* CoTaskMemAlloc(SIZE_T sizeInBytes)
+{
+    return malloc(sizeInBytes);
+}
+
+void CoTaskMemFree(void* pMemory)
+{
+    free(pMemory);
+}
+
+void OutputDebugStringA(LPCSTR pText)
+{
+    fputs(pText, stderr);
+}
+
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* pFrequency)
+{
+    pFrequency->QuadPart = 1000000000ll;
+    return TRUE;
+}
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER* pCounter)
+{
+    pCounter->QuadPart = getNullDeviceTimeInNanoseconds();
+    return TRUE;
+}
+
+void* _aligned_malloc(size_t sizeInBytes, size_t alignmentInBytes)
+{
+#if defined(_MSC_VER)
+    return ::_aligned_malloc(sizeInBytes, alignmentInBytes);
+#else
+    void* pMemory = nullptr;
+    if(alignmentInBytes < sizeof(void*))
+    {
+        alignmentInBytes = sizeof(void*);
+    }
+
+    return posix_memalign(&pMemory, alignmentInBytes, sizeInBytes) == 0 ? pMemory : nullptr;
+#endif
+}
+
+void _aligned_free(void* pMemory)
+{
+#if defined(_MSC_VER)
+    ::_aligned_free(pMemory);
+#else
+    free(pMemory);
+#endif
+}
+
+LONG InterlockedIncrement(volatile LONG* pValue)
+{
+#if defined(_MSC_VER)
+    return (LONG)_InterlockedIncrement((volatile long*)pValue);
+#else
+    return __atomic_add_fetch(pValue, 1, __ATOMIC_SEQ_CST);
+#endif
+}
+
+LONG64 InterlockedIncrement64(volatile LONG64* pValue)
+{
+#if defined(_MSC_VER)
+    return (LONG64)_InterlockedIncrement64((volatile long long*)pValue);
+#else
+    return __atomic_add_fetch(pValue, 1, __ATOMIC_SEQ_CST);
+#endif
+}
+
+LONG InterlockedDecrement(volatile LONG* pValue)
+{
+#if defined(_MSC_VER)
+    return (LONG)_InterlockedDecrement((volatile long*)pValue);
+#else
+    return __atomic_sub_fetch(pValue, 1, __ATOMIC_SEQ_CST);
+#endif
+}
+
+LONG InterlockedExchangeAdd(volatile LONG* pValue, LONG addend)
+{
+#if defined(_MSC_VER)
+    return (LONG)_InterlockedExchangeAdd((volatile long*)pValue, addend);
+#else
+    return __atomic_fetch_add(pValue, addend, __ATOMIC_SEQ_CST);
+#endif
+}
+
+LONG InterlockedExchange(volatile LONG* pValue, LONG value)
+{
+#if defined(_MSC_VER)
+    return (LONG)_InterlockedExchange((volatile long*)pValue, value);
+#else
+    return __atomic_exchange_n(pValue, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+LONG InterlockedCompareExchange(volatile LONG* pValue, LONG exchange, LONG comparand)
+{
+#if defined(_MSC_VER)
+    return (LONG)_InterlockedCompareExchange((volatile long*)pValue, exchange, comparand);
+#else
+    __atomic_compare_exchange_n(pValue, &comparand, exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return comparand;
+#endif
+}
+
+LONG64 InterlockedCompareExchange64(volatile LONG64* pValue, LONG64 exchange, LONG64 comparand)
+{
+#if defined(_MSC_VER)
+    return (LONG64)_InterlockedCompareExchange64((volatile long long*)pValue, exchange, comparand);
+#else
+    __atomic_compare_exchange_n(pValue, &comparand, exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return comparand;
+#endif
+}
+
+//FK: Plain spin lock, structs containing locks get copied around by value so this can't be a std::mutex
+struct SRWLOCK
+{
+    volatile LONG isLocked;
+};
+
+void InitializeSRWLock(SRWLOCK* pLock)
+{
+    pLock->isLocked = 0;
+}
+
+void AcquireSRWLockExclusive(SRWLOCK* pLock)
+{
+    while(InterlockedExchange(&pLock->isLocked, 1) != 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+void ReleaseSRWLockExclusive(SRWLOCK* pLock)
+{
+    InterlockedExchange(&pLock->isLocked, 0);
+}
+
+//FK: Readers don't share the spin lock, they just take it exclusively
+void AcquireSRWLockShared(SRWLOCK* pLock)
+{
+    AcquireSRWLockExclusive(pLock);
+}
+
+void ReleaseSRWLockShared(SRWLOCK* pLock)
+{
+    ReleaseSRWLockExclusive(pLock);
+}
+
+//FK: Waiters just poll - callers have to recheck their condition after waking up anyway
+struct CONDITION_VARIABLE
+{
+    volatile LONG wakeCount;
+};
+
+void InitializeConditionVariable(CONDITION_VARIABLE* pConditionVariable)
+{
+    pConditionVariable->wakeCount = 0;
+}
+
+BOOL SleepConditionVariableSRW(CONDITION_VARIABLE* pConditionVariable, SRWLOCK* pLock, DWORD timeoutInMilliseconds, ULONG flags)
+{
+    (void)pConditionVariable;
+    (void)timeoutInMilliseconds;
+    (void)flags;
+
+    ReleaseSRWLockExclusive(pLock);
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    AcquireSRWLockExclusive(pLock);
+    return TRUE;
+}
+
+void WakeAllConditionVariable(CONDITION_VARIABLE* pConditionVariable)
+{
+    InterlockedIncrement(&pConditionVariable->wakeCount);
+}
+
+struct null_event_t
+{
+    std::mutex                  mutex;
+    std::condition_variable     condition;
+    int64_t                     signalTimeInNanoseconds;    // event gets signaled once this time has passed, -1 = not scheduled
+    bool                        isSignaled;
+    bool                        isManualReset;
+};
+
+HANDLE CreateEventA(void* pEventAttributes, BOOL manualReset, BOOL initialState, LPCSTR pName)
+{
+    (void)pEventAttributes;
+    (void)pName;
+
+    null_event_t* pEvent = new null_event_t;
+    pEvent->signalTimeInNanoseconds = -1;
+    pEvent->isSignaled              = initialState != FALSE;
+    pEvent->isManualReset           = manualReset != FALSE;
+    return pEvent;
+}
+
+#define CreateEvent CreateEventA
+
+BOOL SetEvent(HANDLE pEventHandle)
+{
+    null_event_t* pEvent = (null_event_t*)pEventHandle;
+    {
+        std::lock_guard<std::mutex> lock(pEvent->mutex);
+        pEvent->isSignaled = true;
+        pEvent->signalTimeInNanoseconds = -1;
+    }
+
+    pEvent->condition.notify_all();
+    return TRUE;
+}
+
+BOOL ResetEvent(HANDLE pEventHandle)
+{
+    null_event_t* pEvent = (null_event_t*)pEventHandle;
+    std::lock_guard<std::mutex> lock(pEvent->mutex);
+    pEvent->isSignaled = false;
+    return TRUE;
+}
+
+void scheduleNullEvent(HANDLE pEventHandle, const int64_t signalTimeInNanoseconds)
+{
+    null_event_t* pEvent = (null_event_t*)pEventHandle;
+    {
+        std::lock_guard<std::mutex> lock(pEvent->mutex);
+        pEvent->signalTimeInNanoseconds = signalTimeInNanoseconds;
+    }
+
+    pEvent->condition.notify_all();
+}
+
+DWORD WaitForSingleObject(HANDLE pEventHandle, DWORD timeoutInMilliseconds)
+{
+    null_event_t* pEvent = (null_event_t*)pEventHandle;
+    std::unique_lock<std::mutex> lock(pEvent->mutex);
+
+    const int64_t timeoutTimeInNanoseconds = timeoutInMilliseconds == INFINITE ? INT64_MAX : getNullDeviceTimeInNanoseconds() + (int64_t)timeoutInMilliseconds * 1000000ll;
+    while(!pEvent->isSignaled)
+    {
+        const int64_t nowInNanoseconds = getNullDeviceTimeInNanoseconds();
+        if(pEvent->signalTimeInNanoseconds >= 0 && pEvent->signalTimeInNanoseconds <= nowInNanoseconds)
+        {
+            pEvent->isSignaled = true;
+            pEvent->signalTimeInNanoseconds = -1;
+            break;
+        }
+
+        if(nowInNanoseconds >= timeoutTimeInNanoseconds)
+        {
+            return WAIT_TIMEOUT;
+        }
+
+        int64_t wakeUpTimeInNanoseconds = timeoutTimeInNanoseconds;
+        if(pEvent->signalTimeInNanoseconds >= 0 && pEvent->signalTimeInNanoseconds < wakeUpTimeInNanoseconds)
+        {
+            wakeUpTimeInNanoseconds = pEvent->signalTimeInNanoseconds;
+        }
+
+        if(wakeUpTimeInNanoseconds == INT64_MAX)
+        {
+            pEvent->condition.wait(lock);
+        }
+        else
+        {
+            pEvent->condition.wait_for(lock, std::chrono::nanoseconds(wakeUpTimeInNanoseconds - nowInNanoseconds));
+        }
+    }
+
+    if(!pEvent->isManualReset)
+    {
+        pEvent->isSignaled = false;
+    }
+
+    return WAIT_OBJECT_0;
+}
+
+BOOL CloseHandle(HANDLE pEventHandle)
+{
+    delete (null_event_t*)pEventHandle;
+    return TRUE;
+}
+
+struct SYSTEM_INFO
+{
+    DWORD dwNumberOfProcessors;
+};
+
+void GetSystemInfo(SYSTEM_INFO* pSystemInfo)
+{
+    const uint32_t processorCount = std::thread::hardware_concurrency();
+    pSystemInfo->dwNumberOfProcessors = processorCount > 0u ? processorCount : 1u;
+}
+
+//FK: Every submission runs on its own thread, good enough for the handful of submissions the renderer does per call
+struct TP_CALLBACK_INSTANCE;
+struct TP_CALLBACK_ENVIRON;
+struct TP_WORK;
+
+typedef TP_CALLBACK_INSTANCE*   PTP_CALLBACK_INSTANCE;
+typedef TP_CALLBACK_ENVIRON*    PTP_CALLBACK_ENVIRON;
+typedef TP_WORK*                PTP_WORK;
+typedef void(*PTP_WORK_CALLBACK)(PTP_CALLBACK_INSTANCE, PVOID, PTP_WORK);
+
+struct TP_WORK
+{
+    PTP_WORK_CALLBACK           pCallback;
+    PVOID                       pContext;
+    std::mutex                  mutex;
+    std::vector<std::thread>    threads;
+};
+
+PTP_WORK CreateThreadpoolWork(PTP_WORK_CALLBACK pCallback, PVOID pContext, PTP_CALLBACK_ENVIRON pCallbackEnvironment)
+{
+    (void)pCallbackEnvironment;
+
+    PTP_WORK pWork = new TP_WORK;
+    pWork->pCallback    = pCallback;
+    pWork->pContext     = pContext;
+    return pWork;
+}
+
+void SubmitThreadpoolWork(PTP_WORK pWork)
+{
+    std::lock_guard<std::mutex> lock(pWork->mutex);
+    pWork->threads.emplace_back(pWork->pCallback, nullptr, pWork->pContext, pWork);
+}
+
+void WaitForThreadpoolWorkCallbacks(PTP_WORK pWork, BOOL cancelPendingCallbacks)
+{
+    (void)cancelPendingCallbacks;
+
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(pWork->mutex);
+        threads.swap(pWork->threads);
+    }
+
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void CloseThreadpoolWork(PTP_WORK pWork)
+{
+    WaitForThreadpoolWorkCallbacks(pWork, FALSE);
+    delete pWork;
+}
+
+//FK: COM
+//    Every interface has its own id object, QueryInterface() compares ids by address.
+template<typename T>
+const IID& getNullDeviceInterfaceId()
+{
+    static const IID interfaceId = {};
+    return interfaceId;
+}
+
+template<typename T>
+const IID& getNullDeviceInterfaceId(T**)
+{
+    return getNullDeviceInterfaceId<T>();
+}
+
+#define IID_PPV_ARGS(ppType) getNullDeviceInterfaceId(ppType), (void**)(ppType)
+
+struct IUnknown
+{
+    virtual ~IUnknown() {}
+
+    virtual HRESULT QueryInterface(REFIID riid, void** ppObject)
+    {
+        (void)riid;
+        *ppObject = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG AddRef()
+    {
+        return (ULONG)InterlockedIncrement(&referenceCount);
+    }
+
+    ULONG Release()
+    {
+        const ULONG newReferenceCount = (ULONG)InterlockedDecrement(&referenceCount);
+        if(newReferenceCount == 0u)
+        {
+            delete this;
+        }
+
+        return newReferenceCount;
+    }
+
+    volatile LONG referenceCount = 1;
+};
+
+template<typename T>
+HRESULT returnNullDeviceObject(T* pObject, void** ppObject)
+{
+    if(pObject == nullptr)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    *ppObject = pObject;
+    return S_OK;
+}
+
+struct IMalloc : IUnknown
+{
+    virtual void*   Alloc(SIZE_T sizeInBytes) = 0;
+    virtual void    Free(void* pMemory) = 0;
+    virtual int     DidAlloc(void* pMemory) = 0;
+    virtual void*   Realloc(void* pMemory, SIZE_T newSizeInBytes) = 0;
+    virtual SIZE_T  GetSize(void* pMemory) = 0;
+    virtual void    HeapMinimize() = 0;
+};
+
+struct ID3D10Blob : IUnknown
+{
+    ID3D10Blob(const void* pData, const SIZE_T sizeInBytes)
+    {
+        pBuffer = malloc(sizeInBytes > 0u ? sizeInBytes : 1u);
+        bufferSizeInBytes = sizeInBytes;
+        if(pData != nullptr)
+        {
+            memcpy(pBuffer, pData, sizeInBytes);
+        }
+    }
+
+    ~ID3D10Blob()
+    {
+        free(pBuffer);
+    }
+
+    void*   GetBufferPointer()  { return pBuffer; }
+    SIZE_T  GetBufferSize()     { return bufferSizeInBytes; }
+
+    void*   pBuffer;
+    SIZE_T  bufferSizeInBytes;
+};
+
+typedef ID3D10Blob ID3DBlob;
+
+//FK: pix
+#define PIX_COLOR(r, g, b) ((UINT64)(0xff000000u | ((r) << 16) | ((g) << 8) | (b)))
+
+template<typename CONTEXT>
+void PIXBeginEvent(CONTEXT* pContext, UINT64 color, LPCSTR pName)
+{
+    (void)pContext;
+    (void)color;
+    (void)pName;
+}
+
+template<typename CONTEXT>
+void PIXEndEvent(CONTEXT* pContext)
+{
+    (void)pContext;
+}
+
+//FK: d3d12
+typedef UINT64 D3D12_GPU_VIRTUAL_ADDRESS;
+
+typedef int32_t D3D_FEATURE_LEVEL;
+enum
+{
+    D3D_FEATURE_LEVEL_12_0 = 0xc000,
+    D3D_FEATURE_LEVEL_12_1 = 0xc100
+};
+
+typedef int32_t D3D12_COMMAND_LIST_TYPE;
+enum
+{
+    D3D12_COMMAND_LIST_TYPE_DIRECT  = 0,
+    D3D12_COMMAND_LIST_TYPE_BUNDLE  = 1,
+    D3D12_COMMAND_LIST_TYPE_COMPUTE = 2,
+    D3D12_COMMAND_LIST_TYPE_COPY    = 3
+};
+
+typedef int32_t D3D12_COMMAND_QUEUE_FLAGS;
+typedef int32_t D3D12_FENCE_FLAGS;
+enum
+{
+    D3D12_COMMAND_QUEUE_FLAG_NONE       = 0,
+    D3D12_COMMAND_QUEUE_PRIORITY_NORMAL = 0,
+    D3D12_FENCE_FLAG_NONE               = 0
+};
+
+struct D3D12_COMMAND_QUEUE_DESC
+{
+    D3D12_COMMAND_LIST_TYPE     Type;
+    int32_t                     Priority;
+    D3D12_COMMAND_QUEUE_FLAGS   Flags;
+    UINT                        NodeMask;
+};
+
+struct D3D12_CPU_DESCRIPTOR_HANDLE
+{
+    SIZE_T ptr;
+};
+
+struct D3D12_GPU_DESCRIPTOR_HANDLE
+{
+    UINT64 ptr;
+};
+
+typedef int32_t D3D12_DESCRIPTOR_HEAP_TYPE;
+enum
+{
+    D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV  = 0,
+    D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER      = 1,
+    D3D12_DESCRIPTOR_HEAP_TYPE_RTV          = 2,
+    D3D12_DESCRIPTOR_HEAP_TYPE_DSV          = 3,
+    D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES    = 4
+};
+
+typedef int32_t D3D12_DESCRIPTOR_HEAP_FLAGS;
+enum
+{
+    D3D12_DESCRIPTOR_HEAP_FLAG_NONE             = 0,
+    D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE   = 1
+};
+
+struct D3D12_DESCRIPTOR_HEAP_DESC
+{
+    D3D12_DESCRIPTOR_HEAP_TYPE  Type;
+    UINT                        NumDescriptors;
+    D3D12_DESCRIPTOR_HEAP_FLAGS Flags;
+    UINT                        NodeMask;
+};
+
+typedef int32_t D3D12_HEAP_TYPE;
+typedef int32_t D3D12_HEAP_FLAGS;
+typedef int32_t D3D12_CPU_PAGE_PROPERTY;
+typedef int32_t D3D12_MEMORY_POOL;
+enum
+{
+    D3D12_HEAP_TYPE_DEFAULT                         = 1,
+    D3D12_HEAP_TYPE_UPLOAD                          = 2,
+    D3D12_HEAP_TYPE_READBACK                        = 3,
+    D3D12_CPU_PAGE_PROPERTY_UNKNOWN                 = 0,
+    D3D12_MEMORY_POOL_UNKNOWN                       = 0,
+    D3D12_HEAP_FLAG_NONE                            = 0,
+    D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES  = 0,
+    D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS              = 0xc0,
+    D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES   = 0x84,
+    D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES       = 0x44
+};
+
+enum
+{
+    D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT      = 65536,
+    D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT = 4194304
+};
+
+struct D3D12_HEAP_PROPERTIES
+{
+    D3D12_HEAP_TYPE         Type;
+    D3D12_CPU_PAGE_PROPERTY CPUPageProperty;
+    D3D12_MEMORY_POOL       MemoryPoolPreference;
+    UINT                    CreationNodeMask;
+    UINT                    VisibleNodeMask;
+};
+
+struct D3D12_HEAP_DESC
+{
+    UINT64                  SizeInBytes;
+    D3D12_HEAP_PROPERTIES   Properties;
+    UINT64                  Alignment;
+    D3D12_HEAP_FLAGS        Flags;
+};
+
+struct D3D12_RANGE
+{
+    SIZE_T Begin;
+    SIZE_T End;
+};
+
+typedef int32_t D3D12_RESOURCE_STATES;
+enum
+{
+    D3D12_RESOURCE_STATE_COMMON                     = 0,
+    D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER = 0x1,
+    D3D12_RESOURCE_STATE_INDEX_BUFFER               = 0x2,
+    D3D12_RESOURCE_STATE_RENDER_TARGET              = 0x4,
+    D3D12_RESOURCE_STATE_UNORDERED_ACCESS           = 0x8,
+    D3D12_RESOURCE_STATE_DEPTH_WRITE                = 0x10,
+    D3D12_RESOURCE_STATE_DEPTH_READ                 = 0x20,
+    D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE  = 0x40,
+    D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE      = 0x80,
+    D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT          = 0x200,
+    D3D12_RESOURCE_STATE_COPY_DEST                  = 0x400,
+    D3D12_RESOURCE_STATE_COPY_SOURCE                = 0x800,
+    D3D12_RESOURCE_STATE_GENERIC_READ               = 0xac3,
+    D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE        = 0xc0,
+    D3D12_RESOURCE_STATE_PRESENT                    = 0
+};
+
+typedef int32_t D3D12_RESOURCE_BARRIER_TYPE;
+typedef int32_t D3D12_RESOURCE_BARRIER_FLAGS;
+enum
+{
+    D3D12_RESOURCE_BARRIER_TYPE_TRANSITION  = 0,
+    D3D12_RESOURCE_BARRIER_TYPE_ALIASING    = 1,
+    D3D12_RESOURCE_BARRIER_TYPE_UAV         = 2,
+    D3D12_RESOURCE_BARRIER_FLAG_NONE        = 0
+};
+
+#define D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES 0xffffffff
+
+struct ID3D12Resource;
+
+struct D3D12_RESOURCE_TRANSITION_BARRIER
+{
+    ID3D12Resource*         pResource;
+    UINT                    Subresource;
+    D3D12_RESOURCE_STATES   StateBefore;
+    D3D12_RESOURCE_STATES   StateAfter;
+};
+
+struct D3D12_RESOURCE_ALIASING_BARRIER
+{
+    ID3D12Resource* pResourceBefore;
+    ID3D12Resource* pResourceAfter;
+};
+
+struct D3D12_RESOURCE_UAV_BARRIER
+{
+    ID3D12Resource* pResource;
+};
+
+struct D3D12_RESOURCE_BARRIER
+{
+    D3D12_RESOURCE_BARRIER_TYPE     Type;
+    D3D12_RESOURCE_BARRIER_FLAGS    Flags;
+    union
+    {
+        D3D12_RESOURCE_TRANSITION_BARRIER   Transition;
+        D3D12_RESOURCE_ALIASING_BARRIER     Aliasing;
+        D3D12_RESOURCE_UAV_BARRIER          UAV;
+    };
+};
+
+typedef int32_t DXGI_FORMAT;
+enum
+{
+    DXGI_FORMAT_UNKNOWN             = 0,
+    DXGI_FORMAT_R32G32B32A32_FLOAT  = 2,
+    DXGI_FORMAT_R32G32B32_FLOAT     = 6,
+    DXGI_FORMAT_R16G16B16A16_FLOAT  = 10,
+    DXGI_FORMAT_R16G16B16A16_SNORM  = 13,
+    DXGI_FORMAT_R32G32_FLOAT        = 16,
+    DXGI_FORMAT_R10G10B10A2_UNORM   = 24,
+    DXGI_FORMAT_R8G8B8A8_UNORM      = 28,
+    DXGI_FORMAT_R8G8B8A8_SNORM      = 31,
+    DXGI_FORMAT_R16G16_FLOAT        = 34,
+    DXGI_FORMAT_R16G16_SNORM        = 37,
+    DXGI_FORMAT_D32_FLOAT           = 40,
+    DXGI_FORMAT_R32_FLOAT           = 41,
+    DXGI_FORMAT_R32_UINT            = 42,
+    DXGI_FORMAT_R8G8_UNORM          = 49,
+    DXGI_FORMAT_R8G8_SNORM          = 51,
+    DXGI_FORMAT_R16_FLOAT           = 54,
+    DXGI_FORMAT_R16_SNORM           = 58,
+    DXGI_FORMAT_R8_UNORM            = 61,
+    DXGI_FORMAT_R8_SNORM            = 63
+};
+
+struct DXGI_SAMPLE_DESC
+{
+    UINT Count;
+    UINT Quality;
+};
+
+typedef int32_t D3D12_RESOURCE_DIMENSION;
+enum
+{
+    D3D12_RESOURCE_DIMENSION_UNKNOWN    = 0,
+    D3D12_RESOURCE_DIMENSION_BUFFER     = 1,
+    D3D12_RESOURCE_DIMENSION_TEXTURE1D  = 2,
+    D3D12_RESOURCE_DIMENSION_TEXTURE2D  = 3,
+    D3D12_RESOURCE_DIMENSION_TEXTURE3D  = 4
+};
+
+typedef int32_t D3D12_TEXTURE_LAYOUT;
+enum
+{
+    D3D12_TEXTURE_LAYOUT_UNKNOWN    = 0,
+    D3D12_TEXTURE_LAYOUT_ROW_MAJOR  = 1
+};
+
+typedef int32_t D3D12_RESOURCE_FLAGS;
+enum
+{
+    D3D12_RESOURCE_FLAG_NONE                    = 0,
+    D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET     = 0x1,
+    D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL     = 0x2,
+    D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS  = 0x4
+};
+
+struct D3D12_RESOURCE_DESC
+{
+    D3D12_RESOURCE_DIMENSION    Dimension;
+    UINT64                      Alignment;
+    UINT64                      Width;
+    UINT                        Height;
+    uint16_t                    DepthOrArraySize;
+    uint16_t                    MipLevels;
+    DXGI_FORMAT                 Format;
+    DXGI_SAMPLE_DESC            SampleDesc;
+    D3D12_TEXTURE_LAYOUT        Layout;
+    D3D12_RESOURCE_FLAGS        Flags;
+};
+
+struct D3D12_RESOURCE_ALLOCATION_INFO
+{
+    UINT64 SizeInBytes;
+    UINT64 Alignment;
+};
+
+struct D3D12_CLEAR_VALUE
+{
+    DXGI_FORMAT Format;
+    FLOAT       Color[4];
+};
+
+struct D3D12_VERTEX_BUFFER_VIEW
+{
+    D3D12_GPU_VIRTUAL_ADDRESS   BufferLocation;
+    UINT                        SizeInBytes;
+    UINT                        StrideInBytes;
+};
+
+typedef int32_t D3D12_PRIMITIVE_TOPOLOGY;
+typedef int32_t D3D_PRIMITIVE_TOPOLOGY;
+enum
+{
+    D3D_PRIMITIVE_TOPOLOGY_UNDEFINED    = 0,
+    D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST = 4
+};
+
+typedef int32_t D3D12_PRIMITIVE_TOPOLOGY_TYPE;
+enum
+{
+    D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE = 3
+};
+
+typedef int32_t D3D12_BLEND;
+enum
+{
+    D3D12_BLEND_ZERO            = 1,
+    D3D12_BLEND_ONE             = 2,
+    D3D12_BLEND_SRC_ALPHA       = 5,
+    D3D12_BLEND_INV_SRC_ALPHA   = 6
+};
+
+typedef int32_t D3D12_BLEND_OP;
+enum
+{
+    D3D12_BLEND_OP_ADD = 1
+};
+
+typedef int32_t D3D12_LOGIC_OP;
+enum
+{
+    D3D12_LOGIC_OP_NOOP = 4
+};
+
+enum
+{
+    D3D12_COLOR_WRITE_ENABLE_ALL = 0xF
+};
+
+typedef int32_t D3D12_FILL_MODE;
+enum
+{
+    D3D12_FILL_MODE_WIREFRAME   = 2,
+    D3D12_FILL_MODE_SOLID       = 3
+};
+
+typedef int32_t D3D12_CULL_MODE;
+enum
+{
+    D3D12_CULL_MODE_NONE    = 1,
+    D3D12_CULL_MODE_FRONT   = 2,
+    D3D12_CULL_MODE_BACK    = 3
+};
+
+typedef int32_t D3D12_CONSERVATIVE_RASTERIZATION_MODE;
+enum
+{
+    D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF = 0
+};
+
+typedef int32_t D3D12_DEPTH_WRITE_MASK;
+enum
+{
+    D3D12_DEPTH_WRITE_MASK_ZERO = 0,
+    D3D12_DEPTH_WRITE_MASK_ALL  = 1
+};
+
+typedef int32_t D3D12_COMPARISON_FUNC;
+enum
+{
+    D3D12_COMPARISON_FUNC_NEVER         = 1,
+    D3D12_COMPARISON_FUNC_LESS          = 2,
+    D3D12_COMPARISON_FUNC_EQUAL         = 3,
+    D3D12_COMPARISON_FUNC_LESS_EQUAL    = 4,
+    D3D12_COMPARISON_FUNC_ALWAYS        = 8
+};
+
+typedef int32_t D3D12_STENCIL_OP;
+enum
+{
+    D3D12_STENCIL_OP_KEEP = 1
+};
+
+#define D3D12_DEFAULT_STENCIL_READ_MASK     0xFF
+#define D3D12_DEFAULT_STENCIL_WRITE_MASK    0xFF
+
+struct D3D12_VIEWPORT
+{
+    FLOAT TopLeftX;
+    FLOAT TopLeftY;
+    FLOAT Width;
+    FLOAT Height;
+    FLOAT MinDepth;
+    FLOAT MaxDepth;
+};
+
+typedef RECT D3D12_RECT;
+
+typedef int32_t D3D12_INPUT_CLASSIFICATION;
+enum
+{
+    D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA      = 0,
+    D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA    = 1
+};
+
+#define D3D12_APPEND_ALIGNED_ELEMENT 0xffffffff
+
+struct D3D12_INPUT_ELEMENT_DESC
+{
+    LPCSTR                      SemanticName;
+    UINT                        SemanticIndex;
+    DXGI_FORMAT                 Format;
+    UINT                        InputSlot;
+    UINT                        AlignedByteOffset;
+    D3D12_INPUT_CLASSIFICATION  InputSlotClass;
+    UINT                        InstanceDataStepRate;
+};
+
+struct D3D12_INPUT_LAYOUT_DESC
+{
+    const D3D12_INPUT_ELEMENT_DESC* pInputElementDescs;
+    UINT                            NumElements;
+};
+
+struct D3D12_SHADER_BYTECODE
+{
+    const void* pShaderBytecode;
+    SIZE_T      BytecodeLength;
+};
+
+struct D3D12_RENDER_TARGET_BLEND_DESC
+{
+    BOOL    BlendEnable;
+    BOOL    LogicOpEnable;
+    int32_t SrcBlend;
+    int32_t DestBlend;
+    int32_t BlendOp;
+    int32_t SrcBlendAlpha;
+    int32_t DestBlendAlpha;
+    int32_t BlendOpAlpha;
+    int32_t LogicOp;
+    uint8_t RenderTargetWriteMask;
+};
+
+struct D3D12_BLEND_DESC
+{
+    BOOL                            AlphaToCoverageEnable;
+    BOOL                            IndependentBlendEnable;
+    D3D12_RENDER_TARGET_BLEND_DESC  RenderTarget[8];
+};
+
+struct D3D12_RASTERIZER_DESC
+{
+    int32_t FillMode;
+    int32_t CullMode;
+    BOOL    FrontCounterClockwise;
+    int32_t DepthBias;
+    FLOAT   DepthBiasClamp;
+    FLOAT   SlopeScaledDepthBias;
+    BOOL    DepthClipEnable;
+    BOOL    MultisampleEnable;
+    BOOL    AntialiasedLineEnable;
+    UINT    ForcedSampleCount;
+    int32_t ConservativeRaster;
+};
+
+struct D3D12_DEPTH_STENCILOP_DESC
+{
+    int32_t StencilFailOp;
+    int32_t StencilDepthFailOp;
+    int32_t StencilPassOp;
+    int32_t StencilFunc;
+};
+
+struct D3D12_DEPTH_STENCIL_DESC
+{
+    BOOL                        DepthEnable;
+    int32_t                     DepthWriteMask;
+    int32_t                     DepthFunc;
+    BOOL                        StencilEnable;
+    uint8_t                     StencilReadMask;
+    uint8_t                     StencilWriteMask;
+    D3D12_DEPTH_STENCILOP_DESC  FrontFace;
+    D3D12_DEPTH_STENCILOP_DESC  BackFace;
+};
+
+struct D3D12_CACHED_PIPELINE_STATE
+{
+    const void* pCachedBlob;
+    SIZE_T      CachedBlobSizeInBytes;
+};
+
+struct ID3D12RootSignature;
+
+struct D3D12_GRAPHICS_PIPELINE_STATE_DESC
+{
+    ID3D12RootSignature*            pRootSignature;
+    D3D12_SHADER_BYTECODE           VS;
+    D3D12_SHADER_BYTECODE           PS;
+    D3D12_SHADER_BYTECODE           DS;
+    D3D12_SHADER_BYTECODE           HS;
+    D3D12_SHADER_BYTECODE           GS;
+    int32_t                         StreamOutput;
+    D3D12_BLEND_DESC                BlendState;
+    UINT                            SampleMask;
+    D3D12_RASTERIZER_DESC           RasterizerState;
+    D3D12_DEPTH_STENCIL_DESC        DepthStencilState;
+    D3D12_INPUT_LAYOUT_DESC         InputLayout;
+    int32_t                         IBStripCutValue;
+    D3D12_PRIMITIVE_TOPOLOGY_TYPE   PrimitiveTopologyType;
+    UINT                            NumRenderTargets;
+    DXGI_FORMAT                     RTVFormats[8];
+    DXGI_FORMAT                     DSVFormat;
+    DXGI_SAMPLE_DESC                SampleDesc;
+    UINT                            NodeMask;
+    D3D12_CACHED_PIPELINE_STATE     CachedPSO;
+    int32_t                         Flags;
+};
+
+typedef int32_t D3D12_ROOT_SIGNATURE_FLAGS;
+enum
+{
+    D3D12_ROOT_SIGNATURE_FLAG_NONE                                  = 0,
+    D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT    = 0x1,
+    D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED     = 0x400
+};
+
+typedef int32_t D3D12_ROOT_PARAMETER_TYPE;
+enum
+{
+    D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE  = 0,
+    D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS   = 1,
+    D3D12_ROOT_PARAMETER_TYPE_CBV               = 2,
+    D3D12_ROOT_PARAMETER_TYPE_SRV               = 3,
+    D3D12_ROOT_PARAMETER_TYPE_UAV               = 4
+};
+
+typedef int32_t D3D12_SHADER_VISIBILITY;
+enum
+{
+    D3D12_SHADER_VISIBILITY_ALL     = 0,
+    D3D12_SHADER_VISIBILITY_VERTEX  = 1,
+    D3D12_SHADER_VISIBILITY_PIXEL   = 5
+};
+
+typedef int32_t D3D12_DESCRIPTOR_RANGE_TYPE;
+enum
+{
+    D3D12_DESCRIPTOR_RANGE_TYPE_SRV     = 0,
+    D3D12_DESCRIPTOR_RANGE_TYPE_UAV     = 1,
+    D3D12_DESCRIPTOR_RANGE_TYPE_CBV     = 2,
+    D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER = 3
+};
+
+#define D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND 0xffffffff
+
+struct D3D12_DESCRIPTOR_RANGE
+{
+    D3D12_DESCRIPTOR_RANGE_TYPE RangeType;
+    UINT                        NumDescriptors;
+    UINT                        BaseShaderRegister;
+    UINT                        RegisterSpace;
+    UINT                        OffsetInDescriptorsFromTableStart;
+};
+
+struct D3D12_ROOT_DESCRIPTOR_TABLE
+{
+    UINT                            NumDescriptorRanges;
+    const D3D12_DESCRIPTOR_RANGE*   pDescriptorRanges;
+};
+
+struct D3D12_ROOT_CONSTANTS
+{
+    UINT ShaderRegister;
+    UINT RegisterSpace;
+    UINT Num32BitValues;
+};
+
+struct D3D12_ROOT_DESCRIPTOR
+{
+    UINT ShaderRegister;
+    UINT RegisterSpace;
+};
+
+struct D3D12_ROOT_PARAMETER
+{
+    D3D12_ROOT_PARAMETER_TYPE ParameterType;
+    union
+    {
+        D3D12_ROOT_DESCRIPTOR_TABLE DescriptorTable;
+        D3D12_ROOT_CONSTANTS        Constants;
+        D3D12_ROOT_DESCRIPTOR       Descriptor;
+    };
+    D3D12_SHADER_VISIBILITY ShaderVisibility;
+};
+
+typedef int32_t D3D12_FILTER;
+typedef int32_t D3D12_TEXTURE_ADDRESS_MODE;
+typedef int32_t D3D12_STATIC_BORDER_COLOR;
+
+struct D3D12_STATIC_SAMPLER_DESC
+{
+    D3D12_FILTER                Filter;
+    D3D12_TEXTURE_ADDRESS_MODE  AddressU;
+    D3D12_TEXTURE_ADDRESS_MODE  AddressV;
+    D3D12_TEXTURE_ADDRESS_MODE  AddressW;
+    FLOAT                       MipLODBias;
+    UINT                        MaxAnisotropy;
+    D3D12_COMPARISON_FUNC       ComparisonFunc;
+    D3D12_STATIC_BORDER_COLOR   BorderColor;
+    FLOAT                       MinLOD;
+    FLOAT                       MaxLOD;
+    UINT                        ShaderRegister;
+    UINT                        RegisterSpace;
+    D3D12_SHADER_VISIBILITY     ShaderVisibility;
+};
+
+enum
+{
+    D3D12_FILTER_MIN_MAG_MIP_POINT          = 0,
+    D3D12_FILTER_MIN_MAG_MIP_LINEAR         = 0x15,
+    D3D12_TEXTURE_ADDRESS_MODE_WRAP         = 1,
+    D3D12_TEXTURE_ADDRESS_MODE_CLAMP        = 3,
+    D3D12_STATIC_BORDER_COLOR_OPAQUE_BLACK  = 1
+};
+
+#define D3D12_FLOAT32_MAX 3.402823466e+38f
+
+typedef int32_t D3D12_SRV_DIMENSION;
+enum
+{
+    D3D12_SRV_DIMENSION_BUFFER      = 1,
+    D3D12_SRV_DIMENSION_TEXTURE2D   = 4
+};
+
+#define D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING 0x1688
+
+struct D3D12_BUFFER_SRV
+{
+    UINT64  FirstElement;
+    UINT    NumElements;
+    UINT    StructureByteStride;
+    int32_t Flags;
+};
+
+struct D3D12_TEX2D_SRV
+{
+    UINT    MostDetailedMip;
+    UINT    MipLevels;
+    UINT    PlaneSlice;
+    FLOAT   ResourceMinLODClamp;
+};
+
+struct D3D12_SHADER_RESOURCE_VIEW_DESC
+{
+    DXGI_FORMAT         Format;
+    D3D12_SRV_DIMENSION ViewDimension;
+    UINT                Shader4ComponentMapping;
+    union
+    {
+        D3D12_BUFFER_SRV    Buffer;
+        D3D12_TEX2D_SRV     Texture2D;
+    };
+};
+
+struct D3D12_CONSTANT_BUFFER_VIEW_DESC
+{
+    D3D12_GPU_VIRTUAL_ADDRESS   BufferLocation;
+    UINT                        SizeInBytes;
+};
+
+struct D3D12_ROOT_SIGNATURE_DESC
+{
+    UINT                                NumParameters;
+    const D3D12_ROOT_PARAMETER*         pParameters;
+    UINT                                NumStaticSamplers;
+    const D3D12_STATIC_SAMPLER_DESC*    pStaticSamplers;
+    D3D12_ROOT_SIGNATURE_FLAGS          Flags;
+};
+
+typedef int32_t D3D_ROOT_SIGNATURE_VERSION;
+enum
+{
+    D3D_ROOT_SIGNATURE_VERSION_1_0 = 0x1
+};
+
+typedef int32_t D3D12_MESSAGE_SEVERITY;
+enum
+{
+    D3D12_MESSAGE_SEVERITY_CORRUPTION   = 0,
+    D3D12_MESSAGE_SEVERITY_ERROR        = 1,
+    D3D12_MESSAGE_SEVERITY_WARNING      = 2
+};
+
+//FK: Everything the GPU would have done
+struct null_device_statistics_t
+{
+    uint64_t executeCallCount;
+    uint64_t executedCommandListCount;
+    uint64_t drawCallCount;
+    uint64_t resourceBarrierCount;
+    uint64_t clearCount;
+    uint64_t discardCount;
+    uint64_t copyCount;
+    uint64_t copiedSizeInBytes;
+    uint64_t stateChangeCount;
+    uint64_t rootConstantCount;         // 32 bit values set with SetGraphicsRoot32BitConstants()
+    uint64_t signalCount;
+    uint64_t waitCount;                 // GPU side waits of a command queue for a fence
+    uint64_t presentCount;
+    uint64_t rootSignatureCount;        // created root signatures
+    uint64_t pipelineStateCount;        // created pipeline state objects
+    uint64_t loadedPipelineStateCount;  // pipeline state objects loaded from a pipeline library
+};
+
+//FK: How long the simulated GPU takes for each command, all zero = infinitely fast GPU
+struct null_device_cost_model_t
+{
+    uint64_t commandListCostInNanoseconds;
+    uint64_t drawCallCostInNanoseconds;
+    uint64_t resourceBarrierCostInNanoseconds;
+    uint64_t clearCostInNanoseconds;
+    uint64_t copyCostInNanosecondsPerKiB;
+};
+
+//FK: CPU time that CreateGraphicsPipelineState() keeps the calling thread busy, the driver compiles the shaders at this point
+uint64_t nullPipelineStateCompilerCostInNanoseconds = 0u;
+
+void setNullPipelineStateCompilerCost(const uint64_t costPerPipelineStateInNanoseconds)
+{
+    nullPipelineStateCompilerCostInNanoseconds = costPerPipelineStateInNanoseconds;
+}
+
+//FK: Barriers and discards of all command lists in the order they got recorded, discards have pDiscardedResource set
+struct null_resource_command_t
+{
+    D3D12_RESOURCE_BARRIER  barrier;
+    ID3D12Resource*         pDiscardedResource;
+};
+
+struct null_resource_command_log_t
+{
+    null_resource_command_t*    pCommands;
+    uint32_t                    maxCommandCount;
+    volatile LONG               commandCount;
+};
+
+null_resource_command_log_t* pNullResourceCommandLog = nullptr;
+
+//FK: Lets tests check which barriers got issued, nullptr stops logging
+void setNullResourceCommandLog(null_resource_command_log_t* pCommandLog)
+{
+    pNullResourceCommandLog = pCommandLog;
+}
+
+void logNullResourceCommand(const D3D12_RESOURCE_BARRIER* pBarrier, ID3D12Resource* pDiscardedResource)
+{
+    if(pNullResourceCommandLog == nullptr)
+    {
+        return;
+    }
+
+    const uint32_t commandIndex = (uint32_t)InterlockedIncrement(&pNullResourceCommandLog->commandCount) - 1u;
+    if(commandIndex >= pNullResourceCommandLog->maxCommandCount)
+    {
+        return;
+    }
+
+    null_resource_command_t* pCommand = pNullResourceCommandLog->pCommands + commandIndex;
+    *pCommand = {};
+    if(pBarrier != nullptr)
+    {
+        pCommand->barrier = *pBarrier;
+    }
+    pCommand->pDiscardedResource = pDiscardedResource;
+}
+
+//FK: Pipeline libraries are only valid for the adapter and driver version that serialized them
+uint32_t nullAdapterId      = 1u;
+uint32_t nullDriverVersion  = 1u;
+
+void setNullAdapter(const uint32_t adapterId, const uint32_t driverVersion)
+{
+    nullAdapterId       = adapterId;
+    nullDriverVersion   = driverVersion;
+}
+
+struct ID3D12Device10;
+
+struct ID3D12Object : IUnknown
+{
+    HRESULT SetName(LPCWSTR pName)
+    {
+        (void)pName;
+        return S_OK;
+    }
+};
+
+struct ID3D12DeviceChild : ID3D12Object
+{
+    ID3D12Device10* pDevice = nullptr;
+};
+
+struct ID3D12Pageable : ID3D12DeviceChild
+{
+};
+
+struct ID3D12Heap : ID3D12Pageable
+{
+    D3D12_HEAP_DESC desc;
+};
+
+struct ID3D12RootSignature : ID3D12DeviceChild
+{
+};
+
+struct ID3D12PipelineState : ID3D12Pageable
+{
+};
+
+//FK: Serialized as null_pipeline_library_header_t followed by the length prefixed pipeline names
+struct null_pipeline_library_header_t
+{
+    uint32_t adapterId;
+    uint32_t driverVersion;
+    uint32_t pipelineCount;
+};
+
+struct ID3D12PipelineLibrary : ID3D12DeviceChild
+{
+    const std::wstring* findPipeline(LPCWSTR pName)
+    {
+        for(const std::wstring& pipelineName : pipelineNames)
+        {
+            if(pipelineName == pName)
+            {
+                return &pipelineName;
+            }
+        }
+
+        return nullptr;
+    }
+
+    HRESULT StorePipeline(LPCWSTR pName, ID3D12PipelineState* pPipeline)
+    {
+        (void)pPipeline;
+
+        std::lock_guard<std::mutex> lockGuard(mutex);
+        if(pName == nullptr || findPipeline(pName) != nullptr)
+        {
+            return E_INVALIDARG;
+        }
+
+        pipelineNames.push_back(pName);
+        return S_OK;
+    }
+
+    HRESULT LoadGraphicsPipeline(LPCWSTR pName, const D3D12_GRAPHICS_PIPELINE_STATE_DESC* pDesc, REFIID riid, void** ppPipelineState);
+
+    SIZE_T GetSerializedSize()
+    {
+        std::lock_guard<std::mutex> lockGuard(mutex);
+
+        SIZE_T serializedSizeInBytes = sizeof(null_pipeline_library_header_t);
+        for(const std::wstring& pipelineName : pipelineNames)
+        {
+            serializedSizeInBytes += sizeof(uint32_t) + pipelineName.size() * sizeof(wchar_t);
+        }
+
+        return serializedSizeInBytes;
+    }
+
+    HRESULT Serialize(void* pData, SIZE_T dataSizeInBytes)
+    {
+        if(dataSizeInBytes < GetSerializedSize())
+        {
+            return E_INVALIDARG;
+        }
+
+        std::lock_guard<std::mutex> lockGuard(mutex);
+
+        null_pipeline_library_header_t header = {};
+        header.adapterId        = nullAdapterId;
+        header.driverVersion    = nullDriverVersion;
+        header.pipelineCount    = (uint32_t)pipelineNames.size();
+
+        uint8_t* pDataBytes = (uint8_t*)pData;
+        memcpy(pDataBytes, &header, sizeof(header));
+        pDataBytes += sizeof(header);
+
+        for(const std::wstring& pipelineName : pipelineNames)
+        {
+            const uint32_t nameLength = (uint32_t)pipelineName.size();
+            memcpy(pDataBytes, &nameLength, sizeof(nameLength));
+            memcpy(pDataBytes + sizeof(nameLength), pipelineName.data(), nameLength * sizeof(wchar_t));
+            pDataBytes += sizeof(nameLength) + nameLength * sizeof(wchar_t);
+        }
+
+        return S_OK;
+    }
+
+    HRESULT deserialize(const uint8_t* pData, const SIZE_T dataSizeInBytes)
+    {
+        null_pipeline_library_header_t header = {};
+        if(dataSizeInBytes < sizeof(header))
+        {
+            return E_INVALIDARG;
+        }
+
+        memcpy(&header, pData, sizeof(header));
+        if(header.adapterId != nullAdapterId)
+        {
+            return D3D12_ERROR_ADAPTER_NOT_FOUND;
+        }
+
+        if(header.driverVersion != nullDriverVersion)
+        {
+            return D3D12_ERROR_DRIVER_VERSION_MISMATCH;
+        }
+
+        SIZE_T offsetInBytes = sizeof(header);
+        for(uint32_t pipelineIndex = 0u; pipelineIndex < header.pipelineCount; ++pipelineIndex)
+        {
+            uint32_t nameLength = 0u;
+            if(dataSizeInBytes - offsetInBytes < sizeof(nameLength))
+            {
+                return E_INVALIDARG;
+            }
+
+            memcpy(&nameLength, pData + offsetInBytes, sizeof(nameLength));
+            offsetInBytes += sizeof(nameLength);
+            if((dataSizeInBytes - offsetInBytes) / sizeof(wchar_t) < nameLength)
+            {
+                return E_INVALIDARG;
+            }
+
+            std::wstring pipelineName(nameLength, L'\0');
+            memcpy(&pipelineName[0], pData + offsetInBytes, nameLength * sizeof(wchar_t));
+            pipelineNames.push_back(pipelineName);
+            offsetInBytes += nameLength * sizeof(wchar_t);
+        }
+
+        return offsetInBytes == dataSizeInBytes ? S_OK : E_INVALIDARG;
+    }
+
+    std::vector<std::wstring>   pipelineNames;
+    std::mutex                  mutex;
+};
+
+struct ID3D12CommandAllocator : ID3D12Pageable
+{
+    HRESULT Reset()
+    {
+        return S_OK;
+    }
+};
+
+struct ID3D12Resource : ID3D12Pageable
+{
+    ~ID3D12Resource()
+    {
+        _aligned_free(pCPUMemory);
+    }
+
+    //FK: Only upload and readback resources have memory behind them
+    HRESULT Map(UINT subresource, const D3D12_RANGE* pReadRange, void** ppData)
+    {
+        (void)subresource;
+        (void)pReadRange;
+        if(pCPUMemory == nullptr)
+        {
+            return E_INVALIDARG;
+        }
+
+        *ppData = pCPUMemory;
+        return S_OK;
+    }
+
+    void Unmap(UINT subresource, const D3D12_RANGE* pWrittenRange)
+    {
+        (void)subresource;
+        (void)pWrittenRange;
+    }
+
+    D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress()
+    {
+        return gpuVirtualAddress;
+    }
+
+    D3D12_RESOURCE_DESC GetDesc()
+    {
+        return desc;
+    }
+
+    D3D12_RESOURCE_DESC         desc = {};
+    void*                       pCPUMemory = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS   gpuVirtualAddress = 0u;
+};
+
+struct ID3D12DescriptorHeap : ID3D12Pageable
+{
+    ~ID3D12DescriptorHeap()
+    {
+        free(pDescriptors);
+    }
+
+    D3D12_CPU_DESCRIPTOR_HANDLE GetCPUDescriptorHandleForHeapStart()
+    {
+        D3D12_CPU_DESCRIPTOR_HANDLE handle = {(SIZE_T)pDescriptors};
+        return handle;
+    }
+
+    D3D12_GPU_DESCRIPTOR_HANDLE GetGPUDescriptorHandleForHeapStart()
+    {
+        D3D12_GPU_DESCRIPTOR_HANDLE handle = {(UINT64)pDescriptors};
+        return handle;
+    }
+
+    D3D12_DESCRIPTOR_HEAP_DESC GetDesc()
+    {
+        return desc;
+    }
+
+    D3D12_DESCRIPTOR_HEAP_DESC  desc = {};
+    void*                       pDescriptors = nullptr;
+};
+
+struct ID3D12CommandList : ID3D12DeviceChild
+{
+};
+
+struct ID3D12GraphicsCommandList : ID3D12CommandList
+{
+    HRESULT Close()
+    {
+        if(!isOpen)
+        {
+            return E_FAIL;
+        }
+
+        isOpen = false;
+        return S_OK;
+    }
+
+    HRESULT Reset(ID3D12CommandAllocator* pAllocator, ID3D12PipelineState* pInitialState)
+    {
+        (void)pAllocator;
+        (void)pInitialState;
+        if(isOpen)
+        {
+            return E_FAIL;
+        }
+
+        isOpen = true;
+        recorded = {};
+        return S_OK;
+    }
+
+    void ResourceBarrier(UINT barrierCount, const D3D12_RESOURCE_BARRIER* pBarriers)
+    {
+        for(UINT barrierIndex = 0u; barrierIndex < barrierCount; ++barrierIndex)
+        {
+            logNullResourceCommand(pBarriers + barrierIndex, nullptr);
+        }
+
+        recorded.resourceBarrierCount += barrierCount;
+    }
+
+    void DiscardResource(ID3D12Resource* pResource, const void* pRegion)
+    {
+        (void)pRegion;
+        logNullResourceCommand(nullptr, pResource);
+        ++recorded.discardCount;
+    }
+
+    void CopyBufferRegion(ID3D12Resource* pDstBuffer, UINT64 dstOffset, ID3D12Resource* pSrcBuffer, UINT64 srcOffset, UINT64 sizeInBytes)
+    {
+        (void)pDstBuffer;
+        (void)dstOffset;
+        (void)pSrcBuffer;
+        (void)srcOffset;
+        ++recorded.copyCount;
+        recorded.copiedSizeInBytes += sizeInBytes;
+    }
+
+    void ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE renderTargetView, const FLOAT colorRGBA[4], UINT rectCount, const D3D12_RECT* pRects)
+    {
+        (void)renderTargetView;
+        (void)colorRGBA;
+        (void)rectCount;
+        (void)pRects;
+        ++recorded.clearCount;
+    }
+
+    void DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation)
+    {
+        (void)vertexCountPerInstance;
+        (void)instanceCount;
+        (void)startVertexLocation;
+        (void)startInstanceLocation;
+        ++recorded.drawCallCount;
+    }
+
+    void RSSetViewports(UINT viewportCount, const D3D12_VIEWPORT* pViewports)                   { (void)viewportCount; (void)pViewports; ++recorded.stateChangeCount; }
+    void RSSetScissorRects(UINT rectCount, const D3D12_RECT* pRects)                            { (void)rectCount; (void)pRects; ++recorded.stateChangeCount; }
+    void SetPipelineState(ID3D12PipelineState* pPipelineState)                                  { (void)pPipelineState; ++recorded.stateChangeCount; }
+    void SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature)                          { (void)pRootSignature; ++recorded.stateChangeCount; }
+    void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY primitiveTopology)                     { (void)primitiveTopology; ++recorded.stateChangeCount; }
+    void IASetVertexBuffers(UINT startSlot, UINT viewCount, const D3D12_VERTEX_BUFFER_VIEW* pViews) { (void)startSlot; (void)viewCount; (void)pViews; ++recorded.stateChangeCount; }
+    void SetDescriptorHeaps(UINT heapCount, ID3D12DescriptorHeap* const* ppHeaps)               { (void)heapCount; (void)ppHeaps; ++recorded.stateChangeCount; }
+    void SetGraphicsRootDescriptorTable(UINT rootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor) { (void)rootParameterIndex; (void)baseDescriptor; ++recorded.stateChangeCount; }
+    void SetGraphicsRoot32BitConstants(UINT rootParameterIndex, UINT valueCount, const void* pSrcData, UINT destOffset) { (void)rootParameterIndex; (void)pSrcData; (void)destOffset; ++recorded.stateChangeCount; recorded.rootConstantCount += valueCount; }
+    void SetGraphicsRootConstantBufferView(UINT rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS bufferLocation) { (void)rootParameterIndex; (void)bufferLocation; ++recorded.stateChangeCount; }
+
+    void OMSetRenderTargets(UINT renderTargetCount, const D3D12_CPU_DESCRIPTOR_HANDLE* pRenderTargetDescriptors, BOOL isSingleHandleToDescriptorRange, const D3D12_CPU_DESCRIPTOR_HANDLE* pDepthStencilDescriptor)
+    {
+        (void)renderTargetCount;
+        (void)pRenderTargetDescriptors;
+        (void)isSingleHandleToDescriptorRange;
+        (void)pDepthStencilDescriptor;
+        ++recorded.stateChangeCount;
+    }
+
+    null_device_statistics_t    recorded = {};
+    uint64_t                    executionIndex = 0u;    // executedCommandListCount of the device at the last execution, gives the submission order
+    D3D12_COMMAND_LIST_TYPE     type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+    bool                        isOpen = true;
+};
+
+constexpr uint32_t maxNullFencePendingSignalCount   = 64u;
+constexpr uint32_t maxNullFenceWaitingEventCount    = 16u;
+
+struct null_fence_signal_t
+{
+    UINT64  value;
+    int64_t completionTimeInNanoseconds;
+};
+
+struct null_fence_waiting_event_t
+{
+    UINT64  value;
+    HANDLE  pEvent;
+};
+
+struct ID3D12Fence : ID3D12Pageable
+{
+    //FK: Signals of a fence come from one queue, so they complete in the order they got issued
+    UINT64 GetCompletedValue()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        updateCompletedValue(getNullDeviceTimeInNanoseconds());
+        return completedValue;
+    }
+
+    HRESULT SetEventOnCompletion(UINT64 value, HANDLE pEvent)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        updateCompletedValue(getNullDeviceTimeInNanoseconds());
+        if(completedValue >= value)
+        {
+            lock.unlock();
+            if(pEvent != nullptr)
+            {
+                SetEvent(pEvent);
+            }
+
+            return S_OK;
+        }
+
+        const null_fence_signal_t* pSignal = findPendingSignal(value);
+        if(pSignal == nullptr)
+        {
+            //FK: The signal hasn't been issued yet, schedule the event once it is
+            if(pEvent == nullptr || waitingEventCount == maxNullFenceWaitingEventCount)
+            {
+                return E_FAIL;
+            }
+
+            waitingEvents[waitingEventCount].value  = value;
+            waitingEvents[waitingEventCount].pEvent = pEvent;
+            ++waitingEventCount;
+            return S_OK;
+        }
+
+        const int64_t completionTimeInNanoseconds = pSignal->completionTimeInNanoseconds;
+        lock.unlock();
+
+        //FK: Without event the call blocks until the value has been reached
+        if(pEvent == nullptr)
+        {
+            sleepUntilNullDeviceTime(completionTimeInNanoseconds);
+        }
+        else
+        {
+            scheduleNullEvent(pEvent, completionTimeInNanoseconds);
+        }
+
+        return S_OK;
+    }
+
+    HRESULT Signal(UINT64 value)
+    {
+        addSignal(value, getNullDeviceTimeInNanoseconds());
+        return S_OK;
+    }
+
+    void addSignal(const UINT64 value, const int64_t completionTimeInNanoseconds)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        updateCompletedValue(getNullDeviceTimeInNanoseconds());
+
+        if(pendingSignalCount == maxNullFencePendingSignalCount)
+        {
+            //FK: The CPU is too far ahead of the simulated GPU
+            sleepUntilNullDeviceTime(pendingSignals[0].completionTimeInNanoseconds);
+            updateCompletedValue(pendingSignals[0].completionTimeInNanoseconds);
+        }
+
+        pendingSignals[pendingSignalCount].value                        = value;
+        pendingSignals[pendingSignalCount].completionTimeInNanoseconds  = completionTimeInNanoseconds;
+        ++pendingSignalCount;
+
+        uint32_t waitingEventIndex = 0u;
+        while(waitingEventIndex < waitingEventCount)
+        {
+            if(waitingEvents[waitingEventIndex].value <= value)
+            {
+                scheduleNullEvent(waitingEvents[waitingEventIndex].pEvent, completionTimeInNanoseconds);
+                waitingEvents[waitingEventIndex] = waitingEvents[--waitingEventCount];
+                continue;
+            }
+
+            ++waitingEventIndex;
+        }
+    }
+
+    //FK: Returns -1 if the value hasn't been signaled by anybody yet
+    int64_t getCompletionTimeInNanoseconds(const UINT64 value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(completedValue >= value)
+        {
+            return 0;
+        }
+
+        const null_fence_signal_t* pSignal = findPendingSignal(value);
+        return pSignal != nullptr ? pSignal->completionTimeInNanoseconds : -1;
+    }
+
+    const null_fence_signal_t* findPendingSignal(const UINT64 value) const
+    {
+        for(uint32_t signalIndex = 0u; signalIndex < pendingSignalCount; ++signalIndex)
+        {
+            if(pendingSignals[signalIndex].value >= value)
+            {
+                return pendingSignals + signalIndex;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void updateCompletedValue(const int64_t timeInNanoseconds)
+    {
+        uint32_t completedSignalCount = 0u;
+        while(completedSignalCount < pendingSignalCount && pendingSignals[completedSignalCount].completionTimeInNanoseconds <= timeInNanoseconds)
+        {
+            completedValue = pendingSignals[completedSignalCount].value;
+            ++completedSignalCount;
+        }
+
+        if(completedSignalCount > 0u)
+        {
+            pendingSignalCount -= completedSignalCount;
+            memmove(pendingSignals, pendingSignals + completedSignalCount, sizeof(null_fence_signal_t) * pendingSignalCount);
+        }
+    }
+
+    std::mutex                  mutex;
+    UINT64                      completedValue = 0u;
+    null_fence_signal_t         pendingSignals[maxNullFencePendingSignalCount];
+    uint32_t                    pendingSignalCount = 0u;
+    null_fence_waiting_event_t  waitingEvents[maxNullFenceWaitingEventCount];
+    uint32_t                    waitingEventCount = 0u;
+};
+
+struct ID3D12CommandQueue : ID3D12Pageable
+{
+    void ExecuteCommandLists(UINT commandListCount, ID3D12CommandList* const* ppCommandLists);
+
+    HRESULT Signal(ID3D12Fence* pFence, UINT64 value);
+
+    //FK: GPU side wait, work submitted afterwards can't start before the fence value has been reached
+    HRESULT Wait(ID3D12Fence* pFence, UINT64 value);
+
+    //FK: A wait for a signal that hasn't been issued yet gets resolved once the next work arrives.
+    //    Should the signal still be missing, the queue continues (a real GPU would hang).
+    void resolveWait()
+    {
+        if(pWaitFence == nullptr)
+        {
+            return;
+        }
+
+        const int64_t completionTimeInNanoseconds = pWaitFence->getCompletionTimeInNanoseconds(waitValue);
+        if(completionTimeInNanoseconds > busyUntilTimeInNanoseconds)
+        {
+            busyUntilTimeInNanoseconds = completionTimeInNanoseconds;
+        }
+
+        if(completionTimeInNanoseconds >= 0)
+        {
+            pWaitFence = nullptr;
+        }
+    }
+
+    D3D12_COMMAND_QUEUE_DESC    desc = {};
+    int64_t                     busyUntilTimeInNanoseconds = 0;
+    ID3D12Fence*                pWaitFence = nullptr;
+    UINT64                      waitValue = 0u;
+};
+
+struct ID3D12Debug6 : IUnknown
+{
+    void EnableDebugLayer() {}
+    void SetEnableAutoName(BOOL enable) { (void)enable; }
+};
+
+struct ID3D12InfoQueue : IUnknown
+{
+    HRESULT SetBreakOnSeverity(D3D12_MESSAGE_SEVERITY severity, BOOL enable)
+    {
+        (void)severity;
+        (void)enable;
+        return S_OK;
+    }
+};
+
+struct ID3D12Device10 : ID3D12Object
+{
+    HRESULT QueryInterface(REFIID riid, void** ppObject) override
+    {
+        if(&riid == &getNullDeviceInterfaceId<ID3D12InfoQueue>())
+        {
+            return returnNullDeviceObject(new ID3D12InfoQueue, ppObject);
+        }
+
+        return ID3D12Object::QueryInterface(riid, ppObject);
+    }
+
+    template<typename T>
+    T* createChild()
+    {
+        T* pChild = new T;
+        pChild->pDevice = this;
+        return pChild;
+    }
+
+    HRESULT CreateCommandQueue(const D3D12_COMMAND_QUEUE_DESC* pDesc, REFIID riid, void** ppCommandQueue)
+    {
+        (void)riid;
+        ID3D12CommandQueue* pCommandQueue = createChild<ID3D12CommandQueue>();
+        pCommandQueue->desc = *pDesc;
+        return returnNullDeviceObject(pCommandQueue, ppCommandQueue);
+    }
+
+    HRESULT CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE type, REFIID riid, void** ppCommandAllocator)
+    {
+        (void)type;
+        (void)riid;
+        return returnNullDeviceObject(createChild<ID3D12CommandAllocator>(), ppCommandAllocator);
+    }
+
+    HRESULT CreateCommandList(UINT nodeMask, D3D12_COMMAND_LIST_TYPE type, ID3D12CommandAllocator* pCommandAllocator, ID3D12PipelineState* pInitialState, REFIID riid, void** ppCommandList)
+    {
+        (void)nodeMask;
+        (void)pCommandAllocator;
+        (void)pInitialState;
+        (void)riid;
+        ID3D12GraphicsCommandList* pCommandList = createChild<ID3D12GraphicsCommandList>();
+        pCommandList->type = type;
+        return returnNullDeviceObject(pCommandList, ppCommandList);
+    }
+
+    HRESULT CreateFence(UINT64 initialValue, D3D12_FENCE_FLAGS flags, REFIID riid, void** ppFence)
+    {
+        (void)flags;
+        (void)riid;
+        ID3D12Fence* pFence = createChild<ID3D12Fence>();
+        pFence->completedValue = initialValue;
+        return returnNullDeviceObject(pFence, ppFence);
+    }
+
+    HRESULT CreateDescriptorHeap(const D3D12_DESCRIPTOR_HEAP_DESC* pDesc, REFIID riid, void** ppDescriptorHeap)
+    {
+        (void)riid;
+
+        //FK: Real memory so every descriptor has its own address
+        ID3D12DescriptorHeap* pDescriptorHeap = createChild<ID3D12DescriptorHeap>();
+        pDescriptorHeap->desc = *pDesc;
+        pDescriptorHeap->pDescriptors = calloc(pDesc->NumDescriptors > 0u ? pDesc->NumDescriptors : 1u, GetDescriptorHandleIncrementSize(pDesc->Type));
+        return returnNullDeviceObject(pDescriptorHeap, ppDescriptorHeap);
+    }
+
+    UINT GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE type)
+    {
+        (void)type;
+        return 32u;
+    }
+
+    //FK: Views store what they point to so that copied descriptors can be told apart
+    void CreateRenderTargetView(ID3D12Resource* pResource, const void* pDesc, D3D12_CPU_DESCRIPTOR_HANDLE destDescriptor)
+    {
+        (void)pDesc;
+        memcpy((void*)destDescriptor.ptr, &pResource, sizeof(pResource));
+    }
+
+    void CreateDepthStencilView(ID3D12Resource* pResource, const void* pDesc, D3D12_CPU_DESCRIPTOR_HANDLE destDescriptor)
+    {
+        (void)pDesc;
+        memcpy((void*)destDescriptor.ptr, &pResource, sizeof(pResource));
+    }
+
+    void CreateShaderResourceView(ID3D12Resource* pResource, const D3D12_SHADER_RESOURCE_VIEW_DESC* pDesc, D3D12_CPU_DESCRIPTOR_HANDLE destDescriptor)
+    {
+        (void)pDesc;
+        memcpy((void*)destDescriptor.ptr, &pResource, sizeof(pResource));
+    }
+
+    void CreateConstantBufferView(const D3D12_CONSTANT_BUFFER_VIEW_DESC* pDesc, D3D12_CPU_DESCRIPTOR_HANDLE destDescriptor)
+    {
+        memcpy((void*)destDescriptor.ptr, &pDesc->BufferLocation, sizeof(pDesc->BufferLocation));
+    }
+
+    void CopyDescriptorsSimple(UINT descriptorCount, D3D12_CPU_DESCRIPTOR_HANDLE destDescriptorRangeStart, D3D12_CPU_DESCRIPTOR_HANDLE srcDescriptorRangeStart, D3D12_DESCRIPTOR_HEAP_TYPE type)
+    {
+        memcpy((void*)destDescriptorRangeStart.ptr, (const void*)srcDescriptorRangeStart.ptr, (size_t)descriptorCount * GetDescriptorHandleIncrementSize(type));
+    }
+
+    D3D12_RESOURCE_ALLOCATION_INFO GetResourceAllocationInfo(UINT visibleMask, UINT resourceDescCount, const D3D12_RESOURCE_DESC* pResourceDescs)
+    {
+        (void)visibleMask;
+
+        D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = {0u, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT};
+        for(UINT descIndex = 0u; descIndex < resourceDescCount; ++descIndex)
+        {
+            const D3D12_RESOURCE_DESC* pDesc = pResourceDescs + descIndex;
+            const UINT64 sizeInBytes = pDesc->Dimension == D3D12_RESOURCE_DIMENSION_BUFFER ? pDesc->Width : pDesc->Width * pDesc->Height * pDesc->DepthOrArraySize * 16u;
+            allocationInfo.SizeInBytes += (sizeInBytes + D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1u) & ~(UINT64)(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1u);
+        }
+
+        return allocationInfo;
+    }
+
+    ID3D12Resource* createResource(const D3D12_RESOURCE_DESC* pDesc, const D3D12_HEAP_TYPE heapType)
+    {
+        ID3D12Resource* pResource = createChild<ID3D12Resource>();
+        pResource->desc = *pDesc;
+
+        if(heapType == D3D12_HEAP_TYPE_UPLOAD || heapType == D3D12_HEAP_TYPE_READBACK)
+        {
+            pResource->pCPUMemory = _aligned_malloc((size_t)pDesc->Width, 256u);
+            if(pResource->pCPUMemory == nullptr)
+            {
+                pResource->Release();
+                return nullptr;
+            }
+        }
+
+        //FK: CPU visible resources use their CPU address, everything else gets a unique made up address
+        if(pResource->pCPUMemory != nullptr)
+        {
+            pResource->gpuVirtualAddress = (D3D12_GPU_VIRTUAL_ADDRESS)pResource->pCPUMemory;
+        }
+        else
+        {
+            const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = GetResourceAllocationInfo(0u, 1u, pDesc);
+            pResource->gpuVirtualAddress = nextGPUVirtualAddress;
+            nextGPUVirtualAddress += allocationInfo.SizeInBytes;
+        }
+
+        return pResource;
+    }
+
+    HRESULT CreateCommittedResource(const D3D12_HEAP_PROPERTIES* pHeapProperties, D3D12_HEAP_FLAGS heapFlags, const D3D12_RESOURCE_DESC* pDesc, D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* pOptimizedClearValue, REFIID riid, void** ppResource)
+    {
+        (void)heapFlags;
+        (void)initialState;
+        (void)pOptimizedClearValue;
+        (void)riid;
+        return returnNullDeviceObject(createResource(pDesc, pHeapProperties->Type), ppResource);
+    }
+
+    HRESULT CreateCommittedResource1(const D3D12_HEAP_PROPERTIES* pHeapProperties, D3D12_HEAP_FLAGS heapFlags, const D3D12_RESOURCE_DESC* pDesc, D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* pOptimizedClearValue, void* pProtectedSession, REFIID riid, void** ppResource)
+    {
+        (void)pProtectedSession;
+        return CreateCommittedResource(pHeapProperties, heapFlags, pDesc, initialState, pOptimizedClearValue, riid, ppResource);
+    }
+
+    HRESULT CreateHeap(const D3D12_HEAP_DESC* pDesc, REFIID riid, void** ppHeap)
+    {
+        (void)riid;
+        ID3D12Heap* pHeap = createChild<ID3D12Heap>();
+        pHeap->desc = *pDesc;
+        return returnNullDeviceObject(pHeap, ppHeap);
+    }
+
+    HRESULT CreatePlacedResource(ID3D12Heap* pHeap, UINT64 heapOffset, const D3D12_RESOURCE_DESC* pDesc, D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* pOptimizedClearValue, REFIID riid, void** ppResource)
+    {
+        (void)heapOffset;
+        (void)initialState;
+        (void)pOptimizedClearValue;
+        (void)riid;
+        return returnNullDeviceObject(createResource(pDesc, pHeap->desc.Properties.Type), ppResource);
+    }
+
+    HRESULT CreateRootSignature(UINT nodeMask, const void* pBlobWithRootSignature, SIZE_T blobLengthInBytes, REFIID riid, void** ppRootSignature)
+    {
+        (void)nodeMask;
+        (void)pBlobWithRootSignature;
+        (void)blobLengthInBytes;
+        (void)riid;
+        InterlockedIncrement64((volatile LONG64*)&statistics.rootSignatureCount);
+        return returnNullDeviceObject(createChild<ID3D12RootSignature>(), ppRootSignature);
+    }
+
+    HRESULT CreateGraphicsPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC* pDesc, REFIID riid, void** ppPipelineState)
+    {
+        (void)pDesc;
+        (void)riid;
+
+        const int64_t endTimeInNanoseconds = getNullDeviceTimeInNanoseconds() + (int64_t)nullPipelineStateCompilerCostInNanoseconds;
+        while(getNullDeviceTimeInNanoseconds() < endTimeInNanoseconds)
+        {
+        }
+
+        InterlockedIncrement64((volatile LONG64*)&statistics.pipelineStateCount);
+        return returnNullDeviceObject(createChild<ID3D12PipelineState>(), ppPipelineState);
+    }
+
+    HRESULT CreatePipelineLibrary(const void* pLibraryBlob, SIZE_T blobLengthInBytes, REFIID riid, void** ppPipelineLibrary)
+    {
+        (void)riid;
+        ID3D12PipelineLibrary* pPipelineLibrary = createChild<ID3D12PipelineLibrary>();
+        if(blobLengthInBytes > 0u)
+        {
+            const HRESULT result = pPipelineLibrary->deserialize((const uint8_t*)pLibraryBlob, blobLengthInBytes);
+            if(result != S_OK)
+            {
+                pPipelineLibrary->Release();
+                return result;
+            }
+        }
+
+        return returnNullDeviceObject(pPipelineLibrary, ppPipelineLibrary);
+    }
+
+    HRESULT GetDeviceRemovedReason()
+    {
+        return S_OK;
+    }
+
+    null_device_statistics_t    statistics = {};
+    null_device_cost_model_t    costModel = {};
+    D3D12_GPU_VIRTUAL_ADDRESS   nextGPUVirtualAddress = 0x100000000ull;
+};
+
+void ID3D12CommandQueue::ExecuteCommandLists(UINT commandListCount, ID3D12CommandList* const* ppCommandLists)
+{
+    resolveWait();
+
+    null_device_statistics_t* pStatistics = &pDevice->statistics;
+    const null_device_cost_model_t* pCostModel = &pDevice->costModel;
+    ++pStatistics->executeCallCount;
+
+    const int64_t nowInNanoseconds = getNullDeviceTimeInNanoseconds();
+    if(busyUntilTimeInNanoseconds < nowInNanoseconds)
+    {
+        busyUntilTimeInNanoseconds = nowInNanoseconds;
+    }
+
+    for(UINT commandListIndex = 0u; commandListIndex < commandListCount; ++commandListIndex)
+    {
+        ID3D12GraphicsCommandList* pCommandList = (ID3D12GraphicsCommandList*)ppCommandLists[commandListIndex];
+        const null_device_statistics_t* pRecorded = &pCommandList->recorded;
+        if(pCommandList->isOpen)
+        {
+            fprintf(stderr, "Null device: Command list got executed without being closed.\n");
+        }
+
+        pCommandList->executionIndex = pStatistics->executedCommandListCount++;
+        pStatistics->drawCallCount          += pRecorded->drawCallCount;
+        pStatistics->resourceBarrierCount   += pRecorded->resourceBarrierCount;
+        pStatistics->clearCount             += pRecorded->clearCount;
+        pStatistics->discardCount           += pRecorded->discardCount;
+        pStatistics->copyCount              += pRecorded->copyCount;
+        pStatistics->copiedSizeInBytes      += pRecorded->copiedSizeInBytes;
+        pStatistics->stateChangeCount       += pRecorded->stateChangeCount;
+        pStatistics->rootConstantCount      += pRecorded->rootConstantCount;
+
+        busyUntilTimeInNanoseconds += pCostModel->commandListCostInNanoseconds +
+                                      pRecorded->drawCallCount * pCostModel->drawCallCostInNanoseconds +
+                                      pRecorded->resourceBarrierCount * pCostModel->resourceBarrierCostInNanoseconds +
+                                      pRecorded->clearCount * pCostModel->clearCostInNanoseconds +
+                                      (pRecorded->copiedSizeInBytes / 1024u) * pCostModel->copyCostInNanosecondsPerKiB;
+    }
+}
+
+HRESULT ID3D12CommandQueue::Signal(ID3D12Fence* pFence, UINT64 value)
+{
+    resolveWait();
+
+    const int64_t nowInNanoseconds = getNullDeviceTimeInNanoseconds();
+    if(busyUntilTimeInNanoseconds < nowInNanoseconds)
+    {
+        busyUntilTimeInNanoseconds = nowInNanoseconds;
+    }
+
+    ++pDevice->statistics.signalCount;
+    pFence->addSignal(value, busyUntilTimeInNanoseconds);
+    return S_OK;
+}
+
+HRESULT ID3D12CommandQueue::Wait(ID3D12Fence* pFence, UINT64 value)
+{
+    resolveWait();
+
+    ++pDevice->statistics.waitCount;
+    pWaitFence  = pFence;
+    waitValue   = value;
+    resolveWait();
+    return S_OK;
+}
+
+HRESULT ID3D12PipelineLibrary::LoadGraphicsPipeline(LPCWSTR pName, const D3D12_GRAPHICS_PIPELINE_STATE_DESC* pDesc, REFIID riid, void** ppPipelineState)
+{
+    (void)pDesc;
+    (void)riid;
+
+    {
+        std::lock_guard<std::mutex> lockGuard(mutex);
+        if(findPipeline(pName) == nullptr)
+        {
+            return E_INVALIDARG;
+        }
+    }
+
+    InterlockedIncrement64((volatile LONG64*)&pDevice->statistics.loadedPipelineStateCount);
+    return returnNullDeviceObject(pDevice->createChild<ID3D12PipelineState>(), ppPipelineState);
+}
+
+HRESULT D3D12CreateDevice(IUnknown* pAdapter, D3D_FEATURE_LEVEL minimumFeatureLevel, REFIID riid, void** ppDevice)
+{
+    (void)pAdapter;
+    (void)minimumFeatureLevel;
+    (void)riid;
+    return returnNullDeviceObject(new ID3D12Device10, ppDevice);
+}
+
+HRESULT D3D12GetDebugInterface(REFIID riid, void** ppDebug)
+{
+    (void)riid;
+    return returnNullDeviceObject(new ID3D12Debug6, ppDebug);
+}
+
+void appendNullRootSignatureData(std::vector<uint8_t>* pBlob, const void* pData, const size_t sizeInBytes)
+{
+    pBlob->insert(pBlob->end(), (const uint8_t*)pData, (const uint8_t*)pData + sizeInBytes);
+}
+
+//FK: Flattens the desc without pointers, so equal layouts serialize to equal blobs - same as the real serializer
+HRESULT D3D12SerializeRootSignature(const D3D12_ROOT_SIGNATURE_DESC* pRootSignature, D3D_ROOT_SIGNATURE_VERSION version, ID3DBlob** ppBlob, ID3DBlob** ppErrorBlob)
+{
+    std::vector<uint8_t> blob;
+    appendNullRootSignatureData(&blob, &version, sizeof(version));
+    appendNullRootSignatureData(&blob, &pRootSignature->Flags, sizeof(pRootSignature->Flags));
+    appendNullRootSignatureData(&blob, &pRootSignature->NumParameters, sizeof(pRootSignature->NumParameters));
+    for(UINT parameterIndex = 0u; parameterIndex < pRootSignature->NumParameters; ++parameterIndex)
+    {
+        const D3D12_ROOT_PARAMETER* pParameter = pRootSignature->pParameters + parameterIndex;
+        appendNullRootSignatureData(&blob, &pParameter->ParameterType, sizeof(pParameter->ParameterType));
+        appendNullRootSignatureData(&blob, &pParameter->ShaderVisibility, sizeof(pParameter->ShaderVisibility));
+        switch(pParameter->ParameterType)
+        {
+            case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE:
+                appendNullRootSignatureData(&blob, &pParameter->DescriptorTable.NumDescriptorRanges, sizeof(UINT));
+                appendNullRootSignatureData(&blob, pParameter->DescriptorTable.pDescriptorRanges, sizeof(D3D12_DESCRIPTOR_RANGE) * pParameter->DescriptorTable.NumDescriptorRanges);
+                break;
+            case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+                appendNullRootSignatureData(&blob, &pParameter->Constants, sizeof(pParameter->Constants));
+                break;
+            default:
+                appendNullRootSignatureData(&blob, &pParameter->Descriptor, sizeof(pParameter->Descriptor));
+                break;
+        }
+    }
+
+    appendNullRootSignatureData(&blob, &pRootSignature->NumStaticSamplers, sizeof(pRootSignature->NumStaticSamplers));
+    appendNullRootSignatureData(&blob, pRootSignature->pStaticSamplers, sizeof(D3D12_STATIC_SAMPLER_DESC) * pRootSignature->NumStaticSamplers);
+
+    *ppBlob = new ID3DBlob(blob.data(), blob.size());
+    if(ppErrorBlob != nullptr)
+    {
+        *ppErrorBlob = nullptr;
+    }
+
+    return S_OK;
+}
+
+const null_device_statistics_t* getNullDeviceStatistics(const ID3D12Device10* pDevice)
+{
+    return &pDevice->statistics;
+}
+
+void setNullDeviceCostModel(ID3D12Device10* pDevice, const null_device_cost_model_t* pCostModel)
+{
+    pDevice->costModel = *pCostModel;
+}
+
+//FK: dxgi
+enum
+{
+    DXGI_CREATE_FACTORY_DEBUG           = 0x1,
+    DXGI_USAGE_RENDER_TARGET_OUTPUT     = 0x20,
+    DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL    = 3,
+    DXGI_SCALING_NONE                   = 1,
+    DXGI_ALPHA_MODE_UNSPECIFIED         = 0,
+    DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING  = 2048,
+    DXGI_PRESENT_ALLOW_TEARING          = 0x200
+};
+
+struct DXGI_SWAP_CHAIN_DESC1
+{
+    UINT                Width;
+    UINT                Height;
+    DXGI_FORMAT         Format;
+    BOOL                Stereo;
+    DXGI_SAMPLE_DESC    SampleDesc;
+    UINT                BufferUsage;
+    UINT                BufferCount;
+    int32_t             Scaling;
+    int32_t             SwapEffect;
+    int32_t             AlphaMode;
+    UINT                Flags;
+};
+
+constexpr uint32_t maxNullSwapChainBufferCount = 16u;
+
+struct IDXGIObject : IUnknown
+{
+};
+
+struct IDXGISwapChain4;
+
+struct IDXGISwapChain1 : IDXGIObject
+{
+    ~IDXGISwapChain1()
+    {
+        releaseBuffers();
+    }
+
+    HRESULT QueryInterface(REFIID riid, void** ppObject) override;
+
+    HRESULT GetBuffer(UINT bufferIndex, REFIID riid, void** ppBuffer)
+    {
+        (void)riid;
+        if(bufferIndex >= desc.BufferCount)
+        {
+            return DXGI_ERROR_INVALID_CALL;
+        }
+
+        ppBuffers[bufferIndex]->AddRef();
+        *ppBuffer = ppBuffers[bufferIndex];
+        return S_OK;
+    }
+
+    HRESULT Present(UINT syncInterval, UINT flags)
+    {
+        (void)syncInterval;
+        (void)flags;
+        ++pDevice->statistics.presentCount;
+        currentBufferIndex = (currentBufferIndex + 1u) % desc.BufferCount;
+        return S_OK;
+    }
+
+    HRESULT ResizeBuffers(UINT bufferCount, UINT width, UINT height, DXGI_FORMAT format, UINT flags)
+    {
+        if(bufferCount > 0u)
+        {
+            desc.BufferCount = bufferCount;
+        }
+
+        desc.Width  = width;
+        desc.Height = height;
+        desc.Flags  = flags;
+        if(format != DXGI_FORMAT_UNKNOWN)
+        {
+            desc.Format = format;
+        }
+
+        releaseBuffers();
+        return createBuffers() ? S_OK : E_OUTOFMEMORY;
+    }
+
+    bool createBuffers()
+    {
+        if(desc.BufferCount > maxNullSwapChainBufferCount)
+        {
+            return false;
+        }
+
+        D3D12_RESOURCE_DESC bufferDesc = {};
+        bufferDesc.Dimension        = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        bufferDesc.Width            = desc.Width;
+        bufferDesc.Height           = desc.Height;
+        bufferDesc.DepthOrArraySize = 1u;
+        bufferDesc.MipLevels        = 1u;
+        bufferDesc.Format           = desc.Format;
+        bufferDesc.SampleDesc       = {1u, 0u};
+        bufferDesc.Flags            = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+
+        for(UINT bufferIndex = 0u; bufferIndex < desc.BufferCount; ++bufferIndex)
+        {
+            ppBuffers[bufferIndex] = pDevice->createResource(&bufferDesc, D3D12_HEAP_TYPE_DEFAULT);
+            if(ppBuffers[bufferIndex] == nullptr)
+            {
+                return false;
+            }
+        }
+
+        currentBufferIndex = 0u;
+        return true;
+    }
+
+    void releaseBuffers()
+    {
+        for(UINT bufferIndex = 0u; bufferIndex < maxNullSwapChainBufferCount; ++bufferIndex)
+        {
+            if(ppBuffers[bufferIndex] != nullptr)
+            {
+                ppBuffers[bufferIndex]->Release();
+                ppBuffers[bufferIndex] = nullptr;
+            }
+        }
+    }
+
+    ID3D12Device10*         pDevice = nullptr;
+    DXGI_SWAP_CHAIN_DESC1   desc = {};
+    ID3D12Resource*         ppBuffers[maxNullSwapChainBufferCount] = {};
+    UINT                    currentBufferIndex = 0u;
+};
+
+struct IDXGISwapChain4 : IDXGISwapChain1
+{
+    UINT GetCurrentBackBufferIndex()
+    {
+        return currentBufferIndex;
+    }
+};
+
+HRESULT IDXGISwapChain1::QueryInterface(REFIID riid, void** ppObject)
+{
+    //FK: Swap chains always get created as IDXGISwapChain4
+    if(&riid == &getNullDeviceInterfaceId<IDXGISwapChain1>() || &riid == &getNullDeviceInterfaceId<IDXGISwapChain4>())
+    {
+        AddRef();
+        *ppObject = static_cast<IDXGISwapChain4*>(this);
+        return S_OK;
+    }
+
+    return IDXGIObject::QueryInterface(riid, ppObject);
+}
+
+struct IDXGIFactory7 : IDXGIObject
+{
+    //FK: pDevice is the direct command queue
+    HRESULT CreateSwapChainForHwnd(IUnknown* pDevice, HWND pWindowHandle, const DXGI_SWAP_CHAIN_DESC1* pDesc, const void* pFullscreenDesc, void* pRestrictToOutput, IDXGISwapChain1** ppSwapChain)
+    {
+        (void)pWindowHandle;
+        (void)pFullscreenDesc;
+        (void)pRestrictToOutput;
+
+        IDXGISwapChain4* pSwapChain = new IDXGISwapChain4;
+        pSwapChain->pDevice = ((ID3D12CommandQueue*)pDevice)->pDevice;
+        pSwapChain->desc = *pDesc;
+        if(!pSwapChain->createBuffers())
+        {
+            pSwapChain->Release();
+            return E_OUTOFMEMORY;
+        }
+
+        *ppSwapChain = pSwapChain;
+        return S_OK;
+    }
+};
+
+typedef IDXGIFactory7 IDXGIFactory6;
+
+HRESULT CreateDXGIFactory2(UINT flags, REFIID riid, void** ppFactory)
+{
+    (void)flags;
+    (void)riid;
+    return returnNullDeviceObject(new IDXGIFactory7, ppFactory);
+}
+
+//FK: dxc
+//    Compiling just hands back the source code as shader blob after keeping the calling thread busy for the configured time.
+//    Reflection data gets derived from the source, see createNullShaderReflectionBlob().
+static const CLSID CLSID_DxcCompiler    = {0x73e22d93, 0xe6ce, 0x47f3, {0xb5, 0xbf, 0xf0, 0x66, 0x4f, 0x39, 0xc1, 0xb0}};
+static const CLSID CLSID_DxcUtils       = {0x6245d6af, 0x66e0, 0x48fd, {0x80, 0xb4, 0x4d, 0x27, 0x17, 0x96, 0x74, 0x8c}};
+
+typedef int32_t DXC_OUT_KIND;
+enum
+{
+    DXC_OUT_NONE        = 0,
+    DXC_OUT_OBJECT      = 1,
+    DXC_OUT_ERRORS      = 2,
+    DXC_OUT_REFLECTION  = 8
+};
+
+#define DXC_CP_ACP 0
+
+struct DxcBuffer
+{
+    const void* Ptr;
+    SIZE_T      Size;
+    UINT        Encoding;
+};
+
+struct IDxcBlob : IUnknown
+{
+    IDxcBlob(const void* pData, const SIZE_T sizeInBytes)
+    {
+        pBuffer = malloc(sizeInBytes > 0u ? sizeInBytes : 1u);
+        bufferSizeInBytes = sizeInBytes;
+        memcpy(pBuffer, pData, sizeInBytes);
+    }
+
+    ~IDxcBlob()
+    {
+        free(pBuffer);
+    }
+
+    void*   GetBufferPointer()  { return pBuffer; }
+    SIZE_T  GetBufferSize()     { return bufferSizeInBytes; }
+
+    void*   pBuffer;
+    SIZE_T  bufferSizeInBytes;
+};
+
+struct IDxcBlobEncoding : IDxcBlob
+{
+};
+
+struct IDxcBlobUtf16 : IDxcBlobEncoding
+{
+};
+
+struct IDxcIncludeHandler : IUnknown
+{
+};
+
+struct IDxcResult : IUnknown
+{
+    ~IDxcResult()
+    {
+        if(pObject != nullptr)
+        {
+            pObject->Release();
+        }
+
+        if(pReflection != nullptr)
+        {
+            pReflection->Release();
+        }
+    }
+
+    BOOL HasOutput(DXC_OUT_KIND kind)
+    {
+        return kind == DXC_OUT_OBJECT || (kind == DXC_OUT_REFLECTION && pReflection != nullptr);
+    }
+
+    HRESULT GetErrorBuffer(IDxcBlobEncoding** ppErrors)
+    {
+        *ppErrors = nullptr;
+        return S_OK;
+    }
+
+    HRESULT GetOutput(DXC_OUT_KIND kind, REFIID riid, void** ppObject, IDxcBlobUtf16** ppOutputName)
+    {
+        (void)riid;
+        if(ppOutputName != nullptr)
+        {
+            *ppOutputName = nullptr;
+        }
+
+        IDxcBlob* pOutput = kind == DXC_OUT_OBJECT ? pObject : (kind == DXC_OUT_REFLECTION ? pReflection : nullptr);
+        if(pOutput == nullptr)
+        {
+            *ppObject = nullptr;
+            return E_INVALIDARG;
+        }
+
+        pOutput->AddRef();
+        *ppObject = pOutput;
+        return S_OK;
+    }
+
+    IDxcBlob* pObject = nullptr;
+    IDxcBlob* pReflection = nullptr;
+};
+
+//FK: Made up version, bump this whenever the null compiler output changes so shader caches get invalidated
+struct IDxcVersionInfo : IUnknown
+{
+    HRESULT GetVersion(UINT* pMajor, UINT* pMinor)
+    {
+        *pMajor = 1u;
+        *pMinor = 2u;
+        return S_OK;
+    }
+
+    HRESULT GetFlags(UINT32* pFlags)
+    {
+        *pFlags = 0u;
+        return S_OK;
+    }
+};
+
+//FK: Tests change the commit to simulate a compiler update that didn't bump the version
+uint32_t    nullShaderCompilerCommitCount   = 1u;
+const char* pNullShaderCompilerCommitHash   = "0000000";
+
+void setNullShaderCompilerCommit(const uint32_t commitCount, const char* pCommitHash)
+{
+    nullShaderCompilerCommitCount   = commitCount;
+    pNullShaderCompilerCommitHash   = pCommitHash;
+}
+
+struct IDxcVersionInfo2 : IDxcVersionInfo
+{
+    //FK: Same contract as dxc, the hash has to be freed with CoTaskMemFree()
+    HRESULT GetCommitInfo(UINT32* pCommitCount, char** pCommitHash)
+    {
+        const size_t commitHashSizeInBytes = strlen(pNullShaderCompilerCommitHash) + 1u;
+        *pCommitHash = (char*)CoTaskMemAlloc(commitHashSizeInBytes);
+        if(*pCommitHash == nullptr)
+        {
+            return E_OUTOFMEMORY;
+        }
+
+        memcpy(*pCommitHash, pNullShaderCompilerCommitHash, commitHashSizeInBytes);
+        *pCommitCount = nullShaderCompilerCommitCount;
+        return S_OK;
+    }
+};
+
+//FK: d3d12shader
+typedef int32_t D3D_SHADER_INPUT_TYPE;
+enum
+{
+    D3D_SIT_CBUFFER                         = 0,
+    D3D_SIT_TBUFFER                         = 1,
+    D3D_SIT_TEXTURE                         = 2,
+    D3D_SIT_SAMPLER                         = 3,
+    D3D_SIT_UAV_RWTYPED                     = 4,
+    D3D_SIT_STRUCTURED                      = 5,
+    D3D_SIT_UAV_RWSTRUCTURED                = 6,
+    D3D_SIT_BYTEADDRESS                     = 7,
+    D3D_SIT_UAV_RWBYTEADDRESS               = 8,
+    D3D_SIT_UAV_APPEND_STRUCTURED           = 9,
+    D3D_SIT_UAV_CONSUME_STRUCTURED          = 10,
+    D3D_SIT_UAV_RWSTRUCTURED_WITH_COUNTER   = 11,
+    D3D_SIT_RTACCELERATIONSTRUCTURE         = 12,
+    D3D_SIT_UAV_FEEDBACKTEXTURE             = 13
+};
+
+typedef int32_t D3D_NAME;
+enum
+{
+    D3D_NAME_UNDEFINED      = 0,
+    D3D_NAME_POSITION       = 1,
+    D3D_NAME_VERTEX_ID      = 6,
+    D3D_NAME_PRIMITIVE_ID   = 7,
+    D3D_NAME_INSTANCE_ID    = 8,
+    D3D_NAME_IS_FRONT_FACE  = 9,
+    D3D_NAME_TARGET         = 64
+};
+
+enum
+{
+    D3D12_SHVER_PIXEL_SHADER    = 0,
+    D3D12_SHVER_VERTEX_SHADER   = 1,
+    D3D12_SHVER_GEOMETRY_SHADER = 2,
+    D3D12_SHVER_HULL_SHADER     = 3,
+    D3D12_SHVER_DOMAIN_SHADER   = 4,
+    D3D12_SHVER_COMPUTE_SHADER  = 5
+};
+
+#define D3D12_SHVER_GET_TYPE(_Version) (((_Version) >> 16) & 0xffff)
+
+struct D3D12_SHADER_DESC
+{
+    UINT    Version;
+    LPCSTR  Creator;
+    UINT    Flags;
+    UINT    ConstantBuffers;
+    UINT    BoundResources;
+    UINT    InputParameters;
+    UINT    OutputParameters;
+};
+
+struct D3D12_SIGNATURE_PARAMETER_DESC
+{
+    LPCSTR      SemanticName;
+    UINT        SemanticIndex;
+    UINT        Register;
+    D3D_NAME    SystemValueType;
+    int32_t     ComponentType;
+    BYTE        Mask;
+    BYTE        ReadWriteMask;
+    UINT        Stream;
+    int32_t     MinPrecision;
+};
+
+struct D3D12_SHADER_INPUT_BIND_DESC
+{
+    LPCSTR                  Name;
+    D3D_SHADER_INPUT_TYPE   Type;
+    UINT                    BindPoint;
+    UINT                    BindCount;
+    UINT                    uFlags;
+    int32_t                 ReturnType;
+    int32_t                 Dimension;
+    UINT                    NumSamples;
+    UINT                    Space;
+    UINT                    uID;
+};
+
+struct D3D12_SHADER_BUFFER_DESC
+{
+    LPCSTR  Name;
+    int32_t Type;
+    UINT    Variables;
+    UINT    Size;
+    UINT    uFlags;
+};
+
+constexpr uint32_t nullShaderReflectionNameLength = 64u;
+
+struct null_shader_input_parameter_t
+{
+    char        semanticName[nullShaderReflectionNameLength];
+    UINT        semanticIndex;
+    D3D_NAME    systemValueType;
+    BYTE        mask;
+};
+
+struct null_shader_resource_binding_t
+{
+    char                    name[nullShaderReflectionNameLength];
+    D3D_SHADER_INPUT_TYPE   type;
+    UINT                    bindPoint;
+    UINT                    bindCount;      // 0 = unbounded
+    UINT                    space;
+    UINT                    constantBufferSizeInBytes;
+};
+
+//FK: Reflection blob layout - header, input parameters, resource bindings
+struct null_shader_reflection_header_t
+{
+    UINT version;
+    UINT inputParameterCount;
+    UINT resourceBindingCount;
+};
+
+//FK: Not reference counted, owned by the reflection object (same as the real one)
+struct ID3D12ShaderReflectionConstantBuffer
+{
+    HRESULT GetDesc(D3D12_SHADER_BUFFER_DESC* pDesc)
+    {
+        if(desc.Name == nullptr)
+        {
+            return E_FAIL;
+        }
+
+        *pDesc = desc;
+        return S_OK;
+    }
+
+    D3D12_SHADER_BUFFER_DESC desc = {};
+};
+
+struct ID3D12ShaderReflection : IUnknown
+{
+    HRESULT GetDesc(D3D12_SHADER_DESC* pDesc)
+    {
+        *pDesc = {};
+        pDesc->Version          = header.version;
+        pDesc->Creator          = "null device";
+        pDesc->ConstantBuffers  = (UINT)constantBuffers.size();
+        pDesc->BoundResources   = header.resourceBindingCount;
+        pDesc->InputParameters  = header.inputParameterCount;
+        return S_OK;
+    }
+
+    HRESULT GetInputParameterDesc(UINT parameterIndex, D3D12_SIGNATURE_PARAMETER_DESC* pDesc)
+    {
+        if(parameterIndex >= inputParameters.size())
+        {
+            return E_INVALIDARG;
+        }
+
+        const null_shader_input_parameter_t* pParameter = &inputParameters[parameterIndex];
+        *pDesc = {};
+        pDesc->SemanticName     = pParameter->semanticName;
+        pDesc->SemanticIndex    = pParameter->semanticIndex;
+        pDesc->Register         = parameterIndex;
+        pDesc->SystemValueType  = pParameter->systemValueType;
+        pDesc->Mask             = pParameter->mask;
+        return S_OK;
+    }
+
+    HRESULT GetResourceBindingDesc(UINT resourceIndex, D3D12_SHADER_INPUT_BIND_DESC* pDesc)
+    {
+        if(resourceIndex >= resourceBindings.size())
+        {
+            return E_INVALIDARG;
+        }
+
+        const null_shader_resource_binding_t* pBinding = &resourceBindings[resourceIndex];
+        *pDesc = {};
+        pDesc->Name         = pBinding->name;
+        pDesc->Type         = pBinding->type;
+        pDesc->BindPoint    = pBinding->bindPoint;
+        pDesc->BindCount    = pBinding->bindCount;
+        pDesc->Space        = pBinding->space;
+        pDesc->uID          = resourceIndex;
+        return S_OK;
+    }
+
+    //FK: Unknown names return an invalid constant buffer whose GetDesc() fails
+    ID3D12ShaderReflectionConstantBuffer* GetConstantBufferByName(LPCSTR pName)
+    {
+        for(ID3D12ShaderReflectionConstantBuffer& constantBuffer : constantBuffers)
+        {
+            if(strcmp(constantBuffer.desc.Name, pName) == 0)
+            {
+                return &constantBuffer;
+            }
+        }
+
+        return &invalidConstantBuffer;
+    }
+
+    null_shader_reflection_header_t                     header = {};
+    std::vector<null_shader_input_parameter_t>          inputParameters;
+    std::vector<null_shader_resource_binding_t>         resourceBindings;
+    std::vector<ID3D12ShaderReflectionConstantBuffer>   constantBuffers;
+    ID3D12ShaderReflectionConstantBuffer                invalidConstantBuffer;
+};
+
+//FK: Reflection of the null compiler
+//    There's no real front end, so the source gets picked apart by a tiny parser that only understands what's needed to
+//    generate root signatures and input layouts:
+//    - Entry point parameters with semantics, either directly or as members of a struct parameter.
+//    - Resources, cbuffers and ConstantBuffer<T> with explicit register() bindings, including [N] and [] arrays.
+//    Comments, macros, nested structs and implicitly bound resources aren't supported.
+bool isNullShaderIdentifierCharacter(const char character)
+{
+    return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z') || (character >= '0' && character <= '9') || character == '_';
+}
+
+std::string trimNullShaderString(const std::string& text)
+{
+    const size_t start = text.find_first_not_of(" \t\r\n");
+    if(start == std::string::npos)
+    {
+        return std::string();
+    }
+
+    const size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(start, end - start + 1u);
+}
+
+std::vector<std::string> splitNullShaderString(const std::string& text, const char separator)
+{
+    std::vector<std::string> parts;
+    size_t start = 0u;
+    while(start <= text.size())
+    {
+        size_t end = text.find(separator, start);
+        if(end == std::string::npos)
+        {
+            end = text.size();
+        }
+
+        const std::string part = trimNullShaderString(text.substr(start, end - start));
+        if(!part.empty())
+        {
+            parts.push_back(part);
+        }
+        start = end + 1u;
+    }
+
+    return parts;
+}
+
+//FK: Finds a whole word, returns std::string::npos if there's none
+size_t findNullShaderWord(const std::string& source, const std::string& word, size_t start = 0u)
+{
+    while((start = source.find(word, start)) != std::string::npos)
+    {
+        const bool isWordStart = start == 0u || !isNullShaderIdentifierCharacter(source[start - 1u]);
+        const bool isWordEnd = start + word.size() >= source.size() || !isNullShaderIdentifierCharacter(source[start + word.size()]);
+        if(isWordStart && isWordEnd)
+        {
+            return start;
+        }
+        start += word.size();
+    }
+
+    return std::string::npos;
+}
+
+//FK: Returns the text between the bracket at openIndex and its matching closing bracket
+std::string findNullShaderBracketContent(const std::string& source, const size_t openIndex, const char openBracket, const char closeBracket)
+{
+    uint32_t depth = 0u;
+    for(size_t index = openIndex; index < source.size(); ++index)
+    {
+        if(source[index] == openBracket)
+        {
+            ++depth;
+        }
+        else if(source[index] == closeBracket && --depth == 0u)
+        {
+            return source.substr(openIndex + 1u, index - openIndex - 1u);
+        }
+    }
+
+    return std::string();
+}
+
+std::string findNullShaderStructBody(const std::string& source, const std::string& structName)
+{
+    size_t structIndex = 0u;
+    while((structIndex = findNullShaderWord(source, "struct", structIndex)) != std::string::npos)
+    {
+        structIndex += 6u;
+        const size_t bodyIndex = source.find('{', structIndex);
+        if(bodyIndex != std::string::npos && trimNullShaderString(source.substr(structIndex, bodyIndex - structIndex)) == structName)
+        {
+            return findNullShaderBracketContent(source, bodyIndex, '{', '}');
+        }
+    }
+
+    return std::string();
+}
+
+struct null_shader_declaration_t
+{
+    std::string typeName;
+    std::string name;
+    std::string semantic;
+    UINT        arrayCount;     // 1 for non arrays, 0 for unbounded arrays
+};
+
+//FK: "[modifiers] type name[N] : SEMANTIC"
+null_shader_declaration_t parseNullShaderDeclaration(const std::string& declarationText)
+{
+    null_shader_declaration_t declaration = {};
+    declaration.arrayCount = 1u;
+
+    std::string text = declarationText;
+    const size_t semanticIndex = text.find(':');
+    if(semanticIndex != std::string::npos)
+    {
+        declaration.semantic = trimNullShaderString(text.substr(semanticIndex + 1u));
+        text = text.substr(0u, semanticIndex);
+    }
+
+    const size_t arrayIndex = text.find('[');
+    if(arrayIndex != std::string::npos)
+    {
+        const std::string arrayCount = trimNullShaderString(findNullShaderBracketContent(text, arrayIndex, '[', ']'));
+        declaration.arrayCount = arrayCount.empty() ? 0u : (UINT)strtoul(arrayCount.c_str(), nullptr, 10);
+        text = text.substr(0u, arrayIndex);
+    }
+
+    const std::vector<std::string> tokens = splitNullShaderString(trimNullShaderString(text), ' ');
+    if(tokens.size() >= 2u)
+    {
+        declaration.typeName    = tokens[tokens.size() - 2u];
+        declaration.name        = tokens[tokens.size() - 1u];
+    }
+
+    return declaration;
+}
+
+//FK: float = 1x1, float3 = 1x3, float4x4 = 4x4 - matrices are column major, every column takes one register
+void getNullShaderTypeDimensions(const std::string& typeName, UINT* pOutRegisterCount, UINT* pOutComponentCount)
+{
+    *pOutRegisterCount  = 1u;
+    *pOutComponentCount = 1u;
+
+    const size_t length = typeName.size();
+    const auto isDimension = [](const char character) { return character >= '1' && character <= '4'; };
+    if(length >= 3u && typeName[length - 2u] == 'x' && isDimension(typeName[length - 3u]) && isDimension(typeName[length - 1u]))
+    {
+        *pOutComponentCount = (UINT)(typeName[length - 3u] - '0');
+        *pOutRegisterCount  = (UINT)(typeName[length - 1u] - '0');
+    }
+    else if(length >= 1u && isDimension(typeName[length - 1u]))
+    {
+        *pOutComponentCount = (UINT)(typeName[length - 1u] - '0');
+    }
+}
+
+//FK: HLSL constant buffer packing - vectors don't straddle 16 byte boundaries, arrays and matrices start at one
+UINT calculateNullShaderConstantBufferSizeInBytes(const std::string& body)
+{
+    UINT offsetInBytes = 0u;
+    for(const std::string& member : splitNullShaderString(body, ';'))
+    {
+        const null_shader_declaration_t declaration = parseNullShaderDeclaration(member);
+        if(declaration.name.empty())
+        {
+            continue;
+        }
+
+        UINT registerCount = 1u;
+        UINT componentCount = 1u;
+        getNullShaderTypeDimensions(declaration.typeName, &registerCount, &componentCount);
+
+        const UINT registerCountInArray = registerCount * (declaration.arrayCount > 0u ? declaration.arrayCount : 1u);
+        if(registerCountInArray > 1u || (offsetInBytes % 16u) + componentCount * 4u > 16u)
+        {
+            offsetInBytes = (offsetInBytes + 15u) & ~15u;
+        }
+
+        offsetInBytes += (registerCountInArray - 1u) * 16u + componentCount * 4u;
+    }
+
+    return (offsetInBytes + 15u) & ~15u;
+}
+
+D3D_NAME getNullShaderSystemValueType(const std::string& semanticName)
+{
+    const struct { const char* pName; D3D_NAME systemValueType; } systemValues[] = {
+        {"SV_POSITION", D3D_NAME_POSITION}, {"SV_VERTEXID", D3D_NAME_VERTEX_ID}, {"SV_PRIMITIVEID", D3D_NAME_PRIMITIVE_ID},
+        {"SV_INSTANCEID", D3D_NAME_INSTANCE_ID}, {"SV_ISFRONTFACE", D3D_NAME_IS_FRONT_FACE}, {"SV_TARGET", D3D_NAME_TARGET}
+    };
+
+    std::string upperCaseName = semanticName;
+    for(char& character : upperCaseName)
+    {
+        character = (char)toupper((unsigned char)character);
+    }
+
+    for(const auto& systemValue : systemValues)
+    {
+        if(upperCaseName == systemValue.pName)
+        {
+            return systemValue.systemValueType;
+        }
+    }
+
+    return D3D_NAME_UNDEFINED;
+}
+
+void addNullShaderInputParameter(std::vector<null_shader_input_parameter_t>* pInputParameters, const null_shader_declaration_t& declaration)
+{
+    size_t semanticIndexStart = declaration.semantic.size();
+    while(semanticIndexStart > 0u && declaration.semantic[semanticIndexStart - 1u] >= '0' && declaration.semantic[semanticIndexStart - 1u] <= '9')
+    {
+        --semanticIndexStart;
+    }
+
+    UINT registerCount = 1u;
+    UINT componentCount = 1u;
+    getNullShaderTypeDimensions(declaration.typeName, &registerCount, &componentCount);
+
+    null_shader_input_parameter_t inputParameter = {};
+    const std::string semanticName = declaration.semantic.substr(0u, semanticIndexStart);
+    snprintf(inputParameter.semanticName, sizeof(inputParameter.semanticName), "%s", semanticName.c_str());
+    inputParameter.semanticIndex    = (UINT)strtoul(declaration.semantic.c_str() + semanticIndexStart, nullptr, 10);
+    inputParameter.systemValueType  = getNullShaderSystemValueType(semanticName);
+    inputParameter.mask             = (BYTE)((1u << componentCount) - 1u);
+    pInputParameters->push_back(inputParameter);
+}
+
+void parseNullShaderInputParameters(const std::string& source, const std::string& entryPoint, std::vector<null_shader_input_parameter_t>* pOutInputParameters)
+{
+    size_t entryPointIndex = 0u;
+    while((entryPointIndex = findNullShaderWord(source, entryPoint, entryPointIndex)) != std::string::npos)
+    {
+        const size_t parameterListIndex = source.find_first_not_of(" \t\r\n", entryPointIndex + entryPoint.size());
+        entryPointIndex += entryPoint.size();
+        if(parameterListIndex == std::string::npos || source[parameterListIndex] != '(')
+        {
+            continue;
+        }
+
+        for(const std::string& parameter : splitNullShaderString(findNullShaderBracketContent(source, parameterListIndex, '(', ')'), ','))
+        {
+            const null_shader_declaration_t declaration = parseNullShaderDeclaration(parameter);
+            if(!declaration.semantic.empty())
+            {
+                addNullShaderInputParameter(pOutInputParameters, declaration);
+                continue;
+            }
+
+            for(const std::string& member : splitNullShaderString(findNullShaderStructBody(source, declaration.typeName), ';'))
+            {
+                const null_shader_declaration_t memberDeclaration = parseNullShaderDeclaration(member);
+                if(!memberDeclaration.semantic.empty())
+                {
+                    addNullShaderInputParameter(pOutInputParameters, memberDeclaration);
+                }
+            }
+        }
+        return;
+    }
+}
+
+D3D_SHADER_INPUT_TYPE getNullShaderInputType(const char registerType, const std::string& typeName)
+{
+    switch(registerType)
+    {
+        case 'b':
+            return D3D_SIT_CBUFFER;
+        case 's':
+            return D3D_SIT_SAMPLER;
+        case 't':
+            if(typeName == "tbuffer")
+            {
+                return D3D_SIT_TBUFFER;
+            }
+            if(typeName.compare(0u, 16u, "StructuredBuffer") == 0)
+            {
+                return D3D_SIT_STRUCTURED;
+            }
+            return typeName == "ByteAddressBuffer" ? D3D_SIT_BYTEADDRESS : D3D_SIT_TEXTURE;
+        default:
+            if(typeName.compare(0u, 18u, "RWStructuredBuffer") == 0)
+            {
+                return D3D_SIT_UAV_RWSTRUCTURED;
+            }
+            return typeName == "RWByteAddressBuffer" ? D3D_SIT_UAV_RWBYTEADDRESS : D3D_SIT_UAV_RWTYPED;
+    }
+}
+
+void parseNullShaderResourceBindings(const std::string& source, std::vector<null_shader_resource_binding_t>* pOutResourceBindings)
+{
+    size_t registerIndex = 0u;
+    while((registerIndex = findNullShaderWord(source, "register", registerIndex)) != std::string::npos)
+    {
+        const size_t argumentIndex = source.find('(', registerIndex);
+        const size_t colonIndex = source.find_last_of(':', registerIndex);
+        registerIndex += 8u;
+        if(argumentIndex == std::string::npos || colonIndex == std::string::npos)
+        {
+            continue;
+        }
+
+        //FK: "b0" or "t3, space1"
+        const std::vector<std::string> registerArguments = splitNullShaderString(findNullShaderBracketContent(source, argumentIndex, '(', ')'), ',');
+        if(registerArguments.empty() || strchr("btus", registerArguments[0][0]) == nullptr)
+        {
+            continue;
+        }
+
+        const size_t declarationIndex = source.find_last_of(";{}", colonIndex);
+        const size_t declarationStart = declarationIndex == std::string::npos ? 0u : declarationIndex + 1u;
+        null_shader_declaration_t declaration = parseNullShaderDeclaration(source.substr(declarationStart, colonIndex - declarationStart));
+
+        null_shader_resource_binding_t binding = {};
+        binding.type        = getNullShaderInputType(registerArguments[0][0], declaration.typeName);
+        binding.bindPoint   = (UINT)strtoul(registerArguments[0].c_str() + 1u, nullptr, 10);
+        binding.bindCount   = declaration.arrayCount;
+        binding.space       = registerArguments.size() > 1u ? (UINT)strtoul(registerArguments[1].c_str() + 5u, nullptr, 10) : 0u;
+        snprintf(binding.name, sizeof(binding.name), "%s", declaration.name.c_str());
+
+        if(declaration.typeName == "cbuffer" || declaration.typeName == "tbuffer")
+        {
+            const size_t bodyIndex = source.find('{', argumentIndex);
+            binding.constantBufferSizeInBytes = bodyIndex != std::string::npos ? calculateNullShaderConstantBufferSizeInBytes(findNullShaderBracketContent(source, bodyIndex, '{', '}')) : 0u;
+        }
+        else if(declaration.typeName.compare(0u, 15u, "ConstantBuffer<") == 0)
+        {
+            const std::string structName = declaration.typeName.substr(15u, declaration.typeName.find('>') - 15u);
+            binding.constantBufferSizeInBytes = calculateNullShaderConstantBufferSizeInBytes(findNullShaderStructBody(source, structName));
+        }
+
+        pOutResourceBindings->push_back(binding);
+    }
+}
+
+//FK: "vs_6_0" -> D3D12_SHVER version
+UINT getNullShaderVersion(const std::string& profile)
+{
+    const char* shaderTypes[] = {"ps", "vs", "gs", "hs", "ds", "cs"};
+    UINT shaderType = D3D12_SHVER_PIXEL_SHADER;
+    for(UINT shaderTypeIndex = 0u; shaderTypeIndex < sizeof(shaderTypes) / sizeof(shaderTypes[0]); ++shaderTypeIndex)
+    {
+        if(profile.compare(0u, 2u, shaderTypes[shaderTypeIndex]) == 0)
+        {
+            shaderType = shaderTypeIndex;
+        }
+    }
+
+    const UINT majorVersion = profile.size() > 3u ? (UINT)(profile[3] - '0') : 0u;
+    const UINT minorVersion = profile.size() > 5u ? (UINT)(profile[5] - '0') : 0u;
+    return (shaderType << 16u) | (majorVersion << 4u) | minorVersion;
+}
+
+IDxcBlob* createNullShaderReflectionBlob(const std::string& source, const std::string& entryPoint, const std::string& profile)
+{
+    std::vector<null_shader_input_parameter_t> inputParameters;
+    std::vector<null_shader_resource_binding_t> resourceBindings;
+    parseNullShaderInputParameters(source, entryPoint, &inputParameters);
+    parseNullShaderResourceBindings(source, &resourceBindings);
+
+    null_shader_reflection_header_t header = {};
+    header.version              = getNullShaderVersion(profile);
+    header.inputParameterCount  = (UINT)inputParameters.size();
+    header.resourceBindingCount = (UINT)resourceBindings.size();
+
+    std::vector<uint8_t> blob((const uint8_t*)&header, (const uint8_t*)(&header + 1));
+    blob.insert(blob.end(), (const uint8_t*)inputParameters.data(), (const uint8_t*)(inputParameters.data() + inputParameters.size()));
+    blob.insert(blob.end(), (const uint8_t*)resourceBindings.data(), (const uint8_t*)(resourceBindings.data() + resourceBindings.size()));
+    return new IDxcBlob(blob.data(), blob.size());
+}
+
+uint64_t nullShaderCompilerCostInNanoseconds = 0u;
+
+void setNullShaderCompilerCost(const uint64_t costPerShaderInNanoseconds)
+{
+    nullShaderCompilerCostInNanoseconds = costPerShaderInNanoseconds;
+}
+
+struct IDxcCompiler3 : IUnknown
+{
+    HRESULT QueryInterface(REFIID riid, void** ppObject) override
+    {
+        if(&riid == &getNullDeviceInterfaceId<IDxcVersionInfo>())
+        {
+            return returnNullDeviceObject(new IDxcVersionInfo, ppObject);
+        }
+
+        if(&riid == &getNullDeviceInterfaceId<IDxcVersionInfo2>())
+        {
+            return returnNullDeviceObject(new IDxcVersionInfo2, ppObject);
+        }
+
+        return IUnknown::QueryInterface(riid, ppObject);
+    }
+
+    HRESULT Compile(const DxcBuffer* pSource, LPCWSTR* ppArguments, UINT argumentCount, IDxcIncludeHandler* pIncludeHandler, REFIID riid, void** ppResult)
+    {
+        (void)pIncludeHandler;
+        (void)riid;
+
+        //FK: Busy wait, a real compiler keeps the core busy as well
+        const int64_t endTimeInNanoseconds = getNullDeviceTimeInNanoseconds() + (int64_t)nullShaderCompilerCostInNanoseconds;
+        while(getNullDeviceTimeInNanoseconds() < endTimeInNanoseconds)
+        {
+        }
+
+        //FK: The "binary" is the source plus every define that the source mentions. Defines that the shader
+        //    doesn't reference don't change the output - same as with the real compiler.
+        const char* pSourceCode = (const char*)pSource->Ptr;
+        std::vector<char> binary(pSourceCode, pSourceCode + pSource->Size);
+        const std::string sourceCode(pSourceCode, strnlen(pSourceCode, pSource->Size));
+        std::string entryPoint = "main";
+        std::string profile;
+        for(UINT argumentIndex = 0u; argumentIndex < argumentCount; ++argumentIndex)
+        {
+            char argument[256] = {};
+            wcstombs(argument, ppArguments[argumentIndex], sizeof(argument) - 1u);
+            if(strncmp(argument, "-E ", 3u) == 0)
+            {
+                entryPoint = argument + 3u;
+            }
+            else if(strncmp(argument, "-T ", 3u) == 0)
+            {
+                profile = argument + 3u;
+            }
+
+            if(strncmp(argument, "-D ", 3u) != 0)
+            {
+                continue;
+            }
+
+            const char* pDefine = argument + 3u;
+            const std::string defineName(pDefine, strcspn(pDefine, "="));
+            if(sourceCode.find(defineName) != std::string::npos)
+            {
+                binary.insert(binary.end(), argument, argument + strlen(argument) + 1u);
+            }
+        }
+
+        IDxcResult* pResult = new IDxcResult;
+        pResult->pObject = new IDxcBlob(binary.data(), binary.size());
+        pResult->pReflection = createNullShaderReflectionBlob(sourceCode, entryPoint, profile);
+        return returnNullDeviceObject(pResult, ppResult);
+    }
+};
+
+struct IDxcUtils : IUnknown
+{
+    HRESULT CreateDefaultIncludeHandler(IDxcIncludeHandler** ppIncludeHandler)
+    {
+        return returnNullDeviceObject(new IDxcIncludeHandler, (void**)ppIncludeHandler);
+    }
+
+    HRESULT CreateReflection(const DxcBuffer* pData, REFIID riid, void** ppReflection)
+    {
+        (void)riid;
+        const uint8_t* pBlob = (const uint8_t*)pData->Ptr;
+        null_shader_reflection_header_t header = {};
+        if(pData->Size < sizeof(header))
+        {
+            *ppReflection = nullptr;
+            return E_INVALIDARG;
+        }
+
+        memcpy(&header, pBlob, sizeof(header));
+        const SIZE_T inputParametersSizeInBytes = sizeof(null_shader_input_parameter_t) * header.inputParameterCount;
+        const SIZE_T resourceBindingsSizeInBytes = sizeof(null_shader_resource_binding_t) * header.resourceBindingCount;
+        if(pData->Size != sizeof(header) + inputParametersSizeInBytes + resourceBindingsSizeInBytes)
+        {
+            *ppReflection = nullptr;
+            return E_INVALIDARG;
+        }
+
+        ID3D12ShaderReflection* pReflection = new ID3D12ShaderReflection;
+        pReflection->header = header;
+        const null_shader_input_parameter_t* pInputParameters = (const null_shader_input_parameter_t*)(pBlob + sizeof(header));
+        const null_shader_resource_binding_t* pResourceBindings = (const null_shader_resource_binding_t*)(pBlob + sizeof(header) + inputParametersSizeInBytes);
+        pReflection->inputParameters.assign(pInputParameters, pInputParameters + header.inputParameterCount);
+        pReflection->resourceBindings.assign(pResourceBindings, pResourceBindings + header.resourceBindingCount);
+
+        //FK: Constant buffer names point into the resource bindings, which don't move anymore
+        for(const null_shader_resource_binding_t& binding : pReflection->resourceBindings)
+        {
+            if(binding.type == D3D_SIT_CBUFFER || binding.type == D3D_SIT_TBUFFER)
+            {
+                ID3D12ShaderReflectionConstantBuffer constantBuffer;
+                constantBuffer.desc.Name = binding.name;
+                constantBuffer.desc.Size = binding.constantBufferSizeInBytes;
+                pReflection->constantBuffers.push_back(constantBuffer);
+            }
+        }
+
+        return returnNullDeviceObject(pReflection, ppReflection);
+    }
+};
+
+HRESULT DxcCreateInstance(REFCLSID rclsid, REFIID riid, void** ppObject)
+{
+    (void)riid;
+    if(memcmp(&rclsid, &CLSID_DxcCompiler, sizeof(CLSID)) == 0)
+    {
+        return returnNullDeviceObject(new IDxcCompiler3, ppObject);
+    }
+    else if(memcmp(&rclsid, &CLSID_DxcUtils, sizeof(CLSID)) == 0)
+    {
+        return returnNullDeviceObject(new IDxcUtils, ppObject);
+    }
+
+    *ppObject = nullptr;
+    return E_NOINTERFACE;
+}
@@ -1,24 +1,28 @@
 #define _CRT_SECURE_NO_WARNINGS
 
+#define USE_D3D12_DEBUG 1
+#define CLEAR_NEW_MEMORY_WITH_ZEROES 1
+#define USE_DEBUG_ASSERTS 1
+
+//FK: Set to 1 to run without GPU and window (eg: headless benchmarks on linux), see k15_d3d12_null_device.hpp
+#ifndef USE_NULL_DEVICE
+#define USE_NULL_DEVICE 0
+#endif
+
+#if USE_NULL_DEVICE
+#include "k15_d3d12_null_device.hpp"
+#else
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #include <windows.h>
-#include <stdio.h>
 
-#define USE_D3D12_DEBUG 1
-#define CLEAR_NEW_MEMORY_WITH_ZEROES 1
-#define USE_DEBUG_ASSERTS 1
 #include <d3d12.h>
 #include <d3d12sdklayers.h>
+#include <d3d12shader.h>
 //#include <d3dcompiler.h>
 #include <dxgi1_6.h>
 #include <dxcapi.h>
 
-#include <stdio.h>
-#include <stdint.h>
-
-#include <limits>
-
 #include "include/WinPixEventRuntime/pix3.h"
 
 #pragma comment(lib, "kernel32.lib")
@@ -29,6 +33,35 @@
 #pragma comment(lib, "x64/dxcompiler.lib")
 //#pragma comment(lib, "x64/D3dcompiler_47.lib")
 #pragma comment(lib, "x64/WinPixEventRuntime.lib")
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#include <limits>
+
+//FK: SSE2 is part of the x64 baseline, the AVX2 (+F16C) kernels are selected at runtime, see getSupportedSimdLevel()
+#ifndef USE_X64_SIMD_KERNELS
+#if defined(_M_X64) || defined(__x86_64__)
+#define USE_X64_SIMD_KERNELS 1
+#else
+#define USE_X64_SIMD_KERNELS 0
+#endif
+#endif
+
+#if USE_X64_SIMD_KERNELS
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define AVX2_TARGET_FUNCTION
+#else
+#define AVX2_TARGET_FUNCTION __attribute__((target("avx2,f16c")))
+#endif
+#endif
 
 typedef LRESULT(CALLBACK* WNDPROC)(HWND, UINT, WPARAM, LPARAM);
 
@@ -81,6 +114,7 @@ struct render_context_t;
 
 typedef void*(*allocate_from_memory_allocator_fnc)(memory_allocator_t*, uint64_t, uint64_t);
 typedef void(*free_from_memory_allocator_fnc)(memory_allocator_t*, void*);
+typedef void(*reset_memory_allocator_fnc)(memory_allocator_t*);
 
 typedef ID3D12Device10  D3D12DeviceType;
 typedef ID3D12Debug6    D3D12DebugType;
@@ -152,7 +186,7 @@ struct flags8_t : flags_t<T, uint8_t>
 {
     flags8_t<T>& operator=(const uint8_t flagsValue)
     {
-        value = flagsValue;
+        this->value = flagsValue;
         return *this;
     }
 };
@@ -162,7 +196,7 @@ struct flags16_t : flags_t<T, uint16_t>
 {
     flags16_t<T>& operator=(const uint16_t flagsValue)
     {
-        value = flagsValue;
+        this->value = flagsValue;
         return *this;
     }
 };
@@ -172,7 +206,7 @@ struct flags32_t : flags_t<T, uint32_t>
 {
     flags32_t<T>& operator=(const uint32_t flagsValue)
     {
-        value = flagsValue;
+        this->value = flagsValue;
         return *this;
     }
 };
@@ -181,6 +215,27 @@ struct memory_allocator_t
 {
     allocate_from_memory_allocator_fnc  allocateFnc;
     free_from_memory_allocator_fnc      freeFnc;
+    reset_memory_allocator_fnc          resetFnc;
+};
+
+struct linear_memory_allocator_chunk_t
+{
+    linear_memory_allocator_chunk_t*    pNext;
+    uint8_t*                            pMemory;
+    uint64_t                            sizeInBytes;
+    uint64_t                            offsetInBytes;
+};
+
+struct linear_memory_allocator_t : memory_allocator_t
+{
+    memory_allocator_t*                 pBaseAllocator;
+    linear_memory_allocator_chunk_t*    pFirstChunk;
+    linear_memory_allocator_chunk_t*    pCurrentChunk;
+    uint64_t                            chunkSizeInBytes;
+    uint64_t                            usedSizeInBytes;
+    uint64_t                            frameHighWaterMarkInBytes;  // usage of the last frame before it got reset
+    uint64_t                            highWaterMarkInBytes;       // highest usage of any frame so far
+    uint32_t                            chunkCount;
 };
 
 struct d3d12_resource_t
@@ -189,6 +244,22 @@ struct d3d12_resource_t
     D3D12_RESOURCE_STATES currentState;
 };
 
+constexpr uint32_t maxPendingResourceBarrierCount = 16u;
+
+struct resource_barrier_statistics_t
+{
+    uint32_t issuedBarrierCount;
+    uint32_t elidedBarrierCount;    // transitions that got merged into or cancelled by another transition
+};
+
+struct resource_barrier_batch_t
+{
+    ID3D12GraphicsCommandList*      pCommandList;
+    D3D12_RESOURCE_BARRIER          pendingBarriers[maxPendingResourceBarrierCount];
+    uint32_t                        pendingBarrierCount;
+    resource_barrier_statistics_t   statistics;
+};
+
 struct buffer_slice_t
 {
     uint64_t startByteIndex;
@@ -197,7 +268,37 @@ struct buffer_slice_t
 
 struct staging_buffer_slice_t : buffer_slice_t
 {
+    uint64_t fenceValue;    // slice can be reused once the frame fence reached this value
+};
+
+constexpr uint32_t maxRingBufferInFlightSliceCount = 8u;
+
+struct ring_buffer_allocator_t
+{
+    staging_buffer_slice_t  inFlightSlices[maxRingBufferInFlightSliceCount];
+    uint64_t                sizeInBytes;
+    uint64_t                headInBytes;        // head and tail are monotonic, the physical offset is value % sizeInBytes
+    uint64_t                tailInBytes;
+    uint64_t                frameStartInBytes;
+    uint64_t                highWaterMarkInBytes;
+    uint32_t                firstInFlightSliceIndex;
+    uint32_t                inFlightSliceCount;
+};
+
+struct upload_ring_buffer_t
+{
+    ring_buffer_allocator_t allocator;
+    d3d12_resource_t        bufferResource;
+    uint8_t*                pMappedData;
+};
 
+struct upload_queue_t
+{
+    ID3D12CommandQueue*     pCopyCommandQueue;
+    ID3D12Fence*            pCopyFence;
+    HANDLE                  pCopyFinishedEvent;
+    uint64_t                lastSubmittedFenceValue;    // fence value of the last upload batch submitted to the copy queue
+    uint64_t                lastWaitedFenceValue;       // highest fence value the direct queue has already waited for
 };
 
 struct memory_buffer_t
@@ -260,16 +361,72 @@ const char* getResultString(const result_status_t result)
     return nullptr;
 }
 
+struct vertex_buffer_handle_t
+{
+    uint32_t index;
+    uint32_t generation;
+};
+
+struct render_target_handle_t
+{
+    uint32_t index;
+    uint32_t generation;
+};
+
+struct vertex_format_handle_t
+{
+    uint32_t index;
+    uint32_t generation;
+};
+
+struct graphics_pipeline_state_handle_t
+{
+    uint32_t index;
+    uint32_t generation;
+};
+
+struct shader_binary_handle_t
+{
+    uint32_t index;
+    uint32_t generation;
+};
+
 struct render_target_t
 {
     d3d12_resource_t            resource;
     D3D12_CPU_DESCRIPTOR_HANDLE cpuDescriptorHandle;
 };
 
+struct shader_cache_statistics_t
+{
+    uint32_t hitCount;
+    uint32_t missCount;
+    uint32_t corruptEntryCount;
+    uint32_t writeFailureCount;
+};
+
+//FK: DXC compiler instances aren't thread safe, every thread that compiles shaders needs its own worker
+struct shader_compiler_worker_t
+{
+    IDxcCompiler3*              pShaderCompiler;
+    IDxcUtils*                  pShaderUtils;
+    IDxcIncludeHandler*         pIncludeHandler;
+    memory_allocator_t*         pTempAllocator;
+    linear_memory_allocator_t   tempMemoryAllocator;    // backs pTempAllocator of batch compilation workers
+    shader_cache_statistics_t   cacheStatistics;
+};
+
 struct shader_compiler_context_t
 {
-    IDxcCompiler3*      pShaderCompiler;
-    IDxcIncludeHandler* pIncludeHandler;
+    IDxcCompiler3*              pShaderCompiler;
+    IDxcUtils*                  pShaderUtils;
+    IDxcIncludeHandler*         pIncludeHandler;
+    memory_allocator_t*         pAllocator;
+    shader_compiler_worker_t*   pWorkers;               // one per core, created by the first compileShaderBatch() call
+    uint32_t                    workerCount;
+    const char*                 pShaderCacheDirectory;  // nullptr = shader cache disabled
+    uint64_t                    compilerVersionHash;    // version, flags and commit of the compiler build
+    shader_cache_statistics_t   cacheStatistics;
 };
 
 struct d3d12_descriptor_heap_t
@@ -285,6 +442,93 @@ struct d3d12_descriptor_heap_t
     uint64_t incrementSizeInBytes;
 };
 
+constexpr uint32_t descriptorBlockSizeClassCount = 8u;     // blocks of 1, 2, 4 ... 128 descriptors
+constexpr uint32_t invalidDescriptorIndex = ~0u;
+constexpr uint32_t maxShaderVisibleSamplerDescriptorCount = 2048u;    // D3D12_MAX_SHADER_VISIBLE_SAMPLER_HEAP_SIZE
+
+struct descriptor_allocation_t
+{
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle;
+    D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle;      // 0 for descriptor heaps that aren't shader visible
+    uint32_t                    heapIndex;      // index of the first descriptor within the descriptor heap
+    uint32_t                    count;
+};
+
+struct descriptor_allocator_statistics_t
+{
+    uint32_t usedDescriptorCount;           // including the padding of rounded up blocks/skipped ring buffer ends
+    uint32_t highWaterMarkDescriptorCount;
+    uint32_t allocationCount;
+    uint32_t failedAllocationCount;         // allocations that failed because the descriptor heap was exhausted
+};
+
+//FK: For long-lived views. Allocations get rounded up to power of two blocks with a free list per block size, so allocating
+//    and freeing is O(1). Blocks never get split or merged, descriptors that were never allocated are handed out linearly.
+struct persistent_descriptor_allocator_t
+{
+    d3d12_descriptor_heap_t             descriptorHeap;
+    memory_allocator_t*                 pMemoryAllocator;
+    uint32_t*                           pNextFreeBlockIndices;      // free list links, indexed by the heap index of a free block
+    uint32_t                            firstFreeBlockIndices[descriptorBlockSizeClassCount];
+    uint32_t                            descriptorCapacity;
+    uint32_t                            untouchedDescriptorIndex;   // descriptors from here on were never allocated
+    SRWLOCK                             lock;                       // views get created and destroyed from multiple threads
+    descriptor_allocator_statistics_t   statistics;
+};
+
+//FK: Shader visible descriptors that are only valid for the frame that allocated them. The ring buffer counts descriptors
+//    instead of bytes and gets reclaimed once the frame fence passed the frame that allocated them.
+struct transient_descriptor_allocator_t
+{
+    const d3d12_descriptor_heap_t*      pDescriptorHeap;
+    uint32_t                            firstDescriptorIndex;   // the allocator owns a range of a shader visible descriptor heap
+    ring_buffer_allocator_t             ringBuffer;
+    SRWLOCK                             lock;       // render passes allocate from multiple threads
+    descriptor_allocator_statistics_t   statistics;
+};
+
+//FK: Draw constants are 32 bit root constants in the first root parameter, shaders see them in b0, space0.
+//    Every constant costs one DWORD of the 64 DWORD root signature limit.
+constexpr uint32_t drawConstantsRootParameterIndex = 0u;
+constexpr uint32_t maxDrawConstantCount = 16u;
+constexpr uint32_t bindlessDrawConstantCount = 4u;
+static_assert(maxDrawConstantCount <= 32u, "Draw constants are tracked with a 32 bit mask");
+static_assert(bindlessDrawConstantCount <= maxDrawConstantCount, "Bindless draw constants have to fit into the draw constants");
+
+//FK: Root parameters of the bindless root signature, see getBindlessRootSignatureDesc()
+enum bindless_root_parameter_t : uint32_t
+{
+    bindless_root_parameter_draw_constants = drawConstantsRootParameterIndex,
+    bindless_root_parameter_srv_table,
+    bindless_root_parameter_cbv_table,
+    bindless_root_parameter_uav_table,
+    bindless_root_parameter_count
+};
+
+struct retired_bindless_descriptor_t
+{
+    uint64_t fenceValue;        // descriptor can be reused once the frame fence reached this value
+    uint32_t descriptorIndex;
+};
+
+//FK: Resources get registered once and are addressed by their descriptor index from then on. The indices are the start of a
+//    shader visible descriptor heap that the bindless root signature exposes as a whole. Released indices might still be
+//    used by frames in flight, so they only become free once those frames are done.
+struct bindless_descriptor_table_t
+{
+    const d3d12_descriptor_heap_t*      pDescriptorHeap;
+    memory_allocator_t*                 pMemoryAllocator;
+    uint32_t*                           pFreeDescriptorIndices;     // stack
+    retired_bindless_descriptor_t*      pRetiredDescriptors;        // queue, ordered by fence value
+    uint32_t                            descriptorCapacity;
+    uint32_t                            freeDescriptorCount;
+    uint32_t                            firstRetiredDescriptorIndex;
+    uint32_t                            retiredDescriptorCount;
+    uint32_t                            untouchedDescriptorIndex;   // descriptors from here on were never allocated
+    SRWLOCK                             lock;                       // bindless views get created and released from multiple threads
+    descriptor_allocator_statistics_t   statistics;                 // retired descriptors count as used
+};
+
 struct d3d12_swap_chain_t
 {
     d3d12_descriptor_heap_t         backBufferRenderTargetDescriptorHeap;
@@ -297,20 +541,153 @@ struct d3d12_swap_chain_t
     uint8_t                         backBufferCount;
 };
 
+struct render_resource_cache_t;
+
+constexpr uint32_t maxRootParameterBindingCount  = 40u;
+constexpr uint32_t invalidRootParameterIndex     = ~0u;
+
+//FK: Where a register range ends up in the root signature, one per root constants, root descriptor and descriptor range.
+//    Static samplers can't be bound, so they don't get one.
+struct root_parameter_binding_t
+{
+    uint32_t    shaderRegister;
+    uint32_t    registerSpace;
+    uint32_t    descriptorCount;                    // 1 for root parameters, ~0u for unbounded ranges
+    uint32_t    offsetInDescriptorsFromTableStart;  // 0 for root parameters
+    uint8_t     type;                               // shader_resource_binding_type_t, root constants count as constant buffer
+    uint8_t     parameterType;                      // D3D12_ROOT_PARAMETER_TYPE
+    uint8_t     rootParameterIndex;
+    uint8_t     padding;
+};
+
+constexpr uint32_t maxCachedVertexBufferSlotCount = 8u;
+
+struct state_filter_statistics_t
+{
+    uint32_t issuedCallCount;
+    uint32_t skippedCallCount;
+};
+
+struct vertex_buffer_binding_t
+{
+    vertex_buffer_handle_t vertexBuffer;
+    vertex_format_handle_t vertexFormat;
+};
+
+//FK: Shadow copy of the state that has been set on a render pass' command list
+struct render_pass_state_cache_t
+{
+    const ID3D12PipelineState*  pPipelineState;
+    const ID3D12RootSignature*  pRootSignature;
+    D3D12_VIEWPORT              viewport;
+    D3D12_RECT                  scissorRect;
+    D3D12_PRIMITIVE_TOPOLOGY    primitiveTopology;
+    D3D12_CPU_DESCRIPTOR_HANDLE renderTargetDescriptor;
+    vertex_buffer_binding_t     vertexBufferBindings[maxCachedVertexBufferSlotCount];
+    uint32_t                    drawConstants[maxDrawConstantCount];
+    uint32_t                    unknownDrawConstantMask;    // constants that haven't been set since the root signature changed
+    state_filter_statistics_t   statistics;
+};
+
+//FK: Draw sort key layout from most to least significant bits, replaying the sorted draws changes the upper fields least often
+constexpr uint32_t drawSortKeyDepthBitCount         = 24u;
+constexpr uint32_t drawSortKeyVertexBufferBitCount  = 16u;
+constexpr uint32_t drawSortKeyPipelineStateBitCount = 16u;
+constexpr uint32_t drawSortKeyLayerBitCount         = 8u;
+static_assert(drawSortKeyDepthBitCount + drawSortKeyVertexBufferBitCount + drawSortKeyPipelineStateBitCount + drawSortKeyLayerBitCount == 64u, "Draw sort keys have to use all 64 bits");
+
+constexpr uint32_t maxQueuedDrawConstantCount   = 4u;
+constexpr uint32_t initialDrawQueueCapacity     = 256u;
+
+struct queued_draw_t
+{
+    graphics_pipeline_state_handle_t    pipelineState;
+    vertex_buffer_handle_t              vertexBuffer;       // bound to slot 0
+    vertex_format_handle_t              vertexFormat;
+    uint32_t                            vertexCountPerInstance;
+    uint32_t                            instanceCount;
+    uint32_t                            startVertexLocation;
+    uint32_t                            startInstanceLocation;
+    uint32_t                            drawConstants[maxQueuedDrawConstantCount];
+    uint32_t                            drawConstantCount;  // 0 = don't set draw constants
+};
+
+struct draw_sort_entry_t
+{
+    uint64_t sortKey;
+    uint32_t drawIndex;
+};
+
+struct draw_queue_statistics_t
+{
+    uint32_t queuedDrawCount;
+    uint32_t sortPassCount;     // radix sort passes that weren't skipped
+};
+
+//FK: Draws that get sorted by their sort key and recorded at the end of the render pass. The memory is kept when the
+//    render pass gets reused, so it only grows until the largest pass fits.
+struct draw_queue_t
+{
+    memory_allocator_t*         pMemoryAllocator;
+    queued_draw_t*              pDraws;
+    draw_sort_entry_t*          pSortEntries;
+    draw_sort_entry_t*          pScratchSortEntries;
+    uint32_t                    drawCount;
+    uint32_t                    capacity;
+    draw_queue_statistics_t     statistics;
+};
+
+struct pipeline_state_readiness_statistics_t
+{
+    uint32_t fallbackCount;     // trySetPipelineState() calls that bound the fallback pipeline state
+    uint32_t skippedDrawCount;  // draws that got skipped because no ready pipeline state was bound
+};
+
 struct render_pass_t
 {
     ID3D12CommandAllocator*     pGraphicsCommandAllocator;
     ID3D12GraphicsCommandList*  pGraphicsCommandList;
+    render_resource_cache_t*    pRenderResourceCache;
     const char*                 pName;
     bool                        isOpen;
     render_target_t*            pRenderTarget;
     render_pass_t*              pNext;
+    uint64_t                    uploadFenceValueToWaitFor;
+    uint32_t                    sortIndex;
+    d3d12_resource_t            renderTargetResource;       // pass local copy so that passes can be recorded in parallel
+    D3D12_RESOURCE_STATES       renderTargetEntryState;
+    resource_barrier_batch_t    barrierBatch;
+    render_pass_state_cache_t   stateCache;
+    LONG                        pipelineStateCompletionIndex;   // copy of the frame's index
+    bool                        skipDraws;                      // no ready pipeline state is bound
+    uint32_t                    drawConstantCount;              // of the bound pipeline state
+    graphics_pipeline_state_handle_t pipelineState;             // bound by setPipelineState()
+    root_parameter_binding_t    rootParameterBindings[maxRootParameterBindingCount];  // copy of the bound pipeline state's, the pipeline state table can grow
+    uint32_t                    rootParameterBindingCount;
+    draw_queue_t                drawQueue;
+    const d3d12_descriptor_heap_t* pShaderVisibleDescriptorHeap;
+    pipeline_state_readiness_statistics_t pipelineStateReadinessStatistics;
+};
+
+enum graphics_pipeline_state_status_t : LONG
+{
+    pipeline_state_status_compiling = 0,
+    pipeline_state_status_ready,
+    pipeline_state_status_failed
 };
 
 struct graphics_pipeline_state_t
 {
     ID3D12PipelineState* pPipelineState;
     ID3D12RootSignature* pRootSignature;
+    uint64_t             cacheKey;
+    uint32_t             referenceCount;    // one per createGraphicsPipelineState() call that returned this pipeline state
+    volatile LONG        status;            // graphics_pipeline_state_status_t
+    volatile LONG        completionIndex;   // frames whose pipelineStateCompletionIndex is at least this can use the pipeline state
+    bool                 isBindless;        // uses the bindless root signature
+    uint32_t             drawConstantCount;
+    root_parameter_binding_t rootParameterBindings[maxRootParameterBindingCount];
+    uint32_t             rootParameterBindingCount;
 };
 
 enum upload_buffer_flags_t : uint8_t
@@ -320,10 +697,32 @@ enum upload_buffer_flags_t : uint8_t
 
 struct upload_buffer_t
 {
-    uint32_t            sizeInBytes;
-    void*               pData;
-    d3d12_resource_t    bufferResource;
-    upload_buffer_t*    pNext;
+    d3d12_resource_t*       pBufferResource;
+    void*                   pData;
+    uint32_t                sizeInBytes;
+    staging_buffer_slice_t  slice;
+};
+
+constexpr uint32_t constantBufferAlignmentInBytes = 256u;    // D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT
+
+//FK: Linear allocator for constants that are only used by a single frame. Every graphics frame has its own buffer which
+//    gets reset once the frame is done on the GPU, the GPU reads the constants straight from the upload heap.
+struct constant_buffer_allocator_t
+{
+    d3d12_resource_t            bufferResource;
+    uint8_t*                    pMappedData;
+    D3D12_GPU_VIRTUAL_ADDRESS   gpuBaseAddress;
+    uint32_t                    sizeInBytes;
+    volatile LONG64             usedSizeInBytes;            // render passes allocate from multiple threads, never exceeds sizeInBytes
+    volatile LONG               failedAllocationCount;      // reset every frame
+    uint32_t                    highWaterMarkInBytes;
+};
+
+struct constant_allocation_t
+{
+    void*                       pData;                  // nullptr if the constant buffer is exhausted
+    D3D12_GPU_VIRTUAL_ADDRESS   gpuVirtualAddress;
+    uint32_t                    sizeInBytes;
 };
 
 enum vertex_attribute_t : uint8_t
@@ -332,9 +731,18 @@ enum vertex_attribute_t : uint8_t
     color
 };
 
+//FK: 3 component 8 and 16 bit attributes are padded to 4 components since there are no matching DXGI formats.
+//    The octahedral types store a unit normal (count 3) as 2 snorm components, the vertex shader has to decode it.
 enum vertex_attribute_type_t : uint8_t
 {
-    float32
+    float32,
+    float16,
+    snorm8,
+    unorm8,
+    snorm16,
+    rgb10a2,        // count 3 or 4, alpha is 1 for 3 components
+    octahedral8,
+    octahedral16
 };
 
 struct vertex_attribute_entry_t
@@ -344,38 +752,107 @@ struct vertex_attribute_entry_t
     uint32_t                count;
 };
 
+constexpr uint32_t maxVertexAttributeCount = 12u;
+constexpr uint32_t vertexPackingChunkSizeInVertices = 64u;
+
+enum simd_level_t : uint8_t
+{
+    simd_level_scalar = 0,
+    simd_level_sse2,
+    simd_level_avx2
+};
+
+//FK: Vertex formats are interned by createVertexFormat(), so equal handles mean equal formats and the handle index can be
+//    used as a compact vertex format id. Everything binding and pipeline state creation need is precomputed by initVertexFormat().
 struct vertex_format_t
 {
-    vertex_attribute_entry_t    pVertexAttributes[12];
+    vertex_attribute_entry_t    pVertexAttributes[maxVertexAttributeCount];
+    uint32_t                    attributeOffsetsInBytes[maxVertexAttributeCount];
+    D3D12_INPUT_ELEMENT_DESC    inputElementDescs[maxVertexAttributeCount];     // one per attribute, all in slot 0
+    uint64_t                    hash;
     uint32_t                    vertexAttributeCount;
+    uint32_t                    strideInBytes;
+    uint32_t                    referenceCount;
 };
 
 struct vertex_buffer_t
 {
     d3d12_resource_t bufferResource;
+    uint64_t         uploadFenceValue;  // upload batch that has to finish before the buffer can be used
     uint32_t         sizeInBytes;
 };
 
+constexpr uint32_t maxShaderResourceBindingCount = 16u;
+constexpr uint8_t invalidVertexAttribute = 0xFFu;
+
+enum shader_resource_binding_type_t : uint8_t
+{
+    shader_resource_binding_constant_buffer = 0,
+    shader_resource_binding_srv,
+    shader_resource_binding_uav,
+    shader_resource_binding_sampler
+};
+
+struct shader_input_attribute_t
+{
+    uint8_t attribute;      // vertex_attribute_t, invalidVertexAttribute if the semantic doesn't name a vertex attribute
+    uint8_t semanticIndex;
+};
+
+struct shader_resource_binding_t
+{
+    uint32_t    shaderRegister;
+    uint32_t    registerSpace;
+    uint32_t    bindCount;                  // 0 = unbounded array
+    uint32_t    constantBufferSizeInBytes;  // 0 for anything but constant buffers
+    uint8_t     type;                       // shader_resource_binding_type_t
+    uint8_t     padding[3];
+};
+
+//FK: Extracted from the DXC reflection data when the shader gets compiled and stored in the shader cache next to the blob
+struct shader_reflection_t
+{
+    shader_input_attribute_t    inputAttributes[maxVertexAttributeCount];       // vertex shader inputs without system values
+    shader_resource_binding_t   resourceBindings[maxShaderResourceBindingCount];
+    uint32_t                    inputAttributeCount;
+    uint32_t                    resourceBindingCount;
+    uint32_t                    isValid;                                        // 0 if the shader couldn't be reflected
+};
+
 struct shader_binary_t
 {
     const uint8_t* pShaderBlob;
+    uint64_t shaderBlobHash;
     uint32_t shaderBlobSizeInBytes;
     shader_binary_t* pNext;
+    shader_reflection_t reflection;
 };
 
 struct render_pass_parameters_t
 {
-    render_target_t* pRenderTarget; // nullptr = backbuffer
-    shader_binary_t* pVertexShader;
-    shader_binary_t* pPixelShader;
+    render_target_t*        pRenderTarget; // nullptr = backbuffer
+    shader_binary_handle_t  vertexShader;
+    shader_binary_handle_t  pixelShader;
 };
 
+constexpr uint32_t maxPipelineStateRenderTargetCount = 8u;
+
 struct graphics_pipeline_state_parameters_t
 {
-    const char*         pName;
-    shader_binary_t*    pVertexShader;
-    shader_binary_t*    pPixelShader;
-    vertex_format_t*    pVertexFormat;
+    const char*                     pName;
+    shader_binary_handle_t          vertexShader;
+    shader_binary_handle_t          pixelShader;
+    vertex_format_handle_t          vertexFormat;
+    D3D12_BLEND_DESC                blendDesc;
+    D3D12_DEPTH_STENCIL_DESC        depthStencilDesc;
+    D3D12_RASTERIZER_DESC           rasterizerDesc;
+    D3D12_PRIMITIVE_TOPOLOGY_TYPE   primitiveTopologyType;
+    DXGI_FORMAT                     renderTargetFormats[maxPipelineStateRenderTargetCount];
+    DXGI_FORMAT                     depthStencilFormat;
+    uint32_t                        renderTargetCount;
+    const D3D12_ROOT_SIGNATURE_DESC*    pRootSignatureDesc;    // nullptr = generated from shader reflection
+    bool                            useBindlessRootSignature;   // pRootSignatureDesc has to be nullptr, see getBindlessRootSignatureDesc()
+    uint32_t                        drawConstantCount;          // see setDrawConstants(), explicit root signature descs have to declare them as first root parameter
 };
 
 struct base_dynamic_array_t
@@ -390,7 +867,7 @@ struct base_dynamic_array_t
 template<typename T>
 struct auto_resource_t
 {
-    T operator()
+    T operator()()
     {
         return resource;
     }
@@ -403,6 +880,171 @@ struct dynamic_array_t : base_dynamic_array_t
 {
 };
 
+struct resource_table_slot_t
+{
+    uint32_t generation;        // odd = slot is in use, even = slot is free
+    uint32_t nextFreeSlotIndex;
+};
+
+struct base_resource_table_t
+{
+    memory_allocator_t*     pMemoryAllocator;
+    void*                   pData;
+    resource_table_slot_t*  pSlots;
+    uint32_t                count;              // number of slots that have been handed out at least once
+    uint32_t                capacity;
+    uint32_t                aliveCount;
+    uint32_t                firstFreeSlotIndex;
+    uint32_t                elementSizeInBytes;
+    bool                    ownsMemory;         // false as long as the table lives inside the preallocated resource blob
+};
+
+template<typename T, typename HANDLE_TYPE>
+struct resource_table_t : base_resource_table_t
+{
+};
+
+enum pipeline_state_cache_entry_state_t : uint8_t
+{
+    pipeline_state_cache_entry_empty = 0,
+    pipeline_state_cache_entry_pending,     // pipeline state is getting created by another thread
+    pipeline_state_cache_entry_ready
+};
+
+//FK: Everything the key of a pipeline state gets calculated from. Shaders are identified by their blob, generated and
+//    bindless root signatures only depend on the shaders and the draw constants so only explicit root signature descs get stored.
+struct graphics_pipeline_state_key_inputs_t
+{
+    uint64_t                        vertexShaderBlobHash;
+    uint64_t                        pixelShaderBlobHash;
+    uint32_t                        vertexShaderBlobSizeInBytes;
+    uint32_t                        pixelShaderBlobSizeInBytes;
+    vertex_attribute_entry_t        vertexAttributes[maxVertexAttributeCount];
+    uint32_t                        vertexAttributeCount;
+    D3D12_BLEND_DESC                blendDesc;
+    D3D12_DEPTH_STENCIL_DESC        depthStencilDesc;
+    D3D12_RASTERIZER_DESC           rasterizerDesc;
+    D3D12_PRIMITIVE_TOPOLOGY_TYPE   primitiveTopologyType;
+    DXGI_FORMAT                     renderTargetFormats[maxPipelineStateRenderTargetCount];
+    DXGI_FORMAT                     depthStencilFormat;
+    uint32_t                        renderTargetCount;
+    uint32_t                        drawConstantCount;
+    bool                            useBindlessRootSignature;
+    uint8_t*                        pRootSignatureDesc;                 // flattened explicit root signature desc, see flattenRootSignatureDesc()
+    uint32_t                        rootSignatureDescSizeInBytes;
+};
+
+struct pipeline_state_cache_entry_t
+{
+    uint64_t                                key;
+    graphics_pipeline_state_key_inputs_t    keyInputs;  // compared on a key match so that key collisions don't share pipeline states
+    graphics_pipeline_state_handle_t        pipelineState;
+    uint8_t                                 state;      // pipeline_state_cache_entry_state_t
+};
+
+struct pipeline_state_cache_statistics_t
+{
+    uint32_t hitCount;
+    uint32_t missCount;         // pipeline state objects that actually got created
+    uint32_t coalescedCount;    // requests for a pipeline state that was still getting created by another thread
+    uint32_t failedCount;
+    uint32_t compileJobCount;   // pipeline states that got compiled on the threadpool
+};
+
+constexpr uint32_t maxPipelineStateCompileJobNameLength = 64u;
+
+struct pipeline_state_compile_job_t
+{
+    pipeline_state_compile_job_t*       pNext;
+    D3D12DeviceType*                    pDevice;
+    graphics_pipeline_state_handle_t    pipelineState;
+    uint64_t                            key;
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC  graphicsPipelineStateDesc;  // owns the root signature reference until the job is done
+    D3D12_INPUT_ELEMENT_DESC            inputElementDescs[maxVertexAttributeCount];
+    char                                name[maxPipelineStateCompileJobNameLength];
+};
+
+//FK: Open addressing hash table with linear probing, keyed by the hash of everything that goes into the pipeline state desc
+struct pipeline_state_cache_t
+{
+    pipeline_state_cache_entry_t*       pEntries;
+    uint32_t                            entryCapacity;  // power of two
+    uint32_t                            entryCount;
+    SRWLOCK                             lock;
+    CONDITION_VARIABLE                  pipelineStateCreated;
+    pipeline_state_cache_statistics_t   statistics;
+    PTP_WORK                            pCompileWork;       // created on the first asynchronous request
+    pipeline_state_compile_job_t*       pFirstCompileJob;
+    pipeline_state_compile_job_t*       pLastCompileJob;
+    volatile LONG                       completedCompileJobCount;
+};
+
+struct root_signature_cache_entry_t
+{
+    uint64_t                key;                    // hash of the root parameter layout
+    uint8_t*                pRootSignatureDesc;     // flattened, compared on a key match so that key collisions don't share root signatures
+    uint32_t                rootSignatureDescSizeInBytes;
+    ID3D12RootSignature*    pRootSignature;
+};
+
+struct root_signature_cache_statistics_t
+{
+    uint32_t hitCount;
+    uint32_t missCount;
+};
+
+struct root_signature_cache_t
+{
+    memory_allocator_t*                 pAllocator;
+    root_signature_cache_entry_t*       pEntries;
+    uint32_t                            entryCount;
+    uint32_t                            entryCapacity;
+    SRWLOCK                             lock;
+    root_signature_cache_statistics_t   statistics;
+};
+
+struct vertex_format_cache_entry_t
+{
+    uint64_t                hash;
+    vertex_format_handle_t  vertexFormat;
+    bool                    isOccupied;
+};
+
+struct vertex_format_cache_statistics_t
+{
+    uint32_t hitCount;      // createVertexFormat() calls that returned an existing vertex format
+    uint32_t missCount;
+};
+
+//FK: Open addressing hash table with linear probing, keyed by the hash of the vertex attributes
+struct vertex_format_cache_t
+{
+    vertex_format_cache_entry_t*        pEntries;
+    uint32_t                            entryCapacity;  // power of two
+    uint32_t                            entryCount;
+    vertex_format_cache_statistics_t    statistics;
+};
+
+struct pipeline_library_statistics_t
+{
+    uint32_t loadedCount;       // pipeline states that didn't have to be compiled
+    uint32_t storedCount;       // pipeline states added to the library
+    uint32_t invalidatedCount;  // library files that got discarded
+    uint32_t writeFailureCount;
+};
+
+//FK: Backs the pipeline state cache with a pipeline library file, entries are named by the pipeline state cache key
+struct pipeline_library_t
+{
+    ID3D12PipelineLibrary*          pPipelineLibrary;   // nullptr = pipeline library disabled
+    memory_allocator_t*             pAllocator;
+    uint8_t*                        pSerializedLibrary; // has to outlive pPipelineLibrary
+    const char*                     pFilePath;
+    SRWLOCK                         lock;
+    bool                            hasChanged;
+    pipeline_library_statistics_t   statistics;
+};
+
 enum render_resource_flags_t : uint8_t
 {
     none                    = 0,
@@ -411,38 +1053,69 @@ enum render_resource_flags_t : uint8_t
 
 struct render_resource_cache_t
 {
-    memory_allocator_t*                 pMemoryAllocator;
-    dynamic_array_t<vertex_buffer_t>    vertexBuffers;
-    dynamic_array_t<render_pass_t>      renderPasses;
-    dynamic_array_t<render_target_t>    renderTargets;
-    dynamic_array_t<vertex_format_t>    vertexFormats;
-    dynamic_array_t<graphics_pipeline_state_t>   pipelineStates;
-    dynamic_array_t<upload_buffer_t>    uploadBuffers;
-    dynamic_array_t<shader_binary_t>    shaderBinaries;
+    memory_allocator_t*                                                         pMemoryAllocator;
+    resource_table_t<vertex_buffer_t, vertex_buffer_handle_t>                   vertexBuffers;
+    dynamic_array_t<render_pass_t>                                              renderPasses;
+    resource_table_t<render_target_t, render_target_handle_t>                   renderTargets;
+    resource_table_t<vertex_format_t, vertex_format_handle_t>                   vertexFormats;
+    resource_table_t<graphics_pipeline_state_t, graphics_pipeline_state_handle_t> pipelineStates;
+    resource_table_t<shader_binary_t, shader_binary_handle_t>                   shaderBinaries;
+    vertex_format_cache_t                                                       vertexFormatCache;
+    pipeline_state_cache_t                                                      pipelineStateCache;
+    root_signature_cache_t                                                      rootSignatureCache;
+    pipeline_library_t                                                          pipelineLibrary;
 
     render_pass_t*                      pFirstFreeRenderPass;
+    SRWLOCK                             renderPassFreeListLock;
 
     flags8_t<render_resource_flags_t>   flags;
 };
 
+struct submit_statistics_t
+{
+    uint32_t submitCallCount;           // ExecuteCommandLists calls
+    uint32_t submittedCommandListCount;
+};
+
 struct graphics_frame_t
 {
-    memory_allocator_t                      tempMemoryAllocator;
+    linear_memory_allocator_t               tempMemoryAllocator;
     render_resource_cache_t*                pRenderResourceCache;
     shader_compiler_context_t*              pShaderCompilerContext;
     render_target_t*                        pBackBuffer;
     memory_allocator_t*                     pMemoryAllocator;
     render_pass_t*                          pFirstRenderPassToExecute;
     render_pass_t*                          pLastRenderPassToExecute;
-    upload_buffer_t*                        pFirstUploadBuffer;
+    upload_ring_buffer_t*                   pUploadRingBuffer;
+    upload_queue_t*                         pUploadQueue;
+    transient_descriptor_allocator_t*       pTransientDescriptorAllocator;
+    bindless_descriptor_table_t*            pBindlessDescriptorTable;
+    persistent_descriptor_allocator_t*      pSamplerDescriptorAllocator;
+    constant_buffer_allocator_t             constantBufferAllocator;
     uint64_t                                frameIndex;
-    uint32_t                                openRenderPassCount;
+    volatile LONG                           openRenderPassCount;
+    volatile LONG                           nextRenderPassSortIndex;
+    SRWLOCK                                 renderPassSubmitLock;
     D3D12DeviceType*                        pDevice;
     ID3D12Fence*                            pFrameFence;
     ID3D12GraphicsCommandList*              pFrameGeneralGraphicsQueue;
     ID3D12CommandAllocator*                 pFrameGeneralGraphicsCommandAllocator;
+    resource_barrier_batch_t                generalGraphicsBarrierBatch;
+    resource_barrier_statistics_t           barrierStatistics;
+    state_filter_statistics_t               stateFilterStatistics;
+    pipeline_state_readiness_statistics_t   pipelineStateReadinessStatistics;
+    LONG                                    pipelineStateCompletionIndex;   // pipeline states compiled before the frame began
+    ID3D12GraphicsCommandList*              pFrameGeneralCopyQueue;
+    ID3D12CommandAllocator*                 pFrameGeneralCopyCommandAllocator;
+    uint64_t                                uploadFenceValue;
+    uint32_t                                pendingCopyCount;
     ID3D12CommandQueue*                     pFrameCommandQueue;
     HANDLE                                  pFrameFinishedEvent;
+    render_pass_t*                          pLastSubmittedRenderPass;   // executed render passes after this one haven't been submitted yet
+    uint32_t                                renderPassToSubmitCount;
+    uint32_t                                nextSortIndexToSubmit;      // early submissions continue at this sort index
+    uint32_t                                renderPassSubmitThreshold;
+    submit_statistics_t                     submitStatistics;
 };
 
 struct graphics_frame_collection_t
@@ -456,8 +1129,10 @@ struct graphics_frame_parameters_t
 {
     uint32_t maxRenderPassCount;
     uint32_t maxVertexBufferCount;
-    uint32_t maxUploadBufferCount;
     uint32_t defaultStagingBufferSizeInBytes;
+    uint32_t tempMemorySizeInBytes;
+    uint32_t constantBufferSizeInBytes;
+    uint32_t renderPassSubmitThreshold;
 };
 
 struct render_context_t
@@ -468,6 +1143,13 @@ struct render_context_t
 
     render_resource_cache_t     renderResourceCache;
     shader_compiler_context_t   shaderCompilerContext;
+    upload_ring_buffer_t        uploadRingBuffer;
+    upload_queue_t              uploadQueue;
+    persistent_descriptor_allocator_t   persistentDescriptorAllocator;
+    d3d12_descriptor_heap_t             shaderVisibleDescriptorHeap;    // bindless descriptors followed by the transient descriptors
+    bindless_descriptor_table_t         bindlessDescriptorTable;
+    transient_descriptor_allocator_t    transientDescriptorAllocator;
+    persistent_descriptor_allocator_t   samplerDescriptorAllocator;     // shader visible, for the sampler tables of generated root signatures
     memory_allocator_t          defaultAllocator;
     graphics_frame_collection_t graphicsFramesCollection;
     const graphics_frame_t*     pCurrentGraphicsFrame;
@@ -518,20 +1200,21 @@ enum assert_result_t
 };
 
 constexpr uint64_t          defaultAllocationAlignment      = 16u;
+constexpr uint64_t          uploadBufferAlignmentInBytes    = 16u;
 constexpr uint32_t          invalidResourceHandleValue      = ~0u;
 constexpr memory_buffer_t   emptyMemoryBuffer               = {nullptr, 0u};
 
 template<typename T>
 T createInvalidResourceHandle()
 {
-    T handle = {invalidResourceHandleValue};
+    T handle = {invalidResourceHandleValue, 0u};
     return handle;
 }
 
 template<typename T>
-T createResourceHandle(uint32_t resourceIndex)
+T createResourceHandle(uint32_t resourceIndex, uint32_t resourceGeneration)
 {
-    T handle = {resourceIndex};
+    T handle = {resourceIndex, resourceGeneration};
     return handle;
 }
 
@@ -546,6 +1229,33 @@ void copyMemoryNonOverlapping(void* pDst, const void* pSrc, const uint64_t sizeI
     memcpy(pDst, pSrc, sizeInBytes);
 }
 
+constexpr uint64_t fnv1aOffsetBasis = 0xcbf29ce484222325ull;
+constexpr uint64_t fnv1aPrime       = 0x100000001b3ull;
+
+//FK: FNV-1a, pass the previous hash to hash multiple buffers in a row
+uint64_t calculateHash(const void* pData, const uint64_t sizeInBytes, uint64_t hash = fnv1aOffsetBasis)
+{
+    const uint8_t* pBytes = (const uint8_t*)pData;
+    for(uint64_t byteIndex = 0u; byteIndex < sizeInBytes; ++byteIndex)
+    {
+        hash ^= pBytes[byteIndex];
+        hash *= fnv1aPrime;
+    }
+
+    return hash;
+}
+
+//FK: Includes the zero terminator, so consecutive strings can't produce the same hash by shifting characters between them
+uint64_t calculateStringHash(const char* pString, uint64_t hash = fnv1aOffsetBasis)
+{
+    if(pString == nullptr)
+    {
+        pString = "";
+    }
+
+    return calculateHash(pString, strlen(pString) + 1u, hash);
+}
+
 void logError(const char* pErrorFormat, ...)
 {
     printf("Error: ");
@@ -677,9 +1387,18 @@ HRESULT logOnHResultError(const HRESULT originalResult, const char* pFunctionCal
     return originalResult;
 }
 
+uint64_t alignValue(const uint64_t value, const uint64_t alignmentInBytes)
+{
+    ASSERT_DEBUG(alignmentInBytes > 0u && (alignmentInBytes & (alignmentInBytes - 1u)) == 0u);
+    return (value + alignmentInBytes - 1u) & ~(alignmentInBytes - 1u);
+}
+
 void resetAllocator(memory_allocator_t* pAllocator)
 {
-    
+    if(pAllocator->resetFnc != nullptr)
+    {
+        pAllocator->resetFnc(pAllocator);
+    }
 }
 
 void* allocateFromAllocator(memory_allocator_t* pAllocator, uint64_t sizeInBytes, alloc_flags_t flags = alloc_flag_none)
@@ -737,40 +1456,251 @@ void createDefaultMemoryAllocator(memory_allocator_t* pAllocator)
 {
     pAllocator->allocateFnc = allocateFromDefaultAllocator;
     pAllocator->freeFnc     = freeFromDefaultAllocator;
+    pAllocator->resetFnc    = nullptr;
 }
 
-shader_binary_t* allocateShaderBinary(graphics_frame_t* pGraphicsFrame)
+linear_memory_allocator_chunk_t* allocateLinearMemoryAllocatorChunk(memory_allocator_t* pBaseAllocator, const uint64_t sizeInBytes)
 {
-    return (shader_binary_t*)allocateFromAllocator(pGraphicsFrame->pMemoryAllocator, sizeof(shader_binary_t));
-}
+    const uint64_t chunkHeaderSizeInBytes = alignValue(sizeof(linear_memory_allocator_chunk_t), defaultAllocationAlignment);
+    uint8_t* pChunkMemory = (uint8_t*)allocateFromAllocator(pBaseAllocator, chunkHeaderSizeInBytes + sizeInBytes);
+    if(pChunkMemory == nullptr)
+    {
+        return nullptr;
+    }
 
-void freeShaderBinary(graphics_frame_t* pGraphicsFrame, shader_binary_t* pShaderBinary)
-{
-    freeFromAllocator(pGraphicsFrame->pMemoryAllocator, pShaderBinary);
-}
+    linear_memory_allocator_chunk_t* pChunk = (linear_memory_allocator_chunk_t*)pChunkMemory;
+    pChunk->pNext           = nullptr;
+    pChunk->pMemory         = pChunkMemory + chunkHeaderSizeInBytes;
+    pChunk->sizeInBytes     = sizeInBytes;
+    pChunk->offsetInBytes   = 0u;
 
-void freeUploadBuffer(render_resource_cache_t* pRenderResourceCache, upload_buffer_t* pUploadBuffer)
-{
-    //TODO
+    return pChunk;
 }
 
-void initializeRenderTarget(render_target_t* pRenderTarget, ID3D12Resource* pRenderTargetResource, D3D12_CPU_DESCRIPTOR_HANDLE* pDescriptorHandle, D3D12_RESOURCE_STATES state)
+void* allocateFromLinearMemoryAllocator(memory_allocator_t* pAllocator, uint64_t sizeInBytes, uint64_t alignmentInBytes)
 {
-    pRenderTarget->resource.pResource       = pRenderTargetResource;
-    pRenderTarget->resource.currentState    = state;
-    pRenderTarget->cpuDescriptorHandle      = *pDescriptorHandle;
-}
+    linear_memory_allocator_t* pLinearAllocator = (linear_memory_allocator_t*)pAllocator;
+    linear_memory_allocator_chunk_t* pChunk = pLinearAllocator->pCurrentChunk;
 
-void destroyRenderTarget(render_target_t* pRenderTarget)
-{
-    COM_RELEASE(pRenderTarget->resource.pResource);
-}
+    while(true)
+    {
+        const uint64_t chunkBaseAddress     = (uint64_t)pChunk->pMemory;
+        const uint64_t alignedOffsetInBytes = alignValue(chunkBaseAddress + pChunk->offsetInBytes, alignmentInBytes) - chunkBaseAddress;
+        if(alignedOffsetInBytes + sizeInBytes <= pChunk->sizeInBytes)
+        {
+            pLinearAllocator->usedSizeInBytes += (alignedOffsetInBytes + sizeInBytes) - pChunk->offsetInBytes;
+            pLinearAllocator->pCurrentChunk = pChunk;
+            pChunk->offsetInBytes = alignedOffsetInBytes + sizeInBytes;
 
-void resetDescriptorHeap(d3d12_descriptor_heap_t* pDescriptorHeap)
-{
-    pDescriptorHeap->pCPUCurrent = (uint8_t*)pDescriptorHeap->pCPUBaseAddress;
-    pDescriptorHeap->pGPUCurrent = (uint8_t*)pDescriptorHeap->pGPUBaseAddress;
-}
+            if(pLinearAllocator->usedSizeInBytes > pLinearAllocator->highWaterMarkInBytes)
+            {
+                pLinearAllocator->highWaterMarkInBytes = pLinearAllocator->usedSizeInBytes;
+            }
+
+            return pChunk->pMemory + alignedOffsetInBytes;
+        }
+
+        if(pChunk->pNext == nullptr)
+        {
+            break;
+        }
+
+        //FK: The unused tail of the chunk we leave behind counts towards the footprint, same as when chaining a new chunk
+        pLinearAllocator->usedSizeInBytes += pChunk->sizeInBytes - pChunk->offsetInBytes;
+        pChunk->offsetInBytes = pChunk->sizeInBytes;
+
+        //FK: Chunks that got chained during previous frames are reset lazily when we advance to them
+        pChunk = pChunk->pNext;
+        pChunk->offsetInBytes = 0u;
+    }
+
+    const uint64_t minChunkSizeInBytes = sizeInBytes + alignmentInBytes;
+    const uint64_t newChunkSizeInBytes = minChunkSizeInBytes > pLinearAllocator->chunkSizeInBytes ? minChunkSizeInBytes : pLinearAllocator->chunkSizeInBytes;
+    logWarning("Linear allocator exhausted its %u chunk(s). Chaining additional chunk of %llu bytes.", pLinearAllocator->chunkCount, newChunkSizeInBytes);
+
+    linear_memory_allocator_chunk_t* pNewChunk = allocateLinearMemoryAllocatorChunk(pLinearAllocator->pBaseAllocator, newChunkSizeInBytes);
+    if(pNewChunk == nullptr)
+    {
+        return nullptr;
+    }
+
+    pChunk->pNext = pNewChunk;
+    ++pLinearAllocator->chunkCount;
+
+    //FK: Account for the unused tail of the previous chunk so the high water mark reflects the real footprint
+    pLinearAllocator->usedSizeInBytes += pChunk->sizeInBytes - pChunk->offsetInBytes;
+    pChunk->offsetInBytes = pChunk->sizeInBytes;
+    pLinearAllocator->pCurrentChunk = pNewChunk;
+
+    return allocateFromLinearMemoryAllocator(pAllocator, sizeInBytes, alignmentInBytes);
+}
+
+void freeFromLinearMemoryAllocator(memory_allocator_t* pAllocator, void* pMemory)
+{
+    //FK: Memory is reclaimed all at once when the allocator gets reset
+    UNUSED_PARAMETER(pAllocator);
+    UNUSED_PARAMETER(pMemory);
+}
+
+void resetLinearMemoryAllocator(memory_allocator_t* pAllocator)
+{
+    linear_memory_allocator_t* pLinearAllocator = (linear_memory_allocator_t*)pAllocator;
+    pLinearAllocator->frameHighWaterMarkInBytes = pLinearAllocator->usedSizeInBytes;
+    pLinearAllocator->usedSizeInBytes           = 0u;
+    pLinearAllocator->pCurrentChunk             = pLinearAllocator->pFirstChunk;
+    pLinearAllocator->pFirstChunk->offsetInBytes = 0u;
+}
+
+bool createLinearMemoryAllocator(linear_memory_allocator_t* pOutAllocator, memory_allocator_t* pBaseAllocator, const uint64_t chunkSizeInBytes)
+{
+    ASSERT_DEBUG(pOutAllocator != nullptr);
+    ASSERT_DEBUG(pBaseAllocator != nullptr);
+    ASSERT_DEBUG(chunkSizeInBytes > 0u);
+
+    linear_memory_allocator_chunk_t* pFirstChunk = allocateLinearMemoryAllocatorChunk(pBaseAllocator, chunkSizeInBytes);
+    if(pFirstChunk == nullptr)
+    {
+        return false;
+    }
+
+    linear_memory_allocator_t linearAllocator = {};
+    linearAllocator.allocateFnc         = allocateFromLinearMemoryAllocator;
+    linearAllocator.freeFnc             = freeFromLinearMemoryAllocator;
+    linearAllocator.resetFnc            = resetLinearMemoryAllocator;
+    linearAllocator.pBaseAllocator      = pBaseAllocator;
+    linearAllocator.pFirstChunk         = pFirstChunk;
+    linearAllocator.pCurrentChunk       = pFirstChunk;
+    linearAllocator.chunkSizeInBytes    = chunkSizeInBytes;
+    linearAllocator.chunkCount          = 1u;
+
+    *pOutAllocator = linearAllocator;
+    return true;
+}
+
+void destroyLinearMemoryAllocator(linear_memory_allocator_t* pAllocator)
+{
+    linear_memory_allocator_chunk_t* pChunk = pAllocator->pFirstChunk;
+    while(pChunk != nullptr)
+    {
+        linear_memory_allocator_chunk_t* pNextChunk = pChunk->pNext;
+        freeFromAllocator(pAllocator->pBaseAllocator, pChunk);
+        pChunk = pNextChunk;
+    }
+
+    clearMemoryWithZeroes(pAllocator);
+}
+
+void createRingBufferAllocator(ring_buffer_allocator_t* pOutAllocator, const uint64_t sizeInBytes)
+{
+    ASSERT_DEBUG(pOutAllocator != nullptr);
+    ASSERT_DEBUG(sizeInBytes > 0u);
+
+    clearMemoryWithZeroes(pOutAllocator);
+    pOutAllocator->sizeInBytes = sizeInBytes;
+}
+
+uint64_t getRingBufferUsedSizeInBytes(const ring_buffer_allocator_t* pAllocator)
+{
+    return pAllocator->headInBytes - pAllocator->tailInBytes;
+}
+
+bool allocateFromRingBuffer(ring_buffer_allocator_t* pAllocator, const uint64_t sizeInBytes, const uint64_t alignmentInBytes, buffer_slice_t* pOutSlice)
+{
+    ASSERT_DEBUG(pAllocator != nullptr);
+    ASSERT_DEBUG(pOutSlice != nullptr);
+    ASSERT_DEBUG(sizeInBytes > 0u);
+
+    const uint64_t physicalHeadInBytes = pAllocator->headInBytes % pAllocator->sizeInBytes;
+    uint64_t alignedHeadInBytes = alignValue(physicalHeadInBytes, alignmentInBytes);
+
+    //FK: Slices have to be contiguous, so skip the remainder of the buffer if the allocation doesn't fit at the end.
+    //    The skipped bytes are part of the current frame and get reclaimed together with it.
+    if(alignedHeadInBytes + sizeInBytes > pAllocator->sizeInBytes)
+    {
+        alignedHeadInBytes = pAllocator->sizeInBytes;
+    }
+
+    const uint64_t startInBytes = pAllocator->headInBytes + (alignedHeadInBytes - physicalHeadInBytes);
+    const uint64_t newHeadInBytes = startInBytes + sizeInBytes;
+    if(newHeadInBytes - pAllocator->tailInBytes > pAllocator->sizeInBytes)
+    {
+        return false;
+    }
+
+    pAllocator->headInBytes = newHeadInBytes;
+
+    const uint64_t usedSizeInBytes = getRingBufferUsedSizeInBytes(pAllocator);
+    if(usedSizeInBytes > pAllocator->highWaterMarkInBytes)
+    {
+        pAllocator->highWaterMarkInBytes = usedSizeInBytes;
+    }
+
+    pOutSlice->startByteIndex   = startInBytes % pAllocator->sizeInBytes;
+    pOutSlice->endByteIndex     = pOutSlice->startByteIndex + sizeInBytes;
+    return true;
+}
+
+void closeRingBufferFrame(ring_buffer_allocator_t* pAllocator, const uint64_t fenceValue)
+{
+    ASSERT_DEBUG(pAllocator != nullptr);
+    if(pAllocator->headInBytes == pAllocator->frameStartInBytes)
+    {
+        return;
+    }
+
+    if(pAllocator->inFlightSliceCount == maxRingBufferInFlightSliceCount)
+    {
+        //FK: Too many frames in flight, extend the newest slice instead. This only delays reclamation of that slice.
+        const uint32_t lastSliceIndex = (pAllocator->firstInFlightSliceIndex + pAllocator->inFlightSliceCount - 1u) % maxRingBufferInFlightSliceCount;
+        pAllocator->inFlightSlices[lastSliceIndex].endByteIndex = pAllocator->headInBytes;
+        pAllocator->inFlightSlices[lastSliceIndex].fenceValue   = fenceValue;
+    }
+    else
+    {
+        const uint32_t sliceIndex = (pAllocator->firstInFlightSliceIndex + pAllocator->inFlightSliceCount) % maxRingBufferInFlightSliceCount;
+        pAllocator->inFlightSlices[sliceIndex].startByteIndex   = pAllocator->frameStartInBytes;
+        pAllocator->inFlightSlices[sliceIndex].endByteIndex     = pAllocator->headInBytes;
+        pAllocator->inFlightSlices[sliceIndex].fenceValue       = fenceValue;
+        ++pAllocator->inFlightSliceCount;
+    }
+
+    pAllocator->frameStartInBytes = pAllocator->headInBytes;
+}
+
+void reclaimRingBuffer(ring_buffer_allocator_t* pAllocator, const uint64_t completedFenceValue)
+{
+    ASSERT_DEBUG(pAllocator != nullptr);
+    while(pAllocator->inFlightSliceCount > 0u)
+    {
+        const staging_buffer_slice_t* pSlice = &pAllocator->inFlightSlices[pAllocator->firstInFlightSliceIndex];
+        if(pSlice->fenceValue > completedFenceValue)
+        {
+            break;
+        }
+
+        pAllocator->tailInBytes = pSlice->endByteIndex;
+        pAllocator->firstInFlightSliceIndex = (pAllocator->firstInFlightSliceIndex + 1u) % maxRingBufferInFlightSliceCount;
+        --pAllocator->inFlightSliceCount;
+    }
+}
+
+void initializeRenderTarget(render_target_t* pRenderTarget, ID3D12Resource* pRenderTargetResource, D3D12_CPU_DESCRIPTOR_HANDLE* pDescriptorHandle, D3D12_RESOURCE_STATES state)
+{
+    pRenderTarget->resource.pResource       = pRenderTargetResource;
+    pRenderTarget->resource.currentState    = state;
+    pRenderTarget->cpuDescriptorHandle      = *pDescriptorHandle;
+}
+
+void destroyRenderTarget(render_target_t* pRenderTarget)
+{
+    COM_RELEASE(pRenderTarget->resource.pResource);
+}
+
+void resetDescriptorHeap(d3d12_descriptor_heap_t* pDescriptorHeap)
+{
+    pDescriptorHeap->pCPUCurrent = (uint8_t*)pDescriptorHeap->pCPUBaseAddress;
+    pDescriptorHeap->pGPUCurrent = (uint8_t*)pDescriptorHeap->pGPUBaseAddress;
+}
 
 D3D12_CPU_DESCRIPTOR_HANDLE getNextCPUDescriptorHandle(d3d12_descriptor_heap_t* pDescriptorHeap)
 {
@@ -785,6 +1715,8 @@ D3D12_CPU_DESCRIPTOR_HANDLE getNextCPUDescriptorHandle(d3d12_descriptor_heap_t*
 
 void markRenderPassChainAsFree(render_resource_cache_t* pRenderResourceCache, render_pass_t* pFirstRenderPassInChain)
 {
+    AcquireSRWLockExclusive(&pRenderResourceCache->renderPassFreeListLock);
+
     render_pass_t* pCurrentRenderPass = pFirstRenderPassInChain;
     while(pCurrentRenderPass != nullptr)
     {
@@ -794,6 +1726,141 @@ void markRenderPassChainAsFree(render_resource_cache_t* pRenderResourceCache, re
 
         pCurrentRenderPass = pNextRenderPass;
     }
+
+    ReleaseSRWLockExclusive(&pRenderResourceCache->renderPassFreeListLock);
+}
+
+void initResourceBarrierBatch(resource_barrier_batch_t* pBarrierBatch, ID3D12GraphicsCommandList* pCommandList)
+{
+    pBarrierBatch->pCommandList         = pCommandList;
+    pBarrierBatch->pendingBarrierCount  = 0u;
+    pBarrierBatch->statistics           = {};
+}
+
+void flushResourceBarriers(resource_barrier_batch_t* pBarrierBatch)
+{
+    if(pBarrierBatch->pendingBarrierCount == 0u)
+    {
+        return;
+    }
+
+    pBarrierBatch->pCommandList->ResourceBarrier(pBarrierBatch->pendingBarrierCount, pBarrierBatch->pendingBarriers);
+    pBarrierBatch->statistics.issuedBarrierCount += pBarrierBatch->pendingBarrierCount;
+    pBarrierBatch->pendingBarrierCount = 0u;
+}
+
+void addResourceBarrierStatistics(resource_barrier_statistics_t* pTarget, const resource_barrier_statistics_t* pSource)
+{
+    pTarget->issuedBarrierCount += pSource->issuedBarrierCount;
+    pTarget->elidedBarrierCount += pSource->elidedBarrierCount;
+}
+
+D3D12_RESOURCE_BARRIER* findPendingTransitionBarrier(resource_barrier_batch_t* pBarrierBatch, const ID3D12Resource* pResource)
+{
+    for(uint32_t barrierIndex = 0u; barrierIndex < pBarrierBatch->pendingBarrierCount; ++barrierIndex)
+    {
+        D3D12_RESOURCE_BARRIER* pBarrier = pBarrierBatch->pendingBarriers + barrierIndex;
+        if(pBarrier->Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION && pBarrier->Transition.pResource == pResource)
+        {
+            return pBarrier;
+        }
+    }
+
+    return nullptr;
+}
+
+D3D12_RESOURCE_BARRIER* allocatePendingResourceBarrier(resource_barrier_batch_t* pBarrierBatch)
+{
+    if(pBarrierBatch->pendingBarrierCount == maxPendingResourceBarrierCount)
+    {
+        flushResourceBarriers(pBarrierBatch);
+    }
+
+    D3D12_RESOURCE_BARRIER* pBarrier = pBarrierBatch->pendingBarriers + pBarrierBatch->pendingBarrierCount++;
+    *pBarrier = {};
+    pBarrier->Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+    return pBarrier;
+}
+
+//FK: pResourceBefore = nullptr means any placed resource in the same heap memory could have been active before
+void addAliasingBarrier(resource_barrier_batch_t* pBarrierBatch, d3d12_resource_t* pResourceBefore, d3d12_resource_t* pResourceAfter)
+{
+    D3D12_RESOURCE_BARRIER* pBarrier = allocatePendingResourceBarrier(pBarrierBatch);
+    pBarrier->Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+    pBarrier->Aliasing.pResourceBefore = pResourceBefore != nullptr ? pResourceBefore->pResource : nullptr;
+    pBarrier->Aliasing.pResourceAfter = pResourceAfter->pResource;
+}
+
+void addUnorderedAccessBarrier(resource_barrier_batch_t* pBarrierBatch, d3d12_resource_t* pResource)
+{
+    D3D12_RESOURCE_BARRIER* pBarrier = allocatePendingResourceBarrier(pBarrierBatch);
+    pBarrier->Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+    pBarrier->UAV.pResource = pResource->pResource;
+}
+
+//FK: Transitions don't get issued right away but get collected until the command list needs them (draw, clear, copy or close).
+//    This allows to merge A->B->C into A->C and to drop A->B->A completely.
+void transitionResource(resource_barrier_batch_t* pBarrierBatch, d3d12_resource_t* pResource, D3D12_RESOURCE_STATES newState)
+{
+    if(pResource->currentState == newState)
+    {
+        return;
+    }
+
+    D3D12_RESOURCE_BARRIER* pPendingBarrier = findPendingTransitionBarrier(pBarrierBatch, pResource->pResource);
+    if(pPendingBarrier != nullptr)
+    {
+        if(pPendingBarrier->Transition.StateBefore == newState)
+        {
+            //FK: Cancel both transitions, order of the barriers within a batch doesn't matter
+            *pPendingBarrier = pBarrierBatch->pendingBarriers[--pBarrierBatch->pendingBarrierCount];
+            pBarrierBatch->statistics.elidedBarrierCount += 2u;
+        }
+        else
+        {
+            pPendingBarrier->Transition.StateAfter = newState;
+            pBarrierBatch->statistics.elidedBarrierCount += 1u;
+        }
+
+        pResource->currentState = newState;
+        return;
+    }
+
+    D3D12_RESOURCE_BARRIER* pBarrier = allocatePendingResourceBarrier(pBarrierBatch);
+    pBarrier->Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    pBarrier->Transition.pResource = pResource->pResource;
+    pBarrier->Transition.StateBefore = pResource->currentState;
+    pBarrier->Transition.StateAfter = newState;
+    pBarrier->Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    
+    pResource->currentState = newState;
+}
+
+void transitionResource(resource_barrier_batch_t* pBarrierBatch, d3d12_resource_t* pResource, D3D12_RESOURCE_STATES currentState, D3D12_RESOURCE_STATES newState)
+{
+    ASSERT_DEBUG(pResource->currentState != currentState);
+    transitionResource(pBarrierBatch, pResource, newState);
+}
+
+void resetRenderPassStateCache(render_pass_state_cache_t* pStateCache)
+{
+    //FK: All bits set never matches a valid state, so the first call after a reset always goes through
+    memset(pStateCache, 0xFF, sizeof(render_pass_state_cache_t));
+    pStateCache->statistics = {};
+}
+
+template<typename T>
+bool hasCachedStateChanged(render_pass_state_cache_t* pStateCache, T* pCachedState, const T& newState)
+{
+    if(memcmp(pCachedState, &newState, sizeof(T)) == 0)
+    {
+        ++pStateCache->statistics.skippedCallCount;
+        return false;
+    }
+
+    *pCachedState = newState;
+    ++pStateCache->statistics.issuedCallCount;
+    return true;
 }
 
 void flushFrame(graphics_frame_t* pGraphicsFrame)
@@ -802,14 +1869,40 @@ void flushFrame(graphics_frame_t* pGraphicsFrame)
     ASSERT_DEBUG(waitResult == WAIT_OBJECT_0);
 }
 
+//FK: Only call once the GPU is done with the frame that used the constants
+void resetConstantBufferAllocator(constant_buffer_allocator_t* pAllocator)
+{
+    const uint32_t usedSizeInBytes = (uint32_t)pAllocator->usedSizeInBytes;
+    if(usedSizeInBytes > pAllocator->highWaterMarkInBytes)
+    {
+        pAllocator->highWaterMarkInBytes = usedSizeInBytes;
+    }
+
+    pAllocator->usedSizeInBytes         = 0;
+    pAllocator->failedAllocationCount   = 0;
+}
+
 void resetFrame(graphics_frame_t* pGraphicsFrame)
 {
     COM_CALL(pGraphicsFrame->pFrameGeneralGraphicsCommandAllocator->Reset());
     COM_CALL(pGraphicsFrame->pFrameGeneralGraphicsQueue->Reset(pGraphicsFrame->pFrameGeneralGraphicsCommandAllocator, nullptr));
+    initResourceBarrierBatch(&pGraphicsFrame->generalGraphicsBarrierBatch, pGraphicsFrame->pFrameGeneralGraphicsQueue);
+    pGraphicsFrame->barrierStatistics = {};
+    pGraphicsFrame->submitStatistics = {};
+    pGraphicsFrame->stateFilterStatistics = {};
+    pGraphicsFrame->pipelineStateReadinessStatistics = {};
+    COM_CALL(pGraphicsFrame->pFrameGeneralCopyCommandAllocator->Reset());
+    COM_CALL(pGraphicsFrame->pFrameGeneralCopyQueue->Reset(pGraphicsFrame->pFrameGeneralCopyCommandAllocator, nullptr));
+    pGraphicsFrame->pendingCopyCount = 0u;
+    resetConstantBufferAllocator(&pGraphicsFrame->constantBufferAllocator);
 
     markRenderPassChainAsFree(pGraphicsFrame->pRenderResourceCache, pGraphicsFrame->pFirstRenderPassToExecute);
     pGraphicsFrame->pFirstRenderPassToExecute = nullptr;
     pGraphicsFrame->pLastRenderPassToExecute = nullptr;
+    pGraphicsFrame->pLastSubmittedRenderPass = nullptr;
+    pGraphicsFrame->renderPassToSubmitCount = 0u;
+    pGraphicsFrame->nextSortIndexToSubmit = 0u;
+    pGraphicsFrame->nextRenderPassSortIndex = 0;
 }
 
 graphics_frame_t* getGraphicsFrameFromGraphicsFrameCollection(graphics_frame_collection_t* pGraphicsFrameCollection, const uint64_t frameIndex)
@@ -829,31 +1922,6 @@ void flushAllFrames(render_context_t* pRenderContext)
     }
 }
 
-void transitionResource(ID3D12GraphicsCommandList* pGraphicsCommandList, d3d12_resource_t* pResource, D3D12_RESOURCE_STATES newState)
-{
-    if(pResource->currentState == newState)
-    {
-        return;
-    }
-    
-    D3D12_RESOURCE_BARRIER barrier = {};
-    barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-    barrier.Transition.pResource = pResource->pResource;
-    barrier.Transition.StateBefore = pResource->currentState;
-    barrier.Transition.StateAfter = newState;
-    barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-    
-    pGraphicsCommandList->ResourceBarrier(1u, &barrier);
-    pResource->currentState = newState;
-}
-
-void transitionResource(ID3D12GraphicsCommandList* pGraphicsCommandList, d3d12_resource_t* pResource, D3D12_RESOURCE_STATES currentState, D3D12_RESOURCE_STATES newState)
-{
-    ASSERT_DEBUG(pResource->currentState != currentState);
-    transitionResource(pGraphicsCommandList, pResource, newState);
-}
-
 bool createD3D12Device(D3D12DeviceType** pOutDevice)
 {
     if(COM_CALL(D3D12CreateDevice(nullptr, D3D_FEATURE_LEVEL_12_0, IID_PPV_ARGS(pOutDevice))) != S_OK)
@@ -935,20 +2003,22 @@ void destroyDescriptorHeap(d3d12_descriptor_heap_t* pDescriptorHeap)
     clearMemoryWithZeroes(pDescriptorHeap);
 }
 
-bool createDescriptorHeap(d3d12_descriptor_heap_t* pOutDescriptorHeap, D3D12DeviceType* pDevice, D3D12_DESCRIPTOR_HEAP_TYPE type, const uint32_t descriptorCount )
+bool createDescriptorHeap(d3d12_descriptor_heap_t* pOutDescriptorHeap, D3D12DeviceType* pDevice, D3D12_DESCRIPTOR_HEAP_TYPE type, const uint32_t descriptorCount, const D3D12_DESCRIPTOR_HEAP_FLAGS flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE)
 {
     ID3D12DescriptorHeap* pDescriptorHeap = nullptr;
     D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc = {};
     descriptorHeapDesc.Type             = type;
     descriptorHeapDesc.NumDescriptors   = descriptorCount;
-    descriptorHeapDesc.Flags            = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+    descriptorHeapDesc.Flags            = flags;
     if(COM_CALL(pDevice->CreateDescriptorHeap(&descriptorHeapDesc, IID_PPV_ARGS(&pDescriptorHeap))) != S_OK)
     {
         return false;
     }
 
+    //FK: Only shader visible descriptor heaps have GPU handles
+    const bool isShaderVisible = (flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE) != 0;
     const uint64_t cpuDescriptorHeapStartAddress = pDescriptorHeap->GetCPUDescriptorHandleForHeapStart().ptr;
-    const uint64_t gpuDescriptorHeapStartAddress = pDescriptorHeap->GetGPUDescriptorHandleForHeapStart().ptr;
+    const uint64_t gpuDescriptorHeapStartAddress = isShaderVisible ? pDescriptorHeap->GetGPUDescriptorHandleForHeapStart().ptr : 0u;
     const uint64_t incrementSizeInBytes = pDevice->GetDescriptorHandleIncrementSize(type);
 
     pOutDescriptorHeap->incrementSizeInBytes = incrementSizeInBytes;
@@ -962,378 +2032,680 @@ bool createDescriptorHeap(d3d12_descriptor_heap_t* pOutDescriptorHeap, D3D12Devi
     return true;
 }
 
-void destroySwapChain(d3d12_swap_chain_t* pSwapChain)
+descriptor_allocation_t createDescriptorAllocation(const d3d12_descriptor_heap_t* pDescriptorHeap, const uint32_t heapIndex, const uint32_t count)
 {
-    COM_RELEASE(pSwapChain->pSwapChain);
-    for(uint32_t bufferIndex = 0u; bufferIndex < pSwapChain->backBufferCount; ++bufferIndex)
+    descriptor_allocation_t allocation = {};
+    allocation.cpuHandle.ptr    = (SIZE_T)(pDescriptorHeap->pCPUBaseAddress + heapIndex * pDescriptorHeap->incrementSizeInBytes);
+    allocation.gpuHandle.ptr    = pDescriptorHeap->pGPUBaseAddress != nullptr ? (UINT64)(pDescriptorHeap->pGPUBaseAddress + heapIndex * pDescriptorHeap->incrementSizeInBytes) : 0u;
+    allocation.heapIndex        = heapIndex;
+    allocation.count            = count;
+    return allocation;
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE getDescriptorAllocationCPUHandle(const descriptor_allocation_t* pAllocation, const uint32_t descriptorIndex, const d3d12_descriptor_heap_t* pDescriptorHeap)
+{
+    ASSERT_DEBUG(descriptorIndex < pAllocation->count);
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = pAllocation->cpuHandle;
+    cpuHandle.ptr += descriptorIndex * pDescriptorHeap->incrementSizeInBytes;
+    return cpuHandle;
+}
+
+void updateDescriptorAllocatorStatistics(descriptor_allocator_statistics_t* pStatistics, const uint32_t usedDescriptorCount)
+{
+    pStatistics->usedDescriptorCount = usedDescriptorCount;
+    if(usedDescriptorCount > pStatistics->highWaterMarkDescriptorCount)
     {
-        destroyRenderTarget(&pSwapChain->pBackBuffers[bufferIndex]);
+        pStatistics->highWaterMarkDescriptorCount = usedDescriptorCount;
     }
+}
 
-    freeFromAllocator(pSwapChain->pMemoryAllocator, pSwapChain->pBackBuffers);
-    destroyDescriptorHeap(&pSwapChain->backBufferRenderTargetDescriptorHeap);
+void destroyPersistentDescriptorAllocator(persistent_descriptor_allocator_t* pAllocator)
+{
+    if(pAllocator->pNextFreeBlockIndices != nullptr)
+    {
+        freeFromAllocator(pAllocator->pMemoryAllocator, pAllocator->pNextFreeBlockIndices);
+    }
+
+    destroyDescriptorHeap(&pAllocator->descriptorHeap);
+    clearMemoryWithZeroes(pAllocator);
 }
 
-bool createSwapChain(d3d12_swap_chain_t* pOutSwapChain, memory_allocator_t* pMemoryAllocator, IDXGIFactory6* pFactory, D3D12DeviceType* pDevice, ID3D12CommandQueue* pCommandQueue, HWND pWindowHandle, const uint32_t windowWidth, const uint32_t windowHeight, const uint32_t frameBufferCount)
+bool createPersistentDescriptorAllocator(persistent_descriptor_allocator_t* pOutAllocator, memory_allocator_t* pMemoryAllocator, D3D12DeviceType* pDevice, const D3D12_DESCRIPTOR_HEAP_TYPE type, const uint32_t descriptorCount, const D3D12_DESCRIPTOR_HEAP_FLAGS flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE)
 {
-    DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {};
-    swapChainDesc.BufferCount   = frameBufferCount;
-    swapChainDesc.SampleDesc    = {1, 0};
-    swapChainDesc.Stereo        = FALSE;
-    swapChainDesc.BufferUsage   = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-    swapChainDesc.SwapEffect    = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
-    swapChainDesc.Format        = DXGI_FORMAT_R8G8B8A8_UNORM;
-    swapChainDesc.Height        = windowHeight;
-    swapChainDesc.Width         = windowWidth;
-    swapChainDesc.Scaling       = DXGI_SCALING_NONE;
-    swapChainDesc.AlphaMode     = DXGI_ALPHA_MODE_UNSPECIFIED;
-    swapChainDesc.Flags         = DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
-    
-    d3d12_swap_chain_t swapChain = {};
-    swapChain.backBufferCount = frameBufferCount;
-    swapChain.pMemoryAllocator = pMemoryAllocator;
+    ASSERT_DEBUG(descriptorCount > 0u);
 
-    com_auto_release_t<IDXGISwapChain1> pTempSwapChain = nullptr;
-    
-    if(!createDescriptorHeap(&swapChain.backBufferRenderTargetDescriptorHeap, pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, frameBufferCount))
+    persistent_descriptor_allocator_t allocator = {};
+    allocator.pMemoryAllocator      = pMemoryAllocator;
+    allocator.pNextFreeBlockIndices = (uint32_t*)allocateFromAllocator(pMemoryAllocator, sizeof(uint32_t) * descriptorCount);
+    if(allocator.pNextFreeBlockIndices == nullptr)
     {
-        goto cleanup_and_exit_failure;
+        return false;
     }
 
-    if(COM_CALL(pFactory->CreateSwapChainForHwnd(pCommandQueue, pWindowHandle, &swapChainDesc, nullptr, nullptr, &pTempSwapChain)) != S_OK)
+    if(!createDescriptorHeap(&allocator.descriptorHeap, pDevice, type, descriptorCount, flags))
     {
-        goto cleanup_and_exit_failure;
+        destroyPersistentDescriptorAllocator(&allocator);
+        return false;
     }
 
-    if(COM_CALL(pTempSwapChain->QueryInterface(IID_PPV_ARGS(&swapChain.pSwapChain))) != S_OK)
+    for(uint32_t sizeClass = 0u; sizeClass < descriptorBlockSizeClassCount; ++sizeClass)
     {
-        goto cleanup_and_exit_failure;
+        allocator.firstFreeBlockIndices[sizeClass] = invalidDescriptorIndex;
     }
 
-    swapChain.pBackBuffers = (render_target_t*)allocateFromAllocator(pMemoryAllocator, sizeof(render_target_t) * frameBufferCount);
-    if(swapChain.pBackBuffers == nullptr)
+    allocator.descriptorCapacity = descriptorCount;
+    InitializeSRWLock(&allocator.lock);
+    *pOutAllocator = allocator;
+    return true;
+}
+
+uint32_t getDescriptorBlockSizeClass(const uint32_t descriptorCount)
+{
+    uint32_t sizeClass = 0u;
+    while((1u << sizeClass) < descriptorCount)
     {
-        goto cleanup_and_exit_failure;
+        ++sizeClass;
     }
 
-    for(uint32_t bufferIndex = 0u; bufferIndex < frameBufferCount; ++bufferIndex)
+    return sizeClass;
+}
+
+bool allocatePersistentDescriptors(persistent_descriptor_allocator_t* pAllocator, const uint32_t descriptorCount, descriptor_allocation_t* pOutAllocation)
+{
+    ASSERT_DEBUG(descriptorCount > 0u);
+
+    const uint32_t sizeClass = getDescriptorBlockSizeClass(descriptorCount);
+    if(sizeClass >= descriptorBlockSizeClassCount)
     {
-        ID3D12Resource* pFrameBuffer = nullptr;
-        if(COM_CALL(swapChain.pSwapChain->GetBuffer(bufferIndex, IID_PPV_ARGS(&pFrameBuffer))) != S_OK)
-        {
-            goto cleanup_and_exit_failure;
-        }
-
-        setD3D12ObjectDebugName(pFrameBuffer, "Frame Buffer");
-        D3D12_CPU_DESCRIPTOR_HANDLE descriptorHandle = getNextCPUDescriptorHandle(&swapChain.backBufferRenderTargetDescriptorHeap);
-        pDevice->CreateRenderTargetView(pFrameBuffer, nullptr, descriptorHandle);
-
-        initializeRenderTarget(&swapChain.pBackBuffers[bufferIndex], pFrameBuffer, &descriptorHandle, D3D12_RESOURCE_STATE_PRESENT);
+        logError("Can't allocate %u persistent descriptors at once, the largest block has %u descriptors.", descriptorCount, 1u << (descriptorBlockSizeClassCount - 1u));
+        ++pAllocator->statistics.failedAllocationCount;
+        return false;
     }
-    
-    swapChain.width = windowWidth;
-    swapChain.height = windowHeight;
 
-    *pOutSwapChain = swapChain;
-    return true;
+    const uint32_t blockSize = 1u << sizeClass;
+    AcquireSRWLockExclusive(&pAllocator->lock);
+    uint32_t heapIndex = pAllocator->firstFreeBlockIndices[sizeClass];
+    if(heapIndex != invalidDescriptorIndex)
+    {
+        pAllocator->firstFreeBlockIndices[sizeClass] = pAllocator->pNextFreeBlockIndices[heapIndex];
+    }
+    else if(pAllocator->untouchedDescriptorIndex + blockSize <= pAllocator->descriptorCapacity)
+    {
+        heapIndex = pAllocator->untouchedDescriptorIndex;
+        pAllocator->untouchedDescriptorIndex += blockSize;
+    }
 
-    cleanup_and_exit_failure:
-        destroySwapChain(&swapChain);
-        return false;
-}
+    const bool allocated = heapIndex != invalidDescriptorIndex;
+    if(allocated)
+    {
+        ++pAllocator->statistics.allocationCount;
+        updateDescriptorAllocatorStatistics(&pAllocator->statistics, pAllocator->statistics.usedDescriptorCount + blockSize);
+    }
+    else
+    {
+        ++pAllocator->statistics.failedAllocationCount;
+    }
+    ReleaseSRWLockExclusive(&pAllocator->lock);
 
-bool createCommandAllocator(D3D12DeviceType* pDevice, D3D12_COMMAND_LIST_TYPE type, ID3D12CommandAllocator** pOutCommandAllocator)
-{
-    if(COM_CALL(pDevice->CreateCommandAllocator(type, IID_PPV_ARGS(pOutCommandAllocator))) != S_OK)
+    if(!allocated)
     {
+        logError("Persistent descriptor heap exhausted (%u/%u descriptors in use, %u requested). Increase 'maxPersistentDescriptorCount'.", pAllocator->statistics.usedDescriptorCount, pAllocator->descriptorCapacity, descriptorCount);
         return false;
     }
 
+    *pOutAllocation = createDescriptorAllocation(&pAllocator->descriptorHeap, heapIndex, descriptorCount);
     return true;
 }
 
-bool createCommandList(D3D12DeviceType* pDevice, D3D12_COMMAND_LIST_TYPE type, ID3D12CommandAllocator* pCommandAllocator, ID3D12GraphicsCommandList** pOutCommandList)
+void freePersistentDescriptors(persistent_descriptor_allocator_t* pAllocator, const descriptor_allocation_t* pAllocation)
 {
-    if(COM_CALL(pDevice->CreateCommandList(0, type, pCommandAllocator, nullptr, IID_PPV_ARGS(pOutCommandList))) != S_OK)
-    {
-        return false;
-    }
+    ASSERT_DEBUG(pAllocation->heapIndex + pAllocation->count <= pAllocator->untouchedDescriptorIndex);
 
-    (*pOutCommandList)->Close();
+    const uint32_t sizeClass = getDescriptorBlockSizeClass(pAllocation->count);
+    AcquireSRWLockExclusive(&pAllocator->lock);
+    pAllocator->pNextFreeBlockIndices[pAllocation->heapIndex] = pAllocator->firstFreeBlockIndices[sizeClass];
+    pAllocator->firstFreeBlockIndices[sizeClass] = pAllocation->heapIndex;
+    pAllocator->statistics.usedDescriptorCount -= 1u << sizeClass;
+    ReleaseSRWLockExclusive(&pAllocator->lock);
+}
 
-    return true;
+void createTransientDescriptorAllocator(transient_descriptor_allocator_t* pOutAllocator, const d3d12_descriptor_heap_t* pDescriptorHeap, const uint32_t firstDescriptorIndex, const uint32_t descriptorCount)
+{
+    ASSERT_DEBUG(pDescriptorHeap->pGPUBaseAddress != nullptr);
+    ASSERT_DEBUG(descriptorCount > 0u);
+
+    clearMemoryWithZeroes(pOutAllocator);
+    pOutAllocator->pDescriptorHeap      = pDescriptorHeap;
+    pOutAllocator->firstDescriptorIndex = firstDescriptorIndex;
+    createRingBufferAllocator(&pOutAllocator->ringBuffer, descriptorCount);
+    InitializeSRWLock(&pOutAllocator->lock);
 }
 
-bool createFence(D3D12DeviceType* pDevice, ID3D12Fence** pOutFence, const uint32_t initialValue)
+//FK: The descriptors are contiguous, so they can be used as a descriptor table
+bool allocateTransientDescriptors(transient_descriptor_allocator_t* pAllocator, const uint32_t descriptorCount, descriptor_allocation_t* pOutAllocation)
 {
-    if(COM_CALL(pDevice->CreateFence(initialValue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(pOutFence))) != S_OK)
+    ASSERT_DEBUG(descriptorCount > 0u);
+
+    AcquireSRWLockExclusive(&pAllocator->lock);
+    buffer_slice_t slice = {};
+    const bool allocated = allocateFromRingBuffer(&pAllocator->ringBuffer, descriptorCount, 1u, &slice);
+    if(allocated)
+    {
+        ++pAllocator->statistics.allocationCount;
+        updateDescriptorAllocatorStatistics(&pAllocator->statistics, (uint32_t)getRingBufferUsedSizeInBytes(&pAllocator->ringBuffer));
+    }
+    else
+    {
+        ++pAllocator->statistics.failedAllocationCount;
+    }
+    ReleaseSRWLockExclusive(&pAllocator->lock);
+
+    if(!allocated)
     {
+        logError("Transient descriptor heap exhausted (%u/%u descriptors in flight, %u requested). Increase 'maxTransientDescriptorCount'.", pAllocator->statistics.usedDescriptorCount, (uint32_t)pAllocator->ringBuffer.sizeInBytes, descriptorCount);
         return false;
     }
 
+    *pOutAllocation = createDescriptorAllocation(pAllocator->pDescriptorHeap, pAllocator->firstDescriptorIndex + (uint32_t)slice.startByteIndex, descriptorCount);
     return true;
 }
 
-void destroyGraphicsFrame(graphics_frame_t* pGraphicsFrame)
+void closeTransientDescriptorFrame(transient_descriptor_allocator_t* pAllocator, const uint64_t frameFenceValue)
 {
-    flushFrame(pGraphicsFrame);
-    if(pGraphicsFrame->pFrameFinishedEvent != nullptr)
+    AcquireSRWLockExclusive(&pAllocator->lock);
+    closeRingBufferFrame(&pAllocator->ringBuffer, frameFenceValue);
+    ReleaseSRWLockExclusive(&pAllocator->lock);
+}
+
+void reclaimTransientDescriptors(transient_descriptor_allocator_t* pAllocator, const uint64_t completedFrameFenceValue)
+{
+    AcquireSRWLockExclusive(&pAllocator->lock);
+    reclaimRingBuffer(&pAllocator->ringBuffer, completedFrameFenceValue);
+    pAllocator->statistics.usedDescriptorCount = (uint32_t)getRingBufferUsedSizeInBytes(&pAllocator->ringBuffer);
+    ReleaseSRWLockExclusive(&pAllocator->lock);
+}
+
+void destroyBindlessDescriptorTable(bindless_descriptor_table_t* pTable)
+{
+    if(pTable->pFreeDescriptorIndices != nullptr)
     {
-        CloseHandle(pGraphicsFrame->pFrameFinishedEvent);
+        freeFromAllocator(pTable->pMemoryAllocator, pTable->pFreeDescriptorIndices);
     }
 
-#if 0
-    for(uint32_t renderPassIndex = 0u; renderPassIndex < pGraphicsFrame->renderPassCount; ++renderPassIndex)
+    if(pTable->pRetiredDescriptors != nullptr)
     {
-        COM_RELEASE(pGraphicsFrame->pRenderPassBuffer[renderPassIndex].pGraphicsCommandList);
-        COM_RELEASE(pGraphicsFrame->pRenderPassBuffer[renderPassIndex].pGraphicsCommandAllocator);
+        freeFromAllocator(pTable->pMemoryAllocator, pTable->pRetiredDescriptors);
     }
 
-    freeFromAllocator(pGraphicsFrame->pMemoryAllocator, pGraphicsFrame->pRenderPassBuffer);
-#endif
-
-    COM_RELEASE(pGraphicsFrame->pFrameGeneralGraphicsCommandAllocator);
-    COM_RELEASE(pGraphicsFrame->pFrameGeneralGraphicsQueue);
-    COM_RELEASE(pGraphicsFrame->pFrameCommandQueue);
-    COM_RELEASE(pGraphicsFrame->pFrameFence);   
+    clearMemoryWithZeroes(pTable);
 }
 
-void destroyGraphicsFrameCollection(graphics_frame_collection_t* pGraphicsFrameCollection)
+bool createBindlessDescriptorTable(bindless_descriptor_table_t* pOutTable, memory_allocator_t* pMemoryAllocator, const d3d12_descriptor_heap_t* pDescriptorHeap, const uint32_t descriptorCount)
 {
-    for(uint32_t frameIndex = 0u; frameIndex < pGraphicsFrameCollection->frameCount; ++frameIndex)
+    ASSERT_DEBUG(pDescriptorHeap->pGPUBaseAddress != nullptr);
+    ASSERT_DEBUG(descriptorCount > 0u);
+
+    bindless_descriptor_table_t table = {};
+    table.pDescriptorHeap           = pDescriptorHeap;
+    table.pMemoryAllocator          = pMemoryAllocator;
+    table.descriptorCapacity        = descriptorCount;
+    table.pFreeDescriptorIndices    = (uint32_t*)allocateFromAllocator(pMemoryAllocator, sizeof(uint32_t) * descriptorCount);
+    table.pRetiredDescriptors       = (retired_bindless_descriptor_t*)allocateFromAllocator(pMemoryAllocator, sizeof(retired_bindless_descriptor_t) * descriptorCount);
+    if(table.pFreeDescriptorIndices == nullptr || table.pRetiredDescriptors == nullptr)
     {
-        graphics_frame_t* pGraphicsFrame = &pGraphicsFrameCollection->pGraphicsFrames[frameIndex];
-        destroyGraphicsFrame(pGraphicsFrame);
+        destroyBindlessDescriptorTable(&table);
+        return false;
     }
 
-    freeFromAllocator(pGraphicsFrameCollection->pMemoryAllocator, pGraphicsFrameCollection->pGraphicsFrames);
+    InitializeSRWLock(&table.lock);
+    *pOutTable = table;
+    return true;
 }
 
-bool isValidGraphicsFrameParameters(const graphics_frame_parameters_t* pGraphicsFrameParameters)
+D3D12_CPU_DESCRIPTOR_HANDLE getBindlessDescriptorCPUHandle(const bindless_descriptor_table_t* pTable, const uint32_t descriptorIndex)
 {
-    if(pGraphicsFrameParameters->maxRenderPassCount == 0u)
+    ASSERT_DEBUG(descriptorIndex < pTable->untouchedDescriptorIndex);
+
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = {};
+    cpuHandle.ptr = (SIZE_T)(pTable->pDescriptorHeap->pCPUBaseAddress + descriptorIndex * pTable->pDescriptorHeap->incrementSizeInBytes);
+    return cpuHandle;
+}
+
+uint32_t allocateBindlessDescriptor(bindless_descriptor_table_t* pTable)
+{
+    AcquireSRWLockExclusive(&pTable->lock);
+    uint32_t descriptorIndex = invalidDescriptorIndex;
+    if(pTable->freeDescriptorCount > 0u)
     {
-        return false;
+        descriptorIndex = pTable->pFreeDescriptorIndices[--pTable->freeDescriptorCount];
+    }
+    else if(pTable->untouchedDescriptorIndex < pTable->descriptorCapacity)
+    {
+        descriptorIndex = pTable->untouchedDescriptorIndex++;
     }
 
-    if(pGraphicsFrameParameters->maxUploadBufferCount == 0u)
+    if(descriptorIndex != invalidDescriptorIndex)
     {
-        return false;
+        ++pTable->statistics.allocationCount;
+        updateDescriptorAllocatorStatistics(&pTable->statistics, pTable->statistics.usedDescriptorCount + 1u);
+    }
+    else
+    {
+        ++pTable->statistics.failedAllocationCount;
     }
+    ReleaseSRWLockExclusive(&pTable->lock);
 
-    if(pGraphicsFrameParameters->maxVertexBufferCount == 0u)
+    if(descriptorIndex == invalidDescriptorIndex)
     {
-        return false;
+        logError("Bindless descriptor table exhausted (%u descriptors in use, %u of them waiting for frames in flight). Increase 'maxBindlessDescriptorCount'.", pTable->statistics.usedDescriptorCount, pTable->retiredDescriptorCount);
     }
 
-    return true;
+    return descriptorIndex;
 }
 
-bool createGraphicsFrame(graphics_frame_t* pOutGraphicFrame, const graphics_frame_parameters_t* pGraphicsFrameParameters, memory_allocator_t* pMemoryAllocator, render_resource_cache_t* pRenderResourceCache, shader_compiler_context_t* pShaderCompilerContext, D3D12DeviceType* pDevice)
+//FK: The descriptor index can be reused once the frame fence reached 'frameFenceValue'
+void releaseBindlessDescriptor(bindless_descriptor_table_t* pTable, const uint32_t descriptorIndex, const uint64_t frameFenceValue)
 {
-    ASSERT_DEBUG(pGraphicsFrameParameters != nullptr);
-    ASSERT_DEBUG(pMemoryAllocator != nullptr);
-    ASSERT_DEBUG(pDevice != nullptr);
-    ASSERT_DEBUG(isValidGraphicsFrameParameters(pGraphicsFrameParameters));
+    ASSERT_DEBUG(descriptorIndex < pTable->untouchedDescriptorIndex);
 
-    graphics_frame_t graphicsFrame = {0};
-    graphicsFrame.pMemoryAllocator = pMemoryAllocator;
-    graphicsFrame.pFrameFinishedEvent = CreateEvent(nullptr, FALSE, TRUE, "");
-    graphicsFrame.pShaderCompilerContext = pShaderCompilerContext;
-    graphicsFrame.pRenderResourceCache = pRenderResourceCache;
-    if(graphicsFrame.pFrameFinishedEvent == nullptr)
+    AcquireSRWLockExclusive(&pTable->lock);
+    ASSERT_DEBUG(pTable->retiredDescriptorCount < pTable->descriptorCapacity);
+    const uint32_t retiredIndex = (pTable->firstRetiredDescriptorIndex + pTable->retiredDescriptorCount) % pTable->descriptorCapacity;
+    pTable->pRetiredDescriptors[retiredIndex].fenceValue        = frameFenceValue;
+    pTable->pRetiredDescriptors[retiredIndex].descriptorIndex   = descriptorIndex;
+    ++pTable->retiredDescriptorCount;
+    ReleaseSRWLockExclusive(&pTable->lock);
+}
+
+void reclaimBindlessDescriptors(bindless_descriptor_table_t* pTable, const uint64_t completedFrameFenceValue)
+{
+    AcquireSRWLockExclusive(&pTable->lock);
+    while(pTable->retiredDescriptorCount > 0u)
     {
-        return false;
-    }
+        const retired_bindless_descriptor_t* pRetiredDescriptor = &pTable->pRetiredDescriptors[pTable->firstRetiredDescriptorIndex];
+        if(pRetiredDescriptor->fenceValue > completedFrameFenceValue)
+        {
+            break;
+        }
 
-    createDefaultMemoryAllocator(&graphicsFrame.tempMemoryAllocator);
+        pTable->pFreeDescriptorIndices[pTable->freeDescriptorCount++] = pRetiredDescriptor->descriptorIndex;
+        pTable->firstRetiredDescriptorIndex = (pTable->firstRetiredDescriptorIndex + 1u) % pTable->descriptorCapacity;
+        --pTable->retiredDescriptorCount;
+        --pTable->statistics.usedDescriptorCount;
+    }
+    ReleaseSRWLockExclusive(&pTable->lock);
+}
 
-    render_pass_t* pRenderPasses = (render_pass_t*)allocateFromAllocator(pMemoryAllocator, (sizeof(render_pass_t) * pGraphicsFrameParameters->maxRenderPassCount), alloc_flag_clear_memory);
-    if(pRenderPasses == nullptr)
+void destroySwapChain(d3d12_swap_chain_t* pSwapChain)
+{
+    COM_RELEASE(pSwapChain->pSwapChain);
+    for(uint32_t bufferIndex = 0u; bufferIndex < pSwapChain->backBufferCount; ++bufferIndex)
     {
-        goto cleanup_and_exit_failure;
+        destroyRenderTarget(&pSwapChain->pBackBuffers[bufferIndex]);
     }
 
-    vertex_buffer_t* pVertexBuffers = (vertex_buffer_t*)allocateFromAllocator(pMemoryAllocator, sizeof(vertex_buffer_t) * pGraphicsFrameParameters->maxVertexBufferCount, alloc_flag_clear_memory);
-    if(pVertexBuffers == nullptr)
+    freeFromAllocator(pSwapChain->pMemoryAllocator, pSwapChain->pBackBuffers);
+    destroyDescriptorHeap(&pSwapChain->backBufferRenderTargetDescriptorHeap);
+}
+
+bool createSwapChain(d3d12_swap_chain_t* pOutSwapChain, memory_allocator_t* pMemoryAllocator, IDXGIFactory6* pFactory, D3D12DeviceType* pDevice, ID3D12CommandQueue* pCommandQueue, HWND pWindowHandle, const uint32_t windowWidth, const uint32_t windowHeight, const uint32_t frameBufferCount)
+{
+    DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {};
+    swapChainDesc.BufferCount   = frameBufferCount;
+    swapChainDesc.SampleDesc    = {1, 0};
+    swapChainDesc.Stereo        = FALSE;
+    swapChainDesc.BufferUsage   = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+    swapChainDesc.SwapEffect    = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
+    swapChainDesc.Format        = DXGI_FORMAT_R8G8B8A8_UNORM;
+    swapChainDesc.Height        = windowHeight;
+    swapChainDesc.Width         = windowWidth;
+    swapChainDesc.Scaling       = DXGI_SCALING_NONE;
+    swapChainDesc.AlphaMode     = DXGI_ALPHA_MODE_UNSPECIFIED;
+    swapChainDesc.Flags         = DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+    
+    d3d12_swap_chain_t swapChain = {};
+    swapChain.backBufferCount = frameBufferCount;
+    swapChain.pMemoryAllocator = pMemoryAllocator;
+
+    com_auto_release_t<IDXGISwapChain1> pTempSwapChain = nullptr;
+    
+    if(!createDescriptorHeap(&swapChain.backBufferRenderTargetDescriptorHeap, pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, frameBufferCount))
     {
         goto cleanup_and_exit_failure;
     }
 
-    upload_buffer_t* pUploadBuffers = (upload_buffer_t*)allocateFromAllocator(pMemoryAllocator, sizeof(upload_buffer_t) * pGraphicsFrameParameters->maxUploadBufferCount, alloc_flag_clear_memory);
-    if(pUploadBuffers == nullptr)
+    if(COM_CALL(pFactory->CreateSwapChainForHwnd(pCommandQueue, pWindowHandle, &swapChainDesc, nullptr, nullptr, &pTempSwapChain)) != S_OK)
     {
         goto cleanup_and_exit_failure;
     }
 
-    if(!createCommandAllocator(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT, &graphicsFrame.pFrameGeneralGraphicsCommandAllocator))
+    if(COM_CALL(pTempSwapChain->QueryInterface(IID_PPV_ARGS(&swapChain.pSwapChain))) != S_OK)
     {
         goto cleanup_and_exit_failure;
     }
 
-    if(!createCommandList(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT, graphicsFrame.pFrameGeneralGraphicsCommandAllocator, &graphicsFrame.pFrameGeneralGraphicsQueue))
+    swapChain.pBackBuffers = (render_target_t*)allocateFromAllocator(pMemoryAllocator, sizeof(render_target_t) * frameBufferCount);
+    if(swapChain.pBackBuffers == nullptr)
     {
         goto cleanup_and_exit_failure;
     }
 
-    for(uint32_t renderPassIndex = 0u; renderPassIndex < pGraphicsFrameParameters->maxRenderPassCount; ++renderPassIndex)
+    for(uint32_t bufferIndex = 0u; bufferIndex < frameBufferCount; ++bufferIndex)
     {
-        if(!createCommandAllocator(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT, &pRenderPasses[renderPassIndex].pGraphicsCommandAllocator))
-        {
-            goto cleanup_and_exit_failure;
-        }
-
-        if(!createCommandList(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT, pRenderPasses[renderPassIndex].pGraphicsCommandAllocator, &pRenderPasses[renderPassIndex].pGraphicsCommandList))
+        ID3D12Resource* pFrameBuffer = nullptr;
+        if(COM_CALL(swapChain.pSwapChain->GetBuffer(bufferIndex, IID_PPV_ARGS(&pFrameBuffer))) != S_OK)
         {
             goto cleanup_and_exit_failure;
         }
-    }
 
-    graphicsFrame.pDevice = pDevice;
+        setD3D12ObjectDebugName(pFrameBuffer, "Frame Buffer");
+        D3D12_CPU_DESCRIPTOR_HANDLE descriptorHandle = getNextCPUDescriptorHandle(&swapChain.backBufferRenderTargetDescriptorHeap);
+        pDevice->CreateRenderTargetView(pFrameBuffer, nullptr, descriptorHandle);
 
-    if(!createFence(pDevice, &graphicsFrame.pFrameFence, 0))
-    {
-        goto cleanup_and_exit_failure;
+        initializeRenderTarget(&swapChain.pBackBuffers[bufferIndex], pFrameBuffer, &descriptorHandle, D3D12_RESOURCE_STATE_PRESENT);
     }
+    
+    swapChain.width = windowWidth;
+    swapChain.height = windowHeight;
 
-    *pOutGraphicFrame = graphicsFrame;
+    *pOutSwapChain = swapChain;
     return true;
 
     cleanup_and_exit_failure:
-        destroyGraphicsFrame(&graphicsFrame);
+        destroySwapChain(&swapChain);
         return false;
 }
 
-bool createGraphicsFrameCollection(graphics_frame_collection_t* pOutGraphicFrameCollection, const graphics_frame_parameters_t* pGraphicsFrameParameters, memory_allocator_t* pMemoryAllocator, render_resource_cache_t* pRenderResourceCache, shader_compiler_context_t* pShaderCompilerContext, D3D12DeviceType* pDevice, const uint8_t frameCount)
+bool createCommandAllocator(D3D12DeviceType* pDevice, D3D12_COMMAND_LIST_TYPE type, ID3D12CommandAllocator** pOutCommandAllocator)
 {
-    graphics_frame_collection_t graphicFrameCollection = {};
-    graphicFrameCollection.pMemoryAllocator = pMemoryAllocator;
-    graphicFrameCollection.frameCount       = frameCount;
-    graphicFrameCollection.pGraphicsFrames  = (graphics_frame_t*)allocateFromAllocator(pMemoryAllocator, sizeof(graphics_frame_t) * frameCount);
-    if(graphicFrameCollection.pGraphicsFrames == nullptr)
+    if(COM_CALL(pDevice->CreateCommandAllocator(type, IID_PPV_ARGS(pOutCommandAllocator))) != S_OK)
     {
-        goto cleanup_and_exit_failure;
+        return false;
     }
 
-    for(uint32_t frameIndex = 0u; frameIndex < frameCount; ++frameIndex)
+    return true;
+}
+
+bool createCommandList(D3D12DeviceType* pDevice, D3D12_COMMAND_LIST_TYPE type, ID3D12CommandAllocator* pCommandAllocator, ID3D12GraphicsCommandList** pOutCommandList)
+{
+    if(COM_CALL(pDevice->CreateCommandList(0, type, pCommandAllocator, nullptr, IID_PPV_ARGS(pOutCommandList))) != S_OK)
     {
-        if(!createGraphicsFrame(&graphicFrameCollection.pGraphicsFrames[frameIndex], pGraphicsFrameParameters, pMemoryAllocator, pRenderResourceCache, pShaderCompilerContext, pDevice))
-        {
-            goto cleanup_and_exit_failure;
-        }
+        return false;
     }
 
-    *pOutGraphicFrameCollection = graphicFrameCollection;
-    return true;
-
-    cleanup_and_exit_failure:
-        destroyGraphicsFrameCollection(pOutGraphicFrameCollection);
-        freeFromAllocator(pMemoryAllocator, graphicFrameCollection.pGraphicsFrames);
+    (*pOutCommandList)->Close();
 
-        return false;
+    return true;
 }
 
-graphics_frame_t* getCurrentFrame(render_context_t* pRenderContext)
+bool createFence(D3D12DeviceType* pDevice, ID3D12Fence** pOutFence, const uint32_t initialValue)
 {
-    const uint64_t frameIndex = pRenderContext->frameIndex % pRenderContext->graphicsFramesCollection.frameCount;
-    return getGraphicsFrameFromGraphicsFrameCollection(&pRenderContext->graphicsFramesCollection, frameIndex);
+    if(COM_CALL(pDevice->CreateFence(initialValue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(pOutFence))) != S_OK)
+    {
+        return false;
+    }
+
+    return true;
 }
 
-enum render_context_flags_t : uint8_t
+void destroyUploadRingBuffer(upload_ring_buffer_t* pUploadRingBuffer)
 {
-    use_debug_layer = 0x01,
-    notify_on_limit_reach = 0x02
-};
+    if(pUploadRingBuffer->bufferResource.pResource != nullptr)
+    {
+        pUploadRingBuffer->bufferResource.pResource->Unmap(0, nullptr);
+    }
 
-struct render_context_parameters_t
+    COM_RELEASE(pUploadRingBuffer->bufferResource.pResource);
+    clearMemoryWithZeroes(pUploadRingBuffer);
+}
+
+bool createMappedUploadBuffer(d3d12_resource_t* pOutBufferResource, uint8_t** ppOutMappedData, D3D12DeviceType* pDevice, const uint64_t sizeInBytes, const char* pName)
 {
-    memory_allocator_t*                 pAllocator;
-    HWND                                pWindowHandle;
-    uint32_t                            windowWidth;
-    uint32_t                            windowHeight;
-    uint32_t                            frameBufferCount;
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension          = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Alignment          = 0u;
+    desc.Height             = 1u;
+    desc.DepthOrArraySize   = 1u;
+    desc.MipLevels          = 1u;
+    desc.SampleDesc.Count   = 1u;
+    desc.SampleDesc.Quality = 0u;
+    desc.Layout             = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    desc.Width              = sizeInBytes;
     
-    flags8_t<render_context_flags_t>    flags;
+    D3D12_HEAP_PROPERTIES heapProperties = {};
+    heapProperties.Type                 = D3D12_HEAP_TYPE_UPLOAD;
+    heapProperties.CPUPageProperty      = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+    heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
 
-    struct limits_t
+    d3d12_resource_t bufferResource = {};
+    if(COM_CALL(pDevice->CreateCommittedResource1(&heapProperties, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, nullptr, IID_PPV_ARGS(&bufferResource.pResource))) != S_OK)
     {
-        uint32_t                        maxVertexBufferCount;
-        uint32_t                        maxUploadBufferCount;
-        uint32_t                        maxVertexFormatCount;
-        uint32_t                        maxShaderBinaryCount;
-        uint32_t                        maxRenderPassCount;
-        uint32_t                        maxRenderTargetCount;
-        uint32_t                        maxPipelineStateCount;
-        uint32_t                        defaultStagingBufferSizeInBytes;
-    } limits;
-};
+        return false;
+    }
 
-struct ComCustomMalloc : IMalloc
+    setD3D12ObjectDebugName(bufferResource.pResource, pName);
+
+    //FK: Upload heaps can stay mapped for their whole lifetime, the CPU never reads from it so pass an empty read range
+    D3D12_RANGE readRange = {};
+    if(COM_CALL(bufferResource.pResource->Map(0, &readRange, (void**)ppOutMappedData)) != S_OK)
+    {
+        COM_RELEASE(bufferResource.pResource);
+        return false;
+    }
+
+    bufferResource.currentState = D3D12_RESOURCE_STATE_GENERIC_READ;
+    *pOutBufferResource = bufferResource;
+    return true;
+}
+
+bool createUploadRingBuffer(upload_ring_buffer_t* pOutUploadRingBuffer, D3D12DeviceType* pDevice, const uint64_t sizeInBytes)
 {
-    ComCustomMalloc(memory_allocator_t* pAllocator) : m_pAllocator(pAllocator) {};
-    virtual void* Alloc(SIZE_T sizeInBytes)
+    ASSERT_DEBUG(pOutUploadRingBuffer != nullptr);
+    ASSERT_DEBUG(pDevice != nullptr);
+    ASSERT_DEBUG(sizeInBytes > 0u);
+
+    upload_ring_buffer_t uploadRingBuffer = {};
+    if(!createMappedUploadBuffer(&uploadRingBuffer.bufferResource, &uploadRingBuffer.pMappedData, pDevice, sizeInBytes, "Upload Ring Buffer"))
     {
-        return allocateFromAllocator(m_pAllocator, sizeInBytes);
+        return false;
     }
 
-    virtual void Free(void* pMemory)
+    createRingBufferAllocator(&uploadRingBuffer.allocator, sizeInBytes);
+
+    *pOutUploadRingBuffer = uploadRingBuffer;
+    return true;
+}
+
+void destroyConstantBufferAllocator(constant_buffer_allocator_t* pAllocator)
+{
+    if(pAllocator->bufferResource.pResource != nullptr)
     {
-        freeFromAllocator(m_pAllocator, pMemory);
+        pAllocator->bufferResource.pResource->Unmap(0, nullptr);
     }
 
-    virtual int DidAlloc(void* pMemory)
+    COM_RELEASE(pAllocator->bufferResource.pResource);
+    clearMemoryWithZeroes(pAllocator);
+}
+
+bool createConstantBufferAllocator(constant_buffer_allocator_t* pOutAllocator, D3D12DeviceType* pDevice, const uint32_t sizeInBytes)
+{
+    ASSERT_DEBUG(pOutAllocator != nullptr);
+    ASSERT_DEBUG(sizeInBytes > 0u && sizeInBytes <= 0x7FFFFFFFu);
+
+    constant_buffer_allocator_t allocator = {};
+    allocator.sizeInBytes = (uint32_t)alignValue(sizeInBytes, constantBufferAlignmentInBytes);
+    if(!createMappedUploadBuffer(&allocator.bufferResource, &allocator.pMappedData, pDevice, allocator.sizeInBytes, "Frame Constant Buffer"))
     {
-        return pMemory != nullptr;
+        return false;
     }
 
-    virtual void* Realloc(void* pMemory, SIZE_T newSizeInBytes)
+    allocator.gpuBaseAddress = allocator.bufferResource.pResource->GetGPUVirtualAddress();
+    *pOutAllocator = allocator;
+    return true;
+}
+
+//FK: Lock free, sizes get rounded up to the constant buffer alignment so that every allocation starts aligned
+constant_allocation_t allocateFromConstantBuffer(constant_buffer_allocator_t* pAllocator, const uint32_t sizeInBytes)
+{
+    ASSERT_DEBUG(sizeInBytes > 0u);
+
+    constant_allocation_t allocation = {};
+    const uint64_t alignedSizeInBytes = alignValue(sizeInBytes, constantBufferAlignmentInBytes);
+    if(alignedSizeInBytes > pAllocator->sizeInBytes)
     {
-        ASSERT_DEBUG_UNREACHABLE_CODE();
-        return nullptr;
+        InterlockedIncrement(&pAllocator->failedAllocationCount);
+        return allocation;
     }
 
-    virtual SIZE_T GetSize(void* pMemory)
+    //FK: Only bump the offset if the allocation fits. Adding first and rolling back on overflow would let concurrent
+    //    allocations that fit fail while the used size is temporarily past the end of the buffer.
+    LONG64 offsetInBytes = pAllocator->usedSizeInBytes;
+    while(true)
     {
-        ASSERT_DEBUG_UNREACHABLE_CODE();
-        return 0u;
+        if((uint64_t)offsetInBytes + alignedSizeInBytes > pAllocator->sizeInBytes)
+        {
+            InterlockedIncrement(&pAllocator->failedAllocationCount);
+            return allocation;
+        }
+
+        const LONG64 previousOffsetInBytes = InterlockedCompareExchange64(&pAllocator->usedSizeInBytes, offsetInBytes + (LONG64)alignedSizeInBytes, offsetInBytes);
+        if(previousOffsetInBytes == offsetInBytes)
+        {
+            break;
+        }
+
+        offsetInBytes = previousOffsetInBytes;
     }
 
-    virtual void HeapMinimize()
+    allocation.pData                = pAllocator->pMappedData + offsetInBytes;
+    allocation.gpuVirtualAddress    = pAllocator->gpuBaseAddress + offsetInBytes;
+    allocation.sizeInBytes          = (uint32_t)alignedSizeInBytes;
+    return allocation;
+}
+
+uint64_t getNextUploadFenceValue(const upload_queue_t* pUploadQueue)
+{
+    return pUploadQueue->lastSubmittedFenceValue + 1u;
+}
+
+void waitForUploadBatch(upload_queue_t* pUploadQueue, const uint64_t fenceValue)
+{
+    if(pUploadQueue->pCopyFence == nullptr || pUploadQueue->pCopyFence->GetCompletedValue() >= fenceValue)
     {
+        return;
+    }
 
+    COM_CALL(pUploadQueue->pCopyFence->SetEventOnCompletion(fenceValue, pUploadQueue->pCopyFinishedEvent));
+    const DWORD waitResult = WaitForSingleObject(pUploadQueue->pCopyFinishedEvent, INFINITE);
+    ASSERT_DEBUG(waitResult == WAIT_OBJECT_0);
+}
+
+void destroyUploadQueue(upload_queue_t* pUploadQueue)
+{
+    waitForUploadBatch(pUploadQueue, pUploadQueue->lastSubmittedFenceValue);
+
+    if(pUploadQueue->pCopyFinishedEvent != nullptr)
+    {
+        CloseHandle(pUploadQueue->pCopyFinishedEvent);
     }
 
-    memory_allocator_t* m_pAllocator;
-};
+    //FK: Copy queue is owned by the render context
+    COM_RELEASE(pUploadQueue->pCopyFence);
+    clearMemoryWithZeroes(pUploadQueue);
+}
 
-bool isValidRenderContextParameters(const render_context_parameters_t* pParameters)
+bool createUploadQueue(upload_queue_t* pOutUploadQueue, D3D12DeviceType* pDevice, ID3D12CommandQueue* pCopyCommandQueue)
 {
-    if(pParameters->frameBufferCount < 2u)
+    ASSERT_DEBUG(pOutUploadQueue != nullptr);
+    ASSERT_DEBUG(pDevice != nullptr);
+    ASSERT_DEBUG(pCopyCommandQueue != nullptr);
+
+    upload_queue_t uploadQueue = {};
+    uploadQueue.pCopyCommandQueue = pCopyCommandQueue;
+    uploadQueue.pCopyFinishedEvent = CreateEvent(nullptr, FALSE, FALSE, "");
+    if(uploadQueue.pCopyFinishedEvent == nullptr)
     {
         return false;
     }
 
-    if(pParameters->pWindowHandle == nullptr || pParameters->pWindowHandle == INVALID_HANDLE_VALUE)
+    if(!createFence(pDevice, &uploadQueue.pCopyFence, 0))
     {
+        CloseHandle(uploadQueue.pCopyFinishedEvent);
         return false;
     }
 
-    if(pParameters->windowHeight <= 0)
+    setD3D12ObjectDebugName(uploadQueue.pCopyFence, "Upload Queue Fence");
+
+    *pOutUploadQueue = uploadQueue;
+    return true;
+}
+
+void destroyGraphicsFrame(graphics_frame_t* pGraphicsFrame)
+{
+    flushFrame(pGraphicsFrame);
+    if(pGraphicsFrame->pUploadQueue != nullptr)
+    {
+        waitForUploadBatch(pGraphicsFrame->pUploadQueue, pGraphicsFrame->uploadFenceValue);
+    }
+
+    if(pGraphicsFrame->pFrameFinishedEvent != nullptr)
+    {
+        CloseHandle(pGraphicsFrame->pFrameFinishedEvent);
+    }
+
+#if 0
+    for(uint32_t renderPassIndex = 0u; renderPassIndex < pGraphicsFrame->renderPassCount; ++renderPassIndex)
+    {
+        COM_RELEASE(pGraphicsFrame->pRenderPassBuffer[renderPassIndex].pGraphicsCommandList);
+        COM_RELEASE(pGraphicsFrame->pRenderPassBuffer[renderPassIndex].pGraphicsCommandAllocator);
+    }
+
+    freeFromAllocator(pGraphicsFrame->pMemoryAllocator, pGraphicsFrame->pRenderPassBuffer);
+#endif
+
+    COM_RELEASE(pGraphicsFrame->pFrameGeneralGraphicsCommandAllocator);
+    COM_RELEASE(pGraphicsFrame->pFrameGeneralGraphicsQueue);
+    COM_RELEASE(pGraphicsFrame->pFrameGeneralCopyCommandAllocator);
+    COM_RELEASE(pGraphicsFrame->pFrameGeneralCopyQueue);
+    COM_RELEASE(pGraphicsFrame->pFrameCommandQueue);
+    COM_RELEASE(pGraphicsFrame->pFrameFence);   
+    destroyConstantBufferAllocator(&pGraphicsFrame->constantBufferAllocator);
+
+    if(pGraphicsFrame->tempMemoryAllocator.pFirstChunk != nullptr)
+    {
+        destroyLinearMemoryAllocator(&pGraphicsFrame->tempMemoryAllocator);
+    }
+}
+
+void destroyGraphicsFrameCollection(graphics_frame_collection_t* pGraphicsFrameCollection)
+{
+    for(uint32_t frameIndex = 0u; frameIndex < pGraphicsFrameCollection->frameCount; ++frameIndex)
+    {
+        graphics_frame_t* pGraphicsFrame = &pGraphicsFrameCollection->pGraphicsFrames[frameIndex];
+        destroyGraphicsFrame(pGraphicsFrame);
+    }
+
+    freeFromAllocator(pGraphicsFrameCollection->pMemoryAllocator, pGraphicsFrameCollection->pGraphicsFrames);
+}
+
+bool isValidGraphicsFrameParameters(const graphics_frame_parameters_t* pGraphicsFrameParameters)
+{
+    if(pGraphicsFrameParameters->maxRenderPassCount == 0u)
     {
         return false;
     }
 
-    if(pParameters->windowWidth <= 0)
+    if(pGraphicsFrameParameters->maxVertexBufferCount == 0u)
     {
         return false;
     }
 
-    if(pParameters->limits.maxUploadBufferCount == 0)
+    if(pGraphicsFrameParameters->tempMemorySizeInBytes == 0u)
     {
         return false;
     }
 
-    if(pParameters->limits.maxVertexBufferCount == 0)
+    if(pGraphicsFrameParameters->constantBufferSizeInBytes == 0u || pGraphicsFrameParameters->constantBufferSizeInBytes > 0x7FFFFFFFu)
     {
         return false;
     }
@@ -1341,932 +2713,7000 @@ bool isValidRenderContextParameters(const render_context_parameters_t* pParamete
     return true;
 }
 
-bool createShaderCompilerContext(memory_allocator_t* pAllocator, shader_compiler_context_t* pShaderCompilerContext)
+bool createGraphicsFrame(graphics_frame_t* pOutGraphicFrame, const graphics_frame_parameters_t* pGraphicsFrameParameters, memory_allocator_t* pMemoryAllocator, render_resource_cache_t* pRenderResourceCache, shader_compiler_context_t* pShaderCompilerContext, upload_ring_buffer_t* pUploadRingBuffer, upload_queue_t* pUploadQueue, transient_descriptor_allocator_t* pTransientDescriptorAllocator, bindless_descriptor_table_t* pBindlessDescriptorTable, persistent_descriptor_allocator_t* pSamplerDescriptorAllocator, ID3D12CommandQueue* pCommandQueue, D3D12DeviceType* pDevice)
 {
-    UNUSED_PARAMETER(pAllocator);
-    if(COM_CALL(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&pShaderCompilerContext->pShaderCompiler))) != S_OK)
+    ASSERT_DEBUG(pGraphicsFrameParameters != nullptr);
+    ASSERT_DEBUG(pMemoryAllocator != nullptr);
+    ASSERT_DEBUG(pDevice != nullptr);
+    ASSERT_DEBUG(isValidGraphicsFrameParameters(pGraphicsFrameParameters));
+
+    graphics_frame_t graphicsFrame = {0};
+    graphicsFrame.pMemoryAllocator = pMemoryAllocator;
+    graphicsFrame.pFrameFinishedEvent = CreateEvent(nullptr, FALSE, TRUE, "");
+    graphicsFrame.pShaderCompilerContext = pShaderCompilerContext;
+    graphicsFrame.pRenderResourceCache = pRenderResourceCache;
+    graphicsFrame.pUploadRingBuffer = pUploadRingBuffer;
+    graphicsFrame.pUploadQueue = pUploadQueue;
+    graphicsFrame.pTransientDescriptorAllocator = pTransientDescriptorAllocator;
+    graphicsFrame.pBindlessDescriptorTable = pBindlessDescriptorTable;
+    graphicsFrame.pSamplerDescriptorAllocator = pSamplerDescriptorAllocator;
+    InitializeSRWLock(&graphicsFrame.renderPassSubmitLock);
+    graphicsFrame.renderPassSubmitThreshold = pGraphicsFrameParameters->renderPassSubmitThreshold;
+
+    //FK: Released in destroyGraphicsFrame()
+    graphicsFrame.pFrameCommandQueue = pCommandQueue;
+    graphicsFrame.pFrameCommandQueue->AddRef();
+    if(graphicsFrame.pFrameFinishedEvent == nullptr)
+    {
+        return false;
+    }
+
+    render_pass_t* pRenderPasses = nullptr;
+    vertex_buffer_t* pVertexBuffers = nullptr;
+
+    if(!createLinearMemoryAllocator(&graphicsFrame.tempMemoryAllocator, pMemoryAllocator, pGraphicsFrameParameters->tempMemorySizeInBytes))
+    {
+        goto cleanup_and_exit_failure;
+    }
+
+    pRenderPasses = (render_pass_t*)allocateFromAllocator(pMemoryAllocator, (sizeof(render_pass_t) * pGraphicsFrameParameters->maxRenderPassCount), alloc_flag_clear_memory);
+    if(pRenderPasses == nullptr)
+    {
+        goto cleanup_and_exit_failure;
+    }
+
+    pVertexBuffers = (vertex_buffer_t*)allocateFromAllocator(pMemoryAllocator, sizeof(vertex_buffer_t) * pGraphicsFrameParameters->maxVertexBufferCount, alloc_flag_clear_memory);
+    if(pVertexBuffers == nullptr)
+    {
+        goto cleanup_and_exit_failure;
+    }
+
+    if(!createCommandAllocator(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT, &graphicsFrame.pFrameGeneralGraphicsCommandAllocator))
+    {
+        goto cleanup_and_exit_failure;
+    }
+
+    if(!createCommandList(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT, graphicsFrame.pFrameGeneralGraphicsCommandAllocator, &graphicsFrame.pFrameGeneralGraphicsQueue))
+    {
+        goto cleanup_and_exit_failure;
+    }
+
+    if(!createCommandAllocator(pDevice, D3D12_COMMAND_LIST_TYPE_COPY, &graphicsFrame.pFrameGeneralCopyCommandAllocator))
+    {
+        goto cleanup_and_exit_failure;
+    }
+
+    if(!createCommandList(pDevice, D3D12_COMMAND_LIST_TYPE_COPY, graphicsFrame.pFrameGeneralCopyCommandAllocator, &graphicsFrame.pFrameGeneralCopyQueue))
+    {
+        goto cleanup_and_exit_failure;
+    }
+
+    for(uint32_t renderPassIndex = 0u; renderPassIndex < pGraphicsFrameParameters->maxRenderPassCount; ++renderPassIndex)
+    {
+        if(!createCommandAllocator(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT, &pRenderPasses[renderPassIndex].pGraphicsCommandAllocator))
+        {
+            goto cleanup_and_exit_failure;
+        }
+
+        if(!createCommandList(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT, pRenderPasses[renderPassIndex].pGraphicsCommandAllocator, &pRenderPasses[renderPassIndex].pGraphicsCommandList))
+        {
+            goto cleanup_and_exit_failure;
+        }
+    }
+
+    graphicsFrame.pDevice = pDevice;
+
+    if(!createFence(pDevice, &graphicsFrame.pFrameFence, 0))
+    {
+        goto cleanup_and_exit_failure;
+    }
+
+    if(!createConstantBufferAllocator(&graphicsFrame.constantBufferAllocator, pDevice, pGraphicsFrameParameters->constantBufferSizeInBytes))
+    {
+        goto cleanup_and_exit_failure;
+    }
+
+    *pOutGraphicFrame = graphicsFrame;
+    return true;
+
+    cleanup_and_exit_failure:
+        destroyGraphicsFrame(&graphicsFrame);
+        return false;
+}
+
+bool createGraphicsFrameCollection(graphics_frame_collection_t* pOutGraphicFrameCollection, const graphics_frame_parameters_t* pGraphicsFrameParameters, memory_allocator_t* pMemoryAllocator, render_resource_cache_t* pRenderResourceCache, shader_compiler_context_t* pShaderCompilerContext, upload_ring_buffer_t* pUploadRingBuffer, upload_queue_t* pUploadQueue, transient_descriptor_allocator_t* pTransientDescriptorAllocator, bindless_descriptor_table_t* pBindlessDescriptorTable, persistent_descriptor_allocator_t* pSamplerDescriptorAllocator, ID3D12CommandQueue* pCommandQueue, D3D12DeviceType* pDevice, const uint8_t frameCount)
+{
+    graphics_frame_collection_t graphicFrameCollection = {};
+    graphicFrameCollection.pMemoryAllocator = pMemoryAllocator;
+    graphicFrameCollection.frameCount       = frameCount;
+    graphicFrameCollection.pGraphicsFrames  = (graphics_frame_t*)allocateFromAllocator(pMemoryAllocator, sizeof(graphics_frame_t) * frameCount);
+    if(graphicFrameCollection.pGraphicsFrames == nullptr)
+    {
+        goto cleanup_and_exit_failure;
+    }
+
+    for(uint32_t frameIndex = 0u; frameIndex < frameCount; ++frameIndex)
     {
+        if(!createGraphicsFrame(&graphicFrameCollection.pGraphicsFrames[frameIndex], pGraphicsFrameParameters, pMemoryAllocator, pRenderResourceCache, pShaderCompilerContext, pUploadRingBuffer, pUploadQueue, pTransientDescriptorAllocator, pBindlessDescriptorTable, pSamplerDescriptorAllocator, pCommandQueue, pDevice))
+        {
+            goto cleanup_and_exit_failure;
+        }
+    }
+
+    *pOutGraphicFrameCollection = graphicFrameCollection;
+    return true;
+
+    cleanup_and_exit_failure:
+        destroyGraphicsFrameCollection(pOutGraphicFrameCollection);
+        freeFromAllocator(pMemoryAllocator, graphicFrameCollection.pGraphicsFrames);
+
         return false;
+}
+
+graphics_frame_t* getCurrentFrame(render_context_t* pRenderContext)
+{
+    const uint64_t frameIndex = pRenderContext->frameIndex % pRenderContext->graphicsFramesCollection.frameCount;
+    return getGraphicsFrameFromGraphicsFrameCollection(&pRenderContext->graphicsFramesCollection, frameIndex);
+}
+
+enum render_context_flags_t : uint8_t
+{
+    use_debug_layer = 0x01,
+    notify_on_limit_reach = 0x02
+};
+
+struct render_context_parameters_t
+{
+    memory_allocator_t*                 pAllocator;
+    HWND                                pWindowHandle;
+    uint32_t                            windowWidth;
+    uint32_t                            windowHeight;
+    uint32_t                            frameBufferCount;
+    uint32_t                            renderPassSubmitThreshold;  // submit early once this many render passes with consecutive sort indices are executed, 0 = submit everything in finishFrame()
+    const char*                         pShaderCacheDirectory;      // compiled shaders get cached in this directory, nullptr = no shader cache. Has to outlive the render context
+    const char*                         pPipelineLibraryFilePath;   // compiled pipeline states get stored in this file, nullptr = no pipeline library. Has to outlive the render context
+    
+    flags8_t<render_context_flags_t>    flags;
+
+    struct limits_t
+    {
+        uint32_t                        maxVertexBufferCount;
+        uint32_t                        maxVertexFormatCount;
+        uint32_t                        maxShaderBinaryCount;
+        uint32_t                        maxRenderPassCount;
+        uint32_t                        maxRenderTargetCount;
+        uint32_t                        maxPipelineStateCount;
+        uint32_t                        maxRootSignatureCount;
+        uint32_t                        maxPersistentDescriptorCount;
+        uint32_t                        maxBindlessDescriptorCount;
+        uint32_t                        maxTransientDescriptorCount;     // shared by all frames in flight
+        uint32_t                        maxSamplerDescriptorCount;       // up to maxShaderVisibleSamplerDescriptorCount
+        uint32_t                        defaultStagingBufferSizeInBytes;
+        uint32_t                        frameTempMemorySizeInBytes;
+        uint32_t                        frameConstantBufferSizeInBytes;  // per frame in flight
+    } limits;
+};
+
+struct ComCustomMalloc : IMalloc
+{
+    ComCustomMalloc(memory_allocator_t* pAllocator) : m_pAllocator(pAllocator) {};
+    virtual void* Alloc(SIZE_T sizeInBytes)
+    {
+        return allocateFromAllocator(m_pAllocator, sizeInBytes);
+    }
+
+    virtual void Free(void* pMemory)
+    {
+        freeFromAllocator(m_pAllocator, pMemory);
+    }
+
+    virtual int DidAlloc(void* pMemory)
+    {
+        return pMemory != nullptr;
+    }
+
+    virtual void* Realloc(void* pMemory, SIZE_T newSizeInBytes)
+    {
+        ASSERT_DEBUG_UNREACHABLE_CODE();
+        return nullptr;
+    }
+
+    virtual SIZE_T GetSize(void* pMemory)
+    {
+        ASSERT_DEBUG_UNREACHABLE_CODE();
+        return 0u;
+    }
+
+    virtual void HeapMinimize()
+    {
+
+    }
+
+    memory_allocator_t* m_pAllocator;
+};
+
+bool isValidRenderContextParameters(const render_context_parameters_t* pParameters)
+{
+    if(pParameters->frameBufferCount < 2u)
+    {
+        return false;
+    }
+
+#if !USE_NULL_DEVICE
+    if(pParameters->pWindowHandle == nullptr || pParameters->pWindowHandle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+#endif
+
+    if(pParameters->windowHeight <= 0)
+    {
+        return false;
+    }
+
+    if(pParameters->windowWidth <= 0)
+    {
+        return false;
+    }
+
+    if(pParameters->limits.defaultStagingBufferSizeInBytes == 0)
+    {
+        return false;
+    }
+
+    if(pParameters->limits.maxVertexBufferCount == 0)
+    {
+        return false;
+    }
+
+    if(pParameters->limits.maxSamplerDescriptorCount == 0 || pParameters->limits.maxSamplerDescriptorCount > maxShaderVisibleSamplerDescriptorCount)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+//FK: The utils are needed to turn the reflection output of the compiler into an ID3D12ShaderReflection
+bool createShaderCompiler(IDxcCompiler3** ppOutShaderCompiler, IDxcUtils** ppOutShaderUtils, IDxcIncludeHandler** ppOutIncludeHandler)
+{
+    if(COM_CALL(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(ppOutShaderCompiler))) != S_OK)
+    {
+        return false;
+    }
+
+    if(COM_CALL(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(ppOutShaderUtils))) != S_OK)
+    {
+        COM_RELEASE(*ppOutShaderCompiler);
+        return false;
+    }
+
+    if(COM_CALL((*ppOutShaderUtils)->CreateDefaultIncludeHandler(ppOutIncludeHandler)) != S_OK)
+    {
+        COM_RELEASE(*ppOutShaderUtils);
+        COM_RELEASE(*ppOutShaderCompiler);
+        return false;
+    }
+
+    return true;
+}
+
+bool createShaderCompilerContext(memory_allocator_t* pAllocator, shader_compiler_context_t* pShaderCompilerContext, const char* pShaderCacheDirectory)
+{
+    if(!createShaderCompiler(&pShaderCompilerContext->pShaderCompiler, &pShaderCompilerContext->pShaderUtils, &pShaderCompilerContext->pIncludeHandler))
+    {
+        return false;
+    }
+
+    pShaderCompilerContext->pAllocator = pAllocator;
+    pShaderCompilerContext->pWorkers = nullptr;
+    pShaderCompilerContext->workerCount = 0u;
+
+    pShaderCompilerContext->cacheStatistics = {};
+    pShaderCompilerContext->pShaderCacheDirectory = nullptr;
+    if(pShaderCacheDirectory != nullptr)
+    {
+        //FK: Cached shaders are only valid for the compiler build that produced them, without version there's no way to tell.
+        //    dxc builds from different commits share the same major/minor version, so the commit is required as well.
+        IDxcVersionInfo2* pVersionInfo = nullptr;
+        uint32_t majorVersion = 0u;
+        uint32_t minorVersion = 0u;
+        uint32_t versionFlags = 0u;
+        uint32_t commitCount = 0u;
+        char* pCommitHash = nullptr;
+        if(pShaderCompilerContext->pShaderCompiler->QueryInterface(IID_PPV_ARGS(&pVersionInfo)) == S_OK &&
+           COM_CALL(pVersionInfo->GetVersion(&majorVersion, &minorVersion)) == S_OK &&
+           COM_CALL(pVersionInfo->GetFlags(&versionFlags)) == S_OK &&
+           COM_CALL(pVersionInfo->GetCommitInfo(&commitCount, &pCommitHash)) == S_OK)
+        {
+            uint64_t compilerVersionHash = calculateHash(&majorVersion, sizeof(majorVersion));
+            compilerVersionHash = calculateHash(&minorVersion, sizeof(minorVersion), compilerVersionHash);
+            compilerVersionHash = calculateHash(&versionFlags, sizeof(versionFlags), compilerVersionHash);
+            compilerVersionHash = calculateHash(&commitCount, sizeof(commitCount), compilerVersionHash);
+            compilerVersionHash = calculateStringHash(pCommitHash, compilerVersionHash);
+
+            CreateDirectoryA(pShaderCacheDirectory, nullptr);
+            pShaderCompilerContext->pShaderCacheDirectory = pShaderCacheDirectory;
+            pShaderCompilerContext->compilerVersionHash = compilerVersionHash;
+        }
+        else
+        {
+            logWarning("Could not query the shader compiler version and commit, shader cache '%s' is disabled.", pShaderCacheDirectory);
+        }
+
+        if(pCommitHash != nullptr)
+        {
+            CoTaskMemFree(pCommitHash);
+        }
+
+        COM_RELEASE(pVersionInfo);
+    }
+
+    return true;
+}
+
+void destroyShaderCompilerWorker(shader_compiler_worker_t* pWorker)
+{
+    destroyLinearMemoryAllocator(&pWorker->tempMemoryAllocator);
+    COM_RELEASE(pWorker->pIncludeHandler);
+    COM_RELEASE(pWorker->pShaderUtils);
+    COM_RELEASE(pWorker->pShaderCompiler);
+}
+
+bool createShaderCompilerWorkers(shader_compiler_context_t* pShaderCompilerContext)
+{
+    SYSTEM_INFO systemInfo = {};
+    GetSystemInfo(&systemInfo);
+    const uint32_t workerCount = systemInfo.dwNumberOfProcessors > 0u ? systemInfo.dwNumberOfProcessors : 1u;
+
+    shader_compiler_worker_t* pWorkers = (shader_compiler_worker_t*)allocateFromAllocator(pShaderCompilerContext->pAllocator, sizeof(shader_compiler_worker_t) * workerCount, alloc_flag_clear_memory);
+    if(pWorkers == nullptr)
+    {
+        return false;
+    }
+
+    for(uint32_t workerIndex = 0u; workerIndex < workerCount; ++workerIndex)
+    {
+        shader_compiler_worker_t* pWorker = pWorkers + workerIndex;
+        if(!createShaderCompiler(&pWorker->pShaderCompiler, &pWorker->pShaderUtils, &pWorker->pIncludeHandler) ||
+           !createLinearMemoryAllocator(&pWorker->tempMemoryAllocator, pShaderCompilerContext->pAllocator, 1024u * 1024u))
+        {
+            for(uint32_t createdWorkerIndex = 0u; createdWorkerIndex <= workerIndex; ++createdWorkerIndex)
+            {
+                destroyShaderCompilerWorker(pWorkers + createdWorkerIndex);
+            }
+
+            freeFromAllocator(pShaderCompilerContext->pAllocator, pWorkers);
+            return false;
+        }
+
+        pWorker->pTempAllocator = &pWorker->tempMemoryAllocator;
+    }
+
+    pShaderCompilerContext->pWorkers = pWorkers;
+    pShaderCompilerContext->workerCount = workerCount;
+    return true;
+}
+
+void destroyShaderCompilerContext(shader_compiler_context_t* pShaderCompilerContext)
+{
+    for(uint32_t workerIndex = 0u; workerIndex < pShaderCompilerContext->workerCount; ++workerIndex)
+    {
+        destroyShaderCompilerWorker(pShaderCompilerContext->pWorkers + workerIndex);
+    }
+
+    if(pShaderCompilerContext->pWorkers != nullptr)
+    {
+        freeFromAllocator(pShaderCompilerContext->pAllocator, pShaderCompilerContext->pWorkers);
+    }
+
+    COM_RELEASE(pShaderCompilerContext->pIncludeHandler);
+    COM_RELEASE(pShaderCompilerContext->pShaderUtils);
+    COM_RELEASE(pShaderCompilerContext->pShaderCompiler);
+    clearMemoryWithZeroes(pShaderCompilerContext);
+}
+
+template<typename T>
+void createDynamicArrayWithPreallocatedMemory(base_dynamic_array_t* pOutArray, memory_allocator_t* pMemoryAllocator, void* pPreallocatedMemory, const uint32_t elementCapacity)
+{
+    pOutArray->pMemoryAllocator     = pMemoryAllocator;
+    pOutArray->pData                = (T*)pPreallocatedMemory;
+    pOutArray->count                = 0u;
+    pOutArray->capacity             = elementCapacity;
+    pOutArray->elementSizeInBytes   = sizeof(T);
+}
+
+void createResourceTableWithPreallocatedMemory(base_resource_table_t* pOutTable, memory_allocator_t* pMemoryAllocator, void* pPreallocatedData, resource_table_slot_t* pPreallocatedSlots, const uint32_t elementSizeInBytes, const uint32_t elementCapacity)
+{
+    pOutTable->pMemoryAllocator     = pMemoryAllocator;
+    pOutTable->pData                = pPreallocatedData;
+    pOutTable->pSlots               = pPreallocatedSlots;
+    pOutTable->count                = 0u;
+    pOutTable->capacity             = elementCapacity;
+    pOutTable->aliveCount           = 0u;
+    pOutTable->firstFreeSlotIndex   = invalidResourceHandleValue;
+    pOutTable->elementSizeInBytes   = elementSizeInBytes;
+    pOutTable->ownsMemory           = false;
+}
+
+uint32_t calculateNewResourceTableCapacity(const base_resource_table_t* pTable)
+{
+    return pTable->capacity * 2u;
+}
+
+bool tryToGrowResourceTable(base_resource_table_t* pTable)
+{
+    const uint32_t newCapacity = calculateNewResourceTableCapacity(pTable);
+    const uint64_t dataSizeInBytes = alignValue((uint64_t)newCapacity * pTable->elementSizeInBytes, defaultAllocationAlignment);
+    uint8_t* pNewMemory = (uint8_t*)allocateFromAllocator(pTable->pMemoryAllocator, dataSizeInBytes + newCapacity * sizeof(resource_table_slot_t), alloc_flag_clear_memory);
+    if(pNewMemory == nullptr)
+    {
+        return false;
+    }
+
+    resource_table_slot_t* pNewSlots = (resource_table_slot_t*)(pNewMemory + dataSizeInBytes);
+    copyMemoryNonOverlapping(pNewMemory, pTable->pData, (uint64_t)pTable->count * pTable->elementSizeInBytes);
+    copyMemoryNonOverlapping(pNewSlots, pTable->pSlots, pTable->count * sizeof(resource_table_slot_t));
+
+    //FK: Only the grown tables own their memory, the initial tables are slices of the render resource cache blob
+    if(pTable->ownsMemory)
+    {
+        freeFromAllocator(pTable->pMemoryAllocator, pTable->pData);
+    }
+
+    pTable->pData       = pNewMemory;
+    pTable->pSlots      = pNewSlots;
+    pTable->capacity    = newCapacity;
+    pTable->ownsMemory  = true;
+
+    return true;
+}
+
+void* allocateFromResourceTableDontGrow(base_resource_table_t* pTable, uint32_t* pOutIndex, uint32_t* pOutGeneration)
+{
+    uint32_t slotIndex = pTable->firstFreeSlotIndex;
+    if(slotIndex != invalidResourceHandleValue)
+    {
+        pTable->firstFreeSlotIndex = pTable->pSlots[slotIndex].nextFreeSlotIndex;
+    }
+    else if(pTable->count < pTable->capacity)
+    {
+        slotIndex = pTable->count++;
+        pTable->pSlots[slotIndex].generation = 0u;
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    resource_table_slot_t* pSlot = pTable->pSlots + slotIndex;
+    ++pSlot->generation;
+    pSlot->nextFreeSlotIndex = invalidResourceHandleValue;
+    ++pTable->aliveCount;
+
+    *pOutIndex      = slotIndex;
+    *pOutGeneration = pSlot->generation;
+
+    void* pElement = (uint8_t*)pTable->pData + (uint64_t)slotIndex * pTable->elementSizeInBytes;
+    memset(pElement, 0, pTable->elementSizeInBytes);
+    return pElement;
+}
+
+bool isValidResourceTableHandle(const base_resource_table_t* pTable, const uint32_t index, const uint32_t generation)
+{
+    return index < pTable->count && pTable->pSlots[index].generation == generation && (generation & 1u) == 1u;
+}
+
+void* getFromResourceTable(const base_resource_table_t* pTable, const uint32_t index, const uint32_t generation)
+{
+    if(!isValidResourceTableHandle(pTable, index, generation))
+    {
+        return nullptr;
+    }
+
+    return (uint8_t*)pTable->pData + (uint64_t)index * pTable->elementSizeInBytes;
+}
+
+bool freeFromResourceTable(base_resource_table_t* pTable, const uint32_t index, const uint32_t generation)
+{
+    if(!isValidResourceTableHandle(pTable, index, generation))
+    {
+        return false;
+    }
+
+    resource_table_slot_t* pSlot = pTable->pSlots + index;
+    ++pSlot->generation;
+    pSlot->nextFreeSlotIndex = pTable->firstFreeSlotIndex;
+    pTable->firstFreeSlotIndex = index;
+    --pTable->aliveCount;
+
+    return true;
+}
+
+void destroyResourceTable(base_resource_table_t* pTable)
+{
+    if(pTable->ownsMemory)
+    {
+        freeFromAllocator(pTable->pMemoryAllocator, pTable->pData);
+    }
+
+    clearMemoryWithZeroes(pTable);
+}
+
+//FK: Pointers returned by these are only valid until the next allocation from the same table (the table might grow)
+template<typename T, typename HANDLE_TYPE>
+T* getFromResourceTable(const resource_table_t<T, HANDLE_TYPE>* pTable, const HANDLE_TYPE handle)
+{
+    return (T*)getFromResourceTable(pTable, handle.index, handle.generation);
+}
+
+template<typename T, typename HANDLE_TYPE>
+bool freeFromResourceTable(resource_table_t<T, HANDLE_TYPE>* pTable, const HANDLE_TYPE handle)
+{
+    return freeFromResourceTable(pTable, handle.index, handle.generation);
+}
+
+render_pass_t* createRenderPassChain(render_pass_t* pRenderPasses, const uint32_t renderPassCount)
+{
+    ASSERT_DEBUG(pRenderPasses != nullptr);
+    ASSERT_DEBUG(renderPassCount > 0u);
+
+    render_pass_t* pCurrentRenderPass = pRenderPasses;
+    render_pass_t* pNextRenderPass = pRenderPasses + 1;
+    uint32_t renderPassIndex = 0u;
+    while(true)
+    {
+        if((renderPassIndex + 1) == renderPassCount)
+        {
+            pCurrentRenderPass->pNext = nullptr;
+            break;
+        }
+
+        pCurrentRenderPass->pNext = pNextRenderPass;
+        pCurrentRenderPass = pNextRenderPass;
+        pNextRenderPass = pNextRenderPass + 1;
+        ++renderPassIndex;
+    }
+
+    return pRenderPasses;
+}
+
+bool initRenderPassChain(D3D12DeviceType* pDevice, render_pass_t* pFirstRenderPassInChain)
+{
+    render_pass_t* pCurrentRenderPass = pFirstRenderPassInChain;
+    while(pCurrentRenderPass != nullptr)
+    {
+        
+        if(!createCommandAllocator(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT, &pCurrentRenderPass->pGraphicsCommandAllocator))
+        {
+            return false;
+        }
+
+        if(!createCommandList(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT, pCurrentRenderPass->pGraphicsCommandAllocator, &pCurrentRenderPass->pGraphicsCommandList))
+        {
+            return false;
+        }
+
+        pCurrentRenderPass = pCurrentRenderPass->pNext;
+    }
+
+    return true;
+}
+
+template<typename T>
+uint64_t createResourceTableFromResourceBlob(base_resource_table_t* pOutTable, memory_allocator_t* pMemoryAllocator, uint8_t* pResourceBlob, uint64_t offsetInBytes, const uint32_t elementCapacity)
+{
+    void* pData = pResourceBlob + offsetInBytes;
+    offsetInBytes += sizeof(T) * elementCapacity;
+
+    resource_table_slot_t* pSlots = (resource_table_slot_t*)(pResourceBlob + offsetInBytes);
+    offsetInBytes += sizeof(resource_table_slot_t) * elementCapacity;
+
+    createResourceTableWithPreallocatedMemory(pOutTable, pMemoryAllocator, pData, pSlots, sizeof(T), elementCapacity);
+    return offsetInBytes;
+}
+
+bool createRenderResourceCache(D3D12DeviceType* pDevice, render_resource_cache_t* pOutRenderResourceCache, memory_allocator_t* pMemoryAllocator, const render_context_parameters_t::limits_t* pLimits, const bool notifyOnLimitReach)
+{
+    uint64_t totalAllocationSizeInBytes = 0u;
+    totalAllocationSizeInBytes += (sizeof(vertex_buffer_t) + sizeof(resource_table_slot_t)) * pLimits->maxVertexBufferCount;
+    totalAllocationSizeInBytes += (sizeof(vertex_format_t) + sizeof(resource_table_slot_t)) * pLimits->maxVertexFormatCount;
+    totalAllocationSizeInBytes += (sizeof(shader_binary_t) + sizeof(resource_table_slot_t)) * pLimits->maxShaderBinaryCount;
+    totalAllocationSizeInBytes += (sizeof(render_target_t) + sizeof(resource_table_slot_t)) * pLimits->maxRenderTargetCount;
+    totalAllocationSizeInBytes += (sizeof(graphics_pipeline_state_t) + sizeof(resource_table_slot_t)) * pLimits->maxPipelineStateCount;
+    totalAllocationSizeInBytes += sizeof(render_pass_t) * pLimits->maxRenderPassCount;
+
+    //FK: Keep the load factor of the pipeline state cache at or below 50%
+    uint32_t pipelineStateCacheEntryCapacity = 16u;
+    while(pipelineStateCacheEntryCapacity < pLimits->maxPipelineStateCount * 2u)
+    {
+        pipelineStateCacheEntryCapacity *= 2u;
+    }
+
+    uint32_t vertexFormatCacheEntryCapacity = 16u;
+    while(vertexFormatCacheEntryCapacity < pLimits->maxVertexFormatCount * 2u)
+    {
+        vertexFormatCacheEntryCapacity *= 2u;
+    }
+
+    totalAllocationSizeInBytes += sizeof(pipeline_state_cache_entry_t) * pipelineStateCacheEntryCapacity;
+    totalAllocationSizeInBytes += sizeof(root_signature_cache_entry_t) * pLimits->maxRootSignatureCount;
+    totalAllocationSizeInBytes += sizeof(vertex_format_cache_entry_t) * vertexFormatCacheEntryCapacity;
+
+    uint8_t* pResourceBlob = (uint8_t*)allocateFromAllocator(pMemoryAllocator, totalAllocationSizeInBytes, alloc_flag_clear_memory);
+    if(pResourceBlob == nullptr)
+    {
+        return false;
+    }
+
+    uint64_t offsetInBytes = 0u;
+    offsetInBytes = createResourceTableFromResourceBlob<vertex_buffer_t>(&pOutRenderResourceCache->vertexBuffers, pMemoryAllocator, pResourceBlob, offsetInBytes, pLimits->maxVertexBufferCount);
+    offsetInBytes = createResourceTableFromResourceBlob<vertex_format_t>(&pOutRenderResourceCache->vertexFormats, pMemoryAllocator, pResourceBlob, offsetInBytes, pLimits->maxVertexFormatCount);
+    offsetInBytes = createResourceTableFromResourceBlob<shader_binary_t>(&pOutRenderResourceCache->shaderBinaries, pMemoryAllocator, pResourceBlob, offsetInBytes, pLimits->maxShaderBinaryCount);
+    offsetInBytes = createResourceTableFromResourceBlob<render_target_t>(&pOutRenderResourceCache->renderTargets, pMemoryAllocator, pResourceBlob, offsetInBytes, pLimits->maxRenderTargetCount);
+    offsetInBytes = createResourceTableFromResourceBlob<graphics_pipeline_state_t>(&pOutRenderResourceCache->pipelineStates, pMemoryAllocator, pResourceBlob, offsetInBytes, pLimits->maxPipelineStateCount);
+
+    createDynamicArrayWithPreallocatedMemory<render_pass_t>(&pOutRenderResourceCache->renderPasses, pMemoryAllocator, pResourceBlob + offsetInBytes, pLimits->maxRenderPassCount);
+    offsetInBytes += sizeof(render_pass_t) * pLimits->maxRenderPassCount;
+
+    pipeline_state_cache_t* pPipelineStateCache = &pOutRenderResourceCache->pipelineStateCache;
+    pPipelineStateCache->pEntries                   = (pipeline_state_cache_entry_t*)(pResourceBlob + offsetInBytes);
+    pPipelineStateCache->entryCapacity              = pipelineStateCacheEntryCapacity;
+    pPipelineStateCache->entryCount                 = 0u;
+    pPipelineStateCache->statistics                 = {};
+    pPipelineStateCache->pCompileWork               = nullptr;
+    pPipelineStateCache->pFirstCompileJob           = nullptr;
+    pPipelineStateCache->pLastCompileJob            = nullptr;
+    pPipelineStateCache->completedCompileJobCount   = 0;
+    InitializeSRWLock(&pPipelineStateCache->lock);
+    InitializeConditionVariable(&pPipelineStateCache->pipelineStateCreated);
+    offsetInBytes += sizeof(pipeline_state_cache_entry_t) * pipelineStateCacheEntryCapacity;
+
+    root_signature_cache_t* pRootSignatureCache = &pOutRenderResourceCache->rootSignatureCache;
+    pRootSignatureCache->pAllocator     = pMemoryAllocator;
+    pRootSignatureCache->pEntries       = (root_signature_cache_entry_t*)(pResourceBlob + offsetInBytes);
+    pRootSignatureCache->entryCount     = 0u;
+    pRootSignatureCache->entryCapacity  = pLimits->maxRootSignatureCount;
+    pRootSignatureCache->statistics     = {};
+    InitializeSRWLock(&pRootSignatureCache->lock);
+    offsetInBytes += sizeof(root_signature_cache_entry_t) * pLimits->maxRootSignatureCount;
+
+    vertex_format_cache_t* pVertexFormatCache = &pOutRenderResourceCache->vertexFormatCache;
+    pVertexFormatCache->pEntries        = (vertex_format_cache_entry_t*)(pResourceBlob + offsetInBytes);
+    pVertexFormatCache->entryCapacity   = vertexFormatCacheEntryCapacity;
+    pVertexFormatCache->entryCount      = 0u;
+    pVertexFormatCache->statistics      = {};
+    offsetInBytes += sizeof(vertex_format_cache_entry_t) * vertexFormatCacheEntryCapacity;
+
+    pOutRenderResourceCache->flags = 0u;
+    pOutRenderResourceCache->pMemoryAllocator = pMemoryAllocator;
+    
+    if(notifyOnLimitReach)
+    {
+        pOutRenderResourceCache->flags |= render_resource_flags_t::notify_on_array_grow;
+    }
+
+    InitializeSRWLock(&pOutRenderResourceCache->renderPassFreeListLock);
+    pOutRenderResourceCache->pFirstFreeRenderPass = createRenderPassChain((render_pass_t*)pOutRenderResourceCache->renderPasses.pData, pOutRenderResourceCache->renderPasses.capacity);
+    if(!initRenderPassChain(pDevice, pOutRenderResourceCache->pFirstFreeRenderPass))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+constexpr uint32_t pipelineLibraryFileMagic         = 0x4C50354B; // 'K5PL'
+constexpr uint32_t pipelineLibraryFormatVersion     = 1u;
+constexpr uint32_t maxPipelineLibraryPathLength     = 512u;
+
+//FK: Adapter and driver version get validated by CreatePipelineLibrary(), the header only guards against corrupt files
+struct pipeline_library_file_header_t
+{
+    uint32_t magic;
+    uint32_t formatVersion;
+    uint64_t serializedLibraryHash;
+    uint64_t serializedLibrarySizeInBytes;
+};
+
+//FK: Returns the serialized library allocated from pAllocator or nullptr if there's no valid pipeline library file
+uint8_t* loadPipelineLibraryFile(memory_allocator_t* pAllocator, pipeline_library_statistics_t* pStatistics, const char* pFilePath, uint64_t* pOutSerializedLibrarySizeInBytes)
+{
+    FILE* pFileHandle = fopen(pFilePath, "rb");
+    if(pFileHandle == nullptr)
+    {
+        return nullptr;
+    }
+
+    uint8_t* pSerializedLibrary = nullptr;
+    pipeline_library_file_header_t header = {};
+    if(fread(&header, sizeof(header), 1u, pFileHandle) == 1u &&
+       header.magic == pipelineLibraryFileMagic && header.formatVersion == pipelineLibraryFormatVersion && header.serializedLibrarySizeInBytes > 0u)
+    {
+        pSerializedLibrary = (uint8_t*)allocateFromAllocator(pAllocator, header.serializedLibrarySizeInBytes);
+        if(pSerializedLibrary == nullptr)
+        {
+            fclose(pFileHandle);
+            return nullptr;
+        }
+
+        uint8_t trailingByte = 0u;
+        if(fread(pSerializedLibrary, 1u, header.serializedLibrarySizeInBytes, pFileHandle) != header.serializedLibrarySizeInBytes ||
+           fread(&trailingByte, 1u, 1u, pFileHandle) != 0u ||
+           calculateHash(pSerializedLibrary, header.serializedLibrarySizeInBytes) != header.serializedLibraryHash)
+        {
+            freeFromAllocator(pAllocator, pSerializedLibrary);
+            pSerializedLibrary = nullptr;
+        }
+    }
+
+    fclose(pFileHandle);
+
+    if(pSerializedLibrary == nullptr)
+    {
+        logWarning("Pipeline library '%s' is corrupt and will be recreated.", pFilePath);
+        ++pStatistics->invalidatedCount;
+        return nullptr;
+    }
+
+    *pOutSerializedLibrarySizeInBytes = header.serializedLibrarySizeInBytes;
+    return pSerializedLibrary;
+}
+
+bool createPipelineLibrary(D3D12DeviceType* pDevice, memory_allocator_t* pAllocator, pipeline_library_t* pOutPipelineLibrary, const char* pFilePath)
+{
+    pOutPipelineLibrary->pPipelineLibrary   = nullptr;
+    pOutPipelineLibrary->pAllocator         = pAllocator;
+    pOutPipelineLibrary->pSerializedLibrary = nullptr;
+    pOutPipelineLibrary->pFilePath          = pFilePath;
+    pOutPipelineLibrary->hasChanged         = false;
+    pOutPipelineLibrary->statistics         = {};
+    InitializeSRWLock(&pOutPipelineLibrary->lock);
+
+    if(pFilePath == nullptr)
+    {
+        return true;
+    }
+
+    uint64_t serializedLibrarySizeInBytes = 0u;
+    uint8_t* pSerializedLibrary = loadPipelineLibraryFile(pAllocator, &pOutPipelineLibrary->statistics, pFilePath, &serializedLibrarySizeInBytes);
+    if(pSerializedLibrary != nullptr)
+    {
+        //FK: Libraries from a different adapter or driver version are expected after hardware or driver updates, just start over
+        const HRESULT result = pDevice->CreatePipelineLibrary(pSerializedLibrary, serializedLibrarySizeInBytes, IID_PPV_ARGS(&pOutPipelineLibrary->pPipelineLibrary));
+        if(result == S_OK)
+        {
+            pOutPipelineLibrary->pSerializedLibrary = pSerializedLibrary;
+            return true;
+        }
+
+        logWarning("Pipeline library '%s' can't be used and will be recreated - error: %s", pFilePath, getHResultString(result));
+
+        //FK: Flag the library before the buffer gets freed, the invalid file gets replaced on the next save even without new pipeline states
+        pOutPipelineLibrary->hasChanged = true;
+        freeFromAllocator(pAllocator, pSerializedLibrary);
+        pSerializedLibrary = nullptr;
+        ++pOutPipelineLibrary->statistics.invalidatedCount;
+    }
+
+    const HRESULT result = COM_CALL(pDevice->CreatePipelineLibrary(nullptr, 0u, IID_PPV_ARGS(&pOutPipelineLibrary->pPipelineLibrary)));
+    if(result != S_OK)
+    {
+        logWarning("Pipeline libraries are not supported, pipeline library '%s' is disabled - error: %s", pFilePath, getHResultString(result));
+        pOutPipelineLibrary->pPipelineLibrary = nullptr;
+    }
+
+    return true;
+}
+
+//FK: Writes the pipeline library file if pipeline states have been added since it has been loaded or saved.
+//    Gets called by shutdownRenderContext(), call it earlier to not lose pipeline states on a crash.
+bool savePipelineLibrary(pipeline_library_t* pPipelineLibrary)
+{
+    if(pPipelineLibrary->pPipelineLibrary == nullptr)
+    {
+        return true;
+    }
+
+    AcquireSRWLockExclusive(&pPipelineLibrary->lock);
+    if(!pPipelineLibrary->hasChanged)
+    {
+        ReleaseSRWLockExclusive(&pPipelineLibrary->lock);
+        return true;
+    }
+
+    const uint64_t serializedLibrarySizeInBytes = pPipelineLibrary->pPipelineLibrary->GetSerializedSize();
+    uint8_t* pSerializedLibrary = (uint8_t*)allocateFromAllocator(pPipelineLibrary->pAllocator, serializedLibrarySizeInBytes);
+    bool writeSucceeded = pSerializedLibrary != nullptr && COM_CALL(pPipelineLibrary->pPipelineLibrary->Serialize(pSerializedLibrary, serializedLibrarySizeInBytes)) == S_OK;
+
+    char temporaryFilePath[maxPipelineLibraryPathLength];
+    const int temporaryPathLength = snprintf(temporaryFilePath, sizeof(temporaryFilePath), "%s.tmp", pPipelineLibrary->pFilePath);
+    writeSucceeded = writeSucceeded && temporaryPathLength > 0 && (uint32_t)temporaryPathLength < sizeof(temporaryFilePath);
+
+    FILE* pFileHandle = writeSucceeded ? fopen(temporaryFilePath, "wb") : nullptr;
+    if(pFileHandle != nullptr)
+    {
+        pipeline_library_file_header_t header = {};
+        header.magic                        = pipelineLibraryFileMagic;
+        header.formatVersion                = pipelineLibraryFormatVersion;
+        header.serializedLibraryHash        = calculateHash(pSerializedLibrary, serializedLibrarySizeInBytes);
+        header.serializedLibrarySizeInBytes = serializedLibrarySizeInBytes;
+
+        writeSucceeded = fwrite(&header, sizeof(header), 1u, pFileHandle) == 1u;
+        writeSucceeded = writeSucceeded && fwrite(pSerializedLibrary, 1u, serializedLibrarySizeInBytes, pFileHandle) == serializedLibrarySizeInBytes;
+        writeSucceeded = (fclose(pFileHandle) == 0) && writeSucceeded;
+        writeSucceeded = writeSucceeded && MoveFileExA(temporaryFilePath, pPipelineLibrary->pFilePath, MOVEFILE_REPLACE_EXISTING);
+        if(!writeSucceeded)
+        {
+            remove(temporaryFilePath);
+        }
+    }
+    else
+    {
+        writeSucceeded = false;
+    }
+
+    if(writeSucceeded)
+    {
+        pPipelineLibrary->hasChanged = false;
+    }
+    else
+    {
+        logWarning("Could not write pipeline library '%s'.", pPipelineLibrary->pFilePath);
+        ++pPipelineLibrary->statistics.writeFailureCount;
+    }
+
+    ReleaseSRWLockExclusive(&pPipelineLibrary->lock);
+
+    if(pSerializedLibrary != nullptr)
+    {
+        freeFromAllocator(pPipelineLibrary->pAllocator, pSerializedLibrary);
+    }
+
+    return writeSucceeded;
+}
+
+void destroyPipelineLibrary(pipeline_library_t* pPipelineLibrary)
+{
+    COM_RELEASE(pPipelineLibrary->pPipelineLibrary);
+    if(pPipelineLibrary->pSerializedLibrary != nullptr)
+    {
+        freeFromAllocator(pPipelineLibrary->pAllocator, pPipelineLibrary->pSerializedLibrary);
+        pPipelineLibrary->pSerializedLibrary = nullptr;
+    }
+}
+
+bool createRenderContext(render_context_t* pRenderContext, const render_context_parameters_t* pParameters)
+{
+    ASSERT_DEBUG(isValidRenderContextParameters(pParameters));
+
+    memory_allocator_t* pAllocator = pParameters->pAllocator;
+    if(pAllocator != nullptr)
+    {
+        pRenderContext->defaultAllocator = *pAllocator;
+    }
+    else
+    {
+        createDefaultMemoryAllocator(&pRenderContext->defaultAllocator);
+    }
+
+    bool useDebugLayer = pParameters->flags & render_context_flags_t::use_debug_layer;
+    if(useDebugLayer)
+    {
+        useDebugLayer = enableD3D12DebugLayer(&pRenderContext->pDebugLayer);
+    }
+
+    if(!createD3D12Factory(&pRenderContext->pFactory))
+    {
+        return false;
+    }
+
+    if(!createD3D12Device(&pRenderContext->pDevice))
+    {
+        return false;
+    }
+
+    if(!createCommandQueue(pRenderContext->pDevice, &pRenderContext->pDefaultDirectCommandQueue, D3D12_COMMAND_LIST_TYPE_DIRECT))
+    {
+        return false;
+    }
+
+    if(!createCommandQueue(pRenderContext->pDevice, &pRenderContext->pDefaultCopyCommandQueue, D3D12_COMMAND_LIST_TYPE_COPY))
+    {
+        return false;
+    }
+
+    if(!createSwapChain(&pRenderContext->swapChain, &pRenderContext->defaultAllocator, pRenderContext->pFactory, pRenderContext->pDevice, pRenderContext->pDefaultDirectCommandQueue, pParameters->pWindowHandle, pParameters->windowWidth, pParameters->windowHeight, pParameters->frameBufferCount))
+    {
+        return false;
+    }
+
+    if(!createShaderCompilerContext(&pRenderContext->defaultAllocator, &pRenderContext->shaderCompilerContext, pParameters->pShaderCacheDirectory))
+    {
+        return false;
+    }
+
+    graphics_frame_parameters_t graphicsFrameParameters = {};
+    graphicsFrameParameters.maxRenderPassCount              = pParameters->limits.maxRenderPassCount;
+    graphicsFrameParameters.maxVertexBufferCount            = pParameters->limits.maxVertexBufferCount;
+    graphicsFrameParameters.defaultStagingBufferSizeInBytes = pParameters->limits.defaultStagingBufferSizeInBytes;
+    graphicsFrameParameters.tempMemorySizeInBytes           = pParameters->limits.frameTempMemorySizeInBytes;
+    graphicsFrameParameters.constantBufferSizeInBytes       = pParameters->limits.frameConstantBufferSizeInBytes;
+    graphicsFrameParameters.renderPassSubmitThreshold       = pParameters->renderPassSubmitThreshold;
+
+    if(!createUploadRingBuffer(&pRenderContext->uploadRingBuffer, pRenderContext->pDevice, pParameters->limits.defaultStagingBufferSizeInBytes))
+    {
+        return false;
+    }
+
+    if(!createUploadQueue(&pRenderContext->uploadQueue, pRenderContext->pDevice, pRenderContext->pDefaultCopyCommandQueue))
+    {
+        return false;
+    }
+
+    if(!createPersistentDescriptorAllocator(&pRenderContext->persistentDescriptorAllocator, &pRenderContext->defaultAllocator, pRenderContext->pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, pParameters->limits.maxPersistentDescriptorCount))
+    {
+        return false;
+    }
+
+    //FK: Only one shader visible CBV/SRV/UAV heap can be bound at a time, so bindless and transient descriptors share it
+    const uint32_t shaderVisibleDescriptorCount = pParameters->limits.maxBindlessDescriptorCount + pParameters->limits.maxTransientDescriptorCount;
+    if(!createDescriptorHeap(&pRenderContext->shaderVisibleDescriptorHeap, pRenderContext->pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, shaderVisibleDescriptorCount, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE))
+    {
+        return false;
+    }
+
+    if(!createBindlessDescriptorTable(&pRenderContext->bindlessDescriptorTable, &pRenderContext->defaultAllocator, &pRenderContext->shaderVisibleDescriptorHeap, pParameters->limits.maxBindlessDescriptorCount))
+    {
+        return false;
+    }
+
+    createTransientDescriptorAllocator(&pRenderContext->transientDescriptorAllocator, &pRenderContext->shaderVisibleDescriptorHeap, pParameters->limits.maxBindlessDescriptorCount, pParameters->limits.maxTransientDescriptorCount);
+
+    //FK: Samplers rarely change, so they only get a persistent allocator. It owns the one shader visible sampler heap.
+    if(!createPersistentDescriptorAllocator(&pRenderContext->samplerDescriptorAllocator, &pRenderContext->defaultAllocator, pRenderContext->pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, pParameters->limits.maxSamplerDescriptorCount, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE))
+    {
+        return false;
+    }
+
+    if(!createGraphicsFrameCollection(&pRenderContext->graphicsFramesCollection, &graphicsFrameParameters, &pRenderContext->defaultAllocator, &pRenderContext->renderResourceCache, &pRenderContext->shaderCompilerContext, &pRenderContext->uploadRingBuffer, &pRenderContext->uploadQueue, &pRenderContext->transientDescriptorAllocator, &pRenderContext->bindlessDescriptorTable, &pRenderContext->samplerDescriptorAllocator, pRenderContext->pDefaultDirectCommandQueue, pRenderContext->pDevice, pParameters->frameBufferCount))
+    {
+        return false;
+    }
+
+    if(useDebugLayer)
+    {
+        if(!setupD3D12DebugLayer(pRenderContext->pDevice))
+        {
+
+        }
+    }
+
+    const bool notifyOnLimitReach = pParameters->flags & render_context_flags_t::notify_on_limit_reach;
+    if(!createRenderResourceCache(pRenderContext->pDevice, &pRenderContext->renderResourceCache, &pRenderContext->defaultAllocator, &pParameters->limits, notifyOnLimitReach))
+    {
+        return false;
+    }
+
+    if(!createPipelineLibrary(pRenderContext->pDevice, &pRenderContext->defaultAllocator, &pRenderContext->renderResourceCache.pipelineLibrary, pParameters->pPipelineLibraryFilePath))
+    {
+        return false;
+    }
+
+    pRenderContext->frameIndex = 1u;
+
+    return true;
+}
+
+graphics_frame_t* beginNextFrame(render_context_t* pRenderContext)
+{
+    ASSERT_DEBUG(pRenderContext != nullptr);
+    ASSERT_DEBUG(pRenderContext->pCurrentGraphicsFrame == nullptr);
+
+    const uint64_t previousFrameIndex = (pRenderContext->frameIndex - 1) % pRenderContext->graphicsFramesCollection.frameCount;
+    const uint64_t frameIndex = pRenderContext->frameIndex % pRenderContext->graphicsFramesCollection.frameCount;
+
+    graphics_frame_t* pPreviousFrame = getGraphicsFrameFromGraphicsFrameCollection(&pRenderContext->graphicsFramesCollection, previousFrameIndex);
+    graphics_frame_t* pGraphicsFrame = getGraphicsFrameFromGraphicsFrameCollection(&pRenderContext->graphicsFramesCollection, frameIndex);
+    
+    //FK: The copy queue runs independently of the direct queue, wait for this frame's upload batch as well
+    flushFrame(pGraphicsFrame);
+    waitForUploadBatch(&pRenderContext->uploadQueue, pGraphicsFrame->uploadFenceValue);
+    resetFrame(pGraphicsFrame);
+
+    //FK: Upload slices are read by the copy queue, so they're done once their upload batch fence has been reached
+    reclaimRingBuffer(&pRenderContext->uploadRingBuffer.allocator, pRenderContext->uploadQueue.pCopyFence->GetCompletedValue());
+
+    //FK: Frames finish in order, so every frame up to the one that just got flushed is done with its descriptors
+    const uint64_t completedFrameFenceValue = pGraphicsFrame->pFrameFence->GetCompletedValue();
+    reclaimTransientDescriptors(&pRenderContext->transientDescriptorAllocator, completedFrameFenceValue);
+    reclaimBindlessDescriptors(&pRenderContext->bindlessDescriptorTable, completedFrameFenceValue);
+
+    const uint32_t currentBackBufferIndex = pRenderContext->swapChain.pSwapChain->GetCurrentBackBufferIndex();
+
+    pRenderContext->pCurrentGraphicsFrame = pGraphicsFrame;
+    pGraphicsFrame->frameIndex = pRenderContext->frameIndex;
+    pGraphicsFrame->pBackBuffer = pRenderContext->swapChain.pBackBuffers + currentBackBufferIndex;
+    ++pRenderContext->frameIndex;
+
+    //FK: Pipeline states that finish compiling during the frame only get used from the next frame on, so all
+    //    render passes of a frame agree on which pipeline states are ready
+    pGraphicsFrame->pipelineStateCompletionIndex = InterlockedCompareExchange(&pRenderContext->renderResourceCache.pipelineStateCache.completedCompileJobCount, 0, 0);
+
+    resetAllocator(&pGraphicsFrame->tempMemoryAllocator);
+    return pGraphicsFrame;
+}
+
+void submitUploadBatch(render_context_t* pRenderContext, graphics_frame_t* pGraphicsFrame)
+{
+    upload_queue_t* pUploadQueue = &pRenderContext->uploadQueue;
+    COM_CALL(pGraphicsFrame->pFrameGeneralCopyQueue->Close());
+
+    if(pGraphicsFrame->pendingCopyCount > 0u)
+    {
+        pUploadQueue->pCopyCommandQueue->ExecuteCommandLists(1u, (ID3D12CommandList* const*)&pGraphicsFrame->pFrameGeneralCopyQueue);
+    }
+
+    //FK: Signal even without pending copies, upload buffers that didn't get copied still need their ring buffer slice reclaimed
+    pUploadQueue->lastSubmittedFenceValue = getNextUploadFenceValue(pUploadQueue);
+    COM_CALL(pUploadQueue->pCopyCommandQueue->Signal(pUploadQueue->pCopyFence, pUploadQueue->lastSubmittedFenceValue));
+
+    pGraphicsFrame->uploadFenceValue = pUploadQueue->lastSubmittedFenceValue;
+    closeRingBufferFrame(&pRenderContext->uploadRingBuffer.allocator, pUploadQueue->lastSubmittedFenceValue);
+}
+
+bool isUploadBatchPendingOnDirectQueue(upload_queue_t* pUploadQueue, const uint64_t uploadFenceValue)
+{
+    return uploadFenceValue > pUploadQueue->lastWaitedFenceValue && pUploadQueue->pCopyFence->GetCompletedValue() < uploadFenceValue;
+}
+
+void executeCommandLists(graphics_frame_t* pGraphicsFrame, ID3D12CommandList* const* ppCommandLists, const uint32_t commandListCount)
+{
+    if(commandListCount == 0u)
+    {
+        return;
+    }
+
+    pGraphicsFrame->pFrameCommandQueue->ExecuteCommandLists(commandListCount, ppCommandLists);
+    pGraphicsFrame->submitStatistics.submitCallCount += 1u;
+    pGraphicsFrame->submitStatistics.submittedCommandListCount += commandListCount;
+}
+
+//FK: Insertion sort, keeps render passes with equal sort index in the order they got executed in
+void sortRenderPassesBySortIndex(render_pass_t** ppRenderPasses, const uint32_t renderPassCount)
+{
+    for(uint32_t renderPassIndex = 1u; renderPassIndex < renderPassCount; ++renderPassIndex)
+    {
+        render_pass_t* pRenderPass = ppRenderPasses[renderPassIndex];
+        uint32_t insertIndex = renderPassIndex;
+        while(insertIndex > 0u && ppRenderPasses[insertIndex - 1u]->sortIndex > pRenderPass->sortIndex)
+        {
+            ppRenderPasses[insertIndex] = ppRenderPasses[insertIndex - 1u];
+            --insertIndex;
+        }
+
+        ppRenderPasses[insertIndex] = pRenderPass;
+    }
+}
+
+render_pass_t* getFirstRenderPassToSubmit(graphics_frame_t* pGraphicsFrame)
+{
+    return pGraphicsFrame->pLastSubmittedRenderPass != nullptr ? pGraphicsFrame->pLastSubmittedRenderPass->pNext : pGraphicsFrame->pFirstRenderPassToExecute;
+}
+
+//FK: Number of sorted render passes whose sort indices continue the already submitted ones without a gap.
+//    A pass behind a gap can't be submitted early, the pass that fills the gap might still be recording.
+uint32_t getContiguousRenderPassCount(render_pass_t* const* ppSortedRenderPasses, const uint32_t renderPassCount, uint32_t* pInOutNextSortIndex)
+{
+    uint32_t nextSortIndex = *pInOutNextSortIndex;
+    uint32_t renderPassIndex = 0u;
+    while(renderPassIndex < renderPassCount && ppSortedRenderPasses[renderPassIndex]->sortIndex <= nextSortIndex)
+    {
+        if(ppSortedRenderPasses[renderPassIndex]->sortIndex == nextSortIndex)
+        {
+            ++nextSortIndex;
+        }
+
+        ++renderPassIndex;
+    }
+
+    *pInOutNextSortIndex = nextSortIndex;
+    return renderPassIndex;
+}
+
+//FK: Cheap check before sorting, true if the next 'renderPassCount' sort indices have all been executed
+bool hasContiguousRenderPassesToSubmit(graphics_frame_t* pGraphicsFrame, const uint32_t renderPassCount)
+{
+    uint32_t contiguousRenderPassCount = 0u;
+    const render_pass_t* pRenderPass = getFirstRenderPassToSubmit(pGraphicsFrame);
+    while(pRenderPass != nullptr)
+    {
+        if(pRenderPass->sortIndex >= pGraphicsFrame->nextSortIndexToSubmit && pRenderPass->sortIndex - pGraphicsFrame->nextSortIndexToSubmit < renderPassCount)
+        {
+            ++contiguousRenderPassCount;
+        }
+
+        pRenderPass = pRenderPass->pNext;
+    }
+
+    return contiguousRenderPassCount >= renderPassCount;
+}
+
+//FK: Submits the render passes that have been executed since the last submit with as few ExecuteCommandLists calls as possible.
+//    The submission only gets split if a render pass has to wait for an upload batch of the copy queue.
+//    Early submissions (submitAll = false) only send the passes that directly follow the already submitted sort indices,
+//    so passes get submitted in sort index order no matter in which order they have been executed.
+void submitRenderPasses(graphics_frame_t* pGraphicsFrame, ID3D12CommandList* pTrailingCommandList, const bool submitAll)
+{
+    const uint32_t renderPassCount = pGraphicsFrame->renderPassToSubmitCount;
+    render_pass_t** ppRenderPasses = (render_pass_t**)allocateFromAllocator(&pGraphicsFrame->tempMemoryAllocator, sizeof(render_pass_t*) * renderPassCount);
+    ID3D12CommandList** ppCommandLists = (ID3D12CommandList**)allocateFromAllocator(&pGraphicsFrame->tempMemoryAllocator, sizeof(ID3D12CommandList*) * (renderPassCount + 1u));
+    uint32_t commandListCount = 0u;
+
+    uint32_t renderPassIndex = 0u;
+    render_pass_t* pRenderPass = getFirstRenderPassToSubmit(pGraphicsFrame);
+    while(pRenderPass != nullptr)
+    {
+        ppRenderPasses[renderPassIndex++] = pRenderPass;
+        pRenderPass = pRenderPass->pNext;
+    }
+    ASSERT_DEBUG(renderPassIndex == renderPassCount);
+
+    //FK: Render passes might have been executed from different threads, the sort index makes the submission order deterministic
+    sortRenderPassesBySortIndex(ppRenderPasses, renderPassCount);
+
+    const uint32_t renderPassToSubmitCount = submitAll ? renderPassCount : getContiguousRenderPassCount(ppRenderPasses, renderPassCount, &pGraphicsFrame->nextSortIndexToSubmit);
+
+    //FK: Relink the pending passes in sort index order, so the ones that didn't get submitted stay at the end of the chain
+    if(renderPassCount > 0u)
+    {
+        for(renderPassIndex = 1u; renderPassIndex < renderPassCount; ++renderPassIndex)
+        {
+            ppRenderPasses[renderPassIndex - 1u]->pNext = ppRenderPasses[renderPassIndex];
+        }
+        ppRenderPasses[renderPassCount - 1u]->pNext = nullptr;
+
+        if(pGraphicsFrame->pLastSubmittedRenderPass != nullptr)
+        {
+            pGraphicsFrame->pLastSubmittedRenderPass->pNext = ppRenderPasses[0];
+        }
+        else
+        {
+            pGraphicsFrame->pFirstRenderPassToExecute = ppRenderPasses[0];
+        }
+
+        pGraphicsFrame->pLastRenderPassToExecute = ppRenderPasses[renderPassCount - 1u];
+    }
+
+    upload_queue_t* pUploadQueue = pGraphicsFrame->pUploadQueue;
+    for(renderPassIndex = 0u; renderPassIndex < renderPassToSubmitCount; ++renderPassIndex)
+    {
+        pRenderPass = ppRenderPasses[renderPassIndex];
+
+        //FK: Only the first render pass that uses freshly uploaded resources has to wait for the copy queue.
+        //    This is a GPU side wait, the CPU doesn't block here.
+        if(isUploadBatchPendingOnDirectQueue(pUploadQueue, pRenderPass->uploadFenceValueToWaitFor))
+        {
+            executeCommandLists(pGraphicsFrame, ppCommandLists, commandListCount);
+            commandListCount = 0u;
+
+            COM_CALL(pGraphicsFrame->pFrameCommandQueue->Wait(pUploadQueue->pCopyFence, pRenderPass->uploadFenceValueToWaitFor));
+            pUploadQueue->lastWaitedFenceValue = pRenderPass->uploadFenceValueToWaitFor;
+        }
+
+        ppCommandLists[commandListCount++] = pRenderPass->pGraphicsCommandList;
+    }
+
+    if(pTrailingCommandList != nullptr)
+    {
+        ppCommandLists[commandListCount++] = pTrailingCommandList;
+    }
+
+    executeCommandLists(pGraphicsFrame, ppCommandLists, commandListCount);
+
+    if(renderPassToSubmitCount > 0u)
+    {
+        pGraphicsFrame->pLastSubmittedRenderPass = ppRenderPasses[renderPassToSubmitCount - 1u];
+    }
+
+    pGraphicsFrame->renderPassToSubmitCount = renderPassCount - renderPassToSubmitCount;
+}
+
+void finishFrame(render_context_t* pRenderContext, graphics_frame_t* pGraphicsFrame)
+{
+    ASSERT_DEBUG(pRenderContext != nullptr);
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    ASSERT_DEBUG(pRenderContext->pCurrentGraphicsFrame == pGraphicsFrame);
+    ASSERT_DEBUG(pGraphicsFrame->openRenderPassCount == 0u);
+
+    const uint32_t frameBufferIndex = pRenderContext->swapChain.pSwapChain->GetCurrentBackBufferIndex();
+    transitionResource(&pGraphicsFrame->generalGraphicsBarrierBatch, &pRenderContext->swapChain.pBackBuffers[frameBufferIndex].resource, D3D12_RESOURCE_STATE_PRESENT);
+    flushResourceBarriers(&pGraphicsFrame->generalGraphicsBarrierBatch);
+    addResourceBarrierStatistics(&pGraphicsFrame->barrierStatistics, &pGraphicsFrame->generalGraphicsBarrierBatch.statistics);
+
+    submitUploadBatch(pRenderContext, pGraphicsFrame);
+
+    //FK: The general list only contains the transition of the back buffer into present state, so it goes last
+    pGraphicsFrame->pFrameGeneralGraphicsQueue->Close();
+    submitRenderPasses(pGraphicsFrame, pGraphicsFrame->pFrameGeneralGraphicsQueue, true);
+
+    COM_CALL(pRenderContext->pDefaultDirectCommandQueue->Signal(pGraphicsFrame->pFrameFence, pGraphicsFrame->frameIndex));
+    closeTransientDescriptorFrame(&pRenderContext->transientDescriptorAllocator, pGraphicsFrame->frameIndex);
+
+    COM_CALL(pRenderContext->swapChain.pSwapChain->Present(0, DXGI_PRESENT_ALLOW_TEARING));
+    COM_CALL(pGraphicsFrame->pFrameFence->SetEventOnCompletion(pGraphicsFrame->frameIndex, pGraphicsFrame->pFrameFinishedEvent));
+
+    pRenderContext->pCurrentGraphicsFrame = nullptr;
+}
+
+void* allocateFromRenderResourceCacheGeneric(base_resource_table_t* pResourceTable, const bool notifyOnGrow, const char* pResourceName, uint32_t* pOutIndex, uint32_t* pOutGeneration)
+{
+    void* pRenderResourceData = allocateFromResourceTableDontGrow(pResourceTable, pOutIndex, pOutGeneration);
+    if(pRenderResourceData == nullptr)
+    {
+        if(notifyOnGrow)
+        {
+            logWarning("Reached limit of %u %s. Need to allocate from main memory to make room for more %s, new limit = %u", pResourceTable->capacity, pResourceName, calculateNewResourceTableCapacity(pResourceTable), pResourceName);
+        }
+
+        if(!tryToGrowResourceTable(pResourceTable))
+        {
+            return nullptr;
+        }
+
+        pRenderResourceData = allocateFromResourceTableDontGrow(pResourceTable, pOutIndex, pOutGeneration);
+        if(pRenderResourceData == nullptr)
+        {
+            return nullptr;
+        }
+    }
+
+    return pRenderResourceData;
+}
+
+template<typename T, typename HANDLE_TYPE>
+T* allocateFromRenderResourceCache(render_resource_cache_t* pRenderResourceCache, resource_table_t<T, HANDLE_TYPE>* pResourceTable, const char* pResourceName, HANDLE_TYPE* pOutHandle)
+{
+    const bool notifyOnGrow = pRenderResourceCache->flags & render_resource_flags_t::notify_on_array_grow;
+
+    uint32_t index = 0u;
+    uint32_t generation = 0u;
+    T* pResource = (T*)allocateFromRenderResourceCacheGeneric(pResourceTable, notifyOnGrow, pResourceName, &index, &generation);
+    *pOutHandle = pResource != nullptr ? createResourceHandle<HANDLE_TYPE>(index, generation) : createInvalidResourceHandle<HANDLE_TYPE>();
+    return pResource;
+}
+
+shader_binary_t* allocateShaderBinary(render_resource_cache_t* pRenderResourceCache, shader_binary_handle_t* pOutHandle)
+{
+    return allocateFromRenderResourceCache(pRenderResourceCache, &pRenderResourceCache->shaderBinaries, "shader binaries", pOutHandle);
+}
+
+vertex_format_t* allocateVertexFormat(render_resource_cache_t* pRenderResourceCache, vertex_format_handle_t* pOutHandle)
+{
+    return allocateFromRenderResourceCache(pRenderResourceCache, &pRenderResourceCache->vertexFormats, "vertex formats", pOutHandle);
+}
+
+vertex_buffer_t* allocateVertexBuffer(render_resource_cache_t* pRenderResourceCache, vertex_buffer_handle_t* pOutHandle)
+{
+    return allocateFromRenderResourceCache(pRenderResourceCache, &pRenderResourceCache->vertexBuffers, "vertex buffers", pOutHandle);
+}
+
+shader_binary_t* getShaderBinary(render_resource_cache_t* pRenderResourceCache, const shader_binary_handle_t handle)
+{
+    return getFromResourceTable(&pRenderResourceCache->shaderBinaries, handle);
+}
+
+vertex_format_t* getVertexFormat(render_resource_cache_t* pRenderResourceCache, const vertex_format_handle_t handle)
+{
+    return getFromResourceTable(&pRenderResourceCache->vertexFormats, handle);
+}
+
+vertex_buffer_t* getVertexBuffer(render_resource_cache_t* pRenderResourceCache, const vertex_buffer_handle_t handle)
+{
+    return getFromResourceTable(&pRenderResourceCache->vertexBuffers, handle);
+}
+
+graphics_pipeline_state_t* getPipelineState(render_resource_cache_t* pRenderResourceCache, const graphics_pipeline_state_handle_t handle)
+{
+    return getFromResourceTable(&pRenderResourceCache->pipelineStates, handle);
+}
+
+render_pass_t* getFreeRenderPass(render_resource_cache_t* pRenderResourceCache)
+{
+    AcquireSRWLockExclusive(&pRenderResourceCache->renderPassFreeListLock);
+    if(pRenderResourceCache->pFirstFreeRenderPass == nullptr)
+    {
+        DebugBreak();
+    }
+
+    render_pass_t* pFreeRenderPass = pRenderResourceCache->pFirstFreeRenderPass;
+    if(pFreeRenderPass != nullptr)
+    {
+        pRenderResourceCache->pFirstFreeRenderPass = pFreeRenderPass->pNext;
+    }
+    ReleaseSRWLockExclusive(&pRenderResourceCache->renderPassFreeListLock);
+
+    return pFreeRenderPass;
+}
+
+graphics_pipeline_state_t* allocatePipelineState(render_resource_cache_t* pRenderResourceCache, graphics_pipeline_state_handle_t* pOutHandle)
+{
+    return allocateFromRenderResourceCache(pRenderResourceCache, &pRenderResourceCache->pipelineStates, "pipeline state objects", pOutHandle);
+}
+
+//FK: The descs contain padding bytes, so they get compared member by member. Same rules as calculateBlendDescHash().
+bool areBlendDescsEqual(const D3D12_BLEND_DESC* pBlendDescA, const D3D12_BLEND_DESC* pBlendDescB, const uint32_t renderTargetCount)
+{
+    if(pBlendDescA->AlphaToCoverageEnable != pBlendDescB->AlphaToCoverageEnable || pBlendDescA->IndependentBlendEnable != pBlendDescB->IndependentBlendEnable)
+    {
+        return false;
+    }
+
+    const uint32_t blendDescCount = pBlendDescA->IndependentBlendEnable ? renderTargetCount : 1u;
+    for(uint32_t renderTargetIndex = 0u; renderTargetIndex < blendDescCount; ++renderTargetIndex)
+    {
+        const D3D12_RENDER_TARGET_BLEND_DESC* pRenderTargetBlendDescA = pBlendDescA->RenderTarget + renderTargetIndex;
+        const D3D12_RENDER_TARGET_BLEND_DESC* pRenderTargetBlendDescB = pBlendDescB->RenderTarget + renderTargetIndex;
+        if(pRenderTargetBlendDescA->BlendEnable != pRenderTargetBlendDescB->BlendEnable ||
+           pRenderTargetBlendDescA->LogicOpEnable != pRenderTargetBlendDescB->LogicOpEnable ||
+           pRenderTargetBlendDescA->SrcBlend != pRenderTargetBlendDescB->SrcBlend ||
+           pRenderTargetBlendDescA->DestBlend != pRenderTargetBlendDescB->DestBlend ||
+           pRenderTargetBlendDescA->BlendOp != pRenderTargetBlendDescB->BlendOp ||
+           pRenderTargetBlendDescA->SrcBlendAlpha != pRenderTargetBlendDescB->SrcBlendAlpha ||
+           pRenderTargetBlendDescA->DestBlendAlpha != pRenderTargetBlendDescB->DestBlendAlpha ||
+           pRenderTargetBlendDescA->BlendOpAlpha != pRenderTargetBlendDescB->BlendOpAlpha ||
+           pRenderTargetBlendDescA->LogicOp != pRenderTargetBlendDescB->LogicOp ||
+           pRenderTargetBlendDescA->RenderTargetWriteMask != pRenderTargetBlendDescB->RenderTargetWriteMask)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool areDepthStencilDescsEqual(const D3D12_DEPTH_STENCIL_DESC* pDepthStencilDescA, const D3D12_DEPTH_STENCIL_DESC* pDepthStencilDescB)
+{
+    return pDepthStencilDescA->DepthEnable == pDepthStencilDescB->DepthEnable &&
+           pDepthStencilDescA->DepthWriteMask == pDepthStencilDescB->DepthWriteMask &&
+           pDepthStencilDescA->DepthFunc == pDepthStencilDescB->DepthFunc &&
+           pDepthStencilDescA->StencilEnable == pDepthStencilDescB->StencilEnable &&
+           pDepthStencilDescA->StencilReadMask == pDepthStencilDescB->StencilReadMask &&
+           pDepthStencilDescA->StencilWriteMask == pDepthStencilDescB->StencilWriteMask &&
+           memcmp(&pDepthStencilDescA->FrontFace, &pDepthStencilDescB->FrontFace, sizeof(pDepthStencilDescA->FrontFace)) == 0 &&
+           memcmp(&pDepthStencilDescA->BackFace, &pDepthStencilDescB->BackFace, sizeof(pDepthStencilDescA->BackFace)) == 0;
+}
+
+bool areGraphicsPipelineStateKeyInputsEqual(const graphics_pipeline_state_key_inputs_t* pKeyInputsA, const graphics_pipeline_state_key_inputs_t* pKeyInputsB)
+{
+    if(pKeyInputsA->vertexShaderBlobHash != pKeyInputsB->vertexShaderBlobHash ||
+       pKeyInputsA->pixelShaderBlobHash != pKeyInputsB->pixelShaderBlobHash ||
+       pKeyInputsA->vertexShaderBlobSizeInBytes != pKeyInputsB->vertexShaderBlobSizeInBytes ||
+       pKeyInputsA->pixelShaderBlobSizeInBytes != pKeyInputsB->pixelShaderBlobSizeInBytes ||
+       pKeyInputsA->vertexAttributeCount != pKeyInputsB->vertexAttributeCount ||
+       pKeyInputsA->primitiveTopologyType != pKeyInputsB->primitiveTopologyType ||
+       pKeyInputsA->depthStencilFormat != pKeyInputsB->depthStencilFormat ||
+       pKeyInputsA->renderTargetCount != pKeyInputsB->renderTargetCount ||
+       pKeyInputsA->drawConstantCount != pKeyInputsB->drawConstantCount ||
+       pKeyInputsA->useBindlessRootSignature != pKeyInputsB->useBindlessRootSignature ||
+       pKeyInputsA->rootSignatureDescSizeInBytes != pKeyInputsB->rootSignatureDescSizeInBytes)
+    {
+        return false;
+    }
+
+    for(uint32_t attributeIndex = 0u; attributeIndex < pKeyInputsA->vertexAttributeCount; ++attributeIndex)
+    {
+        const vertex_attribute_entry_t* pAttributeA = pKeyInputsA->vertexAttributes + attributeIndex;
+        const vertex_attribute_entry_t* pAttributeB = pKeyInputsB->vertexAttributes + attributeIndex;
+        if(pAttributeA->attribute != pAttributeB->attribute || pAttributeA->type != pAttributeB->type || pAttributeA->count != pAttributeB->count)
+        {
+            return false;
+        }
+    }
+
+    return memcmp(pKeyInputsA->renderTargetFormats, pKeyInputsB->renderTargetFormats, sizeof(DXGI_FORMAT) * pKeyInputsA->renderTargetCount) == 0 &&
+           memcmp(&pKeyInputsA->rasterizerDesc, &pKeyInputsB->rasterizerDesc, sizeof(pKeyInputsA->rasterizerDesc)) == 0 &&
+           areBlendDescsEqual(&pKeyInputsA->blendDesc, &pKeyInputsB->blendDesc, pKeyInputsA->renderTargetCount) &&
+           areDepthStencilDescsEqual(&pKeyInputsA->depthStencilDesc, &pKeyInputsB->depthStencilDesc) &&
+           (pKeyInputsA->rootSignatureDescSizeInBytes == 0u || memcmp(pKeyInputsA->pRootSignatureDesc, pKeyInputsB->pRootSignatureDesc, pKeyInputsA->rootSignatureDescSizeInBytes) == 0);
+}
+
+void destroyGraphicsPipelineStateKeyInputs(memory_allocator_t* pAllocator, graphics_pipeline_state_key_inputs_t* pKeyInputs)
+{
+    if(pKeyInputs->pRootSignatureDesc != nullptr)
+    {
+        freeFromAllocator(pAllocator, pKeyInputs->pRootSignatureDesc);
+        pKeyInputs->pRootSignatureDesc = nullptr;
+    }
+}
+
+//FK: Compares the key inputs as well, so key collisions can't merge different pipeline states
+pipeline_state_cache_entry_t* findPipelineStateCacheEntry(pipeline_state_cache_t* pPipelineStateCache, const uint64_t key, const graphics_pipeline_state_key_inputs_t* pKeyInputs)
+{
+    const uint32_t entryIndexMask = pPipelineStateCache->entryCapacity - 1u;
+    uint32_t entryIndex = (uint32_t)key & entryIndexMask;
+    for(uint32_t probeIndex = 0u; probeIndex < pPipelineStateCache->entryCapacity; ++probeIndex)
+    {
+        pipeline_state_cache_entry_t* pEntry = pPipelineStateCache->pEntries + entryIndex;
+        if(pEntry->state == pipeline_state_cache_entry_empty)
+        {
+            return nullptr;
+        }
+        else if(pEntry->key == key && areGraphicsPipelineStateKeyInputsEqual(&pEntry->keyInputs, pKeyInputs))
+        {
+            return pEntry;
+        }
+
+        entryIndex = (entryIndex + 1u) & entryIndexMask;
+    }
+
+    return nullptr;
+}
+
+//FK: Returns the entry that points to the pipeline state or nullptr if the pipeline state isn't cached
+pipeline_state_cache_entry_t* findPipelineStateCacheEntryByHandle(pipeline_state_cache_t* pPipelineStateCache, const uint64_t key, const graphics_pipeline_state_handle_t pipelineStateHandle)
+{
+    const uint32_t entryIndexMask = pPipelineStateCache->entryCapacity - 1u;
+    uint32_t entryIndex = (uint32_t)key & entryIndexMask;
+    for(uint32_t probeIndex = 0u; probeIndex < pPipelineStateCache->entryCapacity; ++probeIndex)
+    {
+        pipeline_state_cache_entry_t* pEntry = pPipelineStateCache->pEntries + entryIndex;
+        if(pEntry->state == pipeline_state_cache_entry_empty)
+        {
+            return nullptr;
+        }
+        else if(pEntry->pipelineState.index == pipelineStateHandle.index && pEntry->pipelineState.generation == pipelineStateHandle.generation)
+        {
+            return pEntry;
+        }
+
+        entryIndex = (entryIndex + 1u) & entryIndexMask;
+    }
+
+    return nullptr;
+}
+
+//FK: Returns nullptr if the cache is too full, the pipeline state will just not be cached in that case.
+//    The entry takes ownership of the key inputs.
+pipeline_state_cache_entry_t* insertPipelineStateCacheEntry(pipeline_state_cache_t* pPipelineStateCache, const uint64_t key, const graphics_pipeline_state_key_inputs_t* pKeyInputs)
+{
+    if(pPipelineStateCache->entryCount >= pPipelineStateCache->entryCapacity / 4u * 3u)
+    {
+        return nullptr;
+    }
+
+    const uint32_t entryIndexMask = pPipelineStateCache->entryCapacity - 1u;
+    uint32_t entryIndex = (uint32_t)key & entryIndexMask;
+    while(pPipelineStateCache->pEntries[entryIndex].state != pipeline_state_cache_entry_empty)
+    {
+        entryIndex = (entryIndex + 1u) & entryIndexMask;
+    }
+
+    pipeline_state_cache_entry_t* pEntry = pPipelineStateCache->pEntries + entryIndex;
+    pEntry->key             = key;
+    pEntry->keyInputs       = *pKeyInputs;
+    pEntry->pipelineState   = createInvalidResourceHandle<graphics_pipeline_state_handle_t>();
+    pEntry->state           = pipeline_state_cache_entry_pending;
+    ++pPipelineStateCache->entryCount;
+
+    return pEntry;
+}
+
+//FK: Backward shift deletion, moves the following entries of the probe sequence into the gap so lookups never need tombstones
+void removePipelineStateCacheEntry(memory_allocator_t* pAllocator, pipeline_state_cache_t* pPipelineStateCache, pipeline_state_cache_entry_t* pEntry)
+{
+    destroyGraphicsPipelineStateKeyInputs(pAllocator, &pEntry->keyInputs);
+
+    const uint32_t entryIndexMask = pPipelineStateCache->entryCapacity - 1u;
+    uint32_t gapIndex = (uint32_t)(pEntry - pPipelineStateCache->pEntries);
+    uint32_t entryIndex = gapIndex;
+    while(true)
+    {
+        entryIndex = (entryIndex + 1u) & entryIndexMask;
+
+        pipeline_state_cache_entry_t* pNextEntry = pPipelineStateCache->pEntries + entryIndex;
+        if(pNextEntry->state == pipeline_state_cache_entry_empty)
+        {
+            break;
+        }
+
+        //FK: Entries can only move towards their home index, skip entries whose home index lies between the gap and themselves
+        const uint32_t homeIndex = (uint32_t)pNextEntry->key & entryIndexMask;
+        const bool isHomeBetweenGapAndEntry = gapIndex <= entryIndex ? (gapIndex < homeIndex && homeIndex <= entryIndex) : (gapIndex < homeIndex || homeIndex <= entryIndex);
+        if(isHomeBetweenGapAndEntry)
+        {
+            continue;
+        }
+
+        pPipelineStateCache->pEntries[gapIndex] = *pNextEntry;
+        gapIndex = entryIndex;
+    }
+
+    pPipelineStateCache->pEntries[gapIndex] = {};
+    --pPipelineStateCache->entryCount;
+}
+
+//FK: Pipeline states are shared by everyone who created them with the same parameters,
+//    they only get destroyed once every createGraphicsPipelineState() call has been matched by a destroy call.
+void destroyPipelineState(render_resource_cache_t* pRenderResourceCache, const graphics_pipeline_state_handle_t pipelineStateHandle)
+{
+    pipeline_state_cache_t* pPipelineStateCache = &pRenderResourceCache->pipelineStateCache;
+    AcquireSRWLockExclusive(&pPipelineStateCache->lock);
+
+    graphics_pipeline_state_t* pPipelineState = getPipelineState(pRenderResourceCache, pipelineStateHandle);
+    if(pPipelineState == nullptr || --pPipelineState->referenceCount > 0u)
+    {
+        ReleaseSRWLockExclusive(&pPipelineStateCache->lock);
+        return;
+    }
+
+    pipeline_state_cache_entry_t* pEntry = findPipelineStateCacheEntryByHandle(pPipelineStateCache, pPipelineState->cacheKey, pipelineStateHandle);
+    if(pEntry != nullptr)
+    {
+        removePipelineStateCacheEntry(pRenderResourceCache->pMemoryAllocator, pPipelineStateCache, pEntry);
+    }
+
+    COM_RELEASE(pPipelineState->pPipelineState);
+    COM_RELEASE(pPipelineState->pRootSignature);
+    freeFromResourceTable(&pRenderResourceCache->pipelineStates, pipelineStateHandle);
+
+    ReleaseSRWLockExclusive(&pPipelineStateCache->lock);
+}
+
+void destroyVertexBuffer(render_resource_cache_t* pRenderResourceCache, const vertex_buffer_handle_t vertexBufferHandle)
+{
+    vertex_buffer_t* pVertexBuffer = getVertexBuffer(pRenderResourceCache, vertexBufferHandle);
+    if(pVertexBuffer == nullptr)
+    {
+        return;
+    }
+
+    COM_RELEASE(pVertexBuffer->bufferResource.pResource);
+    freeFromResourceTable(&pRenderResourceCache->vertexBuffers, vertexBufferHandle);
+}
+
+bool areVertexAttributesEqual(const vertex_format_t* pVertexFormat, const vertex_attribute_entry_t* pVertexAttributes, const uint32_t vertexAttributeCount)
+{
+    if(pVertexFormat->vertexAttributeCount != vertexAttributeCount)
+    {
+        return false;
+    }
+
+    for(uint32_t attributeIndex = 0u; attributeIndex < vertexAttributeCount; ++attributeIndex)
+    {
+        const vertex_attribute_entry_t* pAttributeA = pVertexFormat->pVertexAttributes + attributeIndex;
+        const vertex_attribute_entry_t* pAttributeB = pVertexAttributes + attributeIndex;
+        if(pAttributeA->attribute != pAttributeB->attribute || pAttributeA->type != pAttributeB->type || pAttributeA->count != pAttributeB->count)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//FK: Compares the attributes as well, so hash collisions can't merge different vertex formats
+vertex_format_cache_entry_t* findVertexFormatCacheEntry(render_resource_cache_t* pRenderResourceCache, const uint64_t hash, const vertex_attribute_entry_t* pVertexAttributes, const uint32_t vertexAttributeCount)
+{
+    vertex_format_cache_t* pVertexFormatCache = &pRenderResourceCache->vertexFormatCache;
+    const uint32_t entryIndexMask = pVertexFormatCache->entryCapacity - 1u;
+    uint32_t entryIndex = (uint32_t)hash & entryIndexMask;
+    for(uint32_t probeIndex = 0u; probeIndex < pVertexFormatCache->entryCapacity; ++probeIndex)
+    {
+        vertex_format_cache_entry_t* pEntry = pVertexFormatCache->pEntries + entryIndex;
+        if(!pEntry->isOccupied)
+        {
+            return nullptr;
+        }
+        else if(pEntry->hash == hash && areVertexAttributesEqual(getVertexFormat(pRenderResourceCache, pEntry->vertexFormat), pVertexAttributes, vertexAttributeCount))
+        {
+            return pEntry;
+        }
+
+        entryIndex = (entryIndex + 1u) & entryIndexMask;
+    }
+
+    return nullptr;
+}
+
+//FK: Returns false if the cache is too full, the vertex format will just not be shared in that case
+bool insertVertexFormatCacheEntry(vertex_format_cache_t* pVertexFormatCache, const uint64_t hash, const vertex_format_handle_t vertexFormatHandle)
+{
+    if(pVertexFormatCache->entryCount >= pVertexFormatCache->entryCapacity / 4u * 3u)
+    {
+        return false;
+    }
+
+    const uint32_t entryIndexMask = pVertexFormatCache->entryCapacity - 1u;
+    uint32_t entryIndex = (uint32_t)hash & entryIndexMask;
+    while(pVertexFormatCache->pEntries[entryIndex].isOccupied)
+    {
+        entryIndex = (entryIndex + 1u) & entryIndexMask;
+    }
+
+    vertex_format_cache_entry_t* pEntry = pVertexFormatCache->pEntries + entryIndex;
+    pEntry->hash            = hash;
+    pEntry->vertexFormat    = vertexFormatHandle;
+    pEntry->isOccupied      = true;
+    ++pVertexFormatCache->entryCount;
+
+    return true;
+}
+
+//FK: Backward shift deletion, same as removePipelineStateCacheEntry()
+void removeVertexFormatCacheEntry(vertex_format_cache_t* pVertexFormatCache, const vertex_format_handle_t vertexFormatHandle, const uint64_t hash)
+{
+    const uint32_t entryIndexMask = pVertexFormatCache->entryCapacity - 1u;
+    uint32_t gapIndex = (uint32_t)hash & entryIndexMask;
+    for(uint32_t probeIndex = 0u; probeIndex < pVertexFormatCache->entryCapacity; ++probeIndex)
+    {
+        const vertex_format_cache_entry_t* pEntry = pVertexFormatCache->pEntries + gapIndex;
+        if(!pEntry->isOccupied)
+        {
+            return;
+        }
+        else if(pEntry->vertexFormat.index == vertexFormatHandle.index && pEntry->vertexFormat.generation == vertexFormatHandle.generation)
+        {
+            break;
+        }
+
+        gapIndex = (gapIndex + 1u) & entryIndexMask;
+    }
+
+    uint32_t entryIndex = gapIndex;
+    while(true)
+    {
+        entryIndex = (entryIndex + 1u) & entryIndexMask;
+
+        vertex_format_cache_entry_t* pNextEntry = pVertexFormatCache->pEntries + entryIndex;
+        if(!pNextEntry->isOccupied)
+        {
+            break;
+        }
+
+        const uint32_t homeIndex = (uint32_t)pNextEntry->hash & entryIndexMask;
+        const bool isHomeBetweenGapAndEntry = gapIndex <= entryIndex ? (gapIndex < homeIndex && homeIndex <= entryIndex) : (gapIndex < homeIndex || homeIndex <= entryIndex);
+        if(isHomeBetweenGapAndEntry)
+        {
+            continue;
+        }
+
+        pVertexFormatCache->pEntries[gapIndex] = *pNextEntry;
+        gapIndex = entryIndex;
+    }
+
+    pVertexFormatCache->pEntries[gapIndex] = {};
+    --pVertexFormatCache->entryCount;
+}
+
+//FK: Vertex formats are shared by everyone who created them with the same attributes,
+//    they only get destroyed once every createVertexFormat() call has been matched by a destroy call.
+void destroyVertexFormat(render_resource_cache_t* pRenderResourceCache, const vertex_format_handle_t vertexFormatHandle)
+{
+    vertex_format_t* pVertexFormat = getVertexFormat(pRenderResourceCache, vertexFormatHandle);
+    if(pVertexFormat == nullptr || --pVertexFormat->referenceCount > 0u)
+    {
+        return;
+    }
+
+    removeVertexFormatCacheEntry(&pRenderResourceCache->vertexFormatCache, vertexFormatHandle, pVertexFormat->hash);
+    freeFromResourceTable(&pRenderResourceCache->vertexFormats, vertexFormatHandle);
+}
+
+//FK: startRenderPass(), endRenderPass() and executeRenderPass() can be called from multiple threads at once. 
+//    Render passes get submitted in the order of their sort index, passes with equal sort index keep the order they got executed in.
+//    Creating resources while render passes are being recorded on other threads is not supported.
+render_pass_t* startRenderPass(graphics_frame_t* pGraphicsFrame, const char* pRenderPassName, render_target_t* pRenderTarget, const uint32_t sortIndex)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+
+    render_pass_t* pRenderPass = getFreeRenderPass(pGraphicsFrame->pRenderResourceCache);
+    if(pRenderPass == nullptr)
+    {
+        return nullptr;
+    }
+
+    InterlockedIncrement(&pGraphicsFrame->openRenderPassCount);
+
+    if(pRenderTarget == nullptr)
+    {
+        pRenderTarget = pGraphicsFrame->pBackBuffer;
+    }
+
+    COM_CALL(pRenderPass->pGraphicsCommandAllocator->Reset());
+    COM_CALL(pRenderPass->pGraphicsCommandList->Reset(pRenderPass->pGraphicsCommandAllocator, nullptr));
+    pRenderPass->isOpen = true;
+    pRenderPass->pRenderResourceCache = pGraphicsFrame->pRenderResourceCache;
+    pRenderPass->pName = pRenderPassName;
+    pRenderPass->pRenderTarget = pRenderTarget;
+    pRenderPass->uploadFenceValueToWaitFor = 0u;
+    pRenderPass->sortIndex = sortIndex;
+    pRenderPass->pipelineStateCompletionIndex = pGraphicsFrame->pipelineStateCompletionIndex;
+    pRenderPass->skipDraws = false;
+    pRenderPass->drawConstantCount = 0u;
+    pRenderPass->pipelineState = createInvalidResourceHandle<graphics_pipeline_state_handle_t>();
+    pRenderPass->rootParameterBindingCount = 0u;
+    pRenderPass->drawQueue.drawCount = 0u;
+    pRenderPass->drawQueue.statistics = {};
+    pRenderPass->pipelineStateReadinessStatistics = {};
+
+    //FK: The render target is the only state shared between render passes, passes track its state locally and
+    //    return it to the state they found it in.
+    pRenderPass->renderTargetResource = pRenderTarget->resource;
+    pRenderPass->renderTargetEntryState = pRenderTarget->resource.currentState;
+    initResourceBarrierBatch(&pRenderPass->barrierBatch, pRenderPass->pGraphicsCommandList);
+    resetRenderPassStateCache(&pRenderPass->stateCache);
+
+    //FK: Bindless and transient descriptors live in the same heap, samplers in their own. Both only have to be set once per command list.
+    pRenderPass->pShaderVisibleDescriptorHeap = pGraphicsFrame->pBindlessDescriptorTable->pDescriptorHeap;
+    ID3D12DescriptorHeap* pShaderVisibleDescriptorHeaps[2] = {pRenderPass->pShaderVisibleDescriptorHeap->pDescriptorHeap, pGraphicsFrame->pSamplerDescriptorAllocator->descriptorHeap.pDescriptorHeap};
+    pRenderPass->pGraphicsCommandList->SetDescriptorHeaps(2u, pShaderVisibleDescriptorHeaps);
+
+    setD3D12ObjectDebugName(pRenderPass->pGraphicsCommandList, pRenderPassName);    
+    addBeginMarker(pRenderPass->pGraphicsCommandList, pRenderPassName);
+    return pRenderPass;
+}
+
+render_pass_t* startRenderPass(graphics_frame_t* pGraphicsFrame, const char* pRenderPassName, render_target_t* pRenderTarget)
+{
+    //FK: Without explicit sort index passes get submitted in the order they got started in
+    const uint32_t sortIndex = (uint32_t)InterlockedIncrement(&pGraphicsFrame->nextRenderPassSortIndex) - 1u;
+    return startRenderPass(pGraphicsFrame, pRenderPassName, pRenderTarget, sortIndex);
+}
+
+bool isColorRenderTarget(render_target_t* pRenderTarget)
+{
+    //FK: TODO
+    return true;
+}
+
+//FK: Size of a single stored component, rgb10a2 is stored as a single packed component
+uint32_t getVertexAttributeTypeSizeInBytes(const vertex_attribute_type_t attributeType)
+{
+    switch(attributeType)
+    {
+        case vertex_attribute_type_t::float32:
+        case vertex_attribute_type_t::rgb10a2:
+            return 4u;
+        case vertex_attribute_type_t::float16:
+        case vertex_attribute_type_t::snorm16:
+        case vertex_attribute_type_t::octahedral16:
+            return 2u;
+        case vertex_attribute_type_t::snorm8:
+        case vertex_attribute_type_t::unorm8:
+        case vertex_attribute_type_t::octahedral8:
+            return 1u;
+        default:
+            DebugBreak();
+    }
+
+    UNREACHABLE_CODE();
+    return 0u;
+}
+
+uint32_t getVertexAttributeStoredComponentCount(const vertex_attribute_type_t attributeType, const uint32_t count)
+{
+    switch(attributeType)
+    {
+        case vertex_attribute_type_t::float32:
+            return count;
+        case vertex_attribute_type_t::float16:
+        case vertex_attribute_type_t::snorm8:
+        case vertex_attribute_type_t::unorm8:
+        case vertex_attribute_type_t::snorm16:
+            return count == 3u ? 4u : count;
+        case vertex_attribute_type_t::rgb10a2:
+            return 1u;
+        case vertex_attribute_type_t::octahedral8:
+        case vertex_attribute_type_t::octahedral16:
+            return 2u;
+        default:
+            DebugBreak();
+    }
+
+    UNREACHABLE_CODE();
+    return 0u;
+}
+
+uint32_t getVertexAttributeSizeInBytes(const vertex_attribute_entry_t* pAttribute)
+{
+    return getVertexAttributeStoredComponentCount(pAttribute->type, pAttribute->count) * getVertexAttributeTypeSizeInBytes(pAttribute->type);
+}
+
+bool isValidVertexAttribute(const vertex_attribute_entry_t* pAttribute)
+{
+    if(pAttribute->attribute > vertex_attribute_t::color)
+    {
+        return false;
+    }
+
+    switch(pAttribute->type)
+    {
+        case vertex_attribute_type_t::float32:
+        case vertex_attribute_type_t::float16:
+        case vertex_attribute_type_t::snorm8:
+        case vertex_attribute_type_t::unorm8:
+        case vertex_attribute_type_t::snorm16:
+            return pAttribute->count >= 1u && pAttribute->count <= 4u;
+        case vertex_attribute_type_t::rgb10a2:
+            return pAttribute->count == 3u || pAttribute->count == 4u;
+        case vertex_attribute_type_t::octahedral8:
+        case vertex_attribute_type_t::octahedral16:
+            return pAttribute->count == 3u;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+simd_level_t detectSimdLevel()
+{
+#if USE_X64_SIMD_KERNELS
+#if defined(_MSC_VER) && !defined(__clang__)
+    int cpuInfo[4] = {};
+    __cpuid(cpuInfo, 0);
+    if(cpuInfo[0] >= 7)
+    {
+        __cpuid(cpuInfo, 1);
+        const bool hasOsAvxSupport  = (cpuInfo[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+        const bool hasAvx           = (cpuInfo[2] & (1 << 28)) != 0;
+        const bool hasF16c          = (cpuInfo[2] & (1 << 29)) != 0;
+
+        __cpuidex(cpuInfo, 7, 0);
+        const bool hasAvx2          = (cpuInfo[1] & (1 << 5)) != 0;
+        if(hasOsAvxSupport && hasAvx && hasF16c && hasAvx2)
+        {
+            return simd_level_avx2;
+        }
+    }
+#else
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c"))
+    {
+        return simd_level_avx2;
+    }
+#endif
+    return simd_level_sse2;
+#else
+    return simd_level_scalar;
+#endif
+}
+
+simd_level_t getSupportedSimdLevel()
+{
+    static const simd_level_t supportedSimdLevel = detectSimdLevel();
+    return supportedSimdLevel;
+}
+
+//FK: Round to nearest even, NaN -> quiet NaN, overflow -> infinity (see https://gist.github.com/rygorous/2156668)
+uint16_t convertFloat32ToFloat16(const float value)
+{
+    const uint32_t infinityBits         = 255u << 23;
+    const uint32_t float16MaxBits       = (127u + 16u) << 23;
+    const uint32_t minNormalBits        = (127u - 14u) << 23;
+    const uint32_t subnormalMagicBits   = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+    uint32_t bits = 0u;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    uint32_t halfBits = 0u;
+    if(bits >= float16MaxBits)
+    {
+        halfBits = bits > infinityBits ? 0x7E00u : 0x7C00u;
+    }
+    else if(bits < minNormalBits)
+    {
+        //FK: Let the float addition round the mantissa into the low 10 bits
+        float subnormalMagic = 0.0f;
+        float absoluteValue = 0.0f;
+        memcpy(&subnormalMagic, &subnormalMagicBits, sizeof(subnormalMagic));
+        memcpy(&absoluteValue, &bits, sizeof(absoluteValue));
+        absoluteValue += subnormalMagic;
+        memcpy(&bits, &absoluteValue, sizeof(bits));
+        halfBits = bits - subnormalMagicBits;
+    }
+    else
+    {
+        const uint32_t mantissaOdd = (bits >> 13) & 1u;
+        bits = bits - ((127u - 15u) << 23) + 0xFFFu + mantissaOdd;
+        halfBits = bits >> 13;
+    }
+
+    return (uint16_t)(halfBits | (sign >> 16));
+}
+
+//FK: NaN -> 0, values outside of [minValue, 1] get clamped, round to nearest even like cvtps2dq
+int32_t convertFloat32ToNormalized(const float value, const float minValue, const float scale)
+{
+    float clampedValue = value != value ? 0.0f : value;
+    clampedValue = clampedValue < minValue ? minValue : clampedValue;
+    clampedValue = clampedValue > 1.0f ? 1.0f : clampedValue;
+    return (int32_t)lrintf(clampedValue * scale);
+}
+
+uint32_t convertFloat32ToRgb10a2(const float* pRgba)
+{
+    const uint32_t r = (uint32_t)convertFloat32ToNormalized(pRgba[0], 0.0f, 1023.0f);
+    const uint32_t g = (uint32_t)convertFloat32ToNormalized(pRgba[1], 0.0f, 1023.0f);
+    const uint32_t b = (uint32_t)convertFloat32ToNormalized(pRgba[2], 0.0f, 1023.0f);
+    const uint32_t a = (uint32_t)convertFloat32ToNormalized(pRgba[3], 0.0f, 3.0f);
+    return r | (g << 10) | (b << 20) | (a << 30);
+}
+
+//FK: Projects the normal onto the octahedron |x|+|y|+|z|=1 and folds the lower hemisphere over the diagonals.
+//    Result is in [-1, 1]. Zero length normals encode to (0, 0).
+void encodeOctahedralNormal(const float* pNormal, float* pOutEncodedNormal)
+{
+    const float absoluteSum = fabsf(pNormal[0]) + fabsf(pNormal[1]) + fabsf(pNormal[2]);
+    const float inverseAbsoluteSum = absoluteSum > 0.0f ? 1.0f / absoluteSum : 0.0f;
+    const float x = pNormal[0] * inverseAbsoluteSum;
+    const float y = pNormal[1] * inverseAbsoluteSum;
+
+    if(pNormal[2] < 0.0f)
+    {
+        pOutEncodedNormal[0] = copysignf(1.0f - fabsf(y), x);
+        pOutEncodedNormal[1] = copysignf(1.0f - fabsf(x), y);
+    }
+    else
+    {
+        pOutEncodedNormal[0] = x;
+        pOutEncodedNormal[1] = y;
+    }
+}
+
+void packFloat32ToFloat16Scalar(const float* pSource, uint16_t* pDestination, const uint32_t count)
+{
+    for(uint32_t index = 0u; index < count; ++index)
+    {
+        pDestination[index] = convertFloat32ToFloat16(pSource[index]);
+    }
+}
+
+void packFloat32ToSnorm8Scalar(const float* pSource, int8_t* pDestination, const uint32_t count)
+{
+    for(uint32_t index = 0u; index < count; ++index)
+    {
+        pDestination[index] = (int8_t)convertFloat32ToNormalized(pSource[index], -1.0f, 127.0f);
+    }
+}
+
+void packFloat32ToUnorm8Scalar(const float* pSource, uint8_t* pDestination, const uint32_t count)
+{
+    for(uint32_t index = 0u; index < count; ++index)
+    {
+        pDestination[index] = (uint8_t)convertFloat32ToNormalized(pSource[index], 0.0f, 255.0f);
+    }
+}
+
+void packFloat32ToSnorm16Scalar(const float* pSource, int16_t* pDestination, const uint32_t count)
+{
+    for(uint32_t index = 0u; index < count; ++index)
+    {
+        pDestination[index] = (int16_t)convertFloat32ToNormalized(pSource[index], -1.0f, 32767.0f);
+    }
+}
+
+void packFloat32ToRgb10a2Scalar(const float* pSource, uint32_t* pDestination, const uint32_t vertexCount)
+{
+    for(uint32_t vertexIndex = 0u; vertexIndex < vertexCount; ++vertexIndex)
+    {
+        pDestination[vertexIndex] = convertFloat32ToRgb10a2(pSource + vertexIndex * 4u);
+    }
+}
+
+void encodeOctahedralNormalsScalar(const float* pSource, float* pDestination, const uint32_t vertexCount)
+{
+    for(uint32_t vertexIndex = 0u; vertexIndex < vertexCount; ++vertexIndex)
+    {
+        encodeOctahedralNormal(pSource + vertexIndex * 3u, pDestination + vertexIndex * 2u);
+    }
+}
+
+#if USE_X64_SIMD_KERNELS
+//FK: SSE2 port of convertFloat32ToFloat16(). The result is sign extended to 32 bit so that _mm_packs_epi32 keeps the bits.
+__m128i convertFloat32ToFloat16Sse2(const __m128 value)
+{
+    const __m128i signMask              = _mm_set1_epi32((int32_t)0x80000000u);
+    const __m128i float16Max            = _mm_set1_epi32((127 + 16) << 23);
+    const __m128i minNormal             = _mm_set1_epi32((127 - 14) << 23);
+    const __m128i subnormalMagic        = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+    const __m128i normalBias            = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+    const __m128i infinityAsFloat16     = _mm_set1_epi32(0x7C00);
+    const __m128i quietNanBit           = _mm_set1_epi32(0x200);
+
+    const __m128  sign                  = _mm_and_ps(_mm_castsi128_ps(signMask), value);
+    const __m128  absoluteValue         = _mm_xor_ps(value, sign);
+    const __m128i absoluteBits          = _mm_castps_si128(absoluteValue);
+
+    const __m128i isNan                 = _mm_castps_si128(_mm_cmpunord_ps(absoluteValue, absoluteValue));
+    const __m128i isFinite              = _mm_cmpgt_epi32(float16Max, absoluteBits);
+    const __m128i isSubnormal           = _mm_cmpgt_epi32(minNormal, absoluteBits);
+    const __m128i infinityOrNan         = _mm_or_si128(infinityAsFloat16, _mm_and_si128(isNan, quietNanBit));
+
+    const __m128  subnormalSum          = _mm_add_ps(absoluteValue, _mm_castsi128_ps(subnormalMagic));
+    const __m128i subnormal             = _mm_sub_epi32(_mm_castps_si128(subnormalSum), subnormalMagic);
+
+    const __m128i mantissaOdd           = _mm_srai_epi32(_mm_slli_epi32(absoluteBits, 31 - 13), 31);
+    const __m128i rounded               = _mm_sub_epi32(_mm_add_epi32(absoluteBits, normalBias), mantissaOdd);
+    const __m128i normal                = _mm_srli_epi32(rounded, 13);
+
+    const __m128i finite                = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+    const __m128i result                = _mm_or_si128(_mm_and_si128(isFinite, finite), _mm_andnot_si128(isFinite, infinityOrNan));
+    return _mm_or_si128(result, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+}
+
+__m128i convertFloat32ToNormalizedSse2(const __m128 value, const __m128 minValue, const __m128 scale)
+{
+    const __m128 withoutNan     = _mm_and_ps(value, _mm_cmpord_ps(value, value));
+    const __m128 clampedValue   = _mm_min_ps(_mm_max_ps(withoutNan, minValue), _mm_set1_ps(1.0f));
+    return _mm_cvtps_epi32(_mm_mul_ps(clampedValue, scale));
+}
+
+void packFloat32ToFloat16Sse2(const float* pSource, uint16_t* pDestination, const uint32_t count)
+{
+    uint32_t index = 0u;
+    for(; index + 8u <= count; index += 8u)
+    {
+        const __m128i low  = convertFloat32ToFloat16Sse2(_mm_loadu_ps(pSource + index));
+        const __m128i high = convertFloat32ToFloat16Sse2(_mm_loadu_ps(pSource + index + 4u));
+        _mm_storeu_si128((__m128i*)(pDestination + index), _mm_packs_epi32(low, high));
+    }
+
+    packFloat32ToFloat16Scalar(pSource + index, pDestination + index, count - index);
+}
+
+void packFloat32ToSnorm8Sse2(const float* pSource, int8_t* pDestination, const uint32_t count)
+{
+    const __m128 minValue   = _mm_set1_ps(-1.0f);
+    const __m128 scale      = _mm_set1_ps(127.0f);
+
+    uint32_t index = 0u;
+    for(; index + 16u <= count; index += 16u)
+    {
+        const __m128i value0 = convertFloat32ToNormalizedSse2(_mm_loadu_ps(pSource + index), minValue, scale);
+        const __m128i value1 = convertFloat32ToNormalizedSse2(_mm_loadu_ps(pSource + index + 4u), minValue, scale);
+        const __m128i value2 = convertFloat32ToNormalizedSse2(_mm_loadu_ps(pSource + index + 8u), minValue, scale);
+        const __m128i value3 = convertFloat32ToNormalizedSse2(_mm_loadu_ps(pSource + index + 12u), minValue, scale);
+        const __m128i packed = _mm_packs_epi16(_mm_packs_epi32(value0, value1), _mm_packs_epi32(value2, value3));
+        _mm_storeu_si128((__m128i*)(pDestination + index), packed);
+    }
+
+    packFloat32ToSnorm8Scalar(pSource + index, pDestination + index, count - index);
+}
+
+void packFloat32ToUnorm8Sse2(const float* pSource, uint8_t* pDestination, const uint32_t count)
+{
+    const __m128 minValue   = _mm_setzero_ps();
+    const __m128 scale      = _mm_set1_ps(255.0f);
+
+    uint32_t index = 0u;
+    for(; index + 16u <= count; index += 16u)
+    {
+        const __m128i value0 = convertFloat32ToNormalizedSse2(_mm_loadu_ps(pSource + index), minValue, scale);
+        const __m128i value1 = convertFloat32ToNormalizedSse2(_mm_loadu_ps(pSource + index + 4u), minValue, scale);
+        const __m128i value2 = convertFloat32ToNormalizedSse2(_mm_loadu_ps(pSource + index + 8u), minValue, scale);
+        const __m128i value3 = convertFloat32ToNormalizedSse2(_mm_loadu_ps(pSource + index + 12u), minValue, scale);
+        const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(value0, value1), _mm_packs_epi32(value2, value3));
+        _mm_storeu_si128((__m128i*)(pDestination + index), packed);
+    }
+
+    packFloat32ToUnorm8Scalar(pSource + index, pDestination + index, count - index);
+}
+
+void packFloat32ToSnorm16Sse2(const float* pSource, int16_t* pDestination, const uint32_t count)
+{
+    const __m128 minValue   = _mm_set1_ps(-1.0f);
+    const __m128 scale      = _mm_set1_ps(32767.0f);
+
+    uint32_t index = 0u;
+    for(; index + 8u <= count; index += 8u)
+    {
+        const __m128i value0 = convertFloat32ToNormalizedSse2(_mm_loadu_ps(pSource + index), minValue, scale);
+        const __m128i value1 = convertFloat32ToNormalizedSse2(_mm_loadu_ps(pSource + index + 4u), minValue, scale);
+        _mm_storeu_si128((__m128i*)(pDestination + index), _mm_packs_epi32(value0, value1));
+    }
+
+    packFloat32ToSnorm16Scalar(pSource + index, pDestination + index, count - index);
+}
+
+void packFloat32ToRgb10a2Sse2(const float* pSource, uint32_t* pDestination, const uint32_t vertexCount)
+{
+    const __m128 minValue   = _mm_setzero_ps();
+    const __m128 colorScale = _mm_set1_ps(1023.0f);
+    const __m128 alphaScale = _mm_set1_ps(3.0f);
+
+    uint32_t vertexIndex = 0u;
+    for(; vertexIndex + 4u <= vertexCount; vertexIndex += 4u)
+    {
+        __m128 r = _mm_loadu_ps(pSource + vertexIndex * 4u);
+        __m128 g = _mm_loadu_ps(pSource + vertexIndex * 4u + 4u);
+        __m128 b = _mm_loadu_ps(pSource + vertexIndex * 4u + 8u);
+        __m128 a = _mm_loadu_ps(pSource + vertexIndex * 4u + 12u);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+
+        __m128i packed = convertFloat32ToNormalizedSse2(r, minValue, colorScale);
+        packed = _mm_or_si128(packed, _mm_slli_epi32(convertFloat32ToNormalizedSse2(g, minValue, colorScale), 10));
+        packed = _mm_or_si128(packed, _mm_slli_epi32(convertFloat32ToNormalizedSse2(b, minValue, colorScale), 20));
+        packed = _mm_or_si128(packed, _mm_slli_epi32(convertFloat32ToNormalizedSse2(a, minValue, alphaScale), 30));
+        _mm_storeu_si128((__m128i*)(pDestination + vertexIndex), packed);
+    }
+
+    packFloat32ToRgb10a2Scalar(pSource + vertexIndex * 4u, pDestination + vertexIndex, vertexCount - vertexIndex);
+}
+
+void encodeOctahedralNormalsSse2(const float* pSource, float* pDestination, const uint32_t vertexCount)
+{
+    const __m128 signMask       = _mm_castsi128_ps(_mm_set1_epi32((int32_t)0x80000000u));
+    const __m128 absoluteMask   = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 one            = _mm_set1_ps(1.0f);
+    const __m128 zero           = _mm_setzero_ps();
+
+    uint32_t vertexIndex = 0u;
+    for(; vertexIndex + 4u <= vertexCount; vertexIndex += 4u)
+    {
+        //FK: xyz xyz xyz xyz -> xxxx yyyy zzzz
+        const __m128 xyzx = _mm_loadu_ps(pSource + vertexIndex * 3u);
+        const __m128 yzxy = _mm_loadu_ps(pSource + vertexIndex * 3u + 4u);
+        const __m128 zxyz = _mm_loadu_ps(pSource + vertexIndex * 3u + 8u);
+        const __m128 x = _mm_shuffle_ps(xyzx, _mm_shuffle_ps(yzxy, zxyz, _MM_SHUFFLE(1, 0, 3, 2)), _MM_SHUFFLE(3, 0, 3, 0));
+        const __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(xyzx, yzxy, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(yzxy, zxyz, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(xyzx, yzxy, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(zxyz, zxyz, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+
+        const __m128 absoluteSum = _mm_add_ps(_mm_add_ps(_mm_and_ps(x, absoluteMask), _mm_and_ps(y, absoluteMask)), _mm_and_ps(z, absoluteMask));
+        const __m128 inverseAbsoluteSum = _mm_and_ps(_mm_div_ps(one, absoluteSum), _mm_cmpgt_ps(absoluteSum, zero));
+        const __m128 projectedX = _mm_mul_ps(x, inverseAbsoluteSum);
+        const __m128 projectedY = _mm_mul_ps(y, inverseAbsoluteSum);
+
+        const __m128 foldedX = _mm_or_ps(_mm_sub_ps(one, _mm_and_ps(projectedY, absoluteMask)), _mm_and_ps(projectedX, signMask));
+        const __m128 foldedY = _mm_or_ps(_mm_sub_ps(one, _mm_and_ps(projectedX, absoluteMask)), _mm_and_ps(projectedY, signMask));
+        const __m128 isLowerHemisphere = _mm_cmplt_ps(z, zero);
+        const __m128 encodedX = _mm_or_ps(_mm_and_ps(isLowerHemisphere, foldedX), _mm_andnot_ps(isLowerHemisphere, projectedX));
+        const __m128 encodedY = _mm_or_ps(_mm_and_ps(isLowerHemisphere, foldedY), _mm_andnot_ps(isLowerHemisphere, projectedY));
+
+        _mm_storeu_ps(pDestination + vertexIndex * 2u, _mm_unpacklo_ps(encodedX, encodedY));
+        _mm_storeu_ps(pDestination + vertexIndex * 2u + 4u, _mm_unpackhi_ps(encodedX, encodedY));
+    }
+
+    encodeOctahedralNormalsScalar(pSource + vertexIndex * 3u, pDestination + vertexIndex * 2u, vertexCount - vertexIndex);
+}
+
+AVX2_TARGET_FUNCTION __m256i convertFloat32ToNormalizedAvx2(const __m256 value, const __m256 minValue, const __m256 scale)
+{
+    const __m256 withoutNan     = _mm256_and_ps(value, _mm256_cmp_ps(value, value, _CMP_ORD_Q));
+    const __m256 clampedValue   = _mm256_min_ps(_mm256_max_ps(withoutNan, minValue), _mm256_set1_ps(1.0f));
+    return _mm256_cvtps_epi32(_mm256_mul_ps(clampedValue, scale));
+}
+
+AVX2_TARGET_FUNCTION void packFloat32ToFloat16Avx2(const float* pSource, uint16_t* pDestination, const uint32_t count)
+{
+    uint32_t index = 0u;
+    for(; index + 16u <= count; index += 16u)
+    {
+        const __m128i low  = _mm256_cvtps_ph(_mm256_loadu_ps(pSource + index), _MM_FROUND_TO_NEAREST_INT);
+        const __m128i high = _mm256_cvtps_ph(_mm256_loadu_ps(pSource + index + 8u), _MM_FROUND_TO_NEAREST_INT);
+        _mm256_storeu_si256((__m256i*)(pDestination + index), _mm256_set_m128i(high, low));
+    }
+
+    packFloat32ToFloat16Sse2(pSource + index, pDestination + index, count - index);
+}
+
+//FK: The 256 bit packs work per 128 bit lane, the permutes restore the source order
+AVX2_TARGET_FUNCTION void packFloat32ToSnorm8Avx2(const float* pSource, int8_t* pDestination, const uint32_t count)
+{
+    const __m256  minValue       = _mm256_set1_ps(-1.0f);
+    const __m256  scale          = _mm256_set1_ps(127.0f);
+    const __m256i laneOrder      = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    uint32_t index = 0u;
+    for(; index + 32u <= count; index += 32u)
+    {
+        const __m256i value0 = convertFloat32ToNormalizedAvx2(_mm256_loadu_ps(pSource + index), minValue, scale);
+        const __m256i value1 = convertFloat32ToNormalizedAvx2(_mm256_loadu_ps(pSource + index + 8u), minValue, scale);
+        const __m256i value2 = convertFloat32ToNormalizedAvx2(_mm256_loadu_ps(pSource + index + 16u), minValue, scale);
+        const __m256i value3 = convertFloat32ToNormalizedAvx2(_mm256_loadu_ps(pSource + index + 24u), minValue, scale);
+        const __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(value0, value1), _mm256_packs_epi32(value2, value3));
+        _mm256_storeu_si256((__m256i*)(pDestination + index), _mm256_permutevar8x32_epi32(packed, laneOrder));
+    }
+
+    packFloat32ToSnorm8Sse2(pSource + index, pDestination + index, count - index);
+}
+
+AVX2_TARGET_FUNCTION void packFloat32ToUnorm8Avx2(const float* pSource, uint8_t* pDestination, const uint32_t count)
+{
+    const __m256  minValue       = _mm256_setzero_ps();
+    const __m256  scale          = _mm256_set1_ps(255.0f);
+    const __m256i laneOrder      = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    uint32_t index = 0u;
+    for(; index + 32u <= count; index += 32u)
+    {
+        const __m256i value0 = convertFloat32ToNormalizedAvx2(_mm256_loadu_ps(pSource + index), minValue, scale);
+        const __m256i value1 = convertFloat32ToNormalizedAvx2(_mm256_loadu_ps(pSource + index + 8u), minValue, scale);
+        const __m256i value2 = convertFloat32ToNormalizedAvx2(_mm256_loadu_ps(pSource + index + 16u), minValue, scale);
+        const __m256i value3 = convertFloat32ToNormalizedAvx2(_mm256_loadu_ps(pSource + index + 24u), minValue, scale);
+        const __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(value0, value1), _mm256_packs_epi32(value2, value3));
+        _mm256_storeu_si256((__m256i*)(pDestination + index), _mm256_permutevar8x32_epi32(packed, laneOrder));
+    }
+
+    packFloat32ToUnorm8Sse2(pSource + index, pDestination + index, count - index);
+}
+
+AVX2_TARGET_FUNCTION void packFloat32ToSnorm16Avx2(const float* pSource, int16_t* pDestination, const uint32_t count)
+{
+    const __m256 minValue   = _mm256_set1_ps(-1.0f);
+    const __m256 scale      = _mm256_set1_ps(32767.0f);
+
+    uint32_t index = 0u;
+    for(; index + 16u <= count; index += 16u)
+    {
+        const __m256i value0 = convertFloat32ToNormalizedAvx2(_mm256_loadu_ps(pSource + index), minValue, scale);
+        const __m256i value1 = convertFloat32ToNormalizedAvx2(_mm256_loadu_ps(pSource + index + 8u), minValue, scale);
+        const __m256i packed = _mm256_packs_epi32(value0, value1);
+        _mm256_storeu_si256((__m256i*)(pDestination + index), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    packFloat32ToSnorm16Sse2(pSource + index, pDestination + index, count - index);
+}
+
+//FK: Vertex n and n + 4 share a register so that the transpose can stay within the 128 bit lanes
+AVX2_TARGET_FUNCTION void packFloat32ToRgb10a2Avx2(const float* pSource, uint32_t* pDestination, const uint32_t vertexCount)
+{
+    const __m256 minValue   = _mm256_setzero_ps();
+    const __m256 colorScale = _mm256_set1_ps(1023.0f);
+    const __m256 alphaScale = _mm256_set1_ps(3.0f);
+
+    uint32_t vertexIndex = 0u;
+    for(; vertexIndex + 8u <= vertexCount; vertexIndex += 8u)
+    {
+        const float* pVertices = pSource + vertexIndex * 4u;
+        const __m256 vertex04 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pVertices)), _mm_loadu_ps(pVertices + 16u), 1);
+        const __m256 vertex15 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pVertices + 4u)), _mm_loadu_ps(pVertices + 20u), 1);
+        const __m256 vertex26 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pVertices + 8u)), _mm_loadu_ps(pVertices + 24u), 1);
+        const __m256 vertex37 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pVertices + 12u)), _mm_loadu_ps(pVertices + 28u), 1);
+
+        const __m256 rg01 = _mm256_unpacklo_ps(vertex04, vertex15);
+        const __m256 rg23 = _mm256_unpacklo_ps(vertex26, vertex37);
+        const __m256 ba01 = _mm256_unpackhi_ps(vertex04, vertex15);
+        const __m256 ba23 = _mm256_unpackhi_ps(vertex26, vertex37);
+        const __m256 r = _mm256_shuffle_ps(rg01, rg23, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 g = _mm256_shuffle_ps(rg01, rg23, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 b = _mm256_shuffle_ps(ba01, ba23, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 a = _mm256_shuffle_ps(ba01, ba23, _MM_SHUFFLE(3, 2, 3, 2));
+
+        __m256i packed = convertFloat32ToNormalizedAvx2(r, minValue, colorScale);
+        packed = _mm256_or_si256(packed, _mm256_slli_epi32(convertFloat32ToNormalizedAvx2(g, minValue, colorScale), 10));
+        packed = _mm256_or_si256(packed, _mm256_slli_epi32(convertFloat32ToNormalizedAvx2(b, minValue, colorScale), 20));
+        packed = _mm256_or_si256(packed, _mm256_slli_epi32(convertFloat32ToNormalizedAvx2(a, minValue, alphaScale), 30));
+        _mm256_storeu_si256((__m256i*)(pDestination + vertexIndex), packed);
+    }
+
+    packFloat32ToRgb10a2Sse2(pSource + vertexIndex * 4u, pDestination + vertexIndex, vertexCount - vertexIndex);
+}
+
+AVX2_TARGET_FUNCTION void encodeOctahedralNormalsAvx2(const float* pSource, float* pDestination, const uint32_t vertexCount)
+{
+    const __m256 signMask       = _mm256_castsi256_ps(_mm256_set1_epi32((int32_t)0x80000000u));
+    const __m256 absoluteMask   = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256 one            = _mm256_set1_ps(1.0f);
+    const __m256 zero           = _mm256_setzero_ps();
+
+    uint32_t vertexIndex = 0u;
+    for(; vertexIndex + 8u <= vertexCount; vertexIndex += 8u)
+    {
+        //FK: Same deinterleave as the SSE2 kernel, vertices 0-3 in the low lane and 4-7 in the high lane
+        const float* pNormals = pSource + vertexIndex * 3u;
+        const __m256 xyzx = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pNormals)), _mm_loadu_ps(pNormals + 12u), 1);
+        const __m256 yzxy = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pNormals + 4u)), _mm_loadu_ps(pNormals + 16u), 1);
+        const __m256 zxyz = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pNormals + 8u)), _mm_loadu_ps(pNormals + 20u), 1);
+        const __m256 x = _mm256_shuffle_ps(xyzx, _mm256_shuffle_ps(yzxy, zxyz, _MM_SHUFFLE(1, 0, 3, 2)), _MM_SHUFFLE(3, 0, 3, 0));
+        const __m256 y = _mm256_shuffle_ps(_mm256_shuffle_ps(xyzx, yzxy, _MM_SHUFFLE(0, 0, 1, 1)), _mm256_shuffle_ps(yzxy, zxyz, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        const __m256 z = _mm256_shuffle_ps(_mm256_shuffle_ps(xyzx, yzxy, _MM_SHUFFLE(1, 1, 2, 2)), _mm256_shuffle_ps(zxyz, zxyz, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+
+        const __m256 absoluteSum = _mm256_add_ps(_mm256_add_ps(_mm256_and_ps(x, absoluteMask), _mm256_and_ps(y, absoluteMask)), _mm256_and_ps(z, absoluteMask));
+        const __m256 inverseAbsoluteSum = _mm256_and_ps(_mm256_div_ps(one, absoluteSum), _mm256_cmp_ps(absoluteSum, zero, _CMP_GT_OQ));
+        const __m256 projectedX = _mm256_mul_ps(x, inverseAbsoluteSum);
+        const __m256 projectedY = _mm256_mul_ps(y, inverseAbsoluteSum);
+
+        const __m256 foldedX = _mm256_or_ps(_mm256_sub_ps(one, _mm256_and_ps(projectedY, absoluteMask)), _mm256_and_ps(projectedX, signMask));
+        const __m256 foldedY = _mm256_or_ps(_mm256_sub_ps(one, _mm256_and_ps(projectedX, absoluteMask)), _mm256_and_ps(projectedY, signMask));
+        const __m256 isLowerHemisphere = _mm256_cmp_ps(z, zero, _CMP_LT_OQ);
+        const __m256 encodedX = _mm256_blendv_ps(projectedX, foldedX, isLowerHemisphere);
+        const __m256 encodedY = _mm256_blendv_ps(projectedY, foldedY, isLowerHemisphere);
+
+        const __m256 encodedLow  = _mm256_unpacklo_ps(encodedX, encodedY);
+        const __m256 encodedHigh = _mm256_unpackhi_ps(encodedX, encodedY);
+        _mm256_storeu_ps(pDestination + vertexIndex * 2u, _mm256_permute2f128_ps(encodedLow, encodedHigh, 0x20));
+        _mm256_storeu_ps(pDestination + vertexIndex * 2u + 8u, _mm256_permute2f128_ps(encodedLow, encodedHigh, 0x31));
+    }
+
+    encodeOctahedralNormalsSse2(pSource + vertexIndex * 3u, pDestination + vertexIndex * 2u, vertexCount - vertexIndex);
+}
+#endif
+
+void packFloat32ToFloat16(const float* pSource, uint16_t* pDestination, const uint32_t count, const simd_level_t simdLevel)
+{
+#if USE_X64_SIMD_KERNELS
+    if(simdLevel == simd_level_avx2)
+    {
+        packFloat32ToFloat16Avx2(pSource, pDestination, count);
+        return;
+    }
+    else if(simdLevel == simd_level_sse2)
+    {
+        packFloat32ToFloat16Sse2(pSource, pDestination, count);
+        return;
+    }
+#endif
+    packFloat32ToFloat16Scalar(pSource, pDestination, count);
+}
+
+void packFloat32ToSnorm8(const float* pSource, int8_t* pDestination, const uint32_t count, const simd_level_t simdLevel)
+{
+#if USE_X64_SIMD_KERNELS
+    if(simdLevel == simd_level_avx2)
+    {
+        packFloat32ToSnorm8Avx2(pSource, pDestination, count);
+        return;
+    }
+    else if(simdLevel == simd_level_sse2)
+    {
+        packFloat32ToSnorm8Sse2(pSource, pDestination, count);
+        return;
+    }
+#endif
+    packFloat32ToSnorm8Scalar(pSource, pDestination, count);
+}
+
+void packFloat32ToUnorm8(const float* pSource, uint8_t* pDestination, const uint32_t count, const simd_level_t simdLevel)
+{
+#if USE_X64_SIMD_KERNELS
+    if(simdLevel == simd_level_avx2)
+    {
+        packFloat32ToUnorm8Avx2(pSource, pDestination, count);
+        return;
+    }
+    else if(simdLevel == simd_level_sse2)
+    {
+        packFloat32ToUnorm8Sse2(pSource, pDestination, count);
+        return;
+    }
+#endif
+    packFloat32ToUnorm8Scalar(pSource, pDestination, count);
+}
+
+void packFloat32ToSnorm16(const float* pSource, int16_t* pDestination, const uint32_t count, const simd_level_t simdLevel)
+{
+#if USE_X64_SIMD_KERNELS
+    if(simdLevel == simd_level_avx2)
+    {
+        packFloat32ToSnorm16Avx2(pSource, pDestination, count);
+        return;
+    }
+    else if(simdLevel == simd_level_sse2)
+    {
+        packFloat32ToSnorm16Sse2(pSource, pDestination, count);
+        return;
+    }
+#endif
+    packFloat32ToSnorm16Scalar(pSource, pDestination, count);
+}
+
+//FK: pSource holds 4 floats per vertex
+void packFloat32ToRgb10a2(const float* pSource, uint32_t* pDestination, const uint32_t vertexCount, const simd_level_t simdLevel)
+{
+#if USE_X64_SIMD_KERNELS
+    if(simdLevel == simd_level_avx2)
+    {
+        packFloat32ToRgb10a2Avx2(pSource, pDestination, vertexCount);
+        return;
+    }
+    else if(simdLevel == simd_level_sse2)
+    {
+        packFloat32ToRgb10a2Sse2(pSource, pDestination, vertexCount);
+        return;
+    }
+#endif
+    packFloat32ToRgb10a2Scalar(pSource, pDestination, vertexCount);
+}
+
+//FK: pSource holds 3 floats per vertex, pDestination receives 2 floats per vertex
+void encodeOctahedralNormals(const float* pSource, float* pDestination, const uint32_t vertexCount, const simd_level_t simdLevel)
+{
+#if USE_X64_SIMD_KERNELS
+    if(simdLevel == simd_level_avx2)
+    {
+        encodeOctahedralNormalsAvx2(pSource, pDestination, vertexCount);
+        return;
+    }
+    else if(simdLevel == simd_level_sse2)
+    {
+        encodeOctahedralNormalsSse2(pSource, pDestination, vertexCount);
+        return;
+    }
+#endif
+    encodeOctahedralNormalsScalar(pSource, pDestination, vertexCount);
+}
+
+//FK: Converts a tightly packed float stream with pAttribute->count floats per vertex into the attribute type and
+//    writes it to pDestination with the given stride, so attributes can be packed straight into an interleaved vertex buffer.
+void packVertexAttribute(const vertex_attribute_entry_t* pAttribute, const float* pSource, const uint32_t vertexCount, void* pDestination, const uint32_t destinationStrideInBytes, const simd_level_t simdLevel = getSupportedSimdLevel())
+{
+    ASSERT_DEBUG(isValidVertexAttribute(pAttribute));
+    ASSERT_DEBUG(simdLevel <= getSupportedSimdLevel());
+
+    const uint32_t storedComponentCount = getVertexAttributeStoredComponentCount(pAttribute->type, pAttribute->count);
+    const uint32_t attributeSizeInBytes = getVertexAttributeSizeInBytes(pAttribute);
+    const bool     needsPadding         = pAttribute->count == 3u && (storedComponentCount == 4u || pAttribute->type == vertex_attribute_type_t::rgb10a2);
+    const float    paddingValue         = pAttribute->type == vertex_attribute_type_t::rgb10a2 ? 1.0f : 0.0f;
+
+    float    intermediateChunk[vertexPackingChunkSizeInVertices * 4u];
+    uint32_t packedChunk[vertexPackingChunkSizeInVertices * 4u];
+
+    uint8_t* pDestinationBytes = (uint8_t*)pDestination;
+    for(uint32_t firstVertexIndex = 0u; firstVertexIndex < vertexCount; firstVertexIndex += vertexPackingChunkSizeInVertices)
+    {
+        const uint32_t chunkVertexCount = vertexCount - firstVertexIndex < vertexPackingChunkSizeInVertices ? vertexCount - firstVertexIndex : vertexPackingChunkSizeInVertices;
+        const float* pChunkSource = pSource + firstVertexIndex * pAttribute->count;
+        if(needsPadding)
+        {
+            for(uint32_t vertexIndex = 0u; vertexIndex < chunkVertexCount; ++vertexIndex)
+            {
+                intermediateChunk[vertexIndex * 4u + 0u] = pChunkSource[vertexIndex * 3u + 0u];
+                intermediateChunk[vertexIndex * 4u + 1u] = pChunkSource[vertexIndex * 3u + 1u];
+                intermediateChunk[vertexIndex * 4u + 2u] = pChunkSource[vertexIndex * 3u + 2u];
+                intermediateChunk[vertexIndex * 4u + 3u] = paddingValue;
+            }
+
+            pChunkSource = intermediateChunk;
+        }
+
+        const uint32_t chunkComponentCount = chunkVertexCount * storedComponentCount;
+        switch(pAttribute->type)
+        {
+            case vertex_attribute_type_t::float32:
+                memcpy(packedChunk, pChunkSource, chunkVertexCount * attributeSizeInBytes);
+                break;
+            case vertex_attribute_type_t::float16:
+                packFloat32ToFloat16(pChunkSource, (uint16_t*)packedChunk, chunkComponentCount, simdLevel);
+                break;
+            case vertex_attribute_type_t::snorm8:
+                packFloat32ToSnorm8(pChunkSource, (int8_t*)packedChunk, chunkComponentCount, simdLevel);
+                break;
+            case vertex_attribute_type_t::unorm8:
+                packFloat32ToUnorm8(pChunkSource, (uint8_t*)packedChunk, chunkComponentCount, simdLevel);
+                break;
+            case vertex_attribute_type_t::snorm16:
+                packFloat32ToSnorm16(pChunkSource, (int16_t*)packedChunk, chunkComponentCount, simdLevel);
+                break;
+            case vertex_attribute_type_t::rgb10a2:
+                packFloat32ToRgb10a2(pChunkSource, packedChunk, chunkVertexCount, simdLevel);
+                break;
+            case vertex_attribute_type_t::octahedral8:
+                encodeOctahedralNormals(pChunkSource, intermediateChunk, chunkVertexCount, simdLevel);
+                packFloat32ToSnorm8(intermediateChunk, (int8_t*)packedChunk, chunkComponentCount, simdLevel);
+                break;
+            case vertex_attribute_type_t::octahedral16:
+                encodeOctahedralNormals(pChunkSource, intermediateChunk, chunkVertexCount, simdLevel);
+                packFloat32ToSnorm16(intermediateChunk, (int16_t*)packedChunk, chunkComponentCount, simdLevel);
+                break;
+            default:
+                ASSERT_DEBUG_UNREACHABLE_CODE();
+                break;
+        }
+
+        if(destinationStrideInBytes == attributeSizeInBytes)
+        {
+            memcpy(pDestinationBytes, packedChunk, chunkVertexCount * attributeSizeInBytes);
+        }
+        else
+        {
+            const uint8_t* pPackedBytes = (const uint8_t*)packedChunk;
+            for(uint32_t vertexIndex = 0u; vertexIndex < chunkVertexCount; ++vertexIndex)
+            {
+                memcpy(pDestinationBytes + vertexIndex * destinationStrideInBytes, pPackedBytes + vertexIndex * attributeSizeInBytes, attributeSizeInBytes);
+            }
+        }
+
+        pDestinationBytes += chunkVertexCount * destinationStrideInBytes;
+    }
+}
+
+//FK: ppAttributeSources holds one float stream per attribute of the vertex format, see packVertexAttribute()
+void packVertices(const vertex_format_t* pVertexFormat, const float* const* ppAttributeSources, const uint32_t vertexCount, void* pDestination, const simd_level_t simdLevel = getSupportedSimdLevel())
+{
+    for(uint32_t attributeIndex = 0u; attributeIndex < pVertexFormat->vertexAttributeCount; ++attributeIndex)
+    {
+        uint8_t* pAttributeDestination = (uint8_t*)pDestination + pVertexFormat->attributeOffsetsInBytes[attributeIndex];
+        packVertexAttribute(pVertexFormat->pVertexAttributes + attributeIndex, ppAttributeSources[attributeIndex], vertexCount, pAttributeDestination, pVertexFormat->strideInBytes, simdLevel);
+    }
+}
+
+const char* getVertexAttributeSemanticName(const vertex_attribute_t attribute)
+{
+    switch(attribute)
+    {
+        case vertex_attribute_t::position:
+            return "POSITION";
+        case vertex_attribute_t::color:
+            return "COLOR";
+        default:
+            DebugBreak();
+    }
+
+    UNREACHABLE_CODE();
+    return nullptr;
+}
+
+bool areStringsEqualIgnoringCase(const char* pStringA, const char* pStringB)
+{
+    while(*pStringA && *pStringB)
+    {
+        const char characterA = (*pStringA >= 'a' && *pStringA <= 'z') ? *pStringA - ('a' - 'A') : *pStringA;
+        const char characterB = (*pStringB >= 'a' && *pStringB <= 'z') ? *pStringB - ('a' - 'A') : *pStringB;
+        if(characterA != characterB)
+        {
+            return false;
+        }
+
+        ++pStringA;
+        ++pStringB;
+    }
+
+    return *pStringA == *pStringB;
+}
+
+//FK: HLSL semantics are case insensitive. Returns invalidVertexAttribute for semantics that don't name a vertex attribute.
+uint8_t findVertexAttributeBySemanticName(const char* pSemanticName)
+{
+    const vertex_attribute_t attributes[] = {vertex_attribute_t::position, vertex_attribute_t::color};
+    for(const vertex_attribute_t attribute : attributes)
+    {
+        if(areStringsEqualIgnoringCase(getVertexAttributeSemanticName(attribute), pSemanticName))
+        {
+            return attribute;
+        }
+    }
+
+    return invalidVertexAttribute;
+}
+
+DXGI_FORMAT getVertexAttributeFormat(const vertex_attribute_type_t attributeType, const uint32_t count)
+{
+    ASSERT_DEBUG(count > 0u && count <= 4u);
+    switch(attributeType)
+    {
+        case vertex_attribute_type_t::float32:
+        {
+            const DXGI_FORMAT formats[] = {DXGI_FORMAT_R32_FLOAT, DXGI_FORMAT_R32G32_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT};
+            return formats[count - 1u];
+        }
+        case vertex_attribute_type_t::float16:
+        {
+            const DXGI_FORMAT formats[] = {DXGI_FORMAT_R16_FLOAT, DXGI_FORMAT_R16G16_FLOAT, DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_R16G16B16A16_FLOAT};
+            return formats[count - 1u];
+        }
+        case vertex_attribute_type_t::snorm8:
+        {
+            const DXGI_FORMAT formats[] = {DXGI_FORMAT_R8_SNORM, DXGI_FORMAT_R8G8_SNORM, DXGI_FORMAT_R8G8B8A8_SNORM, DXGI_FORMAT_R8G8B8A8_SNORM};
+            return formats[count - 1u];
+        }
+        case vertex_attribute_type_t::unorm8:
+        {
+            const DXGI_FORMAT formats[] = {DXGI_FORMAT_R8_UNORM, DXGI_FORMAT_R8G8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM};
+            return formats[count - 1u];
+        }
+        case vertex_attribute_type_t::snorm16:
+        {
+            const DXGI_FORMAT formats[] = {DXGI_FORMAT_R16_SNORM, DXGI_FORMAT_R16G16_SNORM, DXGI_FORMAT_R16G16B16A16_SNORM, DXGI_FORMAT_R16G16B16A16_SNORM};
+            return formats[count - 1u];
+        }
+        case vertex_attribute_type_t::rgb10a2:
+            return DXGI_FORMAT_R10G10B10A2_UNORM;
+        case vertex_attribute_type_t::octahedral8:
+            return DXGI_FORMAT_R8G8_SNORM;
+        case vertex_attribute_type_t::octahedral16:
+            return DXGI_FORMAT_R16G16_SNORM;
+        default:
+            DebugBreak();
+    }
+
+    UNREACHABLE_CODE();
+    return DXGI_FORMAT_UNKNOWN;
+}
+
+uint64_t calculateVertexFormatHash(const vertex_format_t* pVertexFormat, uint64_t hash)
+{
+    hash = calculateHash(&pVertexFormat->vertexAttributeCount, sizeof(pVertexFormat->vertexAttributeCount), hash);
+    for(uint32_t attributeIndex = 0u; attributeIndex < pVertexFormat->vertexAttributeCount; ++attributeIndex)
+    {
+        const vertex_attribute_entry_t* pAttribute = pVertexFormat->pVertexAttributes + attributeIndex;
+        hash = calculateHash(&pAttribute->attribute, sizeof(pAttribute->attribute), hash);
+        hash = calculateHash(&pAttribute->type, sizeof(pAttribute->type), hash);
+        hash = calculateHash(&pAttribute->count, sizeof(pAttribute->count), hash);
+    }
+
+    return hash;
+}
+
+//FK: Attributes are tightly packed into vertex buffer slot 0 in the order of the vertex format.
+void initVertexFormat(vertex_format_t* pOutVertexFormat, const vertex_attribute_entry_t* pVertexAttributes, const uint32_t vertexAttributeCount)
+{
+    ASSERT_DEBUG(vertexAttributeCount > 0u && vertexAttributeCount <= maxVertexAttributeCount);
+
+    clearMemoryWithZeroes(pOutVertexFormat);
+    memcpy(pOutVertexFormat->pVertexAttributes, pVertexAttributes, sizeof(vertex_attribute_entry_t) * vertexAttributeCount);
+    pOutVertexFormat->vertexAttributeCount = vertexAttributeCount;
+
+    uint32_t offsetInBytes = 0u;
+    for(uint32_t attributeIndex = 0u; attributeIndex < vertexAttributeCount; ++attributeIndex)
+    {
+        const vertex_attribute_entry_t* pAttribute = pVertexAttributes + attributeIndex;
+
+        uint32_t semanticIndex = 0u;
+        for(uint32_t previousAttributeIndex = 0u; previousAttributeIndex < attributeIndex; ++previousAttributeIndex)
+        {
+            if(pVertexAttributes[previousAttributeIndex].attribute == pAttribute->attribute)
+            {
+                ++semanticIndex;
+            }
+        }
+
+        D3D12_INPUT_ELEMENT_DESC* pInputElementDesc = pOutVertexFormat->inputElementDescs + attributeIndex;
+        pInputElementDesc->SemanticName         = getVertexAttributeSemanticName(pAttribute->attribute);
+        pInputElementDesc->SemanticIndex        = semanticIndex;
+        pInputElementDesc->Format               = getVertexAttributeFormat(pAttribute->type, pAttribute->count);
+        pInputElementDesc->InputSlot            = 0u;
+        pInputElementDesc->AlignedByteOffset    = offsetInBytes;
+        pInputElementDesc->InputSlotClass       = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+        pInputElementDesc->InstanceDataStepRate = 0u;
+
+        pOutVertexFormat->attributeOffsetsInBytes[attributeIndex] = offsetInBytes;
+        offsetInBytes += getVertexAttributeSizeInBytes(pAttribute);
+    }
+
+    pOutVertexFormat->strideInBytes = offsetInBytes;
+    pOutVertexFormat->hash          = calculateVertexFormatHash(pOutVertexFormat, fnv1aOffsetBasis);
+}
+
+//FK: With reflection data of the vertex shader only the attributes that the shader reads get an input element, in the order of the shader inputs.
+//    Returns false if the shader reads an attribute that the vertex format doesn't have.
+bool fillInputElementDescs(const vertex_format_t* pVertexFormat, const shader_reflection_t* pVertexShaderReflection, D3D12_INPUT_ELEMENT_DESC* pOutInputElementDescs, uint32_t* pOutInputElementCount)
+{
+    if(!pVertexShaderReflection->isValid)
+    {
+        memcpy(pOutInputElementDescs, pVertexFormat->inputElementDescs, sizeof(D3D12_INPUT_ELEMENT_DESC) * pVertexFormat->vertexAttributeCount);
+        *pOutInputElementCount = pVertexFormat->vertexAttributeCount;
+        return true;
+    }
+
+    for(uint32_t inputIndex = 0u; inputIndex < pVertexShaderReflection->inputAttributeCount; ++inputIndex)
+    {
+        const shader_input_attribute_t* pInputAttribute = pVertexShaderReflection->inputAttributes + inputIndex;
+
+        uint32_t attributeIndex = 0u;
+        uint32_t semanticIndex = 0u;
+        for(; attributeIndex < pVertexFormat->vertexAttributeCount; ++attributeIndex)
+        {
+            if(pVertexFormat->pVertexAttributes[attributeIndex].attribute == pInputAttribute->attribute && semanticIndex++ == pInputAttribute->semanticIndex)
+            {
+                break;
+            }
+        }
+
+        if(attributeIndex == pVertexFormat->vertexAttributeCount)
+        {
+            logError("Vertex shader input %u (%s%u) is missing in the vertex format.", inputIndex, 
+                pInputAttribute->attribute != invalidVertexAttribute ? getVertexAttributeSemanticName((vertex_attribute_t)pInputAttribute->attribute) : "unknown semantic ", pInputAttribute->semanticIndex);
+            return false;
+        }
+
+        pOutInputElementDescs[inputIndex] = pVertexFormat->inputElementDescs[attributeIndex];
+    }
+
+    *pOutInputElementCount = pVertexShaderReflection->inputAttributeCount;
+    return true;
+}
+
+void bindVertexBuffer(render_pass_t* pRenderPass, const vertex_buffer_handle_t vertexBufferHandle, const vertex_format_handle_t vertexFormatHandle, uint32_t slotIndex)
+{
+    ASSERT_DEBUG(slotIndex < maxCachedVertexBufferSlotCount);
+
+    //FK: Handles are generational, so equal handles always refer to the same buffer and format.
+    //    This skips the handle lookups and the stride calculation as well.
+    vertex_buffer_binding_t vertexBufferBinding = {};
+    vertexBufferBinding.vertexBuffer = vertexBufferHandle;
+    vertexBufferBinding.vertexFormat = vertexFormatHandle;
+    if(!hasCachedStateChanged(&pRenderPass->stateCache, &pRenderPass->stateCache.vertexBufferBindings[slotIndex], vertexBufferBinding))
+    {
+        return;
+    }
+
+    const vertex_buffer_t* pVertexBuffer = getVertexBuffer(pRenderPass->pRenderResourceCache, vertexBufferHandle);
+    const vertex_format_t* pVertexFormat = getVertexFormat(pRenderPass->pRenderResourceCache, vertexFormatHandle);
+    ASSERT_DEBUG_MSG(pVertexBuffer != nullptr && pVertexFormat != nullptr, "Stale or invalid vertex buffer/vertex format handle.");
+
+    D3D12_VERTEX_BUFFER_VIEW vertexBufferView = {};
+    vertexBufferView.BufferLocation = pVertexBuffer->bufferResource.pResource->GetGPUVirtualAddress();
+    vertexBufferView.SizeInBytes    = pVertexBuffer->sizeInBytes;
+    vertexBufferView.StrideInBytes  = pVertexFormat->strideInBytes;
+    pRenderPass->pGraphicsCommandList->IASetVertexBuffers(slotIndex, 1u, &vertexBufferView);
+
+    if(pVertexBuffer->uploadFenceValue > pRenderPass->uploadFenceValueToWaitFor)
+    {
+        pRenderPass->uploadFenceValueToWaitFor = pVertexBuffer->uploadFenceValue;
+    }
+}
+
+void setBindlessDescriptorTables(render_pass_t* pRenderPass)
+{
+    D3D12_GPU_DESCRIPTOR_HANDLE heapStart = {};
+    heapStart.ptr = (UINT64)pRenderPass->pShaderVisibleDescriptorHeap->pGPUBaseAddress;
+    pRenderPass->pGraphicsCommandList->SetGraphicsRootDescriptorTable(bindless_root_parameter_srv_table, heapStart);
+    pRenderPass->pGraphicsCommandList->SetGraphicsRootDescriptorTable(bindless_root_parameter_cbv_table, heapStart);
+    pRenderPass->pGraphicsCommandList->SetGraphicsRootDescriptorTable(bindless_root_parameter_uav_table, heapStart);
+}
+
+//FK: The pipeline state cache lock has to be held, see setPipelineState()
+void bindPipelineState(render_pass_t* pRenderPass, const graphics_pipeline_state_handle_t pipelineStateHandle, const graphics_pipeline_state_t* pPipelineState)
+{
+    ASSERT_DEBUG(pPipelineState != nullptr);
+    ASSERT_DEBUG(pPipelineState->pPipelineState != nullptr);
+
+    pRenderPass->skipDraws = false;
+    pRenderPass->drawConstantCount = pPipelineState->drawConstantCount;
+
+    //FK: The render pass only keeps the handle, bindings that get resolved after this call are read from the copy
+    if(pRenderPass->pipelineState.index != pipelineStateHandle.index || pRenderPass->pipelineState.generation != pipelineStateHandle.generation)
+    {
+        pRenderPass->pipelineState = pipelineStateHandle;
+        pRenderPass->rootParameterBindingCount = pPipelineState->rootParameterBindingCount;
+        memcpy(pRenderPass->rootParameterBindings, pPipelineState->rootParameterBindings, sizeof(root_parameter_binding_t) * pPipelineState->rootParameterBindingCount);
+    }
+
+    render_pass_state_cache_t* pStateCache = &pRenderPass->stateCache;
+    if(hasCachedStateChanged(pStateCache, &pStateCache->pPipelineState, (const ID3D12PipelineState*)pPipelineState->pPipelineState))
+    {
+        pRenderPass->pGraphicsCommandList->SetPipelineState(pPipelineState->pPipelineState);
+    }
+
+    if(hasCachedStateChanged(pStateCache, &pStateCache->pRootSignature, (const ID3D12RootSignature*)pPipelineState->pRootSignature))
+    {
+        pRenderPass->pGraphicsCommandList->SetGraphicsRootSignature(pPipelineState->pRootSignature);
+
+        //FK: Changing the root signature resets all root arguments
+        pStateCache->unknownDrawConstantMask = ~0u;
+        if(pPipelineState->isBindless)
+        {
+            setBindlessDescriptorTables(pRenderPass);
+        }
+    }
+}
+
+//FK: Binds a pipeline state that is ready, see trySetPipelineState() for pipeline states that might still be compiling
+void setPipelineState(render_pass_t* pRenderPass, const graphics_pipeline_state_handle_t pipelineStateHandle)
+{
+    ASSERT_DEBUG(pRenderPass != nullptr);
+
+    //FK: Pipeline states only get written with the lock held exclusively, reading them is fine for parallel render passes
+    pipeline_state_cache_t* pPipelineStateCache = &pRenderPass->pRenderResourceCache->pipelineStateCache;
+    AcquireSRWLockShared(&pPipelineStateCache->lock);
+
+    const graphics_pipeline_state_t* pPipelineState = getPipelineState(pRenderPass->pRenderResourceCache, pipelineStateHandle);
+    if(pPipelineState == nullptr || pPipelineState->status != pipeline_state_status_ready)
+    {
+        ReleaseSRWLockShared(&pPipelineStateCache->lock);
+        logError("Can't set pipeline state, the handle is stale or the pipeline state isn't ready.");
+        pRenderPass->skipDraws = true;
+        return;
+    }
+
+    bindPipelineState(pRenderPass, pipelineStateHandle, pPipelineState);
+    ReleaseSRWLockShared(&pPipelineStateCache->lock);
+}
+
+//FK: Per draw data that is small enough to live in the root signature, e.g. object or material indices. Only the range of
+//    constants that differs from what has been set before gets recorded. Root arguments get reset when the root signature
+//    changes, so this has to be called after setPipelineState().
+void setDrawConstants(render_pass_t* pRenderPass, const uint32_t* pConstants, const uint32_t constantCount, const uint32_t firstConstantIndex = 0u)
+{
+    ASSERT_DEBUG(pRenderPass != nullptr);
+    ASSERT_DEBUG(pConstants != nullptr);
+    ASSERT_DEBUG(constantCount > 0u && firstConstantIndex + constantCount <= pRenderPass->drawConstantCount);
+
+    render_pass_state_cache_t* pStateCache = &pRenderPass->stateCache;
+    uint32_t firstChangedIndex = constantCount;
+    uint32_t lastChangedIndex = 0u;
+    for(uint32_t constantIndex = 0u; constantIndex < constantCount; ++constantIndex)
+    {
+        const uint32_t cachedConstantIndex = firstConstantIndex + constantIndex;
+        const bool isKnown = (pStateCache->unknownDrawConstantMask & (1u << cachedConstantIndex)) == 0u;
+        if(isKnown && pStateCache->drawConstants[cachedConstantIndex] == pConstants[constantIndex])
+        {
+            continue;
+        }
+
+        pStateCache->drawConstants[cachedConstantIndex] = pConstants[constantIndex];
+        firstChangedIndex = firstChangedIndex < constantIndex ? firstChangedIndex : constantIndex;
+        lastChangedIndex = constantIndex;
+    }
+
+    if(firstChangedIndex == constantCount)
+    {
+        ++pStateCache->statistics.skippedCallCount;
+        return;
+    }
+
+    pStateCache->unknownDrawConstantMask &= ~(((1u << constantCount) - 1u) << firstConstantIndex);
+    ++pStateCache->statistics.issuedCallCount;
+
+    //FK: Unchanged constants in between get set again, one call is cheaper than splitting the range
+    const uint32_t changedConstantCount = lastChangedIndex - firstChangedIndex + 1u;
+    pRenderPass->pGraphicsCommandList->SetGraphicsRoot32BitConstants(drawConstantsRootParameterIndex, changedConstantCount, pConstants + firstChangedIndex, firstConstantIndex + firstChangedIndex);
+}
+
+template<typename T>
+void setDrawConstants(render_pass_t* pRenderPass, const T& constants)
+{
+    static_assert(sizeof(T) % sizeof(uint32_t) == 0u && sizeof(T) <= maxDrawConstantCount * sizeof(uint32_t), "Draw constants have to be made of up to maxDrawConstantCount 32 bit values");
+    setDrawConstants(pRenderPass, (const uint32_t*)&constants, (uint32_t)(sizeof(T) / sizeof(uint32_t)));
+}
+
+//FK: Per draw data of bindless pipeline states, usually descriptor indices
+void setBindlessDrawConstants(render_pass_t* pRenderPass, const uint32_t* pConstants, const uint32_t constantCount)
+{
+    ASSERT_DEBUG(constantCount <= bindlessDrawConstantCount);
+    setDrawConstants(pRenderPass, pConstants, constantCount);
+}
+
+const root_parameter_binding_t* findRootParameterBinding(const root_parameter_binding_t* pBindings, const uint32_t bindingCount, const shader_resource_binding_type_t type, const uint32_t shaderRegister, const uint32_t registerSpace)
+{
+    for(uint32_t bindingIndex = 0u; bindingIndex < bindingCount; ++bindingIndex)
+    {
+        const root_parameter_binding_t* pBinding = pBindings + bindingIndex;
+        if(pBinding->type == type && pBinding->registerSpace == registerSpace && shaderRegister >= pBinding->shaderRegister &&
+           (pBinding->descriptorCount == std::numeric_limits<uint32_t>::max() || shaderRegister - pBinding->shaderRegister < pBinding->descriptorCount))
+        {
+            return pBinding;
+        }
+    }
+
+    return nullptr;
+}
+
+//FK: Looks up the root constants, root descriptor or descriptor range that a register is bound to, nullptr if the root
+//    signature doesn't bind the register. Only valid once the pipeline state is ready.
+const root_parameter_binding_t* getRootParameterBinding(const graphics_pipeline_state_t* pPipelineState, const shader_resource_binding_type_t type, const uint32_t shaderRegister, const uint32_t registerSpace)
+{
+    ASSERT_DEBUG(pPipelineState != nullptr);
+    return findRootParameterBinding(pPipelineState->rootParameterBindings, pPipelineState->rootParameterBindingCount, type, shaderRegister, registerSpace);
+}
+
+//FK: Root parameter index of a register, e.g. to pass the root CBVs and tables of generated root signatures to
+//    setConstantBuffer() and setDescriptorTable(). Returns invalidRootParameterIndex if the register isn't bound.
+uint32_t getRootParameterIndex(const graphics_pipeline_state_t* pPipelineState, const shader_resource_binding_type_t type, const uint32_t shaderRegister, const uint32_t registerSpace)
+{
+    const root_parameter_binding_t* pBinding = getRootParameterBinding(pPipelineState, type, shaderRegister, registerSpace);
+    return pBinding != nullptr ? pBinding->rootParameterIndex : invalidRootParameterIndex;
+}
+
+//FK: Position of a register's descriptor relative to the start of its descriptor table, invalidDescriptorIndex if the
+//    register isn't part of a descriptor table
+uint32_t getDescriptorTableOffset(const graphics_pipeline_state_t* pPipelineState, const shader_resource_binding_type_t type, const uint32_t shaderRegister, const uint32_t registerSpace)
+{
+    const root_parameter_binding_t* pBinding = getRootParameterBinding(pPipelineState, type, shaderRegister, registerSpace);
+    if(pBinding == nullptr || pBinding->parameterType != D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE)
+    {
+        return invalidDescriptorIndex;
+    }
+
+    return pBinding->offsetInDescriptorsFromTableStart + shaderRegister - pBinding->shaderRegister;
+}
+
+//FK: Binds descriptors of the shader visible heaps, e.g. from allocateFrameDescriptors() or for sampler tables from
+//    the render context's samplerDescriptorAllocator, to a descriptor table. The handle points at the start of the table.
+void setDescriptorTable(render_pass_t* pRenderPass, const uint32_t rootParameterIndex, const D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor)
+{
+    ASSERT_DEBUG(pRenderPass != nullptr);
+    ASSERT_DEBUG(rootParameterIndex != invalidRootParameterIndex);
+    ASSERT_DEBUG(baseDescriptor.ptr != 0u);
+    pRenderPass->pGraphicsCommandList->SetGraphicsRootDescriptorTable(rootParameterIndex, baseDescriptor);
+}
+
+//FK: Binds constants allocated with allocateConstants() to a constant buffer register of the bound pipeline state.
+//    The register has to be a root CBV, generated root signatures make every constant buffer that isn't an array one.
+void setConstantBuffer(render_pass_t* pRenderPass, const uint32_t shaderRegister, const uint32_t registerSpace, const D3D12_GPU_VIRTUAL_ADDRESS gpuVirtualAddress)
+{
+    ASSERT_DEBUG(pRenderPass != nullptr);
+    ASSERT_DEBUG(!isInvalidResourceHandle(pRenderPass->pipelineState));
+    ASSERT_DEBUG(gpuVirtualAddress != 0u);
+    ASSERT_DEBUG((gpuVirtualAddress % constantBufferAlignmentInBytes) == 0u);
+
+    const root_parameter_binding_t* pBinding = findRootParameterBinding(pRenderPass->rootParameterBindings, pRenderPass->rootParameterBindingCount, shader_resource_binding_constant_buffer, shaderRegister, registerSpace);
+    if(pBinding == nullptr || pBinding->parameterType != D3D12_ROOT_PARAMETER_TYPE_CBV)
+    {
+        logError("Can't set constant buffer b%u, space%u. The bound pipeline state doesn't have a root CBV for it.", shaderRegister, registerSpace);
+        return;
+    }
+
+    pRenderPass->pGraphicsCommandList->SetGraphicsRootConstantBufferView(pBinding->rootParameterIndex, gpuVirtualAddress);
+}
+
+//FK: The pipeline state cache lock has to be held, the pipeline state table can grow while another thread creates a pipeline state
+const graphics_pipeline_state_t* getReadyPipelineState(render_pass_t* pRenderPass, const graphics_pipeline_state_handle_t pipelineStateHandle)
+{
+    graphics_pipeline_state_t* pPipelineState = getPipelineState(pRenderPass->pRenderResourceCache, pipelineStateHandle);
+    if(pPipelineState == nullptr || InterlockedCompareExchange(&pPipelineState->status, 0, 0) != pipeline_state_status_ready)
+    {
+        return nullptr;
+    }
+
+    return InterlockedCompareExchange(&pPipelineState->completionIndex, 0, 0) <= pRenderPass->pipelineStateCompletionIndex ? pPipelineState : nullptr;
+}
+
+//FK: Binds the pipeline state if it has been ready when the frame began and the fallback pipeline state (can be invalid) otherwise.
+//    Returns false if neither is ready, draws get skipped until the next pipeline state gets bound.
+bool trySetPipelineState(render_pass_t* pRenderPass, const graphics_pipeline_state_handle_t pipelineStateHandle, const graphics_pipeline_state_handle_t fallbackPipelineStateHandle)
+{
+    ASSERT_DEBUG(pRenderPass != nullptr);
+
+    //FK: Pipeline states only get written with the lock held exclusively, reading them is fine for parallel render passes
+    pipeline_state_cache_t* pPipelineStateCache = &pRenderPass->pRenderResourceCache->pipelineStateCache;
+    AcquireSRWLockShared(&pPipelineStateCache->lock);
+
+    graphics_pipeline_state_handle_t boundPipelineStateHandle = pipelineStateHandle;
+    const graphics_pipeline_state_t* pPipelineState = getReadyPipelineState(pRenderPass, pipelineStateHandle);
+    if(pPipelineState == nullptr)
+    {
+        boundPipelineStateHandle = fallbackPipelineStateHandle;
+        pPipelineState = getReadyPipelineState(pRenderPass, fallbackPipelineStateHandle);
+        if(pPipelineState == nullptr)
+        {
+            ReleaseSRWLockShared(&pPipelineStateCache->lock);
+            pRenderPass->skipDraws = true;
+            return false;
+        }
+
+        ++pRenderPass->pipelineStateReadinessStatistics.fallbackCount;
+    }
+
+    bindPipelineState(pRenderPass, boundPipelineStateHandle, pPipelineState);
+    ReleaseSRWLockShared(&pPipelineStateCache->lock);
+    return true;
+}
+
+void setViewport(render_pass_t* pRenderPass, const D3D12_VIEWPORT& viewport)
+{
+    if(hasCachedStateChanged(&pRenderPass->stateCache, &pRenderPass->stateCache.viewport, viewport))
+    {
+        pRenderPass->pGraphicsCommandList->RSSetViewports(1u, &viewport);
+    }
+}
+
+void setScissorRect(render_pass_t* pRenderPass, const D3D12_RECT& scissorRect)
+{
+    if(hasCachedStateChanged(&pRenderPass->stateCache, &pRenderPass->stateCache.scissorRect, scissorRect))
+    {
+        pRenderPass->pGraphicsCommandList->RSSetScissorRects(1u, &scissorRect);
+    }
+}
+
+void setPrimitiveTopology(render_pass_t* pRenderPass, const D3D12_PRIMITIVE_TOPOLOGY primitiveTopology)
+{
+    if(hasCachedStateChanged(&pRenderPass->stateCache, &pRenderPass->stateCache.primitiveTopology, primitiveTopology))
+    {
+        pRenderPass->pGraphicsCommandList->IASetPrimitiveTopology(primitiveTopology);
+    }
+}
+
+void setRenderTarget(render_pass_t* pRenderPass, const render_target_t* pRenderTarget)
+{
+    ASSERT_DEBUG(pRenderTarget != nullptr);
+
+    if(hasCachedStateChanged(&pRenderPass->stateCache, &pRenderPass->stateCache.renderTargetDescriptor, pRenderTarget->cpuDescriptorHandle))
+    {
+        pRenderPass->pGraphicsCommandList->OMSetRenderTargets(1u, &pRenderTarget->cpuDescriptorHandle, 0u, nullptr);
+    }
+}
+
+d3d12_resource_t* getRenderPassResource(render_pass_t* pRenderPass, render_target_t* pRenderTarget)
+{
+    if(pRenderTarget == pRenderPass->pRenderTarget)
+    {
+        return &pRenderPass->renderTargetResource;
+    }
+
+    //FK: Render targets other than the one of the pass are shared state, these can't be used by passes recorded in parallel
+    return &pRenderTarget->resource;
+}
+
+void clearColorRenderTarget(render_pass_t* pRenderPass, render_target_t* pRenderTarget, const float r, const float g, const float b, const float a)
+{
+    ASSERT_DEBUG(pRenderTarget != nullptr);
+    ASSERT_DEBUG(isColorRenderTarget(pRenderTarget));
+    ASSERT_DEBUG(pRenderPass != nullptr);
+    ASSERT_DEBUG(pRenderPass->isOpen);
+
+    const FLOAT colorValues[4] = {r, g, b, a};
+
+    transitionResource(&pRenderPass->barrierBatch, getRenderPassResource(pRenderPass, pRenderTarget), D3D12_RESOURCE_STATE_RENDER_TARGET);
+    flushResourceBarriers(&pRenderPass->barrierBatch);
+    pRenderPass->pGraphicsCommandList->ClearRenderTargetView(pRenderTarget->cpuDescriptorHandle, colorValues, 0, nullptr);
+}
+
+void drawInstanced(render_pass_t* pRenderPass, const uint32_t vertexCountPerInstance, const uint32_t instanceCount, const uint32_t startVertexLocation, const uint32_t startInstanceLocation)
+{
+    ASSERT_DEBUG(pRenderPass != nullptr);
+    ASSERT_DEBUG(pRenderPass->isOpen);
+
+    if(pRenderPass->skipDraws)
+    {
+        ++pRenderPass->pipelineStateReadinessStatistics.skippedDrawCount;
+        return;
+    }
+
+    flushResourceBarriers(&pRenderPass->barrierBatch);
+    pRenderPass->pGraphicsCommandList->DrawInstanced(vertexCountPerInstance, instanceCount, startVertexLocation, startInstanceLocation);
+}
+
+//FK: Handle indices that don't fit into their field only make the grouping worse, the queued draw keeps the whole handle
+uint64_t createDrawSortKey(const uint8_t layer, const graphics_pipeline_state_handle_t pipelineStateHandle, const vertex_buffer_handle_t vertexBufferHandle, const float normalizedDepth)
+{
+    const uint64_t maxDepthValue = (1ull << drawSortKeyDepthBitCount) - 1ull;
+    const float clampedDepth = normalizedDepth < 0.0f ? 0.0f : (normalizedDepth > 1.0f ? 1.0f : normalizedDepth);
+    const uint64_t depth = (uint64_t)(clampedDepth * (float)maxDepthValue);
+    const uint64_t vertexBuffer = vertexBufferHandle.index & ((1ull << drawSortKeyVertexBufferBitCount) - 1ull);
+    const uint64_t pipelineState = pipelineStateHandle.index & ((1ull << drawSortKeyPipelineStateBitCount) - 1ull);
+
+    return ((uint64_t)layer << (64u - drawSortKeyLayerBitCount)) |
+           (pipelineState << (drawSortKeyDepthBitCount + drawSortKeyVertexBufferBitCount)) |
+           (vertexBuffer << drawSortKeyDepthBitCount) |
+           depth;
+}
+
+void destroyDrawQueue(draw_queue_t* pDrawQueue)
+{
+    if(pDrawQueue->pDraws != nullptr)
+    {
+        freeFromAllocator(pDrawQueue->pMemoryAllocator, pDrawQueue->pDraws);
+    }
+
+    clearMemoryWithZeroes(pDrawQueue);
+}
+
+bool tryToGrowDrawQueue(draw_queue_t* pDrawQueue, memory_allocator_t* pMemoryAllocator)
+{
+    const uint32_t newCapacity = pDrawQueue->capacity == 0u ? initialDrawQueueCapacity : pDrawQueue->capacity * 2u;
+    const uint64_t drawsSizeInBytes = alignValue((uint64_t)newCapacity * sizeof(queued_draw_t), defaultAllocationAlignment);
+    const uint64_t sortEntriesSizeInBytes = (uint64_t)newCapacity * sizeof(draw_sort_entry_t);
+    uint8_t* pNewMemory = (uint8_t*)allocateFromAllocator(pMemoryAllocator, drawsSizeInBytes + sortEntriesSizeInBytes * 2u);
+    if(pNewMemory == nullptr)
+    {
+        return false;
+    }
+
+    draw_sort_entry_t* pNewSortEntries = (draw_sort_entry_t*)(pNewMemory + drawsSizeInBytes);
+    if(pDrawQueue->pDraws != nullptr)
+    {
+        copyMemoryNonOverlapping(pNewMemory, pDrawQueue->pDraws, (uint64_t)pDrawQueue->drawCount * sizeof(queued_draw_t));
+        copyMemoryNonOverlapping(pNewSortEntries, pDrawQueue->pSortEntries, (uint64_t)pDrawQueue->drawCount * sizeof(draw_sort_entry_t));
+        freeFromAllocator(pDrawQueue->pMemoryAllocator, pDrawQueue->pDraws);
+    }
+
+    pDrawQueue->pMemoryAllocator    = pMemoryAllocator;
+    pDrawQueue->pDraws              = (queued_draw_t*)pNewMemory;
+    pDrawQueue->pSortEntries        = pNewSortEntries;
+    pDrawQueue->pScratchSortEntries = pNewSortEntries + newCapacity;
+    pDrawQueue->capacity            = newCapacity;
+    return true;
+}
+
+//FK: Queued draws get sorted by their sort key (see createDrawSortKey()) and recorded in endRenderPass(), after everything that
+//    has been recorded on the render pass directly. Draws with equal sort keys keep the order they got queued in.
+bool queueDraw(render_pass_t* pRenderPass, const queued_draw_t& draw, const uint64_t sortKey)
+{
+    ASSERT_DEBUG(pRenderPass != nullptr);
+    ASSERT_DEBUG(pRenderPass->isOpen);
+    ASSERT_DEBUG(draw.drawConstantCount <= maxQueuedDrawConstantCount);
+
+    draw_queue_t* pDrawQueue = &pRenderPass->drawQueue;
+    if(pDrawQueue->drawCount == pDrawQueue->capacity && !tryToGrowDrawQueue(pDrawQueue, pRenderPass->pRenderResourceCache->pMemoryAllocator))
+    {
+        logError("Could not grow the draw queue of render pass '%s' beyond %u draws.", pRenderPass->pName, pDrawQueue->capacity);
+        return false;
+    }
+
+    const uint32_t drawIndex = pDrawQueue->drawCount++;
+    pDrawQueue->pDraws[drawIndex] = draw;
+    pDrawQueue->pSortEntries[drawIndex].sortKey     = sortKey;
+    pDrawQueue->pSortEntries[drawIndex].drawIndex   = drawIndex;
+    ++pDrawQueue->statistics.queuedDrawCount;
+    return true;
+}
+
+bool queueDraw(render_pass_t* pRenderPass, const queued_draw_t& draw, const uint8_t layer, const float normalizedDepth)
+{
+    return queueDraw(pRenderPass, draw, createDrawSortKey(layer, draw.pipelineState, draw.vertexBuffer, normalizedDepth));
+}
+
+//FK: LSD radix sort with 8 bit digits, stable. Digits that are equal for all keys (e.g. the layer if all draws are in
+//    the same layer) get skipped. Returns the buffer that contains the sorted entries.
+draw_sort_entry_t* radixSortDrawSortEntries(draw_sort_entry_t* pEntries, draw_sort_entry_t* pScratchEntries, const uint32_t entryCount, uint32_t* pOutSortPassCount)
+{
+    constexpr uint32_t digitCount = sizeof(uint64_t);
+    uint32_t histograms[digitCount][256];
+    memset(histograms, 0, sizeof(histograms));
+
+    //FK: All histograms in one pass over the keys
+    for(uint32_t entryIndex = 0u; entryIndex < entryCount; ++entryIndex)
+    {
+        const uint64_t sortKey = pEntries[entryIndex].sortKey;
+        for(uint32_t digitIndex = 0u; digitIndex < digitCount; ++digitIndex)
+        {
+            ++histograms[digitIndex][(sortKey >> (digitIndex * 8u)) & 0xFFu];
+        }
+    }
+
+    uint32_t sortPassCount = 0u;
+    for(uint32_t digitIndex = 0u; digitIndex < digitCount; ++digitIndex)
+    {
+        uint32_t* pHistogram = histograms[digitIndex];
+        if(pHistogram[(pEntries[0].sortKey >> (digitIndex * 8u)) & 0xFFu] == entryCount)
+        {
+            continue;
+        }
+
+        uint32_t offset = 0u;
+        for(uint32_t bucketIndex = 0u; bucketIndex < 256u; ++bucketIndex)
+        {
+            const uint32_t bucketCount = pHistogram[bucketIndex];
+            pHistogram[bucketIndex] = offset;
+            offset += bucketCount;
+        }
+
+        for(uint32_t entryIndex = 0u; entryIndex < entryCount; ++entryIndex)
+        {
+            const draw_sort_entry_t entry = pEntries[entryIndex];
+            pScratchEntries[pHistogram[(entry.sortKey >> (digitIndex * 8u)) & 0xFFu]++] = entry;
+        }
+
+        draw_sort_entry_t* pSortedEntries = pScratchEntries;
+        pScratchEntries = pEntries;
+        pEntries = pSortedEntries;
+        ++sortPassCount;
+    }
+
+    *pOutSortPassCount = sortPassCount;
+    return pEntries;
+}
+
+void recordQueuedDraws(render_pass_t* pRenderPass)
+{
+    draw_queue_t* pDrawQueue = &pRenderPass->drawQueue;
+    if(pDrawQueue->drawCount == 0u)
+    {
+        return;
+    }
+
+    uint32_t sortPassCount = 0u;
+    const draw_sort_entry_t* pSortedEntries = radixSortDrawSortEntries(pDrawQueue->pSortEntries, pDrawQueue->pScratchSortEntries, pDrawQueue->drawCount, &sortPassCount);
+    pDrawQueue->statistics.sortPassCount += sortPassCount;
+
+    //FK: Consecutive draws mostly share their pipeline state, so skip the lookup as well and not just the API call
+    const graphics_pipeline_state_handle_t invalidPipelineStateHandle = createInvalidResourceHandle<graphics_pipeline_state_handle_t>();
+    const queued_draw_t* pPreviousDraw = nullptr;
+    for(uint32_t entryIndex = 0u; entryIndex < pDrawQueue->drawCount; ++entryIndex)
+    {
+        const queued_draw_t* pDraw = pDrawQueue->pDraws + pSortedEntries[entryIndex].drawIndex;
+        if(pPreviousDraw == nullptr || pDraw->pipelineState.index != pPreviousDraw->pipelineState.index || pDraw->pipelineState.generation != pPreviousDraw->pipelineState.generation)
+        {
+            trySetPipelineState(pRenderPass, pDraw->pipelineState, invalidPipelineStateHandle);
+        }
+
+        pPreviousDraw = pDraw;
+
+        if(pRenderPass->skipDraws)
+        {
+            ++pRenderPass->pipelineStateReadinessStatistics.skippedDrawCount;
+            continue;
+        }
+
+        bindVertexBuffer(pRenderPass, pDraw->vertexBuffer, pDraw->vertexFormat, 0u);
+        if(pDraw->drawConstantCount > 0u)
+        {
+            setDrawConstants(pRenderPass, pDraw->drawConstants, pDraw->drawConstantCount);
+        }
+
+        drawInstanced(pRenderPass, pDraw->vertexCountPerInstance, pDraw->instanceCount, pDraw->startVertexLocation, pDraw->startInstanceLocation);
+    }
+
+    pDrawQueue->drawCount = 0u;
+}
+
+void endRenderPass(graphics_frame_t* pGraphicsFrame, render_pass_t* pRenderPass)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    ASSERT_DEBUG(pGraphicsFrame->openRenderPassCount > 0);
+    ASSERT_DEBUG(pRenderPass != nullptr);
+    ASSERT_DEBUG(pRenderPass->isOpen);
+
+    recordQueuedDraws(pRenderPass);
+
+    pRenderPass->isOpen = false;
+    InterlockedDecrement(&pGraphicsFrame->openRenderPassCount);
+
+    transitionResource(&pRenderPass->barrierBatch, &pRenderPass->renderTargetResource, pRenderPass->renderTargetEntryState);
+    flushResourceBarriers(&pRenderPass->barrierBatch);
+
+    addEndMarker(pRenderPass->pGraphicsCommandList);
+    COM_CALL(pRenderPass->pGraphicsCommandList->Close());
+}
+
+void executeRenderPass(graphics_frame_t* pGraphicsFrame, render_pass_t* pRenderPass)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    ASSERT_DEBUG(pRenderPass != nullptr);
+    ASSERT_DEBUG(!pRenderPass->isOpen);
+
+    AcquireSRWLockExclusive(&pGraphicsFrame->renderPassSubmitLock);
+
+    //FK: pNext still points into the free list of the render resource cache
+    pRenderPass->pNext = nullptr;
+
+    if(pGraphicsFrame->pLastRenderPassToExecute == nullptr)
+    {
+        pGraphicsFrame->pFirstRenderPassToExecute = pRenderPass;
+    }
+    else
+    {
+        pGraphicsFrame->pLastRenderPassToExecute->pNext = pRenderPass;
+    }
+
+    pGraphicsFrame->pLastRenderPassToExecute = pRenderPass;
+    ++pGraphicsFrame->renderPassToSubmitCount;
+
+    addResourceBarrierStatistics(&pGraphicsFrame->barrierStatistics, &pRenderPass->barrierBatch.statistics);
+    pGraphicsFrame->stateFilterStatistics.issuedCallCount += pRenderPass->stateCache.statistics.issuedCallCount;
+    pGraphicsFrame->stateFilterStatistics.skippedCallCount += pRenderPass->stateCache.statistics.skippedCallCount;
+    pGraphicsFrame->pipelineStateReadinessStatistics.fallbackCount += pRenderPass->pipelineStateReadinessStatistics.fallbackCount;
+    pGraphicsFrame->pipelineStateReadinessStatistics.skippedDrawCount += pRenderPass->pipelineStateReadinessStatistics.skippedDrawCount;
+
+    //FK: Let the GPU start working on the passes recorded so far while the remaining passes are still being recorded.
+    //    Passes that use uploads of this frame will wait on the GPU until the upload batch got submitted in finishFrame().
+    //    Passes only get submitted early once all passes with a lower sort index are executed, passes with explicit
+    //    sort indices that leave gaps therefore get submitted in finishFrame().
+    const uint32_t renderPassSubmitThreshold = pGraphicsFrame->renderPassSubmitThreshold;
+    if(renderPassSubmitThreshold > 0u && pGraphicsFrame->renderPassToSubmitCount >= renderPassSubmitThreshold && hasContiguousRenderPassesToSubmit(pGraphicsFrame, renderPassSubmitThreshold))
+    {
+        submitRenderPasses(pGraphicsFrame, nullptr, false);
+    }
+
+    ReleaseSRWLockExclusive(&pGraphicsFrame->renderPassSubmitLock);
+}
+
+typedef void(*record_render_pass_fnc)(render_pass_t* pRenderPass, void* pUserData);
+
+struct render_pass_job_t
+{
+    const char*             pName;
+    render_target_t*        pRenderTarget;  // nullptr = backbuffer
+    record_render_pass_fnc  pRecordFnc;
+    void*                   pUserData;
+};
+
+struct render_pass_job_context_t
+{
+    graphics_frame_t*           pGraphicsFrame;
+    const render_pass_job_t*    pJobs;
+    uint32_t                    jobCount;
+    uint32_t                    firstSortIndex;
+    volatile LONG               nextJobIndex;
+};
+
+void recordRenderPassJob(render_pass_job_context_t* pJobContext, const uint32_t jobIndex)
+{
+    const render_pass_job_t* pJob = pJobContext->pJobs + jobIndex;
+    render_pass_t* pRenderPass = startRenderPass(pJobContext->pGraphicsFrame, pJob->pName, pJob->pRenderTarget, pJobContext->firstSortIndex + jobIndex);
+    if(pRenderPass == nullptr)
+    {
+        return;
+    }
+
+    pJob->pRecordFnc(pRenderPass, pJob->pUserData);
+
+    endRenderPass(pJobContext->pGraphicsFrame, pRenderPass);
+    executeRenderPass(pJobContext->pGraphicsFrame, pRenderPass);
+}
+
+void CALLBACK recordRenderPassJobThreadpoolCallback(PTP_CALLBACK_INSTANCE pInstance, PVOID pContext, PTP_WORK pWork)
+{
+    UNUSED_PARAMETER(pInstance);
+    UNUSED_PARAMETER(pWork);
+
+    //FK: Every submission of the work object runs exactly one job
+    render_pass_job_context_t* pJobContext = (render_pass_job_context_t*)pContext;
+    const uint32_t jobIndex = (uint32_t)InterlockedIncrement(&pJobContext->nextJobIndex) - 1u;
+    ASSERT_DEBUG(jobIndex < pJobContext->jobCount);
+
+    recordRenderPassJob(pJobContext, jobIndex);
+}
+
+//FK: Records one render pass per job on the windows thread pool and blocks until all of them are executed.
+//    Jobs get submitted in the order they're passed in, after all render passes that have been started before.
+void recordRenderPassJobs(graphics_frame_t* pGraphicsFrame, const render_pass_job_t* pJobs, const uint32_t jobCount)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    ASSERT_DEBUG(pJobs != nullptr || jobCount == 0u);
+
+    render_pass_job_context_t jobContext = {};
+    jobContext.pGraphicsFrame   = pGraphicsFrame;
+    jobContext.pJobs            = pJobs;
+    jobContext.jobCount         = jobCount;
+    jobContext.firstSortIndex   = (uint32_t)InterlockedExchangeAdd(&pGraphicsFrame->nextRenderPassSortIndex, (LONG)jobCount);
+
+    PTP_WORK pWork = CreateThreadpoolWork(recordRenderPassJobThreadpoolCallback, &jobContext, nullptr);
+    if(pWork == nullptr)
+    {
+        logWarning("Could not create thread pool work, recording %u render passes on the calling thread.", jobCount);
+        for(uint32_t jobIndex = 0u; jobIndex < jobCount; ++jobIndex)
+        {
+            recordRenderPassJob(&jobContext, jobIndex);
+        }
+
+        return;
+    }
+
+    for(uint32_t jobIndex = 0u; jobIndex < jobCount; ++jobIndex)
+    {
+        SubmitThreadpoolWork(pWork);
+    }
+
+    WaitForThreadpoolWorkCallbacks(pWork, FALSE);
+    CloseThreadpoolWork(pWork);
+}
+
+//FK: Render graph
+//    Passes declare the resources they read and write, compileRenderGraph() then culls passes whose outputs are never
+//    read, computes the barriers needed at each pass boundary and places transient resources with non-overlapping
+//    lifetimes at the same offset of a shared heap. Compilation doesn't touch the device.
+//    Placed memory doesn't keep its content when another resource used it in between, so every transient resource
+//    gets an aliasing barrier and a discard at its first use. The first pass using it has to write all of it (or clear it).
+constexpr uint32_t invalidRenderGraphIndex = ~0u;
+
+struct render_graph_resource_handle_t
+{
+    uint32_t index;
+};
+
+struct render_graph_pass_handle_t
+{
+    uint32_t index;
+};
+
+enum render_graph_barrier_type_t : uint8_t
+{
+    render_graph_barrier_transition,
+    render_graph_barrier_aliasing,
+    render_graph_barrier_unordered_access,
+    render_graph_barrier_discard            // not a barrier, DiscardResource() once the barriers before it got issued
+};
+
+struct render_graph_barrier_t
+{
+    uint32_t                    resourceIndex;
+    D3D12_RESOURCE_STATES       stateBefore;
+    D3D12_RESOURCE_STATES       stateAfter;
+    render_graph_barrier_type_t type;
+};
+
+struct render_graph_access_t
+{
+    uint32_t                resourceIndex;
+    D3D12_RESOURCE_STATES   state;
+    bool                    isRead;
+    bool                    isWrite;
+};
+
+struct render_graph_resource_t
+{
+    const char*             pName;
+    d3d12_resource_t*       pResource;          // imported resource, transient resources get theirs when the graph gets executed
+    render_target_t*        pRenderTarget;      // imported render target, see importRenderGraphRenderTarget()
+    D3D12_RESOURCE_DESC     desc;
+    uint64_t                sizeInBytes;
+    uint64_t                alignmentInBytes;
+    D3D12_RESOURCE_STATES   initialState;
+    D3D12_RESOURCE_STATES   finalState;
+    bool                    isImported;
+    bool                    isOutput;           // read after the graph (eg: presented), passes writing it don't get culled
+
+    //FK: Written by compileRenderGraph()
+    uint32_t                firstUsePassIndex;
+    uint32_t                lastUsePassIndex;
+    uint64_t                heapOffsetInBytes;
+    uint32_t                aliasedResourceIndex;   // resource that used the heap memory before this one within the graph
+    bool                    isAliased;              // shares heap memory with a resource used earlier in the graph
+    bool                    isAliasedAway;          // a later resource took over the heap memory, no barriers after that
+};
+
+struct render_graph_pass_t
+{
+    const char*             pName;
+    render_target_t*        pRenderTarget;      // nullptr = backbuffer
+    uint32_t                renderTargetResourceIndex;  // graph resource used instead of pRenderTarget if valid
+    record_render_pass_fnc  pRecordFnc;
+    void*                   pUserData;
+    uint32_t                firstAccessIndex;
+    uint32_t                accessCount;
+    bool                    hasSideEffects;     // never gets culled (eg: writes to a readback buffer outside of the graph)
+
+    //FK: Written by compileRenderGraph()
+    bool                    isCulled;
+    uint32_t                firstBarrierIndex;
+    uint32_t                barrierCount;
+};
+
+//FK: Placed resources of transient resources, these outlive a single graph declaration so they can be reused
+//    by the next frame as long as the layout doesn't change.
+struct render_graph_transient_resource_t
+{
+    render_target_t         renderTarget;       // descriptor is a DSV for depth stencil resources
+    D3D12_RESOURCE_DESC     desc;
+    D3D12_RESOURCE_STATES   initialState;
+    uint64_t                heapOffsetInBytes;
+};
+
+struct render_graph_retired_object_t
+{
+    ID3D12Pageable*         pObject;
+    ID3D12Fence*            pFence;
+    uint64_t                fenceValue;
+};
+
+struct render_graph_heap_block_t
+{
+    uint64_t                offsetInBytes;
+    uint64_t                sizeInBytes;
+    uint32_t                lastUsePassIndex;
+    uint32_t                resourceIndex;      // last resource placed in the block
+};
+
+struct render_graph_statistics_t
+{
+    uint32_t                culledPassCount;
+    uint32_t                transitionBarrierCount;
+    uint32_t                aliasingBarrierCount;
+    uint32_t                unorderedAccessBarrierCount;
+    uint32_t                discardCount;
+    uint64_t                transientResourceSizeInBytes;   // sum of all transient resources that are in use
+    uint64_t                transientHeapSizeInBytes;       // heap size needed after aliasing
+};
+
+struct render_graph_parameters_t
+{
+    uint32_t maxPassCount;
+    uint32_t maxResourceCount;
+    uint32_t maxAccessCount;
+};
+
+struct render_graph_t
+{
+    memory_allocator_t*                 pMemoryAllocator;
+    render_graph_pass_t*                pPasses;
+    render_graph_resource_t*            pResources;
+    render_graph_access_t*              pAccesses;
+    render_graph_barrier_t*             pBarriers;
+    render_graph_heap_block_t*          pHeapBlocks;
+    D3D12_RESOURCE_STATES*              pTrackedStates;
+    bool*                               pTrackedWrites;
+    bool*                               pIsResourceNeeded;
+    uint32_t*                           pTransientResourceOrder;
+    render_graph_transient_resource_t*  pTransientResources;
+    render_graph_retired_object_t*      pRetiredObjects;
+
+    ID3D12Heap*                         pTransientHeap;
+    uint64_t                            transientHeapCapacityInBytes;
+
+    //FK: One descriptor per resource slot, created together with the placed resources
+    d3d12_descriptor_heap_t             renderTargetDescriptorHeap;
+    d3d12_descriptor_heap_t             depthStencilDescriptorHeap;
+
+    uint32_t                            maxPassCount;
+    uint32_t                            maxResourceCount;
+    uint32_t                            maxAccessCount;
+    uint32_t                            maxBarrierCount;
+    uint32_t                            maxRetiredObjectCount;
+    uint32_t                            passCount;
+    uint32_t                            resourceCount;
+    uint32_t                            accessCount;
+    uint32_t                            barrierCount;
+    uint32_t                            retiredObjectCount;
+    uint32_t                            firstFinalBarrierIndex;
+    uint32_t                            finalBarrierCount;
+    bool                                isCompiled;
+    bool                                ownsRetiredObjects; // false as long as the retired objects live inside the render graph blob
+
+    render_graph_statistics_t           statistics;
+};
+
+bool createRenderGraph(render_graph_t* pOutRenderGraph, memory_allocator_t* pMemoryAllocator, const render_graph_parameters_t* pParameters)
+{
+    ASSERT_DEBUG(pOutRenderGraph != nullptr);
+    ASSERT_DEBUG(pMemoryAllocator != nullptr);
+    ASSERT_DEBUG(pParameters != nullptr);
+    ASSERT_DEBUG(pParameters->maxPassCount > 0u && pParameters->maxResourceCount > 0u);
+
+    const uint32_t maxPassCount     = pParameters->maxPassCount;
+    const uint32_t maxResourceCount = pParameters->maxResourceCount;
+    const uint32_t maxAccessCount   = pParameters->maxAccessCount;
+
+    //FK: Worst case is an aliasing barrier, a discard and a transition/uav barrier per access plus a transition per resource
+    //    before it gets aliased away or at the end of the graph.
+    //    Every placement can split a heap block, so there are at most twice as many blocks as resources.
+    //    A frame retires at most all placed resources plus the heap, objects of frames in flight grow the list further.
+    const uint32_t maxBarrierCount          = maxAccessCount * 3u + maxResourceCount;
+    const uint32_t maxHeapBlockCount        = maxResourceCount * 2u;
+    const uint32_t maxRetiredObjectCount    = maxResourceCount + 1u;
+
+    const uint64_t sizeInBytes = sizeof(render_graph_pass_t) * maxPassCount + 
+                                 sizeof(render_graph_resource_t) * maxResourceCount +
+                                 sizeof(render_graph_access_t) * maxAccessCount +
+                                 sizeof(render_graph_barrier_t) * maxBarrierCount +
+                                 sizeof(render_graph_heap_block_t) * maxHeapBlockCount +
+                                 sizeof(render_graph_transient_resource_t) * maxResourceCount +
+                                 sizeof(render_graph_retired_object_t) * maxRetiredObjectCount +
+                                 sizeof(D3D12_RESOURCE_STATES) * maxResourceCount +
+                                 sizeof(uint32_t) * maxResourceCount +
+                                 sizeof(bool) * maxResourceCount * 2u;
+
+    uint8_t* pMemory = (uint8_t*)allocateFromAllocator(pMemoryAllocator, sizeInBytes, alloc_flag_clear_memory);
+    if(pMemory == nullptr)
+    {
+        logError("Could not allocate %.3fKiB for render graph with %u passes and %u resources.", (float)sizeInBytes / 1024.f, maxPassCount, maxResourceCount);
+        return false;
+    }
+
+    render_graph_t renderGraph = {};
+    renderGraph.pMemoryAllocator        = pMemoryAllocator;
+    renderGraph.pPasses                 = (render_graph_pass_t*)pMemory;                        pMemory += sizeof(render_graph_pass_t) * maxPassCount;
+    renderGraph.pResources              = (render_graph_resource_t*)pMemory;                    pMemory += sizeof(render_graph_resource_t) * maxResourceCount;
+    renderGraph.pAccesses               = (render_graph_access_t*)pMemory;                      pMemory += sizeof(render_graph_access_t) * maxAccessCount;
+    renderGraph.pBarriers               = (render_graph_barrier_t*)pMemory;                     pMemory += sizeof(render_graph_barrier_t) * maxBarrierCount;
+    renderGraph.pHeapBlocks             = (render_graph_heap_block_t*)pMemory;                  pMemory += sizeof(render_graph_heap_block_t) * maxHeapBlockCount;
+    renderGraph.pTransientResources     = (render_graph_transient_resource_t*)pMemory;          pMemory += sizeof(render_graph_transient_resource_t) * maxResourceCount;
+    renderGraph.pRetiredObjects         = (render_graph_retired_object_t*)pMemory;              pMemory += sizeof(render_graph_retired_object_t) * maxRetiredObjectCount;
+    renderGraph.pTrackedStates          = (D3D12_RESOURCE_STATES*)pMemory;                      pMemory += sizeof(D3D12_RESOURCE_STATES) * maxResourceCount;
+    renderGraph.pTransientResourceOrder = (uint32_t*)pMemory;                                   pMemory += sizeof(uint32_t) * maxResourceCount;
+    renderGraph.pTrackedWrites          = (bool*)pMemory;                                       pMemory += sizeof(bool) * maxResourceCount;
+    renderGraph.pIsResourceNeeded       = (bool*)pMemory;
+    renderGraph.maxPassCount            = maxPassCount;
+    renderGraph.maxResourceCount        = maxResourceCount;
+    renderGraph.maxAccessCount          = maxAccessCount;
+    renderGraph.maxBarrierCount         = maxBarrierCount;
+    renderGraph.maxRetiredObjectCount   = maxRetiredObjectCount;
+
+    *pOutRenderGraph = renderGraph;
+    return true;
+}
+
+void releaseRetiredRenderGraphObjects(render_graph_t* pRenderGraph, const bool waitForGPU)
+{
+    uint32_t retiredObjectIndex = 0u;
+    while(retiredObjectIndex < pRenderGraph->retiredObjectCount)
+    {
+        render_graph_retired_object_t* pRetiredObject = pRenderGraph->pRetiredObjects + retiredObjectIndex;
+        if(pRetiredObject->pFence->GetCompletedValue() < pRetiredObject->fenceValue)
+        {
+            if(!waitForGPU)
+            {
+                ++retiredObjectIndex;
+                continue;
+            }
+
+            //FK: Without event the call blocks until the fence got reached
+            COM_CALL(pRetiredObject->pFence->SetEventOnCompletion(pRetiredObject->fenceValue, nullptr));
+        }
+
+        COM_RELEASE(pRetiredObject->pObject);
+        *pRetiredObject = pRenderGraph->pRetiredObjects[--pRenderGraph->retiredObjectCount];
+    }
+}
+
+//FK: The GPU must not use any of the transient resources anymore (see flushAllFrames())
+void destroyRenderGraph(render_graph_t* pRenderGraph)
+{
+    releaseRetiredRenderGraphObjects(pRenderGraph, true);
+
+    for(uint32_t resourceIndex = 0u; resourceIndex < pRenderGraph->maxResourceCount; ++resourceIndex)
+    {
+        COM_RELEASE(pRenderGraph->pTransientResources[resourceIndex].renderTarget.resource.pResource);
+    }
+
+    COM_RELEASE(pRenderGraph->pTransientHeap);
+    destroyDescriptorHeap(&pRenderGraph->renderTargetDescriptorHeap);
+    destroyDescriptorHeap(&pRenderGraph->depthStencilDescriptorHeap);
+
+    if(pRenderGraph->ownsRetiredObjects)
+    {
+        freeFromAllocator(pRenderGraph->pMemoryAllocator, pRenderGraph->pRetiredObjects);
+    }
+
+    freeFromAllocator(pRenderGraph->pMemoryAllocator, pRenderGraph->pPasses);
+    clearMemoryWithZeroes(pRenderGraph);
+}
+
+//FK: Graphs get declared from scratch every frame, placed transient resources are kept alive
+void resetRenderGraph(render_graph_t* pRenderGraph)
+{
+    pRenderGraph->passCount         = 0u;
+    pRenderGraph->resourceCount     = 0u;
+    pRenderGraph->accessCount       = 0u;
+    pRenderGraph->barrierCount      = 0u;
+    pRenderGraph->finalBarrierCount = 0u;
+    pRenderGraph->isCompiled        = false;
+    pRenderGraph->statistics        = {};
+}
+
+render_graph_resource_t* addRenderGraphResource(render_graph_t* pRenderGraph, const char* pName, render_graph_resource_handle_t* pOutHandle)
+{
+    if(pRenderGraph->resourceCount == pRenderGraph->maxResourceCount)
+    {
+        logError("Could not add render graph resource '%s', limit of %u resources has been reached.", pName, pRenderGraph->maxResourceCount);
+        pOutHandle->index = invalidResourceHandleValue;
+        return nullptr;
+    }
+
+    pOutHandle->index = pRenderGraph->resourceCount;
+
+    render_graph_resource_t* pResource = pRenderGraph->pResources + pRenderGraph->resourceCount++;
+    *pResource = {};
+    pResource->pName                = pName;
+    pResource->firstUsePassIndex    = invalidRenderGraphIndex;
+    pResource->lastUsePassIndex     = invalidRenderGraphIndex;
+    pResource->aliasedResourceIndex = invalidRenderGraphIndex;
+    return pResource;
+}
+
+//FK: Imported resources enter the graph in their current state and leave it in finalState
+render_graph_resource_handle_t importRenderGraphResource(render_graph_t* pRenderGraph, const char* pName, d3d12_resource_t* pResource, const D3D12_RESOURCE_STATES finalState, const bool isOutput)
+{
+    ASSERT_DEBUG(pRenderGraph != nullptr);
+    ASSERT_DEBUG(pResource != nullptr);
+    ASSERT_DEBUG(!pRenderGraph->isCompiled);
+
+    render_graph_resource_handle_t resourceHandle;
+    render_graph_resource_t* pGraphResource = addRenderGraphResource(pRenderGraph, pName, &resourceHandle);
+    if(pGraphResource != nullptr)
+    {
+        pGraphResource->pResource       = pResource;
+        pGraphResource->initialState    = pResource->currentState;
+        pGraphResource->finalState      = finalState;
+        pGraphResource->isImported      = true;
+        pGraphResource->isOutput        = isOutput;
+    }
+
+    return resourceHandle;
+}
+
+render_graph_resource_handle_t importRenderGraphRenderTarget(render_graph_t* pRenderGraph, const char* pName, render_target_t* pRenderTarget, const D3D12_RESOURCE_STATES finalState, const bool isOutput)
+{
+    const render_graph_resource_handle_t resourceHandle = importRenderGraphResource(pRenderGraph, pName, &pRenderTarget->resource, finalState, isOutput);
+    if(!isInvalidResourceHandle(resourceHandle))
+    {
+        pRenderGraph->pResources[resourceHandle.index].pRenderTarget = pRenderTarget;
+    }
+
+    return resourceHandle;
+}
+
+//FK: Transient resources only live within the graph. They're created in initialState and get transitioned back into it
+//    before another resource takes over their memory or at the end of the graph, that way the placed resources can be
+//    reused by the next frame without additional tracking. The first access needs to be a write as render target or 
+//    depth stencil, the previous content gets discarded there.
+//    allocationInfo is what ID3D12Device::GetResourceAllocationInfo() returns for desc.
+render_graph_resource_handle_t createRenderGraphTransientResource(render_graph_t* pRenderGraph, const char* pName, const D3D12_RESOURCE_DESC& desc, const D3D12_RESOURCE_ALLOCATION_INFO& allocationInfo, const D3D12_RESOURCE_STATES initialState)
+{
+    ASSERT_DEBUG(pRenderGraph != nullptr);
+    ASSERT_DEBUG(!pRenderGraph->isCompiled);
+    ASSERT_DEBUG(allocationInfo.SizeInBytes > 0u && allocationInfo.Alignment > 0u);
+    ASSERT_DEBUG_MSG((desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) != 0, "Transient resources need to be render targets or depth stencil targets.");
+
+    render_graph_resource_handle_t resourceHandle;
+    render_graph_resource_t* pGraphResource = addRenderGraphResource(pRenderGraph, pName, &resourceHandle);
+    if(pGraphResource != nullptr)
+    {
+        pGraphResource->desc                = desc;
+        pGraphResource->sizeInBytes         = allocationInfo.SizeInBytes;
+        pGraphResource->alignmentInBytes    = allocationInfo.Alignment;
+        pGraphResource->initialState        = initialState;
+        pGraphResource->finalState          = initialState;
+    }
+
+    return resourceHandle;
+}
+
+render_graph_pass_handle_t addRenderGraphPass(render_graph_t* pRenderGraph, const char* pName, render_target_t* pRenderTarget, record_render_pass_fnc pRecordFnc, void* pUserData, const bool hasSideEffects = false)
+{
+    ASSERT_DEBUG(pRenderGraph != nullptr);
+    ASSERT_DEBUG(!pRenderGraph->isCompiled);
+
+    render_graph_pass_handle_t passHandle = {invalidResourceHandleValue};
+    if(pRenderGraph->passCount == pRenderGraph->maxPassCount)
+    {
+        logError("Could not add render graph pass '%s', limit of %u passes has been reached.", pName, pRenderGraph->maxPassCount);
+        return passHandle;
+    }
+
+    passHandle.index = pRenderGraph->passCount;
+
+    render_graph_pass_t* pPass = pRenderGraph->pPasses + pRenderGraph->passCount++;
+    *pPass = {};
+    pPass->pName                        = pName;
+    pPass->pRenderTarget                = pRenderTarget;
+    pPass->renderTargetResourceIndex    = invalidRenderGraphIndex;
+    pPass->pRecordFnc                   = pRecordFnc;
+    pPass->pUserData                    = pUserData;
+    pPass->firstAccessIndex             = pRenderGraph->accessCount;
+    pPass->hasSideEffects               = hasSideEffects;
+    return passHandle;
+}
+
+void addRenderGraphAccess(render_graph_t* pRenderGraph, const render_graph_pass_handle_t passHandle, const render_graph_resource_handle_t resourceHandle, const D3D12_RESOURCE_STATES state, const bool isWrite)
+{
+    ASSERT_DEBUG(pRenderGraph != nullptr);
+    ASSERT_DEBUG(!pRenderGraph->isCompiled);
+    if(isInvalidResourceHandle(passHandle) || isInvalidResourceHandle(resourceHandle))
+    {
+        return;
+    }
+
+    //FK: Keeps the accesses of a pass next to each other
+    ASSERT_DEBUG_MSG(passHandle.index + 1u == pRenderGraph->passCount, "Resource accesses can only be added to the most recently added pass.");
+    ASSERT_DEBUG(resourceHandle.index < pRenderGraph->resourceCount);
+
+    render_graph_pass_t* pPass = pRenderGraph->pPasses + passHandle.index;
+    for(uint32_t accessIndex = 0u; accessIndex < pPass->accessCount; ++accessIndex)
+    {
+        render_graph_access_t* pAccess = pRenderGraph->pAccesses + pPass->firstAccessIndex + accessIndex;
+        if(pAccess->resourceIndex == resourceHandle.index)
+        {
+            pAccess->state |= state;
+            pAccess->isRead |= !isWrite;
+            pAccess->isWrite |= isWrite;
+            return;
+        }
+    }
+
+    if(pRenderGraph->accessCount == pRenderGraph->maxAccessCount)
+    {
+        logError("Could not add resource access to render graph pass '%s', limit of %u accesses has been reached.", pPass->pName, pRenderGraph->maxAccessCount);
+        return;
+    }
+
+    render_graph_access_t* pAccess = pRenderGraph->pAccesses + pRenderGraph->accessCount++;
+    pAccess->resourceIndex  = resourceHandle.index;
+    pAccess->state          = state;
+    pAccess->isRead         = !isWrite;
+    pAccess->isWrite        = isWrite;
+    ++pPass->accessCount;
+}
+
+void readRenderGraphResource(render_graph_t* pRenderGraph, const render_graph_pass_handle_t passHandle, const render_graph_resource_handle_t resourceHandle, const D3D12_RESOURCE_STATES state)
+{
+    addRenderGraphAccess(pRenderGraph, passHandle, resourceHandle, state, false);
+}
+
+//FK: A write replaces the whole content of the resource, passes that keep parts of it (eg: blending) need to read it as well
+void writeRenderGraphResource(render_graph_t* pRenderGraph, const render_graph_pass_handle_t passHandle, const render_graph_resource_handle_t resourceHandle, const D3D12_RESOURCE_STATES state)
+{
+    addRenderGraphAccess(pRenderGraph, passHandle, resourceHandle, state, true);
+}
+
+//FK: Renders into a resource of the graph, the pass writes it as render target. Transient resources need to allow render
+//    target usage, imported resources need to be imported with importRenderGraphRenderTarget().
+render_graph_pass_handle_t addRenderGraphPass(render_graph_t* pRenderGraph, const char* pName, const render_graph_resource_handle_t renderTargetHandle, record_render_pass_fnc pRecordFnc, void* pUserData, const bool hasSideEffects = false)
+{
+    ASSERT_DEBUG(pRenderGraph != nullptr);
+    if(isInvalidResourceHandle(renderTargetHandle))
+    {
+        const render_graph_pass_handle_t passHandle = {invalidResourceHandleValue};
+        return passHandle;
+    }
+
+    ASSERT_DEBUG(renderTargetHandle.index < pRenderGraph->resourceCount);
+    const render_graph_resource_t* pResource = pRenderGraph->pResources + renderTargetHandle.index;
+    ASSERT_DEBUG_MSG(pResource->isImported ? pResource->pRenderTarget != nullptr : (pResource->desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) != 0, "Render graph resource can't be used as render target of a pass.");
+
+    const render_graph_pass_handle_t passHandle = addRenderGraphPass(pRenderGraph, pName, nullptr, pRecordFnc, pUserData, hasSideEffects);
+    if(!isInvalidResourceHandle(passHandle))
+    {
+        pRenderGraph->pPasses[passHandle.index].renderTargetResourceIndex = renderTargetHandle.index;
+        writeRenderGraphResource(pRenderGraph, passHandle, renderTargetHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    }
+
+    return passHandle;
+}
+
+void cullRenderGraphPasses(render_graph_t* pRenderGraph)
+{
+    bool* pIsResourceNeeded = pRenderGraph->pIsResourceNeeded;
+    for(uint32_t resourceIndex = 0u; resourceIndex < pRenderGraph->resourceCount; ++resourceIndex)
+    {
+        pIsResourceNeeded[resourceIndex] = pRenderGraph->pResources[resourceIndex].isOutput;
+    }
+
+    //FK: Walk backwards, a pass is needed when a later pass (or the outside world) reads something it writes.
+    //    Writes end the need of earlier passes for that resource, reads start it.
+    for(uint32_t passIndex = pRenderGraph->passCount; passIndex-- > 0u;)
+    {
+        render_graph_pass_t* pPass = pRenderGraph->pPasses + passIndex;
+        const render_graph_access_t* pAccesses = pRenderGraph->pAccesses + pPass->firstAccessIndex;
+
+        bool isPassNeeded = pPass->hasSideEffects;
+        for(uint32_t accessIndex = 0u; accessIndex < pPass->accessCount && !isPassNeeded; ++accessIndex)
+        {
+            isPassNeeded = pAccesses[accessIndex].isWrite && pIsResourceNeeded[pAccesses[accessIndex].resourceIndex];
+        }
+
+        pPass->isCulled = !isPassNeeded;
+        if(pPass->isCulled)
+        {
+            ++pRenderGraph->statistics.culledPassCount;
+            continue;
+        }
+
+        for(uint32_t accessIndex = 0u; accessIndex < pPass->accessCount; ++accessIndex)
+        {
+            if(pAccesses[accessIndex].isWrite)
+            {
+                pIsResourceNeeded[pAccesses[accessIndex].resourceIndex] = false;
+            }
+        }
+
+        for(uint32_t accessIndex = 0u; accessIndex < pPass->accessCount; ++accessIndex)
+        {
+            if(pAccesses[accessIndex].isRead)
+            {
+                pIsResourceNeeded[pAccesses[accessIndex].resourceIndex] = true;
+            }
+        }
+    }
+}
+
+void placeRenderGraphTransientResources(render_graph_t* pRenderGraph, const uint32_t transientResourceCount)
+{
+    render_graph_heap_block_t* pHeapBlocks = pRenderGraph->pHeapBlocks;
+    uint32_t heapBlockCount = 0u;
+    uint64_t heapSizeInBytes = 0u;
+
+    //FK: Resources are visited in order of their first use, so a block can be reused as soon as its last user is done.
+    //    Picking the smallest block that fits keeps big blocks around for big resources.
+    for(uint32_t orderIndex = 0u; orderIndex < transientResourceCount; ++orderIndex)
+    {
+        render_graph_resource_t* pResource = pRenderGraph->pResources + pRenderGraph->pTransientResourceOrder[orderIndex];
+        const uint64_t sizeInBytes = alignValue(pResource->sizeInBytes, pResource->alignmentInBytes);
+
+        render_graph_heap_block_t* pBestBlock = nullptr;
+        for(uint32_t blockIndex = 0u; blockIndex < heapBlockCount; ++blockIndex)
+        {
+            render_graph_heap_block_t* pBlock = pHeapBlocks + blockIndex;
+            const bool isBlockFree = pBlock->lastUsePassIndex < pResource->firstUsePassIndex;
+            const bool isBlockFitting = pBlock->sizeInBytes >= sizeInBytes && (pBlock->offsetInBytes % pResource->alignmentInBytes) == 0u;
+            if(isBlockFree && isBlockFitting && (pBestBlock == nullptr || pBlock->sizeInBytes < pBestBlock->sizeInBytes))
+            {
+                pBestBlock = pBlock;
+            }
+        }
+
+        pRenderGraph->statistics.transientResourceSizeInBytes += sizeInBytes;
+
+        const uint32_t resourceIndex = pRenderGraph->pTransientResourceOrder[orderIndex];
+        if(pBestBlock == nullptr)
+        {
+            const uint64_t offsetInBytes = alignValue(heapSizeInBytes, pResource->alignmentInBytes);
+            render_graph_heap_block_t* pBlock = pHeapBlocks + heapBlockCount++;
+            pBlock->offsetInBytes       = offsetInBytes;
+            pBlock->sizeInBytes         = sizeInBytes;
+            pBlock->lastUsePassIndex    = pResource->lastUsePassIndex;
+            pBlock->resourceIndex       = resourceIndex;
+
+            pResource->heapOffsetInBytes    = offsetInBytes;
+            pResource->aliasedResourceIndex = invalidRenderGraphIndex;
+            pResource->isAliased            = false;
+            heapSizeInBytes = offsetInBytes + sizeInBytes;
+            continue;
+        }
+
+        //FK: Split off what's not needed, it stays free for as long as the block was free before.
+        //    The remaining memory still belongs to the previous resource, so a block only ever overlaps a single resource.
+        if(pBestBlock->sizeInBytes > sizeInBytes)
+        {
+            render_graph_heap_block_t* pRemainingBlock = pHeapBlocks + heapBlockCount++;
+            pRemainingBlock->offsetInBytes      = pBestBlock->offsetInBytes + sizeInBytes;
+            pRemainingBlock->sizeInBytes        = pBestBlock->sizeInBytes - sizeInBytes;
+            pRemainingBlock->lastUsePassIndex   = pBestBlock->lastUsePassIndex;
+            pRemainingBlock->resourceIndex      = pBestBlock->resourceIndex;
+        }
+
+        pResource->heapOffsetInBytes    = pBestBlock->offsetInBytes;
+        pResource->aliasedResourceIndex = pBestBlock->resourceIndex;
+        pResource->isAliased            = true;
+
+        pBestBlock->sizeInBytes         = sizeInBytes;
+        pBestBlock->lastUsePassIndex    = pResource->lastUsePassIndex;
+        pBestBlock->resourceIndex       = resourceIndex;
+    }
+
+    pRenderGraph->statistics.transientHeapSizeInBytes = heapSizeInBytes;
+}
+
+void addRenderGraphBarrier(render_graph_t* pRenderGraph, const uint32_t resourceIndex, const D3D12_RESOURCE_STATES stateBefore, const D3D12_RESOURCE_STATES stateAfter, const render_graph_barrier_type_t type)
+{
+    ASSERT_DEBUG(pRenderGraph->barrierCount < pRenderGraph->maxBarrierCount);
+
+    render_graph_barrier_t* pBarrier = pRenderGraph->pBarriers + pRenderGraph->barrierCount++;
+    pBarrier->resourceIndex = resourceIndex;
+    pBarrier->stateBefore   = stateBefore;
+    pBarrier->stateAfter    = stateAfter;
+    pBarrier->type          = type;
+
+    switch(type)
+    {
+        case render_graph_barrier_transition:
+            ++pRenderGraph->statistics.transitionBarrierCount;
+            break;
+        case render_graph_barrier_aliasing:
+            ++pRenderGraph->statistics.aliasingBarrierCount;
+            break;
+        case render_graph_barrier_unordered_access:
+            ++pRenderGraph->statistics.unorderedAccessBarrierCount;
+            break;
+        case render_graph_barrier_discard:
+            ++pRenderGraph->statistics.discardCount;
+            break;
+    }
+}
+
+void computeRenderGraphBarriers(render_graph_t* pRenderGraph)
+{
+    for(uint32_t resourceIndex = 0u; resourceIndex < pRenderGraph->resourceCount; ++resourceIndex)
+    {
+        pRenderGraph->pTrackedStates[resourceIndex] = pRenderGraph->pResources[resourceIndex].initialState;
+        pRenderGraph->pTrackedWrites[resourceIndex] = false;
+    }
+
+    //FK: All barriers of a pass get issued together at the start of the pass
+    for(uint32_t passIndex = 0u; passIndex < pRenderGraph->passCount; ++passIndex)
+    {
+        render_graph_pass_t* pPass = pRenderGraph->pPasses + passIndex;
+        pPass->firstBarrierIndex = pRenderGraph->barrierCount;
+        if(pPass->isCulled)
+        {
+            continue;
+        }
+
+        const render_graph_access_t* pAccesses = pRenderGraph->pAccesses + pPass->firstAccessIndex;
+        for(uint32_t accessIndex = 0u; accessIndex < pPass->accessCount; ++accessIndex)
+        {
+            const render_graph_access_t* pAccess = pAccesses + accessIndex;
+            const render_graph_resource_t* pResource = pRenderGraph->pResources + pAccess->resourceIndex;
+
+            if(!pResource->isImported && pResource->firstUsePassIndex == passIndex)
+            {
+                ASSERT_DEBUG_MSG(pAccess->isWrite && (pAccess->state == D3D12_RESOURCE_STATE_RENDER_TARGET || pAccess->state == D3D12_RESOURCE_STATE_DEPTH_WRITE), "The first access of a transient render graph resource needs to be a render target or depth write.");
+
+                //FK: Return the resource that used the memory before to its initial state while it's still the active one,
+                //    it must not be touched anymore once the aliasing barrier made this resource the active one.
+                if(pResource->isAliased)
+                {
+                    render_graph_resource_t* pAliasedResource = pRenderGraph->pResources + pResource->aliasedResourceIndex;
+                    const D3D12_RESOURCE_STATES aliasedResourceState = pRenderGraph->pTrackedStates[pResource->aliasedResourceIndex];
+                    if(!pAliasedResource->isAliasedAway && aliasedResourceState != pAliasedResource->initialState)
+                    {
+                        addRenderGraphBarrier(pRenderGraph, pResource->aliasedResourceIndex, aliasedResourceState, pAliasedResource->initialState, render_graph_barrier_transition);
+                        pRenderGraph->pTrackedStates[pResource->aliasedResourceIndex] = pAliasedResource->initialState;
+                    }
+
+                    pAliasedResource->isAliasedAway = true;
+                }
+
+                //FK: Even without aliasing within the graph, other placed resources used the memory during previous frames
+                const D3D12_RESOURCE_STATES initialState = pRenderGraph->pTrackedStates[pAccess->resourceIndex];
+                addRenderGraphBarrier(pRenderGraph, pAccess->resourceIndex, initialState, initialState, render_graph_barrier_aliasing);
+            }
+
+            const D3D12_RESOURCE_STATES trackedState = pRenderGraph->pTrackedStates[pAccess->resourceIndex];
+            if(trackedState != pAccess->state)
+            {
+                addRenderGraphBarrier(pRenderGraph, pAccess->resourceIndex, trackedState, pAccess->state, render_graph_barrier_transition);
+            }
+            else if(pAccess->state == D3D12_RESOURCE_STATE_UNORDERED_ACCESS && pResource->firstUsePassIndex != passIndex && (pAccess->isWrite || pRenderGraph->pTrackedWrites[pAccess->resourceIndex]))
+            {
+                //FK: Unordered access writes of the previous pass need to be finished before this pass touches the resource
+                addRenderGraphBarrier(pRenderGraph, pAccess->resourceIndex, trackedState, trackedState, render_graph_barrier_unordered_access);
+            }
+
+            pRenderGraph->pTrackedStates[pAccess->resourceIndex] = pAccess->state;
+            pRenderGraph->pTrackedWrites[pAccess->resourceIndex] = pAccess->isWrite;
+        }
+
+        //FK: Discards need the render target or depth write state, so they come after the barriers of the pass
+        for(uint32_t accessIndex = 0u; accessIndex < pPass->accessCount; ++accessIndex)
+        {
+            const render_graph_access_t* pAccess = pAccesses + accessIndex;
+            const render_graph_resource_t* pResource = pRenderGraph->pResources + pAccess->resourceIndex;
+            if(!pResource->isImported && pResource->firstUsePassIndex == passIndex)
+            {
+                addRenderGraphBarrier(pRenderGraph, pAccess->resourceIndex, pAccess->state, pAccess->state, render_graph_barrier_discard);
+            }
+        }
+
+        pPass->barrierCount = pRenderGraph->barrierCount - pPass->firstBarrierIndex;
+    }
+
+    //FK: Resources that got aliased away already went back to their initial state and are inactive now
+    pRenderGraph->firstFinalBarrierIndex = pRenderGraph->barrierCount;
+    for(uint32_t resourceIndex = 0u; resourceIndex < pRenderGraph->resourceCount; ++resourceIndex)
+    {
+        const render_graph_resource_t* pResource = pRenderGraph->pResources + resourceIndex;
+        const D3D12_RESOURCE_STATES trackedState = pRenderGraph->pTrackedStates[resourceIndex];
+        if(!pResource->isAliasedAway && trackedState != pResource->finalState)
+        {
+            addRenderGraphBarrier(pRenderGraph, resourceIndex, trackedState, pResource->finalState, render_graph_barrier_transition);
+        }
+    }
+
+    pRenderGraph->finalBarrierCount = pRenderGraph->barrierCount - pRenderGraph->firstFinalBarrierIndex;
+}
+
+//FK: CPU only, executeRenderGraph() is the part that talks to the device
+void compileRenderGraph(render_graph_t* pRenderGraph)
+{
+    ASSERT_DEBUG(pRenderGraph != nullptr);
+    ASSERT_DEBUG(!pRenderGraph->isCompiled);
+
+    pRenderGraph->barrierCount = 0u;
+    pRenderGraph->statistics = {};
+
+    cullRenderGraphPasses(pRenderGraph);
+
+    uint32_t transientResourceCount = 0u;
+    for(uint32_t passIndex = 0u; passIndex < pRenderGraph->passCount; ++passIndex)
+    {
+        const render_graph_pass_t* pPass = pRenderGraph->pPasses + passIndex;
+        if(pPass->isCulled)
+        {
+            continue;
+        }
+
+        for(uint32_t accessIndex = 0u; accessIndex < pPass->accessCount; ++accessIndex)
+        {
+            const uint32_t resourceIndex = pRenderGraph->pAccesses[pPass->firstAccessIndex + accessIndex].resourceIndex;
+            render_graph_resource_t* pResource = pRenderGraph->pResources + resourceIndex;
+            if(pResource->firstUsePassIndex == invalidRenderGraphIndex)
+            {
+                pResource->firstUsePassIndex = passIndex;
+                if(!pResource->isImported)
+                {
+                    pRenderGraph->pTransientResourceOrder[transientResourceCount++] = resourceIndex;
+                }
+            }
+
+            pResource->lastUsePassIndex = passIndex;
+        }
+    }
+
+    placeRenderGraphTransientResources(pRenderGraph, transientResourceCount);
+    computeRenderGraphBarriers(pRenderGraph);
+
+    pRenderGraph->isCompiled = true;
+}
+
+bool tryToGrowRetiredRenderGraphObjects(render_graph_t* pRenderGraph)
+{
+    const uint32_t newMaxRetiredObjectCount = pRenderGraph->maxRetiredObjectCount * 2u;
+    render_graph_retired_object_t* pNewRetiredObjects = (render_graph_retired_object_t*)allocateFromAllocator(pRenderGraph->pMemoryAllocator, sizeof(render_graph_retired_object_t) * newMaxRetiredObjectCount);
+    if(pNewRetiredObjects == nullptr)
+    {
+        return false;
+    }
+
+    copyMemoryNonOverlapping(pNewRetiredObjects, pRenderGraph->pRetiredObjects, sizeof(render_graph_retired_object_t) * pRenderGraph->retiredObjectCount);
+
+    //FK: Only the grown list owns its memory, the initial list is a slice of the render graph blob
+    if(pRenderGraph->ownsRetiredObjects)
+    {
+        freeFromAllocator(pRenderGraph->pMemoryAllocator, pRenderGraph->pRetiredObjects);
+    }
+
+    pRenderGraph->pRetiredObjects       = pNewRetiredObjects;
+    pRenderGraph->maxRetiredObjectCount = newMaxRetiredObjectCount;
+    pRenderGraph->ownsRetiredObjects    = true;
+    return true;
+}
+
+bool retireRenderGraphObject(render_graph_t* pRenderGraph, ID3D12Pageable* pObject, graphics_frame_t* pGraphicsFrame)
+{
+    if(pObject == nullptr)
+    {
+        return true;
+    }
+
+    //FK: Waiting isn't an option, the objects retired during this frame only get released once finishFrame() signaled its fence
+    if(pRenderGraph->retiredObjectCount == pRenderGraph->maxRetiredObjectCount && !tryToGrowRetiredRenderGraphObjects(pRenderGraph))
+    {
+        logError("Could not grow the retired render graph objects to %u entries.", pRenderGraph->maxRetiredObjectCount * 2u);
+        return false;
+    }
+
+    //FK: The frame fence of this frame gets signaled after all previous frames are done on the direct queue
+    render_graph_retired_object_t* pRetiredObject = pRenderGraph->pRetiredObjects + pRenderGraph->retiredObjectCount++;
+    pRetiredObject->pObject     = pObject;
+    pRetiredObject->pFence      = pGraphicsFrame->pFrameFence;
+    pRetiredObject->fenceValue  = pGraphicsFrame->frameIndex;
+    return true;
+}
+
+//FK: Layout changes (eg: after a resolution change) re-create the affected placed resources,
+//    the previous ones get released once the GPU is done with the frames still using them.
+bool createRenderGraphTransientResources(render_graph_t* pRenderGraph, graphics_frame_t* pGraphicsFrame)
+{
+    releaseRetiredRenderGraphObjects(pRenderGraph, false);
+
+    if(pRenderGraph->renderTargetDescriptorHeap.pDescriptorHeap == nullptr)
+    {
+        if(!createDescriptorHeap(&pRenderGraph->renderTargetDescriptorHeap, pGraphicsFrame->pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, pRenderGraph->maxResourceCount) ||
+           !createDescriptorHeap(&pRenderGraph->depthStencilDescriptorHeap, pGraphicsFrame->pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_DSV, pRenderGraph->maxResourceCount))
+        {
+            logError("Could not create render graph descriptor heaps for %u resources.", pRenderGraph->maxResourceCount);
+            destroyDescriptorHeap(&pRenderGraph->renderTargetDescriptorHeap);
+            return false;
+        }
+    }
+
+    const uint64_t heapSizeInBytes = pRenderGraph->statistics.transientHeapSizeInBytes;
+    if(heapSizeInBytes > pRenderGraph->transientHeapCapacityInBytes)
+    {
+        for(uint32_t resourceIndex = 0u; resourceIndex < pRenderGraph->maxResourceCount; ++resourceIndex)
+        {
+            if(!retireRenderGraphObject(pRenderGraph, pRenderGraph->pTransientResources[resourceIndex].renderTarget.resource.pResource, pGraphicsFrame))
+            {
+                return false;
+            }
+            pRenderGraph->pTransientResources[resourceIndex].renderTarget.resource.pResource = nullptr;
+        }
+
+        if(!retireRenderGraphObject(pRenderGraph, pRenderGraph->pTransientHeap, pGraphicsFrame))
+        {
+            return false;
+        }
+        pRenderGraph->pTransientHeap = nullptr;
+        pRenderGraph->transientHeapCapacityInBytes = 0u;
+
+        D3D12_HEAP_DESC heapDesc = {};
+        heapDesc.SizeInBytes            = heapSizeInBytes;
+        heapDesc.Properties.Type        = D3D12_HEAP_TYPE_DEFAULT;
+        heapDesc.Alignment              = D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT;
+        heapDesc.Flags                  = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+
+        if(COM_CALL(pGraphicsFrame->pDevice->CreateHeap(&heapDesc, IID_PPV_ARGS(&pRenderGraph->pTransientHeap))) != S_OK)
+        {
+            logError("Could not create render graph transient heap of %.3fMiB.", (float)heapSizeInBytes / (1024.f * 1024.f));
+            return false;
+        }
+
+        setD3D12ObjectDebugName(pRenderGraph->pTransientHeap, "Render Graph Transient Heap");
+        pRenderGraph->transientHeapCapacityInBytes = heapSizeInBytes;
+    }
+
+    for(uint32_t resourceIndex = 0u; resourceIndex < pRenderGraph->resourceCount; ++resourceIndex)
+    {
+        const render_graph_resource_t* pResource = pRenderGraph->pResources + resourceIndex;
+        render_graph_transient_resource_t* pTransientResource = pRenderGraph->pTransientResources + resourceIndex;
+        if(pResource->isImported || pResource->firstUsePassIndex == invalidRenderGraphIndex)
+        {
+            continue;
+        }
+
+        const bool isLayoutUnchanged = pTransientResource->renderTarget.resource.pResource != nullptr &&
+                                       pTransientResource->heapOffsetInBytes == pResource->heapOffsetInBytes &&
+                                       pTransientResource->initialState == pResource->initialState &&
+                                       memcmp(&pTransientResource->desc, &pResource->desc, sizeof(D3D12_RESOURCE_DESC)) == 0;
+        if(isLayoutUnchanged)
+        {
+            continue;
+        }
+
+        if(!retireRenderGraphObject(pRenderGraph, pTransientResource->renderTarget.resource.pResource, pGraphicsFrame))
+        {
+            return false;
+        }
+        pTransientResource->renderTarget.resource.pResource = nullptr;
+
+        ID3D12Resource* pPlacedResource = nullptr;
+        if(COM_CALL(pGraphicsFrame->pDevice->CreatePlacedResource(pRenderGraph->pTransientHeap, pResource->heapOffsetInBytes, &pResource->desc, pResource->initialState, nullptr, IID_PPV_ARGS(&pPlacedResource))) != S_OK)
+        {
+            logError("Could not create placed resource for render graph transient resource '%s'.", pResource->pName);
+            return false;
+        }
+
+        //FK: Render target and depth stencil views are only read while recording, so the descriptor of a slot can be
+        //    overwritten while previous frames that used it are still in flight.
+        const bool isDepthStencil = (pResource->desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) != 0;
+        const d3d12_descriptor_heap_t* pDescriptorHeap = isDepthStencil ? &pRenderGraph->depthStencilDescriptorHeap : &pRenderGraph->renderTargetDescriptorHeap;
+        D3D12_CPU_DESCRIPTOR_HANDLE descriptorHandle = {};
+        descriptorHandle.ptr = (SIZE_T)(pDescriptorHeap->pCPUBaseAddress + pDescriptorHeap->incrementSizeInBytes * resourceIndex);
+        if(isDepthStencil)
+        {
+            pGraphicsFrame->pDevice->CreateDepthStencilView(pPlacedResource, nullptr, descriptorHandle);
+        }
+        else
+        {
+            pGraphicsFrame->pDevice->CreateRenderTargetView(pPlacedResource, nullptr, descriptorHandle);
+        }
+
+        setD3D12ObjectDebugName(pPlacedResource, pResource->pName);
+        pTransientResource->renderTarget.resource.pResource     = pPlacedResource;
+        pTransientResource->renderTarget.resource.currentState  = pResource->initialState;
+        pTransientResource->renderTarget.cpuDescriptorHandle    = descriptorHandle;
+        pTransientResource->desc                                = pResource->desc;
+        pTransientResource->initialState            = pResource->initialState;
+        pTransientResource->heapOffsetInBytes       = pResource->heapOffsetInBytes;
+    }
+
+    return true;
+}
+
+d3d12_resource_t* getRenderGraphResource(render_graph_t* pRenderGraph, const render_graph_resource_handle_t resourceHandle)
+{
+    ASSERT_DEBUG(resourceHandle.index < pRenderGraph->resourceCount);
+
+    render_graph_resource_t* pResource = pRenderGraph->pResources + resourceHandle.index;
+    return pResource->isImported ? pResource->pResource : &pRenderGraph->pTransientResources[resourceHandle.index].renderTarget.resource;
+}
+
+//FK: Transient resources only have their placed resource and view while the graph gets executed, eg: for the record function of a pass
+render_target_t* getRenderGraphRenderTarget(render_graph_t* pRenderGraph, const render_graph_resource_handle_t resourceHandle)
+{
+    ASSERT_DEBUG(resourceHandle.index < pRenderGraph->resourceCount);
+
+    render_graph_resource_t* pResource = pRenderGraph->pResources + resourceHandle.index;
+    ASSERT_DEBUG_MSG(!pResource->isImported || pResource->pRenderTarget != nullptr, "Resource has been imported without render target.");
+    return pResource->isImported ? pResource->pRenderTarget : &pRenderGraph->pTransientResources[resourceHandle.index].renderTarget;
+}
+
+void applyRenderGraphBarriers(render_graph_t* pRenderGraph, render_pass_t* pRenderPass, const uint32_t firstBarrierIndex, const uint32_t barrierCount)
+{
+    for(uint32_t barrierIndex = firstBarrierIndex; barrierIndex < firstBarrierIndex + barrierCount; ++barrierIndex)
+    {
+        const render_graph_barrier_t* pBarrier = pRenderGraph->pBarriers + barrierIndex;
+        const render_graph_resource_handle_t resourceHandle = {pBarrier->resourceIndex};
+        d3d12_resource_t* pResource = getRenderGraphResource(pRenderGraph, resourceHandle);
+
+        //FK: The render target of the pass is tracked by the pass itself
+        const bool isRenderPassRenderTarget = pResource == &pRenderPass->pRenderTarget->resource;
+        d3d12_resource_t* pTrackedResource = isRenderPassRenderTarget ? &pRenderPass->renderTargetResource : pResource;
+
+        switch(pBarrier->type)
+        {
+            case render_graph_barrier_transition:
+                ASSERT_DEBUG(pTrackedResource->currentState == pBarrier->stateBefore);
+                transitionResource(&pRenderPass->barrierBatch, pTrackedResource, pBarrier->stateAfter);
+                break;
+            case render_graph_barrier_aliasing:
+                addAliasingBarrier(&pRenderPass->barrierBatch, nullptr, pTrackedResource);
+                break;
+            case render_graph_barrier_unordered_access:
+                addUnorderedAccessBarrier(&pRenderPass->barrierBatch, pTrackedResource);
+                break;
+            case render_graph_barrier_discard:
+                ASSERT_DEBUG(pTrackedResource->currentState == pBarrier->stateBefore);
+                flushResourceBarriers(&pRenderPass->barrierBatch);
+                pRenderPass->pGraphicsCommandList->DiscardResource(pTrackedResource->pResource, nullptr);
+                break;
+        }
+
+        if(isRenderPassRenderTarget)
+        {
+            pResource->currentState = pTrackedResource->currentState;
+        }
+    }
+}
+
+//FK: Records the passes that survived culling in declaration order on the calling thread
+bool executeRenderGraph(render_graph_t* pRenderGraph, graphics_frame_t* pGraphicsFrame)
+{
+    ASSERT_DEBUG(pRenderGraph != nullptr);
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    ASSERT_DEBUG_MSG(pRenderGraph->isCompiled, "Render graph needs to be compiled before it can be executed.");
+
+    if(!createRenderGraphTransientResources(pRenderGraph, pGraphicsFrame))
+    {
+        return false;
+    }
+
+    uint32_t lastPassIndex = invalidRenderGraphIndex;
+    for(uint32_t passIndex = 0u; passIndex < pRenderGraph->passCount; ++passIndex)
+    {
+        if(!pRenderGraph->pPasses[passIndex].isCulled)
+        {
+            lastPassIndex = passIndex;
+        }
+    }
+
+    for(uint32_t passIndex = 0u; passIndex < pRenderGraph->passCount; ++passIndex)
+    {
+        const render_graph_pass_t* pPass = pRenderGraph->pPasses + passIndex;
+        if(pPass->isCulled)
+        {
+            continue;
+        }
+
+        render_target_t* pRenderTarget = pPass->pRenderTarget;
+        if(pPass->renderTargetResourceIndex != invalidRenderGraphIndex)
+        {
+            const render_graph_resource_handle_t renderTargetHandle = {pPass->renderTargetResourceIndex};
+            pRenderTarget = getRenderGraphRenderTarget(pRenderGraph, renderTargetHandle);
+        }
+
+        render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, pPass->pName, pRenderTarget);
+        if(pRenderPass == nullptr)
+        {
+            return false;
+        }
+
+        applyRenderGraphBarriers(pRenderGraph, pRenderPass, pPass->firstBarrierIndex, pPass->barrierCount);
+        flushResourceBarriers(&pRenderPass->barrierBatch);
+
+        //FK: The graph decides about the state of the render target, endRenderPass() shouldn't undo the transitions
+        pRenderPass->renderTargetEntryState = pRenderPass->renderTargetResource.currentState;
+
+        if(pPass->pRecordFnc != nullptr)
+        {
+            pPass->pRecordFnc(pRenderPass, pPass->pUserData);
+        }
+
+        if(passIndex == lastPassIndex)
+        {
+            applyRenderGraphBarriers(pRenderGraph, pRenderPass, pRenderGraph->firstFinalBarrierIndex, pRenderGraph->finalBarrierCount);
+            pRenderPass->renderTargetEntryState = pRenderPass->renderTargetResource.currentState;
+        }
+
+        endRenderPass(pGraphicsFrame, pRenderPass);
+        executeRenderPass(pGraphicsFrame, pRenderPass);
+    }
+
+    return true;
+}
+
+vertex_buffer_handle_t createVertexBuffer(graphics_frame_t* pGraphicsFrame, const upload_buffer_t* pUploadBuffer, const uint32_t uploadBufferOffset = 0u, uint32_t sizeInBytes = 0u)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    ASSERT_DEBUG(pUploadBuffer != nullptr);
+
+    //FK: createUploadBuffer() fails once the upload ring buffer is exhausted, which can happen for valid but large data
+    if(pUploadBuffer->pData == nullptr)
+    {
+        logError("Can't create vertex buffer, the upload buffer couldn't be allocated.");
+        return createInvalidResourceHandle<vertex_buffer_handle_t>();
+    }
+
+    if(uploadBufferOffset > pUploadBuffer->sizeInBytes)
+    {
+        logError("Can't create vertex buffer, offset %u is past the end of the %u byte upload buffer.", uploadBufferOffset, pUploadBuffer->sizeInBytes);
+        return createInvalidResourceHandle<vertex_buffer_handle_t>();
+    }
+
+    if(sizeInBytes == 0u)
+    {
+        sizeInBytes = pUploadBuffer->sizeInBytes - uploadBufferOffset;
+    }
+
+    if(sizeInBytes == 0u || sizeInBytes > pUploadBuffer->sizeInBytes - uploadBufferOffset)
+    {
+        logError("Can't create vertex buffer, %u bytes at offset %u don't fit into the %u byte upload buffer.", sizeInBytes, uploadBufferOffset, pUploadBuffer->sizeInBytes);
+        return createInvalidResourceHandle<vertex_buffer_handle_t>();
+    }
+
+    vertex_buffer_handle_t vertexBufferHandle = {};
+    vertex_buffer_t* pVertexBuffer = allocateVertexBuffer(pGraphicsFrame->pRenderResourceCache, &vertexBufferHandle);
+    if(pVertexBuffer == nullptr)
+    {
+        return createInvalidResourceHandle<vertex_buffer_handle_t>();
+    }
+
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension          = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Alignment          = 0u;
+    desc.DepthOrArraySize   = 1u;
+    desc.Height             = 1u;
+    desc.MipLevels          = 1u;
+    desc.Layout             = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    desc.SampleDesc.Count   = 1u;
+    desc.SampleDesc.Quality = 0u;
+    desc.Width              = sizeInBytes;
+    
+    D3D12_HEAP_PROPERTIES heapProperties = {};
+    heapProperties.Type                 = D3D12_HEAP_TYPE_DEFAULT;
+    heapProperties.CPUPageProperty      = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+    heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+    
+    if(COM_CALL(pGraphicsFrame->pDevice->CreateCommittedResource1(&heapProperties, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_COMMON, nullptr, nullptr, IID_PPV_ARGS(&pVertexBuffer->bufferResource.pResource))) != S_OK)
+    {
+        freeFromResourceTable(&pGraphicsFrame->pRenderResourceCache->vertexBuffers, vertexBufferHandle);
+        return createInvalidResourceHandle<vertex_buffer_handle_t>();
+    }
+
+    pVertexBuffer->sizeInBytes = sizeInBytes;
+
+    //FK: Buffers get implicitly promoted to COPY_DEST on the copy queue and decay back to COMMON once the copy is done.
+    //    The direct queue promotes them again on first use, so no barriers are needed on either queue.
+    pVertexBuffer->bufferResource.currentState = D3D12_RESOURCE_STATE_COMMON;
+    pVertexBuffer->uploadFenceValue = getNextUploadFenceValue(pGraphicsFrame->pUploadQueue);
+    pGraphicsFrame->pFrameGeneralCopyQueue->CopyBufferRegion(pVertexBuffer->bufferResource.pResource, 0u, pUploadBuffer->pBufferResource->pResource, pUploadBuffer->slice.startByteIndex + uploadBufferOffset, sizeInBytes);
+    ++pGraphicsFrame->pendingCopyCount;
+
+    return vertexBufferHandle;
+}
+
+vertex_format_handle_t createVertexFormat(graphics_frame_t* pGraphicsFrame, const vertex_attribute_entry_t* pVertexAttributes, const uint32_t vertexAttributeCount)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    ASSERT_DEBUG(pVertexAttributes != nullptr);
+    ASSERT_DEBUG(vertexAttributeCount > 0u && vertexAttributeCount <= maxVertexAttributeCount);
+
+    for(uint32_t attributeIndex = 0u; attributeIndex < vertexAttributeCount; ++attributeIndex)
+    {
+        if(!isValidVertexAttribute(pVertexAttributes + attributeIndex))
+        {
+            logError("Vertex attribute %u has an invalid type/count combination (type: %u, count: %u).", attributeIndex, pVertexAttributes[attributeIndex].type, pVertexAttributes[attributeIndex].count);
+            return createInvalidResourceHandle<vertex_format_handle_t>();
+        }
+    }
+
+    render_resource_cache_t* pRenderResourceCache = pGraphicsFrame->pRenderResourceCache;
+    vertex_format_cache_t* pVertexFormatCache = &pRenderResourceCache->vertexFormatCache;
+
+    vertex_format_t vertexFormat;
+    initVertexFormat(&vertexFormat, pVertexAttributes, vertexAttributeCount);
+
+    const vertex_format_cache_entry_t* pEntry = findVertexFormatCacheEntry(pRenderResourceCache, vertexFormat.hash, pVertexAttributes, vertexAttributeCount);
+    if(pEntry != nullptr)
+    {
+        ++getVertexFormat(pRenderResourceCache, pEntry->vertexFormat)->referenceCount;
+        ++pVertexFormatCache->statistics.hitCount;
+        return pEntry->vertexFormat;
+    }
+
+    vertex_format_handle_t vertexFormatHandle = {};
+    vertex_format_t* pVertexFormat = allocateVertexFormat(pRenderResourceCache, &vertexFormatHandle);
+    if(pVertexFormat == nullptr)
+    {
+        return vertexFormatHandle;
+    }
+
+    *pVertexFormat = vertexFormat;
+    pVertexFormat->referenceCount = 1u;
+    ++pVertexFormatCache->statistics.missCount;
+    insertVertexFormatCacheEntry(pVertexFormatCache, vertexFormat.hash, vertexFormatHandle);
+
+    return vertexFormatHandle;
+}
+
+upload_buffer_t createUploadBuffer(graphics_frame_t* pGraphicsFrame, void* pData, const uint32_t dataSizeInBytes, upload_buffer_flags_t flags = upload_buffer_flag_none)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    ASSERT_DEBUG(pGraphicsFrame->pUploadRingBuffer != nullptr);
+    ASSERT_DEBUG(dataSizeInBytes > 0u);
+    UNUSED_PARAMETER(flags);
+
+    upload_ring_buffer_t* pUploadRingBuffer = pGraphicsFrame->pUploadRingBuffer;
+
+    upload_buffer_t uploadBuffer = {};
+    if(!allocateFromRingBuffer(&pUploadRingBuffer->allocator, dataSizeInBytes, uploadBufferAlignmentInBytes, &uploadBuffer.slice))
+    {
+        logError("Upload ring buffer is out of memory (requested %u bytes, %llu of %llu bytes in flight). Increase 'defaultStagingBufferSizeInBytes'.", 
+            dataSizeInBytes, getRingBufferUsedSizeInBytes(&pUploadRingBuffer->allocator), pUploadRingBuffer->allocator.sizeInBytes);
+        return uploadBuffer;
+    }
+
+    //FK: Slice gets reclaimed once the upload batch of this frame has been copied
+    uploadBuffer.slice.fenceValue   = getNextUploadFenceValue(pGraphicsFrame->pUploadQueue);
+    uploadBuffer.pBufferResource    = &pUploadRingBuffer->bufferResource;
+    uploadBuffer.pData              = pUploadRingBuffer->pMappedData + uploadBuffer.slice.startByteIndex;
+    uploadBuffer.sizeInBytes        = dataSizeInBytes;
+
+    if(pData != nullptr)
+    {
+        memcpy(uploadBuffer.pData, pData, dataSizeInBytes);
+    }
+
+    return uploadBuffer;
+}
+
+upload_buffer_t createUploadBuffer(graphics_frame_t* pGraphicsFrame, const uint32_t dataSizeInBytes)
+{
+    return createUploadBuffer(pGraphicsFrame, nullptr, dataSizeInBytes);
+}
+
+//FK: Constants are only valid until the frame has been finished on the GPU. Can be called from multiple threads.
+constant_allocation_t allocateConstants(graphics_frame_t* pGraphicsFrame, const uint32_t sizeInBytes)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+
+    constant_buffer_allocator_t* pAllocator = &pGraphicsFrame->constantBufferAllocator;
+    const constant_allocation_t allocation = allocateFromConstantBuffer(pAllocator, sizeInBytes);
+    if(allocation.pData == nullptr)
+    {
+        logError("Frame constant buffer is out of memory (requested %u bytes, buffer size is %u bytes). Increase 'frameConstantBufferSizeInBytes'.", sizeInBytes, pAllocator->sizeInBytes);
+    }
+
+    return allocation;
+}
+
+//FK: Returns a pointer into the mapped constant buffer so that constants can be written in place without an extra copy.
+//    Upload heaps are write combined, so write the constants sequentially and never read from them.
+template<typename T>
+T* allocateConstants(graphics_frame_t* pGraphicsFrame, D3D12_GPU_VIRTUAL_ADDRESS* pOutGPUVirtualAddress)
+{
+    ASSERT_DEBUG(pOutGPUVirtualAddress != nullptr);
+    static_assert(alignof(T) <= constantBufferAlignmentInBytes, "Constant buffer allocations are only 256 byte aligned");
+
+    const constant_allocation_t allocation = allocateConstants(pGraphicsFrame, (uint32_t)sizeof(T));
+    *pOutGPUVirtualAddress = allocation.gpuVirtualAddress;
+    return (T*)allocation.pData;
+}
+
+//FK: Descriptors are only valid until the frame has been finished on the GPU
+bool allocateFrameDescriptors(graphics_frame_t* pGraphicsFrame, const uint32_t descriptorCount, descriptor_allocation_t* pOutAllocation)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    ASSERT_DEBUG(pGraphicsFrame->pTransientDescriptorAllocator != nullptr);
+    return allocateTransientDescriptors(pGraphicsFrame->pTransientDescriptorAllocator, descriptorCount, pOutAllocation);
+}
+
+//FK: Copies a descriptor (e.g. from the persistent descriptor allocator) into the bindless descriptor table.
+//    Returns the index that shaders use to access it or invalidDescriptorIndex if the table is full.
+uint32_t registerBindlessDescriptor(graphics_frame_t* pGraphicsFrame, const D3D12_CPU_DESCRIPTOR_HANDLE sourceDescriptor)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    const uint32_t descriptorIndex = allocateBindlessDescriptor(pGraphicsFrame->pBindlessDescriptorTable);
+    if(descriptorIndex != invalidDescriptorIndex)
+    {
+        pGraphicsFrame->pDevice->CopyDescriptorsSimple(1u, getBindlessDescriptorCPUHandle(pGraphicsFrame->pBindlessDescriptorTable, descriptorIndex), sourceDescriptor, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    }
+
+    return descriptorIndex;
+}
+
+uint32_t createBindlessShaderResourceView(graphics_frame_t* pGraphicsFrame, ID3D12Resource* pResource, const D3D12_SHADER_RESOURCE_VIEW_DESC* pDesc)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    const uint32_t descriptorIndex = allocateBindlessDescriptor(pGraphicsFrame->pBindlessDescriptorTable);
+    if(descriptorIndex != invalidDescriptorIndex)
+    {
+        pGraphicsFrame->pDevice->CreateShaderResourceView(pResource, pDesc, getBindlessDescriptorCPUHandle(pGraphicsFrame->pBindlessDescriptorTable, descriptorIndex));
+    }
+
+    return descriptorIndex;
+}
+
+uint32_t createBindlessConstantBufferView(graphics_frame_t* pGraphicsFrame, const D3D12_CONSTANT_BUFFER_VIEW_DESC* pDesc)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    const uint32_t descriptorIndex = allocateBindlessDescriptor(pGraphicsFrame->pBindlessDescriptorTable);
+    if(descriptorIndex != invalidDescriptorIndex)
+    {
+        pGraphicsFrame->pDevice->CreateConstantBufferView(pDesc, getBindlessDescriptorCPUHandle(pGraphicsFrame->pBindlessDescriptorTable, descriptorIndex));
+    }
+
+    return descriptorIndex;
+}
+
+//FK: The index can still be used by the frames in flight, it gets reused once those are done
+void destroyBindlessDescriptor(graphics_frame_t* pGraphicsFrame, const uint32_t descriptorIndex)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    if(descriptorIndex != invalidDescriptorIndex)
+    {
+        releaseBindlessDescriptor(pGraphicsFrame->pBindlessDescriptorTable, descriptorIndex, pGraphicsFrame->frameIndex);
+    }
+}
+
+struct shader_compilation_parameters_t
+{
+    const char*     pShaderProfile;
+    const char*     pFilePath;
+    const char*     pShaderSourceCode;
+    const char*     pEntryPoint;
+    const char*     pDefines;
+};
+
+result_t<memory_buffer_t> readWholeFileIntoNewBuffer(memory_allocator_t* pAllocator, const char* pFilePath)
+{
+    FILE* pShaderFileHandle = fopen(pFilePath, "rb");
+    if(pShaderFileHandle == nullptr)
+    {
+        return result_status_t::file_not_found;
+    }
+
+    fseek(pShaderFileHandle, 0, SEEK_END);
+    const uint64_t shaderFileSizeInBytes = ftell(pShaderFileHandle);
+    fseek(pShaderFileHandle, 0, SEEK_SET);
+
+    char* pShaderSourceContent = (char*)allocateFromAllocator(pAllocator, shaderFileSizeInBytes + 1);
+    if(pShaderSourceContent == nullptr)
+    {
+        fclose(pShaderFileHandle);
+        return result_status_t::out_of_memory;
+    }
+
+    fread(pShaderSourceContent, 1u, shaderFileSizeInBytes, pShaderFileHandle);
+    fclose(pShaderFileHandle);
+
+    pShaderSourceContent[shaderFileSizeInBytes] = 0;
+
+    memory_buffer_t fileContent = {};
+    fileContent.pData = pShaderSourceContent;
+    fileContent.sizeInBytes = shaderFileSizeInBytes + 1;
+
+    return fileContent;
+}
+
+struct dxc_arguments_t
+{
+    const wchar_t** ppArguments;
+    uint32_t        argumentCount;
+};
+
+uint32_t findCharacterCountInString(const char* pString, const char needle)
+{
+    uint32_t count = 0u;
+    while(*pString)
+    {
+        if(*pString++ == needle)
+        {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+result_t<wchar_t*> formatWideStringIntoNewBuffer(memory_allocator_t* pAllocator, const wchar_t* pFormat, ...)
+{
+    wchar_t tempMemoryBuffer[1024] = {};
+    const uint64_t tempMemoryBufferSizeInCharacters = sizeof(tempMemoryBuffer) >> 1;
+    va_list vaList;
+    va_start(vaList, pFormat);
+    const uint32_t charactersPrinted = vswprintf_s(tempMemoryBuffer, tempMemoryBufferSizeInCharacters, pFormat, vaList);
+    va_end(vaList);
+
+    wchar_t* pTextBuffer = (wchar_t*)allocateFromAllocator(pAllocator, charactersPrinted * sizeof(wchar_t), alloc_flag_clear_memory);
+    if(pTextBuffer == nullptr)
+    {
+        return result_status_t::out_of_memory;
+    }
+
+    wcscpy(pTextBuffer, tempMemoryBuffer);
+    return pTextBuffer;
+}
+
+const char* findFirstInstanceOfCharacterInString(const char* pString, const char needle)
+{
+    while(*pString)
+    {
+        if(*pString == needle)
+        {
+            return pString;
+        }
+
+        ++pString;
+    }
+
+    return nullptr;
+}
+
+bool isValidCompilerDefines(const char* pCompilerDefines)
+{
+    bool lastCharWasDelimiter = false;
+    while(*pCompilerDefines)
+    {
+        if(*pCompilerDefines++ == ';')
+        {
+            if(lastCharWasDelimiter)
+            {
+                return false;
+            }
+
+            lastCharWasDelimiter = true;
+        }
+        else
+        {
+            lastCharWasDelimiter = false;
+        }
+    }
+
+    return true;
+}
+
+template<typename T>
+T rangeCheckCast(size_t value)
+{
+    //FK: size_t can't be negative, comparing against min() of a signed type would convert it to a huge unsigned value
+    ASSERT_ALWAYS(value <= (size_t)std::numeric_limits<T>::max());
+    return (T)value;
+}
+
+void freeCompilerArguments(memory_allocator_t* pMemoryAllocator, dxc_arguments_t* pArguments)
+{
+    for(uint32_t argumentIndex = 0u; argumentIndex < pArguments->argumentCount; ++argumentIndex)
+    {
+        freeFromAllocator(pMemoryAllocator, (void*)pArguments->ppArguments[argumentIndex]);
+    }
+
+    freeFromAllocator(pMemoryAllocator, pArguments->ppArguments);
+}
+
+result_t<dxc_arguments_t> generateCompilerArgumentsIntoNewBuffer(memory_allocator_t* pMemoryAllocator, const shader_compilation_parameters_t* pParameters)
+{
+    uint32_t argumentCount = 2u; //entry point + shader profile
+    dxc_arguments_t arguments = {};
+
+    if(pParameters->pDefines != nullptr && pParameters->pDefines[0] != 0)
+    {
+        if(!isValidCompilerDefines(pParameters->pDefines))
+        {
+            logError("Invalid shader compiler defines '%s'.", pParameters->pDefines);
+            return result_status_t::invalid_arguments;
+        }
+
+        argumentCount += 1u;
+        argumentCount += findCharacterCountInString(pParameters->pDefines, ';');
+    }
+
+    wchar_t** ppArguments = (wchar_t**)allocateFromAllocator(pMemoryAllocator, sizeof(wchar_t*) * argumentCount);
+    if(ppArguments == nullptr)
+    {
+        return result_status_t::out_of_memory;
+    }
+
+    ppArguments[0] = formatWideStringIntoNewBuffer(pMemoryAllocator, L"-E %hs", pParameters->pEntryPoint);
+    ppArguments[1] = formatWideStringIntoNewBuffer(pMemoryAllocator, L"-T %hs", pParameters->pShaderProfile);
+
+    if(pParameters->pDefines != nullptr)
+    {
+        const char* pDefineStart    = pParameters->pDefines;
+        const char* pDefineEnd      = pParameters->pDefines + strlen(pParameters->pDefines);
+
+        const char* pCurrentDefineStart = pDefineStart;
+
+        if(ppArguments[0] == nullptr || ppArguments[1] == nullptr)
+        {
+            goto cleanup_and_return_out_of_memory;
+            return result_status_t::out_of_memory;
+        }
+        
+        for(uint32_t argumentIndex = 2u; argumentIndex < argumentCount; ++argumentIndex)
+        {
+            const char* pCurrentDefineEnd = findFirstInstanceOfCharacterInString(pCurrentDefineStart, ';');
+            if(pCurrentDefineEnd == nullptr)
+            {
+                pCurrentDefineEnd = pDefineEnd;
+            }
+
+            const int defineLength = rangeCheckCast<int>(pCurrentDefineEnd - pCurrentDefineStart);
+            ppArguments[argumentIndex] = formatWideStringIntoNewBuffer(pMemoryAllocator, L"-D %.*s", defineLength, pCurrentDefineStart);
+            if(ppArguments[argumentIndex] == nullptr)
+            {
+                goto cleanup_and_return_out_of_memory;
+            }
+            pCurrentDefineStart = pCurrentDefineEnd + 1;
+        }
+    }
+
+    arguments.argumentCount = argumentCount;
+    arguments.ppArguments   = (const wchar_t**)ppArguments;
+    return arguments;
+
+cleanup_and_return_out_of_memory:
+    for(uint32_t argumentIndex = 0u; argumentIndex < argumentCount; ++argumentIndex)
+    {
+        freeFromAllocator(pMemoryAllocator, ppArguments[argumentIndex]);
+    }
+    freeFromAllocator(pMemoryAllocator, ppArguments);
+
+    return result_status_t::out_of_memory;
+}
+
+constexpr uint32_t shaderCacheEntryMagic        = 0x4853354B; // 'K5SH'
+constexpr uint32_t shaderCacheFormatVersion     = 3u;
+constexpr uint32_t maxShaderCachePathLength     = 512u;
+constexpr uint32_t maxShaderIncludeDepth        = 8u;
+
+struct shader_cache_entry_header_t
+{
+    uint32_t            magic;
+    uint32_t            formatVersion;
+    uint64_t            key;
+    uint64_t            shaderBlobHash;
+    uint64_t            reflectionHash;
+    uint32_t            shaderBlobSizeInBytes;
+    uint32_t            padding;
+    shader_reflection_t reflection;
+};
+
+uint32_t getDirectoryLengthOfPath(const char* pFilePath)
+{
+    uint32_t directoryLength = 0u;
+    for(uint32_t characterIndex = 0u; pFilePath[characterIndex] != 0; ++characterIndex)
+    {
+        if(pFilePath[characterIndex] == '/' || pFilePath[characterIndex] == '\\')
+        {
+            directoryLength = characterIndex + 1u;
+        }
+    }
+
+    return directoryLength;
+}
+
+//FK: Hashes name and content of every file included by pShaderSource (recursively). Includes get resolved relative to the
+//    including file first and relative to the working directory second. This doesn't know about #if, so includes that end up
+//    not being used still change the hash - worst case this causes a cache miss.
+uint64_t calculateShaderIncludeHash(memory_allocator_t* pTempAllocator, const char* pFilePath, const char* pShaderSource, const uint32_t includeDepth, uint64_t hash)
+{
+    if(includeDepth == maxShaderIncludeDepth)
+    {
+        logWarning("Includes of shader '%s' are nested deeper than %u levels, ignoring deeper includes for the shader cache key.", pFilePath, maxShaderIncludeDepth);
+        return hash;
+    }
+
+    const uint32_t directoryLength = getDirectoryLengthOfPath(pFilePath);
+
+    const char* pCurrent = pShaderSource;
+    while((pCurrent = strstr(pCurrent, "#include")) != nullptr)
+    {
+        pCurrent += sizeof("#include") - 1u;
+        while(*pCurrent == ' ' || *pCurrent == '\t')
+        {
+            ++pCurrent;
+        }
+
+        const char closingCharacter = *pCurrent == '"' ? '"' : (*pCurrent == '<' ? '>' : 0);
+        if(closingCharacter == 0)
+        {
+            continue;
+        }
+
+        const char* pIncludeNameStart = pCurrent + 1;
+        const char* pIncludeNameEnd = pIncludeNameStart;
+        while(*pIncludeNameEnd != 0 && *pIncludeNameEnd != closingCharacter && *pIncludeNameEnd != '\n')
+        {
+            ++pIncludeNameEnd;
+        }
+
+        if(*pIncludeNameEnd != closingCharacter)
+        {
+            pCurrent = pIncludeNameEnd;
+            continue;
+        }
+
+        pCurrent = pIncludeNameEnd + 1;
+
+        const int includeNameLength = rangeCheckCast<int>(pIncludeNameEnd - pIncludeNameStart);
+        hash = calculateHash(pIncludeNameStart, includeNameLength, hash);
+
+        char includePath[maxShaderCachePathLength];
+        snprintf(includePath, sizeof(includePath), "%.*s%.*s", (int)directoryLength, pFilePath, includeNameLength, pIncludeNameStart);
+
+        result_t<memory_buffer_t> includeResult = readWholeFileIntoNewBuffer(pTempAllocator, includePath);
+        if(!isResultSuccessful(includeResult))
+        {
+            snprintf(includePath, sizeof(includePath), "%.*s", includeNameLength, pIncludeNameStart);
+            includeResult = readWholeFileIntoNewBuffer(pTempAllocator, includePath);
+        }
+
+        //FK: Unresolved includes only contribute their name, the compiler will either find them elsewhere or fail
+        if(!isResultSuccessful(includeResult))
+        {
+            continue;
+        }
+
+        const char* pIncludeSource = (const char*)includeResult.value.pData;
+        hash = calculateHash(pIncludeSource, includeResult.value.sizeInBytes, hash);
+        hash = calculateShaderIncludeHash(pTempAllocator, includePath, pIncludeSource, includeDepth + 1u, hash);
+        freeFromAllocator(pTempAllocator, includeResult.value.pData);
+    }
+
+    return hash;
+}
+
+//FK: The key covers the exact argument vector that gets passed to the compiler, not just the parameters it got generated from.
+//    That way arguments that get added to generateCompilerArgumentsIntoNewBuffer() later on invalidate existing entries.
+uint64_t calculateShaderCacheKey(memory_allocator_t* pTempAllocator, const shader_compiler_context_t* pShaderCompilerContext, const shader_compilation_parameters_t* pParameters, const dxc_arguments_t* pArguments, const memory_buffer_t* pShaderSource)
+{
+    uint64_t key = calculateHash(&shaderCacheFormatVersion, sizeof(shaderCacheFormatVersion));
+    key = calculateHash(&pShaderCompilerContext->compilerVersionHash, sizeof(pShaderCompilerContext->compilerVersionHash), key);
+    key = calculateHash(&pArguments->argumentCount, sizeof(pArguments->argumentCount), key);
+    for(uint32_t argumentIndex = 0u; argumentIndex < pArguments->argumentCount; ++argumentIndex)
+    {
+        //FK: Include the terminator so that argument boundaries are part of the key
+        const wchar_t* pArgument = pArguments->ppArguments[argumentIndex];
+        key = calculateHash(pArgument, (wcslen(pArgument) + 1u) * sizeof(wchar_t), key);
+    }
+
+    key = calculateHash(pShaderSource->pData, pShaderSource->sizeInBytes, key);
+    return calculateShaderIncludeHash(pTempAllocator, pParameters->pFilePath, (const char*)pShaderSource->pData, 0u, key);
+}
+
+bool formatShaderCacheEntryPath(char* pPathBuffer, const uint32_t pathBufferSizeInBytes, const shader_compiler_context_t* pShaderCompilerContext, const uint64_t key)
+{
+    const int pathLength = snprintf(pPathBuffer, pathBufferSizeInBytes, "%s/%016llx.shader", pShaderCompilerContext->pShaderCacheDirectory, (unsigned long long)key);
+    return pathLength > 0 && (uint32_t)pathLength < pathBufferSizeInBytes;
+}
+
+//FK: Returns the cached shader blob allocated from pAllocator or nullptr on a miss. Entries that fail validation get deleted.
+uint8_t* loadShaderCacheEntry(const shader_compiler_context_t* pShaderCompilerContext, shader_cache_statistics_t* pCacheStatistics, memory_allocator_t* pAllocator, const uint64_t key, uint32_t* pOutShaderBlobSizeInBytes, shader_reflection_t* pOutShaderReflection)
+{
+    char entryPath[maxShaderCachePathLength];
+    if(!formatShaderCacheEntryPath(entryPath, sizeof(entryPath), pShaderCompilerContext, key))
+    {
+        return nullptr;
+    }
+
+    FILE* pEntryFileHandle = fopen(entryPath, "rb");
+    if(pEntryFileHandle == nullptr)
+    {
+        return nullptr;
+    }
+
+    uint8_t* pShaderBlob = nullptr;
+    shader_cache_entry_header_t header = {};
+    if(fread(&header, sizeof(header), 1u, pEntryFileHandle) == 1u && 
+       header.magic == shaderCacheEntryMagic && header.formatVersion == shaderCacheFormatVersion && header.key == key && header.shaderBlobSizeInBytes > 0u &&
+       calculateHash(&header.reflection, sizeof(header.reflection)) == header.reflectionHash)
+    {
+        pShaderBlob = (uint8_t*)allocateFromAllocator(pAllocator, header.shaderBlobSizeInBytes);
+        if(pShaderBlob == nullptr)
+        {
+            fclose(pEntryFileHandle);
+            return nullptr;
+        }
+
+        //FK: Reading one byte more than expected detects entries with trailing garbage
+        uint8_t trailingByte = 0u;
+        if(fread(pShaderBlob, 1u, header.shaderBlobSizeInBytes, pEntryFileHandle) != header.shaderBlobSizeInBytes ||
+           fread(&trailingByte, 1u, 1u, pEntryFileHandle) != 0u ||
+           calculateHash(pShaderBlob, header.shaderBlobSizeInBytes) != header.shaderBlobHash)
+        {
+            freeFromAllocator(pAllocator, pShaderBlob);
+            pShaderBlob = nullptr;
+        }
+    }
+
+    fclose(pEntryFileHandle);
+
+    if(pShaderBlob == nullptr)
+    {
+        logWarning("Shader cache entry '%s' is corrupt and will be recreated.", entryPath);
+        remove(entryPath);
+        ++pCacheStatistics->corruptEntryCount;
+        return nullptr;
+    }
+
+    *pOutShaderBlobSizeInBytes = header.shaderBlobSizeInBytes;
+    *pOutShaderReflection = header.reflection;
+    return pShaderBlob;
+}
+
+//FK: Entries get written to a temporary file first and then moved in place, readers never see half written entries
+void storeShaderCacheEntry(const shader_compiler_context_t* pShaderCompilerContext, shader_cache_statistics_t* pCacheStatistics, const uint64_t key, const uint8_t* pShaderBlob, const uint32_t shaderBlobSizeInBytes, const shader_reflection_t* pShaderReflection)
+{
+    static volatile LONG temporaryFileCounter = 0;
+
+    char entryPath[maxShaderCachePathLength];
+    char temporaryEntryPath[maxShaderCachePathLength];
+
+    LARGE_INTEGER timestamp;
+    QueryPerformanceCounter(&timestamp);
+    const LONG temporaryFileIndex = InterlockedIncrement(&temporaryFileCounter);
+    const int temporaryPathLength = snprintf(temporaryEntryPath, sizeof(temporaryEntryPath), "%s/%016llx.%llx_%d.tmp", pShaderCompilerContext->pShaderCacheDirectory, (unsigned long long)key, (unsigned long long)timestamp.QuadPart, (int)temporaryFileIndex);
+    if(!formatShaderCacheEntryPath(entryPath, sizeof(entryPath), pShaderCompilerContext, key) || temporaryPathLength <= 0 || (uint32_t)temporaryPathLength >= sizeof(temporaryEntryPath))
+    {
+        ++pCacheStatistics->writeFailureCount;
+        return;
+    }
+
+    shader_cache_entry_header_t header;
+    clearMemoryWithZeroes(&header);
+    header.magic                    = shaderCacheEntryMagic;
+    header.formatVersion            = shaderCacheFormatVersion;
+    header.key                      = key;
+    header.shaderBlobHash           = calculateHash(pShaderBlob, shaderBlobSizeInBytes);
+    header.reflectionHash           = calculateHash(pShaderReflection, sizeof(shader_reflection_t));
+    header.shaderBlobSizeInBytes    = shaderBlobSizeInBytes;
+    header.reflection               = *pShaderReflection;
+
+    FILE* pEntryFileHandle = fopen(temporaryEntryPath, "wb");
+    if(pEntryFileHandle == nullptr)
+    {
+        logWarning("Could not write shader cache entry '%s'.", temporaryEntryPath);
+        ++pCacheStatistics->writeFailureCount;
+        return;
+    }
+
+    bool writeSucceeded = fwrite(&header, sizeof(header), 1u, pEntryFileHandle) == 1u;
+    writeSucceeded = writeSucceeded && fwrite(pShaderBlob, 1u, shaderBlobSizeInBytes, pEntryFileHandle) == shaderBlobSizeInBytes;
+    writeSucceeded = (fclose(pEntryFileHandle) == 0) && writeSucceeded;
+    writeSucceeded = writeSucceeded && MoveFileExA(temporaryEntryPath, entryPath, MOVEFILE_REPLACE_EXISTING);
+    
+    if(!writeSucceeded)
+    {
+        logWarning("Could not write shader cache entry '%s'.", entryPath);
+        remove(temporaryEntryPath);
+        ++pCacheStatistics->writeFailureCount;
+    }
+}
+
+void addShaderCacheStatistics(shader_cache_statistics_t* pTarget, const shader_cache_statistics_t* pSource)
+{
+    pTarget->hitCount           += pSource->hitCount;
+    pTarget->missCount          += pSource->missCount;
+    pTarget->corruptEntryCount  += pSource->corruptEntryCount;
+    pTarget->writeFailureCount  += pSource->writeFailureCount;
+}
+
+shader_binary_handle_t createShaderBinary(graphics_frame_t* pGraphicsFrame, const uint8_t* pShaderBlob, const uint32_t shaderBlobSizeInBytes, const shader_reflection_t* pShaderReflection)
+{
+    shader_binary_handle_t shaderBinaryHandle = {};
+    shader_binary_t* pShaderBinary = allocateShaderBinary(pGraphicsFrame->pRenderResourceCache, &shaderBinaryHandle);
+    if(pShaderBinary == nullptr)
+    {
+        freeFromAllocator(pGraphicsFrame->pMemoryAllocator, (void*)pShaderBlob);
+        return shaderBinaryHandle;
+    }
+
+    pShaderBinary->pShaderBlob = pShaderBlob;
+    pShaderBinary->shaderBlobHash = calculateHash(pShaderBlob, shaderBlobSizeInBytes);
+    pShaderBinary->shaderBlobSizeInBytes = shaderBlobSizeInBytes;
+    pShaderBinary->reflection = *pShaderReflection;
+
+    return shaderBinaryHandle;
+}
+
+void destroyShaderBinary(graphics_frame_t* pGraphicsFrame, const shader_binary_handle_t shaderBinaryHandle)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+
+    shader_binary_t* pShaderBinary = getShaderBinary(pGraphicsFrame->pRenderResourceCache, shaderBinaryHandle);
+    if(pShaderBinary == nullptr)
+    {
+        return;
+    }
+
+    freeFromAllocator(pGraphicsFrame->pMemoryAllocator, (void*)pShaderBinary->pShaderBlob);
+    freeFromResourceTable(&pGraphicsFrame->pRenderResourceCache->shaderBinaries, shaderBinaryHandle);
+}
+
+shader_resource_binding_type_t getShaderResourceBindingType(const D3D_SHADER_INPUT_TYPE inputType)
+{
+    switch(inputType)
+    {
+        case D3D_SIT_CBUFFER:
+            return shader_resource_binding_constant_buffer;
+        case D3D_SIT_SAMPLER:
+            return shader_resource_binding_sampler;
+        case D3D_SIT_TBUFFER:
+        case D3D_SIT_TEXTURE:
+        case D3D_SIT_STRUCTURED:
+        case D3D_SIT_BYTEADDRESS:
+        case D3D_SIT_RTACCELERATIONSTRUCTURE:
+            return shader_resource_binding_srv;
+        default:
+            return shader_resource_binding_uav;
+    }
+}
+
+bool fillShaderReflection(ID3D12ShaderReflection* pShaderReflection, const char* pShaderFilePath, shader_reflection_t* pOutShaderReflection)
+{
+    D3D12_SHADER_DESC shaderDesc = {};
+    if(COM_CALL(pShaderReflection->GetDesc(&shaderDesc)) != S_OK)
+    {
+        return false;
+    }
+
+    //FK: Only vertex shader inputs get fetched from vertex buffers, everything else is fed by the previous stage
+    if(D3D12_SHVER_GET_TYPE(shaderDesc.Version) == D3D12_SHVER_VERTEX_SHADER)
+    {
+        for(uint32_t parameterIndex = 0u; parameterIndex < shaderDesc.InputParameters; ++parameterIndex)
+        {
+            D3D12_SIGNATURE_PARAMETER_DESC parameterDesc = {};
+            if(COM_CALL(pShaderReflection->GetInputParameterDesc(parameterIndex, &parameterDesc)) != S_OK)
+            {
+                return false;
+            }
+
+            if(parameterDesc.SystemValueType != D3D_NAME_UNDEFINED)
+            {
+                continue;
+            }
+
+            if(pOutShaderReflection->inputAttributeCount == maxVertexAttributeCount)
+            {
+                logWarning("Shader '%s' has more than %u vertex inputs.", pShaderFilePath, maxVertexAttributeCount);
+                return false;
+            }
+
+            shader_input_attribute_t* pInputAttribute = pOutShaderReflection->inputAttributes + pOutShaderReflection->inputAttributeCount++;
+            pInputAttribute->attribute      = findVertexAttributeBySemanticName(parameterDesc.SemanticName);
+            pInputAttribute->semanticIndex  = rangeCheckCast<uint8_t>(parameterDesc.SemanticIndex);
+            if(pInputAttribute->attribute == invalidVertexAttribute)
+            {
+                logWarning("Vertex input '%s%u' of shader '%s' doesn't match any vertex attribute.", parameterDesc.SemanticName, parameterDesc.SemanticIndex, pShaderFilePath);
+            }
+        }
+    }
+
+    for(uint32_t resourceIndex = 0u; resourceIndex < shaderDesc.BoundResources; ++resourceIndex)
+    {
+        D3D12_SHADER_INPUT_BIND_DESC bindDesc = {};
+        if(COM_CALL(pShaderReflection->GetResourceBindingDesc(resourceIndex, &bindDesc)) != S_OK)
+        {
+            return false;
+        }
+
+        if(pOutShaderReflection->resourceBindingCount == maxShaderResourceBindingCount)
+        {
+            logWarning("Shader '%s' has more than %u resource bindings.", pShaderFilePath, maxShaderResourceBindingCount);
+            return false;
+        }
+
+        shader_resource_binding_t* pBinding = pOutShaderReflection->resourceBindings + pOutShaderReflection->resourceBindingCount++;
+        pBinding->type              = getShaderResourceBindingType(bindDesc.Type);
+        pBinding->shaderRegister    = bindDesc.BindPoint;
+        pBinding->registerSpace     = bindDesc.Space;
+        pBinding->bindCount         = bindDesc.BindCount == std::numeric_limits<uint32_t>::max() ? 0u : bindDesc.BindCount;
+
+        D3D12_SHADER_BUFFER_DESC constantBufferDesc = {};
+        if(pBinding->type == shader_resource_binding_constant_buffer &&
+           pShaderReflection->GetConstantBufferByName(bindDesc.Name)->GetDesc(&constantBufferDesc) == S_OK)
+        {
+            pBinding->constantBufferSizeInBytes = constantBufferDesc.Size;
+        }
+    }
+
+    return true;
+}
+
+//FK: Shaders that can't be reflected still get compiled, pipeline states fall back to the whole vertex format and a root
+//    signature without root parameters for them
+void extractShaderReflection(IDxcUtils* pShaderUtils, IDxcResult* pCompileResult, const char* pShaderFilePath, shader_reflection_t* pOutShaderReflection)
+{
+    clearMemoryWithZeroes(pOutShaderReflection);
+    if(!pCompileResult->HasOutput(DXC_OUT_REFLECTION))
+    {
+        logWarning("Shader compiler didn't output reflection data for shader '%s'.", pShaderFilePath);
+        return;
+    }
+
+    IDxcBlob* pReflectionBlob = nullptr;
+    if(COM_CALL(pCompileResult->GetOutput(DXC_OUT_REFLECTION, IID_PPV_ARGS(&pReflectionBlob), nullptr)) != S_OK)
+    {
+        return;
+    }
+
+    DxcBuffer reflectionBuffer = {};
+    reflectionBuffer.Ptr    = pReflectionBlob->GetBufferPointer();
+    reflectionBuffer.Size   = pReflectionBlob->GetBufferSize();
+
+    ID3D12ShaderReflection* pShaderReflection = nullptr;
+    const HRESULT reflectionResult = COM_CALL(pShaderUtils->CreateReflection(&reflectionBuffer, IID_PPV_ARGS(&pShaderReflection)));
+    pReflectionBlob->Release();
+    if(reflectionResult != S_OK)
+    {
+        logWarning("Could not reflect shader '%s' - error: %s.", pShaderFilePath, getHResultString(reflectionResult));
+        return;
+    }
+
+    const bool reflectionIsValid = fillShaderReflection(pShaderReflection, pShaderFilePath, pOutShaderReflection);
+    pShaderReflection->Release();
+
+    if(!reflectionIsValid)
+    {
+        clearMemoryWithZeroes(pOutShaderReflection);
+        return;
+    }
+
+    pOutShaderReflection->isValid = 1u;
+}
+
+//FK: Returns the shader blob allocated from pAllocator or nullptr if the shader couldn't be compiled. The worker is the only
+//    state that gets modified, so this can run on multiple threads in parallel as long as each thread uses its own worker.
+uint8_t* compileShaderBlob(const shader_compiler_context_t* pShaderCompilerContext, shader_compiler_worker_t* pWorker, memory_allocator_t* pAllocator, const shader_compilation_parameters_t* pParameters, uint32_t* pOutShaderBlobSizeInBytes, shader_reflection_t* pOutShaderReflection)
+{
+    ASSERT_DEBUG(pWorker != nullptr);
+    ASSERT_DEBUG(pParameters != nullptr);
+    ASSERT_DEBUG(pParameters->pEntryPoint != nullptr)
+    ASSERT_DEBUG(pParameters->pFilePath != nullptr);
+    ASSERT_DEBUG(pParameters->pShaderProfile != nullptr);
+    result_t<memory_buffer_t> shaderCodeResult = readWholeFileIntoNewBuffer(pWorker->pTempAllocator, pParameters->pFilePath);
+    if(!isResultSuccessful(shaderCodeResult))
+    {
+        logError("Could not read shader file '%s' - error: %s.", pParameters->pFilePath, getResultString(shaderCodeResult));
+        return nullptr;
+    }
+
+    result_t<dxc_arguments_t> compileArgumentsResult = generateCompilerArgumentsIntoNewBuffer(pWorker->pTempAllocator, pParameters);
+    if(!isResultSuccessful(compileArgumentsResult))
+    {
+        logError("Could not generate compiler arguments for shader file '%s' - error: %s.", pParameters->pFilePath, getResultString(compileArgumentsResult));
+        freeFromAllocator(pWorker->pTempAllocator, shaderCodeResult.value.pData);
+        return nullptr;
+    }
+
+    //FK: Cache hits skip the compiler completely
+    const bool useShaderCache = pShaderCompilerContext->pShaderCacheDirectory != nullptr;
+    uint64_t shaderCacheKey = 0u;
+    if(useShaderCache)
+    {
+        shaderCacheKey = calculateShaderCacheKey(pWorker->pTempAllocator, pShaderCompilerContext, pParameters, &compileArgumentsResult.value, &shaderCodeResult.value);
+
+        uint32_t cachedShaderBlobSizeInBytes = 0u;
+        uint8_t* pCachedShaderBlob = loadShaderCacheEntry(pShaderCompilerContext, &pWorker->cacheStatistics, pAllocator, shaderCacheKey, &cachedShaderBlobSizeInBytes, pOutShaderReflection);
+        if(pCachedShaderBlob != nullptr)
+        {
+            ++pWorker->cacheStatistics.hitCount;
+            freeCompilerArguments(pWorker->pTempAllocator, &compileArgumentsResult.value);
+            freeFromAllocator(pWorker->pTempAllocator, shaderCodeResult.value.pData);
+            *pOutShaderBlobSizeInBytes = cachedShaderBlobSizeInBytes;
+            return pCachedShaderBlob;
+        }
+
+        ++pWorker->cacheStatistics.missCount;
+    }
+
+    DxcBuffer shaderSourceBuffer = {};
+    shaderSourceBuffer.Ptr = shaderCodeResult.value.pData;
+    shaderSourceBuffer.Size = shaderCodeResult.value.sizeInBytes;
+
+    IDxcResult* pCompileResult = nullptr;
+    const HRESULT compileResult = COM_CALL(pWorker->pShaderCompiler->Compile(&shaderSourceBuffer, compileArgumentsResult.value.ppArguments, compileArgumentsResult.value.argumentCount, pWorker->pIncludeHandler, IID_PPV_ARGS(&pCompileResult)));
+    
+    freeCompilerArguments(pWorker->pTempAllocator, &compileArgumentsResult.value);
+    freeFromAllocator(pWorker->pTempAllocator, shaderCodeResult.value.pData);
+    
+    if(compileResult != S_OK)
+    {
+        logError("Shader compiler couldn't compile shader '%s' - error: %s.", pParameters->pFilePath, getHResultString(compileResult));
+        return nullptr;
+    }
+
+    if(pCompileResult->HasOutput(DXC_OUT_ERRORS))
+    {
+        IDxcBlobEncoding* pErrorBufferEncoding = nullptr;
+        const HRESULT getErrorBufferResult = COM_CALL(pCompileResult->GetErrorBuffer(&pErrorBufferEncoding));
+        if(getErrorBufferResult != S_OK)
+        {
+            logError("Shader compilation of shader '%s' failed but the error couldn't get retrieved - error: %s.", pParameters->pFilePath, getHResultString(getErrorBufferResult));
+            pCompileResult->Release();
+            return nullptr;
+        }
+
+        if(pErrorBufferEncoding != nullptr && pErrorBufferEncoding->GetBufferSize() > 0)
+        {
+            logError("Shader compilation of shader '%s' failed because: %s\n", pParameters->pFilePath, (char*)pErrorBufferEncoding->GetBufferPointer());
+            pErrorBufferEncoding->Release();
+            pCompileResult->Release();
+            return nullptr;
+        }
+    }
+
+    IDxcBlob* pCompileShaderBlob = nullptr;
+    const HRESULT getBlobOutputResult = COM_CALL(pCompileResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&pCompileShaderBlob), nullptr));
+    if(getBlobOutputResult != S_OK)
+    {
+        COM_RELEASE(pCompileShaderBlob);
+        pCompileResult->Release();
+        logError("Shader compilation of shader '%s' was successful but there's no shader blob. GetOutput() error: %s", pParameters->pFilePath, getHResultString(getBlobOutputResult));
+        return nullptr;
     }
 
-    IDxcLibrary* pShaderLibrary = nullptr;
-    if(COM_CALL(DxcCreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(&pShaderLibrary))) != S_OK)
+    extractShaderReflection(pWorker->pShaderUtils, pCompileResult, pParameters->pFilePath, pOutShaderReflection);
+    pCompileResult->Release();
+
+    const uint32_t shaderBlobSizeInBytes = rangeCheckCast<uint32_t>(pCompileShaderBlob->GetBufferSize());
+    uint8_t* pShaderBlobCopy = (uint8_t*)allocateFromAllocator(pAllocator, pCompileShaderBlob->GetBufferSize());
+    if(pShaderBlobCopy == nullptr)
     {
-        return false;
+        logError("Shader compilation of shader '%s' was successful but we ran out of memory trying to copy the shader blob.", pParameters->pFilePath);
+        pCompileShaderBlob->Release();
+        return nullptr;
     }
 
-    if(COM_CALL(pShaderLibrary->CreateIncludeHandler(&pShaderCompilerContext->pIncludeHandler) != S_OK))
+    memcpy(pShaderBlobCopy, pCompileShaderBlob->GetBufferPointer(), pCompileShaderBlob->GetBufferSize());
+    pCompileShaderBlob->Release();
+
+    if(useShaderCache)
     {
-        pShaderLibrary->Release();
-        return false;
+        storeShaderCacheEntry(pShaderCompilerContext, &pWorker->cacheStatistics, shaderCacheKey, pShaderBlobCopy, shaderBlobSizeInBytes, pOutShaderReflection);
     }
 
-    pShaderLibrary->Release();
-    return true;
+    *pOutShaderBlobSizeInBytes = shaderBlobSizeInBytes;
+    return pShaderBlobCopy;
 }
 
-template<typename T>
-void createDynamicArrayWithPreallocatedMemory(base_dynamic_array_t* pOutArray, memory_allocator_t* pMemoryAllocator, void* pPreallocatedMemory, const uint32_t elementCapacity)
+//FK: Worker for compiling on the thread that owns the frame, uses the compiler of the context and the temp memory of the frame
+shader_compiler_worker_t createFrameShaderCompilerWorker(graphics_frame_t* pGraphicsFrame)
 {
-    pOutArray->pMemoryAllocator     = pMemoryAllocator;
-    pOutArray->pData                = (T*)pPreallocatedMemory;
-    pOutArray->count                = 0u;
-    pOutArray->capacity             = elementCapacity;
-    pOutArray->elementSizeInBytes   = sizeof(T);
+    shader_compiler_worker_t worker = {};
+    worker.pShaderCompiler  = pGraphicsFrame->pShaderCompilerContext->pShaderCompiler;
+    worker.pShaderUtils     = pGraphicsFrame->pShaderCompilerContext->pShaderUtils;
+    worker.pIncludeHandler  = pGraphicsFrame->pShaderCompilerContext->pIncludeHandler;
+    worker.pTempAllocator   = &pGraphicsFrame->tempMemoryAllocator;
+    return worker;
 }
 
-void* pushBackFromDynamicArrayDontGrow(base_dynamic_array_t* pArray, const uint32_t count)
+shader_binary_handle_t loadAndCompileShaderCodeFromFile(graphics_frame_t* pGraphicsFrame, const shader_compilation_parameters_t* pParameters)
 {
-    const uint32_t newArrayCount = pArray->count + count;
-    if(newArrayCount >= pArray->capacity)
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+
+    shader_compiler_context_t* pShaderCompilerContext = pGraphicsFrame->pShaderCompilerContext;
+    shader_compiler_worker_t worker = createFrameShaderCompilerWorker(pGraphicsFrame);
+
+    uint32_t shaderBlobSizeInBytes = 0u;
+    shader_reflection_t shaderReflection;
+    uint8_t* pShaderBlob = compileShaderBlob(pShaderCompilerContext, &worker, pGraphicsFrame->pMemoryAllocator, pParameters, &shaderBlobSizeInBytes, &shaderReflection);
+    addShaderCacheStatistics(&pShaderCompilerContext->cacheStatistics, &worker.cacheStatistics);
+    if(pShaderBlob == nullptr)
     {
-        return nullptr;
+        return createInvalidResourceHandle<shader_binary_handle_t>();
     }
 
-    void* pData = (uint8_t*)pArray->pData + pArray->count * pArray->elementSizeInBytes;
-    pArray->count += count;
-
-    return pData;
+    return createShaderBinary(pGraphicsFrame, pShaderBlob, shaderBlobSizeInBytes, &shaderReflection);
 }
 
-uint32_t calculateNewDynamicArrayCapacity(const base_dynamic_array_t* pArray)
+struct shader_batch_result_t
 {
-    return pArray->capacity * 2u;
-}
+    uint32_t                shaderIndex;    // index into the parameters passed to compileShaderBatch()
+    shader_binary_handle_t  shaderBinary;   // invalid if the shader couldn't be compiled
+};
+
+typedef void(*shader_batch_result_fnc)(const shader_batch_result_t* pResult, void* pUserData);
+
+struct shader_batch_context_t
+{
+    graphics_frame_t*                       pGraphicsFrame;
+    const shader_compilation_parameters_t*  pParameters;
+    shader_binary_handle_t*                 pOutShaderBinaries;
+    shader_batch_result_fnc                 pResultFnc;
+    void*                                   pUserData;
+    uint32_t                                shaderCount;
+    uint32_t                                failedShaderCount;
+    volatile LONG                           nextShaderIndex;
+    volatile LONG                           nextWorkerIndex;
+    SRWLOCK                                 resultLock;
+};
 
-bool tryToGrowDynamicArray(base_dynamic_array_t* pArray)
+//FK: The render resource cache isn't thread safe, so results get published one at a time
+void publishShaderBatchResult(shader_batch_context_t* pBatchContext, const uint32_t shaderIndex, const uint8_t* pShaderBlob, const uint32_t shaderBlobSizeInBytes, const shader_reflection_t* pShaderReflection)
 {
-    const uint32_t newCapacity = calculateNewDynamicArrayCapacity(pArray);
-    void* pNewData = allocateFromAllocator(pArray->pMemoryAllocator, newCapacity * pArray->elementSizeInBytes);
-    if(pNewData == nullptr)
+    AcquireSRWLockExclusive(&pBatchContext->resultLock);
+
+    shader_batch_result_t result = {};
+    result.shaderIndex  = shaderIndex;
+    result.shaderBinary = createInvalidResourceHandle<shader_binary_handle_t>();
+
+    if(pShaderBlob != nullptr)
     {
-        return false;
+        result.shaderBinary = createShaderBinary(pBatchContext->pGraphicsFrame, pShaderBlob, shaderBlobSizeInBytes, pShaderReflection);
     }
 
-    copyMemoryNonOverlapping(pNewData, pArray->pData, pArray->capacity * pArray->elementSizeInBytes);
-    freeFromAllocator(pArray->pMemoryAllocator, pArray->pData);
-    pArray->pData = pNewData;
-    pArray->capacity = newCapacity;
+    if(isInvalidResourceHandle(result.shaderBinary))
+    {
+        ++pBatchContext->failedShaderCount;
+    }
 
-    return true;
+    pBatchContext->pOutShaderBinaries[shaderIndex] = result.shaderBinary;
+    if(pBatchContext->pResultFnc != nullptr)
+    {
+        pBatchContext->pResultFnc(&result, pBatchContext->pUserData);
+    }
+
+    ReleaseSRWLockExclusive(&pBatchContext->resultLock);
 }
 
-render_pass_t* createRenderPassChain(render_pass_t* pRenderPasses, const uint32_t renderPassCount)
+void compileShaderBatchOnWorker(shader_batch_context_t* pBatchContext, shader_compiler_worker_t* pWorker)
 {
-    ASSERT_DEBUG(pRenderPasses != nullptr);
-    ASSERT_DEBUG(renderPassCount > 0u);
-
-    render_pass_t* pCurrentRenderPass = pRenderPasses;
-    render_pass_t* pNextRenderPass = pRenderPasses + 1;
-    uint32_t renderPassIndex = 0u;
+    graphics_frame_t* pGraphicsFrame = pBatchContext->pGraphicsFrame;
     while(true)
     {
-        if((renderPassIndex + 1) == renderPassCount)
+        const uint32_t shaderIndex = (uint32_t)InterlockedIncrement(&pBatchContext->nextShaderIndex) - 1u;
+        if(shaderIndex >= pBatchContext->shaderCount)
         {
-            pCurrentRenderPass->pNext = nullptr;
             break;
         }
 
-        pCurrentRenderPass->pNext = pNextRenderPass;
-        pCurrentRenderPass = pNextRenderPass;
-        pNextRenderPass = pNextRenderPass + 1;
-        ++renderPassIndex;
+        uint32_t shaderBlobSizeInBytes = 0u;
+        shader_reflection_t shaderReflection;
+        uint8_t* pShaderBlob = compileShaderBlob(pGraphicsFrame->pShaderCompilerContext, pWorker, pGraphicsFrame->pMemoryAllocator, pBatchContext->pParameters + shaderIndex, &shaderBlobSizeInBytes, &shaderReflection);
+        resetAllocator(&pWorker->tempMemoryAllocator);
+
+        publishShaderBatchResult(pBatchContext, shaderIndex, pShaderBlob, shaderBlobSizeInBytes, &shaderReflection);
     }
+}
 
-    return pRenderPasses;
+void CALLBACK compileShaderBatchThreadpoolCallback(PTP_CALLBACK_INSTANCE pInstance, PVOID pContext, PTP_WORK pWork)
+{
+    UNUSED_PARAMETER(pInstance);
+    UNUSED_PARAMETER(pWork);
+
+    //FK: Every submission of the work object claims one worker and compiles shaders until the batch is done
+    shader_batch_context_t* pBatchContext = (shader_batch_context_t*)pContext;
+    const uint32_t workerIndex = (uint32_t)InterlockedIncrement(&pBatchContext->nextWorkerIndex) - 1u;
+    ASSERT_DEBUG(workerIndex < pBatchContext->pGraphicsFrame->pShaderCompilerContext->workerCount);
+
+    compileShaderBatchOnWorker(pBatchContext, pBatchContext->pGraphicsFrame->pShaderCompilerContext->pWorkers + workerIndex);
 }
 
-bool initRenderPassChain(D3D12DeviceType* pDevice, render_pass_t* pFirstRenderPassInChain)
+//FK: Compiles all shaders on the windows thread pool with at most one thread per core and blocks until all of them are done.
+//    pResultFnc (optional) gets called for every shader as soon as it's done - one call at a time, but from worker threads
+//    and in no particular order. Returns false if any of the shaders couldn't be compiled.
+bool compileShaderBatch(graphics_frame_t* pGraphicsFrame, const shader_compilation_parameters_t* pParameters, const uint32_t shaderCount, shader_binary_handle_t* pOutShaderBinaries, shader_batch_result_fnc pResultFnc, void* pUserData)
 {
-    render_pass_t* pCurrentRenderPass = pFirstRenderPassInChain;
-    while(pCurrentRenderPass != nullptr)
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    ASSERT_DEBUG(pParameters != nullptr || shaderCount == 0u);
+    ASSERT_DEBUG(pOutShaderBinaries != nullptr || shaderCount == 0u);
+
+    shader_batch_context_t batchContext = {};
+    batchContext.pGraphicsFrame     = pGraphicsFrame;
+    batchContext.pParameters        = pParameters;
+    batchContext.pOutShaderBinaries = pOutShaderBinaries;
+    batchContext.pResultFnc         = pResultFnc;
+    batchContext.pUserData          = pUserData;
+    batchContext.shaderCount        = shaderCount;
+    InitializeSRWLock(&batchContext.resultLock);
+
+    shader_compiler_context_t* pShaderCompilerContext = pGraphicsFrame->pShaderCompilerContext;
+    if(pShaderCompilerContext->pWorkers == nullptr && !createShaderCompilerWorkers(pShaderCompilerContext))
     {
-        
-        if(!createCommandAllocator(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT, &pCurrentRenderPass->pGraphicsCommandAllocator))
-        {
-            return false;
-        }
+        logWarning("Could not create shader compiler workers, compiling %u shaders on the calling thread.", shaderCount);
 
-        if(!createCommandList(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT, pCurrentRenderPass->pGraphicsCommandAllocator, &pCurrentRenderPass->pGraphicsCommandList))
+        shader_compiler_worker_t worker = createFrameShaderCompilerWorker(pGraphicsFrame);
+        for(uint32_t shaderIndex = 0u; shaderIndex < shaderCount; ++shaderIndex)
         {
-            return false;
+            uint32_t shaderBlobSizeInBytes = 0u;
+            shader_reflection_t shaderReflection;
+            const uint8_t* pShaderBlob = compileShaderBlob(pShaderCompilerContext, &worker, pGraphicsFrame->pMemoryAllocator, pParameters + shaderIndex, &shaderBlobSizeInBytes, &shaderReflection);
+            publishShaderBatchResult(&batchContext, shaderIndex, pShaderBlob, shaderBlobSizeInBytes, &shaderReflection);
         }
 
-        pCurrentRenderPass = pCurrentRenderPass->pNext;
+        addShaderCacheStatistics(&pShaderCompilerContext->cacheStatistics, &worker.cacheStatistics);
+        return batchContext.failedShaderCount == 0u;
     }
 
-    return true;
-}
+    const uint32_t workerCount = shaderCount < pShaderCompilerContext->workerCount ? shaderCount : pShaderCompilerContext->workerCount;
+    PTP_WORK pWork = CreateThreadpoolWork(compileShaderBatchThreadpoolCallback, &batchContext, nullptr);
+    if(pWork == nullptr)
+    {
+        logWarning("Could not create thread pool work, compiling %u shaders on the calling thread.", shaderCount);
+        compileShaderBatchOnWorker(&batchContext, pShaderCompilerContext->pWorkers);
+    }
+    else
+    {
+        for(uint32_t workerIndex = 0u; workerIndex < workerCount; ++workerIndex)
+        {
+            SubmitThreadpoolWork(pWork);
+        }
 
-bool createRenderResourceCache(D3D12DeviceType* pDevice, render_resource_cache_t* pOutRenderResourceCache, memory_allocator_t* pMemoryAllocator, const render_context_parameters_t::limits_t* pLimits, const bool notifyOnLimitReach)
-{
-    uint64_t totalAllocationSizeInBytes = 0u;
-    totalAllocationSizeInBytes += sizeof(vertex_buffer_t) * pLimits->maxVertexBufferCount;
-    totalAllocationSizeInBytes += sizeof(vertex_format_t) * pLimits->maxVertexFormatCount;
-    totalAllocationSizeInBytes += sizeof(shader_binary_t) * pLimits->maxShaderBinaryCount;
-    totalAllocationSizeInBytes += sizeof(render_target_t) * pLimits->maxRenderTargetCount;
-    totalAllocationSizeInBytes += sizeof(graphics_pipeline_state_t) * pLimits->maxPipelineStateCount;
-    totalAllocationSizeInBytes += sizeof(upload_buffer_t) * pLimits->maxUploadBufferCount;
-    totalAllocationSizeInBytes += sizeof(render_pass_t) * pLimits->maxRenderPassCount;
+        WaitForThreadpoolWorkCallbacks(pWork, FALSE);
+        CloseThreadpoolWork(pWork);
+    }
 
-    uint8_t* pResourceBlob = (uint8_t*)allocateFromAllocator(pMemoryAllocator, totalAllocationSizeInBytes, alloc_flag_clear_memory);
-    if(pResourceBlob == nullptr)
+    for(uint32_t workerIndex = 0u; workerIndex < pShaderCompilerContext->workerCount; ++workerIndex)
     {
-        return false;
+        shader_compiler_worker_t* pWorker = pShaderCompilerContext->pWorkers + workerIndex;
+        addShaderCacheStatistics(&pShaderCompilerContext->cacheStatistics, &pWorker->cacheStatistics);
+        pWorker->cacheStatistics = {};
     }
 
-    uint64_t offsetInBytes = 0u;
-    createDynamicArrayWithPreallocatedMemory<vertex_buffer_t>(&pOutRenderResourceCache->vertexBuffers, pMemoryAllocator, pResourceBlob + offsetInBytes, pLimits->maxVertexBufferCount);
-    offsetInBytes += sizeof(vertex_buffer_t) * pLimits->maxVertexBufferCount;
+    return batchContext.failedShaderCount == 0u;
+}
 
-    createDynamicArrayWithPreallocatedMemory<vertex_format_t>(&pOutRenderResourceCache->vertexFormats, pMemoryAllocator, pResourceBlob + offsetInBytes, pLimits->maxVertexFormatCount);
-    offsetInBytes += sizeof(vertex_format_t) * pLimits->maxVertexFormatCount;
-    
-    createDynamicArrayWithPreallocatedMemory<shader_binary_t>(&pOutRenderResourceCache->shaderBinaries, pMemoryAllocator, pResourceBlob + offsetInBytes, pLimits->maxShaderBinaryCount);
-    offsetInBytes += sizeof(shader_binary_t) * pLimits->maxShaderBinaryCount;
+constexpr uint32_t maxShaderPermutationKeywordCount     = 12u;     // lookup table is a flat array with one entry per permutation
+constexpr uint32_t maxShaderPermutationDefinesLength    = 1024u;
+
+enum shader_permutation_state_t : uint8_t
+{
+    shader_permutation_not_compiled = 0,
+    shader_permutation_compiled,
+    shader_permutation_failed
+};
 
-    createDynamicArrayWithPreallocatedMemory<render_target_t>(&pOutRenderResourceCache->renderTargets, pMemoryAllocator, pResourceBlob + offsetInBytes, pLimits->maxRenderTargetCount);
-    offsetInBytes += sizeof(render_target_t) * pLimits->maxRenderTargetCount;
+struct shader_permutation_set_parameters_t
+{
+    const char*         pShaderProfile;
+    const char*         pFilePath;
+    const char*         pEntryPoint;
+    const char*         pDefines;       // optional, defined for every permutation
+    const char* const*  ppKeywords;     // keyword n gets defined when bit n of the permutation mask is set
+    uint32_t            keywordCount;
+};
 
-    createDynamicArrayWithPreallocatedMemory<graphics_pipeline_state_t>(&pOutRenderResourceCache->pipelineStates, pMemoryAllocator, pResourceBlob + offsetInBytes, pLimits->maxPipelineStateCount);
-    offsetInBytes += sizeof(graphics_pipeline_state_t) * pLimits->maxPipelineStateCount;
+struct shader_permutation_statistics_t
+{
+    uint32_t compiledPermutationCount;
+    uint32_t deduplicatedPermutationCount;  // permutations that compiled to the same blob as an earlier permutation
+    uint32_t failedPermutationCount;
+};
 
-    createDynamicArrayWithPreallocatedMemory<upload_buffer_t>(&pOutRenderResourceCache->uploadBuffers, pMemoryAllocator, pResourceBlob + offsetInBytes, pLimits->maxUploadBufferCount);
-    offsetInBytes += sizeof(upload_buffer_t) * pLimits->maxUploadBufferCount;
+struct shader_permutation_binary_t
+{
+    uint64_t                shaderBlobHash;
+    shader_binary_handle_t  shaderBinary;
+};
 
-    createDynamicArrayWithPreallocatedMemory<render_pass_t>(&pOutRenderResourceCache->renderPasses, pMemoryAllocator, pResourceBlob + offsetInBytes, pLimits->maxRenderPassCount);
-    offsetInBytes += sizeof(render_pass_t) * pLimits->maxRenderPassCount;
+struct shader_permutation_set_t
+{
+    memory_allocator_t*             pMemoryAllocator;
+    shader_permutation_binary_t*    pUniqueBinaries;
+    shader_binary_handle_t*         pPermutations;          // indexed by permutation mask
+    uint8_t*                        pPermutationStates;     // shader_permutation_state_t, indexed by permutation mask
+    const char*                     pKeywords[maxShaderPermutationKeywordCount];
+    shader_compilation_parameters_t baseParameters;
+    uint32_t                        keywordCount;
+    uint32_t                        permutationCount;
+    uint32_t                        uniqueBinaryCount;
+    shader_permutation_statistics_t statistics;
+};
 
-    pOutRenderResourceCache->flags = 0u;
-    pOutRenderResourceCache->pMemoryAllocator = pMemoryAllocator;
-    
-    if(notifyOnLimitReach)
+const char* copyStringIntoBuffer(char** ppBuffer, const char* pString)
+{
+    if(pString == nullptr)
     {
-        pOutRenderResourceCache->flags |= render_resource_flags_t::notify_on_array_grow;
+        return nullptr;
     }
 
-    pOutRenderResourceCache->pFirstFreeRenderPass = createRenderPassChain((render_pass_t*)pOutRenderResourceCache->renderPasses.pData, pOutRenderResourceCache->renderPasses.capacity);
-    if(!initRenderPassChain(pDevice, pOutRenderResourceCache->pFirstFreeRenderPass))
-    {
-        return false;
-    }
+    char* pStringCopy = *ppBuffer;
+    const size_t stringSizeInBytes = strlen(pString) + 1u;
+    memcpy(pStringCopy, pString, stringSizeInBytes);
+    *ppBuffer += stringSizeInBytes;
 
-    return true;
+    return pStringCopy;
 }
 
-bool createRenderContext(render_context_t* pRenderContext, const render_context_parameters_t* pParameters)
+uint64_t getStringSizeInBytes(const char* pString)
 {
-    ASSERT_DEBUG(isValidRenderContextParameters(pParameters));
+    return pString != nullptr ? strlen(pString) + 1u : 0u;
+}
 
-    memory_allocator_t* pAllocator = pParameters->pAllocator;
-    if(pAllocator != nullptr)
-    {
-        pRenderContext->defaultAllocator = *pAllocator;
-    }
-    else
-    {
-        createDefaultMemoryAllocator(&pRenderContext->defaultAllocator);
-    }
+bool createShaderPermutationSet(shader_permutation_set_t* pOutPermutationSet, memory_allocator_t* pMemoryAllocator, const shader_permutation_set_parameters_t* pParameters)
+{
+    ASSERT_DEBUG(pOutPermutationSet != nullptr);
+    ASSERT_DEBUG(pMemoryAllocator != nullptr);
+    ASSERT_DEBUG(pParameters != nullptr);
+    ASSERT_DEBUG(pParameters->pFilePath != nullptr && pParameters->pEntryPoint != nullptr && pParameters->pShaderProfile != nullptr);
+    ASSERT_DEBUG(pParameters->ppKeywords != nullptr || pParameters->keywordCount == 0u);
 
-    bool useDebugLayer = pParameters->flags & render_context_flags_t::use_debug_layer;
-    if(useDebugLayer)
+    if(pParameters->keywordCount > maxShaderPermutationKeywordCount)
     {
-        useDebugLayer = enableD3D12DebugLayer(&pRenderContext->pDebugLayer);
+        logError("Shader '%s' declares %u keywords, only %u are supported.", pParameters->pFilePath, pParameters->keywordCount, maxShaderPermutationKeywordCount);
+        return false;
     }
 
-    if(!createD3D12Factory(&pRenderContext->pFactory))
+    if(pParameters->pDefines != nullptr && !isValidCompilerDefines(pParameters->pDefines))
     {
+        logError("Invalid shader compiler defines '%s' for shader '%s'.", pParameters->pDefines, pParameters->pFilePath);
         return false;
     }
 
-    if(!createD3D12Device(&pRenderContext->pDevice))
+    uint64_t stringSizeInBytes = getStringSizeInBytes(pParameters->pShaderProfile) + getStringSizeInBytes(pParameters->pFilePath) + 
+                                 getStringSizeInBytes(pParameters->pEntryPoint) + getStringSizeInBytes(pParameters->pDefines);
+    for(uint32_t keywordIndex = 0u; keywordIndex < pParameters->keywordCount; ++keywordIndex)
     {
-        return false;
+        const char* pKeyword = pParameters->ppKeywords[keywordIndex];
+        if(pKeyword == nullptr || pKeyword[0] == 0 || findFirstInstanceOfCharacterInString(pKeyword, ';') != nullptr)
+        {
+            logError("Invalid keyword '%s' for shader '%s'.", pKeyword != nullptr ? pKeyword : "", pParameters->pFilePath);
+            return false;
+        }
+
+        stringSizeInBytes += getStringSizeInBytes(pKeyword);
     }
 
-    if(!createCommandQueue(pRenderContext->pDevice, &pRenderContext->pDefaultDirectCommandQueue, D3D12_COMMAND_LIST_TYPE_DIRECT))
+    //FK: Everything lives in a single allocation, the strings get copied so the caller doesn't have to keep them alive
+    const uint32_t permutationCount = 1u << pParameters->keywordCount;
+    const uint64_t sizeInBytes = sizeof(shader_permutation_binary_t) * permutationCount +
+                                 sizeof(shader_binary_handle_t) * permutationCount +
+                                 sizeof(uint8_t) * permutationCount +
+                                 stringSizeInBytes;
+
+    uint8_t* pMemory = (uint8_t*)allocateFromAllocator(pMemoryAllocator, sizeInBytes, alloc_flag_clear_memory);
+    if(pMemory == nullptr)
     {
+        logError("Could not allocate %.3fKiB for the %u permutations of shader '%s'.", (float)sizeInBytes / 1024.f, permutationCount, pParameters->pFilePath);
         return false;
     }
 
-    if(!createCommandQueue(pRenderContext->pDevice, &pRenderContext->pDefaultCopyCommandQueue, D3D12_COMMAND_LIST_TYPE_COPY))
+    shader_permutation_set_t permutationSet = {};
+    permutationSet.pMemoryAllocator     = pMemoryAllocator;
+    permutationSet.pUniqueBinaries      = (shader_permutation_binary_t*)pMemory;   pMemory += sizeof(shader_permutation_binary_t) * permutationCount;
+    permutationSet.pPermutations        = (shader_binary_handle_t*)pMemory;        pMemory += sizeof(shader_binary_handle_t) * permutationCount;
+    permutationSet.pPermutationStates   = pMemory;                                  pMemory += sizeof(uint8_t) * permutationCount;
+    permutationSet.keywordCount         = pParameters->keywordCount;
+    permutationSet.permutationCount     = permutationCount;
+
+    char* pStringBuffer = (char*)pMemory;
+    permutationSet.baseParameters.pShaderProfile    = copyStringIntoBuffer(&pStringBuffer, pParameters->pShaderProfile);
+    permutationSet.baseParameters.pFilePath         = copyStringIntoBuffer(&pStringBuffer, pParameters->pFilePath);
+    permutationSet.baseParameters.pEntryPoint       = copyStringIntoBuffer(&pStringBuffer, pParameters->pEntryPoint);
+    permutationSet.baseParameters.pDefines          = copyStringIntoBuffer(&pStringBuffer, pParameters->pDefines);
+
+    for(uint32_t keywordIndex = 0u; keywordIndex < pParameters->keywordCount; ++keywordIndex)
     {
-        return false;
+        permutationSet.pKeywords[keywordIndex] = copyStringIntoBuffer(&pStringBuffer, pParameters->ppKeywords[keywordIndex]);
     }
 
-    if(!createSwapChain(&pRenderContext->swapChain, &pRenderContext->defaultAllocator, pRenderContext->pFactory, pRenderContext->pDevice, pRenderContext->pDefaultDirectCommandQueue, pParameters->pWindowHandle, pParameters->windowWidth, pParameters->windowHeight, pParameters->frameBufferCount))
+    for(uint32_t permutationIndex = 0u; permutationIndex < permutationCount; ++permutationIndex)
     {
-        return false;
+        permutationSet.pPermutations[permutationIndex] = createInvalidResourceHandle<shader_binary_handle_t>();
     }
 
-    if(!createShaderCompilerContext(pAllocator, &pRenderContext->shaderCompilerContext))
+    *pOutPermutationSet = permutationSet;
+    return true;
+}
+
+void destroyShaderPermutationSet(graphics_frame_t* pGraphicsFrame, shader_permutation_set_t* pPermutationSet)
+{
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    ASSERT_DEBUG(pPermutationSet != nullptr);
+
+    //FK: Deduplicated permutations share their binary, so only the unique ones get destroyed
+    for(uint32_t binaryIndex = 0u; binaryIndex < pPermutationSet->uniqueBinaryCount; ++binaryIndex)
     {
-        return false;
+        destroyShaderBinary(pGraphicsFrame, pPermutationSet->pUniqueBinaries[binaryIndex].shaderBinary);
     }
 
-    graphics_frame_parameters_t graphicsFrameParameters = {};
-    graphicsFrameParameters.maxRenderPassCount              = pParameters->limits.maxRenderPassCount;
-    graphicsFrameParameters.maxUploadBufferCount            = pParameters->limits.maxUploadBufferCount;
-    graphicsFrameParameters.maxVertexBufferCount            = pParameters->limits.maxVertexBufferCount;
-    graphicsFrameParameters.defaultStagingBufferSizeInBytes = pParameters->limits.defaultStagingBufferSizeInBytes;
-    if(!createGraphicsFrameCollection(&pRenderContext->graphicsFramesCollection, &graphicsFrameParameters, &pRenderContext->defaultAllocator, &pRenderContext->renderResourceCache, &pRenderContext->shaderCompilerContext, pRenderContext->pDevice, pParameters->frameBufferCount))
+    freeFromAllocator(pPermutationSet->pMemoryAllocator, pPermutationSet->pUniqueBinaries);
+    *pPermutationSet = {};
+}
+
+//FK: Returns 0 for keywords that the shader doesn't declare, so masks can be built from names without checking every keyword
+uint32_t getShaderPermutationKeywordMask(const shader_permutation_set_t* pPermutationSet, const char* pKeyword)
+{
+    ASSERT_DEBUG(pPermutationSet != nullptr);
+    ASSERT_DEBUG(pKeyword != nullptr);
+
+    for(uint32_t keywordIndex = 0u; keywordIndex < pPermutationSet->keywordCount; ++keywordIndex)
     {
-        return false;
+        if(strcmp(pPermutationSet->pKeywords[keywordIndex], pKeyword) == 0)
+        {
+            return 1u << keywordIndex;
+        }
     }
 
-    if(useDebugLayer)
+    logWarning("Shader '%s' doesn't declare keyword '%s'.", pPermutationSet->baseParameters.pFilePath, pKeyword);
+    return 0u;
+}
+
+bool formatShaderPermutationDefines(char* pDefinesBuffer, const uint32_t definesBufferSizeInBytes, const shader_permutation_set_t* pPermutationSet, const uint32_t permutationMask)
+{
+    uint32_t definesLength = 0u;
+    pDefinesBuffer[0] = 0;
+
+    const char* pBaseDefines = pPermutationSet->baseParameters.pDefines;
+    if(pBaseDefines != nullptr && pBaseDefines[0] != 0)
     {
-        if(!setupD3D12DebugLayer(pRenderContext->pDevice))
+        const int charactersPrinted = sprintf_s(pDefinesBuffer, definesBufferSizeInBytes, "%s", pBaseDefines);
+        if(charactersPrinted < 0 || (uint32_t)charactersPrinted >= definesBufferSizeInBytes)
         {
-
+            return false;
         }
+
+        definesLength = (uint32_t)charactersPrinted;
     }
 
-    const bool notifyOnLimitReach = pParameters->flags & render_context_flags_t::notify_on_limit_reach;
-    if(!createRenderResourceCache(pRenderContext->pDevice, &pRenderContext->renderResourceCache, &pRenderContext->defaultAllocator, &pParameters->limits, notifyOnLimitReach))
+    for(uint32_t keywordIndex = 0u; keywordIndex < pPermutationSet->keywordCount; ++keywordIndex)
     {
-        return false;
-    }
+        if((permutationMask & (1u << keywordIndex)) == 0u)
+        {
+            continue;
+        }
 
-    pRenderContext->frameIndex = 1u;
+        const int charactersPrinted = sprintf_s(pDefinesBuffer + definesLength, definesBufferSizeInBytes - definesLength, "%s%s", definesLength > 0u ? ";" : "", pPermutationSet->pKeywords[keywordIndex]);
+        if(charactersPrinted < 0 || definesLength + (uint32_t)charactersPrinted >= definesBufferSizeInBytes)
+        {
+            return false;
+        }
+
+        definesLength += (uint32_t)charactersPrinted;
+    }
 
     return true;
 }
 
-graphics_frame_t* beginNextFrame(render_context_t* pRenderContext)
+//FK: Different keyword combinations often compile to the same blob (eg. keywords that a shader variant doesn't use),
+//    these permutations share a single shader binary.
+shader_binary_handle_t registerShaderPermutationBinary(graphics_frame_t* pGraphicsFrame, shader_permutation_set_t* pPermutationSet, const uint32_t permutationMask, const shader_binary_handle_t shaderBinaryHandle)
 {
-    ASSERT_DEBUG(pRenderContext != nullptr);
-    ASSERT_DEBUG(pRenderContext->pCurrentGraphicsFrame == nullptr);
-
-    const uint64_t previousFrameIndex = (pRenderContext->frameIndex - 1) % pRenderContext->graphicsFramesCollection.frameCount;
-    const uint64_t frameIndex = pRenderContext->frameIndex % pRenderContext->graphicsFramesCollection.frameCount;
+    const shader_binary_t* pShaderBinary = getShaderBinary(pGraphicsFrame->pRenderResourceCache, shaderBinaryHandle);
+    if(pShaderBinary == nullptr)
+    {
+        pPermutationSet->pPermutationStates[permutationMask] = shader_permutation_failed;
+        ++pPermutationSet->statistics.failedPermutationCount;
+        return createInvalidResourceHandle<shader_binary_handle_t>();
+    }
 
-    graphics_frame_t* pPreviousFrame = getGraphicsFrameFromGraphicsFrameCollection(&pRenderContext->graphicsFramesCollection, previousFrameIndex);
-    graphics_frame_t* pGraphicsFrame = getGraphicsFrameFromGraphicsFrameCollection(&pRenderContext->graphicsFramesCollection, frameIndex);
-    
-    flushFrame(pGraphicsFrame);
-    resetFrame(pGraphicsFrame);
+    const shader_permutation_binary_t* pDuplicateBinary = nullptr;
+    const uint64_t shaderBlobHash = pShaderBinary->shaderBlobHash;
+    for(uint32_t binaryIndex = 0u; binaryIndex < pPermutationSet->uniqueBinaryCount; ++binaryIndex)
+    {
+        const shader_permutation_binary_t* pUniqueBinary = pPermutationSet->pUniqueBinaries + binaryIndex;
+        if(pUniqueBinary->shaderBlobHash != shaderBlobHash)
+        {
+            continue;
+        }
 
-    const uint32_t currentBackBufferIndex = pRenderContext->swapChain.pSwapChain->GetCurrentBackBufferIndex();
+        const shader_binary_t* pUniqueShaderBinary = getShaderBinary(pGraphicsFrame->pRenderResourceCache, pUniqueBinary->shaderBinary);
+        if(pUniqueShaderBinary->shaderBlobSizeInBytes == pShaderBinary->shaderBlobSizeInBytes &&
+           memcmp(pUniqueShaderBinary->pShaderBlob, pShaderBinary->pShaderBlob, pShaderBinary->shaderBlobSizeInBytes) == 0)
+        {
+            pDuplicateBinary = pUniqueBinary;
+            break;
+        }
+    }
 
-    pRenderContext->pCurrentGraphicsFrame = pGraphicsFrame;
-    pGraphicsFrame->frameIndex = pRenderContext->frameIndex;
-    pGraphicsFrame->pBackBuffer = pRenderContext->swapChain.pBackBuffers + currentBackBufferIndex;
-    ++pRenderContext->frameIndex;
+    shader_binary_handle_t permutationBinaryHandle = shaderBinaryHandle;
+    if(pDuplicateBinary == nullptr)
+    {
+        ASSERT_DEBUG(pPermutationSet->uniqueBinaryCount < pPermutationSet->permutationCount);
+        shader_permutation_binary_t* pUniqueBinary = pPermutationSet->pUniqueBinaries + pPermutationSet->uniqueBinaryCount++;
+        pUniqueBinary->shaderBlobHash   = shaderBlobHash;
+        pUniqueBinary->shaderBinary     = shaderBinaryHandle;
+    }
+    else
+    {
+        destroyShaderBinary(pGraphicsFrame, shaderBinaryHandle);
+        permutationBinaryHandle = pDuplicateBinary->shaderBinary;
+        ++pPermutationSet->statistics.deduplicatedPermutationCount;
+    }
 
-    resetAllocator(&pGraphicsFrame->tempMemoryAllocator);
-    return pGraphicsFrame;
+    ++pPermutationSet->statistics.compiledPermutationCount;
+    pPermutationSet->pPermutations[permutationMask]         = permutationBinaryHandle;
+    pPermutationSet->pPermutationStates[permutationMask]    = shader_permutation_compiled;
+    return permutationBinaryHandle;
 }
 
-void finishFrame(render_context_t* pRenderContext, graphics_frame_t* pGraphicsFrame)
+//FK: O(1) for permutations that have been requested before. The first request of a permutation compiles it on the calling
+//    thread, use compileShaderPermutations() up front to avoid that. Permutations that failed to compile return an invalid
+//    handle without being recompiled.
+shader_binary_handle_t getShaderPermutation(graphics_frame_t* pGraphicsFrame, shader_permutation_set_t* pPermutationSet, const uint32_t permutationMask)
 {
-    ASSERT_DEBUG(pRenderContext != nullptr);
     ASSERT_DEBUG(pGraphicsFrame != nullptr);
-    ASSERT_DEBUG(pRenderContext->pCurrentGraphicsFrame == pGraphicsFrame);
-    ASSERT_DEBUG(pGraphicsFrame->openRenderPassCount == 0u);
-
-    const uint32_t frameBufferIndex = pRenderContext->swapChain.pSwapChain->GetCurrentBackBufferIndex();
-    transitionResource(pGraphicsFrame->pFrameGeneralGraphicsQueue, &pRenderContext->swapChain.pBackBuffers[frameBufferIndex].resource, D3D12_RESOURCE_STATE_PRESENT);
-
-    pGraphicsFrame->pFrameGeneralGraphicsQueue->Close();
-    pRenderContext->pDefaultDirectCommandQueue->ExecuteCommandLists(1u, (ID3D12CommandList* const*)&pGraphicsFrame->pFrameGeneralGraphicsQueue);
+    ASSERT_DEBUG(pPermutationSet != nullptr);
+    ASSERT_DEBUG(permutationMask < pPermutationSet->permutationCount);
 
-    render_pass_t* pRenderPass = pGraphicsFrame->pFirstRenderPassToExecute;
-    while(pRenderPass)
+    const uint8_t permutationState = pPermutationSet->pPermutationStates[permutationMask];
+    if(permutationState == shader_permutation_compiled)
     {
-        pRenderContext->pDefaultDirectCommandQueue->ExecuteCommandLists(1u, (ID3D12CommandList* const*)&pRenderPass->pGraphicsCommandList);
-        pRenderPass = pRenderPass->pNext;
+        return pPermutationSet->pPermutations[permutationMask];
+    }
+    else if(permutationState == shader_permutation_failed)
+    {
+        return createInvalidResourceHandle<shader_binary_handle_t>();
     }
 
-    COM_CALL(pRenderContext->pDefaultDirectCommandQueue->Signal(pGraphicsFrame->pFrameFence, pGraphicsFrame->frameIndex));
+    char defines[maxShaderPermutationDefinesLength];
+    if(!formatShaderPermutationDefines(defines, sizeof(defines), pPermutationSet, permutationMask))
+    {
+        logError("Defines of permutation 0x%x of shader '%s' exceed %u characters.", permutationMask, pPermutationSet->baseParameters.pFilePath, maxShaderPermutationDefinesLength);
+        pPermutationSet->pPermutationStates[permutationMask] = shader_permutation_failed;
+        ++pPermutationSet->statistics.failedPermutationCount;
+        return createInvalidResourceHandle<shader_binary_handle_t>();
+    }
 
-    COM_CALL(pRenderContext->swapChain.pSwapChain->Present(0, DXGI_PRESENT_ALLOW_TEARING));
-    COM_CALL(pGraphicsFrame->pFrameFence->SetEventOnCompletion(pGraphicsFrame->frameIndex, pGraphicsFrame->pFrameFinishedEvent));
+    shader_compilation_parameters_t compilationParameters = pPermutationSet->baseParameters;
+    compilationParameters.pDefines = defines;
 
-    pRenderContext->pCurrentGraphicsFrame = nullptr;
+    const shader_binary_handle_t shaderBinaryHandle = loadAndCompileShaderCodeFromFile(pGraphicsFrame, &compilationParameters);
+    return registerShaderPermutationBinary(pGraphicsFrame, pPermutationSet, permutationMask, shaderBinaryHandle);
 }
 
-void* allocateFromRenderResourceCacheGeneric(base_dynamic_array_t* pResourceArray, const bool notifyOnGrow, const char* pResourceName)
+//FK: Compiles all permutations that haven't been compiled yet in parallel using compileShaderBatch().
+//    Returns false if any of the permutations couldn't be compiled.
+bool compileShaderPermutations(graphics_frame_t* pGraphicsFrame, shader_permutation_set_t* pPermutationSet, const uint32_t* pPermutationMasks, const uint32_t permutationMaskCount)
 {
-    void* pRenderResourceData = pushBackFromDynamicArrayDontGrow(pResourceArray, 1u);
-    if(pRenderResourceData == nullptr)
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    ASSERT_DEBUG(pPermutationSet != nullptr);
+    ASSERT_DEBUG(pPermutationMasks != nullptr || permutationMaskCount == 0u);
+
+    //FK: Nothing to compile, also avoids 0 byte temp allocations
+    if(permutationMaskCount == 0u)
+    {
+        return true;
+    }
+
+    memory_allocator_t* pTempAllocator = &pGraphicsFrame->tempMemoryAllocator;
+    shader_compilation_parameters_t* pCompilationParameters = (shader_compilation_parameters_t*)allocateFromAllocator(pTempAllocator, sizeof(shader_compilation_parameters_t) * permutationMaskCount);
+    uint32_t* pBatchPermutationMasks = (uint32_t*)allocateFromAllocator(pTempAllocator, sizeof(uint32_t) * permutationMaskCount);
+    shader_binary_handle_t* pShaderBinaries = (shader_binary_handle_t*)allocateFromAllocator(pTempAllocator, sizeof(shader_binary_handle_t) * permutationMaskCount);
+    char* pDefines = (char*)allocateFromAllocator(pTempAllocator, maxShaderPermutationDefinesLength * permutationMaskCount);
+    if(pCompilationParameters == nullptr || pBatchPermutationMasks == nullptr || pShaderBinaries == nullptr || pDefines == nullptr)
+    {
+        logError("Could not allocate temp memory to compile %u permutations of shader '%s'.", permutationMaskCount, pPermutationSet->baseParameters.pFilePath);
+        return false;
+    }
+
+    bool allPermutationsCompiled = true;
+    uint32_t batchShaderCount = 0u;
+    for(uint32_t maskIndex = 0u; maskIndex < permutationMaskCount; ++maskIndex)
     {
-        if(notifyOnGrow)
+        const uint32_t permutationMask = pPermutationMasks[maskIndex];
+        ASSERT_DEBUG(permutationMask < pPermutationSet->permutationCount);
+
+        //FK: Skip permutations that are compiled already or that are in the batch already
+        bool isAlreadyInBatch = false;
+        for(uint32_t batchIndex = 0u; batchIndex < batchShaderCount && !isAlreadyInBatch; ++batchIndex)
         {
-            logWarning("Reached limit of %u %s. Need to allocate from main memory to make room for more %s, new limit = %u", pResourceArray->capacity, pResourceName, calculateNewDynamicArrayCapacity(pResourceArray), pResourceName);
+            isAlreadyInBatch = pBatchPermutationMasks[batchIndex] == permutationMask;
         }
 
-        if(!tryToGrowDynamicArray(pResourceArray))
+        const uint8_t permutationState = pPermutationSet->pPermutationStates[permutationMask];
+        if(isAlreadyInBatch || permutationState != shader_permutation_not_compiled)
         {
-            return nullptr;
+            allPermutationsCompiled &= permutationState != shader_permutation_failed;
+            continue;
         }
 
-        pRenderResourceData = pushBackFromDynamicArrayDontGrow(pResourceArray, 1u);
-        if(pRenderResourceData == nullptr)
+        char* pPermutationDefines = pDefines + maxShaderPermutationDefinesLength * batchShaderCount;
+        if(!formatShaderPermutationDefines(pPermutationDefines, maxShaderPermutationDefinesLength, pPermutationSet, permutationMask))
         {
-            return nullptr;
+            logError("Defines of permutation 0x%x of shader '%s' exceed %u characters.", permutationMask, pPermutationSet->baseParameters.pFilePath, maxShaderPermutationDefinesLength);
+            pPermutationSet->pPermutationStates[permutationMask] = shader_permutation_failed;
+            ++pPermutationSet->statistics.failedPermutationCount;
+            allPermutationsCompiled = false;
+            continue;
         }
+
+        pCompilationParameters[batchShaderCount] = pPermutationSet->baseParameters;
+        pCompilationParameters[batchShaderCount].pDefines = pPermutationDefines;
+        pBatchPermutationMasks[batchShaderCount] = permutationMask;
+        ++batchShaderCount;
     }
 
-    return pRenderResourceData;
+    compileShaderBatch(pGraphicsFrame, pCompilationParameters, batchShaderCount, pShaderBinaries, nullptr, nullptr);
+
+    //FK: Registering in batch order keeps the deduplication deterministic
+    for(uint32_t batchIndex = 0u; batchIndex < batchShaderCount; ++batchIndex)
+    {
+        const shader_binary_handle_t shaderBinaryHandle = registerShaderPermutationBinary(pGraphicsFrame, pPermutationSet, pBatchPermutationMasks[batchIndex], pShaderBinaries[batchIndex]);
+        allPermutationsCompiled &= !isInvalidResourceHandle(shaderBinaryHandle);
+    }
+
+    freeFromAllocator(pTempAllocator, pDefines);
+    freeFromAllocator(pTempAllocator, pShaderBinaries);
+    freeFromAllocator(pTempAllocator, pBatchPermutationMasks);
+    freeFromAllocator(pTempAllocator, pCompilationParameters);
+
+    return allPermutationsCompiled;
 }
 
-shader_binary_t* allocateShaderBinary(render_resource_cache_t* pRenderResourceCache)
-{
-    return (shader_binary_t*)allocateFromRenderResourceCacheGeneric(&pRenderResourceCache->shaderBinaries, pRenderResourceCache->flags & render_resource_flags_t::notify_on_array_grow, "shader binaries");
+D3D12_BLEND_DESC createDefaultBlendDesc()
+{
+    D3D12_BLEND_DESC defaultBlendDesc = {};
+    defaultBlendDesc.RenderTarget[0].BlendEnable            = FALSE;
+    defaultBlendDesc.RenderTarget[0].LogicOpEnable          = FALSE;
+    defaultBlendDesc.RenderTarget[0].SrcBlend               = D3D12_BLEND_ONE;
+    defaultBlendDesc.RenderTarget[0].DestBlend              = D3D12_BLEND_ZERO;
+    defaultBlendDesc.RenderTarget[0].BlendOp                = D3D12_BLEND_OP_ADD;
+    defaultBlendDesc.RenderTarget[0].SrcBlendAlpha          = D3D12_BLEND_ONE;
+    defaultBlendDesc.RenderTarget[0].DestBlendAlpha         = D3D12_BLEND_ZERO;
+    defaultBlendDesc.RenderTarget[0].BlendOpAlpha           = D3D12_BLEND_OP_ADD;
+    defaultBlendDesc.RenderTarget[0].LogicOp                = D3D12_LOGIC_OP_NOOP;
+    defaultBlendDesc.RenderTarget[0].RenderTargetWriteMask  = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+    return defaultBlendDesc;
 }
 
-vertex_format_t* allocateVertexFormat(render_resource_cache_t* pRenderResourceCache)
-{
-    return (vertex_format_t*)allocateFromRenderResourceCacheGeneric(&pRenderResourceCache->vertexFormats, pRenderResourceCache->flags & render_resource_flags_t::notify_on_array_grow, "vertex formats");
+D3D12_DEPTH_STENCIL_DESC createDefaultDepthStencilDesc()
+{
+    D3D12_DEPTH_STENCIL_DESC defaultDepthStencilState = {};
+    defaultDepthStencilState.DepthEnable                    = TRUE;
+    defaultDepthStencilState.DepthWriteMask                 = D3D12_DEPTH_WRITE_MASK_ALL;
+    defaultDepthStencilState.DepthFunc                      = D3D12_COMPARISON_FUNC_LESS;
+    defaultDepthStencilState.StencilEnable                  = FALSE;
+    defaultDepthStencilState.StencilReadMask                = D3D12_DEFAULT_STENCIL_READ_MASK;
+    defaultDepthStencilState.StencilWriteMask               = D3D12_DEFAULT_STENCIL_WRITE_MASK;
+    defaultDepthStencilState.FrontFace.StencilFailOp        = D3D12_STENCIL_OP_KEEP;
+    defaultDepthStencilState.FrontFace.StencilDepthFailOp   = D3D12_STENCIL_OP_KEEP;
+    defaultDepthStencilState.FrontFace.StencilPassOp        = D3D12_STENCIL_OP_KEEP;
+    defaultDepthStencilState.FrontFace.StencilFunc          = D3D12_COMPARISON_FUNC_ALWAYS;
+    defaultDepthStencilState.BackFace.StencilFailOp         = D3D12_STENCIL_OP_KEEP;
+    defaultDepthStencilState.BackFace.StencilDepthFailOp    = D3D12_STENCIL_OP_KEEP;
+    defaultDepthStencilState.BackFace.StencilPassOp         = D3D12_STENCIL_OP_KEEP;
+    defaultDepthStencilState.BackFace.StencilFunc           = D3D12_COMPARISON_FUNC_ALWAYS;
+
+    return defaultDepthStencilState;
 }
 
-render_pass_t* getFreeRenderPass(render_resource_cache_t* pRenderResourceCache)
+D3D12_RASTERIZER_DESC createDefaultRasterizerDesc()
+{
+    D3D12_RASTERIZER_DESC defaultRasterizerDesc = {};
+    defaultRasterizerDesc.FillMode              = D3D12_FILL_MODE_SOLID;
+    defaultRasterizerDesc.CullMode              = D3D12_CULL_MODE_BACK;
+    defaultRasterizerDesc.FrontCounterClockwise = FALSE;
+    defaultRasterizerDesc.DepthBias             = 0;
+    defaultRasterizerDesc.DepthBiasClamp        = 0.0f;
+    defaultRasterizerDesc.SlopeScaledDepthBias  = 0.0f;
+    defaultRasterizerDesc.DepthClipEnable       = TRUE;
+    defaultRasterizerDesc.MultisampleEnable     = FALSE;
+    defaultRasterizerDesc.AntialiasedLineEnable = FALSE;
+    defaultRasterizerDesc.ForcedSampleCount     = 0;
+    defaultRasterizerDesc.ConservativeRaster    = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
+
+    return defaultRasterizerDesc;
+}
+
+//FK: Opaque triangles into a single R8G8B8A8 render target, shaders and vertex format have to be set by the caller
+graphics_pipeline_state_parameters_t createDefaultGraphicsPipelineStateParameters()
+{
+    graphics_pipeline_state_parameters_t parameters = {};
+    parameters.vertexShader             = createInvalidResourceHandle<shader_binary_handle_t>();
+    parameters.pixelShader              = createInvalidResourceHandle<shader_binary_handle_t>();
+    parameters.vertexFormat             = createInvalidResourceHandle<vertex_format_handle_t>();
+    parameters.blendDesc                = createDefaultBlendDesc();
+    parameters.depthStencilDesc         = createDefaultDepthStencilDesc();
+    parameters.rasterizerDesc           = createDefaultRasterizerDesc();
+    parameters.primitiveTopologyType    = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    parameters.renderTargetFormats[0]   = DXGI_FORMAT_R8G8B8A8_UNORM;
+    parameters.depthStencilFormat       = DXGI_FORMAT_UNKNOWN;
+    parameters.renderTargetCount        = 1u;
+
+    return parameters;
+}
+
+//FK: The descs below contain padding bytes, so they get hashed member by member to keep the hash stable
+uint64_t calculateBlendDescHash(const D3D12_BLEND_DESC* pBlendDesc, const uint32_t renderTargetCount, uint64_t hash)
 {
-    if(pRenderResourceCache->pFirstFreeRenderPass == nullptr)
+    hash = calculateHash(&pBlendDesc->AlphaToCoverageEnable, sizeof(pBlendDesc->AlphaToCoverageEnable), hash);
+    hash = calculateHash(&pBlendDesc->IndependentBlendEnable, sizeof(pBlendDesc->IndependentBlendEnable), hash);
+
+    //FK: Without independent blending only the first render target blend desc is used
+    const uint32_t blendDescCount = pBlendDesc->IndependentBlendEnable ? renderTargetCount : 1u;
+    for(uint32_t renderTargetIndex = 0u; renderTargetIndex < blendDescCount; ++renderTargetIndex)
     {
-        DebugBreak();
+        const D3D12_RENDER_TARGET_BLEND_DESC* pRenderTargetBlendDesc = pBlendDesc->RenderTarget + renderTargetIndex;
+        hash = calculateHash(&pRenderTargetBlendDesc->BlendEnable, sizeof(pRenderTargetBlendDesc->BlendEnable), hash);
+        hash = calculateHash(&pRenderTargetBlendDesc->LogicOpEnable, sizeof(pRenderTargetBlendDesc->LogicOpEnable), hash);
+        hash = calculateHash(&pRenderTargetBlendDesc->SrcBlend, sizeof(pRenderTargetBlendDesc->SrcBlend), hash);
+        hash = calculateHash(&pRenderTargetBlendDesc->DestBlend, sizeof(pRenderTargetBlendDesc->DestBlend), hash);
+        hash = calculateHash(&pRenderTargetBlendDesc->BlendOp, sizeof(pRenderTargetBlendDesc->BlendOp), hash);
+        hash = calculateHash(&pRenderTargetBlendDesc->SrcBlendAlpha, sizeof(pRenderTargetBlendDesc->SrcBlendAlpha), hash);
+        hash = calculateHash(&pRenderTargetBlendDesc->DestBlendAlpha, sizeof(pRenderTargetBlendDesc->DestBlendAlpha), hash);
+        hash = calculateHash(&pRenderTargetBlendDesc->BlendOpAlpha, sizeof(pRenderTargetBlendDesc->BlendOpAlpha), hash);
+        hash = calculateHash(&pRenderTargetBlendDesc->LogicOp, sizeof(pRenderTargetBlendDesc->LogicOp), hash);
+        hash = calculateHash(&pRenderTargetBlendDesc->RenderTargetWriteMask, sizeof(pRenderTargetBlendDesc->RenderTargetWriteMask), hash);
     }
 
-    render_pass_t* pFreeRenderPass = pRenderResourceCache->pFirstFreeRenderPass;
-    pRenderResourceCache->pFirstFreeRenderPass = pFreeRenderPass->pNext;
-    return pFreeRenderPass;
+    return hash;
 }
 
-graphics_pipeline_state_t* allocatePipelineState(render_resource_cache_t* pRenderResourceCache)
-{
-    return (graphics_pipeline_state_t*)allocateFromRenderResourceCacheGeneric(&pRenderResourceCache->pipelineStates, pRenderResourceCache->flags & render_resource_flags_t::notify_on_array_grow, "pipeline state objects");
+uint64_t calculateDepthStencilDescHash(const D3D12_DEPTH_STENCIL_DESC* pDepthStencilDesc, uint64_t hash)
+{
+    hash = calculateHash(&pDepthStencilDesc->DepthEnable, sizeof(pDepthStencilDesc->DepthEnable), hash);
+    hash = calculateHash(&pDepthStencilDesc->DepthWriteMask, sizeof(pDepthStencilDesc->DepthWriteMask), hash);
+    hash = calculateHash(&pDepthStencilDesc->DepthFunc, sizeof(pDepthStencilDesc->DepthFunc), hash);
+    hash = calculateHash(&pDepthStencilDesc->StencilEnable, sizeof(pDepthStencilDesc->StencilEnable), hash);
+    hash = calculateHash(&pDepthStencilDesc->StencilReadMask, sizeof(pDepthStencilDesc->StencilReadMask), hash);
+    hash = calculateHash(&pDepthStencilDesc->StencilWriteMask, sizeof(pDepthStencilDesc->StencilWriteMask), hash);
+    hash = calculateHash(&pDepthStencilDesc->FrontFace, sizeof(pDepthStencilDesc->FrontFace), hash);
+    hash = calculateHash(&pDepthStencilDesc->BackFace, sizeof(pDepthStencilDesc->BackFace), hash);
+    return hash;
 }
 
-upload_buffer_t* allocateUploadBuffer(render_resource_cache_t* pRenderResourceCache)
+uint64_t calculateRootSignatureDescHash(const D3D12_ROOT_SIGNATURE_DESC* pRootSignatureDesc, uint64_t hash)
 {
-    return (upload_buffer_t*)allocateFromRenderResourceCacheGeneric(&pRenderResourceCache->uploadBuffers, pRenderResourceCache->flags & render_resource_flags_t::notify_on_array_grow, "upload buffers");
+    hash = calculateHash(&pRootSignatureDesc->Flags, sizeof(pRootSignatureDesc->Flags), hash);
+    hash = calculateHash(&pRootSignatureDesc->NumParameters, sizeof(pRootSignatureDesc->NumParameters), hash);
+    for(uint32_t parameterIndex = 0u; parameterIndex < pRootSignatureDesc->NumParameters; ++parameterIndex)
+    {
+        const D3D12_ROOT_PARAMETER* pParameter = pRootSignatureDesc->pParameters + parameterIndex;
+        hash = calculateHash(&pParameter->ParameterType, sizeof(pParameter->ParameterType), hash);
+        hash = calculateHash(&pParameter->ShaderVisibility, sizeof(pParameter->ShaderVisibility), hash);
+        switch(pParameter->ParameterType)
+        {
+            case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE:
+                hash = calculateHash(&pParameter->DescriptorTable.NumDescriptorRanges, sizeof(pParameter->DescriptorTable.NumDescriptorRanges), hash);
+                hash = calculateHash(pParameter->DescriptorTable.pDescriptorRanges, sizeof(D3D12_DESCRIPTOR_RANGE) * pParameter->DescriptorTable.NumDescriptorRanges, hash);
+                break;
+            case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+                hash = calculateHash(&pParameter->Constants, sizeof(pParameter->Constants), hash);
+                break;
+            default:
+                hash = calculateHash(&pParameter->Descriptor, sizeof(pParameter->Descriptor), hash);
+                break;
+        }
+    }
+
+    hash = calculateHash(&pRootSignatureDesc->NumStaticSamplers, sizeof(pRootSignatureDesc->NumStaticSamplers), hash);
+    hash = calculateHash(pRootSignatureDesc->pStaticSamplers, sizeof(D3D12_STATIC_SAMPLER_DESC) * pRootSignatureDesc->NumStaticSamplers, hash);
+    return hash;
 }
 
-render_pass_t* startRenderPass(graphics_frame_t* pGraphicsFrame, const char* pRenderPassName, render_target_t* pRenderTarget)
+void appendToFlattenedRootSignatureDesc(uint8_t* pBuffer, uint32_t* pOffsetInBytes, const void* pData, const uint32_t sizeInBytes)
 {
-    ASSERT_DEBUG(pGraphicsFrame != nullptr);
-
-    render_pass_t* pRenderPass = getFreeRenderPass(pGraphicsFrame->pRenderResourceCache);
-    if(pRenderPass == nullptr)
+    if(pBuffer != nullptr && sizeInBytes > 0u)
     {
-        return nullptr;
+        memcpy(pBuffer + *pOffsetInBytes, pData, sizeInBytes);
     }
 
-    ++pGraphicsFrame->openRenderPassCount;
+    *pOffsetInBytes += sizeInBytes;
+}
 
-    COM_CALL(pRenderPass->pGraphicsCommandAllocator->Reset());
-    COM_CALL(pRenderPass->pGraphicsCommandList->Reset(pRenderPass->pGraphicsCommandAllocator, nullptr));
-    pRenderPass->isOpen = true;
-    pRenderPass->pName = pRenderPassName;
-    pRenderPass->pRenderTarget = pRenderTarget;
+//FK: Writes the root signature desc without pointers and padding into pBuffer, so descs can be compared with memcmp().
+//    Covers the same members as calculateRootSignatureDescHash(). Returns the size, pBuffer can be nullptr to query it.
+uint32_t flattenRootSignatureDesc(const D3D12_ROOT_SIGNATURE_DESC* pRootSignatureDesc, uint8_t* pBuffer)
+{
+    uint32_t sizeInBytes = 0u;
+    appendToFlattenedRootSignatureDesc(pBuffer, &sizeInBytes, &pRootSignatureDesc->Flags, sizeof(pRootSignatureDesc->Flags));
+    appendToFlattenedRootSignatureDesc(pBuffer, &sizeInBytes, &pRootSignatureDesc->NumParameters, sizeof(pRootSignatureDesc->NumParameters));
+    for(uint32_t parameterIndex = 0u; parameterIndex < pRootSignatureDesc->NumParameters; ++parameterIndex)
+    {
+        const D3D12_ROOT_PARAMETER* pParameter = pRootSignatureDesc->pParameters + parameterIndex;
+        appendToFlattenedRootSignatureDesc(pBuffer, &sizeInBytes, &pParameter->ParameterType, sizeof(pParameter->ParameterType));
+        appendToFlattenedRootSignatureDesc(pBuffer, &sizeInBytes, &pParameter->ShaderVisibility, sizeof(pParameter->ShaderVisibility));
+        switch(pParameter->ParameterType)
+        {
+            case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE:
+                appendToFlattenedRootSignatureDesc(pBuffer, &sizeInBytes, &pParameter->DescriptorTable.NumDescriptorRanges, sizeof(pParameter->DescriptorTable.NumDescriptorRanges));
+                appendToFlattenedRootSignatureDesc(pBuffer, &sizeInBytes, pParameter->DescriptorTable.pDescriptorRanges, sizeof(D3D12_DESCRIPTOR_RANGE) * pParameter->DescriptorTable.NumDescriptorRanges);
+                break;
+            case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+                appendToFlattenedRootSignatureDesc(pBuffer, &sizeInBytes, &pParameter->Constants, sizeof(pParameter->Constants));
+                break;
+            default:
+                appendToFlattenedRootSignatureDesc(pBuffer, &sizeInBytes, &pParameter->Descriptor, sizeof(pParameter->Descriptor));
+                break;
+        }
+    }
 
-    setD3D12ObjectDebugName(pRenderPass->pGraphicsCommandList, pRenderPassName);    
-    addBeginMarker(pRenderPass->pGraphicsCommandList, pRenderPassName);
-    return pRenderPass;
+    appendToFlattenedRootSignatureDesc(pBuffer, &sizeInBytes, &pRootSignatureDesc->NumStaticSamplers, sizeof(pRootSignatureDesc->NumStaticSamplers));
+    appendToFlattenedRootSignatureDesc(pBuffer, &sizeInBytes, pRootSignatureDesc->pStaticSamplers, sizeof(D3D12_STATIC_SAMPLER_DESC) * pRootSignatureDesc->NumStaticSamplers);
+    return sizeInBytes;
 }
 
-void endRenderPass(graphics_frame_t* pGraphicsFrame, render_pass_t* pRenderPass)
+//FK: Layout for pipeline states without root parameters
+D3D12_ROOT_SIGNATURE_DESC createDefaultRootSignatureDesc()
 {
-    ASSERT_DEBUG(pGraphicsFrame != nullptr);
-    ASSERT_DEBUG(pGraphicsFrame->openRenderPassCount > 0);
-    ASSERT_DEBUG(pRenderPass != nullptr);
-    ASSERT_DEBUG(pRenderPass->isOpen);
+    D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+    rootSignatureDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+    return rootSignatureDesc;
+}
 
-    pRenderPass->isOpen = false;
-    --pGraphicsFrame->openRenderPassCount;
+constexpr uint32_t maxGeneratedRootSignatureBindingCount = maxShaderResourceBindingCount * 2u;
 
-    transitionResource(pRenderPass->pGraphicsCommandList, &pGraphicsFrame->pBackBuffer->resource, D3D12_RESOURCE_STATE_PRESENT);
+struct generated_root_signature_desc_t
+{
+    D3D12_ROOT_SIGNATURE_DESC   rootSignatureDesc;
+    D3D12_ROOT_PARAMETER        rootParameters[maxGeneratedRootSignatureBindingCount + 3u];
+    D3D12_DESCRIPTOR_RANGE      descriptorRanges[maxGeneratedRootSignatureBindingCount];
+};
 
-    addEndMarker(pRenderPass->pGraphicsCommandList);
-    COM_CALL(pRenderPass->pGraphicsCommandList->Close());
-}
+enum shader_visibility_flag_t : uint8_t
+{
+    shader_visibility_flag_vertex   = 0x1,
+    shader_visibility_flag_pixel    = 0x2
+};
 
-bool isColorRenderTarget(render_target_t* pRenderTarget)
+struct generated_root_signature_binding_t
 {
-    //FK: TODO
-    return true;
-}
+    shader_resource_binding_t   binding;
+    uint8_t                     visibilityFlags;
+};
 
-uint32_t getVertexAttributeTypeSizeInBytes(const vertex_attribute_type_t attributeType)
+D3D12_SHADER_VISIBILITY getShaderVisibility(const uint8_t visibilityFlags)
 {
-    switch(attributeType)
+    switch(visibilityFlags)
     {
-        case vertex_attribute_type_t::float32:
-            return 4u;
+        case shader_visibility_flag_vertex:
+            return D3D12_SHADER_VISIBILITY_VERTEX;
+        case shader_visibility_flag_pixel:
+            return D3D12_SHADER_VISIBILITY_PIXEL;
         default:
-            DebugBreak();
+            return D3D12_SHADER_VISIBILITY_ALL;
     }
-
-    UNREACHABLE_CODE();
-    return 0u;
 }
 
-uint32_t calculateVertexStrideSizeInBytes(const vertex_format_t* pVertexFormat)
+D3D12_DESCRIPTOR_RANGE_TYPE getDescriptorRangeType(const uint8_t bindingType)
 {
-    uint32_t strideSizeInBytes = 0u;
-    for(uint32_t attributeIndex = 0u; attributeIndex < pVertexFormat->vertexAttributeCount; ++attributeIndex)
+    switch(bindingType)
     {
-        strideSizeInBytes += pVertexFormat->pVertexAttributes[attributeIndex].count * getVertexAttributeTypeSizeInBytes(pVertexFormat->pVertexAttributes[attributeIndex].type);
+        case shader_resource_binding_constant_buffer:
+            return D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
+        case shader_resource_binding_srv:
+            return D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+        case shader_resource_binding_uav:
+            return D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+        default:
+            return D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER;
     }
+}
+
+//FK: Bindings that both stages use get merged, array sizes are the larger of both declarations
+void addGeneratedRootSignatureBindings(generated_root_signature_binding_t* pBindings, uint32_t* pBindingCount, const shader_reflection_t* pShaderReflection, const uint8_t visibilityFlag)
+{
+    for(uint32_t bindingIndex = 0u; bindingIndex < pShaderReflection->resourceBindingCount; ++bindingIndex)
+    {
+        const shader_resource_binding_t* pBinding = pShaderReflection->resourceBindings + bindingIndex;
+
+        generated_root_signature_binding_t* pMergedBinding = nullptr;
+        for(uint32_t mergedBindingIndex = 0u; mergedBindingIndex < *pBindingCount; ++mergedBindingIndex)
+        {
+            const shader_resource_binding_t* pExistingBinding = &pBindings[mergedBindingIndex].binding;
+            if(pExistingBinding->type == pBinding->type && pExistingBinding->registerSpace == pBinding->registerSpace && pExistingBinding->shaderRegister == pBinding->shaderRegister)
+            {
+                pMergedBinding = pBindings + mergedBindingIndex;
+                break;
+            }
+        }
+
+        if(pMergedBinding == nullptr)
+        {
+            ASSERT_DEBUG(*pBindingCount < maxGeneratedRootSignatureBindingCount);
+            pMergedBinding = pBindings + (*pBindingCount)++;
+            pMergedBinding->binding         = *pBinding;
+            pMergedBinding->visibilityFlags = 0u;
+        }
+        else if(pMergedBinding->binding.bindCount != 0u)
+        {
+            pMergedBinding->binding.bindCount = (pBinding->bindCount == 0u || pBinding->bindCount > pMergedBinding->binding.bindCount) ? pBinding->bindCount : pMergedBinding->binding.bindCount;
+        }
 
-    return strideSizeInBytes;
+        pMergedBinding->visibilityFlags |= visibilityFlag;
+    }
 }
 
-void bindVertexBuffer(render_pass_t* pRenderPass, vertex_buffer_t* pVertexBuffer, const vertex_format_t* pVertexFormat, uint32_t slotIndex)
+//FK: Sorts by descriptor table first so that every table gets a contiguous set of ranges. Unbounded arrays go last within
+//    their table since nothing can be appended after them.
+uint32_t getGeneratedRootSignatureBindingSortKey(const shader_resource_binding_t* pBinding)
 {
-    D3D12_VERTEX_BUFFER_VIEW vertexBufferView = {};
-    vertexBufferView.BufferLocation = pVertexBuffer->bufferResource.pResource->GetGPUVirtualAddress();
-    vertexBufferView.SizeInBytes    = pVertexBuffer->sizeInBytes;
-    vertexBufferView.StrideInBytes  = calculateVertexStrideSizeInBytes(pVertexFormat);
-    pRenderPass->pGraphicsCommandList->IASetVertexBuffers(slotIndex, 1u, &vertexBufferView);
+    const uint32_t tableIndex = pBinding->type == shader_resource_binding_sampler ? 2u : (pBinding->type == shader_resource_binding_constant_buffer && pBinding->bindCount == 1u ? 0u : 1u);
+    return (tableIndex << 4u) | ((pBinding->bindCount == 0u ? 1u : 0u) << 3u) | pBinding->type;
 }
 
-void clearColorRenderTarget(render_pass_t* pRenderPass, render_target_t* pRenderTarget, const float r, const float g, const float b, const float a)
+bool isGeneratedRootSignatureBindingLess(const shader_resource_binding_t* pBindingA, const shader_resource_binding_t* pBindingB)
 {
-    ASSERT_DEBUG(pRenderTarget != nullptr);
-    ASSERT_DEBUG(isColorRenderTarget(pRenderTarget));
-    ASSERT_DEBUG(pRenderPass != nullptr);
-    ASSERT_DEBUG(pRenderPass->isOpen);
+    const uint32_t sortKeyA = getGeneratedRootSignatureBindingSortKey(pBindingA);
+    const uint32_t sortKeyB = getGeneratedRootSignatureBindingSortKey(pBindingB);
+    if(sortKeyA != sortKeyB)
+    {
+        return sortKeyA < sortKeyB;
+    }
 
-    const FLOAT colorValues[4] = {r, g, b, a};
+    if(pBindingA->registerSpace != pBindingB->registerSpace)
+    {
+        return pBindingA->registerSpace < pBindingB->registerSpace;
+    }
 
-    transitionResource(pRenderPass->pGraphicsCommandList, &pRenderTarget->resource, D3D12_RESOURCE_STATE_RENDER_TARGET);
-    pRenderPass->pGraphicsCommandList->ClearRenderTargetView(pRenderTarget->cpuDescriptorHandle, colorValues, 0, nullptr);
+    return pBindingA->shaderRegister < pBindingB->shaderRegister;
 }
 
-void executeRenderPass(graphics_frame_t* pGraphicsFrame, render_pass_t* pRenderPass)
+//FK: Generates the minimal root signature for the resources that the shaders use:
+//    - draw constants if requested, they replace the constant buffer in b0, space0
+//    - one root CBV per constant buffer, ordered by space and register
+//    - one descriptor table with all SRVs, UAVs and constant buffer arrays
+//    - one descriptor table with all samplers
+//    Every parameter is only visible to the stages that use it. Shaders without resources end up with the default layout.
+const D3D12_ROOT_SIGNATURE_DESC* generateRootSignatureDesc(const shader_reflection_t* pVertexShaderReflection, const shader_reflection_t* pPixelShaderReflection, generated_root_signature_desc_t* pOutGeneratedRootSignatureDesc, const uint32_t drawConstantCount = 0u)
 {
-    ASSERT_DEBUG(pGraphicsFrame != nullptr);
-    ASSERT_DEBUG(pRenderPass != nullptr);
-    ASSERT_DEBUG(!pRenderPass->isOpen);
+    ASSERT_DEBUG(drawConstantCount <= maxDrawConstantCount);
+
+    generated_root_signature_binding_t bindings[maxGeneratedRootSignatureBindingCount];
+    uint32_t bindingCount = 0u;
+    addGeneratedRootSignatureBindings(bindings, &bindingCount, pVertexShaderReflection, shader_visibility_flag_vertex);
+    addGeneratedRootSignatureBindings(bindings, &bindingCount, pPixelShaderReflection, shader_visibility_flag_pixel);
 
-    if(pGraphicsFrame->pFirstRenderPassToExecute == nullptr)
+    for(uint32_t bindingIndex = 1u; bindingIndex < bindingCount; ++bindingIndex)
     {
-        pRenderPass->pNext = pGraphicsFrame->pFirstRenderPassToExecute;
-        pGraphicsFrame->pFirstRenderPassToExecute = pRenderPass;
+        const generated_root_signature_binding_t binding = bindings[bindingIndex];
+        uint32_t insertIndex = bindingIndex;
+        while(insertIndex > 0u && isGeneratedRootSignatureBindingLess(&binding.binding, &bindings[insertIndex - 1u].binding))
+        {
+            bindings[insertIndex] = bindings[insertIndex - 1u];
+            --insertIndex;
+        }
+        bindings[insertIndex] = binding;
     }
 
-    if(pGraphicsFrame->pLastRenderPassToExecute == nullptr)
+    generated_root_signature_desc_t* pDesc = pOutGeneratedRootSignatureDesc;
+    clearMemoryWithZeroes(pDesc);
+    pDesc->rootSignatureDesc = createDefaultRootSignatureDesc();
+
+    uint32_t parameterCount = 0u;
+    uint32_t rangeCount = 0u;
+    uint32_t currentTableIndex = ~0u;
+    uint8_t tableVisibilityFlags = 0u;
+    if(drawConstantCount > 0u)
     {
-        pGraphicsFrame->pLastRenderPassToExecute = pRenderPass;
+        D3D12_ROOT_PARAMETER* pParameter = pDesc->rootParameters + parameterCount++;
+        pParameter->ParameterType               = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        pParameter->ShaderVisibility            = D3D12_SHADER_VISIBILITY_ALL;
+        pParameter->Constants.ShaderRegister    = 0u;
+        pParameter->Constants.RegisterSpace     = 0u;
+        pParameter->Constants.Num32BitValues    = drawConstantCount;
     }
-    else
+
+    for(uint32_t bindingIndex = 0u; bindingIndex < bindingCount; ++bindingIndex)
     {
-        pGraphicsFrame->pLastRenderPassToExecute->pNext = pRenderPass;
-        pGraphicsFrame->pLastRenderPassToExecute = pRenderPass;
+        const shader_resource_binding_t* pBinding = &bindings[bindingIndex].binding;
+        const bool isDrawConstantsBinding = pBinding->type == shader_resource_binding_constant_buffer && pBinding->shaderRegister == 0u && pBinding->registerSpace == 0u;
+        if(drawConstantCount > 0u && isDrawConstantsBinding)
+        {
+            continue;
+        }
+
+        const uint32_t tableIndex = getGeneratedRootSignatureBindingSortKey(pBinding) >> 4u;
+        if(tableIndex == 0u)
+        {
+            D3D12_ROOT_PARAMETER* pParameter = pDesc->rootParameters + parameterCount++;
+            pParameter->ParameterType               = D3D12_ROOT_PARAMETER_TYPE_CBV;
+            pParameter->ShaderVisibility            = getShaderVisibility(bindings[bindingIndex].visibilityFlags);
+            pParameter->Descriptor.ShaderRegister   = pBinding->shaderRegister;
+            pParameter->Descriptor.RegisterSpace    = pBinding->registerSpace;
+            continue;
+        }
+
+        if(tableIndex != currentTableIndex)
+        {
+            D3D12_ROOT_PARAMETER* pParameter = pDesc->rootParameters + parameterCount++;
+            pParameter->ParameterType                       = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+            pParameter->DescriptorTable.pDescriptorRanges   = pDesc->descriptorRanges + rangeCount;
+            pParameter->DescriptorTable.NumDescriptorRanges = 0u;
+            currentTableIndex = tableIndex;
+            tableVisibilityFlags = 0u;
+        }
+
+        //FK: Tables are visible to every stage that uses any of their ranges
+        D3D12_ROOT_PARAMETER* pTableParameter = pDesc->rootParameters + parameterCount - 1u;
+        tableVisibilityFlags |= bindings[bindingIndex].visibilityFlags;
+        pTableParameter->ShaderVisibility = getShaderVisibility(tableVisibilityFlags);
+        ++pTableParameter->DescriptorTable.NumDescriptorRanges;
+
+        D3D12_DESCRIPTOR_RANGE* pRange = pDesc->descriptorRanges + rangeCount++;
+        pRange->RangeType                           = getDescriptorRangeType(pBinding->type);
+        pRange->NumDescriptors                      = pBinding->bindCount == 0u ? std::numeric_limits<uint32_t>::max() : pBinding->bindCount;
+        pRange->BaseShaderRegister                  = pBinding->shaderRegister;
+        pRange->RegisterSpace                       = pBinding->registerSpace;
+        pRange->OffsetInDescriptorsFromTableStart   = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
     }
+
+    pDesc->rootSignatureDesc.NumParameters  = parameterCount;
+    pDesc->rootSignatureDesc.pParameters    = parameterCount > 0u ? pDesc->rootParameters : nullptr;
+    return &pDesc->rootSignatureDesc;
 }
 
-vertex_buffer_t* createVertexBuffer(graphics_frame_t* pGraphicsFrame, const upload_buffer_t* pUploadBuffer, const uint32_t uploadBufferOffset = 0u, uint32_t sizeInBytes = 0u)
-{
-    ASSERT_DEBUG(pGraphicsFrame != nullptr);
-    ASSERT_DEBUG(pUploadBuffer != nullptr);
+//FK: Exposes the whole shader visible descriptor heap, shaders index into it with the draw constants:
+//    - draw constants:     bindlessDrawConstantCount 32 bit values in b0, space0
+//    - SRV table:          unbounded t0, space1 (e.g. Texture2D textures[] : register(t0, space1))
+//    - CBV table:          unbounded b0, space2
+//    - UAV table:          unbounded u0, space3
+//    - static samplers:    s0 linear wrap, s1 point clamp, both in space0
+//    All tables start at the beginning of the heap, so a bindless descriptor index is valid in each of them.
+const D3D12_ROOT_SIGNATURE_DESC* getBindlessRootSignatureDesc()
+{
+    static D3D12_DESCRIPTOR_RANGE descriptorRanges[3] = {};
+    static D3D12_ROOT_PARAMETER rootParameters[bindless_root_parameter_count] = {};
+    static D3D12_STATIC_SAMPLER_DESC staticSamplers[2] = {};
+    static D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = [](){
+        const D3D12_DESCRIPTOR_RANGE_TYPE rangeTypes[3] = {D3D12_DESCRIPTOR_RANGE_TYPE_SRV, D3D12_DESCRIPTOR_RANGE_TYPE_CBV, D3D12_DESCRIPTOR_RANGE_TYPE_UAV};
+        for(uint32_t rangeIndex = 0u; rangeIndex < 3u; ++rangeIndex)
+        {
+            D3D12_DESCRIPTOR_RANGE* pRange = descriptorRanges + rangeIndex;
+            pRange->RangeType                           = rangeTypes[rangeIndex];
+            pRange->NumDescriptors                      = std::numeric_limits<uint32_t>::max();
+            pRange->BaseShaderRegister                  = 0u;
+            pRange->RegisterSpace                       = 1u + rangeIndex;
+            pRange->OffsetInDescriptorsFromTableStart   = 0u;
+
+            D3D12_ROOT_PARAMETER* pParameter = rootParameters + bindless_root_parameter_srv_table + rangeIndex;
+            pParameter->ParameterType                       = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+            pParameter->ShaderVisibility                    = D3D12_SHADER_VISIBILITY_ALL;
+            pParameter->DescriptorTable.NumDescriptorRanges = 1u;
+            pParameter->DescriptorTable.pDescriptorRanges   = pRange;
+        }
 
-    vertex_buffer_t* pVertexBuffer = (vertex_buffer_t*)allocateFromAllocator(pGraphicsFrame->pMemoryAllocator, sizeof(vertex_buffer_t));
-    if(pVertexBuffer == nullptr)
+        D3D12_ROOT_PARAMETER* pDrawConstants = rootParameters + bindless_root_parameter_draw_constants;
+        pDrawConstants->ParameterType               = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        pDrawConstants->ShaderVisibility            = D3D12_SHADER_VISIBILITY_ALL;
+        pDrawConstants->Constants.ShaderRegister    = 0u;
+        pDrawConstants->Constants.RegisterSpace     = 0u;
+        pDrawConstants->Constants.Num32BitValues    = bindlessDrawConstantCount;
+
+        for(uint32_t samplerIndex = 0u; samplerIndex < 2u; ++samplerIndex)
+        {
+            D3D12_STATIC_SAMPLER_DESC* pSampler = staticSamplers + samplerIndex;
+            const D3D12_TEXTURE_ADDRESS_MODE addressMode = samplerIndex == 0u ? D3D12_TEXTURE_ADDRESS_MODE_WRAP : D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+            pSampler->Filter            = samplerIndex == 0u ? D3D12_FILTER_MIN_MAG_MIP_LINEAR : D3D12_FILTER_MIN_MAG_MIP_POINT;
+            pSampler->AddressU          = addressMode;
+            pSampler->AddressV          = addressMode;
+            pSampler->AddressW          = addressMode;
+            pSampler->ComparisonFunc    = D3D12_COMPARISON_FUNC_NEVER;
+            pSampler->BorderColor       = D3D12_STATIC_BORDER_COLOR_OPAQUE_BLACK;
+            pSampler->MaxLOD            = D3D12_FLOAT32_MAX;
+            pSampler->ShaderRegister    = samplerIndex;
+            pSampler->ShaderVisibility  = D3D12_SHADER_VISIBILITY_ALL;
+        }
+
+        D3D12_ROOT_SIGNATURE_DESC desc = createDefaultRootSignatureDesc();
+        desc.NumParameters      = bindless_root_parameter_count;
+        desc.pParameters        = rootParameters;
+        desc.NumStaticSamplers  = 2u;
+        desc.pStaticSamplers    = staticSamplers;
+        return desc;
+    }();
+
+    return &rootSignatureDesc;
+}
+
+//FK: Pipeline states without explicit root signature desc get one generated from the reflection data of their shaders
+const D3D12_ROOT_SIGNATURE_DESC* getPipelineStateRootSignatureDesc(const graphics_pipeline_state_parameters_t* pParameters, const shader_binary_t* pVertexShader, const shader_binary_t* pPixelShader, generated_root_signature_desc_t* pGeneratedRootSignatureDesc)
+{
+    if(pParameters->useBindlessRootSignature)
     {
-        return nullptr;
+        ASSERT_DEBUG(pParameters->pRootSignatureDesc == nullptr);
+        ASSERT_DEBUG(pParameters->drawConstantCount <= bindlessDrawConstantCount);
+        return getBindlessRootSignatureDesc();
     }
 
-    if(sizeInBytes == 0u)
+    if(pParameters->pRootSignatureDesc != nullptr)
     {
-        sizeInBytes = pUploadBuffer->sizeInBytes;
+        ASSERT_DEBUG(pParameters->drawConstantCount == 0u || (pParameters->pRootSignatureDesc->NumParameters > drawConstantsRootParameterIndex
+            && pParameters->pRootSignatureDesc->pParameters[drawConstantsRootParameterIndex].ParameterType == D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS
+            && pParameters->pRootSignatureDesc->pParameters[drawConstantsRootParameterIndex].Constants.Num32BitValues >= pParameters->drawConstantCount));
+        return pParameters->pRootSignatureDesc;
     }
 
-    D3D12_RESOURCE_DESC desc = {};
-    desc.Dimension          = D3D12_RESOURCE_DIMENSION_BUFFER;
-    desc.Alignment          = 0u;
-    desc.DepthOrArraySize   = 1u;
-    desc.Height             = 1u;
-    desc.MipLevels          = 1u;
-    desc.Layout             = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-    desc.SampleDesc.Count   = 1u;
-    desc.SampleDesc.Quality = 0u;
-    desc.Width              = sizeInBytes;
-    
-    D3D12_HEAP_PROPERTIES heapProperties = {};
-    heapProperties.Type                 = D3D12_HEAP_TYPE_DEFAULT;
-    heapProperties.CPUPageProperty      = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-    heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-    
-    if(COM_CALL(pGraphicsFrame->pDevice->CreateCommittedResource1(&heapProperties, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_COMMON, nullptr, nullptr, IID_PPV_ARGS(&pVertexBuffer->bufferResource.pResource))) != S_OK)
+    return generateRootSignatureDesc(&pVertexShader->reflection, &pPixelShader->reflection, pGeneratedRootSignatureDesc, pParameters->drawConstantCount);
+}
+
+shader_resource_binding_type_t getDescriptorRangeBindingType(const D3D12_DESCRIPTOR_RANGE_TYPE rangeType)
+{
+    switch(rangeType)
     {
-        freeFromAllocator(pGraphicsFrame->pMemoryAllocator, pVertexBuffer);
-        return nullptr;
+        case D3D12_DESCRIPTOR_RANGE_TYPE_CBV:
+            return shader_resource_binding_constant_buffer;
+        case D3D12_DESCRIPTOR_RANGE_TYPE_SRV:
+            return shader_resource_binding_srv;
+        case D3D12_DESCRIPTOR_RANGE_TYPE_UAV:
+            return shader_resource_binding_uav;
+        default:
+            return shader_resource_binding_sampler;
     }
+}
 
-    pVertexBuffer->bufferResource.currentState = D3D12_RESOURCE_STATE_COMMON;
-    pVertexBuffer->sizeInBytes = sizeInBytes;
+//FK: Resolves the appended range offsets of descriptor tables so that every register knows its place in its table.
+//    Returns false if the root signature has more bindings than fit, the bindings that didn't fit can't be looked up.
+bool fillRootParameterBindings(root_parameter_binding_t* pOutBindings, uint32_t* pOutBindingCount, const D3D12_ROOT_SIGNATURE_DESC* pRootSignatureDesc)
+{
+    static_assert(maxRootParameterBindingCount >= maxGeneratedRootSignatureBindingCount + 1u, "Generated root signatures have to fit into the root parameter bindings");
+    static_assert(maxRootParameterBindingCount <= 256u, "Root parameter indices are stored as uint8_t");
+
+    uint32_t bindingCount = 0u;
+    for(uint32_t parameterIndex = 0u; parameterIndex < pRootSignatureDesc->NumParameters; ++parameterIndex)
+    {
+        const D3D12_ROOT_PARAMETER* pParameter = pRootSignatureDesc->pParameters + parameterIndex;
+        const uint32_t rangeCount = pParameter->ParameterType == D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE ? pParameter->DescriptorTable.NumDescriptorRanges : 1u;
+        uint32_t tableSizeInDescriptors = 0u;
+        for(uint32_t rangeIndex = 0u; rangeIndex < rangeCount; ++rangeIndex)
+        {
+            if(bindingCount == maxRootParameterBindingCount)
+            {
+                *pOutBindingCount = bindingCount;
+                return false;
+            }
+
+            root_parameter_binding_t* pBinding = pOutBindings + bindingCount++;
+            clearMemoryWithZeroes(pBinding);
+            pBinding->parameterType         = (uint8_t)pParameter->ParameterType;
+            pBinding->rootParameterIndex    = (uint8_t)parameterIndex;
+            pBinding->descriptorCount       = 1u;
 
-    #if 1
-    transitionResource(pGraphicsFrame->pFrameGeneralGraphicsQueue, &pVertexBuffer->bufferResource, D3D12_RESOURCE_STATE_COPY_DEST);
-    pGraphicsFrame->pFrameGeneralGraphicsQueue->CopyBufferRegion(pVertexBuffer->bufferResource.pResource, 0u, pUploadBuffer->bufferResource.pResource, uploadBufferOffset, sizeInBytes);
-    transitionResource(pGraphicsFrame->pFrameGeneralGraphicsQueue, &pVertexBuffer->bufferResource, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
-    #else
-    transitionResource(pGraphicsFrame->pFrameGeneralCopyQueue, &pVertexBuffer->bufferResource, D3D12_RESOURCE_STATE_COPY_DEST);
-    pGraphicsFrame->pFrameGeneralCopyQueue->CopyBufferRegion(pVertexBuffer->bufferResource.pResource, 0u, pUploadBuffer->pBufferResource->pResource, pUploadBuffer->startStagingBufferByteIndex, bufferSizeInBytes);
-    #endif
+            switch(pParameter->ParameterType)
+            {
+                case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE:
+                {
+                    const D3D12_DESCRIPTOR_RANGE* pRange = pParameter->DescriptorTable.pDescriptorRanges + rangeIndex;
+                    const uint32_t offsetInDescriptors = pRange->OffsetInDescriptorsFromTableStart == D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND ? tableSizeInDescriptors : pRange->OffsetInDescriptorsFromTableStart;
+                    pBinding->type                              = getDescriptorRangeBindingType(pRange->RangeType);
+                    pBinding->shaderRegister                    = pRange->BaseShaderRegister;
+                    pBinding->registerSpace                     = pRange->RegisterSpace;
+                    pBinding->descriptorCount                   = pRange->NumDescriptors;
+                    pBinding->offsetInDescriptorsFromTableStart = offsetInDescriptors;
+                    tableSizeInDescriptors = pRange->NumDescriptors == std::numeric_limits<uint32_t>::max() ? offsetInDescriptors : offsetInDescriptors + pRange->NumDescriptors;
+                    break;
+                }
+                case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+                    pBinding->type              = shader_resource_binding_constant_buffer;
+                    pBinding->shaderRegister    = pParameter->Constants.ShaderRegister;
+                    pBinding->registerSpace     = pParameter->Constants.RegisterSpace;
+                    break;
+                default:
+                    pBinding->type              = pParameter->ParameterType == D3D12_ROOT_PARAMETER_TYPE_CBV ? shader_resource_binding_constant_buffer : (pParameter->ParameterType == D3D12_ROOT_PARAMETER_TYPE_SRV ? shader_resource_binding_srv : shader_resource_binding_uav);
+                    pBinding->shaderRegister    = pParameter->Descriptor.ShaderRegister;
+                    pBinding->registerSpace     = pParameter->Descriptor.RegisterSpace;
+                    break;
+            }
+        }
+    }
 
-    return pVertexBuffer;
+    *pOutBindingCount = bindingCount;
+    return true;
+}
+
+//FK: Shaders are keyed by their blob content and the vertex format by its attributes rather than by their handles,
+//    so recreated shaders or duplicated vertex formats still end up with the same pipeline state
+uint64_t calculateGraphicsPipelineStateKey(const graphics_pipeline_state_parameters_t* pParameters, const shader_binary_t* pVertexShader, const shader_binary_t* pPixelShader, const vertex_format_t* pVertexFormat)
+{
+    uint64_t key = fnv1aOffsetBasis;
+    key = calculateHash(&pVertexShader->shaderBlobHash, sizeof(pVertexShader->shaderBlobHash), key);
+    key = calculateHash(&pPixelShader->shaderBlobHash, sizeof(pPixelShader->shaderBlobHash), key);
+    key = calculateHash(&pVertexFormat->hash, sizeof(pVertexFormat->hash), key);
+    key = calculateBlendDescHash(&pParameters->blendDesc, pParameters->renderTargetCount, key);
+    key = calculateDepthStencilDescHash(&pParameters->depthStencilDesc, key);
+    key = calculateHash(&pParameters->rasterizerDesc, sizeof(pParameters->rasterizerDesc), key);
+    key = calculateHash(&pParameters->primitiveTopologyType, sizeof(pParameters->primitiveTopologyType), key);
+    key = calculateHash(&pParameters->renderTargetCount, sizeof(pParameters->renderTargetCount), key);
+    key = calculateHash(pParameters->renderTargetFormats, sizeof(DXGI_FORMAT) * pParameters->renderTargetCount, key);
+    key = calculateHash(&pParameters->depthStencilFormat, sizeof(pParameters->depthStencilFormat), key);
+
+    generated_root_signature_desc_t generatedRootSignatureDesc;
+    key = calculateRootSignatureDescHash(getPipelineStateRootSignatureDesc(pParameters, pVertexShader, pPixelShader, &generatedRootSignatureDesc), key);
+    return key;
 }
 
-vertex_format_t* createVertexFormat(graphics_frame_t* pGraphicsFrame, const vertex_attribute_entry_t* pVertexAttributes, const uint32_t vertexAttributeCount)
+//FK: Explicit root signature descs get flattened into memory from pAllocator, destroyGraphicsPipelineStateKeyInputs() frees it
+bool createGraphicsPipelineStateKeyInputs(memory_allocator_t* pAllocator, graphics_pipeline_state_key_inputs_t* pOutKeyInputs, const graphics_pipeline_state_parameters_t* pParameters, const shader_binary_t* pVertexShader, const shader_binary_t* pPixelShader, const vertex_format_t* pVertexFormat)
 {
-    ASSERT_DEBUG(pGraphicsFrame != nullptr);
-    ASSERT_DEBUG(pVertexAttributes != nullptr);
-    ASSERT_DEBUG(vertexAttributeCount > 0u);
-    
-    vertex_format_t* pVertexFormat = allocateVertexFormat(pGraphicsFrame->pRenderResourceCache);
-    if(pVertexFormat == nullptr)
+    clearMemoryWithZeroes(pOutKeyInputs);
+    pOutKeyInputs->vertexShaderBlobHash         = pVertexShader->shaderBlobHash;
+    pOutKeyInputs->pixelShaderBlobHash          = pPixelShader->shaderBlobHash;
+    pOutKeyInputs->vertexShaderBlobSizeInBytes  = pVertexShader->shaderBlobSizeInBytes;
+    pOutKeyInputs->pixelShaderBlobSizeInBytes   = pPixelShader->shaderBlobSizeInBytes;
+    pOutKeyInputs->vertexAttributeCount         = pVertexFormat->vertexAttributeCount;
+    pOutKeyInputs->blendDesc                    = pParameters->blendDesc;
+    pOutKeyInputs->depthStencilDesc             = pParameters->depthStencilDesc;
+    pOutKeyInputs->rasterizerDesc               = pParameters->rasterizerDesc;
+    pOutKeyInputs->primitiveTopologyType        = pParameters->primitiveTopologyType;
+    pOutKeyInputs->depthStencilFormat           = pParameters->depthStencilFormat;
+    pOutKeyInputs->renderTargetCount            = pParameters->renderTargetCount;
+    pOutKeyInputs->drawConstantCount            = pParameters->drawConstantCount;
+    pOutKeyInputs->useBindlessRootSignature     = pParameters->useBindlessRootSignature;
+    memcpy(pOutKeyInputs->vertexAttributes, pVertexFormat->pVertexAttributes, sizeof(vertex_attribute_entry_t) * pVertexFormat->vertexAttributeCount);
+    memcpy(pOutKeyInputs->renderTargetFormats, pParameters->renderTargetFormats, sizeof(DXGI_FORMAT) * pParameters->renderTargetCount);
+
+    if(pParameters->useBindlessRootSignature || pParameters->pRootSignatureDesc == nullptr)
     {
-        return nullptr;
+        return true;
     }
 
-    memcpy(pVertexFormat->pVertexAttributes, pVertexAttributes, sizeof(vertex_attribute_entry_t) * vertexAttributeCount);
-    pVertexFormat->vertexAttributeCount = vertexAttributeCount;
+    const uint32_t rootSignatureDescSizeInBytes = flattenRootSignatureDesc(pParameters->pRootSignatureDesc, nullptr);
+    pOutKeyInputs->pRootSignatureDesc = (uint8_t*)allocateFromAllocator(pAllocator, rootSignatureDescSizeInBytes);
+    if(pOutKeyInputs->pRootSignatureDesc == nullptr)
+    {
+        return false;
+    }
 
-    return pVertexFormat;
+    pOutKeyInputs->rootSignatureDescSizeInBytes = flattenRootSignatureDesc(pParameters->pRootSignatureDesc, pOutKeyInputs->pRootSignatureDesc);
+    return true;
 }
 
-upload_buffer_t* createUploadBuffer(graphics_frame_t* pGraphicsFrame, void* pData, const uint32_t dataSizeInBytes, upload_buffer_flags_t flags = upload_buffer_flag_none)
+bool createRootSignature(D3D12DeviceType* pDevice, const D3D12_ROOT_SIGNATURE_DESC* pRootSignatureDesc, ID3D12RootSignature** ppOutRootSignature)
 {
-    ASSERT_DEBUG(pGraphicsFrame != nullptr);
-    ASSERT_DEBUG(dataSizeInBytes > 0u);
-
-    D3D12_RESOURCE_DESC desc = {};
-    desc.Dimension          = D3D12_RESOURCE_DIMENSION_BUFFER;
-    desc.Alignment          = 0u;
-    desc.Height             = 1u;
-    desc.DepthOrArraySize   = 1u;
-    desc.MipLevels          = 1u;
-    desc.SampleDesc.Count   = 1u;
-    desc.SampleDesc.Quality = 0u;
-    desc.Layout             = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-    desc.Width              = dataSizeInBytes;
-    
-    D3D12_HEAP_PROPERTIES heapProperties = {};
-    heapProperties.Type                 = D3D12_HEAP_TYPE_UPLOAD;
-    heapProperties.CPUPageProperty      = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-    heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-    
-    ID3D12Resource* pResource = nullptr;
-    if(COM_CALL(pGraphicsFrame->pDevice->CreateCommittedResource1(&heapProperties, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, nullptr, IID_PPV_ARGS(&pResource))) != S_OK)
+    ID3DBlob* pRootSignatureBlob = nullptr;
+    ID3DBlob* pErrorBlob = nullptr;
+    const HRESULT serializeResult = COM_CALL(D3D12SerializeRootSignature(pRootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, &pRootSignatureBlob, &pErrorBlob));
+    if(serializeResult != S_OK)
     {
-        return nullptr;
+        logError("Could not serialize root signature - error: %s %s", getHResultString(serializeResult), pErrorBlob != nullptr ? (const char*)pErrorBlob->GetBufferPointer() : "");
+        COM_RELEASE(pErrorBlob);
+        return false;
     }
 
-    upload_buffer_t* pUploadBuffer = allocateUploadBuffer(pGraphicsFrame->pRenderResourceCache);
-    if(pUploadBuffer == nullptr)
+    COM_RELEASE(pErrorBlob);
+
+    const HRESULT createResult = COM_CALL(pDevice->CreateRootSignature(0u, pRootSignatureBlob->GetBufferPointer(), pRootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(ppOutRootSignature)));
+    COM_RELEASE(pRootSignatureBlob);
+    if(createResult != S_OK)
     {
-        pResource->Release();
-        return nullptr;
+        logError("Could not create root signature - error: %s.", getHResultString(createResult));
+        return false;
     }
 
-    void* pUploadBufferData = nullptr;
+    return true;
+}
 
-    D3D12_RANGE mapRange = {};
-    mapRange.End = dataSizeInBytes;
-    if(COM_CALL(pResource->Map(0, &mapRange, &pUploadBufferData)) != S_OK)
+//FK: Returns a root signature with an additional reference for the caller, pipeline states with the same root parameter
+//    layout share the root signature. This also keeps redundant SetGraphicsRootSignature() calls out of the command lists.
+ID3D12RootSignature* getOrCreateRootSignature(D3D12DeviceType* pDevice, root_signature_cache_t* pRootSignatureCache, const D3D12_ROOT_SIGNATURE_DESC* pRootSignatureDesc)
+{
+    const uint64_t key = calculateRootSignatureDescHash(pRootSignatureDesc, fnv1aOffsetBasis);
+    const uint32_t rootSignatureDescSizeInBytes = flattenRootSignatureDesc(pRootSignatureDesc, nullptr);
+    uint8_t* pFlattenedRootSignatureDesc = (uint8_t*)allocateFromAllocator(pRootSignatureCache->pAllocator, rootSignatureDescSizeInBytes);
+    if(pFlattenedRootSignatureDesc == nullptr)
     {
-        pResource->Release();
-        freeUploadBuffer(pGraphicsFrame->pRenderResourceCache, pUploadBuffer);
+        logError("Out of memory while looking up root signature.");
         return nullptr;
     }
 
-    if(pData != nullptr)
+    flattenRootSignatureDesc(pRootSignatureDesc, pFlattenedRootSignatureDesc);
+
+    //FK: Creating root signatures is cheap compared to pipeline states, so this happens while holding the lock
+    AcquireSRWLockExclusive(&pRootSignatureCache->lock);
+
+    ID3D12RootSignature* pRootSignature = nullptr;
+    for(uint32_t entryIndex = 0u; entryIndex < pRootSignatureCache->entryCount; ++entryIndex)
     {
-        memcpy(pUploadBufferData, pData, dataSizeInBytes);
+        const root_signature_cache_entry_t* pEntry = pRootSignatureCache->pEntries + entryIndex;
+        if(pEntry->key == key && pEntry->rootSignatureDescSizeInBytes == rootSignatureDescSizeInBytes &&
+           memcmp(pEntry->pRootSignatureDesc, pFlattenedRootSignatureDesc, rootSignatureDescSizeInBytes) == 0)
+        {
+            pRootSignature = pEntry->pRootSignature;
+            break;
+        }
     }
 
-    pUploadBuffer->sizeInBytes                  = dataSizeInBytes;
-    pUploadBuffer->pData                        = pUploadBufferData;
-    pUploadBuffer->bufferResource.pResource     = pResource;
-    pUploadBuffer->bufferResource.currentState  = D3D12_RESOURCE_STATE_GENERIC_READ;
-
-    pUploadBuffer->pNext = pGraphicsFrame->pFirstUploadBuffer;
-    pGraphicsFrame->pFirstUploadBuffer = pUploadBuffer;
-    
-    return pUploadBuffer;
-}
+    if(pRootSignature != nullptr)
+    {
+        ++pRootSignatureCache->statistics.hitCount;
+        pRootSignature->AddRef();
+    }
+    else if(createRootSignature(pDevice, pRootSignatureDesc, &pRootSignature))
+    {
+        ++pRootSignatureCache->statistics.missCount;
+        if(pRootSignatureCache->entryCount < pRootSignatureCache->entryCapacity)
+        {
+            root_signature_cache_entry_t* pEntry = pRootSignatureCache->pEntries + pRootSignatureCache->entryCount++;
+            pEntry->key                             = key;
+            pEntry->pRootSignatureDesc              = pFlattenedRootSignatureDesc;
+            pEntry->rootSignatureDescSizeInBytes    = rootSignatureDescSizeInBytes;
+            pEntry->pRootSignature                  = pRootSignature;
+            pRootSignature->AddRef();
+            pFlattenedRootSignatureDesc = nullptr;
+        }
+        else
+        {
+            logWarning("Root signature cache is full, increase limits.maxRootSignatureCount.");
+        }
+    }
 
-upload_buffer_t* createUploadBuffer(graphics_frame_t* pGraphicsFrame, const uint32_t dataSizeInBytes)
-{
-    return createUploadBuffer(pGraphicsFrame, nullptr, dataSizeInBytes);
-}
+    ReleaseSRWLockExclusive(&pRootSignatureCache->lock);
 
-struct shader_compilation_parameters_t
-{
-    const char*     pShaderProfile;
-    const char*     pFilePath;
-    const char*     pShaderSourceCode;
-    const char*     pEntryPoint;
-    const char*     pDefines;
-};
+    if(pFlattenedRootSignatureDesc != nullptr)
+    {
+        freeFromAllocator(pRootSignatureCache->pAllocator, pFlattenedRootSignatureDesc);
+    }
 
-result_t<memory_buffer_t> readWholeFileIntoNewBuffer(memory_allocator_t* pAllocator, const char* pFilePath)
+    return pRootSignature;
+}
+
+void destroyRootSignatureCache(root_signature_cache_t* pRootSignatureCache)
 {
-    FILE* pShaderFileHandle = fopen(pFilePath, "rb");
-    if(pShaderFileHandle == nullptr)
+    for(uint32_t entryIndex = 0u; entryIndex < pRootSignatureCache->entryCount; ++entryIndex)
     {
-        return result_status_t::file_not_found;
+        COM_RELEASE(pRootSignatureCache->pEntries[entryIndex].pRootSignature);
+        freeFromAllocator(pRootSignatureCache->pAllocator, pRootSignatureCache->pEntries[entryIndex].pRootSignatureDesc);
     }
 
-    fseek(pShaderFileHandle, 0, SEEK_END);
-    const uint64_t shaderFileSizeInBytes = ftell(pShaderFileHandle);
-    fseek(pShaderFileHandle, 0, SEEK_SET);
+    pRootSignatureCache->entryCount = 0u;
+}
 
-    char* pShaderSourceContent = (char*)allocateFromAllocator(pAllocator, shaderFileSizeInBytes + 1);
-    if(pShaderSourceContent == nullptr)
+void formatPipelineLibraryEntryName(wchar_t (&entryName)[17], const uint64_t key)
+{
+    const wchar_t* pHexDigits = L"0123456789abcdef";
+    for(uint32_t digitIndex = 0u; digitIndex < 16u; ++digitIndex)
     {
-        fclose(pShaderFileHandle);
-        return result_status_t::out_of_memory;
+        entryName[digitIndex] = pHexDigits[(key >> ((15u - digitIndex) * 4u)) & 0xFu];
     }
 
-    fread(pShaderSourceContent, 1u, shaderFileSizeInBytes, pShaderFileHandle);
-    fclose(pShaderFileHandle);
+    entryName[16] = L'\0';
+}
 
-    pShaderSourceContent[shaderFileSizeInBytes] = 0;
+ID3D12PipelineState* loadGraphicsPipelineStateFromLibrary(pipeline_library_t* pPipelineLibrary, const uint64_t key, const D3D12_GRAPHICS_PIPELINE_STATE_DESC* pGraphicsPipelineStateDesc)
+{
+    if(pPipelineLibrary->pPipelineLibrary == nullptr)
+    {
+        return nullptr;
+    }
 
-    memory_buffer_t fileContent = {};
-    fileContent.pData = pShaderSourceContent;
-    fileContent.sizeInBytes = shaderFileSizeInBytes + 1;
+    wchar_t entryName[17];
+    formatPipelineLibraryEntryName(entryName, key);
 
-    return fileContent;
-}
+    //FK: Pipeline states that aren't part of the library yet return E_INVALIDARG, that's not worth logging
+    ID3D12PipelineState* pPipelineStateObject = nullptr;
+    if(pPipelineLibrary->pPipelineLibrary->LoadGraphicsPipeline(entryName, pGraphicsPipelineStateDesc, IID_PPV_ARGS(&pPipelineStateObject)) != S_OK)
+    {
+        return nullptr;
+    }
 
-struct dxc_arguments_t
-{
-    const wchar_t** ppArguments;
-    uint32_t        argumentCount;
-};
+    AcquireSRWLockExclusive(&pPipelineLibrary->lock);
+    ++pPipelineLibrary->statistics.loadedCount;
+    ReleaseSRWLockExclusive(&pPipelineLibrary->lock);
+    return pPipelineStateObject;
+}
 
-uint32_t findCharacterCountInString(const char* pString, const char needle)
+void storeGraphicsPipelineStateInLibrary(pipeline_library_t* pPipelineLibrary, const uint64_t key, ID3D12PipelineState* pPipelineStateObject)
 {
-    uint32_t count = 0u;
-    while(*pString)
+    if(pPipelineLibrary->pPipelineLibrary == nullptr)
     {
-        if(*pString++ == needle)
-        {
-            ++count;
-        }
+        return;
     }
 
-    return count;
+    wchar_t entryName[17];
+    formatPipelineLibraryEntryName(entryName, key);
+
+    AcquireSRWLockExclusive(&pPipelineLibrary->lock);
+    if(COM_CALL(pPipelineLibrary->pPipelineLibrary->StorePipeline(entryName, pPipelineStateObject)) == S_OK)
+    {
+        ++pPipelineLibrary->statistics.storedCount;
+        pPipelineLibrary->hasChanged = true;
+    }
+    ReleaseSRWLockExclusive(&pPipelineLibrary->lock);
 }
 
-result_t<wchar_t*> formatWideStringIntoNewBuffer(memory_allocator_t* pAllocator, const wchar_t* pFormat, ...)
-{
-    wchar_t tempMemoryBuffer[1024] = {};
-    const uint64_t tempMemoryBufferSizeInCharacters = sizeof(tempMemoryBuffer) >> 1;
-    va_list vaList;
-    va_start(vaList, pFormat);
-    const uint32_t charactersPrinted = vswprintf_s(tempMemoryBuffer, tempMemoryBufferSizeInCharacters, pFormat, vaList);
-    va_end(vaList);
+bool fillGraphicsPipelineStateDesc(D3D12_GRAPHICS_PIPELINE_STATE_DESC* pOutGraphicsPipelineStateDesc, D3D12_INPUT_ELEMENT_DESC* pOutInputElementDescs, const graphics_pipeline_state_parameters_t* pParameters, const shader_binary_t* pVertexShader, const shader_binary_t* pPixelShader, const vertex_format_t* pVertexFormat, ID3D12RootSignature* pRootSignature)
+{
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelineStateDesc = {};
+    graphicsPipelineStateDesc.VS.BytecodeLength     = pVertexShader->shaderBlobSizeInBytes;
+    graphicsPipelineStateDesc.VS.pShaderBytecode    = pVertexShader->pShaderBlob;
+    graphicsPipelineStateDesc.PS.BytecodeLength     = pPixelShader->shaderBlobSizeInBytes;
+    graphicsPipelineStateDesc.PS.pShaderBytecode    = pPixelShader->pShaderBlob;
+    graphicsPipelineStateDesc.NumRenderTargets      = pParameters->renderTargetCount;
+    graphicsPipelineStateDesc.DSVFormat             = pParameters->depthStencilFormat;
+    graphicsPipelineStateDesc.SampleMask            = 0xFFFFFFFF;
+    graphicsPipelineStateDesc.PrimitiveTopologyType = pParameters->primitiveTopologyType;
+    graphicsPipelineStateDesc.SampleDesc.Count      = 1u;
+    graphicsPipelineStateDesc.SampleDesc.Quality    = 0u;
+    graphicsPipelineStateDesc.BlendState            = pParameters->blendDesc;
+    graphicsPipelineStateDesc.DepthStencilState     = pParameters->depthStencilDesc;
+    graphicsPipelineStateDesc.RasterizerState       = pParameters->rasterizerDesc;
+    graphicsPipelineStateDesc.pRootSignature        = pRootSignature;
+    
+    graphicsPipelineStateDesc.InputLayout.pInputElementDescs    = pOutInputElementDescs;
+    if(!fillInputElementDescs(pVertexFormat, &pVertexShader->reflection, pOutInputElementDescs, &graphicsPipelineStateDesc.InputLayout.NumElements))
+    {
+        logError("Vertex format doesn't match the vertex shader of graphics pipeline state '%s'.", pParameters->pName);
+        return false;
+    }
 
-    wchar_t* pTextBuffer = (wchar_t*)allocateFromAllocator(pAllocator, charactersPrinted * sizeof(wchar_t), alloc_flag_clear_memory);
-    if(pTextBuffer == nullptr)
+    for(uint32_t renderTargetIndex = 0u; renderTargetIndex < pParameters->renderTargetCount; ++renderTargetIndex)
     {
-        return result_status_t::out_of_memory;
+        graphicsPipelineStateDesc.RTVFormats[renderTargetIndex] = pParameters->renderTargetFormats[renderTargetIndex];
     }
 
-    wcscpy(pTextBuffer, tempMemoryBuffer);
-    return pTextBuffer;
+    *pOutGraphicsPipelineStateDesc = graphicsPipelineStateDesc;
+    return true;
 }
 
-const char* findFirstInstanceOfCharacterInString(const char* pString, const char needle)
+//FK: Loads the pipeline state object from the pipeline library or compiles it, returns nullptr on failure
+ID3D12PipelineState* createGraphicsPipelineStateObject(D3D12DeviceType* pDevice, pipeline_library_t* pPipelineLibrary, const uint64_t key, const char* pName, const D3D12_GRAPHICS_PIPELINE_STATE_DESC* pGraphicsPipelineStateDesc)
 {
-    while(*pString)
+    ID3D12PipelineState* pPipelineStateObject = loadGraphicsPipelineStateFromLibrary(pPipelineLibrary, key, pGraphicsPipelineStateDesc);
+    if(pPipelineStateObject == nullptr)
     {
-        if(*pString == needle)
+        const HRESULT pipelineStateObjectResult = COM_CALL(pDevice->CreateGraphicsPipelineState(pGraphicsPipelineStateDesc, IID_PPV_ARGS(&pPipelineStateObject)));
+        if(pipelineStateObjectResult != S_OK)
         {
-            return pString;
+            logError("'%s' while trying to create graphics pipeline state '%s'.", getHResultString(pipelineStateObjectResult), pName);
+            return nullptr;
         }
 
-        ++pString;
+        storeGraphicsPipelineStateInLibrary(pPipelineLibrary, key, pPipelineStateObject);
     }
 
-    return nullptr;
+    setD3D12ObjectDebugName(pPipelineStateObject, pName);
+    return pPipelineStateObject;
 }
 
-bool isValidCompilerDefines(const char* pCompilerDefines)
+//FK: Publishes the result of a pipeline state creation and wakes up the threads waiting for it, failed pipeline states
+//    get removed from the pipeline state cache so that the next request tries again. Pipeline states created on the
+//    thread of a frame are usable by that frame and all later frames, see getReadyPipelineState().
+void finishGraphicsPipelineStateCreation(render_resource_cache_t* pRenderResourceCache, const graphics_pipeline_state_handle_t pipelineStateHandle, ID3D12RootSignature* pRootSignature, ID3D12PipelineState* pPipelineStateObject, const bool compiledAsynchronously, const LONG frameCompletionIndex)
 {
-    bool lastCharWasDelimiter = false;
-    while(*pCompilerDefines)
+    pipeline_state_cache_t* pPipelineStateCache = &pRenderResourceCache->pipelineStateCache;
+    AcquireSRWLockExclusive(&pPipelineStateCache->lock);
+
+    //FK: The creating thread or compile job holds a reference, so the pipeline state is still alive
+    graphics_pipeline_state_t* pPipelineState = getPipelineState(pRenderResourceCache, pipelineStateHandle);
+    ASSERT_DEBUG(pPipelineState != nullptr);
+
+    pipeline_state_cache_entry_t* pEntry = findPipelineStateCacheEntryByHandle(pPipelineStateCache, pPipelineState->cacheKey, pipelineStateHandle);
+
+    if(pPipelineStateObject != nullptr)
     {
-        if(*pCompilerDefines++ == ';')
+        pPipelineState->pPipelineState = pPipelineStateObject;
+        pPipelineState->pRootSignature = pRootSignature;
+
+        //FK: The compile job count only advances once the status is published, frames that begin in between don't see the
+        //    pipeline state as ready. Completions are serialized by the lock, so the count can't be advanced by anyone else.
+        const LONG completionIndex = compiledAsynchronously ? pPipelineStateCache->completedCompileJobCount + 1 : frameCompletionIndex;
+        InterlockedExchange(&pPipelineState->completionIndex, completionIndex);
+        InterlockedExchange(&pPipelineState->status, pipeline_state_status_ready);
+        if(compiledAsynchronously)
         {
-            if(lastCharWasDelimiter)
-            {
-                return false;
-            }
+            InterlockedExchange(&pPipelineStateCache->completedCompileJobCount, completionIndex);
+        }
 
-            lastCharWasDelimiter = true;
+        if(pEntry != nullptr)
+        {
+            pEntry->state = pipeline_state_cache_entry_ready;
         }
-        else
+    }
+    else
+    {
+        COM_RELEASE(pRootSignature);
+        ++pPipelineStateCache->statistics.failedCount;
+        InterlockedExchange(&pPipelineState->status, pipeline_state_status_failed);
+        if(pEntry != nullptr)
         {
-            lastCharWasDelimiter = false;
+            removePipelineStateCacheEntry(pRenderResourceCache->pMemoryAllocator, pPipelineStateCache, pEntry);
         }
     }
 
-    return true;
+    WakeAllConditionVariable(&pPipelineStateCache->pipelineStateCreated);
+    ReleaseSRWLockExclusive(&pPipelineStateCache->lock);
 }
 
-template<typename T>
-T rangeCheckCast(size_t value)
+void CALLBACK compileGraphicsPipelineStateThreadpoolCallback(PTP_CALLBACK_INSTANCE pInstance, PVOID pContext, PTP_WORK pWork)
 {
-    ASSERT_ALWAYS(value <= std::numeric_limits<T>::max());
-    ASSERT_ALWAYS(value >= std::numeric_limits<T>::min());
-    return (T)value;
-}
+    UNUSED_PARAMETER(pInstance);
+    UNUSED_PARAMETER(pWork);
 
-void freeCompilerArguments(memory_allocator_t* pMemoryAllocator, dxc_arguments_t* pArguments)
-{
-    for(uint32_t argumentIndex = 0u; argumentIndex < pArguments->argumentCount; ++argumentIndex)
+    render_resource_cache_t* pRenderResourceCache = (render_resource_cache_t*)pContext;
+    pipeline_state_cache_t* pPipelineStateCache = &pRenderResourceCache->pipelineStateCache;
+
+    //FK: Every submit corresponds to one queued job, it doesn't matter which callback picks up which job
+    AcquireSRWLockExclusive(&pPipelineStateCache->lock);
+    pipeline_state_compile_job_t* pCompileJob = pPipelineStateCache->pFirstCompileJob;
+    ASSERT_DEBUG(pCompileJob != nullptr);
+    pPipelineStateCache->pFirstCompileJob = pCompileJob->pNext;
+    if(pPipelineStateCache->pFirstCompileJob == nullptr)
     {
-        freeFromAllocator(pMemoryAllocator, (void*)pArguments->ppArguments[argumentIndex]);
+        pPipelineStateCache->pLastCompileJob = nullptr;
     }
+    ReleaseSRWLockExclusive(&pPipelineStateCache->lock);
 
-    freeFromAllocator(pMemoryAllocator, pArguments->ppArguments);
+    ID3D12PipelineState* pPipelineStateObject = createGraphicsPipelineStateObject(pCompileJob->pDevice, &pRenderResourceCache->pipelineLibrary, pCompileJob->key, pCompileJob->name, &pCompileJob->graphicsPipelineStateDesc);
+    finishGraphicsPipelineStateCreation(pRenderResourceCache, pCompileJob->pipelineState, pCompileJob->graphicsPipelineStateDesc.pRootSignature, pPipelineStateObject, true, 0);
+
+    //FK: Drop the reference of the compile job, the pipeline state might have been destroyed while it was compiling
+    destroyPipelineState(pRenderResourceCache, pCompileJob->pipelineState);
+
+    AcquireSRWLockExclusive(&pPipelineStateCache->lock);
+    freeFromAllocator(pRenderResourceCache->pMemoryAllocator, pCompileJob);
+    ReleaseSRWLockExclusive(&pPipelineStateCache->lock);
 }
 
-result_t<dxc_arguments_t> generateCompilerArgumentsIntoNewBuffer(memory_allocator_t* pMemoryAllocator, const shader_compilation_parameters_t* pParameters)
+graphics_pipeline_state_handle_t acquireGraphicsPipelineState(graphics_frame_t* pGraphicsFrame, const graphics_pipeline_state_parameters_t* pParameters, const bool compileAsynchronously)
 {
-    uint32_t argumentCount = 2u; //entry point + shader profile
-    dxc_arguments_t arguments = {};
+    ASSERT_DEBUG(pGraphicsFrame != nullptr);
+    ASSERT_DEBUG(pParameters != nullptr);
+    ASSERT_DEBUG(pParameters->renderTargetCount <= maxPipelineStateRenderTargetCount);
 
-    if(pParameters->pDefines != nullptr && pParameters->pDefines[0] != 0)
+    render_resource_cache_t* pRenderResourceCache = pGraphicsFrame->pRenderResourceCache;
+    const shader_binary_t* pVertexShader = getShaderBinary(pRenderResourceCache, pParameters->vertexShader);
+    const shader_binary_t* pPixelShader = getShaderBinary(pRenderResourceCache, pParameters->pixelShader);
+    const vertex_format_t* pVertexFormat = getVertexFormat(pRenderResourceCache, pParameters->vertexFormat);
+    if(pVertexShader == nullptr || pPixelShader == nullptr || pVertexFormat == nullptr)
     {
-        if(!isValidCompilerDefines(pParameters->pDefines))
-        {
-            logError("Invalid shader compiler defines '%s'.", pParameters->pDefines);
-            return result_status_t::invalid_arguments;
-        }
-
-        argumentCount += 1u;
-        argumentCount += findCharacterCountInString(pParameters->pDefines, ';');
+        logError("Invalid shader or vertex format handle for graphics pipeline state '%s'.", pParameters->pName);
+        return createInvalidResourceHandle<graphics_pipeline_state_handle_t>();
     }
 
-    wchar_t** ppArguments = (wchar_t**)allocateFromAllocator(pMemoryAllocator, sizeof(wchar_t*) * argumentCount);
-    if(ppArguments == nullptr)
+    const uint64_t key = calculateGraphicsPipelineStateKey(pParameters, pVertexShader, pPixelShader, pVertexFormat);
+
+    pipeline_state_cache_t* pPipelineStateCache = &pRenderResourceCache->pipelineStateCache;
+    AcquireSRWLockExclusive(&pPipelineStateCache->lock);
+
+    //FK: Allocations of the render resource cache allocator are guarded by the pipeline state cache lock, same as the compile jobs
+    graphics_pipeline_state_key_inputs_t keyInputs;
+    if(!createGraphicsPipelineStateKeyInputs(pRenderResourceCache->pMemoryAllocator, &keyInputs, pParameters, pVertexShader, pPixelShader, pVertexFormat))
     {
-        return result_status_t::out_of_memory;
+        ++pPipelineStateCache->statistics.failedCount;
+        ReleaseSRWLockExclusive(&pPipelineStateCache->lock);
+        logError("Out of memory while creating the key of graphics pipeline state '%s'.", pParameters->pName);
+        return createInvalidResourceHandle<graphics_pipeline_state_handle_t>();
     }
 
-    ppArguments[0] = formatWideStringIntoNewBuffer(pMemoryAllocator, L"-E %hs", pParameters->pEntryPoint);
-    ppArguments[1] = formatWideStringIntoNewBuffer(pMemoryAllocator, L"-T %hs", pParameters->pShaderProfile);
-
-    if(pParameters->pDefines != nullptr)
+    pipeline_state_cache_entry_t* pEntry = findPipelineStateCacheEntry(pPipelineStateCache, key, &keyInputs);
+    if(pEntry != nullptr)
     {
-        const char* pDefineStart    = pParameters->pDefines;
-        const char* pDefineEnd      = pParameters->pDefines + strlen(pParameters->pDefines);
+        destroyGraphicsPipelineStateKeyInputs(pRenderResourceCache->pMemoryAllocator, &keyInputs);
 
-        const char* pCurrentDefineStart = pDefineStart;
+        const graphics_pipeline_state_handle_t cachedPipelineStateHandle = pEntry->pipelineState;
+        graphics_pipeline_state_t* pPipelineState = getPipelineState(pRenderResourceCache, cachedPipelineStateHandle);
+        if(pPipelineState->status == pipeline_state_status_compiling)
+        {
+            ++pPipelineStateCache->statistics.coalescedCount;
+            while(!compileAsynchronously && pPipelineState != nullptr && pPipelineState->status == pipeline_state_status_compiling)
+            {
+                SleepConditionVariableSRW(&pPipelineStateCache->pipelineStateCreated, &pPipelineStateCache->lock, INFINITE, 0);
 
-        if(ppArguments[0] == nullptr || ppArguments[1] == nullptr)
+                //FK: The pipeline state table can grow while the lock isn't held, failed pipeline states might be gone already
+                pPipelineState = getPipelineState(pRenderResourceCache, cachedPipelineStateHandle);
+            }
+        }
+        else
         {
-            goto cleanup_and_return_out_of_memory;
-            return result_status_t::out_of_memory;
+            ++pPipelineStateCache->statistics.hitCount;
         }
-        
-        for(uint32_t argumentIndex = 2u; argumentIndex < argumentCount; ++argumentIndex)
+
+        graphics_pipeline_state_handle_t pipelineStateHandle = createInvalidResourceHandle<graphics_pipeline_state_handle_t>();
+        if(pPipelineState != nullptr && pPipelineState->status != pipeline_state_status_failed)
         {
-            const char* pCurrentDefineEnd = findFirstInstanceOfCharacterInString(pCurrentDefineStart, ';');
-            const int defineLength = rangeCheckCast<int>(pCurrentDefineEnd - pCurrentDefineStart);
-            ppArguments[argumentIndex] = formatWideStringIntoNewBuffer(pMemoryAllocator, L"-D %.*s", defineLength, pCurrentDefineStart);
-            if(ppArguments[argumentIndex] == nullptr)
-            {
-                goto cleanup_and_return_out_of_memory;
-            }
-            pCurrentDefineStart = pCurrentDefineEnd + 1;
+            //FK: Pipeline states that got compiled on the threadpool keep their completion index even for blocking requests.
+            //    Render passes of frames that began before the compile job finished must not start using them mid-frame.
+            pipelineStateHandle = cachedPipelineStateHandle;
+            ++pPipelineState->referenceCount;
         }
+
+        ReleaseSRWLockExclusive(&pPipelineStateCache->lock);
+        return pipelineStateHandle;
     }
 
-    arguments.argumentCount = argumentCount;
-    arguments.ppArguments   = (const wchar_t**)ppArguments;
-    return arguments;
+    ++pPipelineStateCache->statistics.missCount;
 
-cleanup_and_return_out_of_memory:
-    for(uint32_t argumentIndex = 0u; argumentIndex < argumentCount; ++argumentIndex)
+    graphics_pipeline_state_handle_t pipelineStateHandle = createInvalidResourceHandle<graphics_pipeline_state_handle_t>();
+    graphics_pipeline_state_t* pPipelineState = allocatePipelineState(pRenderResourceCache, &pipelineStateHandle);
+    if(pPipelineState == nullptr)
     {
-        freeFromAllocator(pMemoryAllocator, ppArguments[argumentIndex]);
+        ++pPipelineStateCache->statistics.failedCount;
+        destroyGraphicsPipelineStateKeyInputs(pRenderResourceCache->pMemoryAllocator, &keyInputs);
+        ReleaseSRWLockExclusive(&pPipelineStateCache->lock);
+        return createInvalidResourceHandle<graphics_pipeline_state_handle_t>();
     }
-    freeFromAllocator(pMemoryAllocator, ppArguments);
-
-    return result_status_t::out_of_memory;
-}
-
-void destroyShaderBinary(graphics_frame_t* pGraphicsFrame, shader_binary_t* pShaderBinary)
-{
-    ASSERT_DEBUG(pGraphicsFrame != nullptr);
-    ASSERT_DEBUG(pShaderBinary != nullptr);
 
-    freeFromAllocator(pGraphicsFrame->pMemoryAllocator, (void*)pShaderBinary->pShaderBlob);
-    freeShaderBinary(pGraphicsFrame, pShaderBinary);
-}
+    //FK: Asynchronous compile jobs hold a reference of their own until they're done
+    pPipelineState->pPipelineState      = nullptr;
+    pPipelineState->pRootSignature      = nullptr;
+    pPipelineState->cacheKey            = key;
+    pPipelineState->referenceCount      = compileAsynchronously ? 2u : 1u;
+    pPipelineState->status              = pipeline_state_status_compiling;
+    pPipelineState->completionIndex     = 0;
+    pPipelineState->isBindless          = pParameters->useBindlessRootSignature;
+    pPipelineState->drawConstantCount   = pParameters->useBindlessRootSignature ? bindlessDrawConstantCount : pParameters->drawConstantCount;
+    pPipelineState->rootParameterBindingCount = 0u;
 
-shader_binary_t* loadAndCompileShaderCodeFromFile(graphics_frame_t* pGraphicsFrame, const shader_compilation_parameters_t* pParameters)
-{
-    ASSERT_DEBUG(pGraphicsFrame != nullptr);
-    ASSERT_DEBUG(pParameters != nullptr);
-    ASSERT_DEBUG(pParameters->pEntryPoint != nullptr)
-    ASSERT_DEBUG(pParameters->pFilePath != nullptr);
-    ASSERT_DEBUG(pParameters->pShaderProfile != nullptr);
-    result_t<memory_buffer_t> shaderCodeResult = readWholeFileIntoNewBuffer(&pGraphicsFrame->tempMemoryAllocator, pParameters->pFilePath);
-    if(!isResultSuccessful(shaderCodeResult))
+    pEntry = insertPipelineStateCacheEntry(pPipelineStateCache, key, &keyInputs);
+    if(pEntry != nullptr)
     {
-        logError("Could not read shader file '%s' - error: %s.", pParameters->pFilePath, getResultString(shaderCodeResult));
-        return nullptr;
+        pEntry->pipelineState = pipelineStateHandle;
+    }
+    else
+    {
+        destroyGraphicsPipelineStateKeyInputs(pRenderResourceCache->pMemoryAllocator, &keyInputs);
+        logWarning("Pipeline state cache is full, graphics pipeline state '%s' won't be shared.", pParameters->pName);
     }
 
-    DxcBuffer shaderSourceBuffer = {};
-    shaderSourceBuffer.Ptr = shaderCodeResult.value.pData;
-    shaderSourceBuffer.Size = shaderCodeResult.value.sizeInBytes;
+    //FK: Creating the pipeline state object is the expensive part, don't block other threads while doing that
+    ReleaseSRWLockExclusive(&pPipelineStateCache->lock);
 
-    result_t<dxc_arguments_t> compileArgumentsResult = generateCompilerArgumentsIntoNewBuffer(&pGraphicsFrame->tempMemoryAllocator, pParameters);
-    if(!isResultSuccessful(compileArgumentsResult))
+    generated_root_signature_desc_t generatedRootSignatureDesc;
+    const D3D12_ROOT_SIGNATURE_DESC* pRootSignatureDesc = getPipelineStateRootSignatureDesc(pParameters, pVertexShader, pPixelShader, &generatedRootSignatureDesc);
+    ID3D12RootSignature* pRootSignature = getOrCreateRootSignature(pGraphicsFrame->pDevice, &pRenderResourceCache->rootSignatureCache, pRootSignatureDesc);
+
+    root_parameter_binding_t rootParameterBindings[maxRootParameterBindingCount];
+    uint32_t rootParameterBindingCount = 0u;
+    if(!fillRootParameterBindings(rootParameterBindings, &rootParameterBindingCount, pRootSignatureDesc))
     {
-        logError("Could not generate compiler arguments for shader file '%s' - error: %s.", pParameters->pFilePath, getResultString(compileArgumentsResult));
-        return nullptr;
+        logWarning("Root signature of graphics pipeline state '%s' has more than %u bindings, getRootParameterIndex() won't find the rest.", pParameters->pName, maxRootParameterBindingCount);
     }
 
-    IDxcResult* pCompileResult = nullptr;
+    //FK: The pipeline state table can grow while the lock isn't held. Bindings get written before the pipeline state becomes ready.
+    AcquireSRWLockExclusive(&pPipelineStateCache->lock);
+    pPipelineState = getPipelineState(pRenderResourceCache, pipelineStateHandle);
+    memcpy(pPipelineState->rootParameterBindings, rootParameterBindings, sizeof(root_parameter_binding_t) * rootParameterBindingCount);
+    pPipelineState->rootParameterBindingCount = rootParameterBindingCount;
+    ReleaseSRWLockExclusive(&pPipelineStateCache->lock);
 
-    shader_compiler_context_t* pShaderCompilerContext = pGraphicsFrame->pShaderCompilerContext;
-    const HRESULT compileResult = COM_CALL(pShaderCompilerContext->pShaderCompiler->Compile(&shaderSourceBuffer, compileArgumentsResult.value.ppArguments, compileArgumentsResult.value.argumentCount, pShaderCompilerContext->pIncludeHandler, IID_PPV_ARGS(&pCompileResult)));
-    
-    freeCompilerArguments(&pGraphicsFrame->tempMemoryAllocator, &compileArgumentsResult.value);
-    freeFromAllocator(&pGraphicsFrame->tempMemoryAllocator, shaderCodeResult.value.pData);
-    
-    if(compileResult != S_OK)
+    D3D12_INPUT_ELEMENT_DESC inputElementDescs[maxVertexAttributeCount] = {};
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelineStateDesc = {};
+    const bool canCreatePipelineState = pRootSignature != nullptr && fillGraphicsPipelineStateDesc(&graphicsPipelineStateDesc, inputElementDescs, pParameters, pVertexShader, pPixelShader, pVertexFormat, pRootSignature);
+
+    pipeline_state_compile_job_t* pCompileJob = nullptr;
+    if(canCreatePipelineState && compileAsynchronously)
     {
-        logError("Shader compiler couldn't compile shader '%s' - error: %s.", pParameters->pFilePath, getHResultString(compileResult));
-        return nullptr;
+        AcquireSRWLockExclusive(&pPipelineStateCache->lock);
+        pCompileJob = (pipeline_state_compile_job_t*)allocateFromAllocator(pRenderResourceCache->pMemoryAllocator, sizeof(pipeline_state_compile_job_t));
+        if(pPipelineStateCache->pCompileWork == nullptr && pCompileJob != nullptr)
+        {
+            pPipelineStateCache->pCompileWork = CreateThreadpoolWork(compileGraphicsPipelineStateThreadpoolCallback, pRenderResourceCache, nullptr);
+        }
+        ReleaseSRWLockExclusive(&pPipelineStateCache->lock);
     }
 
-    if(pCompileResult->HasOutput(DXC_OUT_ERRORS))
+    if(pCompileJob != nullptr && pPipelineStateCache->pCompileWork != nullptr)
     {
-        IDxcBlobEncoding* pErrorBufferEncoding = nullptr;
-        const HRESULT getErrorBufferResult = COM_CALL(pCompileResult->GetErrorBuffer(&pErrorBufferEncoding));
-        if(getErrorBufferResult != S_OK)
+        pCompileJob->pNext          = nullptr;
+        pCompileJob->pDevice        = pGraphicsFrame->pDevice;
+        pCompileJob->pipelineState  = pipelineStateHandle;
+        pCompileJob->key            = key;
+        snprintf(pCompileJob->name, sizeof(pCompileJob->name), "%s", pParameters->pName != nullptr ? pParameters->pName : "");
+        memcpy(pCompileJob->inputElementDescs, inputElementDescs, sizeof(inputElementDescs));
+        pCompileJob->graphicsPipelineStateDesc = graphicsPipelineStateDesc;
+        pCompileJob->graphicsPipelineStateDesc.InputLayout.pInputElementDescs = pCompileJob->inputElementDescs;
+
+        AcquireSRWLockExclusive(&pPipelineStateCache->lock);
+        if(pPipelineStateCache->pLastCompileJob == nullptr)
         {
-            logError("Shader compilation of shader '%s' failed but the error couldn't get retrieved - error: %s.", pParameters->pFilePath, getHResultString(getErrorBufferResult));
-            pCompileResult->Release();
-            return nullptr;
+            pPipelineStateCache->pFirstCompileJob = pCompileJob;
         }
-
-        if(pErrorBufferEncoding != nullptr && pErrorBufferEncoding->GetBufferSize() > 0)
+        else
         {
-            logError("Shader compilation of shader '%s' failed because: %s\n", pParameters->pFilePath, (char*)pErrorBufferEncoding->GetBufferPointer());
-            pErrorBufferEncoding->Release();
-            pCompileResult->Release();
-            return nullptr;
+            pPipelineStateCache->pLastCompileJob->pNext = pCompileJob;
         }
-    }
+        pPipelineStateCache->pLastCompileJob = pCompileJob;
+        ++pPipelineStateCache->statistics.compileJobCount;
+        ReleaseSRWLockExclusive(&pPipelineStateCache->lock);
 
-    IDxcBlob* pCompileShaderBlob = nullptr;
-    const HRESULT getBlobOutputResult = COM_CALL(pCompileResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&pCompileShaderBlob), nullptr));
-    pCompileResult->Release();
+        SubmitThreadpoolWork(pPipelineStateCache->pCompileWork);
+        return pipelineStateHandle;
+    }
 
-    if(getBlobOutputResult != S_OK)
+    //FK: Blocking requests and asynchronous requests that couldn't get a compile job get created on this thread
+    ID3D12PipelineState* pPipelineStateObject = nullptr;
+    if(canCreatePipelineState)
     {
-        pCompileShaderBlob->Release();
-        logError("Shader compilation of shader '%s' was successful but there's no shader blob. GetOutput() error: %s", pParameters->pFilePath, getHResultString(getBlobOutputResult));
-        return nullptr;
+        pPipelineStateObject = createGraphicsPipelineStateObject(pGraphicsFrame->pDevice, &pRenderResourceCache->pipelineLibrary, key, pParameters->pName, &graphicsPipelineStateDesc);
     }
 
-#if 0
-    ID3D12ShaderReflection* pShaderReflection = nullptr;
-    const HRESULT shaderReflectionResult = D3DReflect(pCompileShaderBlob->GetBufferPointer(), pCompileShaderBlob->GetBufferSize(), IID_PPV_ARGS(&pShaderReflection));
-    if(shaderReflectionResult != S_OK)
+    if(pCompileJob != nullptr)
     {
-        pCompileShaderBlob->Release();
-        logError("Could not reflect shader '%s' - %s", pParameters->pFilePath, getHResultString(shaderReflectionResult));
-        return nullptr;
+        AcquireSRWLockExclusive(&pPipelineStateCache->lock);
+        freeFromAllocator(pRenderResourceCache->pMemoryAllocator, pCompileJob);
+        ReleaseSRWLockExclusive(&pPipelineStateCache->lock);
     }
-#endif
-    const uint32_t shaderBlobSizeInBytes = rangeCheckCast<uint32_t>(pCompileShaderBlob->GetBufferSize());
-    uint8_t* pShaderBlobCopy = (uint8_t*)allocateFromAllocator(pGraphicsFrame->pMemoryAllocator, pCompileShaderBlob->GetBufferSize());
-    if(pShaderBlobCopy == nullptr)
+
+    finishGraphicsPipelineStateCreation(pRenderResourceCache, pipelineStateHandle, pRootSignature, pPipelineStateObject, false, pGraphicsFrame->pipelineStateCompletionIndex);
+    if(compileAsynchronously)
     {
-        logError("Shader compilation of shader '%s' was successful but we ran out of memory trying to copy the shader blob.", pParameters->pFilePath);
-        pCompileShaderBlob->Release();
-        return nullptr;
+        destroyPipelineState(pRenderResourceCache, pipelineStateHandle);
     }
 
-    memcpy(pShaderBlobCopy, pCompileShaderBlob->GetBufferPointer(), pCompileShaderBlob->GetBufferSize());
-    pCompileShaderBlob->Release();
-
-    shader_binary_t* pShaderBinary = allocateShaderBinary(pGraphicsFrame->pRenderResourceCache);
-    if(pShaderBinary == nullptr)
+    if(pPipelineStateObject == nullptr)
     {
-        return nullptr;
+        destroyPipelineState(pRenderResourceCache, pipelineStateHandle);
+        return createInvalidResourceHandle<graphics_pipeline_state_handle_t>();
     }
 
-    pShaderBinary->pShaderBlob = pShaderBlobCopy;
-    pShaderBinary->shaderBlobSizeInBytes = shaderBlobSizeInBytes;
+    return pipelineStateHandle;
+}
+
+//FK: Returns the existing pipeline state if one with the same parameters has been created before, every call has to be
+//    matched by a destroyPipelineState() call. Can be called from multiple threads - requests for a pipeline state that is
+//    getting created by another thread wait for that thread instead of creating the same pipeline state twice.
+graphics_pipeline_state_handle_t createGraphicsPipelineState(graphics_frame_t* pGraphicsFrame, const graphics_pipeline_state_parameters_t* pParameters)
+{
+    return acquireGraphicsPipelineState(pGraphicsFrame, pParameters, false);
+}
 
-    return pShaderBinary;
+//FK: Same as createGraphicsPipelineState() but returns right away and compiles the pipeline state on the threadpool.
+//    The pipeline state can be used by frames that begin after it finished compiling, see trySetPipelineState().
+//    Shader binaries have to stay alive until then. Returns an invalid handle if the pipeline state can't be created at all.
+graphics_pipeline_state_handle_t requestGraphicsPipelineState(graphics_frame_t* pGraphicsFrame, const graphics_pipeline_state_parameters_t* pParameters)
+{
+    return acquireGraphicsPipelineState(pGraphicsFrame, pParameters, true);
+}
+
+//FK: Blocks until all pipeline states requested with requestGraphicsPipelineState() are compiled
+void waitForPipelineStateCompileJobs(render_resource_cache_t* pRenderResourceCache)
+{
+    pipeline_state_cache_t* pPipelineStateCache = &pRenderResourceCache->pipelineStateCache;
+    if(pPipelineStateCache->pCompileWork != nullptr)
+    {
+        WaitForThreadpoolWorkCallbacks(pPipelineStateCache->pCompileWork, FALSE);
+    }
 }
 
 void destroyFence(ID3D12Fence* pFence)
@@ -2281,7 +9721,28 @@ void destroyCommandAllocator(ID3D12CommandAllocator* pCommandAllocator)
 
 void shutdownRenderContext(render_context_t* pRenderContext)
 {
+    waitForPipelineStateCompileJobs(&pRenderContext->renderResourceCache);
+    if(pRenderContext->renderResourceCache.pipelineStateCache.pCompileWork != nullptr)
+    {
+        CloseThreadpoolWork(pRenderContext->renderResourceCache.pipelineStateCache.pCompileWork);
+    }
+
     destroyGraphicsFrameCollection(&pRenderContext->graphicsFramesCollection);
+    for(uint32_t renderPassIndex = 0u; renderPassIndex < pRenderContext->renderResourceCache.renderPasses.capacity; ++renderPassIndex)
+    {
+        destroyDrawQueue(&((render_pass_t*)pRenderContext->renderResourceCache.renderPasses.pData)[renderPassIndex].drawQueue);
+    }
+
+    destroyShaderCompilerContext(&pRenderContext->shaderCompilerContext);
+    savePipelineLibrary(&pRenderContext->renderResourceCache.pipelineLibrary);
+    destroyPipelineLibrary(&pRenderContext->renderResourceCache.pipelineLibrary);
+    destroyRootSignatureCache(&pRenderContext->renderResourceCache.rootSignatureCache);
+    destroyUploadQueue(&pRenderContext->uploadQueue);
+    destroyUploadRingBuffer(&pRenderContext->uploadRingBuffer);
+    destroyBindlessDescriptorTable(&pRenderContext->bindlessDescriptorTable);
+    destroyDescriptorHeap(&pRenderContext->shaderVisibleDescriptorHeap);
+    destroyPersistentDescriptorAllocator(&pRenderContext->samplerDescriptorAllocator);
+    destroyPersistentDescriptorAllocator(&pRenderContext->persistentDescriptorAllocator);
     destroySwapChain(&pRenderContext->swapChain);
     COM_RELEASE(pRenderContext->pDefaultDirectCommandQueue);
     COM_RELEASE(pRenderContext->pDefaultCopyCommandQueue);
@@ -2332,14 +9793,20 @@ render_context_parameters_t createDefaultRenderContextParameters(HWND pWindowHan
     parameters.windowHeight                             = windowHeight;
     parameters.windowWidth                              = windowWidth;
     parameters.pWindowHandle                            = pWindowHandle;
-    parameters.limits.maxUploadBufferCount              = 32u;
     parameters.limits.maxVertexBufferCount              = 32u;
     parameters.limits.maxRenderPassCount                = 32u;
     parameters.limits.maxPipelineStateCount             = 32u;
+    parameters.limits.maxRootSignatureCount             = 16u;
     parameters.limits.maxRenderTargetCount              = 32u;
     parameters.limits.maxShaderBinaryCount              = 32u;
     parameters.limits.maxVertexFormatCount              = 32u;
-    parameters.limits.defaultStagingBufferSizeInBytes   = 4096u;
+    parameters.limits.maxPersistentDescriptorCount      = 4096u;
+    parameters.limits.maxBindlessDescriptorCount        = 16384u;
+    parameters.limits.maxTransientDescriptorCount       = 16384u;
+    parameters.limits.maxSamplerDescriptorCount         = 256u;
+    parameters.limits.defaultStagingBufferSizeInBytes   = 16u * 1024u * 1024u;
+    parameters.limits.frameTempMemorySizeInBytes        = 1024u * 1024u;
+    parameters.limits.frameConstantBufferSizeInBytes    = 2u * 1024u * 1024u;
 
     return parameters;
 }
\ No newline at end of file
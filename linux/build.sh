@@ -0,0 +1,19 @@
+#!/bin/sh
+# Builds the cpu benchmark against the null device, no GPU or window required.
+# Usage: build.sh [debug|release]
+
+SCRIPT_DIRECTORY=$(cd "$(dirname "$0")" && pwd)
+OUTPUT_FOLDER="$SCRIPT_DIRECTORY/build"
+OUTPUT_FILE_NAME=cpu_benchmark
+C_FILES="$SCRIPT_DIRECTORY/../tests/cpu_benchmark/cpu_benchmark.cpp"
+CXX=${CXX:-c++}
+
+if [ "$1" = "release" ]; then
+    COMPILER_OPTIONS="-O2 -DNDEBUG"
+else
+    COMPILER_OPTIONS="-O0 -g"
+fi
+
+mkdir -p "$OUTPUT_FOLDER" || exit 1
+$CXX -std=c++17 -DUSE_NULL_DEVICE=1 $COMPILER_OPTIONS -o "$OUTPUT_FOLDER/$OUTPUT_FILE_NAME" $C_FILES -lpthread || exit 1
+echo "Built $OUTPUT_FOLDER/$OUTPUT_FILE_NAME"
@@ -0,0 +1,3417 @@
+#include "../../k15_d3d12_renderer.hpp"
+
+#define CHECK(x) checkCondition(x, #x, __FILE__, __LINE__)
+
+static uint32_t failedCheckCount = 0u;
+
+void checkCondition(const bool condition, const char* pExpression, const char* pFile, const uint32_t lineNumber)
+{
+    if(!condition)
+    {
+        printf("Check failed: '%s' in %s:%u\n", pExpression, pFile, lineNumber);
+        ++failedCheckCount;
+    }
+}
+
+struct benchmark_timer_t
+{
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER startTime;
+};
+
+void startBenchmarkTimer(benchmark_timer_t* pTimer)
+{
+    QueryPerformanceFrequency(&pTimer->frequency);
+    QueryPerformanceCounter(&pTimer->startTime);
+}
+
+double stopBenchmarkTimerInMilliseconds(const benchmark_timer_t* pTimer)
+{
+    LARGE_INTEGER endTime;
+    QueryPerformanceCounter(&endTime);
+    return ((double)(endTime.QuadPart - pTimer->startTime.QuadPart) / (double)pTimer->frequency.QuadPart) * 1000.0;
+}
+
+void printBenchmarkResult(const char* pName, const double timeInMs, const uint64_t iterationCount)
+{
+    printf("%-56s %10.3f ms (%8.2f ns/iteration)\n", pName, timeInMs, (timeInMs * 1000000.0) / (double)iterationCount);
+}
+
+void testLinearMemoryAllocator()
+{
+    memory_allocator_t defaultAllocator = {};
+    createDefaultMemoryAllocator(&defaultAllocator);
+
+    linear_memory_allocator_t linearAllocator = {};
+    CHECK(createLinearMemoryAllocator(&linearAllocator, &defaultAllocator, 256u));
+
+    uint8_t* pFirst = (uint8_t*)allocateFromAllocator(&linearAllocator, 3u);
+    uint8_t* pSecond = (uint8_t*)allocateAlignedFromAllocator(&linearAllocator, 16u, 64u);
+    CHECK(pFirst != nullptr && pSecond != nullptr);
+    CHECK(((uint64_t)pSecond & 63u) == 0u);
+    CHECK(pSecond > pFirst);
+
+    //FK: Overflow the first chunk, this should chain in a new one instead of failing
+    uint8_t* pLarge = (uint8_t*)allocateFromAllocator(&linearAllocator, 1024u);
+    CHECK(pLarge != nullptr);
+    CHECK(linearAllocator.chunkCount == 2u);
+    CHECK(linearAllocator.usedSizeInBytes == 256u + 1024u);
+    CHECK(linearAllocator.highWaterMarkInBytes == 256u + 1024u);
+
+    const uint64_t usedSizeInBytes = linearAllocator.usedSizeInBytes;
+    resetAllocator(&linearAllocator);
+    CHECK(linearAllocator.usedSizeInBytes == 0u);
+    CHECK(linearAllocator.frameHighWaterMarkInBytes == usedSizeInBytes);
+
+    //FK: After a reset the first chunk gets reused and chained chunks are kept around
+    uint8_t* pAfterReset = (uint8_t*)allocateFromAllocator(&linearAllocator, 3u);
+    CHECK(pAfterReset == pFirst);
+    CHECK(allocateFromAllocator(&linearAllocator, 1024u) == pLarge);
+    CHECK(linearAllocator.chunkCount == 2u);
+
+    //FK: Advancing to an already chained chunk skips the tail of the first chunk the same way chaining did
+    CHECK(linearAllocator.usedSizeInBytes == usedSizeInBytes);
+
+    destroyLinearMemoryAllocator(&linearAllocator);
+}
+
+void testResourceTable()
+{
+    memory_allocator_t defaultAllocator = {};
+    createDefaultMemoryAllocator(&defaultAllocator);
+
+    vertex_format_t preallocatedFormats[2] = {};
+    resource_table_slot_t preallocatedSlots[2] = {};
+
+    resource_table_t<vertex_format_t, vertex_format_handle_t> vertexFormats = {};
+    createResourceTableWithPreallocatedMemory(&vertexFormats, &defaultAllocator, preallocatedFormats, preallocatedSlots, sizeof(vertex_format_t), 2u);
+
+    uint32_t index = 0u;
+    uint32_t generation = 0u;
+    vertex_format_t* pFirstFormat = (vertex_format_t*)allocateFromResourceTableDontGrow(&vertexFormats, &index, &generation);
+    CHECK(pFirstFormat != nullptr);
+    pFirstFormat->vertexAttributeCount = 1u;
+    const vertex_format_handle_t firstHandle = createResourceHandle<vertex_format_handle_t>(index, generation);
+
+    allocateFromResourceTableDontGrow(&vertexFormats, &index, &generation);
+    const vertex_format_handle_t secondHandle = createResourceHandle<vertex_format_handle_t>(index, generation);
+    CHECK(allocateFromResourceTableDontGrow(&vertexFormats, &index, &generation) == nullptr);
+
+    //FK: Growing must keep handles valid and must not free the preallocated memory
+    CHECK(tryToGrowResourceTable(&vertexFormats));
+    CHECK(vertexFormats.capacity == 4u && vertexFormats.ownsMemory);
+    CHECK(getFromResourceTable(&vertexFormats, firstHandle) != nullptr);
+    CHECK(getFromResourceTable(&vertexFormats, firstHandle)->vertexAttributeCount == 1u);
+
+    //FK: Freed slots get reused and old handles to them become stale
+    CHECK(freeFromResourceTable(&vertexFormats, secondHandle));
+    CHECK(!freeFromResourceTable(&vertexFormats, secondHandle));
+    CHECK(getFromResourceTable(&vertexFormats, secondHandle) == nullptr);
+
+    allocateFromResourceTableDontGrow(&vertexFormats, &index, &generation);
+    const vertex_format_handle_t reusedHandle = createResourceHandle<vertex_format_handle_t>(index, generation);
+    CHECK(reusedHandle.index == secondHandle.index);
+    CHECK(reusedHandle.generation != secondHandle.generation);
+    CHECK(getFromResourceTable(&vertexFormats, secondHandle) == nullptr);
+    CHECK(getFromResourceTable(&vertexFormats, reusedHandle) != nullptr);
+    CHECK(vertexFormats.aliveCount == 2u);
+
+    CHECK(getFromResourceTable(&vertexFormats, createInvalidResourceHandle<vertex_format_handle_t>()) == nullptr);
+
+    destroyResourceTable(&vertexFormats);
+}
+
+void testRingBufferAllocator()
+{
+    ring_buffer_allocator_t ringBuffer = {};
+    createRingBufferAllocator(&ringBuffer, 1024u);
+
+    //FK: Simulated GPU fence, frames get signaled with their frame index like in finishFrame()
+    uint64_t completedFenceValue = 0u;
+
+    buffer_slice_t slice = {};
+    CHECK(allocateFromRingBuffer(&ringBuffer, 100u, 16u, &slice));
+    CHECK(slice.startByteIndex == 0u && slice.endByteIndex == 100u);
+    CHECK(allocateFromRingBuffer(&ringBuffer, 100u, 16u, &slice));
+    CHECK(slice.startByteIndex == 112u);
+    closeRingBufferFrame(&ringBuffer, 1u);
+
+    CHECK(allocateFromRingBuffer(&ringBuffer, 600u, 256u, &slice));
+    CHECK(slice.startByteIndex == 256u);
+    closeRingBufferFrame(&ringBuffer, 2u);
+
+    //FK: Doesn't fit at the end and the start is still in use by frame 1
+    CHECK(!allocateFromRingBuffer(&ringBuffer, 200u, 16u, &slice));
+
+    completedFenceValue = 1u;
+    reclaimRingBuffer(&ringBuffer, completedFenceValue);
+    CHECK(ringBuffer.inFlightSliceCount == 1u);
+
+    //FK: Wraps around to the start now that frame 1 got reclaimed
+    CHECK(allocateFromRingBuffer(&ringBuffer, 200u, 16u, &slice));
+    CHECK(slice.startByteIndex == 0u && slice.endByteIndex == 200u);
+    CHECK(!allocateFromRingBuffer(&ringBuffer, 100u, 16u, &slice));
+    closeRingBufferFrame(&ringBuffer, 3u);
+
+    //FK: Empty frames don't occupy an in flight slot
+    closeRingBufferFrame(&ringBuffer, 4u);
+    CHECK(ringBuffer.inFlightSliceCount == 2u);
+
+    completedFenceValue = 4u;
+    reclaimRingBuffer(&ringBuffer, completedFenceValue);
+    CHECK(ringBuffer.inFlightSliceCount == 0u);
+    CHECK(getRingBufferUsedSizeInBytes(&ringBuffer) == 0u);
+    CHECK(ringBuffer.highWaterMarkInBytes <= ringBuffer.sizeInBytes);
+
+    CHECK(!allocateFromRingBuffer(&ringBuffer, 2048u, 16u, &slice));
+    CHECK(allocateFromRingBuffer(&ringBuffer, 1024u - 200u, 8u, &slice));
+    CHECK(slice.startByteIndex == 200u && slice.endByteIndex == 1024u);
+    closeRingBufferFrame(&ringBuffer, 5u);
+    reclaimRingBuffer(&ringBuffer, 5u);
+
+    //FK: More frames in flight than slots available, the newest slot gets extended and no bytes get lost
+    const uint64_t lastFrameIndex = 6u + maxRingBufferInFlightSliceCount * 2u;
+    for(uint64_t frameIndex = 6u; frameIndex <= lastFrameIndex; ++frameIndex)
+    {
+        CHECK(allocateFromRingBuffer(&ringBuffer, 16u, 16u, &slice));
+        closeRingBufferFrame(&ringBuffer, frameIndex);
+    }
+
+    CHECK(ringBuffer.inFlightSliceCount == maxRingBufferInFlightSliceCount);
+    reclaimRingBuffer(&ringBuffer, lastFrameIndex - 1u);
+    CHECK(getRingBufferUsedSizeInBytes(&ringBuffer) > 0u);
+    reclaimRingBuffer(&ringBuffer, lastFrameIndex);
+    CHECK(getRingBufferUsedSizeInBytes(&ringBuffer) == 0u);
+}
+
+void testResourceBarrierBatch()
+{
+    //FK: Barriers only get compared by resource pointer, fake resources are good enough as long as nothing gets flushed
+    uint32_t fakeResources[2] = {};
+    d3d12_resource_t renderTarget = {(ID3D12Resource*)&fakeResources[0], D3D12_RESOURCE_STATE_PRESENT};
+    d3d12_resource_t vertexBuffer = {(ID3D12Resource*)&fakeResources[1], D3D12_RESOURCE_STATE_COMMON};
+
+    resource_barrier_batch_t barrierBatch = {};
+    initResourceBarrierBatch(&barrierBatch, nullptr);
+
+    //FK: Transition into the current state is a no-op
+    transitionResource(&barrierBatch, &renderTarget, D3D12_RESOURCE_STATE_PRESENT);
+    CHECK(barrierBatch.pendingBarrierCount == 0u);
+
+    transitionResource(&barrierBatch, &renderTarget, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    transitionResource(&barrierBatch, &vertexBuffer, D3D12_RESOURCE_STATE_COPY_DEST);
+    CHECK(barrierBatch.pendingBarrierCount == 2u);
+    CHECK(renderTarget.currentState == D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    //FK: A->B->C gets merged into A->C
+    transitionResource(&barrierBatch, &vertexBuffer, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    CHECK(barrierBatch.pendingBarrierCount == 2u);
+    CHECK(barrierBatch.statistics.elidedBarrierCount == 1u);
+    CHECK(barrierBatch.pendingBarriers[1].Transition.StateBefore == D3D12_RESOURCE_STATE_COMMON);
+    CHECK(barrierBatch.pendingBarriers[1].Transition.StateAfter == D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+
+    //FK: A->B->A cancels out completely
+    transitionResource(&barrierBatch, &renderTarget, D3D12_RESOURCE_STATE_PRESENT);
+    CHECK(barrierBatch.pendingBarrierCount == 1u);
+    CHECK(barrierBatch.statistics.elidedBarrierCount == 3u);
+    CHECK(barrierBatch.pendingBarriers[0].Transition.pResource == vertexBuffer.pResource);
+    CHECK(renderTarget.currentState == D3D12_RESOURCE_STATE_PRESENT);
+
+    transitionResource(&barrierBatch, &vertexBuffer, D3D12_RESOURCE_STATE_COMMON);
+    CHECK(barrierBatch.pendingBarrierCount == 0u);
+    CHECK(barrierBatch.statistics.elidedBarrierCount == 5u);
+    CHECK(barrierBatch.statistics.issuedBarrierCount == 0u);
+
+    resource_barrier_statistics_t frameStatistics = {1u, 1u};
+    addResourceBarrierStatistics(&frameStatistics, &barrierBatch.statistics);
+    CHECK(frameStatistics.issuedBarrierCount == 1u && frameStatistics.elidedBarrierCount == 6u);
+}
+
+void testRenderPassStateCache()
+{
+    render_pass_state_cache_t stateCache = {};
+    resetRenderPassStateCache(&stateCache);
+
+    D3D12_VIEWPORT viewport = {};
+    viewport.Width = 1024.0f;
+    viewport.Height = 768.0f;
+    viewport.MaxDepth = 1.0f;
+
+    //FK: First call after a reset always goes through, even for zeroed state
+    const D3D12_RECT emptyScissorRect = {};
+    CHECK(hasCachedStateChanged(&stateCache, &stateCache.scissorRect, emptyScissorRect));
+    CHECK(hasCachedStateChanged(&stateCache, &stateCache.viewport, viewport));
+    CHECK(!hasCachedStateChanged(&stateCache, &stateCache.viewport, viewport));
+
+    viewport.Width = 512.0f;
+    CHECK(hasCachedStateChanged(&stateCache, &stateCache.viewport, viewport));
+
+    vertex_buffer_binding_t binding = {};
+    binding.vertexBuffer = createResourceHandle<vertex_buffer_handle_t>(0u, 1u);
+    binding.vertexFormat = createResourceHandle<vertex_format_handle_t>(0u, 1u);
+    CHECK(hasCachedStateChanged(&stateCache, &stateCache.vertexBufferBindings[0], binding));
+    CHECK(!hasCachedStateChanged(&stateCache, &stateCache.vertexBufferBindings[0], binding));
+
+    //FK: Same slot, recycled vertex buffer with a new generation
+    binding.vertexBuffer = createResourceHandle<vertex_buffer_handle_t>(0u, 3u);
+    CHECK(hasCachedStateChanged(&stateCache, &stateCache.vertexBufferBindings[0], binding));
+
+    CHECK(stateCache.statistics.issuedCallCount == 5u);
+    CHECK(stateCache.statistics.skippedCallCount == 2u);
+
+    resetRenderPassStateCache(&stateCache);
+    CHECK(stateCache.statistics.issuedCallCount == 0u);
+    CHECK(hasCachedStateChanged(&stateCache, &stateCache.viewport, viewport));
+}
+
+void testDrawSortKeys()
+{
+    const graphics_pipeline_state_handle_t firstPipelineState = createResourceHandle<graphics_pipeline_state_handle_t>(0u, 1u);
+    const graphics_pipeline_state_handle_t lastPipelineState = createResourceHandle<graphics_pipeline_state_handle_t>(0xFFFFu, 1u);
+    const vertex_buffer_handle_t firstVertexBuffer = createResourceHandle<vertex_buffer_handle_t>(0u, 1u);
+    const vertex_buffer_handle_t lastVertexBuffer = createResourceHandle<vertex_buffer_handle_t>(0xFFFFu, 1u);
+
+    //FK: Layer first, then pipeline state, vertex buffer and depth
+    CHECK(createDrawSortKey(1u, firstPipelineState, firstVertexBuffer, 0.0f) > createDrawSortKey(0u, lastPipelineState, lastVertexBuffer, 1.0f));
+    CHECK(createDrawSortKey(0u, lastPipelineState, firstVertexBuffer, 0.0f) > createDrawSortKey(0u, firstPipelineState, lastVertexBuffer, 1.0f));
+    CHECK(createDrawSortKey(0u, firstPipelineState, lastVertexBuffer, 0.0f) > createDrawSortKey(0u, firstPipelineState, firstVertexBuffer, 1.0f));
+    CHECK(createDrawSortKey(0u, firstPipelineState, firstVertexBuffer, 0.75f) > createDrawSortKey(0u, firstPipelineState, firstVertexBuffer, 0.25f));
+    CHECK(createDrawSortKey(0u, firstPipelineState, firstVertexBuffer, -1.0f) == createDrawSortKey(0u, firstPipelineState, firstVertexBuffer, 0.0f));
+    CHECK(createDrawSortKey(0u, firstPipelineState, firstVertexBuffer, 2.0f) == createDrawSortKey(0u, firstPipelineState, firstVertexBuffer, 1.0f));
+
+    const uint32_t entryCount = 1000u;
+    draw_sort_entry_t entries[entryCount];
+    draw_sort_entry_t scratchEntries[entryCount];
+    uint32_t randomValue = 12345u;
+    for(uint32_t entryIndex = 0u; entryIndex < entryCount; ++entryIndex)
+    {
+        randomValue = randomValue * 1664525u + 1013904223u;
+        entries[entryIndex].sortKey     = ((uint64_t)(randomValue >> 24u) << 56u) | (randomValue % 97u);
+        entries[entryIndex].drawIndex   = entryIndex;
+    }
+
+    //FK: Sorted ascending, equal keys keep their order. The 6 digits that are zero for all keys get skipped.
+    uint32_t sortPassCount = 0u;
+    const draw_sort_entry_t* pSortedEntries = radixSortDrawSortEntries(entries, scratchEntries, entryCount, &sortPassCount);
+    CHECK(sortPassCount == 2u);
+    for(uint32_t entryIndex = 1u; entryIndex < entryCount; ++entryIndex)
+    {
+        const draw_sort_entry_t* pPrevious = pSortedEntries + entryIndex - 1u;
+        const draw_sort_entry_t* pCurrent = pSortedEntries + entryIndex;
+        CHECK(pPrevious->sortKey < pCurrent->sortKey || (pPrevious->sortKey == pCurrent->sortKey && pPrevious->drawIndex < pCurrent->drawIndex));
+    }
+}
+
+void testRenderPassSortOrder()
+{
+    //FK: Execution order as it could come from multiple recording threads
+    const uint32_t sortIndices[6] = {3u, 0u, 2u, 0u, 5u, 2u};
+    render_pass_t renderPasses[6] = {};
+    render_pass_t* ppRenderPasses[6] = {};
+    for(uint32_t renderPassIndex = 0u; renderPassIndex < 6u; ++renderPassIndex)
+    {
+        renderPasses[renderPassIndex].sortIndex = sortIndices[renderPassIndex];
+        ppRenderPasses[renderPassIndex] = renderPasses + renderPassIndex;
+    }
+
+    sortRenderPassesBySortIndex(ppRenderPasses, 6u);
+
+    for(uint32_t renderPassIndex = 1u; renderPassIndex < 6u; ++renderPassIndex)
+    {
+        CHECK(ppRenderPasses[renderPassIndex - 1u]->sortIndex <= ppRenderPasses[renderPassIndex]->sortIndex);
+    }
+
+    //FK: Equal sort indices keep their execution order
+    CHECK(ppRenderPasses[0] == &renderPasses[1] && ppRenderPasses[1] == &renderPasses[3]);
+    CHECK(ppRenderPasses[2] == &renderPasses[2] && ppRenderPasses[3] == &renderPasses[5]);
+    CHECK(ppRenderPasses[5] == &renderPasses[4]);
+}
+
+D3D12_RESOURCE_DESC createTestRenderTargetDesc(const uint32_t width, const uint32_t height)
+{
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension          = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    desc.Width              = width;
+    desc.Height             = height;
+    desc.DepthOrArraySize   = 1u;
+    desc.MipLevels          = 1u;
+    desc.Format             = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count   = 1u;
+    desc.Flags              = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+    return desc;
+}
+
+void testRenderGraphCulling()
+{
+    memory_allocator_t defaultAllocator = {};
+    createDefaultMemoryAllocator(&defaultAllocator);
+
+    render_graph_parameters_t parameters = {16u, 16u, 64u};
+    render_graph_t renderGraph = {};
+    CHECK(createRenderGraph(&renderGraph, &defaultAllocator, &parameters));
+
+    d3d12_resource_t backBuffer = {(ID3D12Resource*)0x10, D3D12_RESOURCE_STATE_PRESENT};
+    const D3D12_RESOURCE_DESC desc = createTestRenderTargetDesc(1920u, 1080u);
+    const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = {8u * 1024u * 1024u, 65536u};
+
+    const render_graph_resource_handle_t backBufferHandle = importRenderGraphResource(&renderGraph, "Back Buffer", &backBuffer, D3D12_RESOURCE_STATE_PRESENT, true);
+    const render_graph_resource_handle_t gbuffer = createRenderGraphTransientResource(&renderGraph, "GBuffer", desc, allocationInfo, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    const render_graph_resource_handle_t debugView = createRenderGraphTransientResource(&renderGraph, "Debug View", desc, allocationInfo, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    const render_graph_resource_handle_t ambientOcclusion = createRenderGraphTransientResource(&renderGraph, "Ambient Occlusion", desc, allocationInfo, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    const render_graph_pass_handle_t gbufferPass = addRenderGraphPass(&renderGraph, "GBuffer", nullptr, nullptr, nullptr);
+    writeRenderGraphResource(&renderGraph, gbufferPass, gbuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    //FK: Nothing reads the debug view, so this pass should get culled
+    const render_graph_pass_handle_t debugPass = addRenderGraphPass(&renderGraph, "Debug", nullptr, nullptr, nullptr);
+    readRenderGraphResource(&renderGraph, debugPass, gbuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    writeRenderGraphResource(&renderGraph, debugPass, debugView, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    const render_graph_pass_handle_t ambientOcclusionPass = addRenderGraphPass(&renderGraph, "Ambient Occlusion", nullptr, nullptr, nullptr);
+    readRenderGraphResource(&renderGraph, ambientOcclusionPass, gbuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    writeRenderGraphResource(&renderGraph, ambientOcclusionPass, ambientOcclusion, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    const render_graph_pass_handle_t lightingPass = addRenderGraphPass(&renderGraph, "Lighting", nullptr, nullptr, nullptr);
+    readRenderGraphResource(&renderGraph, lightingPass, gbuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    readRenderGraphResource(&renderGraph, lightingPass, ambientOcclusion, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    writeRenderGraphResource(&renderGraph, lightingPass, backBufferHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    compileRenderGraph(&renderGraph);
+
+    CHECK(renderGraph.statistics.culledPassCount == 1u);
+    CHECK(!renderGraph.pPasses[gbufferPass.index].isCulled);
+    CHECK(renderGraph.pPasses[debugPass.index].isCulled);
+    CHECK(!renderGraph.pPasses[ambientOcclusionPass.index].isCulled);
+    CHECK(!renderGraph.pPasses[lightingPass.index].isCulled);
+    CHECK(renderGraph.pResources[debugView.index].firstUsePassIndex == invalidRenderGraphIndex);
+
+    //FK: Transient resources get an aliasing barrier and a discard at their first use.
+    //    GBuffer RT->SRV before ambient occlusion, AO RT->SRV and back buffer PRESENT->RT before lighting
+    CHECK(renderGraph.pPasses[gbufferPass.index].barrierCount == 2u);
+    CHECK(renderGraph.pPasses[ambientOcclusionPass.index].barrierCount == 3u);
+    CHECK(renderGraph.pPasses[lightingPass.index].barrierCount == 2u);
+
+    const render_graph_barrier_t* pGBufferBarrier = renderGraph.pBarriers + renderGraph.pPasses[ambientOcclusionPass.index].firstBarrierIndex;
+    CHECK(pGBufferBarrier->resourceIndex == gbuffer.index);
+    CHECK(pGBufferBarrier->stateBefore == D3D12_RESOURCE_STATE_RENDER_TARGET);
+    CHECK(pGBufferBarrier->stateAfter == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+    //FK: Back buffer goes back to present, transient resources back to their initial state
+    CHECK(renderGraph.finalBarrierCount == 3u);
+    CHECK(renderGraph.statistics.transitionBarrierCount == 6u);
+
+    //FK: Lifetimes of GBuffer and AO overlap
+    CHECK(!renderGraph.pResources[gbuffer.index].isAliased && !renderGraph.pResources[ambientOcclusion.index].isAliased);
+    CHECK(renderGraph.statistics.aliasingBarrierCount == 2u);
+    CHECK(renderGraph.statistics.discardCount == 2u);
+    CHECK(renderGraph.statistics.transientHeapSizeInBytes == 2u * allocationInfo.SizeInBytes);
+
+    destroyRenderGraph(&renderGraph);
+}
+
+void testRenderGraphAliasing()
+{
+    memory_allocator_t defaultAllocator = {};
+    createDefaultMemoryAllocator(&defaultAllocator);
+
+    render_graph_parameters_t parameters = {16u, 16u, 64u};
+    render_graph_t renderGraph = {};
+    CHECK(createRenderGraph(&renderGraph, &defaultAllocator, &parameters));
+
+    //FK: Same graph twice to make sure resetting works
+    for(uint32_t iteration = 0u; iteration < 2u; ++iteration)
+    {
+        resetRenderGraph(&renderGraph);
+
+        d3d12_resource_t backBuffer = {(ID3D12Resource*)0x10, D3D12_RESOURCE_STATE_PRESENT};
+        const D3D12_RESOURCE_DESC desc = createTestRenderTargetDesc(1280u, 720u);
+        const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = {65536u * 3u, 65536u};
+        const D3D12_RESOURCE_ALLOCATION_INFO smallAllocationInfo = {65536u, 65536u};
+
+        const render_graph_resource_handle_t backBufferHandle = importRenderGraphResource(&renderGraph, "Back Buffer", &backBuffer, D3D12_RESOURCE_STATE_PRESENT, true);
+        const render_graph_resource_handle_t first = createRenderGraphTransientResource(&renderGraph, "First", desc, allocationInfo, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        const render_graph_resource_handle_t second = createRenderGraphTransientResource(&renderGraph, "Second", desc, allocationInfo, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        const render_graph_resource_handle_t third = createRenderGraphTransientResource(&renderGraph, "Third", desc, smallAllocationInfo, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        const render_graph_resource_handle_t fourth = createRenderGraphTransientResource(&renderGraph, "Fourth", desc, smallAllocationInfo, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+        //FK: first -> second -> third + fourth -> back buffer
+        const render_graph_pass_handle_t firstPass = addRenderGraphPass(&renderGraph, "First", nullptr, nullptr, nullptr);
+        writeRenderGraphResource(&renderGraph, firstPass, first, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+        const render_graph_pass_handle_t secondPass = addRenderGraphPass(&renderGraph, "Second", nullptr, nullptr, nullptr);
+        readRenderGraphResource(&renderGraph, secondPass, first, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        writeRenderGraphResource(&renderGraph, secondPass, second, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+        const render_graph_pass_handle_t thirdPass = addRenderGraphPass(&renderGraph, "Third", nullptr, nullptr, nullptr);
+        readRenderGraphResource(&renderGraph, thirdPass, second, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        writeRenderGraphResource(&renderGraph, thirdPass, third, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        writeRenderGraphResource(&renderGraph, thirdPass, fourth, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+        const render_graph_pass_handle_t finalPass = addRenderGraphPass(&renderGraph, "Final", nullptr, nullptr, nullptr);
+        readRenderGraphResource(&renderGraph, finalPass, third, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        readRenderGraphResource(&renderGraph, finalPass, fourth, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        writeRenderGraphResource(&renderGraph, finalPass, backBufferHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+        compileRenderGraph(&renderGraph);
+
+        const render_graph_resource_t* pFirst = renderGraph.pResources + first.index;
+        const render_graph_resource_t* pSecond = renderGraph.pResources + second.index;
+        const render_graph_resource_t* pThird = renderGraph.pResources + third.index;
+        const render_graph_resource_t* pFourth = renderGraph.pResources + fourth.index;
+        CHECK(!pFirst->isAliased && !pSecond->isAliased);
+        CHECK(pFirst->heapOffsetInBytes != pSecond->heapOffsetInBytes);
+
+        //FK: The first resource is done after the second pass, third and fourth both fit into its memory
+        CHECK(pThird->isAliased && pFourth->isAliased);
+        CHECK(pThird->aliasedResourceIndex == first.index && pFourth->aliasedResourceIndex == first.index);
+        CHECK(pFirst->isAliasedAway && !pSecond->isAliasedAway);
+        CHECK(pThird->heapOffsetInBytes >= pFirst->heapOffsetInBytes && pThird->heapOffsetInBytes < pFirst->heapOffsetInBytes + allocationInfo.SizeInBytes);
+        CHECK(pFourth->heapOffsetInBytes >= pFirst->heapOffsetInBytes && pFourth->heapOffsetInBytes < pFirst->heapOffsetInBytes + allocationInfo.SizeInBytes);
+        CHECK(pThird->heapOffsetInBytes != pFourth->heapOffsetInBytes);
+
+        CHECK(renderGraph.statistics.culledPassCount == 0u);
+        CHECK(renderGraph.statistics.aliasingBarrierCount == 4u);
+        CHECK(renderGraph.statistics.transientResourceSizeInBytes == 2u * allocationInfo.SizeInBytes + 2u * smallAllocationInfo.SizeInBytes);
+        CHECK(renderGraph.statistics.transientHeapSizeInBytes == 2u * allocationInfo.SizeInBytes);
+
+        //FK: The first resource goes back to its initial state before the aliasing barriers deactivate it,
+        //    discards come after all barriers of the pass
+        const render_graph_barrier_t* pThirdPassBarriers = renderGraph.pBarriers + renderGraph.pPasses[thirdPass.index].firstBarrierIndex;
+        CHECK(renderGraph.pPasses[thirdPass.index].barrierCount == 6u);
+        CHECK(pThirdPassBarriers[0].type == render_graph_barrier_transition && pThirdPassBarriers[0].resourceIndex == second.index);
+        CHECK(pThirdPassBarriers[1].type == render_graph_barrier_transition && pThirdPassBarriers[1].resourceIndex == first.index);
+        CHECK(pThirdPassBarriers[1].stateBefore == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE && pThirdPassBarriers[1].stateAfter == D3D12_RESOURCE_STATE_RENDER_TARGET);
+        CHECK(pThirdPassBarriers[2].type == render_graph_barrier_aliasing && pThirdPassBarriers[2].resourceIndex == third.index);
+        CHECK(pThirdPassBarriers[3].type == render_graph_barrier_aliasing && pThirdPassBarriers[3].resourceIndex == fourth.index);
+        CHECK(pThirdPassBarriers[4].type == render_graph_barrier_discard && pThirdPassBarriers[4].resourceIndex == third.index);
+        CHECK(pThirdPassBarriers[5].type == render_graph_barrier_discard && pThirdPassBarriers[5].resourceIndex == fourth.index);
+
+        //FK: No final transition for the first resource, it's inactive once it got aliased away
+        CHECK(renderGraph.finalBarrierCount == 4u);
+        for(uint32_t barrierIndex = 0u; barrierIndex < renderGraph.finalBarrierCount; ++barrierIndex)
+        {
+            CHECK(renderGraph.pBarriers[renderGraph.firstFinalBarrierIndex + barrierIndex].resourceIndex != first.index);
+        }
+    }
+
+    destroyRenderGraph(&renderGraph);
+}
+
+void testRenderGraphUnorderedAccess()
+{
+    memory_allocator_t defaultAllocator = {};
+    createDefaultMemoryAllocator(&defaultAllocator);
+
+    render_graph_parameters_t parameters = {16u, 16u, 64u};
+    render_graph_t renderGraph = {};
+    CHECK(createRenderGraph(&renderGraph, &defaultAllocator, &parameters));
+
+    d3d12_resource_t backBuffer = {(ID3D12Resource*)0x10, D3D12_RESOURCE_STATE_PRESENT};
+    d3d12_resource_t particles = {(ID3D12Resource*)0x20, D3D12_RESOURCE_STATE_UNORDERED_ACCESS};
+
+    const render_graph_resource_handle_t backBufferHandle = importRenderGraphResource(&renderGraph, "Back Buffer", &backBuffer, D3D12_RESOURCE_STATE_PRESENT, true);
+    const render_graph_resource_handle_t particleHandle = importRenderGraphResource(&renderGraph, "Particles", &particles, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, false);
+
+    //FK: Both simulation passes read and write, the second one needs to wait for the first one
+    const render_graph_pass_handle_t emitPass = addRenderGraphPass(&renderGraph, "Emit", nullptr, nullptr, nullptr);
+    readRenderGraphResource(&renderGraph, emitPass, particleHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    writeRenderGraphResource(&renderGraph, emitPass, particleHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+    const render_graph_pass_handle_t simulatePass = addRenderGraphPass(&renderGraph, "Simulate", nullptr, nullptr, nullptr);
+    readRenderGraphResource(&renderGraph, simulatePass, particleHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    writeRenderGraphResource(&renderGraph, simulatePass, particleHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+    const render_graph_pass_handle_t drawPass = addRenderGraphPass(&renderGraph, "Draw", nullptr, nullptr, nullptr);
+    readRenderGraphResource(&renderGraph, drawPass, particleHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    writeRenderGraphResource(&renderGraph, drawPass, backBufferHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    compileRenderGraph(&renderGraph);
+
+    CHECK(renderGraph.statistics.culledPassCount == 0u);
+    CHECK(renderGraph.pPasses[emitPass.index].barrierCount == 0u);
+    CHECK(renderGraph.pPasses[simulatePass.index].barrierCount == 1u);
+    CHECK(renderGraph.pBarriers[renderGraph.pPasses[simulatePass.index].firstBarrierIndex].type == render_graph_barrier_unordered_access);
+    CHECK(renderGraph.statistics.unorderedAccessBarrierCount == 1u);
+
+    //FK: Particles NON_PIXEL->UAV and back buffer RT->PRESENT
+    CHECK(renderGraph.finalBarrierCount == 2u);
+
+    destroyRenderGraph(&renderGraph);
+}
+
+//FK: Starts with values that hit the special cases of the conversions, the rest is pseudo random in [-range, range]
+void fillVertexPackingTestValues(float* pValues, const uint32_t count, const float range)
+{
+    const float specialValues[] = {0.0f, -0.0f, 1.0f, -1.0f, 0.5f, -0.5f, 2.0f, -2.0f, 1.0f / 254.0f, 1.0f / 510.0f, 65504.0f, 65520.0f, -65536.0f, 
+        1e-8f, 5.9604645e-8f, 6.1035156e-5f, 6.1005e-5f, 1.00048828125f, 1.00146484375f, 1e30f, std::numeric_limits<float>::infinity(), 
+        -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN(), -std::numeric_limits<float>::quiet_NaN()};
+
+    uint32_t state = 0x12345678u;
+    for(uint32_t index = 0u; index < count; ++index)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        const float randomValue = ((float)(state >> 8) / (float)(1u << 24)) * 2.0f - 1.0f;
+        pValues[index] = index < sizeof(specialValues) / sizeof(specialValues[0]) ? specialValues[index] : randomValue * range;
+    }
+}
+
+void decodeOctahedralNormal(const float* pEncodedNormal, float* pOutNormal)
+{
+    float x = pEncodedNormal[0];
+    float y = pEncodedNormal[1];
+    const float z = 1.0f - fabsf(x) - fabsf(y);
+    if(z < 0.0f)
+    {
+        const float foldedX = copysignf(1.0f - fabsf(y), x);
+        const float foldedY = copysignf(1.0f - fabsf(x), y);
+        x = foldedX;
+        y = foldedY;
+    }
+
+    const float length = sqrtf(x * x + y * y + z * z);
+    pOutNormal[0] = x / length;
+    pOutNormal[1] = y / length;
+    pOutNormal[2] = z / length;
+}
+
+float calculateOctahedralRoundTripMinDot(const vertex_attribute_type_t attributeType, const float* pNormals, const uint32_t normalCount)
+{
+    const vertex_attribute_entry_t attribute = {vertex_attribute_t::position, attributeType, 3u};
+    const float scale = attributeType == vertex_attribute_type_t::octahedral8 ? 127.0f : 32767.0f;
+
+    uint8_t packedNormal[4] = {};
+    float minDot = 1.0f;
+    for(uint32_t normalIndex = 0u; normalIndex < normalCount; ++normalIndex)
+    {
+        const float* pNormal = pNormals + normalIndex * 3u;
+        packVertexAttribute(&attribute, pNormal, 1u, packedNormal, getVertexAttributeSizeInBytes(&attribute));
+
+        float encodedNormal[2] = {};
+        if(attributeType == vertex_attribute_type_t::octahedral8)
+        {
+            encodedNormal[0] = (float)(int8_t)packedNormal[0] / scale;
+            encodedNormal[1] = (float)(int8_t)packedNormal[1] / scale;
+        }
+        else
+        {
+            int16_t packedComponents[2] = {};
+            memcpy(packedComponents, packedNormal, sizeof(packedComponents));
+            encodedNormal[0] = (float)packedComponents[0] / scale;
+            encodedNormal[1] = (float)packedComponents[1] / scale;
+        }
+
+        float decodedNormal[3] = {};
+        decodeOctahedralNormal(encodedNormal, decodedNormal);
+
+        const float length = sqrtf(pNormal[0] * pNormal[0] + pNormal[1] * pNormal[1] + pNormal[2] * pNormal[2]);
+        const float dot = (pNormal[0] * decodedNormal[0] + pNormal[1] * decodedNormal[1] + pNormal[2] * decodedNormal[2]) / length;
+        minDot = dot < minDot ? dot : minDot;
+    }
+
+    return minDot;
+}
+
+void testVertexAttributePacking()
+{
+    const vertex_attribute_entry_t float16x3        = {vertex_attribute_t::position, vertex_attribute_type_t::float16, 3u};
+    const vertex_attribute_entry_t unorm8x4         = {vertex_attribute_t::color, vertex_attribute_type_t::unorm8, 4u};
+    const vertex_attribute_entry_t rgb10a2x3        = {vertex_attribute_t::color, vertex_attribute_type_t::rgb10a2, 3u};
+    const vertex_attribute_entry_t octahedral16x3   = {vertex_attribute_t::position, vertex_attribute_type_t::octahedral16, 3u};
+    const vertex_attribute_entry_t octahedral8x2    = {vertex_attribute_t::position, vertex_attribute_type_t::octahedral8, 2u};
+    const vertex_attribute_entry_t rgb10a2x2        = {vertex_attribute_t::color, vertex_attribute_type_t::rgb10a2, 2u};
+    CHECK(getVertexAttributeSizeInBytes(&float16x3) == 8u);
+    CHECK(getVertexAttributeSizeInBytes(&unorm8x4) == 4u);
+    CHECK(getVertexAttributeSizeInBytes(&rgb10a2x3) == 4u);
+    CHECK(getVertexAttributeSizeInBytes(&octahedral16x3) == 4u);
+    CHECK(getVertexAttributeFormat(float16x3.type, float16x3.count) == DXGI_FORMAT_R16G16B16A16_FLOAT);
+    CHECK(getVertexAttributeFormat(octahedral16x3.type, octahedral16x3.count) == DXGI_FORMAT_R16G16_SNORM);
+    CHECK(isValidVertexAttribute(&octahedral16x3));
+    CHECK(!isValidVertexAttribute(&octahedral8x2));
+    CHECK(!isValidVertexAttribute(&rgb10a2x2));
+
+    CHECK(convertFloat32ToFloat16(1.0f) == 0x3C00u);
+    CHECK(convertFloat32ToFloat16(-2.0f) == 0xC000u);
+    CHECK(convertFloat32ToFloat16(65504.0f) == 0x7BFFu);
+    CHECK(convertFloat32ToFloat16(65520.0f) == 0x7C00u);
+    CHECK(convertFloat32ToFloat16(5.9604645e-8f) == 0x0001u);
+    CHECK(convertFloat32ToNormalized(0.5f, 0.0f, 255.0f) == 128);
+    CHECK(convertFloat32ToNormalized(-1.0f, -1.0f, 127.0f) == -127);
+    CHECK(convertFloat32ToNormalized(std::numeric_limits<float>::quiet_NaN(), -1.0f, 127.0f) == 0);
+    const float opaqueWhite[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    CHECK(convertFloat32ToRgb10a2(opaqueWhite) == 0xFFFFFFFFu);
+
+    //FK: Every SIMD level has to produce the same bits as the scalar kernels. Odd counts exercise the tail handling.
+    const uint32_t valueCount = 1027u;
+    float* pValues = (float*)malloc(sizeof(float) * valueCount * 4u);
+    fillVertexPackingTestValues(pValues, valueCount * 4u, 1.5f);
+
+    uint8_t* pReference = (uint8_t*)malloc(sizeof(float) * valueCount * 4u);
+    uint8_t* pResult = (uint8_t*)malloc(sizeof(float) * valueCount * 4u);
+
+    const simd_level_t supportedSimdLevel = getSupportedSimdLevel();
+    for(uint32_t simdLevel = simd_level_sse2; simdLevel <= supportedSimdLevel; ++simdLevel)
+    {
+        packFloat32ToFloat16Scalar(pValues, (uint16_t*)pReference, valueCount);
+        packFloat32ToFloat16(pValues, (uint16_t*)pResult, valueCount, (simd_level_t)simdLevel);
+        bool isSameFloat16 = true;
+        for(uint32_t index = 0u; index < valueCount; ++index)
+        {
+            const uint16_t referenceBits = ((uint16_t*)pReference)[index];
+            const uint16_t resultBits = ((uint16_t*)pResult)[index];
+
+            //FK: F16C keeps the NaN payload, so only check that NaN stays NaN
+            const bool isReferenceNan = (referenceBits & 0x7C00u) == 0x7C00u && (referenceBits & 0x03FFu) != 0u;
+            const bool isResultNan = (resultBits & 0x7C00u) == 0x7C00u && (resultBits & 0x03FFu) != 0u;
+            isSameFloat16 &= isReferenceNan ? isResultNan : referenceBits == resultBits;
+        }
+        CHECK(isSameFloat16);
+
+        packFloat32ToSnorm8Scalar(pValues, (int8_t*)pReference, valueCount);
+        packFloat32ToSnorm8(pValues, (int8_t*)pResult, valueCount, (simd_level_t)simdLevel);
+        CHECK(memcmp(pReference, pResult, valueCount) == 0);
+
+        packFloat32ToUnorm8Scalar(pValues, pReference, valueCount);
+        packFloat32ToUnorm8(pValues, pResult, valueCount, (simd_level_t)simdLevel);
+        CHECK(memcmp(pReference, pResult, valueCount) == 0);
+
+        packFloat32ToSnorm16Scalar(pValues, (int16_t*)pReference, valueCount);
+        packFloat32ToSnorm16(pValues, (int16_t*)pResult, valueCount, (simd_level_t)simdLevel);
+        CHECK(memcmp(pReference, pResult, valueCount * sizeof(int16_t)) == 0);
+
+        packFloat32ToRgb10a2Scalar(pValues, (uint32_t*)pReference, valueCount);
+        packFloat32ToRgb10a2(pValues, (uint32_t*)pResult, valueCount, (simd_level_t)simdLevel);
+        CHECK(memcmp(pReference, pResult, valueCount * sizeof(uint32_t)) == 0);
+
+        encodeOctahedralNormalsScalar(pValues, (float*)pReference, valueCount);
+        encodeOctahedralNormals(pValues, (float*)pResult, valueCount, (simd_level_t)simdLevel);
+        CHECK(memcmp(pReference, pResult, valueCount * sizeof(float) * 2u) == 0);
+    }
+
+    //FK: Straight down lands in the corners of the octahedral map
+    const float downNormal[3] = {0.0f, 0.0f, -1.0f};
+    int16_t packedDownNormal[2] = {};
+    packVertexAttribute(&octahedral16x3, downNormal, 1u, packedDownNormal, sizeof(packedDownNormal));
+    CHECK(packedDownNormal[0] == 32767 && packedDownNormal[1] == 32767);
+
+    float* pNormals = (float*)malloc(sizeof(float) * valueCount * 3u);
+    fillVertexPackingTestValues(pNormals, valueCount * 3u, 1.0f);
+    for(uint32_t normalIndex = 0u; normalIndex < valueCount; ++normalIndex)
+    {
+        //FK: Skip the special values, they don't form meaningful normals
+        float* pNormal = pNormals + normalIndex * 3u;
+        if(normalIndex < 8u || fabsf(pNormal[0]) + fabsf(pNormal[1]) + fabsf(pNormal[2]) < 0.01f)
+        {
+            pNormal[0] = 0.0f;
+            pNormal[1] = 1.0f;
+            pNormal[2] = 0.0f;
+        }
+    }
+
+    CHECK(calculateOctahedralRoundTripMinDot(vertex_attribute_type_t::octahedral8, pNormals, valueCount) > 0.999f);
+    CHECK(calculateOctahedralRoundTripMinDot(vertex_attribute_type_t::octahedral16, pNormals, valueCount) > 0.99999f);
+
+    //FK: Interleaved position float16x3 (padded to 4) + color unorm8x4
+    const vertex_attribute_entry_t vertexAttributes[] = {float16x3, unorm8x4};
+    vertex_format_t vertexFormat;
+    initVertexFormat(&vertexFormat, vertexAttributes, 2u);
+    CHECK(vertexFormat.strideInBytes == 12u);
+
+    const float positions[2 * 3] = {1.0f, -2.0f, 0.5f, 0.0f, 65504.0f, -0.0f};
+    const float colors[2 * 4] = {1.0f, 0.0f, 0.5f, 1.0f, 0.25f, 2.0f, -1.0f, 0.0f};
+    const float* ppAttributeSources[] = {positions, colors};
+    uint8_t vertices[2 * 12] = {};
+    packVertices(&vertexFormat, ppAttributeSources, 2u, vertices);
+
+    uint16_t packedPositions[2][4] = {};
+    memcpy(packedPositions[0], vertices, 8u);
+    memcpy(packedPositions[1], vertices + 12u, 8u);
+    CHECK(packedPositions[0][0] == 0x3C00u && packedPositions[0][1] == 0xC000u && packedPositions[0][2] == 0x3800u && packedPositions[0][3] == 0u);
+    CHECK(packedPositions[1][0] == 0u && packedPositions[1][1] == 0x7BFFu && packedPositions[1][2] == 0x8000u && packedPositions[1][3] == 0u);
+    CHECK(vertices[8] == 255u && vertices[9] == 0u && vertices[10] == 128u && vertices[11] == 255u);
+    CHECK(vertices[20] == 64u && vertices[21] == 255u && vertices[22] == 0u && vertices[23] == 0u);
+
+    free(pNormals);
+    free(pResult);
+    free(pReference);
+    free(pValues);
+}
+
+void simulateFrameTempAllocations(memory_allocator_t* pAllocator, void** ppAllocations, const uint32_t allocationCount, const bool freeAllocations)
+{
+    for(uint32_t allocationIndex = 0u; allocationIndex < allocationCount; ++allocationIndex)
+    {
+        //FK: Mix of small argument strings and larger file buffers like during shader compilation
+        const uint64_t sizeInBytes = (allocationIndex % 8u == 0u) ? 4096u : 16u + (allocationIndex % 7u) * 24u;
+        ppAllocations[allocationIndex] = allocateFromAllocator(pAllocator, sizeInBytes);
+    }
+
+    if(freeAllocations)
+    {
+        for(uint32_t allocationIndex = 0u; allocationIndex < allocationCount; ++allocationIndex)
+        {
+            freeFromAllocator(pAllocator, ppAllocations[allocationIndex]);
+        }
+    }
+}
+
+void benchmarkFrameTempAllocator()
+{
+    const uint32_t frameCount = 10000u;
+    const uint32_t allocationsPerFrame = 64u;
+    void* ppAllocations[allocationsPerFrame] = {};
+
+    memory_allocator_t defaultAllocator = {};
+    createDefaultMemoryAllocator(&defaultAllocator);
+
+    benchmark_timer_t timer;
+    startBenchmarkTimer(&timer);
+    for(uint32_t frameIndex = 0u; frameIndex < frameCount; ++frameIndex)
+    {
+        simulateFrameTempAllocations(&defaultAllocator, ppAllocations, allocationsPerFrame, true);
+    }
+    printBenchmarkResult("frame temp allocations (default allocator)", stopBenchmarkTimerInMilliseconds(&timer), frameCount * allocationsPerFrame);
+
+    linear_memory_allocator_t linearAllocator = {};
+    createLinearMemoryAllocator(&linearAllocator, &defaultAllocator, 1024u * 1024u);
+
+    startBenchmarkTimer(&timer);
+    for(uint32_t frameIndex = 0u; frameIndex < frameCount; ++frameIndex)
+    {
+        resetAllocator(&linearAllocator);
+        simulateFrameTempAllocations(&linearAllocator, ppAllocations, allocationsPerFrame, true);
+    }
+    printBenchmarkResult("frame temp allocations (linear allocator)", stopBenchmarkTimerInMilliseconds(&timer), frameCount * allocationsPerFrame);
+    printf("    linear allocator frame high water mark: %llu bytes\n", (unsigned long long)linearAllocator.frameHighWaterMarkInBytes);
+
+    destroyLinearMemoryAllocator(&linearAllocator);
+}
+
+//FK: Chains of passes where every pass reads the output of the previous pass of its chain.
+//    Every 8th chain ends in a resource nobody reads and gets culled, the others feed into the final pass.
+void declareSyntheticRenderGraph(render_graph_t* pRenderGraph, d3d12_resource_t* pBackBuffer, const uint32_t chainCount, const uint32_t passesPerChain)
+{
+    const D3D12_RESOURCE_DESC desc = createTestRenderTargetDesc(1920u, 1080u);
+    const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = {8u * 1024u * 1024u, 65536u};
+
+    resetRenderGraph(pRenderGraph);
+    const render_graph_resource_handle_t backBufferHandle = importRenderGraphResource(pRenderGraph, "Back Buffer", pBackBuffer, D3D12_RESOURCE_STATE_PRESENT, true);
+
+    render_graph_resource_handle_t chainOutputs[64];
+    ASSERT_ALWAYS(chainCount <= 64u);
+
+    for(uint32_t chainIndex = 0u; chainIndex < chainCount; ++chainIndex)
+    {
+        render_graph_resource_handle_t previousOutput = {invalidResourceHandleValue};
+        for(uint32_t passIndex = 0u; passIndex < passesPerChain; ++passIndex)
+        {
+            const render_graph_resource_handle_t output = createRenderGraphTransientResource(pRenderGraph, "Synthetic Target", desc, allocationInfo, D3D12_RESOURCE_STATE_RENDER_TARGET);
+            const render_graph_pass_handle_t pass = addRenderGraphPass(pRenderGraph, "Synthetic Pass", nullptr, nullptr, nullptr);
+            if(!isInvalidResourceHandle(previousOutput))
+            {
+                readRenderGraphResource(pRenderGraph, pass, previousOutput, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+            }
+
+            writeRenderGraphResource(pRenderGraph, pass, output, D3D12_RESOURCE_STATE_RENDER_TARGET);
+            previousOutput = output;
+        }
+
+        chainOutputs[chainIndex] = previousOutput;
+    }
+
+    const render_graph_pass_handle_t finalPass = addRenderGraphPass(pRenderGraph, "Final", nullptr, nullptr, nullptr);
+    for(uint32_t chainIndex = 0u; chainIndex < chainCount; ++chainIndex)
+    {
+        if(chainIndex % 8u != 7u)
+        {
+            readRenderGraphResource(pRenderGraph, finalPass, chainOutputs[chainIndex], D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        }
+    }
+
+    writeRenderGraphResource(pRenderGraph, finalPass, backBufferHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+}
+
+void benchmarkRenderGraphCompilation()
+{
+    const uint32_t frameCount = 1000u;
+    const uint32_t chainCount = 32u;
+    const uint32_t passesPerChain = 16u;
+    const uint32_t passCount = chainCount * passesPerChain + 1u;
+
+    memory_allocator_t defaultAllocator = {};
+    createDefaultMemoryAllocator(&defaultAllocator);
+
+    render_graph_parameters_t parameters = {passCount, passCount + 1u, passCount * 2u + chainCount};
+    render_graph_t renderGraph = {};
+    createRenderGraph(&renderGraph, &defaultAllocator, &parameters);
+
+    d3d12_resource_t backBuffer = {(ID3D12Resource*)0x10, D3D12_RESOURCE_STATE_PRESENT};
+
+    benchmark_timer_t timer;
+    startBenchmarkTimer(&timer);
+    for(uint32_t frameIndex = 0u; frameIndex < frameCount; ++frameIndex)
+    {
+        declareSyntheticRenderGraph(&renderGraph, &backBuffer, chainCount, passesPerChain);
+    }
+    const double declarationTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+
+    startBenchmarkTimer(&timer);
+    for(uint32_t frameIndex = 0u; frameIndex < frameCount; ++frameIndex)
+    {
+        declareSyntheticRenderGraph(&renderGraph, &backBuffer, chainCount, passesPerChain);
+        compileRenderGraph(&renderGraph);
+    }
+    const double compilationTimeInMs = stopBenchmarkTimerInMilliseconds(&timer) - declarationTimeInMs;
+
+    printBenchmarkResult("render graph declaration (513 passes)", declarationTimeInMs, frameCount);
+    printBenchmarkResult("render graph compilation (513 passes)", compilationTimeInMs, frameCount);
+    printf("    culled passes: %u, transitions: %u, aliasing barriers: %u, transient memory: %lluMiB -> %lluMiB heap\n", 
+        renderGraph.statistics.culledPassCount, renderGraph.statistics.transitionBarrierCount, renderGraph.statistics.aliasingBarrierCount,
+        (unsigned long long)(renderGraph.statistics.transientResourceSizeInBytes / (1024u * 1024u)), (unsigned long long)(renderGraph.statistics.transientHeapSizeInBytes / (1024u * 1024u)));
+
+    CHECK(renderGraph.statistics.culledPassCount == (chainCount / 8u) * passesPerChain);
+
+    destroyRenderGraph(&renderGraph);
+}
+
+void benchmarkVertexAttributePacking()
+{
+    const uint32_t vertexCount = 1024u * 1024u;
+    float* pSource = (float*)malloc(sizeof(float) * vertexCount * 4u);
+    fillVertexPackingTestValues(pSource, vertexCount * 4u, 1.0f);
+    void* pDestination = malloc(sizeof(float) * vertexCount * 4u);
+
+    const vertex_attribute_entry_t attributes[] = {
+        {vertex_attribute_t::position,  vertex_attribute_type_t::float16,       4u},
+        {vertex_attribute_t::color,     vertex_attribute_type_t::unorm8,        4u},
+        {vertex_attribute_t::color,     vertex_attribute_type_t::snorm8,        4u},
+        {vertex_attribute_t::position,  vertex_attribute_type_t::snorm16,       4u},
+        {vertex_attribute_t::color,     vertex_attribute_type_t::rgb10a2,       4u},
+        {vertex_attribute_t::position,  vertex_attribute_type_t::octahedral16,  3u}
+    };
+    const char* pAttributeNames[] = {"float16x4", "unorm8x4", "snorm8x4", "snorm16x4", "rgb10a2", "octahedral16"};
+    const char* pSimdLevelNames[] = {"scalar", "sse2", "avx2"};
+
+    const simd_level_t supportedSimdLevel = getSupportedSimdLevel();
+    for(uint32_t attributeIndex = 0u; attributeIndex < sizeof(attributes) / sizeof(attributes[0]); ++attributeIndex)
+    {
+        const vertex_attribute_entry_t* pAttribute = attributes + attributeIndex;
+
+        //FK: Warm up so that the first timed run doesn't pay for the page faults of the destination
+        packVertexAttribute(pAttribute, pSource, vertexCount, pDestination, getVertexAttributeSizeInBytes(pAttribute));
+        for(uint32_t simdLevel = simd_level_scalar; simdLevel <= supportedSimdLevel; ++simdLevel)
+        {
+            benchmark_timer_t timer;
+            startBenchmarkTimer(&timer);
+            packVertexAttribute(pAttribute, pSource, vertexCount, pDestination, getVertexAttributeSizeInBytes(pAttribute), (simd_level_t)simdLevel);
+
+            char benchmarkName[64];
+            snprintf(benchmarkName, sizeof(benchmarkName), "vertex packing %s (%s, 1M vertices)", pAttributeNames[attributeIndex], pSimdLevelNames[simdLevel]);
+            printBenchmarkResult(benchmarkName, stopBenchmarkTimerInMilliseconds(&timer), vertexCount);
+        }
+    }
+
+    const vertex_attribute_entry_t uncompressedAttributes[] = {{vertex_attribute_t::position, vertex_attribute_type_t::float32, 3u}, {vertex_attribute_t::color, vertex_attribute_type_t::float32, 4u}};
+    const vertex_attribute_entry_t compressedAttributes[] = {{vertex_attribute_t::position, vertex_attribute_type_t::float16, 3u}, {vertex_attribute_t::color, vertex_attribute_type_t::unorm8, 4u}};
+    vertex_format_t uncompressedFormat;
+    vertex_format_t compressedFormat;
+    initVertexFormat(&uncompressedFormat, uncompressedAttributes, 2u);
+    initVertexFormat(&compressedFormat, compressedAttributes, 2u);
+    printf("    position + color vertex size: %u bytes (float32) -> %u bytes (float16 + unorm8)\n", uncompressedFormat.strideInBytes, compressedFormat.strideInBytes);
+
+    free(pDestination);
+    free(pSource);
+}
+
+#if USE_NULL_DEVICE
+bool createNullDeviceRenderContext(render_context_t* pRenderContext, const uint32_t frameBufferCount)
+{
+    render_context_parameters_t parameters = createDefaultRenderContextParameters(nullptr, frameBufferCount, 1280u, 720u, false);
+
+    //FK: Render passes only return to the free list once their frame is done, so this has to cover all frames in flight
+    parameters.limits.maxRenderPassCount = 64u;
+    return createRenderContext(pRenderContext, &parameters);
+}
+
+void renderNullDeviceFrame(render_context_t* pRenderContext, const uint32_t renderPassCount, const uint32_t drawCallCount)
+{
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(pRenderContext);
+    for(uint32_t renderPassIndex = 0u; renderPassIndex < renderPassCount; ++renderPassIndex)
+    {
+        render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, "Null Device Pass", nullptr);
+        clearColorRenderTarget(pRenderPass, pGraphicsFrame->pBackBuffer, 0.2f, 0.2f, 0.2f, 1.0f);
+        for(uint32_t drawCallIndex = 0u; drawCallIndex < drawCallCount; ++drawCallIndex)
+        {
+            drawInstanced(pRenderPass, 3u, 1u, 0u, 0u);
+        }
+        endRenderPass(pGraphicsFrame, pRenderPass);
+        executeRenderPass(pGraphicsFrame, pRenderPass);
+    }
+    finishFrame(pRenderContext, pGraphicsFrame);
+}
+
+void testNullDeviceFrameLoop()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 3u));
+
+    const uint32_t frameCount = 10u;
+    for(uint32_t frameIndex = 0u; frameIndex < frameCount; ++frameIndex)
+    {
+        renderNullDeviceFrame(&renderContext, 4u, 8u);
+    }
+
+    //FK: All passes plus the present transition get submitted with one call per frame
+    const null_device_statistics_t* pStatistics = getNullDeviceStatistics(renderContext.pDevice);
+    CHECK(pStatistics->presentCount == frameCount);
+    CHECK(pStatistics->clearCount == frameCount * 4u);
+    CHECK(pStatistics->drawCallCount == frameCount * 4u * 8u);
+    CHECK(pStatistics->executeCallCount == frameCount);
+    CHECK(pStatistics->executedCommandListCount == frameCount * 5u);
+
+    //FK: Frames get reused round robin, so the first frame has to be done once the fourth frame begins
+    const graphics_frame_t* pFirstFrame = getGraphicsFrameFromGraphicsFrameCollection(&renderContext.graphicsFramesCollection, 1u);
+    CHECK(pFirstFrame->pFrameFence->GetCompletedValue() >= 1u);
+
+    shutdownRenderContext(&renderContext);
+}
+
+void recordSubmitThresholdTestPass(render_pass_t* pRenderPass, void* pUserData)
+{
+    *(render_pass_t**)pUserData = pRenderPass;
+    clearColorRenderTarget(pRenderPass, pRenderPass->pRenderTarget, 0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+bool areRenderPassesExecutedInOrder(render_pass_t* const* ppRenderPasses, const uint32_t renderPassCount)
+{
+    for(uint32_t renderPassIndex = 1u; renderPassIndex < renderPassCount; ++renderPassIndex)
+    {
+        if(ppRenderPasses[renderPassIndex - 1u]->pGraphicsCommandList->executionIndex >= ppRenderPasses[renderPassIndex]->pGraphicsCommandList->executionIndex)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void testRenderPassSubmitThreshold()
+{
+    render_context_parameters_t parameters = createDefaultRenderContextParameters(nullptr, 2u, 1280u, 720u, false);
+    parameters.limits.maxRenderPassCount    = 64u;
+    parameters.renderPassSubmitThreshold    = 2u;
+
+    render_context_t renderContext = {};
+    CHECK(createRenderContext(&renderContext, &parameters));
+
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+    const submit_statistics_t* pSubmitStatistics = &pGraphicsFrame->submitStatistics;
+    const uint32_t renderPassCount = 6u;
+    render_pass_t* pRenderPasses[renderPassCount] = {};
+    for(uint32_t renderPassIndex = 0u; renderPassIndex < renderPassCount; ++renderPassIndex)
+    {
+        pRenderPasses[renderPassIndex] = startRenderPass(pGraphicsFrame, "Submit Threshold Pass", nullptr);
+        endRenderPass(pGraphicsFrame, pRenderPasses[renderPassIndex]);
+    }
+
+    //FK: Executed in reverse, the passes 3 and 2 reach the threshold but can't go before the passes 0 and 1
+    executeRenderPass(pGraphicsFrame, pRenderPasses[3]);
+    executeRenderPass(pGraphicsFrame, pRenderPasses[2]);
+    executeRenderPass(pGraphicsFrame, pRenderPasses[1]);
+    CHECK(pSubmitStatistics->submitCallCount == 0u);
+    executeRenderPass(pGraphicsFrame, pRenderPasses[0]);
+    CHECK(pSubmitStatistics->submitCallCount == 1u && pSubmitStatistics->submittedCommandListCount == 4u);
+
+    executeRenderPass(pGraphicsFrame, pRenderPasses[5]);
+    CHECK(pSubmitStatistics->submitCallCount == 1u);
+    executeRenderPass(pGraphicsFrame, pRenderPasses[4]);
+    CHECK(pSubmitStatistics->submitCallCount == 2u && pSubmitStatistics->submittedCommandListCount == renderPassCount);
+    finishFrame(&renderContext, pGraphicsFrame);
+    CHECK(areRenderPassesExecutedInOrder(pRenderPasses, renderPassCount));
+
+    //FK: Passes recorded on the thread pool finish in any order, the submission order still follows the jobs
+    pGraphicsFrame = beginNextFrame(&renderContext);
+    const uint32_t jobCount = 16u;
+    render_pass_t* pJobRenderPasses[jobCount] = {};
+    render_pass_job_t jobs[jobCount] = {};
+    for(uint32_t jobIndex = 0u; jobIndex < jobCount; ++jobIndex)
+    {
+        jobs[jobIndex].pName        = "Submit Threshold Job";
+        jobs[jobIndex].pRecordFnc   = recordSubmitThresholdTestPass;
+        jobs[jobIndex].pUserData    = pJobRenderPasses + jobIndex;
+    }
+
+    recordRenderPassJobs(pGraphicsFrame, jobs, jobCount);
+    finishFrame(&renderContext, pGraphicsFrame);
+    CHECK(areRenderPassesExecutedInOrder(pJobRenderPasses, jobCount));
+
+    shutdownRenderContext(&renderContext);
+}
+
+struct render_graph_execution_test_t
+{
+    render_graph_t*                 pRenderGraph;
+    render_graph_resource_handle_t  first;
+    render_graph_resource_handle_t  second;
+    render_graph_resource_handle_t  third;
+    render_graph_resource_handle_t  backBuffer;
+    uint32_t                        recordedPassCount;
+    uint32_t                        boundPlacedResourceCount;
+};
+
+void recordRenderGraphExecutionTestPass(render_pass_t* pRenderPass, void* pUserData)
+{
+    render_graph_execution_test_t* pTest = (render_graph_execution_test_t*)pUserData;
+    ++pTest->recordedPassCount;
+
+    //FK: The null device stores the resource in the view, so this checks that the pass got the view of its placed resource
+    const ID3D12Resource* pViewResource = *(ID3D12Resource* const*)pRenderPass->pRenderTarget->cpuDescriptorHandle.ptr;
+    if(pRenderPass->pRenderTarget != pTest->pRenderGraph->pResources[pTest->backBuffer.index].pRenderTarget && pViewResource == pRenderPass->pRenderTarget->resource.pResource)
+    {
+        ++pTest->boundPlacedResourceCount;
+    }
+
+    setRenderTarget(pRenderPass, pRenderPass->pRenderTarget);
+    clearColorRenderTarget(pRenderPass, pRenderPass->pRenderTarget, 0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+//FK: first -> second -> third -> back buffer, third is small enough to take over the memory of first
+void declareRenderGraphExecutionTestGraph(render_graph_execution_test_t* pTest, graphics_frame_t* pGraphicsFrame, const uint32_t width = 1280u, const uint32_t height = 720u)
+{
+    render_graph_t* pRenderGraph = pTest->pRenderGraph;
+    const D3D12_RESOURCE_DESC desc = createTestRenderTargetDesc(width, height);
+    const D3D12_RESOURCE_DESC smallDesc = createTestRenderTargetDesc(width / 2u, height / 2u);
+    const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = pGraphicsFrame->pDevice->GetResourceAllocationInfo(0u, 1u, &desc);
+    const D3D12_RESOURCE_ALLOCATION_INFO smallAllocationInfo = pGraphicsFrame->pDevice->GetResourceAllocationInfo(0u, 1u, &smallDesc);
+
+    resetRenderGraph(pRenderGraph);
+    pTest->backBuffer   = importRenderGraphRenderTarget(pRenderGraph, "Back Buffer", pGraphicsFrame->pBackBuffer, D3D12_RESOURCE_STATE_PRESENT, true);
+    pTest->first        = createRenderGraphTransientResource(pRenderGraph, "First", desc, allocationInfo, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    pTest->second       = createRenderGraphTransientResource(pRenderGraph, "Second", desc, allocationInfo, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    pTest->third        = createRenderGraphTransientResource(pRenderGraph, "Third", smallDesc, smallAllocationInfo, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    addRenderGraphPass(pRenderGraph, "First", pTest->first, recordRenderGraphExecutionTestPass, pTest);
+
+    const render_graph_pass_handle_t secondPass = addRenderGraphPass(pRenderGraph, "Second", pTest->second, recordRenderGraphExecutionTestPass, pTest);
+    readRenderGraphResource(pRenderGraph, secondPass, pTest->first, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+    const render_graph_pass_handle_t thirdPass = addRenderGraphPass(pRenderGraph, "Third", pTest->third, recordRenderGraphExecutionTestPass, pTest);
+    readRenderGraphResource(pRenderGraph, thirdPass, pTest->second, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+    const render_graph_pass_handle_t finalPass = addRenderGraphPass(pRenderGraph, "Final", pTest->backBuffer, recordRenderGraphExecutionTestPass, pTest);
+    readRenderGraphResource(pRenderGraph, finalPass, pTest->third, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+    compileRenderGraph(pRenderGraph);
+}
+
+bool isLoggedTransition(const null_resource_command_t* pCommand, const d3d12_resource_t* pResource, const D3D12_RESOURCE_STATES stateBefore, const D3D12_RESOURCE_STATES stateAfter)
+{
+    return pCommand->pDiscardedResource == nullptr && pCommand->barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION &&
+           pCommand->barrier.Transition.pResource == pResource->pResource &&
+           pCommand->barrier.Transition.StateBefore == stateBefore && pCommand->barrier.Transition.StateAfter == stateAfter;
+}
+
+bool isLoggedAliasingBarrier(const null_resource_command_t* pCommand, const d3d12_resource_t* pResource)
+{
+    return pCommand->pDiscardedResource == nullptr && pCommand->barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_ALIASING && pCommand->barrier.Aliasing.pResourceAfter == pResource->pResource;
+}
+
+void testRenderGraphExecution()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 2u));
+
+    memory_allocator_t defaultAllocator = {};
+    createDefaultMemoryAllocator(&defaultAllocator);
+
+    render_graph_parameters_t parameters = {16u, 16u, 64u};
+    render_graph_t renderGraph = {};
+    CHECK(createRenderGraph(&renderGraph, &defaultAllocator, &parameters));
+
+    null_resource_command_t commands[32];
+    null_resource_command_log_t commandLog = {commands, 32u, 0};
+
+    const D3D12_RESOURCE_STATES rt  = D3D12_RESOURCE_STATE_RENDER_TARGET;
+    const D3D12_RESOURCE_STATES srv = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+
+    //FK: The second frame reuses the placed resources, their states need to be where the first frame left them
+    graphics_frame_t* pGraphicsFrame = nullptr;
+    for(uint32_t frameIndex = 0u; frameIndex < 2u; ++frameIndex)
+    {
+        pGraphicsFrame = beginNextFrame(&renderContext);
+
+        render_graph_execution_test_t test = {};
+        test.pRenderGraph = &renderGraph;
+        declareRenderGraphExecutionTestGraph(&test, pGraphicsFrame);
+
+        commandLog.commandCount = 0;
+        setNullResourceCommandLog(&commandLog);
+        CHECK(executeRenderGraph(&renderGraph, pGraphicsFrame));
+        setNullResourceCommandLog(nullptr);
+
+        const d3d12_resource_t* pFirst      = getRenderGraphResource(&renderGraph, test.first);
+        const d3d12_resource_t* pSecond     = getRenderGraphResource(&renderGraph, test.second);
+        const d3d12_resource_t* pThird      = getRenderGraphResource(&renderGraph, test.third);
+        const d3d12_resource_t* pBackBuffer = getRenderGraphResource(&renderGraph, test.backBuffer);
+        CHECK(renderGraph.pResources[test.third.index].aliasedResourceIndex == test.first.index);
+        CHECK(test.recordedPassCount == 4u);
+        CHECK(test.boundPlacedResourceCount == 3u);
+
+        //FK: Every pass flushes its barriers before its discards, the final transitions get issued at the end of the last pass
+        CHECK(commandLog.commandCount == 14);
+        if(commandLog.commandCount == 14)
+        {
+            CHECK(isLoggedAliasingBarrier(commands + 0, pFirst));
+            CHECK(commands[1].pDiscardedResource == pFirst->pResource);
+
+            //FK: Passes write their render target before they read their inputs, barriers follow the order of the accesses
+            CHECK(isLoggedAliasingBarrier(commands + 2, pSecond));
+            CHECK(isLoggedTransition(commands + 3, pFirst, rt, srv));
+            CHECK(commands[4].pDiscardedResource == pSecond->pResource);
+
+            //FK: First goes back to its initial state while it's still active, the aliasing barrier then hands its memory to third
+            CHECK(isLoggedTransition(commands + 5, pFirst, srv, rt));
+            CHECK(isLoggedAliasingBarrier(commands + 6, pThird));
+            CHECK(isLoggedTransition(commands + 7, pSecond, rt, srv));
+            CHECK(commands[8].pDiscardedResource == pThird->pResource);
+
+            CHECK(isLoggedTransition(commands + 9, pBackBuffer, D3D12_RESOURCE_STATE_PRESENT, rt));
+            CHECK(isLoggedTransition(commands + 10, pThird, rt, srv));
+
+            //FK: No final transition of first, it's been aliased away
+            CHECK(isLoggedTransition(commands + 11, pBackBuffer, rt, D3D12_RESOURCE_STATE_PRESENT));
+            CHECK(isLoggedTransition(commands + 12, pSecond, srv, rt));
+            CHECK(isLoggedTransition(commands + 13, pThird, srv, rt));
+        }
+
+        CHECK(pFirst->currentState == rt && pSecond->currentState == rt && pThird->currentState == rt);
+        CHECK(pBackBuffer->currentState == D3D12_RESOURCE_STATE_PRESENT);
+
+        finishFrame(&renderContext, pGraphicsFrame);
+    }
+
+    const null_device_statistics_t* pStatistics = getNullDeviceStatistics(renderContext.pDevice);
+    CHECK(pStatistics->discardCount == 2u * 3u);
+    CHECK(pStatistics->clearCount == 2u * 4u);
+
+    //FK: Frame fences get signaled in order, so the GPU is done with the transient resources once the last frame is done
+    COM_CALL(pGraphicsFrame->pFrameFence->SetEventOnCompletion(pGraphicsFrame->frameIndex, nullptr));
+    destroyRenderGraph(&renderGraph);
+    shutdownRenderContext(&renderContext);
+}
+
+void testRenderGraphHeapGrowth()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 2u));
+
+    //FK: Keeps the previous frame in flight, so its retired objects can't be released yet
+    null_device_cost_model_t costModel = {};
+    costModel.commandListCostInNanoseconds = 20000000u;
+    setNullDeviceCostModel(renderContext.pDevice, &costModel);
+
+    memory_allocator_t defaultAllocator = {};
+    createDefaultMemoryAllocator(&defaultAllocator);
+
+    //FK: Back buffer plus 3 placed resources, growing the heap retires the 3 resources and the heap
+    render_graph_parameters_t parameters = {4u, 4u, 16u};
+    render_graph_t renderGraph = {};
+    CHECK(createRenderGraph(&renderGraph, &defaultAllocator, &parameters));
+    const uint32_t initialMaxRetiredObjectCount = renderGraph.maxRetiredObjectCount;
+
+    //FK: The heap grows in the second and third frame, the third frame retires its objects while the second is still in flight
+    graphics_frame_t* pGraphicsFrame = nullptr;
+    const uint32_t frameSizes[3][2] = {{640u, 360u}, {1280u, 720u}, {2560u, 1440u}};
+    uint64_t previousHeapCapacityInBytes = 0u;
+    for(uint32_t frameIndex = 0u; frameIndex < 3u; ++frameIndex)
+    {
+        pGraphicsFrame = beginNextFrame(&renderContext);
+
+        render_graph_execution_test_t test = {};
+        test.pRenderGraph = &renderGraph;
+        declareRenderGraphExecutionTestGraph(&test, pGraphicsFrame, frameSizes[frameIndex][0], frameSizes[frameIndex][1]);
+        CHECK(executeRenderGraph(&renderGraph, pGraphicsFrame));
+        CHECK(test.boundPlacedResourceCount == 3u);
+        CHECK(renderGraph.transientHeapCapacityInBytes > previousHeapCapacityInBytes);
+        previousHeapCapacityInBytes = renderGraph.transientHeapCapacityInBytes;
+
+        finishFrame(&renderContext, pGraphicsFrame);
+    }
+
+    //FK: Nothing got released early, the objects of both frames are still waiting for their frame fences
+    CHECK(renderGraph.retiredObjectCount == 2u * 4u);
+    CHECK(renderGraph.maxRetiredObjectCount > initialMaxRetiredObjectCount);
+
+    COM_CALL(pGraphicsFrame->pFrameFence->SetEventOnCompletion(pGraphicsFrame->frameIndex, nullptr));
+    releaseRetiredRenderGraphObjects(&renderGraph, false);
+    CHECK(renderGraph.retiredObjectCount == 0u);
+
+    destroyRenderGraph(&renderGraph);
+    shutdownRenderContext(&renderContext);
+}
+
+void benchmarkNullDeviceFrameLoop()
+{
+    const uint32_t frameCount = 1000u;
+    const uint32_t renderPassCount = 16u;
+    const uint32_t drawCallCount = 64u;
+
+    render_context_t renderContext = {};
+    if(!createNullDeviceRenderContext(&renderContext, 3u))
+    {
+        CHECK(false);
+        return;
+    }
+
+    benchmark_timer_t timer;
+    startBenchmarkTimer(&timer);
+    for(uint32_t frameIndex = 0u; frameIndex < frameCount; ++frameIndex)
+    {
+        renderNullDeviceFrame(&renderContext, renderPassCount, drawCallCount);
+    }
+    const double cpuBoundTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+
+    //FK: 10us per draw call makes the simulated GPU the bottleneck, frame time should now be dominated by fence waits
+    null_device_cost_model_t costModel = {};
+    costModel.drawCallCostInNanoseconds = 10000u;
+    setNullDeviceCostModel(renderContext.pDevice, &costModel);
+
+    const uint32_t gpuBoundFrameCount = 20u;
+    startBenchmarkTimer(&timer);
+    for(uint32_t frameIndex = 0u; frameIndex < gpuBoundFrameCount; ++frameIndex)
+    {
+        renderNullDeviceFrame(&renderContext, renderPassCount, drawCallCount);
+    }
+    const double gpuBoundTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+
+    printBenchmarkResult("null device frame (16 passes, 1024 draws)", cpuBoundTimeInMs, frameCount);
+    printBenchmarkResult("null device frame (10us per draw)", gpuBoundTimeInMs, gpuBoundFrameCount);
+
+    //FK: Only the frames in flight can run ahead of the simulated GPU, the rest has to wait for it
+    const double gpuFrameTimeInMs = (double)(renderPassCount * drawCallCount * costModel.drawCallCostInNanoseconds) / 1000000.0;
+    CHECK(gpuBoundTimeInMs >= gpuFrameTimeInMs * (double)(gpuBoundFrameCount / 2u));
+
+    shutdownRenderContext(&renderContext);
+}
+
+void writeTestFile(const char* pFilePath, const char* pContent)
+{
+    FILE* pFileHandle = fopen(pFilePath, "wb");
+    CHECK(pFileHandle != nullptr);
+    if(pFileHandle != nullptr)
+    {
+        fwrite(pContent, 1u, strlen(pContent), pFileHandle);
+        fclose(pFileHandle);
+    }
+}
+
+//FK: Entries of previous runs would turn the expected misses into hits
+void removeShaderCacheEntry(graphics_frame_t* pGraphicsFrame, const shader_compilation_parameters_t* pParameters, char* pOutEntryPath)
+{
+    result_t<memory_buffer_t> shaderSourceResult = readWholeFileIntoNewBuffer(&pGraphicsFrame->tempMemoryAllocator, pParameters->pFilePath);
+    CHECK(isResultSuccessful(shaderSourceResult));
+
+    result_t<dxc_arguments_t> argumentsResult = generateCompilerArgumentsIntoNewBuffer(&pGraphicsFrame->tempMemoryAllocator, pParameters);
+    CHECK(isResultSuccessful(argumentsResult));
+
+    const uint64_t shaderCacheKey = calculateShaderCacheKey(&pGraphicsFrame->tempMemoryAllocator, pGraphicsFrame->pShaderCompilerContext, pParameters, &argumentsResult.value, &shaderSourceResult.value);
+    CHECK(formatShaderCacheEntryPath(pOutEntryPath, maxShaderCachePathLength, pGraphicsFrame->pShaderCompilerContext, shaderCacheKey));
+    remove(pOutEntryPath);
+
+    freeCompilerArguments(&pGraphicsFrame->tempMemoryAllocator, &argumentsResult.value);
+}
+
+void testShaderCache()
+{
+    const char* pShaderCacheDirectory = "cpu_benchmark_shader_cache";
+    CreateDirectoryA(pShaderCacheDirectory, nullptr);
+    writeTestFile("cpu_benchmark_shader_cache/test_shader.hlsl", "#include \"test_include.hlsli\"\nfloat4 main() : SV_Target { return color; }\n");
+    writeTestFile("cpu_benchmark_shader_cache/test_include.hlsli", "static const float4 color = float4(1, 0, 0, 1);\n");
+
+    render_context_parameters_t parameters = createDefaultRenderContextParameters(nullptr, 2u, 1280u, 720u, false);
+    parameters.pShaderCacheDirectory = pShaderCacheDirectory;
+    render_context_t renderContext = {};
+    CHECK(createRenderContext(&renderContext, &parameters));
+
+    const shader_cache_statistics_t* pStatistics = &renderContext.shaderCompilerContext.cacheStatistics;
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+
+    shader_compilation_parameters_t compilationParameters = {};
+    compilationParameters.pEntryPoint       = "main";
+    compilationParameters.pFilePath         = "cpu_benchmark_shader_cache/test_shader.hlsl";
+    compilationParameters.pShaderProfile    = "ps_6_0";
+
+    char entryPath[maxShaderCachePathLength];
+    char variantEntryPath[maxShaderCachePathLength];
+    removeShaderCacheEntry(pGraphicsFrame, &compilationParameters, entryPath);
+
+    const shader_binary_handle_t compiledShader = loadAndCompileShaderCodeFromFile(pGraphicsFrame, &compilationParameters);
+    CHECK(pStatistics->missCount == 1u && pStatistics->hitCount == 0u);
+
+    const shader_binary_handle_t cachedShader = loadAndCompileShaderCodeFromFile(pGraphicsFrame, &compilationParameters);
+    CHECK(pStatistics->missCount == 1u && pStatistics->hitCount == 1u);
+
+    const shader_binary_t* pCompiledShader = getShaderBinary(pGraphicsFrame->pRenderResourceCache, compiledShader);
+    const shader_binary_t* pCachedShader = getShaderBinary(pGraphicsFrame->pRenderResourceCache, cachedShader);
+    CHECK(pCompiledShader != nullptr && pCachedShader != nullptr);
+    if(pCompiledShader != nullptr && pCachedShader != nullptr)
+    {
+        CHECK(pCompiledShader->shaderBlobSizeInBytes == pCachedShader->shaderBlobSizeInBytes);
+        CHECK(memcmp(pCompiledShader->pShaderBlob, pCachedShader->pShaderBlob, pCachedShader->shaderBlobSizeInBytes) == 0);
+        CHECK(pCachedShader->reflection.isValid && memcmp(&pCompiledShader->reflection, &pCachedShader->reflection, sizeof(shader_reflection_t)) == 0);
+    }
+
+    //FK: Defines and includes are part of the key
+    compilationParameters.pDefines = "USE_RED=1";
+    removeShaderCacheEntry(pGraphicsFrame, &compilationParameters, variantEntryPath);
+    loadAndCompileShaderCodeFromFile(pGraphicsFrame, &compilationParameters);
+    CHECK(pStatistics->missCount == 2u);
+    compilationParameters.pDefines = nullptr;
+
+    writeTestFile("cpu_benchmark_shader_cache/test_include.hlsli", "static const float4 color = float4(0, 1, 0, 1);\n");
+    removeShaderCacheEntry(pGraphicsFrame, &compilationParameters, variantEntryPath);
+    loadAndCompileShaderCodeFromFile(pGraphicsFrame, &compilationParameters);
+    CHECK(pStatistics->missCount == 3u && pStatistics->hitCount == 1u);
+
+    //FK: Flip a byte of the shader blob, the entry should be detected as corrupt and get recompiled
+    writeTestFile("cpu_benchmark_shader_cache/test_include.hlsli", "static const float4 color = float4(1, 0, 0, 1);\n");
+    FILE* pEntryFileHandle = fopen(entryPath, "r+b");
+    CHECK(pEntryFileHandle != nullptr);
+    if(pEntryFileHandle != nullptr)
+    {
+        fseek(pEntryFileHandle, sizeof(shader_cache_entry_header_t), SEEK_SET);
+        fputc('X', pEntryFileHandle);
+        fclose(pEntryFileHandle);
+    }
+
+    loadAndCompileShaderCodeFromFile(pGraphicsFrame, &compilationParameters);
+    CHECK(pStatistics->corruptEntryCount == 1u && pStatistics->missCount == 4u);
+    loadAndCompileShaderCodeFromFile(pGraphicsFrame, &compilationParameters);
+    CHECK(pStatistics->hitCount == 2u);
+    CHECK(pStatistics->writeFailureCount == 0u);
+
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+
+    //FK: A compiler build from another commit with the same version must not pick up the entries of this one
+    setNullShaderCompilerCommit(2u, "1111111");
+    render_context_t updatedRenderContext = {};
+    CHECK(createRenderContext(&updatedRenderContext, &parameters));
+    pStatistics = &updatedRenderContext.shaderCompilerContext.cacheStatistics;
+    pGraphicsFrame = beginNextFrame(&updatedRenderContext);
+
+    removeShaderCacheEntry(pGraphicsFrame, &compilationParameters, variantEntryPath);
+    CHECK(strcmp(entryPath, variantEntryPath) != 0);
+    loadAndCompileShaderCodeFromFile(pGraphicsFrame, &compilationParameters);
+    CHECK(pStatistics->missCount == 1u && pStatistics->hitCount == 0u);
+
+    finishFrame(&updatedRenderContext, pGraphicsFrame);
+    shutdownRenderContext(&updatedRenderContext);
+    setNullShaderCompilerCommit(1u, "0000000");
+    remove(variantEntryPath);
+
+    remove("cpu_benchmark_shader_cache/test_shader.hlsl");
+    remove("cpu_benchmark_shader_cache/test_include.hlsli");
+}
+
+struct shader_batch_test_results_t
+{
+    uint32_t    resultCount;
+    uint8_t     resultCountPerShader[64];
+};
+
+void countShaderBatchResult(const shader_batch_result_t* pResult, void* pUserData)
+{
+    shader_batch_test_results_t* pResults = (shader_batch_test_results_t*)pUserData;
+    ++pResults->resultCount;
+    ++pResults->resultCountPerShader[pResult->shaderIndex];
+}
+
+bool createShaderBatchTestRenderContext(render_context_t* pRenderContext)
+{
+    writeTestFile("cpu_benchmark_shader_cache/batch_shader.hlsl", "float4 main() : SV_Target { return float4(VALUE, 0, 0, 1); }\n");
+
+    render_context_parameters_t parameters = createDefaultRenderContextParameters(nullptr, 2u, 1280u, 720u, false);
+    parameters.limits.maxShaderBinaryCount = 512u;
+    return createRenderContext(pRenderContext, &parameters);
+}
+
+void createShaderPermutationParameters(shader_compilation_parameters_t* pParameters, char (*pDefines)[32], const uint32_t permutationCount)
+{
+    for(uint32_t permutationIndex = 0u; permutationIndex < permutationCount; ++permutationIndex)
+    {
+        sprintf_s(pDefines[permutationIndex], sizeof(pDefines[permutationIndex]), "VALUE=%u", permutationIndex);
+        pParameters[permutationIndex] = {};
+        pParameters[permutationIndex].pEntryPoint       = "main";
+        pParameters[permutationIndex].pFilePath         = "cpu_benchmark_shader_cache/batch_shader.hlsl";
+        pParameters[permutationIndex].pShaderProfile    = "ps_6_0";
+        pParameters[permutationIndex].pDefines          = pDefines[permutationIndex];
+    }
+}
+
+void testShaderBatchCompilation()
+{
+    render_context_t renderContext = {};
+    CHECK(createShaderBatchTestRenderContext(&renderContext));
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+
+    const uint32_t shaderCount = 64u;
+    char defines[shaderCount][32];
+    shader_compilation_parameters_t parameters[shaderCount];
+    shader_binary_handle_t shaderBinaries[shaderCount];
+    createShaderPermutationParameters(parameters, defines, shaderCount);
+
+    shader_batch_test_results_t results = {};
+    CHECK(compileShaderBatch(pGraphicsFrame, parameters, shaderCount, shaderBinaries, countShaderBatchResult, &results));
+    CHECK(results.resultCount == shaderCount);
+
+    for(uint32_t shaderIndex = 0u; shaderIndex < shaderCount; ++shaderIndex)
+    {
+        CHECK(results.resultCountPerShader[shaderIndex] == 1u);
+        CHECK(!isInvalidResourceHandle(shaderBinaries[shaderIndex]));
+        destroyShaderBinary(pGraphicsFrame, shaderBinaries[shaderIndex]);
+    }
+
+    //FK: Failures only affect their own shader
+    parameters[3].pFilePath = "cpu_benchmark_shader_cache/does_not_exist.hlsl";
+    results = {};
+    CHECK(!compileShaderBatch(pGraphicsFrame, parameters, 8u, shaderBinaries, countShaderBatchResult, &results));
+    CHECK(results.resultCount == 8u);
+    CHECK(isInvalidResourceHandle(shaderBinaries[3]));
+    CHECK(!isInvalidResourceHandle(shaderBinaries[4]));
+
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+
+void testShaderPermutations()
+{
+    render_context_t renderContext = {};
+    CHECK(createShaderBatchTestRenderContext(&renderContext));
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+
+    writeTestFile("cpu_benchmark_shader_cache/permutation_shader.hlsl", 
+        "float4 main() : SV_Target\n"
+        "{\n"
+        "#if USE_FOG\n"
+        "    return float4(0.5, 0.5, 0.5, 1);\n"
+        "#elif USE_SHADOWS\n"
+        "    return float4(0, 0, 0, 1);\n"
+        "#endif\n"
+        "    return float4(1, 1, 1, 1);\n"
+        "}\n");
+
+    //FK: UNUSED_KEYWORD isn't referenced by the shader, so it doesn't change the compiled blob
+    const char* pKeywords[] = {"USE_FOG", "USE_SHADOWS", "UNUSED_KEYWORD"};
+    shader_permutation_set_parameters_t parameters = {};
+    parameters.pFilePath        = "cpu_benchmark_shader_cache/permutation_shader.hlsl";
+    parameters.pEntryPoint      = "main";
+    parameters.pShaderProfile   = "ps_6_0";
+    parameters.ppKeywords       = pKeywords;
+    parameters.keywordCount     = 3u;
+
+    shader_permutation_set_t permutationSet = {};
+    CHECK(createShaderPermutationSet(&permutationSet, &renderContext.defaultAllocator, &parameters));
+    CHECK(permutationSet.permutationCount == 8u);
+
+    const uint32_t fogMask      = getShaderPermutationKeywordMask(&permutationSet, "USE_FOG");
+    const uint32_t shadowMask   = getShaderPermutationKeywordMask(&permutationSet, "USE_SHADOWS");
+    const uint32_t unusedMask   = getShaderPermutationKeywordMask(&permutationSet, "UNUSED_KEYWORD");
+    CHECK(fogMask == 0x1u && shadowMask == 0x2u && unusedMask == 0x4u);
+
+    //FK: First request compiles, later requests are lookups
+    const shader_binary_handle_t defaultPermutation = getShaderPermutation(pGraphicsFrame, &permutationSet, 0u);
+    CHECK(!isInvalidResourceHandle(defaultPermutation));
+    CHECK(permutationSet.statistics.compiledPermutationCount == 1u);
+
+    const shader_binary_handle_t defaultPermutationLookup = getShaderPermutation(pGraphicsFrame, &permutationSet, 0u);
+    CHECK(defaultPermutationLookup.index == defaultPermutation.index && defaultPermutationLookup.generation == defaultPermutation.generation);
+    CHECK(permutationSet.statistics.compiledPermutationCount == 1u);
+
+    const shader_binary_handle_t unusedPermutation = getShaderPermutation(pGraphicsFrame, &permutationSet, unusedMask);
+    CHECK(unusedPermutation.index == defaultPermutation.index && unusedPermutation.generation == defaultPermutation.generation);
+    CHECK(permutationSet.statistics.deduplicatedPermutationCount == 1u);
+
+    const shader_binary_handle_t fogPermutation = getShaderPermutation(pGraphicsFrame, &permutationSet, fogMask);
+    CHECK(!isInvalidResourceHandle(fogPermutation) && fogPermutation.index != defaultPermutation.index);
+
+    uint32_t allPermutationMasks[8u];
+    for(uint32_t permutationIndex = 0u; permutationIndex < 8u; ++permutationIndex)
+    {
+        allPermutationMasks[permutationIndex] = permutationIndex;
+    }
+
+    CHECK(compileShaderPermutations(pGraphicsFrame, &permutationSet, allPermutationMasks, 8u));
+    CHECK(permutationSet.statistics.compiledPermutationCount == 8u);
+    CHECK(permutationSet.statistics.deduplicatedPermutationCount == 4u);
+    CHECK(permutationSet.uniqueBinaryCount == 4u);
+    CHECK(compileShaderPermutations(pGraphicsFrame, &permutationSet, nullptr, 0u));
+
+    destroyShaderPermutationSet(pGraphicsFrame, &permutationSet);
+    CHECK(renderContext.renderResourceCache.shaderBinaries.aliveCount == 0u);
+
+    //FK: Failed permutations don't get recompiled on every request
+    parameters.pFilePath = "cpu_benchmark_shader_cache/does_not_exist.hlsl";
+    CHECK(createShaderPermutationSet(&permutationSet, &renderContext.defaultAllocator, &parameters));
+    CHECK(isInvalidResourceHandle(getShaderPermutation(pGraphicsFrame, &permutationSet, fogMask)));
+    CHECK(isInvalidResourceHandle(getShaderPermutation(pGraphicsFrame, &permutationSet, fogMask)));
+    CHECK(permutationSet.statistics.failedPermutationCount == 1u);
+    destroyShaderPermutationSet(pGraphicsFrame, &permutationSet);
+
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+
+graphics_pipeline_state_parameters_t createPipelineStateTestParameters(graphics_frame_t* pGraphicsFrame)
+{
+    writeTestFile("cpu_benchmark_shader_cache/pso_vertex_shader.hlsl", "float4 main(float3 position : POSITION) : SV_Position { return float4(position, 1); }\n");
+    writeTestFile("cpu_benchmark_shader_cache/pso_pixel_shader.hlsl", "float4 main() : SV_Target { return float4(1, 0, 0, 1); }\n");
+
+    shader_compilation_parameters_t vertexShaderParameters = {};
+    vertexShaderParameters.pEntryPoint      = "main";
+    vertexShaderParameters.pFilePath        = "cpu_benchmark_shader_cache/pso_vertex_shader.hlsl";
+    vertexShaderParameters.pShaderProfile   = "vs_6_0";
+
+    shader_compilation_parameters_t pixelShaderParameters = vertexShaderParameters;
+    pixelShaderParameters.pFilePath         = "cpu_benchmark_shader_cache/pso_pixel_shader.hlsl";
+    pixelShaderParameters.pShaderProfile    = "ps_6_0";
+
+    const vertex_attribute_entry_t vertexAttributes[] = {
+        {vertex_attribute_t::position, vertex_attribute_type_t::float32, 3u},
+        {vertex_attribute_t::color, vertex_attribute_type_t::float32, 4u}
+    };
+
+    graphics_pipeline_state_parameters_t parameters = createDefaultGraphicsPipelineStateParameters();
+    parameters.pName        = "Test";
+    parameters.vertexShader = loadAndCompileShaderCodeFromFile(pGraphicsFrame, &vertexShaderParameters);
+    parameters.pixelShader  = loadAndCompileShaderCodeFromFile(pGraphicsFrame, &pixelShaderParameters);
+    parameters.vertexFormat = createVertexFormat(pGraphicsFrame, vertexAttributes, 2u);
+    return parameters;
+}
+
+bool isSamePipelineState(const graphics_pipeline_state_handle_t a, const graphics_pipeline_state_handle_t b)
+{
+    return a.index == b.index && a.generation == b.generation;
+}
+
+struct pipeline_state_request_context_t
+{
+    graphics_frame_t*                           pGraphicsFrame;
+    const graphics_pipeline_state_parameters_t* pParameters;
+    graphics_pipeline_state_handle_t            pipelineStates[4];
+    volatile LONG                               nextRequestIndex;
+};
+
+void CALLBACK requestPipelineStateThreadpoolCallback(PTP_CALLBACK_INSTANCE pInstance, PVOID pContext, PTP_WORK pWork)
+{
+    UNUSED_PARAMETER(pInstance);
+    UNUSED_PARAMETER(pWork);
+
+    pipeline_state_request_context_t* pRequestContext = (pipeline_state_request_context_t*)pContext;
+    const uint32_t requestIndex = (uint32_t)InterlockedIncrement(&pRequestContext->nextRequestIndex) - 1u;
+    pRequestContext->pipelineStates[requestIndex] = createGraphicsPipelineState(pRequestContext->pGraphicsFrame, pRequestContext->pParameters);
+}
+
+void testPipelineStateCache()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 2u));
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+
+    const pipeline_state_cache_statistics_t* pStatistics = &renderContext.renderResourceCache.pipelineStateCache.statistics;
+    const null_device_statistics_t* pDeviceStatistics = getNullDeviceStatistics(renderContext.pDevice);
+    const uint64_t initialPipelineStateCount = pDeviceStatistics->pipelineStateCount;
+
+    graphics_pipeline_state_parameters_t parameters = createPipelineStateTestParameters(pGraphicsFrame);
+    const graphics_pipeline_state_handle_t pipelineState = createGraphicsPipelineState(pGraphicsFrame, &parameters);
+    CHECK(!isInvalidResourceHandle(pipelineState));
+    CHECK(pStatistics->missCount == 1u && pStatistics->hitCount == 0u);
+
+    //FK: Same parameters and identical vertex formats created separately share the pipeline state
+    CHECK(isSamePipelineState(createGraphicsPipelineState(pGraphicsFrame, &parameters), pipelineState));
+    const vertex_format_t* pVertexFormat = getVertexFormat(pGraphicsFrame->pRenderResourceCache, parameters.vertexFormat);
+    graphics_pipeline_state_parameters_t duplicatedFormatParameters = parameters;
+    duplicatedFormatParameters.vertexFormat = createVertexFormat(pGraphicsFrame, pVertexFormat->pVertexAttributes, pVertexFormat->vertexAttributeCount);
+    CHECK(duplicatedFormatParameters.vertexFormat.index == parameters.vertexFormat.index);
+    CHECK(isSamePipelineState(createGraphicsPipelineState(pGraphicsFrame, &duplicatedFormatParameters), pipelineState));
+    CHECK(pStatistics->missCount == 1u && pStatistics->hitCount == 2u);
+    CHECK(pDeviceStatistics->pipelineStateCount == initialPipelineStateCount + 1u);
+
+    //FK: Blend descs of additional render targets are ignored without independent blending
+    graphics_pipeline_state_parameters_t ignoredBlendParameters = parameters;
+    ignoredBlendParameters.blendDesc.RenderTarget[1].BlendEnable = TRUE;
+    CHECK(isSamePipelineState(createGraphicsPipelineState(pGraphicsFrame, &ignoredBlendParameters), pipelineState));
+
+    graphics_pipeline_state_parameters_t noCullParameters = parameters;
+    noCullParameters.rasterizerDesc.CullMode = D3D12_CULL_MODE_NONE;
+    const graphics_pipeline_state_handle_t noCullPipelineState = createGraphicsPipelineState(pGraphicsFrame, &noCullParameters);
+    CHECK(!isInvalidResourceHandle(noCullPipelineState) && !isSamePipelineState(noCullPipelineState, pipelineState));
+    CHECK(pStatistics->missCount == 2u);
+
+    //FK: Pipeline state is alive until all 4 references are gone
+    for(uint32_t referenceIndex = 0u; referenceIndex < 4u; ++referenceIndex)
+    {
+        CHECK(getPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState) != nullptr);
+        destroyPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState);
+    }
+    CHECK(getPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState) == nullptr);
+    CHECK(getPipelineState(pGraphicsFrame->pRenderResourceCache, noCullPipelineState) != nullptr);
+
+    const graphics_pipeline_state_handle_t recreatedPipelineState = createGraphicsPipelineState(pGraphicsFrame, &parameters);
+    CHECK(!isInvalidResourceHandle(recreatedPipelineState) && pStatistics->missCount == 3u);
+
+    //FK: Concurrent requests for the same pipeline state wait for the thread that creates it
+    setNullPipelineStateCompilerCost(20000000u);
+
+    graphics_pipeline_state_parameters_t wireframeParameters = parameters;
+    wireframeParameters.rasterizerDesc.FillMode = D3D12_FILL_MODE_WIREFRAME;
+
+    pipeline_state_request_context_t requestContext = {};
+    requestContext.pGraphicsFrame   = pGraphicsFrame;
+    requestContext.pParameters      = &wireframeParameters;
+
+    const uint32_t requestCount = 4u;
+    const uint64_t pipelineStateCountBeforeRequests = pDeviceStatistics->pipelineStateCount;
+    const uint32_t hitAndCoalescedCountBeforeRequests = pStatistics->hitCount + pStatistics->coalescedCount;
+    PTP_WORK pWork = CreateThreadpoolWork(requestPipelineStateThreadpoolCallback, &requestContext, nullptr);
+    for(uint32_t requestIndex = 0u; requestIndex < requestCount; ++requestIndex)
+    {
+        SubmitThreadpoolWork(pWork);
+    }
+    WaitForThreadpoolWorkCallbacks(pWork, FALSE);
+    CloseThreadpoolWork(pWork);
+
+    setNullPipelineStateCompilerCost(0u);
+
+    CHECK(pDeviceStatistics->pipelineStateCount == pipelineStateCountBeforeRequests + 1u);
+    CHECK(pStatistics->hitCount + pStatistics->coalescedCount == hitAndCoalescedCountBeforeRequests + requestCount - 1u);
+    for(uint32_t requestIndex = 0u; requestIndex < requestCount; ++requestIndex)
+    {
+        CHECK(!isInvalidResourceHandle(requestContext.pipelineStates[requestIndex]));
+        CHECK(isSamePipelineState(requestContext.pipelineStates[requestIndex], requestContext.pipelineStates[0]));
+    }
+
+    //FK: Failed creations aren't cached
+    graphics_pipeline_state_parameters_t invalidParameters = parameters;
+    invalidParameters.pixelShader = createInvalidResourceHandle<shader_binary_handle_t>();
+    CHECK(isInvalidResourceHandle(createGraphicsPipelineState(pGraphicsFrame, &invalidParameters)));
+
+    //FK: Changing the key inputs of a cached pipeline state simulates a key collision, requests must not share it
+    pipeline_state_cache_t* pPipelineStateCache = &renderContext.renderResourceCache.pipelineStateCache;
+    const uint64_t recreatedPipelineStateKey = getPipelineState(pGraphicsFrame->pRenderResourceCache, recreatedPipelineState)->cacheKey;
+    pipeline_state_cache_entry_t* pCollidingEntry = findPipelineStateCacheEntryByHandle(pPipelineStateCache, recreatedPipelineStateKey, recreatedPipelineState);
+    CHECK(pCollidingEntry != nullptr);
+    if(pCollidingEntry != nullptr)
+    {
+        pCollidingEntry->keyInputs.rasterizerDesc.FrontCounterClockwise = TRUE;
+
+        const uint32_t missCountBeforeCollision = pStatistics->missCount;
+        const graphics_pipeline_state_handle_t collidingPipelineState = createGraphicsPipelineState(pGraphicsFrame, &parameters);
+        CHECK(!isInvalidResourceHandle(collidingPipelineState) && !isSamePipelineState(collidingPipelineState, recreatedPipelineState));
+        CHECK(pStatistics->missCount == missCountBeforeCollision + 1u);
+        CHECK(getPipelineState(pGraphicsFrame->pRenderResourceCache, collidingPipelineState)->cacheKey == recreatedPipelineStateKey);
+        CHECK(isSamePipelineState(createGraphicsPipelineState(pGraphicsFrame, &parameters), collidingPipelineState));
+
+        destroyPipelineState(pGraphicsFrame->pRenderResourceCache, collidingPipelineState);
+        destroyPipelineState(pGraphicsFrame->pRenderResourceCache, collidingPipelineState);
+        CHECK(findPipelineStateCacheEntryByHandle(pPipelineStateCache, recreatedPipelineStateKey, collidingPipelineState) == nullptr);
+        CHECK(findPipelineStateCacheEntryByHandle(pPipelineStateCache, recreatedPipelineStateKey, recreatedPipelineState) != nullptr);
+    }
+
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+
+void testRootSignatureCache()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 2u));
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+
+    const root_signature_cache_statistics_t* pStatistics = &renderContext.renderResourceCache.rootSignatureCache.statistics;
+    const null_device_statistics_t* pDeviceStatistics = getNullDeviceStatistics(renderContext.pDevice);
+    const uint64_t initialRootSignatureCount = pDeviceStatistics->rootSignatureCount;
+
+    //FK: Pipeline states that only differ in fixed function state share their root signature
+    graphics_pipeline_state_parameters_t parameters = createPipelineStateTestParameters(pGraphicsFrame);
+    graphics_pipeline_state_parameters_t noCullParameters = parameters;
+    noCullParameters.rasterizerDesc.CullMode = D3D12_CULL_MODE_NONE;
+
+    const graphics_pipeline_state_handle_t pipelineState = createGraphicsPipelineState(pGraphicsFrame, &parameters);
+    const graphics_pipeline_state_handle_t noCullPipelineState = createGraphicsPipelineState(pGraphicsFrame, &noCullParameters);
+    const graphics_pipeline_state_t* pPipelineState = getPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState);
+    const graphics_pipeline_state_t* pNoCullPipelineState = getPipelineState(pGraphicsFrame->pRenderResourceCache, noCullPipelineState);
+    CHECK(pPipelineState != nullptr && pNoCullPipelineState != nullptr);
+    CHECK(pPipelineState->pRootSignature == pNoCullPipelineState->pRootSignature);
+    CHECK(pDeviceStatistics->rootSignatureCount == initialRootSignatureCount + 1u);
+    CHECK(pStatistics->missCount == 1u && pStatistics->hitCount == 1u);
+
+    //FK: A different root parameter layout gets its own root signature
+    D3D12_ROOT_PARAMETER rootParameter = {};
+    rootParameter.ParameterType             = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    rootParameter.ShaderVisibility          = D3D12_SHADER_VISIBILITY_VERTEX;
+    rootParameter.Constants.Num32BitValues  = 4u;
+
+    D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = createDefaultRootSignatureDesc();
+    rootSignatureDesc.NumParameters = 1u;
+    rootSignatureDesc.pParameters   = &rootParameter;
+
+    graphics_pipeline_state_parameters_t rootConstantsParameters = parameters;
+    rootConstantsParameters.pRootSignatureDesc = &rootSignatureDesc;
+    const graphics_pipeline_state_handle_t rootConstantsPipelineState = createGraphicsPipelineState(pGraphicsFrame, &rootConstantsParameters);
+    const graphics_pipeline_state_t* pRootConstantsPipelineState = getPipelineState(pGraphicsFrame->pRenderResourceCache, rootConstantsPipelineState);
+    CHECK(!isInvalidResourceHandle(rootConstantsPipelineState) && !isSamePipelineState(rootConstantsPipelineState, pipelineState));
+    CHECK(pRootConstantsPipelineState->pRootSignature != pPipelineState->pRootSignature);
+    CHECK(pDeviceStatistics->rootSignatureCount == initialRootSignatureCount + 2u);
+
+    //FK: Equal layouts declared in a separate desc hit the cache
+    D3D12_ROOT_PARAMETER sameRootParameter = rootParameter;
+    D3D12_ROOT_SIGNATURE_DESC sameRootSignatureDesc = rootSignatureDesc;
+    sameRootSignatureDesc.pParameters = &sameRootParameter;
+    graphics_pipeline_state_parameters_t sameRootConstantsParameters = noCullParameters;
+    sameRootConstantsParameters.pRootSignatureDesc = &sameRootSignatureDesc;
+    const graphics_pipeline_state_handle_t sameRootConstantsPipelineState = createGraphicsPipelineState(pGraphicsFrame, &sameRootConstantsParameters);
+    CHECK(getPipelineState(pGraphicsFrame->pRenderResourceCache, sameRootConstantsPipelineState)->pRootSignature == pRootConstantsPipelineState->pRootSignature);
+    CHECK(pDeviceStatistics->rootSignatureCount == initialRootSignatureCount + 2u);
+
+    //FK: Switching between pipeline states with a shared root signature only sets the root signature once
+    render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, "Root Signature Pass", nullptr);
+    const uint32_t issuedCallCountBeforeBinding = pRenderPass->stateCache.statistics.issuedCallCount;
+    setPipelineState(pRenderPass, pipelineState);
+    setPipelineState(pRenderPass, noCullPipelineState);
+    setPipelineState(pRenderPass, pipelineState);
+    CHECK(pRenderPass->stateCache.statistics.issuedCallCount == issuedCallCountBeforeBinding + 4u);
+    endRenderPass(pGraphicsFrame, pRenderPass);
+    executeRenderPass(pGraphicsFrame, pRenderPass);
+
+    destroyPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState);
+    destroyPipelineState(pGraphicsFrame->pRenderResourceCache, noCullPipelineState);
+    destroyPipelineState(pGraphicsFrame->pRenderResourceCache, rootConstantsPipelineState);
+    destroyPipelineState(pGraphicsFrame->pRenderResourceCache, sameRootConstantsPipelineState);
+
+    //FK: Changing the stored desc of a cached root signature simulates a key collision, the layout must not share it
+    root_signature_cache_t* pRootSignatureCache = &renderContext.renderResourceCache.rootSignatureCache;
+    root_signature_cache_entry_t* pCollidingEntry = nullptr;
+    for(uint32_t entryIndex = 0u; entryIndex < pRootSignatureCache->entryCount; ++entryIndex)
+    {
+        if(pRootSignatureCache->pEntries[entryIndex].key == calculateRootSignatureDescHash(&rootSignatureDesc, fnv1aOffsetBasis))
+        {
+            pCollidingEntry = pRootSignatureCache->pEntries + entryIndex;
+        }
+    }
+
+    CHECK(pCollidingEntry != nullptr);
+    if(pCollidingEntry != nullptr)
+    {
+        pCollidingEntry->pRootSignatureDesc[0] ^= 0xFFu;
+
+        ID3D12RootSignature* pCollidingRootSignature = getOrCreateRootSignature(renderContext.pDevice, pRootSignatureCache, &rootSignatureDesc);
+        CHECK(pCollidingRootSignature != nullptr && pCollidingRootSignature != pCollidingEntry->pRootSignature);
+        CHECK(pDeviceStatistics->rootSignatureCount == initialRootSignatureCount + 3u);
+        CHECK(getOrCreateRootSignature(renderContext.pDevice, pRootSignatureCache, &rootSignatureDesc) == pCollidingRootSignature);
+        //FK: One reference per getOrCreateRootSignature() call, the cache keeps its own
+        pCollidingRootSignature->Release();
+        COM_RELEASE(pCollidingRootSignature);
+    }
+
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+
+void testShaderReflection()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 2u));
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+
+    writeTestFile("cpu_benchmark_shader_cache/reflection_vertex_shader.hlsl",
+        "struct VertexInput { float3 pos : POSITION; float4 color : COLOR; };\n"
+        "cbuffer Transform : register(b0) { float4x4 worldViewProjection; float3 offset; float scale; };\n"
+        "Texture2D heightMap : register(t0);\n"
+        "float4 main(VertexInput input, uint vertexId : SV_VertexID) : SV_Position { return mul(worldViewProjection, float4(input.pos, 1)); }\n");
+    writeTestFile("cpu_benchmark_shader_cache/reflection_pixel_shader.hlsl",
+        "struct Material { float4 tint; float roughness; };\n"
+        "cbuffer Transform : register(b0) { float4x4 worldViewProjection; float3 offset; float scale; };\n"
+        "ConstantBuffer<Material> material : register(b1, space1);\n"
+        "Texture2D heightMap : register(t0);\n"
+        "Texture2D textures[] : register(t1, space1);\n"
+        "SamplerState linearSampler : register(s0);\n"
+        "float4 main(float4 pos : SV_Position, float4 color : COLOR) : SV_Target { return color * material.tint; }\n");
+
+    shader_compilation_parameters_t vertexShaderParameters = {};
+    vertexShaderParameters.pEntryPoint      = "main";
+    vertexShaderParameters.pFilePath        = "cpu_benchmark_shader_cache/reflection_vertex_shader.hlsl";
+    vertexShaderParameters.pShaderProfile   = "vs_6_0";
+
+    shader_compilation_parameters_t pixelShaderParameters = vertexShaderParameters;
+    pixelShaderParameters.pFilePath         = "cpu_benchmark_shader_cache/reflection_pixel_shader.hlsl";
+    pixelShaderParameters.pShaderProfile    = "ps_6_0";
+
+    const shader_binary_handle_t vertexShader = loadAndCompileShaderCodeFromFile(pGraphicsFrame, &vertexShaderParameters);
+    const shader_binary_handle_t pixelShader = loadAndCompileShaderCodeFromFile(pGraphicsFrame, &pixelShaderParameters);
+    const shader_binary_t* pVertexShader = getShaderBinary(pGraphicsFrame->pRenderResourceCache, vertexShader);
+    const shader_binary_t* pPixelShader = getShaderBinary(pGraphicsFrame->pRenderResourceCache, pixelShader);
+    CHECK(pVertexShader != nullptr && pPixelShader != nullptr);
+
+    //FK: System values aren't vertex attributes, pixel shader inputs come from the vertex shader
+    const shader_reflection_t* pVertexReflection = &pVertexShader->reflection;
+    const shader_reflection_t* pPixelReflection = &pPixelShader->reflection;
+    CHECK(pVertexReflection->isValid && pPixelReflection->isValid);
+    CHECK(pVertexReflection->inputAttributeCount == 2u && pPixelReflection->inputAttributeCount == 0u);
+    CHECK(pVertexReflection->inputAttributes[0].attribute == vertex_attribute_t::position && pVertexReflection->inputAttributes[1].attribute == vertex_attribute_t::color);
+    CHECK(pVertexReflection->resourceBindingCount == 2u && pPixelReflection->resourceBindingCount == 5u);
+    CHECK(pVertexReflection->resourceBindings[0].type == shader_resource_binding_constant_buffer && pVertexReflection->resourceBindings[0].constantBufferSizeInBytes == 80u);
+    CHECK(pPixelReflection->resourceBindings[1].constantBufferSizeInBytes == 32u && pPixelReflection->resourceBindings[1].registerSpace == 1u);
+    CHECK(pPixelReflection->resourceBindings[3].type == shader_resource_binding_srv && pPixelReflection->resourceBindings[3].bindCount == 0u);
+
+    //FK: Root CBVs first, then the SRV table (unbounded array last) and the sampler table
+    generated_root_signature_desc_t generatedRootSignatureDesc;
+    const D3D12_ROOT_SIGNATURE_DESC* pRootSignatureDesc = generateRootSignatureDesc(pVertexReflection, pPixelReflection, &generatedRootSignatureDesc);
+    CHECK(pRootSignatureDesc->NumParameters == 4u);
+    CHECK(pRootSignatureDesc->pParameters[0].ParameterType == D3D12_ROOT_PARAMETER_TYPE_CBV && pRootSignatureDesc->pParameters[0].ShaderVisibility == D3D12_SHADER_VISIBILITY_ALL);
+    CHECK(pRootSignatureDesc->pParameters[1].ParameterType == D3D12_ROOT_PARAMETER_TYPE_CBV && pRootSignatureDesc->pParameters[1].ShaderVisibility == D3D12_SHADER_VISIBILITY_PIXEL);
+    CHECK(pRootSignatureDesc->pParameters[1].Descriptor.ShaderRegister == 1u && pRootSignatureDesc->pParameters[1].Descriptor.RegisterSpace == 1u);
+    CHECK(pRootSignatureDesc->pParameters[2].ParameterType == D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE && pRootSignatureDesc->pParameters[2].DescriptorTable.NumDescriptorRanges == 2u);
+    CHECK(pRootSignatureDesc->pParameters[2].ShaderVisibility == D3D12_SHADER_VISIBILITY_ALL);
+    CHECK(pRootSignatureDesc->pParameters[2].DescriptorTable.pDescriptorRanges[1].NumDescriptors == std::numeric_limits<uint32_t>::max());
+    CHECK(pRootSignatureDesc->pParameters[3].DescriptorTable.pDescriptorRanges[0].RangeType == D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER);
+    CHECK(pRootSignatureDesc->pParameters[3].ShaderVisibility == D3D12_SHADER_VISIBILITY_PIXEL);
+
+    //FK: Draw constants take the place of the constant buffer in b0, space0
+    pRootSignatureDesc = generateRootSignatureDesc(pVertexReflection, pPixelReflection, &generatedRootSignatureDesc, 4u);
+    CHECK(pRootSignatureDesc->NumParameters == 4u);
+    CHECK(pRootSignatureDesc->pParameters[0].ParameterType == D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS && pRootSignatureDesc->pParameters[0].Constants.Num32BitValues == 4u);
+    CHECK(pRootSignatureDesc->pParameters[0].Constants.ShaderRegister == 0u && pRootSignatureDesc->pParameters[0].Constants.RegisterSpace == 0u);
+    CHECK(pRootSignatureDesc->pParameters[1].ParameterType == D3D12_ROOT_PARAMETER_TYPE_CBV && pRootSignatureDesc->pParameters[1].Descriptor.RegisterSpace == 1u);
+
+    //FK: Shaders without resources end up with the default layout
+    shader_reflection_t emptyReflection = {};
+    const D3D12_ROOT_SIGNATURE_DESC defaultRootSignatureDesc = createDefaultRootSignatureDesc();
+    CHECK(calculateRootSignatureDescHash(generateRootSignatureDesc(&emptyReflection, &emptyReflection, &generatedRootSignatureDesc), fnv1aOffsetBasis) == calculateRootSignatureDescHash(&defaultRootSignatureDesc, fnv1aOffsetBasis));
+
+    //FK: Input elements follow the shader inputs, attributes that the shader doesn't read are left out
+    const vertex_attribute_entry_t vertexAttributes[] = {
+        {vertex_attribute_t::color, vertex_attribute_type_t::float32, 4u},
+        {vertex_attribute_t::color, vertex_attribute_type_t::float32, 4u},
+        {vertex_attribute_t::position, vertex_attribute_type_t::float32, 3u}
+    };
+
+    vertex_format_t vertexFormat;
+    initVertexFormat(&vertexFormat, vertexAttributes, 3u);
+
+    D3D12_INPUT_ELEMENT_DESC inputElementDescs[maxVertexAttributeCount] = {};
+    uint32_t inputElementCount = 0u;
+    CHECK(fillInputElementDescs(&vertexFormat, pVertexReflection, inputElementDescs, &inputElementCount));
+    CHECK(inputElementCount == 2u);
+    CHECK(strcmp(inputElementDescs[0].SemanticName, "POSITION") == 0 && inputElementDescs[0].AlignedByteOffset == 32u);
+    CHECK(strcmp(inputElementDescs[1].SemanticName, "COLOR") == 0 && inputElementDescs[1].SemanticIndex == 0u && inputElementDescs[1].AlignedByteOffset == 0u);
+
+    //FK: Without reflection every attribute gets an input element
+    CHECK(fillInputElementDescs(&vertexFormat, &emptyReflection, inputElementDescs, &inputElementCount) && inputElementCount == 3u);
+
+    graphics_pipeline_state_parameters_t parameters = createDefaultGraphicsPipelineStateParameters();
+    parameters.pName        = "Reflection";
+    parameters.vertexShader = vertexShader;
+    parameters.pixelShader  = pixelShader;
+    parameters.vertexFormat = createVertexFormat(pGraphicsFrame, vertexAttributes, 3u);
+
+    const null_device_statistics_t* pDeviceStatistics = getNullDeviceStatistics(renderContext.pDevice);
+    const uint64_t initialRootSignatureCount = pDeviceStatistics->rootSignatureCount;
+    const graphics_pipeline_state_handle_t pipelineState = createGraphicsPipelineState(pGraphicsFrame, &parameters);
+    CHECK(!isInvalidResourceHandle(pipelineState));
+    CHECK(pDeviceStatistics->rootSignatureCount == initialRootSignatureCount + 1u);
+
+    //FK: Registers resolve to the generated layout, array elements to their place in the table after the ranges before them
+    const graphics_pipeline_state_t* pPipelineState = getPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState);
+    CHECK(pPipelineState->rootParameterBindingCount == 5u);
+    CHECK(getRootParameterIndex(pPipelineState, shader_resource_binding_constant_buffer, 0u, 0u) == 0u);
+    CHECK(getRootParameterIndex(pPipelineState, shader_resource_binding_constant_buffer, 1u, 1u) == 1u);
+    CHECK(getRootParameterIndex(pPipelineState, shader_resource_binding_srv, 0u, 0u) == 2u && getDescriptorTableOffset(pPipelineState, shader_resource_binding_srv, 0u, 0u) == 0u);
+    CHECK(getRootParameterIndex(pPipelineState, shader_resource_binding_srv, 6u, 1u) == 2u && getDescriptorTableOffset(pPipelineState, shader_resource_binding_srv, 6u, 1u) == 6u);
+    CHECK(getRootParameterIndex(pPipelineState, shader_resource_binding_sampler, 0u, 0u) == 3u);
+    CHECK(getRootParameterIndex(pPipelineState, shader_resource_binding_srv, 1u, 0u) == invalidRootParameterIndex);
+    CHECK(getRootParameterIndex(pPipelineState, shader_resource_binding_uav, 0u, 0u) == invalidRootParameterIndex);
+    CHECK(getDescriptorTableOffset(pPipelineState, shader_resource_binding_constant_buffer, 0u, 0u) == invalidDescriptorIndex);
+
+    //FK: Resource tables come from the frame descriptors, sampler tables from the shader visible sampler heap
+    descriptor_allocation_t resourceTable = {};
+    descriptor_allocation_t samplerTable = {};
+    CHECK(allocateFrameDescriptors(pGraphicsFrame, 2u, &resourceTable));
+    CHECK(allocatePersistentDescriptors(&renderContext.samplerDescriptorAllocator, 1u, &samplerTable) && samplerTable.gpuHandle.ptr != 0u);
+
+    render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, "Descriptor Table Pass", nullptr);
+    setPipelineState(pRenderPass, pipelineState);
+    const uint64_t stateChangeCount = pRenderPass->pGraphicsCommandList->recorded.stateChangeCount;
+    setDescriptorTable(pRenderPass, getRootParameterIndex(pPipelineState, shader_resource_binding_srv, 0u, 0u), resourceTable.gpuHandle);
+    setDescriptorTable(pRenderPass, getRootParameterIndex(pPipelineState, shader_resource_binding_sampler, 0u, 0u), samplerTable.gpuHandle);
+    CHECK(pRenderPass->pGraphicsCommandList->recorded.stateChangeCount == stateChangeCount + 2u);
+    endRenderPass(pGraphicsFrame, pRenderPass);
+    executeRenderPass(pGraphicsFrame, pRenderPass);
+    freePersistentDescriptors(&renderContext.samplerDescriptorAllocator, &samplerTable);
+
+    //FK: Vertex formats that lack an attribute the vertex shader reads can't be used
+    graphics_pipeline_state_parameters_t missingColorParameters = parameters;
+    missingColorParameters.vertexFormat = createVertexFormat(pGraphicsFrame, vertexAttributes + 2u, 1u);
+    CHECK(isInvalidResourceHandle(createGraphicsPipelineState(pGraphicsFrame, &missingColorParameters)));
+
+    destroyPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState);
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+
+    remove("cpu_benchmark_shader_cache/reflection_vertex_shader.hlsl");
+    remove("cpu_benchmark_shader_cache/reflection_pixel_shader.hlsl");
+}
+
+void testVertexFormatInterning()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 2u));
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+    render_resource_cache_t* pRenderResourceCache = pGraphicsFrame->pRenderResourceCache;
+    const vertex_format_cache_statistics_t* pStatistics = &pRenderResourceCache->vertexFormatCache.statistics;
+
+    const vertex_attribute_entry_t vertexAttributes[] = {
+        {vertex_attribute_t::position, vertex_attribute_type_t::float32, 3u},
+        {vertex_attribute_t::color, vertex_attribute_type_t::unorm8, 4u},
+        {vertex_attribute_t::color, vertex_attribute_type_t::float16, 3u}
+    };
+
+    //FK: Identical attributes share a single vertex format
+    const vertex_format_handle_t vertexFormat = createVertexFormat(pGraphicsFrame, vertexAttributes, 3u);
+    const vertex_format_handle_t sameVertexFormat = createVertexFormat(pGraphicsFrame, vertexAttributes, 3u);
+    const vertex_format_handle_t otherVertexFormat = createVertexFormat(pGraphicsFrame, vertexAttributes, 2u);
+    CHECK(!isInvalidResourceHandle(vertexFormat) && !isInvalidResourceHandle(otherVertexFormat));
+    CHECK(vertexFormat.index == sameVertexFormat.index && vertexFormat.generation == sameVertexFormat.generation);
+    CHECK(vertexFormat.index != otherVertexFormat.index);
+    CHECK(pStatistics->hitCount == 1u && pStatistics->missCount == 2u);
+
+    const vertex_format_t* pVertexFormat = getVertexFormat(pRenderResourceCache, vertexFormat);
+    CHECK(pVertexFormat->strideInBytes == 12u + 4u + 8u);
+    CHECK(pVertexFormat->attributeOffsetsInBytes[1] == 12u && pVertexFormat->attributeOffsetsInBytes[2] == 16u);
+    CHECK(pVertexFormat->inputElementDescs[2].SemanticIndex == 1u && pVertexFormat->inputElementDescs[2].AlignedByteOffset == 16u);
+    CHECK(pVertexFormat->inputElementDescs[2].Format == DXGI_FORMAT_R16G16B16A16_FLOAT);
+    CHECK(pVertexFormat->hash != getVertexFormat(pRenderResourceCache, otherVertexFormat)->hash);
+
+    //FK: Invalid attributes don't create a vertex format
+    const vertex_attribute_entry_t invalidAttribute = {vertex_attribute_t::position, vertex_attribute_type_t::octahedral16, 4u};
+    CHECK(isInvalidResourceHandle(createVertexFormat(pGraphicsFrame, &invalidAttribute, 1u)));
+
+    //FK: The vertex format stays alive until every create call has been matched by a destroy call
+    destroyVertexFormat(pRenderResourceCache, vertexFormat);
+    CHECK(getVertexFormat(pRenderResourceCache, vertexFormat) != nullptr);
+    destroyVertexFormat(pRenderResourceCache, sameVertexFormat);
+    CHECK(getVertexFormat(pRenderResourceCache, vertexFormat) == nullptr);
+    CHECK(pRenderResourceCache->vertexFormatCache.entryCount == 1u);
+
+    const vertex_format_handle_t recreatedVertexFormat = createVertexFormat(pGraphicsFrame, vertexAttributes, 3u);
+    CHECK(!isInvalidResourceHandle(recreatedVertexFormat) && recreatedVertexFormat.generation != vertexFormat.generation);
+    CHECK(createVertexFormat(pGraphicsFrame, vertexAttributes, 2u).index == otherVertexFormat.index);
+    CHECK(pStatistics->hitCount == 2u && pStatistics->missCount == 3u);
+
+    destroyVertexFormat(pRenderResourceCache, recreatedVertexFormat);
+    destroyVertexFormat(pRenderResourceCache, otherVertexFormat);
+    destroyVertexFormat(pRenderResourceCache, otherVertexFormat);
+    CHECK(pRenderResourceCache->vertexFormatCache.entryCount == 0u);
+
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+
+struct descriptor_allocation_context_t
+{
+    persistent_descriptor_allocator_t*  pAllocator;
+    descriptor_allocation_t             allocations[64];
+    volatile LONG                       nextWorkerIndex;
+};
+
+constexpr uint32_t descriptorAllocationWorkerCount = 4u;
+
+void CALLBACK allocateDescriptorsThreadpoolCallback(PTP_CALLBACK_INSTANCE pInstance, PVOID pContext, PTP_WORK pWork)
+{
+    UNUSED_PARAMETER(pInstance);
+    UNUSED_PARAMETER(pWork);
+
+    descriptor_allocation_context_t* pAllocationContext = (descriptor_allocation_context_t*)pContext;
+    const uint32_t workerIndex = (uint32_t)InterlockedIncrement(&pAllocationContext->nextWorkerIndex) - 1u;
+    const uint32_t allocationCountPerWorker = 64u / descriptorAllocationWorkerCount;
+    for(uint32_t allocationIndex = 0u; allocationIndex < allocationCountPerWorker; ++allocationIndex)
+    {
+        //FK: Free and allocate again in between so that the free lists get used concurrently as well
+        descriptor_allocation_t* pAllocation = pAllocationContext->allocations + workerIndex * allocationCountPerWorker + allocationIndex;
+        allocatePersistentDescriptors(pAllocationContext->pAllocator, 1u, pAllocation);
+        freePersistentDescriptors(pAllocationContext->pAllocator, pAllocation);
+        allocatePersistentDescriptors(pAllocationContext->pAllocator, 1u, pAllocation);
+    }
+}
+
+void testDescriptorAllocators()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 3u));
+
+    persistent_descriptor_allocator_t persistentAllocator = {};
+    CHECK(createPersistentDescriptorAllocator(&persistentAllocator, &renderContext.defaultAllocator, renderContext.pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 16u));
+    const uint64_t incrementSizeInBytes = persistentAllocator.descriptorHeap.incrementSizeInBytes;
+
+    //FK: Allocations get rounded up to power of two blocks
+    descriptor_allocation_t first, second, third, reused;
+    CHECK(allocatePersistentDescriptors(&persistentAllocator, 1u, &first));
+    CHECK(allocatePersistentDescriptors(&persistentAllocator, 3u, &second));
+    CHECK(allocatePersistentDescriptors(&persistentAllocator, 4u, &third));
+    CHECK(first.heapIndex == 0u && second.heapIndex == 1u && third.heapIndex == 5u);
+    CHECK(second.count == 3u && persistentAllocator.statistics.usedDescriptorCount == 9u);
+    CHECK(third.cpuHandle.ptr == first.cpuHandle.ptr + 5u * incrementSizeInBytes);
+    CHECK(getDescriptorAllocationCPUHandle(&second, 2u, &persistentAllocator.descriptorHeap).ptr == first.cpuHandle.ptr + 3u * incrementSizeInBytes);
+    CHECK(first.gpuHandle.ptr == 0u);
+
+    //FK: Freed blocks get reused by allocations of the same size class
+    freePersistentDescriptors(&persistentAllocator, &second);
+    CHECK(persistentAllocator.statistics.usedDescriptorCount == 5u);
+    CHECK(allocatePersistentDescriptors(&persistentAllocator, 4u, &reused));
+    CHECK(reused.heapIndex == second.heapIndex);
+
+    //FK: 9 of 16 descriptors are handed out, a block of 8 doesn't fit anymore
+    descriptor_allocation_t rejected;
+    CHECK(!allocatePersistentDescriptors(&persistentAllocator, 8u, &rejected));
+    CHECK(!allocatePersistentDescriptors(&persistentAllocator, 1024u, &rejected));
+    CHECK(persistentAllocator.statistics.failedAllocationCount == 2u);
+    CHECK(persistentAllocator.statistics.allocationCount == 4u);
+    CHECK(persistentAllocator.statistics.highWaterMarkDescriptorCount == 9u);
+
+    freePersistentDescriptors(&persistentAllocator, &first);
+    freePersistentDescriptors(&persistentAllocator, &third);
+    freePersistentDescriptors(&persistentAllocator, &reused);
+    CHECK(persistentAllocator.statistics.usedDescriptorCount == 0u);
+    destroyPersistentDescriptorAllocator(&persistentAllocator);
+
+    //FK: Allocations from multiple threads never hand out a descriptor twice
+    CHECK(createPersistentDescriptorAllocator(&persistentAllocator, &renderContext.defaultAllocator, renderContext.pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 64u));
+    descriptor_allocation_context_t allocationContext = {};
+    allocationContext.pAllocator = &persistentAllocator;
+    PTP_WORK pWork = CreateThreadpoolWork(allocateDescriptorsThreadpoolCallback, &allocationContext, nullptr);
+    for(uint32_t workerIndex = 0u; workerIndex < descriptorAllocationWorkerCount; ++workerIndex)
+    {
+        SubmitThreadpoolWork(pWork);
+    }
+    WaitForThreadpoolWorkCallbacks(pWork, FALSE);
+    CloseThreadpoolWork(pWork);
+
+    bool isDescriptorAllocated[64] = {};
+    for(uint32_t allocationIndex = 0u; allocationIndex < 64u; ++allocationIndex)
+    {
+        const uint32_t heapIndex = allocationContext.allocations[allocationIndex].heapIndex;
+        CHECK(heapIndex < 64u && !isDescriptorAllocated[heapIndex]);
+        isDescriptorAllocated[heapIndex & 63u] = true;
+        freePersistentDescriptors(&persistentAllocator, allocationContext.allocations + allocationIndex);
+    }
+    CHECK(persistentAllocator.statistics.allocationCount == 128u && persistentAllocator.statistics.failedAllocationCount == 0u);
+    CHECK(persistentAllocator.statistics.usedDescriptorCount == 0u);
+    destroyPersistentDescriptorAllocator(&persistentAllocator);
+
+    //FK: The transient allocator owns descriptors 4 to 11 of the heap
+    d3d12_descriptor_heap_t shaderVisibleDescriptorHeap = {};
+    CHECK(createDescriptorHeap(&shaderVisibleDescriptorHeap, renderContext.pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 12u, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE));
+    transient_descriptor_allocator_t transientAllocator = {};
+    createTransientDescriptorAllocator(&transientAllocator, &shaderVisibleDescriptorHeap, 4u, 8u);
+
+    descriptor_allocation_t table;
+    CHECK(allocateTransientDescriptors(&transientAllocator, 3u, &table));
+    CHECK(table.heapIndex == 4u);
+    CHECK(table.gpuHandle.ptr == (UINT64)shaderVisibleDescriptorHeap.pGPUBaseAddress + 4u * incrementSizeInBytes);
+    CHECK(allocateTransientDescriptors(&transientAllocator, 3u, &table));
+    CHECK(table.heapIndex == 7u);
+    closeTransientDescriptorFrame(&transientAllocator, 1u);
+
+    //FK: Tables are contiguous, so the last 2 descriptors get skipped and the start of the heap is still in use
+    CHECK(!allocateTransientDescriptors(&transientAllocator, 3u, &table));
+    CHECK(transientAllocator.statistics.failedAllocationCount == 1u);
+    reclaimTransientDescriptors(&transientAllocator, 0u);
+    CHECK(transientAllocator.statistics.usedDescriptorCount == 6u);
+    reclaimTransientDescriptors(&transientAllocator, 1u);
+    CHECK(transientAllocator.statistics.usedDescriptorCount == 0u);
+    CHECK(allocateTransientDescriptors(&transientAllocator, 3u, &table));
+    CHECK(table.heapIndex == 4u);
+    CHECK(transientAllocator.statistics.highWaterMarkDescriptorCount == 6u);
+    destroyDescriptorHeap(&shaderVisibleDescriptorHeap);
+
+    //FK: Allocates more descriptors than the heap has in total, which only works if finished frames give theirs back
+    const uint32_t descriptorsPerFrame = renderContext.transientDescriptorAllocator.ringBuffer.sizeInBytes / 4u;
+    for(uint32_t frameIndex = 0u; frameIndex < 12u; ++frameIndex)
+    {
+        graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+        CHECK(allocateFrameDescriptors(pGraphicsFrame, descriptorsPerFrame / 2u, &table));
+        CHECK(allocateFrameDescriptors(pGraphicsFrame, descriptorsPerFrame / 2u, &table));
+        finishFrame(&renderContext, pGraphicsFrame);
+    }
+
+    const descriptor_allocator_statistics_t* pStatistics = &renderContext.transientDescriptorAllocator.statistics;
+    CHECK(pStatistics->failedAllocationCount == 0u && pStatistics->allocationCount == 24u);
+    CHECK(pStatistics->highWaterMarkDescriptorCount <= 4u * descriptorsPerFrame);
+
+    shutdownRenderContext(&renderContext);
+}
+
+uint64_t readNullDescriptor(const D3D12_CPU_DESCRIPTOR_HANDLE descriptor)
+{
+    uint64_t value = 0u;
+    memcpy(&value, (const void*)descriptor.ptr, sizeof(value));
+    return value;
+}
+
+void testBindlessResources()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 2u));
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+    bindless_descriptor_table_t* pTable = &renderContext.bindlessDescriptorTable;
+
+    //FK: Views get written straight into the shader visible heap, indices count from the start of the heap
+    ID3D12Resource* pResource = pGraphicsFrame->pBackBuffer->resource.pResource;
+    D3D12_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc = {};
+    shaderResourceViewDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    const uint32_t textureIndex = createBindlessShaderResourceView(pGraphicsFrame, pResource, &shaderResourceViewDesc);
+    CHECK(textureIndex == 0u);
+    CHECK(readNullDescriptor(getBindlessDescriptorCPUHandle(pTable, textureIndex)) == (uint64_t)pResource);
+
+    D3D12_CONSTANT_BUFFER_VIEW_DESC constantBufferViewDesc = {};
+    constantBufferViewDesc.BufferLocation   = 0x10000u;
+    constantBufferViewDesc.SizeInBytes      = 256u;
+    const uint32_t constantBufferIndex = createBindlessConstantBufferView(pGraphicsFrame, &constantBufferViewDesc);
+    CHECK(constantBufferIndex == 1u);
+    CHECK(readNullDescriptor(getBindlessDescriptorCPUHandle(pTable, constantBufferIndex)) == 0x10000u);
+
+    //FK: Descriptors that have been created in a CPU only heap get copied
+    descriptor_allocation_t stagedDescriptor;
+    CHECK(allocatePersistentDescriptors(&renderContext.persistentDescriptorAllocator, 1u, &stagedDescriptor));
+    constantBufferViewDesc.BufferLocation = 0x20000u;
+    renderContext.pDevice->CreateConstantBufferView(&constantBufferViewDesc, stagedDescriptor.cpuHandle);
+    const uint32_t copiedIndex = registerBindlessDescriptor(pGraphicsFrame, stagedDescriptor.cpuHandle);
+    CHECK(copiedIndex == 2u);
+    CHECK(readNullDescriptor(getBindlessDescriptorCPUHandle(pTable, copiedIndex)) == 0x20000u);
+    freePersistentDescriptors(&renderContext.persistentDescriptorAllocator, &stagedDescriptor);
+
+    //FK: Bindless pipeline states share the root signature regardless of their shaders' resources
+    graphics_pipeline_state_parameters_t parameters = createPipelineStateTestParameters(pGraphicsFrame);
+    parameters.useBindlessRootSignature = true;
+    graphics_pipeline_state_parameters_t noCullParameters = parameters;
+    noCullParameters.rasterizerDesc.CullMode = D3D12_CULL_MODE_NONE;
+    const graphics_pipeline_state_handle_t pipelineState = createGraphicsPipelineState(pGraphicsFrame, &parameters);
+    const graphics_pipeline_state_handle_t noCullPipelineState = createGraphicsPipelineState(pGraphicsFrame, &noCullParameters);
+    const graphics_pipeline_state_t* pPipelineState = getPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState);
+    const graphics_pipeline_state_t* pNoCullPipelineState = getPipelineState(pGraphicsFrame->pRenderResourceCache, noCullPipelineState);
+    CHECK(pPipelineState != nullptr && pNoCullPipelineState != nullptr);
+    CHECK(pPipelineState->isBindless && pPipelineState->pRootSignature == pNoCullPipelineState->pRootSignature);
+
+    //FK: Descriptor heaps get set when the render pass starts
+    render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, "Bindless Pass", nullptr);
+    const uint64_t* pStateChangeCount = &pRenderPass->pGraphicsCommandList->recorded.stateChangeCount;
+    CHECK(*pStateChangeCount == 1u);
+
+    //FK: The first bindless pipeline state sets the root signature and every bindless table
+    const uint32_t bindlessTableCount = bindless_root_parameter_count - bindless_root_parameter_srv_table;
+    uint64_t stateChangeCount = *pStateChangeCount;
+    setPipelineState(pRenderPass, pipelineState);
+    CHECK(*pStateChangeCount == stateChangeCount + 2u + bindlessTableCount);
+
+    //FK: After that every draw only needs its draw constants, pipeline states with the same root signature keep the tables
+    const uint32_t firstDrawConstants[] = {textureIndex, constantBufferIndex};
+    stateChangeCount = *pStateChangeCount;
+    setBindlessDrawConstants(pRenderPass, firstDrawConstants, 2u);
+    drawInstanced(pRenderPass, 3u, 1u, 0u, 0u);
+    CHECK(*pStateChangeCount == stateChangeCount + 1u);
+
+    stateChangeCount = *pStateChangeCount;
+    setPipelineState(pRenderPass, noCullPipelineState);
+    CHECK(*pStateChangeCount == stateChangeCount + 1u);
+
+    const uint32_t secondDrawConstants[] = {textureIndex, copiedIndex};
+    stateChangeCount = *pStateChangeCount;
+    setBindlessDrawConstants(pRenderPass, secondDrawConstants, 2u);
+    drawInstanced(pRenderPass, 3u, 1u, 0u, 0u);
+    CHECK(*pStateChangeCount == stateChangeCount + 1u);
+    endRenderPass(pGraphicsFrame, pRenderPass);
+    executeRenderPass(pGraphicsFrame, pRenderPass);
+
+    //FK: Destroyed indices stay reserved until the frame that destroyed them is done
+    destroyBindlessDescriptor(pGraphicsFrame, constantBufferIndex);
+    CHECK(createBindlessConstantBufferView(pGraphicsFrame, &constantBufferViewDesc) == 3u);
+    CHECK(pTable->statistics.usedDescriptorCount == 4u);
+    finishFrame(&renderContext, pGraphicsFrame);
+
+    for(uint32_t frameIndex = 0u; frameIndex < 2u; ++frameIndex)
+    {
+        pGraphicsFrame = beginNextFrame(&renderContext);
+        finishFrame(&renderContext, pGraphicsFrame);
+    }
+
+    pGraphicsFrame = beginNextFrame(&renderContext);
+    CHECK(pTable->statistics.usedDescriptorCount == 3u);
+    CHECK(createBindlessConstantBufferView(pGraphicsFrame, &constantBufferViewDesc) == constantBufferIndex);
+    CHECK(pTable->statistics.highWaterMarkDescriptorCount == 4u && pTable->statistics.failedAllocationCount == 0u);
+
+    destroyPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState);
+    destroyPipelineState(pGraphicsFrame->pRenderResourceCache, noCullPipelineState);
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+
+struct test_draw_constants_t
+{
+    float       worldMatrix[16];
+    uint32_t    materialIndex;
+};
+
+struct constant_allocation_context_t
+{
+    constant_buffer_allocator_t*    pAllocator;
+    constant_allocation_t           allocations[256];
+    volatile LONG                   nextWorkerIndex;
+};
+
+constexpr uint32_t constantAllocationWorkerCount = 4u;
+
+void CALLBACK allocateConstantsThreadpoolCallback(PTP_CALLBACK_INSTANCE pInstance, PVOID pContext, PTP_WORK pWork)
+{
+    UNUSED_PARAMETER(pInstance);
+    UNUSED_PARAMETER(pWork);
+
+    constant_allocation_context_t* pAllocationContext = (constant_allocation_context_t*)pContext;
+    const uint32_t workerIndex = (uint32_t)InterlockedIncrement(&pAllocationContext->nextWorkerIndex) - 1u;
+    const uint32_t allocationCountPerWorker = 256u / constantAllocationWorkerCount;
+    for(uint32_t allocationIndex = 0u; allocationIndex < allocationCountPerWorker; ++allocationIndex)
+    {
+        //FK: The whole buffer never fits since the first block is taken, failing to allocate it must not make allocations that fit fail
+        allocateFromConstantBuffer(pAllocationContext->pAllocator, pAllocationContext->pAllocator->sizeInBytes);
+        pAllocationContext->allocations[workerIndex * allocationCountPerWorker + allocationIndex] = allocateFromConstantBuffer(pAllocationContext->pAllocator, constantBufferAlignmentInBytes);
+    }
+}
+
+void testConstantBufferAllocator()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 2u));
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+    constant_buffer_allocator_t* pAllocator = &pGraphicsFrame->constantBufferAllocator;
+
+    //FK: Every allocation starts at a 256 byte boundary, sizes get rounded up
+    const constant_allocation_t smallAllocation = allocateConstants(pGraphicsFrame, 16u);
+    const constant_allocation_t exactAllocation = allocateConstants(pGraphicsFrame, 256u);
+    const constant_allocation_t largeAllocation = allocateConstants(pGraphicsFrame, 300u);
+    CHECK(smallAllocation.gpuVirtualAddress == pAllocator->gpuBaseAddress);
+    CHECK(exactAllocation.gpuVirtualAddress == pAllocator->gpuBaseAddress + 256u);
+    CHECK(largeAllocation.gpuVirtualAddress == pAllocator->gpuBaseAddress + 512u);
+    CHECK(largeAllocation.sizeInBytes == 512u && pAllocator->usedSizeInBytes == 1024);
+    CHECK((smallAllocation.gpuVirtualAddress % constantBufferAlignmentInBytes) == 0u);
+
+    //FK: Typed allocations get written straight into the mapped buffer
+    D3D12_GPU_VIRTUAL_ADDRESS drawConstantsAddress = 0u;
+    test_draw_constants_t* pDrawConstants = allocateConstants<test_draw_constants_t>(pGraphicsFrame, &drawConstantsAddress);
+    CHECK(pDrawConstants != nullptr && drawConstantsAddress == pAllocator->gpuBaseAddress + 1024u);
+    pDrawConstants->materialIndex = 42u;
+    CHECK(((const test_draw_constants_t*)(pAllocator->pMappedData + 1024u))->materialIndex == 42u);
+
+    //FK: Constant buffers get bound by register, the bound pipeline state knows which root parameter that is
+    D3D12_ROOT_PARAMETER rootParameters[2] = {};
+    for(uint32_t parameterIndex = 0u; parameterIndex < 2u; ++parameterIndex)
+    {
+        rootParameters[parameterIndex].ParameterType                = D3D12_ROOT_PARAMETER_TYPE_CBV;
+        rootParameters[parameterIndex].ShaderVisibility             = D3D12_SHADER_VISIBILITY_ALL;
+        rootParameters[parameterIndex].Descriptor.ShaderRegister    = parameterIndex;
+        rootParameters[parameterIndex].Descriptor.RegisterSpace     = 1u;
+    }
+
+    D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = createDefaultRootSignatureDesc();
+    rootSignatureDesc.NumParameters = 2u;
+    rootSignatureDesc.pParameters   = rootParameters;
+    graphics_pipeline_state_parameters_t parameters = createPipelineStateTestParameters(pGraphicsFrame);
+    parameters.pRootSignatureDesc = &rootSignatureDesc;
+
+    //FK: The pipeline state table grows once before and once while the pass is recording, which frees the memory of the
+    //    bound pipeline state. The pass has to resolve registers from its own copy of the bindings.
+    const base_resource_table_t* pPipelineStateTable = &pGraphicsFrame->pRenderResourceCache->pipelineStates;
+    const uint32_t initialCapacity = pPipelineStateTable->capacity;
+    const uint32_t growingPipelineStateCount = initialCapacity * 3u;
+    graphics_pipeline_state_handle_t* pGrowingPipelineStates = (graphics_pipeline_state_handle_t*)malloc(sizeof(graphics_pipeline_state_handle_t) * growingPipelineStateCount);
+    graphics_pipeline_state_parameters_t growingParameters = parameters;
+    for(uint32_t pipelineStateIndex = 0u; pipelineStateIndex < initialCapacity; ++pipelineStateIndex)
+    {
+        growingParameters.rasterizerDesc.DepthBias = (int32_t)pipelineStateIndex + 1;
+        pGrowingPipelineStates[pipelineStateIndex] = createGraphicsPipelineState(pGraphicsFrame, &growingParameters);
+    }
+
+    const graphics_pipeline_state_handle_t pipelineState = createGraphicsPipelineState(pGraphicsFrame, &parameters);
+    const graphics_pipeline_state_t* pPipelineState = getPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState);
+    CHECK(pPipelineState != nullptr && getRootParameterIndex(pPipelineState, shader_resource_binding_constant_buffer, 1u, 1u) == 1u);
+
+    render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, "Constant Buffer Pass", nullptr);
+    setPipelineState(pRenderPass, pipelineState);
+
+    CHECK(pPipelineStateTable->capacity == initialCapacity * 2u);
+    for(uint32_t pipelineStateIndex = initialCapacity; pipelineStateIndex < growingPipelineStateCount; ++pipelineStateIndex)
+    {
+        growingParameters.rasterizerDesc.DepthBias = (int32_t)pipelineStateIndex + 1;
+        pGrowingPipelineStates[pipelineStateIndex] = createGraphicsPipelineState(pGraphicsFrame, &growingParameters);
+    }
+    CHECK(pPipelineStateTable->capacity > initialCapacity * 2u);
+
+    const uint64_t stateChangeCount = pRenderPass->pGraphicsCommandList->recorded.stateChangeCount;
+    setConstantBuffer(pRenderPass, 1u, 1u, drawConstantsAddress);
+    CHECK(pRenderPass->pGraphicsCommandList->recorded.stateChangeCount == stateChangeCount + 1u);
+
+    //FK: Registers the pipeline state doesn't bind don't get set
+    setConstantBuffer(pRenderPass, 2u, 1u, drawConstantsAddress);
+    CHECK(pRenderPass->pGraphicsCommandList->recorded.stateChangeCount == stateChangeCount + 1u);
+    endRenderPass(pGraphicsFrame, pRenderPass);
+    executeRenderPass(pGraphicsFrame, pRenderPass);
+    destroyPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState);
+    for(uint32_t pipelineStateIndex = 0u; pipelineStateIndex < growingPipelineStateCount; ++pipelineStateIndex)
+    {
+        destroyPipelineState(pGraphicsFrame->pRenderResourceCache, pGrowingPipelineStates[pipelineStateIndex]);
+    }
+    free(pGrowingPipelineStates);
+    finishFrame(&renderContext, pGraphicsFrame);
+
+    //FK: The buffer of a frame gets reset once the frame comes around again
+    graphics_frame_t* pOtherGraphicsFrame = beginNextFrame(&renderContext);
+    CHECK(pOtherGraphicsFrame != pGraphicsFrame && pOtherGraphicsFrame->constantBufferAllocator.gpuBaseAddress != pAllocator->gpuBaseAddress);
+    finishFrame(&renderContext, pOtherGraphicsFrame);
+    pGraphicsFrame = beginNextFrame(&renderContext);
+    CHECK(pAllocator->usedSizeInBytes == 0 && pAllocator->highWaterMarkInBytes == 1280u);
+    CHECK(allocateConstants(pGraphicsFrame, 64u).gpuVirtualAddress == pAllocator->gpuBaseAddress);
+    finishFrame(&renderContext, pGraphicsFrame);
+
+    //FK: Exhausted buffers fail without handing out memory twice
+    constant_buffer_allocator_t smallAllocator = {};
+    CHECK(createConstantBufferAllocator(&smallAllocator, renderContext.pDevice, 1000u));
+    CHECK(smallAllocator.sizeInBytes == 1024u);
+    CHECK(allocateFromConstantBuffer(&smallAllocator, 512u).pData != nullptr);
+    CHECK(allocateFromConstantBuffer(&smallAllocator, 768u).pData == nullptr);
+    CHECK(allocateFromConstantBuffer(&smallAllocator, 2048u).pData == nullptr);
+    const constant_allocation_t lastAllocation = allocateFromConstantBuffer(&smallAllocator, 512u);
+    CHECK(lastAllocation.gpuVirtualAddress == smallAllocator.gpuBaseAddress + 512u);
+    CHECK(allocateFromConstantBuffer(&smallAllocator, 1u).pData == nullptr);
+    CHECK(smallAllocator.failedAllocationCount == 3 && smallAllocator.usedSizeInBytes == 1024);
+    resetConstantBufferAllocator(&smallAllocator);
+    CHECK(smallAllocator.highWaterMarkInBytes == 1024u && smallAllocator.failedAllocationCount == 0);
+    destroyConstantBufferAllocator(&smallAllocator);
+
+    //FK: Allocations from multiple threads that exactly fill the rest of the buffer all succeed and never overlap
+    constant_buffer_allocator_t sharedAllocator = {};
+    CHECK(createConstantBufferAllocator(&sharedAllocator, renderContext.pDevice, 257u * constantBufferAlignmentInBytes));
+    CHECK(allocateFromConstantBuffer(&sharedAllocator, constantBufferAlignmentInBytes).gpuVirtualAddress == sharedAllocator.gpuBaseAddress);
+    constant_allocation_context_t allocationContext = {};
+    allocationContext.pAllocator = &sharedAllocator;
+    PTP_WORK pWork = CreateThreadpoolWork(allocateConstantsThreadpoolCallback, &allocationContext, nullptr);
+    for(uint32_t workerIndex = 0u; workerIndex < constantAllocationWorkerCount; ++workerIndex)
+    {
+        SubmitThreadpoolWork(pWork);
+    }
+    WaitForThreadpoolWorkCallbacks(pWork, FALSE);
+    CloseThreadpoolWork(pWork);
+
+    bool isBlockAllocated[256] = {};
+    for(uint32_t allocationIndex = 0u; allocationIndex < 256u; ++allocationIndex)
+    {
+        const constant_allocation_t* pAllocation = allocationContext.allocations + allocationIndex;
+        const uint64_t blockIndex = (pAllocation->gpuVirtualAddress - sharedAllocator.gpuBaseAddress) / constantBufferAlignmentInBytes - 1u;
+        CHECK(pAllocation->pData != nullptr && blockIndex < 256u && !isBlockAllocated[blockIndex & 255u]);
+        isBlockAllocated[blockIndex & 255u] = true;
+    }
+    CHECK(sharedAllocator.usedSizeInBytes == (LONG64)sharedAllocator.sizeInBytes);
+    CHECK(sharedAllocator.failedAllocationCount == 256);
+    destroyConstantBufferAllocator(&sharedAllocator);
+
+    shutdownRenderContext(&renderContext);
+}
+
+struct test_object_constants_t
+{
+    uint32_t objectIndex;
+    uint32_t materialIndex;
+};
+
+void testDrawConstants()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 2u));
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+
+    //FK: Draw constants are part of the root signature, so they end up with a root signature of their own
+    graphics_pipeline_state_parameters_t parameters = createPipelineStateTestParameters(pGraphicsFrame);
+    graphics_pipeline_state_parameters_t drawConstantsParameters = parameters;
+    drawConstantsParameters.drawConstantCount = 3u;
+    const graphics_pipeline_state_handle_t pipelineState = createGraphicsPipelineState(pGraphicsFrame, &parameters);
+    const graphics_pipeline_state_handle_t drawConstantsPipelineState = createGraphicsPipelineState(pGraphicsFrame, &drawConstantsParameters);
+    const graphics_pipeline_state_t* pPipelineState = getPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState);
+    const graphics_pipeline_state_t* pDrawConstantsPipelineState = getPipelineState(pGraphicsFrame->pRenderResourceCache, drawConstantsPipelineState);
+    CHECK(pPipelineState != nullptr && pDrawConstantsPipelineState != nullptr);
+    CHECK(!isSamePipelineState(pipelineState, drawConstantsPipelineState) && pPipelineState->pRootSignature != pDrawConstantsPipelineState->pRootSignature);
+    CHECK(pPipelineState->drawConstantCount == 0u && pDrawConstantsPipelineState->drawConstantCount == 3u);
+
+    render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, "Draw Constants Pass", nullptr);
+    const null_device_statistics_t* pRecorded = &pRenderPass->pGraphicsCommandList->recorded;
+    const state_filter_statistics_t* pFilterStatistics = &pRenderPass->stateCache.statistics;
+    setPipelineState(pRenderPass, drawConstantsPipelineState);
+    const uint32_t issuedCallCount = pFilterStatistics->issuedCallCount;
+    const uint32_t skippedCallCount = pFilterStatistics->skippedCallCount;
+
+    //FK: Only the range of constants that changed gets set
+    const uint32_t firstConstants[] = {1u, 2u, 3u};
+    const uint32_t secondConstants[] = {1u, 5u, 3u};
+    const uint32_t thirdConstants[] = {7u, 5u, 8u};
+    setDrawConstants(pRenderPass, firstConstants, 3u);
+    CHECK(pRecorded->rootConstantCount == 3u);
+    setDrawConstants(pRenderPass, firstConstants, 3u);
+    CHECK(pRecorded->rootConstantCount == 3u);
+    setDrawConstants(pRenderPass, secondConstants, 3u);
+    CHECK(pRecorded->rootConstantCount == 4u);
+    setDrawConstants(pRenderPass, thirdConstants, 3u);
+    CHECK(pRecorded->rootConstantCount == 7u);
+    setDrawConstants(pRenderPass, &thirdConstants[2], 1u, 2u);
+    CHECK(pRecorded->rootConstantCount == 7u);
+    CHECK(pFilterStatistics->issuedCallCount == issuedCallCount + 3u && pFilterStatistics->skippedCallCount == skippedCallCount + 2u);
+
+    //FK: Typed constants get split into 32 bit values
+    const test_object_constants_t objectConstants = {7u, 6u};
+    setDrawConstants(pRenderPass, objectConstants);
+    CHECK(pRecorded->rootConstantCount == 8u && pRenderPass->stateCache.drawConstants[1] == 6u);
+
+    //FK: Values that have been set before are unknown after the root signature changed, ~0u is a valid value as well
+    setPipelineState(pRenderPass, pipelineState);
+    setPipelineState(pRenderPass, drawConstantsPipelineState);
+    setDrawConstants(pRenderPass, thirdConstants, 3u);
+    CHECK(pRecorded->rootConstantCount == 11u);
+    const uint32_t invalidIndex = invalidDescriptorIndex;
+    setPipelineState(pRenderPass, pipelineState);
+    setPipelineState(pRenderPass, drawConstantsPipelineState);
+    setDrawConstants(pRenderPass, &invalidIndex, 1u);
+    CHECK(pRecorded->rootConstantCount == 12u);
+
+    drawInstanced(pRenderPass, 3u, 1u, 0u, 0u);
+    endRenderPass(pGraphicsFrame, pRenderPass);
+    executeRenderPass(pGraphicsFrame, pRenderPass);
+
+    destroyPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState);
+    destroyPipelineState(pGraphicsFrame->pRenderResourceCache, drawConstantsPipelineState);
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+
+vertex_buffer_handle_t createTestVertexBuffer(graphics_frame_t* pGraphicsFrame)
+{
+    const float vertices[9] = {0.0f};
+    const upload_buffer_t uploadBuffer = createUploadBuffer(pGraphicsFrame, (void*)vertices, sizeof(vertices));
+    return createVertexBuffer(pGraphicsFrame, &uploadBuffer);
+}
+
+void testDrawQueue()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 2u));
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+
+    graphics_pipeline_state_parameters_t parameters = createPipelineStateTestParameters(pGraphicsFrame);
+    parameters.drawConstantCount = 1u;
+    graphics_pipeline_state_parameters_t noCullParameters = parameters;
+    noCullParameters.rasterizerDesc.CullMode = D3D12_CULL_MODE_NONE;
+    const graphics_pipeline_state_handle_t pipelineStates[2] = {createGraphicsPipelineState(pGraphicsFrame, &parameters), createGraphicsPipelineState(pGraphicsFrame, &noCullParameters)};
+    const vertex_buffer_handle_t vertexBuffers[2] = {createTestVertexBuffer(pGraphicsFrame), createTestVertexBuffer(pGraphicsFrame)};
+    CHECK(!isInvalidResourceHandle(pipelineStates[1]) && !isInvalidResourceHandle(vertexBuffers[1]));
+
+    //FK: pipeline state, vertex buffer, layer and depth of every draw in the order they get queued
+    const uint32_t drawCount = 6u;
+    const uint32_t drawPipelineStates[drawCount] = {1u, 0u, 1u, 0u, 0u, 0u};
+    const uint32_t drawVertexBuffers[drawCount] = {1u, 0u, 0u, 0u, 1u, 0u};
+    const uint8_t drawLayers[drawCount] = {0u, 0u, 0u, 0u, 0u, 1u};
+    const float drawDepths[drawCount] = {0.5f, 0.9f, 0.1f, 0.2f, 0.3f, 0.0f};
+
+    render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, "Draw Queue Pass", nullptr);
+    const null_device_statistics_t* pRecorded = &pRenderPass->pGraphicsCommandList->recorded;
+    const uint64_t stateChangeCount = pRecorded->stateChangeCount;
+    for(uint32_t drawIndex = 0u; drawIndex < drawCount; ++drawIndex)
+    {
+        queued_draw_t draw = {};
+        draw.pipelineState          = pipelineStates[drawPipelineStates[drawIndex]];
+        draw.vertexBuffer           = vertexBuffers[drawVertexBuffers[drawIndex]];
+        draw.vertexFormat           = parameters.vertexFormat;
+        draw.vertexCountPerInstance = 3u;
+        draw.instanceCount          = 1u;
+        draw.drawConstants[0]       = drawIndex;
+        draw.drawConstantCount      = 1u;
+        CHECK(queueDraw(pRenderPass, draw, drawLayers[drawIndex], drawDepths[drawIndex]));
+    }
+
+    //FK: Nothing gets recorded until the pass ends
+    CHECK(pRecorded->stateChangeCount == stateChangeCount && pRecorded->drawCallCount == 0u);
+    endRenderPass(pGraphicsFrame, pRenderPass);
+
+    //FK: Sorted: (0, 0) (0, 0) (0, 1) (1, 0) (1, 1) and (0, 0) in the next layer. That's 3 pipeline states, 1 root signature,
+    //    5 vertex buffers and 6 draw constants instead of 5 pipeline states, 4 root signatures, 6 vertex buffers and 6 draw constants.
+    CHECK(pRecorded->drawCallCount == drawCount);
+    CHECK(pRecorded->stateChangeCount == stateChangeCount + 3u + 1u + 5u + 6u);
+    CHECK(pRecorded->rootConstantCount == drawCount);
+    CHECK(pRenderPass->drawQueue.drawCount == 0u && pRenderPass->drawQueue.statistics.queuedDrawCount == drawCount);
+    CHECK(pRenderPass->drawQueue.capacity == initialDrawQueueCapacity);
+    executeRenderPass(pGraphicsFrame, pRenderPass);
+
+    //FK: Draws with a pipeline state that isn't ready get skipped
+    pRenderPass = startRenderPass(pGraphicsFrame, "Draw Queue Pass", nullptr);
+    queued_draw_t invalidDraw = {};
+    invalidDraw.pipelineState   = createInvalidResourceHandle<graphics_pipeline_state_handle_t>();
+    invalidDraw.vertexBuffer    = vertexBuffers[0];
+    invalidDraw.vertexFormat    = parameters.vertexFormat;
+    invalidDraw.instanceCount   = 1u;
+    CHECK(queueDraw(pRenderPass, invalidDraw, createDrawSortKey(0u, invalidDraw.pipelineState, invalidDraw.vertexBuffer, 0.0f)));
+    endRenderPass(pGraphicsFrame, pRenderPass);
+    CHECK(pRenderPass->pGraphicsCommandList->recorded.drawCallCount == 0u && pRenderPass->pipelineStateReadinessStatistics.skippedDrawCount == 1u);
+    executeRenderPass(pGraphicsFrame, pRenderPass);
+
+    destroyPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineStates[0]);
+    destroyPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineStates[1]);
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+
+void testVertexBufferUploads()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 2u));
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+    const base_resource_table_t* pVertexBuffers = &pGraphicsFrame->pRenderResourceCache->vertexBuffers;
+
+    //FK: An upload buffer that doesn't fit into the ring buffer doesn't have any data to copy from
+    const upload_buffer_t exhaustedUploadBuffer = createUploadBuffer(pGraphicsFrame, (uint32_t)renderContext.uploadRingBuffer.allocator.sizeInBytes + 1u);
+    CHECK(exhaustedUploadBuffer.pData == nullptr);
+    CHECK(isInvalidResourceHandle(createVertexBuffer(pGraphicsFrame, &exhaustedUploadBuffer)));
+
+    //FK: Ranges that reach past the end of the upload buffer get rejected instead of copying from the next allocation
+    const float vertices[9] = {0.0f};
+    const upload_buffer_t uploadBuffer = createUploadBuffer(pGraphicsFrame, (void*)vertices, sizeof(vertices));
+    CHECK(isInvalidResourceHandle(createVertexBuffer(pGraphicsFrame, &uploadBuffer, sizeof(vertices) + 4u)));
+    CHECK(isInvalidResourceHandle(createVertexBuffer(pGraphicsFrame, &uploadBuffer, sizeof(vertices))));
+    CHECK(isInvalidResourceHandle(createVertexBuffer(pGraphicsFrame, &uploadBuffer, 12u, sizeof(vertices))));
+    CHECK(pVertexBuffers->aliveCount == 0u);
+
+    const vertex_buffer_handle_t vertexBuffer = createVertexBuffer(pGraphicsFrame, &uploadBuffer, 12u);
+    CHECK(!isInvalidResourceHandle(vertexBuffer));
+    CHECK(getVertexBuffer(pGraphicsFrame->pRenderResourceCache, vertexBuffer)->sizeInBytes == sizeof(vertices) - 12u);
+
+    destroyVertexBuffer(pGraphicsFrame->pRenderResourceCache, vertexBuffer);
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+
+void recordUploadWaitTestPasses(render_context_t* pRenderContext, graphics_frame_t* pGraphicsFrame, const vertex_buffer_handle_t vertexBuffer, const vertex_format_handle_t vertexFormat)
+{
+    for(uint32_t passIndex = 0u; passIndex < 2u; ++passIndex)
+    {
+        render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, "Upload Wait Pass", nullptr);
+        bindVertexBuffer(pRenderPass, vertexBuffer, vertexFormat, 0u);
+        endRenderPass(pGraphicsFrame, pRenderPass);
+        executeRenderPass(pGraphicsFrame, pRenderPass);
+    }
+
+    finishFrame(pRenderContext, pGraphicsFrame);
+}
+
+void testUploadBatchWaits()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 2u));
+
+    //FK: Keeps the copy queue busy, so the upload batch is still pending once the render passes get submitted
+    null_device_cost_model_t costModel = {};
+    costModel.commandListCostInNanoseconds = 20000000u;
+    setNullDeviceCostModel(renderContext.pDevice, &costModel);
+
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+    const vertex_format_handle_t vertexFormat = createPipelineStateTestParameters(pGraphicsFrame).vertexFormat;
+    const vertex_buffer_handle_t vertexBuffers[2] = {createTestVertexBuffer(pGraphicsFrame), createTestVertexBuffer(pGraphicsFrame)};
+    CHECK(!isInvalidResourceHandle(vertexBuffers[0]) && !isInvalidResourceHandle(vertexBuffers[1]));
+
+    //FK: Both copies go into one upload batch with a single signal, only the first pass that uses the batch waits for it
+    const null_device_statistics_t* pStatistics = getNullDeviceStatistics(renderContext.pDevice);
+    const null_device_statistics_t statisticsBeforeFrame = *pStatistics;
+    recordUploadWaitTestPasses(&renderContext, pGraphicsFrame, vertexBuffers[0], vertexFormat);
+    CHECK(pStatistics->copyCount == statisticsBeforeFrame.copyCount + 2u);
+    CHECK(pStatistics->signalCount == statisticsBeforeFrame.signalCount + 2u);
+    CHECK(pStatistics->waitCount == statisticsBeforeFrame.waitCount + 1u);
+
+    //FK: The direct queue already waited for the batch, so the next frame doesn't wait again
+    pGraphicsFrame = beginNextFrame(&renderContext);
+    recordUploadWaitTestPasses(&renderContext, pGraphicsFrame, vertexBuffers[0], vertexFormat);
+    CHECK(pStatistics->waitCount == statisticsBeforeFrame.waitCount + 1u);
+
+    pGraphicsFrame = beginNextFrame(&renderContext);
+    destroyVertexBuffer(pGraphicsFrame->pRenderResourceCache, vertexBuffers[0]);
+    destroyVertexBuffer(pGraphicsFrame->pRenderResourceCache, vertexBuffers[1]);
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+
+void testAsyncPipelineStates()
+{
+    render_context_t renderContext = {};
+    CHECK(createNullDeviceRenderContext(&renderContext, 2u));
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+
+    const pipeline_state_cache_statistics_t* pStatistics = &renderContext.renderResourceCache.pipelineStateCache.statistics;
+    const null_device_statistics_t* pDeviceStatistics = getNullDeviceStatistics(renderContext.pDevice);
+    render_resource_cache_t* pRenderResourceCache = pGraphicsFrame->pRenderResourceCache;
+
+    graphics_pipeline_state_parameters_t parameters = createPipelineStateTestParameters(pGraphicsFrame);
+    graphics_pipeline_state_parameters_t fallbackParameters = parameters;
+    fallbackParameters.rasterizerDesc.CullMode = D3D12_CULL_MODE_NONE;
+    const graphics_pipeline_state_handle_t fallbackPipelineState = createGraphicsPipelineState(pGraphicsFrame, &fallbackParameters);
+    const graphics_pipeline_state_handle_t invalidPipelineState = createInvalidResourceHandle<graphics_pipeline_state_handle_t>();
+
+    //FK: Requests return while the pipeline state is still compiling, requests for the same pipeline state share it
+    setNullPipelineStateCompilerCost(50000000u);
+    const graphics_pipeline_state_handle_t pipelineState = requestGraphicsPipelineState(pGraphicsFrame, &parameters);
+    CHECK(!isInvalidResourceHandle(pipelineState));
+    CHECK(getPipelineState(pRenderResourceCache, pipelineState)->status == pipeline_state_status_compiling);
+    CHECK(isSamePipelineState(requestGraphicsPipelineState(pGraphicsFrame, &parameters), pipelineState));
+    CHECK(pStatistics->compileJobCount == 1u && pStatistics->coalescedCount == 1u);
+
+    const uint64_t drawCallCountBeforeFrame = pDeviceStatistics->drawCallCount;
+    render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, "Async Pipeline State Pass", nullptr);
+    CHECK(trySetPipelineState(pRenderPass, pipelineState, fallbackPipelineState));
+    drawInstanced(pRenderPass, 3u, 1u, 0u, 0u);
+    CHECK(!trySetPipelineState(pRenderPass, pipelineState, invalidPipelineState));
+    drawInstanced(pRenderPass, 3u, 1u, 0u, 0u);
+    drawInstanced(pRenderPass, 3u, 1u, 0u, 0u);
+    endRenderPass(pGraphicsFrame, pRenderPass);
+    executeRenderPass(pGraphicsFrame, pRenderPass);
+
+    //FK: Pipeline states that finish compiling during a frame are only used from the next frame on
+    waitForPipelineStateCompileJobs(pRenderResourceCache);
+    setNullPipelineStateCompilerCost(0u);
+    CHECK(getPipelineState(pRenderResourceCache, pipelineState)->status == pipeline_state_status_ready);
+
+    pRenderPass = startRenderPass(pGraphicsFrame, "Async Pipeline State Pass", nullptr);
+    CHECK(!trySetPipelineState(pRenderPass, pipelineState, invalidPipelineState));
+    drawInstanced(pRenderPass, 3u, 1u, 0u, 0u);
+    endRenderPass(pGraphicsFrame, pRenderPass);
+    executeRenderPass(pGraphicsFrame, pRenderPass);
+
+    CHECK(pGraphicsFrame->pipelineStateReadinessStatistics.fallbackCount == 1u);
+    CHECK(pGraphicsFrame->pipelineStateReadinessStatistics.skippedDrawCount == 3u);
+    finishFrame(&renderContext, pGraphicsFrame);
+    CHECK(pDeviceStatistics->drawCallCount == drawCallCountBeforeFrame + 1u);
+
+    pGraphicsFrame = beginNextFrame(&renderContext);
+    pRenderPass = startRenderPass(pGraphicsFrame, "Async Pipeline State Pass", nullptr);
+    CHECK(trySetPipelineState(pRenderPass, pipelineState, fallbackPipelineState));
+    drawInstanced(pRenderPass, 3u, 1u, 0u, 0u);
+    CHECK(pRenderPass->pipelineStateReadinessStatistics.fallbackCount == 0u && pRenderPass->pipelineStateReadinessStatistics.skippedDrawCount == 0u);
+
+    //FK: Blocking requests for a pipeline state that is compiling wait for it, the frame still doesn't pick it up mid-frame
+    setNullPipelineStateCompilerCost(20000000u);
+    graphics_pipeline_state_parameters_t wireframeParameters = parameters;
+    wireframeParameters.rasterizerDesc.FillMode = D3D12_FILL_MODE_WIREFRAME;
+    const graphics_pipeline_state_handle_t wireframePipelineState = requestGraphicsPipelineState(pGraphicsFrame, &wireframeParameters);
+    CHECK(isSamePipelineState(createGraphicsPipelineState(pGraphicsFrame, &wireframeParameters), wireframePipelineState));
+    CHECK(getPipelineState(pRenderResourceCache, wireframePipelineState)->status == pipeline_state_status_ready);
+    CHECK(getPipelineState(pRenderResourceCache, wireframePipelineState)->completionIndex > pGraphicsFrame->pipelineStateCompletionIndex);
+    CHECK(!trySetPipelineState(pRenderPass, wireframePipelineState, invalidPipelineState));
+    endRenderPass(pGraphicsFrame, pRenderPass);
+    executeRenderPass(pGraphicsFrame, pRenderPass);
+
+    //FK: Pipeline states created on the thread of the frame are usable by the frame right away
+    graphics_pipeline_state_parameters_t frontCounterClockwiseParameters = parameters;
+    frontCounterClockwiseParameters.rasterizerDesc.FrontCounterClockwise = TRUE;
+    const graphics_pipeline_state_handle_t frontCounterClockwisePipelineState = createGraphicsPipelineState(pGraphicsFrame, &frontCounterClockwiseParameters);
+    pRenderPass = startRenderPass(pGraphicsFrame, "Async Pipeline State Pass", nullptr);
+    CHECK(trySetPipelineState(pRenderPass, frontCounterClockwisePipelineState, invalidPipelineState));
+    endRenderPass(pGraphicsFrame, pRenderPass);
+    executeRenderPass(pGraphicsFrame, pRenderPass);
+
+    //FK: Pipeline states can be destroyed while they're still compiling
+    const uint64_t pipelineStateCountBeforeDestroy = pDeviceStatistics->pipelineStateCount;
+    graphics_pipeline_state_parameters_t depthBiasParameters = parameters;
+    depthBiasParameters.rasterizerDesc.DepthBias = 7;
+    const graphics_pipeline_state_handle_t depthBiasPipelineState = requestGraphicsPipelineState(pGraphicsFrame, &depthBiasParameters);
+    destroyPipelineState(pRenderResourceCache, depthBiasPipelineState);
+    waitForPipelineStateCompileJobs(pRenderResourceCache);
+    setNullPipelineStateCompilerCost(0u);
+    CHECK(pDeviceStatistics->pipelineStateCount == pipelineStateCountBeforeDestroy + 1u);
+    CHECK(getPipelineState(pRenderResourceCache, depthBiasPipelineState) == nullptr);
+
+    graphics_pipeline_state_parameters_t invalidParameters = parameters;
+    invalidParameters.vertexShader = createInvalidResourceHandle<shader_binary_handle_t>();
+    CHECK(isInvalidResourceHandle(requestGraphicsPipelineState(pGraphicsFrame, &invalidParameters)));
+    finishFrame(&renderContext, pGraphicsFrame);
+
+    pGraphicsFrame = beginNextFrame(&renderContext);
+    pRenderPass = startRenderPass(pGraphicsFrame, "Async Pipeline State Pass", nullptr);
+    CHECK(trySetPipelineState(pRenderPass, wireframePipelineState, invalidPipelineState));
+    endRenderPass(pGraphicsFrame, pRenderPass);
+    executeRenderPass(pGraphicsFrame, pRenderPass);
+
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+
+bool createPipelineLibraryTestRenderContext(render_context_t* pRenderContext, const char* pPipelineLibraryFilePath)
+{
+    render_context_parameters_t parameters = createDefaultRenderContextParameters(nullptr, 2u, 1280u, 720u, false);
+    parameters.pPipelineLibraryFilePath = pPipelineLibraryFilePath;
+    parameters.limits.maxRenderPassCount = 64u;
+    return createRenderContext(pRenderContext, &parameters);
+}
+
+//FK: Creates pipelineStateCount pipeline states that only differ in their depth bias and returns what the pipeline library did
+pipeline_library_statistics_t createPipelineLibraryTestPipelineStates(const char* pPipelineLibraryFilePath, const uint32_t pipelineStateCount, uint64_t* pOutCompiledPipelineStateCount)
+{
+    render_context_t renderContext = {};
+    if(!createPipelineLibraryTestRenderContext(&renderContext, pPipelineLibraryFilePath))
+    {
+        CHECK(false);
+        return {};
+    }
+
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+    graphics_pipeline_state_parameters_t parameters = createPipelineStateTestParameters(pGraphicsFrame);
+    for(uint32_t pipelineStateIndex = 0u; pipelineStateIndex < pipelineStateCount; ++pipelineStateIndex)
+    {
+        parameters.rasterizerDesc.DepthBias = (int32_t)pipelineStateIndex;
+        CHECK(!isInvalidResourceHandle(createGraphicsPipelineState(pGraphicsFrame, &parameters)));
+    }
+
+    *pOutCompiledPipelineStateCount = getNullDeviceStatistics(renderContext.pDevice)->pipelineStateCount;
+    const pipeline_library_statistics_t statistics = renderContext.renderResourceCache.pipelineLibrary.statistics;
+
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+    return statistics;
+}
+
+void testPipelineLibrary()
+{
+    const char* pPipelineLibraryFilePath = "cpu_benchmark_shader_cache/test_pipeline_library.bin";
+    CreateDirectoryA("cpu_benchmark_shader_cache", nullptr);
+    remove(pPipelineLibraryFilePath);
+
+    //FK: Cold start compiles everything and writes the library on shutdown
+    uint64_t compiledPipelineStateCount = 0u;
+    pipeline_library_statistics_t statistics = createPipelineLibraryTestPipelineStates(pPipelineLibraryFilePath, 2u, &compiledPipelineStateCount);
+    CHECK(statistics.storedCount == 2u && statistics.loadedCount == 0u && statistics.invalidatedCount == 0u);
+    CHECK(compiledPipelineStateCount == 2u);
+
+    //FK: Warm start loads the known pipeline states and adds the new one
+    statistics = createPipelineLibraryTestPipelineStates(pPipelineLibraryFilePath, 3u, &compiledPipelineStateCount);
+    CHECK(statistics.loadedCount == 2u && statistics.storedCount == 1u);
+    CHECK(compiledPipelineStateCount == 1u);
+
+    statistics = createPipelineLibraryTestPipelineStates(pPipelineLibraryFilePath, 3u, &compiledPipelineStateCount);
+    CHECK(statistics.loadedCount == 3u && statistics.storedCount == 0u);
+    CHECK(compiledPipelineStateCount == 0u);
+
+    //FK: Driver updates and different adapters throw the library away and start over
+    setNullAdapter(1u, 2u);
+    statistics = createPipelineLibraryTestPipelineStates(pPipelineLibraryFilePath, 3u, &compiledPipelineStateCount);
+    CHECK(statistics.invalidatedCount == 1u && statistics.loadedCount == 0u && statistics.storedCount == 3u);
+    CHECK(compiledPipelineStateCount == 3u);
+
+    statistics = createPipelineLibraryTestPipelineStates(pPipelineLibraryFilePath, 3u, &compiledPipelineStateCount);
+    CHECK(statistics.invalidatedCount == 0u && statistics.loadedCount == 3u);
+
+    setNullAdapter(2u, 2u);
+    statistics = createPipelineLibraryTestPipelineStates(pPipelineLibraryFilePath, 3u, &compiledPipelineStateCount);
+    CHECK(statistics.invalidatedCount == 1u && statistics.loadedCount == 0u && statistics.storedCount == 3u);
+
+    //FK: Invalidated libraries get rewritten even if no pipeline state got stored
+    setNullAdapter(3u, 2u);
+    statistics = createPipelineLibraryTestPipelineStates(pPipelineLibraryFilePath, 0u, &compiledPipelineStateCount);
+    CHECK(statistics.invalidatedCount == 1u && statistics.storedCount == 0u);
+    statistics = createPipelineLibraryTestPipelineStates(pPipelineLibraryFilePath, 0u, &compiledPipelineStateCount);
+    CHECK(statistics.invalidatedCount == 0u);
+    setNullAdapter(1u, 1u);
+
+    //FK: Corrupt files get recreated
+    writeTestFile(pPipelineLibraryFilePath, "not a pipeline library");
+    statistics = createPipelineLibraryTestPipelineStates(pPipelineLibraryFilePath, 1u, &compiledPipelineStateCount);
+    CHECK(statistics.invalidatedCount == 1u && statistics.storedCount == 1u);
+
+    statistics = createPipelineLibraryTestPipelineStates(pPipelineLibraryFilePath, 1u, &compiledPipelineStateCount);
+    CHECK(statistics.invalidatedCount == 0u && statistics.loadedCount == 1u);
+}
+
+void benchmarkShaderBatchCompilation()
+{
+    render_context_t renderContext = {};
+    if(!createShaderBatchTestRenderContext(&renderContext))
+    {
+        CHECK(false);
+        return;
+    }
+
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+
+    const uint32_t shaderCount = 256u;
+    char defines[shaderCount][32];
+    shader_compilation_parameters_t parameters[shaderCount];
+    shader_binary_handle_t shaderBinaries[shaderCount];
+    createShaderPermutationParameters(parameters, defines, shaderCount);
+
+    //FK: 1ms per shader, real shaders take anywhere between a few ms and seconds
+    setNullShaderCompilerCost(1000000u);
+
+    benchmark_timer_t timer;
+    startBenchmarkTimer(&timer);
+    for(uint32_t shaderIndex = 0u; shaderIndex < shaderCount; ++shaderIndex)
+    {
+        shaderBinaries[shaderIndex] = loadAndCompileShaderCodeFromFile(pGraphicsFrame, parameters + shaderIndex);
+    }
+    const double serialTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+
+    for(uint32_t shaderIndex = 0u; shaderIndex < shaderCount; ++shaderIndex)
+    {
+        destroyShaderBinary(pGraphicsFrame, shaderBinaries[shaderIndex]);
+    }
+
+    startBenchmarkTimer(&timer);
+    CHECK(compileShaderBatch(pGraphicsFrame, parameters, shaderCount, shaderBinaries, nullptr, nullptr));
+    const double batchTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+
+    setNullShaderCompilerCost(0u);
+
+    printBenchmarkResult("shader compilation (serial, 1ms per shader)", serialTimeInMs, shaderCount);
+    printBenchmarkResult("shader compilation (batch, 1ms per shader)", batchTimeInMs, shaderCount);
+    printf("    compiler workers: %u, speedup: %.2fx\n", renderContext.shaderCompilerContext.workerCount, serialTimeInMs / batchTimeInMs);
+
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+void benchmarkPipelineStateCache()
+{
+    render_context_t renderContext = {};
+    if(!createNullDeviceRenderContext(&renderContext, 2u))
+    {
+        CHECK(false);
+        return;
+    }
+
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+    graphics_pipeline_state_parameters_t parameters = createPipelineStateTestParameters(pGraphicsFrame);
+
+    //FK: 1ms per pipeline state, real drivers take anywhere between a few ms and hundreds of ms
+    setNullPipelineStateCompilerCost(1000000u);
+
+    const uint32_t pipelineStateCount = 16u;
+    const uint32_t requestsPerPipelineState = 1000u;
+    graphics_pipeline_state_handle_t pipelineStates[pipelineStateCount];
+
+    benchmark_timer_t timer;
+    startBenchmarkTimer(&timer);
+    for(uint32_t pipelineStateIndex = 0u; pipelineStateIndex < pipelineStateCount; ++pipelineStateIndex)
+    {
+        parameters.rasterizerDesc.DepthBias = (int32_t)pipelineStateIndex;
+        pipelineStates[pipelineStateIndex] = createGraphicsPipelineState(pGraphicsFrame, &parameters);
+    }
+    const double missTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+
+    startBenchmarkTimer(&timer);
+    for(uint32_t requestIndex = 0u; requestIndex < requestsPerPipelineState; ++requestIndex)
+    {
+        for(uint32_t pipelineStateIndex = 0u; pipelineStateIndex < pipelineStateCount; ++pipelineStateIndex)
+        {
+            parameters.rasterizerDesc.DepthBias = (int32_t)pipelineStateIndex;
+            CHECK(isSamePipelineState(createGraphicsPipelineState(pGraphicsFrame, &parameters), pipelineStates[pipelineStateIndex]));
+            destroyPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineStates[pipelineStateIndex]);
+        }
+    }
+    const double hitTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+
+    setNullPipelineStateCompilerCost(0u);
+
+    const pipeline_state_cache_statistics_t* pStatistics = &renderContext.renderResourceCache.pipelineStateCache.statistics;
+    printBenchmarkResult("pipeline state creation (miss, 1ms per pipeline state)", missTimeInMs, pipelineStateCount);
+    printBenchmarkResult("pipeline state creation (cache hit)", hitTimeInMs, pipelineStateCount * requestsPerPipelineState);
+    printf("    hits: %u, misses: %u, hit rate: %.2f%%\n", pStatistics->hitCount, pStatistics->missCount, 100.0 * pStatistics->hitCount / (pStatistics->hitCount + pStatistics->missCount));
+
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+
+void benchmarkDescriptorAllocators()
+{
+    render_context_t renderContext = {};
+    if(!createNullDeviceRenderContext(&renderContext, 2u))
+    {
+        CHECK(false);
+        return;
+    }
+
+    const uint32_t liveAllocationCount = 256u;
+    const uint32_t iterationCount = 1000000u;
+    descriptor_allocation_t allocations[liveAllocationCount];
+
+    persistent_descriptor_allocator_t persistentAllocator = {};
+    CHECK(createPersistentDescriptorAllocator(&persistentAllocator, &renderContext.defaultAllocator, renderContext.pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, liveAllocationCount * 8u));
+    for(uint32_t allocationIndex = 0u; allocationIndex < liveAllocationCount; ++allocationIndex)
+    {
+        CHECK(allocatePersistentDescriptors(&persistentAllocator, 1u + allocationIndex % 8u, &allocations[allocationIndex]));
+    }
+
+    //FK: Steady state of a streaming scene, one view gets released and another one gets created
+    benchmark_timer_t timer;
+    startBenchmarkTimer(&timer);
+    for(uint32_t iterationIndex = 0u; iterationIndex < iterationCount; ++iterationIndex)
+    {
+        descriptor_allocation_t* pAllocation = &allocations[(iterationIndex * 97u) % liveAllocationCount];
+        const uint32_t descriptorCount = pAllocation->count;
+        freePersistentDescriptors(&persistentAllocator, pAllocation);
+        allocatePersistentDescriptors(&persistentAllocator, descriptorCount, pAllocation);
+    }
+    const double persistentTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+    CHECK(persistentAllocator.statistics.failedAllocationCount == 0u);
+    destroyPersistentDescriptorAllocator(&persistentAllocator);
+
+    transient_descriptor_allocator_t* pTransientAllocator = &renderContext.transientDescriptorAllocator;
+    const uint32_t allocationsPerFrame = 1024u;
+    uint64_t frameFenceValue = 0u;
+
+    startBenchmarkTimer(&timer);
+    for(uint32_t iterationIndex = 0u; iterationIndex < iterationCount; ++iterationIndex)
+    {
+        allocateTransientDescriptors(pTransientAllocator, 4u, &allocations[0]);
+        if((iterationIndex + 1u) % allocationsPerFrame == 0u)
+        {
+            closeTransientDescriptorFrame(pTransientAllocator, ++frameFenceValue);
+            reclaimTransientDescriptors(pTransientAllocator, frameFenceValue - 1u);
+        }
+    }
+    const double transientTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+    CHECK(pTransientAllocator->statistics.failedAllocationCount == 0u);
+
+    printBenchmarkResult("persistent descriptor free + allocate", persistentTimeInMs, iterationCount);
+    printBenchmarkResult("transient descriptor allocate (4 descriptors)", transientTimeInMs, iterationCount);
+    printf("    transient high water mark: %u of %llu descriptors\n", pTransientAllocator->statistics.highWaterMarkDescriptorCount, (unsigned long long)pTransientAllocator->ringBuffer.sizeInBytes);
+
+    shutdownRenderContext(&renderContext);
+}
+
+void benchmarkConstantBufferAllocator()
+{
+    render_context_t renderContext = {};
+    if(!createNullDeviceRenderContext(&renderContext, 2u))
+    {
+        CHECK(false);
+        return;
+    }
+
+    const uint32_t frameCount = 64u;
+    const uint32_t drawCountPerFrame = 4096u;
+    test_draw_constants_t drawConstants = {};
+    uint64_t failedAllocationCount = 0u;
+
+    //FK: Per draw constants get written in place into the frame's constant buffer
+    benchmark_timer_t timer;
+    startBenchmarkTimer(&timer);
+    for(uint32_t frameIndex = 0u; frameIndex < frameCount; ++frameIndex)
+    {
+        graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+        for(uint32_t drawIndex = 0u; drawIndex < drawCountPerFrame; ++drawIndex)
+        {
+            D3D12_GPU_VIRTUAL_ADDRESS gpuVirtualAddress = 0u;
+            test_draw_constants_t* pDrawConstants = allocateConstants<test_draw_constants_t>(pGraphicsFrame, &gpuVirtualAddress);
+            if(pDrawConstants == nullptr)
+            {
+                ++failedAllocationCount;
+                continue;
+            }
+
+            drawConstants.materialIndex = drawIndex;
+            *pDrawConstants = drawConstants;
+        }
+        finishFrame(&renderContext, pGraphicsFrame);
+    }
+    const double constantBufferTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+
+    //FK: Same constants going through the general purpose upload ring buffer
+    startBenchmarkTimer(&timer);
+    for(uint32_t frameIndex = 0u; frameIndex < frameCount; ++frameIndex)
+    {
+        graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+        for(uint32_t drawIndex = 0u; drawIndex < drawCountPerFrame; ++drawIndex)
+        {
+            drawConstants.materialIndex = drawIndex;
+            const upload_buffer_t uploadBuffer = createUploadBuffer(pGraphicsFrame, &drawConstants, sizeof(drawConstants));
+            failedAllocationCount += uploadBuffer.pData == nullptr ? 1u : 0u;
+        }
+        finishFrame(&renderContext, pGraphicsFrame);
+    }
+    const double uploadBufferTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+    CHECK(failedAllocationCount == 0u);
+
+    printBenchmarkResult("per draw constants (frame constant buffer)", constantBufferTimeInMs, frameCount * drawCountPerFrame);
+    printBenchmarkResult("per draw constants (upload buffer)", uploadBufferTimeInMs, frameCount * drawCountPerFrame);
+    printf("    constant buffer high water mark: %u of %u bytes\n", renderContext.graphicsFramesCollection.pGraphicsFrames[0].constantBufferAllocator.highWaterMarkInBytes, renderContext.graphicsFramesCollection.pGraphicsFrames[0].constantBufferAllocator.sizeInBytes);
+
+    shutdownRenderContext(&renderContext);
+}
+
+double measureDrawConstantsFrames(render_context_t* pRenderContext, const graphics_pipeline_state_parameters_t* pParameters, const bool useRootConstants, const uint32_t frameCount, const uint32_t drawCountPerFrame)
+{
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(pRenderContext);
+    const graphics_pipeline_state_handle_t pipelineState = createGraphicsPipelineState(pGraphicsFrame, pParameters);
+    const graphics_pipeline_state_t* pPipelineState = getPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState);
+    finishFrame(pRenderContext, pGraphicsFrame);
+    CHECK(pPipelineState != nullptr);
+
+    benchmark_timer_t timer;
+    startBenchmarkTimer(&timer);
+    for(uint32_t frameIndex = 0u; frameIndex < frameCount; ++frameIndex)
+    {
+        pGraphicsFrame = beginNextFrame(pRenderContext);
+        render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, "Draw Constants Pass", nullptr);
+        setPipelineState(pRenderPass, pipelineState);
+        for(uint32_t drawIndex = 0u; drawIndex < drawCountPerFrame; ++drawIndex)
+        {
+            //FK: Objects are sorted by material, so the material index only changes every few draws
+            const test_object_constants_t objectConstants = {drawIndex, drawIndex / 16u};
+            if(useRootConstants)
+            {
+                setDrawConstants(pRenderPass, objectConstants);
+            }
+            else
+            {
+                D3D12_GPU_VIRTUAL_ADDRESS gpuVirtualAddress = 0u;
+                test_object_constants_t* pObjectConstants = allocateConstants<test_object_constants_t>(pGraphicsFrame, &gpuVirtualAddress);
+                *pObjectConstants = objectConstants;
+                setConstantBuffer(pRenderPass, 0u, 0u, gpuVirtualAddress);
+            }
+            drawInstanced(pRenderPass, 3u, 1u, 0u, 0u);
+        }
+        endRenderPass(pGraphicsFrame, pRenderPass);
+        executeRenderPass(pGraphicsFrame, pRenderPass);
+        finishFrame(pRenderContext, pGraphicsFrame);
+    }
+    const double timeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+
+    pGraphicsFrame = beginNextFrame(pRenderContext);
+    destroyPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineState);
+    finishFrame(pRenderContext, pGraphicsFrame);
+    return timeInMs;
+}
+
+void benchmarkDrawConstants()
+{
+    render_context_t renderContext = {};
+    if(!createNullDeviceRenderContext(&renderContext, 2u))
+    {
+        CHECK(false);
+        return;
+    }
+
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+    graphics_pipeline_state_parameters_t parameters = createPipelineStateTestParameters(pGraphicsFrame);
+    finishFrame(&renderContext, pGraphicsFrame);
+
+    D3D12_ROOT_PARAMETER constantBufferParameter = {};
+    constantBufferParameter.ParameterType       = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    constantBufferParameter.ShaderVisibility    = D3D12_SHADER_VISIBILITY_ALL;
+
+    D3D12_ROOT_SIGNATURE_DESC constantBufferRootSignatureDesc = createDefaultRootSignatureDesc();
+    constantBufferRootSignatureDesc.NumParameters   = 1u;
+    constantBufferRootSignatureDesc.pParameters     = &constantBufferParameter;
+
+    graphics_pipeline_state_parameters_t constantBufferParameters = parameters;
+    constantBufferParameters.pRootSignatureDesc = &constantBufferRootSignatureDesc;
+    graphics_pipeline_state_parameters_t drawConstantsParameters = parameters;
+    drawConstantsParameters.drawConstantCount = 2u;
+
+    const uint32_t frameCount = 64u;
+    const uint32_t drawCountPerFrame = 4096u;
+    const null_device_statistics_t* pDeviceStatistics = getNullDeviceStatistics(renderContext.pDevice);
+    const double constantBufferTimeInMs = measureDrawConstantsFrames(&renderContext, &constantBufferParameters, false, frameCount, drawCountPerFrame);
+    const uint64_t rootConstantCountBefore = pDeviceStatistics->rootConstantCount;
+    const double drawConstantsTimeInMs = measureDrawConstantsFrames(&renderContext, &drawConstantsParameters, true, frameCount, drawCountPerFrame);
+    const uint64_t rootConstantCount = pDeviceStatistics->rootConstantCount - rootConstantCountBefore;
+    CHECK(rootConstantCount < 2u * frameCount * drawCountPerFrame);
+
+    printBenchmarkResult("per draw constants (root CBV)", constantBufferTimeInMs, frameCount * drawCountPerFrame);
+    printBenchmarkResult("per draw constants (root constants)", drawConstantsTimeInMs, frameCount * drawCountPerFrame);
+    printf("    root constants set: %llu of %u\n", (unsigned long long)rootConstantCount, 2u * frameCount * drawCountPerFrame);
+
+    shutdownRenderContext(&renderContext);
+}
+
+struct benchmark_draw_t
+{
+    uint32_t pipelineStateIndex;
+    uint32_t vertexBufferIndex;
+    float    depth;
+};
+
+void benchmarkDrawQueue()
+{
+    render_context_t renderContext = {};
+    if(!createNullDeviceRenderContext(&renderContext, 2u))
+    {
+        CHECK(false);
+        return;
+    }
+
+    const uint32_t pipelineStateCount = 16u;
+    const uint32_t vertexBufferCount = 16u;
+    const uint32_t drawCount = 100000u;
+
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+    graphics_pipeline_state_parameters_t parameters = createPipelineStateTestParameters(pGraphicsFrame);
+    graphics_pipeline_state_handle_t pipelineStates[pipelineStateCount];
+    for(uint32_t pipelineStateIndex = 0u; pipelineStateIndex < pipelineStateCount; ++pipelineStateIndex)
+    {
+        parameters.rasterizerDesc.DepthBias = (int32_t)pipelineStateIndex;
+        pipelineStates[pipelineStateIndex] = createGraphicsPipelineState(pGraphicsFrame, &parameters);
+    }
+
+    vertex_buffer_handle_t vertexBuffers[vertexBufferCount];
+    for(uint32_t vertexBufferIndex = 0u; vertexBufferIndex < vertexBufferCount; ++vertexBufferIndex)
+    {
+        vertexBuffers[vertexBufferIndex] = createTestVertexBuffer(pGraphicsFrame);
+    }
+    finishFrame(&renderContext, pGraphicsFrame);
+
+    //FK: Scene traversal order, unrelated to materials and meshes
+    benchmark_draw_t* pDraws = (benchmark_draw_t*)allocateFromAllocator(&renderContext.defaultAllocator, sizeof(benchmark_draw_t) * drawCount);
+    uint32_t randomValue = 12345u;
+    for(uint32_t drawIndex = 0u; drawIndex < drawCount; ++drawIndex)
+    {
+        randomValue = randomValue * 1664525u + 1013904223u;
+        pDraws[drawIndex].pipelineStateIndex    = (randomValue >> 8u) % pipelineStateCount;
+        pDraws[drawIndex].vertexBufferIndex     = (randomValue >> 16u) % vertexBufferCount;
+        pDraws[drawIndex].depth                 = (float)(randomValue >> 24u) / 255.0f;
+    }
+
+    //FK: The first frames grow the draw queues of the render passes that get reused, only the frames after that get measured
+    const uint32_t warmupFrameCount = 4u;
+    const uint32_t frameCount = 8u;
+    benchmark_timer_t timer;
+    double immediateTimeInMs = 0.0;
+    uint64_t immediateStateChangeCount = 0u;
+    for(uint32_t frameIndex = 0u; frameIndex < warmupFrameCount + frameCount; ++frameIndex)
+    {
+        startBenchmarkTimer(&timer);
+        pGraphicsFrame = beginNextFrame(&renderContext);
+        render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, "Immediate Pass", nullptr);
+        for(uint32_t drawIndex = 0u; drawIndex < drawCount; ++drawIndex)
+        {
+            const benchmark_draw_t* pDraw = pDraws + drawIndex;
+            setPipelineState(pRenderPass, pipelineStates[pDraw->pipelineStateIndex]);
+            bindVertexBuffer(pRenderPass, vertexBuffers[pDraw->vertexBufferIndex], parameters.vertexFormat, 0u);
+            drawInstanced(pRenderPass, 3u, 1u, 0u, 0u);
+        }
+        endRenderPass(pGraphicsFrame, pRenderPass);
+        immediateStateChangeCount = pRenderPass->pGraphicsCommandList->recorded.stateChangeCount;
+        executeRenderPass(pGraphicsFrame, pRenderPass);
+        finishFrame(&renderContext, pGraphicsFrame);
+        immediateTimeInMs += frameIndex >= warmupFrameCount ? stopBenchmarkTimerInMilliseconds(&timer) : 0.0;
+    }
+
+    double queuedTimeInMs = 0.0;
+    uint64_t queuedStateChangeCount = 0u;
+    uint64_t queuedDrawCallCount = 0u;
+    for(uint32_t frameIndex = 0u; frameIndex < warmupFrameCount + frameCount; ++frameIndex)
+    {
+        startBenchmarkTimer(&timer);
+        pGraphicsFrame = beginNextFrame(&renderContext);
+        render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, "Queued Pass", nullptr);
+        for(uint32_t drawIndex = 0u; drawIndex < drawCount; ++drawIndex)
+        {
+            const benchmark_draw_t* pDraw = pDraws + drawIndex;
+            queued_draw_t draw = {};
+            draw.pipelineState          = pipelineStates[pDraw->pipelineStateIndex];
+            draw.vertexBuffer           = vertexBuffers[pDraw->vertexBufferIndex];
+            draw.vertexFormat           = parameters.vertexFormat;
+            draw.vertexCountPerInstance = 3u;
+            draw.instanceCount          = 1u;
+            queueDraw(pRenderPass, draw, 0u, pDraw->depth);
+        }
+        endRenderPass(pGraphicsFrame, pRenderPass);
+        queuedStateChangeCount = pRenderPass->pGraphicsCommandList->recorded.stateChangeCount;
+        queuedDrawCallCount = pRenderPass->pGraphicsCommandList->recorded.drawCallCount;
+        executeRenderPass(pGraphicsFrame, pRenderPass);
+        finishFrame(&renderContext, pGraphicsFrame);
+        queuedTimeInMs += frameIndex >= warmupFrameCount ? stopBenchmarkTimerInMilliseconds(&timer) : 0.0;
+    }
+    CHECK(queuedDrawCallCount == drawCount && queuedStateChangeCount < immediateStateChangeCount);
+
+    //FK: The sort on its own, keys as queueDraw() creates them
+    draw_sort_entry_t* pSortEntries = (draw_sort_entry_t*)allocateFromAllocator(&renderContext.defaultAllocator, sizeof(draw_sort_entry_t) * drawCount * 2u, alloc_flag_clear_memory);
+    for(uint32_t drawIndex = 0u; drawIndex < drawCount; ++drawIndex)
+    {
+        const benchmark_draw_t* pDraw = pDraws + drawIndex;
+        pSortEntries[drawIndex].sortKey     = createDrawSortKey(0u, pipelineStates[pDraw->pipelineStateIndex], vertexBuffers[pDraw->vertexBufferIndex], pDraw->depth);
+        pSortEntries[drawIndex].drawIndex   = drawIndex;
+    }
+
+    uint32_t sortPassCount = 0u;
+    startBenchmarkTimer(&timer);
+    radixSortDrawSortEntries(pSortEntries, pSortEntries + drawCount, drawCount, &sortPassCount);
+    const double sortTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+
+    printBenchmarkResult("100k draws, immediate (random order)", immediateTimeInMs, frameCount * drawCount);
+    printBenchmarkResult("100k draws, queued + sorted", queuedTimeInMs, frameCount * drawCount);
+    printBenchmarkResult("radix sort of 100k draw sort keys", sortTimeInMs, drawCount);
+    printf("    state changes: %llu -> %llu (%llu saved), radix sort passes: %u of 8\n", (unsigned long long)immediateStateChangeCount, (unsigned long long)queuedStateChangeCount, 
+        (unsigned long long)(immediateStateChangeCount - queuedStateChangeCount), sortPassCount);
+
+    freeFromAllocator(&renderContext.defaultAllocator, pSortEntries);
+    freeFromAllocator(&renderContext.defaultAllocator, pDraws);
+
+    pGraphicsFrame = beginNextFrame(&renderContext);
+    for(uint32_t pipelineStateIndex = 0u; pipelineStateIndex < pipelineStateCount; ++pipelineStateIndex)
+    {
+        destroyPipelineState(pGraphicsFrame->pRenderResourceCache, pipelineStates[pipelineStateIndex]);
+    }
+    finishFrame(&renderContext, pGraphicsFrame);
+    shutdownRenderContext(&renderContext);
+}
+
+void benchmarkPipelineLibrary()
+{
+    const char* pPipelineLibraryFilePath = "cpu_benchmark_shader_cache/benchmark_pipeline_library.bin";
+    CreateDirectoryA("cpu_benchmark_shader_cache", nullptr);
+    remove(pPipelineLibraryFilePath);
+
+    //FK: 1ms per pipeline state, real drivers take anywhere between a few ms and hundreds of ms
+    setNullPipelineStateCompilerCost(1000000u);
+
+    const uint32_t pipelineStateCount = 32u;
+    uint64_t compiledPipelineStateCount = 0u;
+
+    benchmark_timer_t timer;
+    startBenchmarkTimer(&timer);
+    createPipelineLibraryTestPipelineStates(pPipelineLibraryFilePath, pipelineStateCount, &compiledPipelineStateCount);
+    const double coldStartTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+
+    startBenchmarkTimer(&timer);
+    const pipeline_library_statistics_t statistics = createPipelineLibraryTestPipelineStates(pPipelineLibraryFilePath, pipelineStateCount, &compiledPipelineStateCount);
+    const double warmStartTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+
+    setNullPipelineStateCompilerCost(0u);
+
+    CHECK(statistics.loadedCount == pipelineStateCount && compiledPipelineStateCount == 0u);
+    printBenchmarkResult("render context startup (cold, 1ms per pipeline state)", coldStartTimeInMs, pipelineStateCount);
+    printBenchmarkResult("render context startup (pipeline library)", warmStartTimeInMs, pipelineStateCount);
+    printf("    loaded pipeline states: %u, compiled pipeline states: %llu\n", statistics.loadedCount, (unsigned long long)compiledPipelineStateCount);
+}
+
+//FK: Worst frame when a batch of new materials shows up at once
+double measureFrameWithNewPipelineStates(const uint32_t pipelineStateCount, const bool compileAsynchronously)
+{
+    render_context_t renderContext = {};
+    if(!createNullDeviceRenderContext(&renderContext, 2u))
+    {
+        CHECK(false);
+        return 0.0;
+    }
+
+    graphics_frame_t* pGraphicsFrame = beginNextFrame(&renderContext);
+    graphics_pipeline_state_parameters_t parameters = createPipelineStateTestParameters(pGraphicsFrame);
+    finishFrame(&renderContext, pGraphicsFrame);
+
+    benchmark_timer_t timer;
+    startBenchmarkTimer(&timer);
+    pGraphicsFrame = beginNextFrame(&renderContext);
+    render_pass_t* pRenderPass = startRenderPass(pGraphicsFrame, "New Pipeline States Pass", nullptr);
+    for(uint32_t pipelineStateIndex = 0u; pipelineStateIndex < pipelineStateCount; ++pipelineStateIndex)
+    {
+        parameters.rasterizerDesc.DepthBias = (int32_t)pipelineStateIndex;
+        const graphics_pipeline_state_handle_t pipelineState = compileAsynchronously ? requestGraphicsPipelineState(pGraphicsFrame, &parameters) : createGraphicsPipelineState(pGraphicsFrame, &parameters);
+        trySetPipelineState(pRenderPass, pipelineState, createInvalidResourceHandle<graphics_pipeline_state_handle_t>());
+        drawInstanced(pRenderPass, 3u, 1u, 0u, 0u);
+    }
+    endRenderPass(pGraphicsFrame, pRenderPass);
+    executeRenderPass(pGraphicsFrame, pRenderPass);
+    finishFrame(&renderContext, pGraphicsFrame);
+    const double frameTimeInMs = stopBenchmarkTimerInMilliseconds(&timer);
+
+    shutdownRenderContext(&renderContext);
+    return frameTimeInMs;
+}
+
+void benchmarkAsyncPipelineStates()
+{
+    //FK: 1ms per pipeline state, real drivers take anywhere between a few ms and hundreds of ms
+    setNullPipelineStateCompilerCost(1000000u);
+
+    const uint32_t pipelineStateCount = 16u;
+    const double blockingFrameTimeInMs = measureFrameWithNewPipelineStates(pipelineStateCount, false);
+    const double asyncFrameTimeInMs = measureFrameWithNewPipelineStates(pipelineStateCount, true);
+
+    setNullPipelineStateCompilerCost(0u);
+
+    printBenchmarkResult("frame with new pipeline states (blocking)", blockingFrameTimeInMs, 1u);
+    printBenchmarkResult("frame with new pipeline states (async)", asyncFrameTimeInMs, 1u);
+}
+
+#endif
+
+int main(int argc, char** argv)
+{
+    UNUSED_PARAMETER(argc);
+    UNUSED_PARAMETER(argv);
+
+    testLinearMemoryAllocator();
+    testResourceTable();
+    testRingBufferAllocator();
+    testResourceBarrierBatch();
+    testRenderPassStateCache();
+    testDrawSortKeys();
+    testRenderPassSortOrder();
+    testRenderGraphCulling();
+    testRenderGraphAliasing();
+    testRenderGraphUnorderedAccess();
+    testVertexAttributePacking();
+#if USE_NULL_DEVICE
+    testNullDeviceFrameLoop();
+    testRenderPassSubmitThreshold();
+    testRenderGraphExecution();
+    testRenderGraphHeapGrowth();
+    testShaderCache();
+    testShaderBatchCompilation();
+    testShaderPermutations();
+    testPipelineStateCache();
+    testRootSignatureCache();
+    testShaderReflection();
+    testVertexFormatInterning();
+    testDescriptorAllocators();
+    testBindlessResources();
+    testConstantBufferAllocator();
+    testDrawConstants();
+    testDrawQueue();
+    testVertexBufferUploads();
+    testUploadBatchWaits();
+    testPipelineLibrary();
+    testAsyncPipelineStates();
+#endif
+
+    benchmarkFrameTempAllocator();
+    benchmarkRenderGraphCompilation();
+    benchmarkVertexAttributePacking();
+#if USE_NULL_DEVICE
+    benchmarkNullDeviceFrameLoop();
+    benchmarkShaderBatchCompilation();
+    benchmarkPipelineStateCache();
+    benchmarkDescriptorAllocators();
+    benchmarkConstantBufferAllocator();
+    benchmarkDrawConstants();
+    benchmarkDrawQueue();
+    benchmarkPipelineLibrary();
+    benchmarkAsyncPipelineStates();
+#endif
+
+    if(failedCheckCount > 0u)
+    {
+        printf("%u check(s) failed.\n", failedCheckCount);
+        return -1;
+    }
+
+    printf("All checks passed.\n");
+    return 0;
+}
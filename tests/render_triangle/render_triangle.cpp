@@ -2,146 +2,33 @@
 #include "../../k15_d3d12_renderer.hpp"
 #include "../test_base.hpp"
 
-mesh_t* createMesh(graphics_frame_t* pGraphicsFrame, const float* pVertices, const uint32_t vertexCount, vertex_format_t* pVertexFormat)
+mesh_t* createMesh(graphics_frame_t* pGraphicsFrame, const float* pVertices, const uint32_t vertexCount, vertex_format_handle_t vertexFormat)
 {
-    const uint32_t vertexBufferSizeInBytes = vertexCount * calculateVertexStrideSizeInBytes(pVertexFormat);
-    upload_buffer_t* pVertexUploadBuffer = createUploadBuffer(pGraphicsFrame, vertexBufferSizeInBytes);
-    memcpy(pVertexUploadBuffer->pData, pVertices, vertexBufferSizeInBytes);
+    const uint32_t vertexBufferSizeInBytes = vertexCount * getVertexFormat(pGraphicsFrame->pRenderResourceCache, vertexFormat)->strideInBytes;
+    upload_buffer_t vertexUploadBuffer = createUploadBuffer(pGraphicsFrame, (void*)pVertices, vertexBufferSizeInBytes);
 
-    vertex_buffer_t* pMeshVertexBuffer = createVertexBuffer(pGraphicsFrame, pVertexUploadBuffer);
+    vertex_buffer_handle_t meshVertexBuffer = createVertexBuffer(pGraphicsFrame, &vertexUploadBuffer);
 
     mesh_t* pMesh = (mesh_t*)allocateFromDefaultAllocator(nullptr, sizeof(mesh_t), defaultAllocationAlignment);
     pMesh->vertexCount = vertexCount;
     pMesh->vertexOffset = 0u;
-    pMesh->pVertexFormat = pVertexFormat;
-    pMesh->pVertexBuffer = pMeshVertexBuffer;
+    pMesh->vertexFormat = vertexFormat;
+    pMesh->vertexBuffer = meshVertexBuffer;
 
     return pMesh;
 }
 
-D3D12_BLEND_DESC createDefaultBlendDesc()
+material_t* createMaterial(graphics_frame_t* pGraphicsFrame, vertex_format_handle_t vertexFormat, const shader_compilation_parameters_t* pVertexShaderParameters, const shader_compilation_parameters_t* pPixelShaderParameters)
 {
-    D3D12_BLEND_DESC defaultBlendDesc = {};
-    defaultBlendDesc.RenderTarget[0].BlendEnable            = FALSE;
-    defaultBlendDesc.RenderTarget[0].LogicOpEnable          = FALSE;
-    defaultBlendDesc.RenderTarget[0].SrcBlend               = D3D12_BLEND_ONE;
-    defaultBlendDesc.RenderTarget[0].DestBlend              = D3D12_BLEND_ZERO;
-    defaultBlendDesc.RenderTarget[0].BlendOp                = D3D12_BLEND_OP_ADD;
-    defaultBlendDesc.RenderTarget[0].SrcBlendAlpha          = D3D12_BLEND_ONE;
-    defaultBlendDesc.RenderTarget[0].DestBlendAlpha         = D3D12_BLEND_ZERO;
-    defaultBlendDesc.RenderTarget[0].BlendOpAlpha           = D3D12_BLEND_OP_ADD;
-    defaultBlendDesc.RenderTarget[0].LogicOp                = D3D12_LOGIC_OP_NOOP;
-    defaultBlendDesc.RenderTarget[0].RenderTargetWriteMask  = D3D12_COLOR_WRITE_ENABLE_ALL;
-
-    return defaultBlendDesc;
-}
-
-D3D12_DEPTH_STENCIL_DESC createDefaultDepthStencilDesc()
-{
-    D3D12_DEPTH_STENCIL_DESC defaultDepthStencilState = {};
-    defaultDepthStencilState.DepthEnable                    = TRUE;
-    defaultDepthStencilState.DepthWriteMask                 = D3D12_DEPTH_WRITE_MASK_ALL;
-    defaultDepthStencilState.DepthFunc                      = D3D12_COMPARISON_FUNC_LESS;
-    defaultDepthStencilState.StencilEnable                  = FALSE;
-    defaultDepthStencilState.StencilReadMask                = D3D12_DEFAULT_STENCIL_READ_MASK;
-    defaultDepthStencilState.StencilWriteMask               = D3D12_DEFAULT_STENCIL_WRITE_MASK;
-    defaultDepthStencilState.FrontFace.StencilFailOp        = D3D12_STENCIL_OP_KEEP;
-    defaultDepthStencilState.FrontFace.StencilDepthFailOp   = D3D12_STENCIL_OP_KEEP;
-    defaultDepthStencilState.FrontFace.StencilPassOp        = D3D12_STENCIL_OP_KEEP;
-    defaultDepthStencilState.FrontFace.StencilFunc          = D3D12_COMPARISON_FUNC_ALWAYS;
-    defaultDepthStencilState.BackFace.StencilFailOp         = D3D12_STENCIL_OP_KEEP;
-    defaultDepthStencilState.BackFace.StencilDepthFailOp    = D3D12_STENCIL_OP_KEEP;
-    defaultDepthStencilState.BackFace.StencilPassOp         = D3D12_STENCIL_OP_KEEP;
-    defaultDepthStencilState.BackFace.StencilFunc           = D3D12_COMPARISON_FUNC_ALWAYS;
-
-    return defaultDepthStencilState;
-}
-
-D3D12_RASTERIZER_DESC createDefaultRasterizerDesc()
-{
-    D3D12_RASTERIZER_DESC defaultRasterizerDesc = {};
-    defaultRasterizerDesc.FillMode              = D3D12_FILL_MODE_SOLID;
-    defaultRasterizerDesc.CullMode              = D3D12_CULL_MODE_BACK;
-    defaultRasterizerDesc.FrontCounterClockwise = FALSE;
-    defaultRasterizerDesc.DepthBias             = 0;
-    defaultRasterizerDesc.DepthBiasClamp        = 0.0f;
-    defaultRasterizerDesc.SlopeScaledDepthBias  = 0.0f;
-    defaultRasterizerDesc.DepthClipEnable       = TRUE;
-    defaultRasterizerDesc.MultisampleEnable     = FALSE;
-    defaultRasterizerDesc.AntialiasedLineEnable = FALSE;
-    defaultRasterizerDesc.ForcedSampleCount     = 0;
-    defaultRasterizerDesc.ConservativeRaster    = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
-
-    return defaultRasterizerDesc;
-}
-
-graphics_pipeline_state_t* createGraphicsPipelineState(graphics_frame_t* pGraphicsFrame, const graphics_pipeline_state_parameters_t* pPipelineStateParameters)
-{
-    graphics_pipeline_state_t* pPipelineState = allocatePipelineState(pGraphicsFrame->pRenderResourceCache);
-    if(pPipelineState == nullptr)
-    {
-        return nullptr;
-    }
-
-    D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
-    rootSignatureDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
-
-    ID3DBlob* pRootSignatureBlob = nullptr;
-    ID3DBlob* pErrorBlob = nullptr;
-    D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, &pRootSignatureBlob, &pErrorBlob);
-    ID3D12RootSignature* pRootSignature = nullptr;
-    pGraphicsFrame->pDevice->CreateRootSignature(0u, pRootSignatureBlob->GetBufferPointer(), pRootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&pRootSignature));
-
-    D3D12_INPUT_ELEMENT_DESC elementDescs[] = {
-        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        {"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-    };
-
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelineStateDesc = {};
-    graphicsPipelineStateDesc.VS.BytecodeLength     = pPipelineStateParameters->pVertexShader->shaderBlobSizeInBytes;
-    graphicsPipelineStateDesc.VS.pShaderBytecode    = pPipelineStateParameters->pVertexShader->pShaderBlob;
-    graphicsPipelineStateDesc.PS.BytecodeLength     = pPipelineStateParameters->pPixelShader->shaderBlobSizeInBytes;
-    graphicsPipelineStateDesc.PS.pShaderBytecode    = pPipelineStateParameters->pPixelShader->pShaderBlob;
-    graphicsPipelineStateDesc.NumRenderTargets      = 1u;
-    graphicsPipelineStateDesc.SampleMask            = 0xFFFFFFFF;
-    graphicsPipelineStateDesc.RTVFormats[0]         = DXGI_FORMAT_R8G8B8A8_UNORM;
-    graphicsPipelineStateDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    graphicsPipelineStateDesc.SampleDesc.Count      = 1u;
-    graphicsPipelineStateDesc.SampleDesc.Quality    = 0u;
-    graphicsPipelineStateDesc.BlendState            = createDefaultBlendDesc();
-    graphicsPipelineStateDesc.DepthStencilState     = createDefaultDepthStencilDesc();
-    graphicsPipelineStateDesc.RasterizerState       = createDefaultRasterizerDesc();
-    graphicsPipelineStateDesc.pRootSignature        = pRootSignature;
-    
-    graphicsPipelineStateDesc.InputLayout.NumElements = 2;
-    graphicsPipelineStateDesc.InputLayout.pInputElementDescs = elementDescs;
-
-    ID3D12PipelineState* pPipelineStateObject = nullptr;
-    const HRESULT pipelineStateObjectResult = pGraphicsFrame->pDevice->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&pPipelineStateObject));
-    if(pipelineStateObjectResult != S_OK)
-    {
-        logError("'%s' while trying to create graphics pipeline state '%s'.", getHResultString(pipelineStateObjectResult), pPipelineStateParameters->pName);
-        return nullptr;
-    }
-
-    setD3D12ObjectDebugName(pPipelineStateObject, pPipelineStateParameters->pName);
-    
-    pPipelineState->pPipelineState = pPipelineStateObject;
-    pPipelineState->pRootSignature = pRootSignature;
-    return pPipelineState;
-}
-
-material_t* createMaterial(graphics_frame_t* pGraphicsFrame, vertex_format_t* pVertexFormat, const shader_compilation_parameters_t* pVertexShaderParameters, const shader_compilation_parameters_t* pPixelShaderParameters)
-{
-    graphics_pipeline_state_parameters_t pipelineStateParameters = {};
-    pipelineStateParameters.pVertexShader   = loadAndCompileShaderCodeFromFile(pGraphicsFrame, pVertexShaderParameters);
-    pipelineStateParameters.pPixelShader    = loadAndCompileShaderCodeFromFile(pGraphicsFrame, pPixelShaderParameters);
-    pipelineStateParameters.pVertexFormat   = pVertexFormat;
+    graphics_pipeline_state_parameters_t pipelineStateParameters = createDefaultGraphicsPipelineStateParameters();
+    pipelineStateParameters.vertexShader    = loadAndCompileShaderCodeFromFile(pGraphicsFrame, pVertexShaderParameters);
+    pipelineStateParameters.pixelShader     = loadAndCompileShaderCodeFromFile(pGraphicsFrame, pPixelShaderParameters);
+    pipelineStateParameters.vertexFormat    = vertexFormat;
     pipelineStateParameters.pName           = "Test";
 
-    graphics_pipeline_state_t* pDefaultPipelineStateObject = createGraphicsPipelineState(pGraphicsFrame, &pipelineStateParameters);
+    graphics_pipeline_state_handle_t defaultPipelineStateObject = createGraphicsPipelineState(pGraphicsFrame, &pipelineStateParameters);
     material_t* pMaterial = (material_t*)allocateFromAllocator(pGraphicsFrame->pMemoryAllocator, sizeof(material_t));
-    pMaterial->pGraphicsPipelineState = pDefaultPipelineStateObject;
+    pMaterial->graphicsPipelineState = defaultPipelineStateObject;
     return pMaterial;
 }
 
@@ -162,9 +49,9 @@ mesh_t* createSingleTriangleMesh(graphics_frame_t* pGraphicsFrame)
         {vertex_attribute_t::color, vertex_attribute_type_t::float32, 4u}
     };
 
-    vertex_format_t* pVertexFormat = createVertexFormat(pGraphicsFrame, pVertexAttributes, 2u);
+    vertex_format_handle_t vertexFormat = createVertexFormat(pGraphicsFrame, pVertexAttributes, 2u);
 
-    return createMesh(pGraphicsFrame, triangleVertices, 3u, pVertexFormat);
+    return createMesh(pGraphicsFrame, triangleVertices, 3u, vertexFormat);
 }
 
 void renderFrame(HWND hwnd, graphics_frame_t* pGraphicsFrame)
@@ -184,7 +71,7 @@ void renderFrame(HWND hwnd, graphics_frame_t* pGraphicsFrame)
     ps_para.pShaderProfile = "ps_6_0";
 
     static mesh_t* pMesh = createSingleTriangleMesh(pGraphicsFrame);
-    static material_t* pMaterial = createMaterial(pGraphicsFrame, pMesh->pVertexFormat, &vs_para, &ps_para);
+    static material_t* pMaterial = createMaterial(pGraphicsFrame, pMesh->vertexFormat, &vs_para, &ps_para);
 
     const float r = (float)cursorPos.x / (float)(clientRect.right - clientRect.left);
     const float g = (float)cursorPos.y / (float)(clientRect.bottom - clientRect.top);
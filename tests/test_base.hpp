@@ -8,20 +8,26 @@
 
 struct material_t
 {
-	graphics_pipeline_state_t* pGraphicsPipelineState;
+	graphics_pipeline_state_handle_t graphicsPipelineState;
 };
 
 struct mesh_t
 {
-	vertex_buffer_t* pVertexBuffer;
-	vertex_format_t* pVertexFormat;
+	vertex_buffer_handle_t vertexBuffer;
+	vertex_format_handle_t vertexFormat;
 
 	uint32_t vertexOffset;
 	uint32_t vertexCount;
 };
 
-void bindGraphicsPipelineState(render_pass_t* pRenderPass, graphics_pipeline_state_t* pGraphicsPipelineState)
+void bindGraphicsPipelineState(render_pass_t* pRenderPass, const graphics_pipeline_state_handle_t graphicsPipelineStateHandle)
 {
+    const graphics_pipeline_state_t* pGraphicsPipelineState = getPipelineState(pRenderPass->pRenderResourceCache, graphicsPipelineStateHandle);
+    if(pGraphicsPipelineState == nullptr)
+    {
+        return;
+    }
+
 	D3D12_VIEWPORT viewport = {};
 	viewport.Height = (float)768;
 	viewport.Width = (float)1024;
@@ -36,27 +42,39 @@ void bindGraphicsPipelineState(render_pass_t* pRenderPass, graphics_pipeline_sta
     scissorRect.left = 0;
     scissorRect.top = 0;
 
-    pRenderPass->pGraphicsCommandList->RSSetViewports(1u, &viewport);
-    pRenderPass->pGraphicsCommandList->RSSetScissorRects(1u, &scissorRect);
+    setViewport(pRenderPass, viewport);
+    setScissorRect(pRenderPass, scissorRect);
 
-    pRenderPass->pGraphicsCommandList->SetPipelineState(pGraphicsPipelineState->pPipelineState);
-	pRenderPass->pGraphicsCommandList->SetGraphicsRootSignature(pGraphicsPipelineState->pRootSignature);
-	pRenderPass->pGraphicsCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	pRenderPass->pGraphicsCommandList->OMSetRenderTargets(1u, &pRenderPass->pRenderTarget->cpuDescriptorHandle, 0u, nullptr);
+    setPipelineState(pRenderPass, pGraphicsPipelineState);
+	setPrimitiveTopology(pRenderPass, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	setRenderTarget(pRenderPass, pRenderPass->pRenderTarget);
 }
 
 void draw(render_pass_t* pRenderPass, const uint32_t vertexOffset, const uint32_t vertexCount)
 {
-	pRenderPass->pGraphicsCommandList->DrawInstanced(vertexCount, 1u, vertexOffset, 0u);
+	drawInstanced(pRenderPass, vertexCount, 1u, vertexOffset, 0u);
 }
 
 void drawMesh(mesh_t* pMesh, material_t* pMaterial, render_pass_t* pRenderPass)
 {
-	bindGraphicsPipelineState(pRenderPass, pMaterial->pGraphicsPipelineState);
-	bindVertexBuffer(pRenderPass, pMesh->pVertexBuffer, pMesh->pVertexFormat, 0u);
+	bindGraphicsPipelineState(pRenderPass, pMaterial->graphicsPipelineState);
+	bindVertexBuffer(pRenderPass, pMesh->vertexBuffer, pMesh->vertexFormat, 0u);
 	draw(pRenderPass, pMesh->vertexOffset, pMesh->vertexCount);
 }
 
+//FK: Gets recorded in endRenderPass(), viewport, scissor rect, topology and render target have to be set on the pass directly
+void queueMesh(mesh_t* pMesh, material_t* pMaterial, render_pass_t* pRenderPass, const uint8_t layer, const float normalizedDepth)
+{
+	queued_draw_t queuedDraw = {};
+	queuedDraw.pipelineState			= pMaterial->graphicsPipelineState;
+	queuedDraw.vertexBuffer				= pMesh->vertexBuffer;
+	queuedDraw.vertexFormat				= pMesh->vertexFormat;
+	queuedDraw.vertexCountPerInstance	= pMesh->vertexCount;
+	queuedDraw.instanceCount			= 1u;
+	queuedDraw.startVertexLocation		= pMesh->vertexOffset;
+	queueDraw(pRenderPass, queuedDraw, layer, normalizedDepth);
+}
+
 void printErrorToFile(const char* p_FileName)
 {
 	DWORD errorId = GetLastError();
@@ -182,7 +200,8 @@ HWND setupWindow(HINSTANCE p_Instance, int p_Width, int p_Height, const char* pW
 bool setup(render_context_t* pRenderContext, HWND pWindowHandle, const uint32_t windowWidth, const uint32_t windowHeight, bool useDebugLayer)
 {
     const uint32_t frameBufferCount = 3u;
-    const render_context_parameters_t parameters = createDefaultRenderContextParameters(pWindowHandle, frameBufferCount, windowWidth, windowHeight, useDebugLayer);
+    render_context_parameters_t parameters = createDefaultRenderContextParameters(pWindowHandle, frameBufferCount, windowWidth, windowHeight, useDebugLayer);
+    parameters.pShaderCacheDirectory = "shader_cache";
     if(!createRenderContext(pRenderContext, &parameters))
     {
         return false;
@@ -2,6 +2,9 @@
 
 ::set C_FILES=..\tests\clear_backbuffer\clear_backbuffer.cpp
 ::set OUTPUT_FILE_NAME=clear_backbuffer
+::set C_FILES=..\tests\cpu_benchmark\cpu_benchmark.cpp
+::set OUTPUT_FILE_NAME=cpu_benchmark
+::set LINKER_OPTIONS=/SUBSYSTEM:CONSOLE
 set C_FILES=..\tests\render_triangle\render_triangle.cpp
 set OUTPUT_FILE_NAME=render_triangle
 set BUILD_CONFIGURATION=%1